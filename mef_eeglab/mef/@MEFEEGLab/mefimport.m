@@ -6,6 +6,7 @@ function OUTEEG = mefimport(this, INEEG, varargin)
 %   OUTEEG = mefimport(__, start_end)
 %   OUTEEG = mefimport(__, start_end, se_unit)
 %   OUTEEG = mefimport(__, 'SelectedChannel', sel_chan, 'Password', pw)
+%   OUTEEG = mefimport(__, 'DataFile', data_file)
 %
 % Input(s):
 %   this            - [obj] MEFEEGLab_2p1 object
@@ -24,6 +25,9 @@ function OUTEEG = mefimport(this, INEEG, varargin)
 %                     .Subject      : subject password (default - '')
 %                     .Session
 %                     .Data
+%   data_file       - [str] (para) float32 data file (.fdt) to export the
+%                     data to, instead of loading them into memory (MEF 3.0
+%                     only; default: '', i.e. load into memory)
 % 
 % Outputs:
 %   OUTEEG           - [struct] EEGLab dataset structure. See Note for
@@ -36,6 +40,13 @@ function OUTEEG = mefimport(this, INEEG, varargin)
 %   All MEF files in one directory are assumed to be data files for
 %   different channels during recording.
 % 
+%   With 'DataFile', the channels are decoded chunk by chunk (in parallel
+%   across channels) straight into data_file, so the memory used is
+%   bounded by the chunk size, not by the length of the session. EEG.data
+%   is then a memory-mapped object of the file (mmo of EEGLAB), or the
+%   file name if mmo is not available, and EEG.times is left to
+%   eeg_checkset.
+% 
 %   Details of EEG dataset structure in EEGLab can be found at:
 %   https://sccn.ucsd.edu/wiki/A05:_Data_Structures, or see the help
 %   information of eeg_checkset.m.
@@ -43,7 +54,7 @@ function OUTEEG = mefimport(this, INEEG, varargin)
 % See also eeglab, eeg_checkset, pop_mefimport. 
 
 % Copyright 2019-2020 Richard J. Cui. Created: Wed 05/08/2019  3:19:29.986 PM
-% $Revision: 2.0 $  $Date: Mon 09/28/2020  3:06:06.030 PM $
+% $Revision: 2.1 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
 %
 % Rocky Creek Dr NE
 % Rochester, MN 55906, USA
@@ -83,6 +94,12 @@ if isempty(pw)
 else
     this.Password = pw;
 end % if
+% data file
+data_file = q.DataFile;
+if ~isempty(data_file) && ~ismethod(this, 'export_sess')
+    error('MEFEEGLab:mefimport:noDataFile',...
+        'Importing into a data file is only supported for MEF 3.0 sessions')
+end % if
 
 sess_path = this.SessionPath;
 
@@ -158,25 +175,58 @@ OUTEEG.nbchan = numel(sel_chan);
 % -----
 OUTEEG.srate = this.SamplingFrequency; % in Hz
 
-% data
-% ----
-[data, t_index] = this.importSession(start_end, se_unit, sess_path,...
-    'SelectedChannel', sel_chan, 'Password', pw);
-OUTEEG.data = data;
+if isempty(data_file)
+    % data
+    % ----
+    [data, t_index] = this.importSession(start_end, se_unit, sess_path,...
+        'SelectedChannel', sel_chan, 'Password', pw);
+    OUTEEG.data = data;
 
-% xmin, xmax (in second)
-% ----------------------
-t_sec = this.SessionUnitConvert(t_index, 'index', 'second');
-OUTEEG.xmin = min(t_sec);
-OUTEEG.xmax = max(t_sec);
+    % xmin, xmax (in second)
+    % ----------------------
+    t_sec = this.SessionUnitConvert(t_index, 'index', 'second');
+    OUTEEG.xmin = min(t_sec);
+    OUTEEG.xmax = max(t_sec);
 
-% times (in second)
-% ------------------------------------------------------------
-OUTEEG.times = t_sec; 
+    % times (in second)
+    % ------------------------------------------------------------
+    OUTEEG.times = t_sec; 
+
+    % pnts
+    % ----
+    OUTEEG.pnts = numel(t_sec);
+else
+    % data (exported to the data file)
+    % --------------------------------
+    if isempty(start_end)
+        start_end = this.abs2relativeTimePoint(this.BeginStop, this.Unit);
+        se_unit = this.Unit;
+    end % if
+    begin_stop = this.relative2absTimePoint(start_end, se_unit);
+    [pnts, ~, se_index] = this.export_sess(data_file, begin_stop, se_unit,...
+        sel_chan, pw);
+    [fdt_path, fdt_name, fdt_ext] = fileparts(data_file);
+    OUTEEG.filepath = fdt_path;
+    OUTEEG.datfile = [fdt_name, fdt_ext];
+    if exist('mmo', 'file') == 2
+        OUTEEG.data = mmo(data_file, [OUTEEG.nbchan, pnts, 1], false);
+    else
+        OUTEEG.data = OUTEEG.datfile;
+    end % if
 
-% pnts
-% ----
-OUTEEG.pnts = numel(t_sec);
+    % xmin, xmax (in second)
+    % ----------------------
+    OUTEEG.xmin = this.SessionUnitConvert(se_index(1), 'index', 'second');
+    OUTEEG.xmax = OUTEEG.xmin + (pnts - 1) / OUTEEG.srate;
+
+    % times (left to eeg_checkset)
+    % ----------------------------
+    OUTEEG.times = [];
+
+    % pnts
+    % ----
+    OUTEEG.pnts = pnts;
+end % if
 
 % comments
 % --------
@@ -209,6 +259,7 @@ default_ut = '';
 expected_ut = {'index', 'uutc', 'msec', 'second', 'minute', 'hour', 'day'};
 default_sc = [];
 default_pw = struct([]);
+default_df = '';
 
 % parse rules
 p = inputParser;
@@ -220,6 +271,7 @@ p.addOptional('se_unit', default_ut,...
     @(x) any(validatestring(x, expected_ut)));
 p.addParameter('SelectedChannel', default_sc, @isstring) % must be string array
 p.addParameter('Password', default_pw, @isstruct);
+p.addParameter('DataFile', default_df, @ischar);
 
 % parse and return the results
 p.parse(varargin{:});
@@ -9,6 +9,7 @@ function [EEG, com] = pop_mefimport(EEG, varargin)
 %   [EEG, com] = __(__, sess_path, sel_chan, start_end)
 %   [EEG, com] = __(__, sess_path, sel_chan, start_end, unit)
 %   [EEG, com] = __(__, pw)
+%   [EEG, com] = __(__, 'DataFile', data_file)
 %
 % Input(s):
 %   EEG             - [strcut] EEGLab dataset structure. See Note for
@@ -24,6 +25,9 @@ function [EEG, com] = pop_mefimport(EEG, varargin)
 %                     'Second', 'Minute', 'Hour', and 'Day'
 %   pw              - [strct] (opt) password structure depending on MEF
 %                     version
+%   data_file       - [str] (para) float32 data file (.fdt) to export the
+%                     data to, for sessions too large to load into memory
+%                     (MEF 3.0 only; default: '', i.e. load into memory)
 % 
 % Outputs:
 %   EEG             - [struct] EEGLab dataset structure. See Note for
@@ -45,10 +49,12 @@ function [EEG, com] = pop_mefimport(EEG, varargin)
 %   start_end is a relative time pint, which is relative to the beginning
 %   of data recording.
 % 
+%   With 'DataFile', EEG.data is backed by data_file (see mefimport).
+% 
 % See also EEGLAB, mefimport.
 
 % Copyright 2019-2020 Richard J. Cui. Created: Tue 05/07/2019 10:33:48.169 PM
-% $Revision: 1.9 $  $Date: Mon 09/28/2020  3:06:06.030 PM $
+% $Revision: 1.12 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
 %
 % Rocky Creek Dr NE
 % Rochester, MN 55906, USA
@@ -73,6 +79,7 @@ sel_chan = q.sel_chan;
 start_end = q.start_end;
 unit = q.unit;
 pw = q.pw;
+data_file = q.DataFile;
 
 mef_ver = q.mef_ver;
 switch mef_ver
@@ -120,12 +127,22 @@ else
     this.SEUnit = unit;
     this.StartEnd = start_end; % relative time points
 end % if
-EEG = this.mefimport(EEG);
+EEG = this.mefimport(EEG, 'DataFile', data_file);
 EEG = eeg_checkset(EEG); % from eeglab functions
 
 % process discontinuity events
 % ----------------------------
-if height(this.Continuity) > 1
+if ismethod(this, 'findMEFEvent') % MEF 3.0: discontinuities & records
+    types = {'Seiz', 'Note', 'CSti', 'ESti'};
+    if height(this.Continuity) > 1
+        types = [{'Discont'}, types];
+    end % if
+    mef_event = this.findMEFEvent([], '', types);
+    if ~isempty(mef_event)
+        EEG.event = mef_event;
+        EEG.urevent = rmfield(mef_event, 'urevent');
+    end % if
+elseif height(this.Continuity) > 1
     discont_event = this.findDiscontEvent;
     EEG.event = discont_event;
     EEG.urevent = rmfield(discont_event, 'urevent');
@@ -157,6 +174,7 @@ defaultSE = [];
 defaultUnit = 'uutc';
 expectedUnit = {'index', 'uutc', 'second', 'minute', 'hour', 'day'};
 default_pw = struct([]);
+default_df = '';
 
 valid_se = @(x) isempty(x) || (isnumeric(x) && numel(x) == 2 && x(1) <= x(2));
 
@@ -171,6 +189,7 @@ p.addOptional('start_end', defaultSE, valid_se);
 p.addOptional('unit', defaultUnit,...
     @(x) any(validatestring(x, expectedUnit)));
 p.addOptional('pw', default_pw, @isstruct);
+p.addParameter('DataFile', default_df, @ischar);
 
 % parse and return the results
 p.parse(EEG, varargin{:});
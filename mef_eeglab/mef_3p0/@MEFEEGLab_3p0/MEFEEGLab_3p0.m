@@ -20,7 +20,7 @@ classdef MEFEEGLab_3p0 < MEFSession_3p0 & MEFEEGLab
     % See also .
     
     % Copyright 2020 Richard J. Cui. Created: Sun 02/09/2020  3:45:09.696 PM
-    % $Revision: 0.4 $  $Date: Mon 09/28/2020  3:06:06.030 PM $
+    % $Revision: 0.5 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
     %
     % Rocky Creek Dr NE
     % Rochester, MN 55906, USA
@@ -68,7 +68,7 @@ classdef MEFEEGLab_3p0 < MEFSession_3p0 & MEFEEGLab
     % other methods
     % -------------
     methods
-        
+        mef_event = findMEFEvent(this, start_end, unit, types) % find discontinuity and record events
     end % methods
 end
 
@@ -0,0 +1,119 @@
+function mef_event = findMEFEvent(this, start_end, unit, types)
+% MEFEEGLAB_3P0.FINDMEFEVENT find discontinuity and record events
+% 
+% Syntax:
+%   mef_event = findMEFEvent(this)
+%   mef_event = findMEFEvent(__, start_end)
+%   mef_event = findMEFEvent(__, start_end, unit)
+%   mef_event = findMEFEvent(__, start_end, unit, types)
+% 
+% Input(s):
+%   this            - [obj] MEFEEGLab_3p0 object
+%   start_end       - [1 x 2 array] (optional) [start time/index, end time/index] of 
+%                     the signal to be extracted from the file (default:
+%                     this.StartEnd)
+%   unit            - [str] (optional) unit of start_end: 'Index', 'uUTC',
+%                     'Second', 'Minute', 'Hour', and 'Day' (default =
+%                     this.SEUnit)
+%   types           - [char|cell] (optional) event type(s): 'Discont',
+%                     'Seiz', 'Note', 'CSti' and/or 'ESti' (default = {},
+%                     all)
+% 
+% Output(s):
+%   mef_event       - [struct] 1 x N EEGLAB event structure (type,
+%                     latency, urevent); types are 'Discont', 'Seiz
+%                     onset', 'Seiz offset', 'Note', 'CSti' and 'ESti'
+% 
+% Note:
+%   Unlike findDiscontEvent, the events are found by find_events_3p0
+%   from the time series and record indices of the session, without
+%   reading the data. Latencies are in samples of the first selected
+%   channel, 1-based from start_end(1) as in EEGLAB.
+% 
+% See also findDiscontEvent, find_events_3p0.
+
+% Copyright 2026 Richard J. Cui. Created: Sun 10/18/2026 10:12:37.415 AM
+% $Revision: 0.1 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+%
+% Rocky Creek Dr NE
+% Rochester, MN 55906, USA
+%
+% Email: richard.cui@utoronto.ca
+
+% =========================================================================
+% parse inputs
+% =========================================================================
+if nargin < 2
+    start_end = [];
+end % if
+if nargin < 3
+    unit = '';
+end % if
+if nargin < 4
+    types = {};
+end % if
+q = parseInputs(this, start_end, unit, types);
+start_end = q.start_end;
+if isempty(start_end)
+    start_end = this.StartEnd;
+end % if
+unit = q.unit;
+if isempty(unit)
+    unit = this.SEUnit;
+end % if
+types = q.types;
+
+% =========================================================================
+% main process
+% =========================================================================
+pw = this.Password;
+pw_str = this.processPassword('Level1Password', pw.Level1Password,...
+    'Level2Password', pw.Level2Password,...
+    'AccessLevel', pw.AccessLevel);
+ref_chan = char(this.SelectedChannel(1)); % reference channel
+
+% converte start_end to index of the reference channel
+begin_stop = this.relative2absTimePoint(start_end, unit);
+if strcmpi(unit, 'index')
+    se_index = begin_stop;
+else
+    if isempty(this.Channel)
+        [header, channel] = this.readHeader(fullfile(this.SessionPath,...
+            [ref_chan, '.timd']), pw_str, pw.AccessLevel);
+        this.Header = header;
+        this.Channel = channel;
+    end % if
+    se_index = this.SampleTime2Index(begin_stop, unit);
+end % if
+se_index(1) = max(se_index(1), 1);
+
+% find the events
+mef_event = find_events_3p0(this.SessionPath, pw_str, se_index, ref_chan,...
+    types);
+
+end
+
+% =========================================================================
+% subroutines
+% =========================================================================
+function q = parseInputs(varargin)
+
+% defaults
+expectedUnit = {'index', 'uutc', 'second', 'minute', 'hour', 'day'};
+
+% parse rules
+p = inputParser;
+p.addRequired('this', @(x) isobject(x) || strcmpi(class(x), 'MEFEEGLab_3p0'));
+p.addRequired('start_end',...
+    @(x) isempty(x) || (isnumeric(x) & numel(x) == 2 & x(1) <= x(2)));
+p.addRequired('unit',...
+    @(x) isempty(x) || any(validatestring(x, expectedUnit)));
+p.addRequired('types', @(x) isempty(x) || ischar(x) || iscellstr(x));
+
+% parse and return the results
+p.parse(varargin{:});
+q = p.Results;
+
+end % function
+
+% [EOF]
\ No newline at end of file
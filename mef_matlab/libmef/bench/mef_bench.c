@@ -0,0 +1,368 @@
+
+/************************************************************************************/
+/*****************************  MEF Benchmark Common Code  **************************/
+/************************************************************************************/
+
+//  Copyright (c) Richard J. Cui Created: Sun 10/18/2026 10:12:37.415 AM
+//  $Revision: 0.1 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+//
+//  Rocky Creek Dr NE
+//  Rochester, MN 55906, USA
+//
+//  Email: richard.cui@utoronto.ca
+
+// Included by each benchmark after its MEF library (see mef_bench.h)
+
+// written with tab width = indent width = 8 spaces and a monospaced font
+
+
+#include "mef_bench.h"
+
+
+void	BENCH_discontinuity_samples(BENCH_OPTIONS *options, si8 *discontinuity_samples)
+{
+	si8	i, number_of_samples;
+
+
+	// channel-relative samples that follow a gap, evenly spaced over the recording (block aligned is not required)
+	number_of_samples = (si8) (options->duration * options->sampling_frequency);
+	for (i = 0; i < options->number_of_discontinuities; ++i)
+		discontinuity_samples[i] = ((i + 1) * number_of_samples) / (options->number_of_discontinuities + 1);
+
+
+	return;
+}
+
+
+static void	BENCH_json_name(BENCH_JSON *json, const si1 *name)
+{
+	if (json->first[json->depth] == 0)
+		fputc(',', json->fp);
+	json->first[json->depth] = 0;
+	fprintf(json->fp, "\n%*s", 2 * json->depth, "");
+	if (name != NULL)
+		fprintf(json->fp, "\"%s\": ", name);
+
+
+	return;
+}
+
+
+void	BENCH_json_begin(BENCH_JSON *json, const si1 *name)
+{
+	// opens an object (the root object if name is NULL)
+	if (json->depth == 0) {  // buffer the document, so a run that fails midway leaves no partial JSON on the output
+		json->out = json->fp;
+		if ((json->fp = tmpfile()) == NULL)
+			json->fp = json->out;
+	}
+	if (json->depth > 0 || name != NULL)
+		BENCH_json_name(json, name);
+	fputc('{', json->fp);
+	json->first[++json->depth] = 1;
+
+
+	return;
+}
+
+
+void	BENCH_json_end(BENCH_JSON *json)
+{
+	si4	c;
+	
+	
+	--json->depth;
+	fprintf(json->fp, "\n%*s}", 2 * json->depth, "");
+	if (json->depth == 0) {
+		fputc('\n', json->fp);
+		if (json->fp != json->out) {
+			rewind(json->fp);
+			while ((c = fgetc(json->fp)) != EOF)
+				fputc(c, json->out);
+			fclose(json->fp);
+			json->fp = json->out;
+		}
+		fflush(json->fp);
+	}
+
+
+	return;
+}
+
+
+void	BENCH_json_integer(BENCH_JSON *json, const si1 *name, si8 value)
+{
+	BENCH_json_name(json, name);
+	fprintf(json->fp, "%lld", (long long) value);
+
+
+	return;
+}
+
+
+void	BENCH_json_number(BENCH_JSON *json, const si1 *name, sf8 value)
+{
+	BENCH_json_name(json, name);
+	if (isfinite(value))
+		fprintf(json->fp, "%.9g", value);
+	else
+		fprintf(json->fp, "null");
+
+
+	return;
+}
+
+
+void	BENCH_json_rate(BENCH_JSON *json, const si1 *name, sf8 amount, sf8 seconds)
+{
+	BENCH_json_number(json, name, (seconds > 0.0) ? amount / seconds : NAN);
+
+
+	return;
+}
+
+
+void	BENCH_json_string(BENCH_JSON *json, const si1 *name, const si1 *value)
+{
+	BENCH_json_name(json, name);
+	fputc('"', json->fp);
+	for (; *value; ++value) {
+		if (*value == '"' || *value == '\\')
+			fputc('\\', json->fp);
+		fputc(*value, json->fp);
+	}
+	fputc('"', json->fp);
+
+
+	return;
+}
+
+
+void	BENCH_json_options(BENCH_JSON *json, BENCH_OPTIONS *options)
+{
+	BENCH_json_begin(json, "parameters");
+	BENCH_json_string(json, "path", options->path);
+	BENCH_json_integer(json, "channels", options->number_of_channels);
+	BENCH_json_number(json, "sampling_frequency", options->sampling_frequency);
+	BENCH_json_number(json, "duration", options->duration);
+	BENCH_json_integer(json, "segments", options->number_of_segments);
+	BENCH_json_integer(json, "discontinuities", options->number_of_discontinuities);
+	BENCH_json_number(json, "gap", options->gap_duration);
+	BENCH_json_integer(json, "encrypt", options->encrypt);
+	BENCH_json_number(json, "records_per_hour", options->records_per_hour);
+	BENCH_json_integer(json, "threads", options->number_of_threads);
+	BENCH_json_integer(json, "repeats", options->repeats);
+	BENCH_json_integer(json, "window_samples", options->window_samples);
+	BENCH_json_integer(json, "cipher_bytes", options->cipher_bytes);
+	BENCH_json_integer(json, "reuse", options->reuse);
+	BENCH_json_end(json);
+
+
+	return;
+}
+
+
+static int	BENCH_compare_sf8(const void *a, const void *b)
+{
+	sf8	x = *((const sf8 *) a), y = *((const sf8 *) b);
+
+
+	return((x > y) - (x < y));
+}
+
+
+sf8	BENCH_median(sf8 *values, si4 n)
+{
+	// sorts values
+	if (n <= 0)
+		return(NAN);
+	qsort((void *) values, (size_t) n, sizeof(sf8), BENCH_compare_sf8);
+
+
+	return((n % 2) ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2.0);
+}
+
+
+si4	BENCH_parse_options(BENCH_OPTIONS *options, si4 argc, si1 **argv, const si1 *usage_notes)
+{
+	si4	i;
+	si1	*name, *value, relative_path[BENCH_PATH_BYTES];
+
+
+	// returns 0 to run, 1 if usage was asked for, -1 on error (usage printed to stderr)
+	memset((void *) options, 0, sizeof(BENCH_OPTIONS));
+	strncpy(options->path, BENCH_PATH_DEFAULT, BENCH_PATH_BYTES - 1);
+	options->number_of_channels = BENCH_CHANNELS_DEFAULT;
+	options->sampling_frequency = BENCH_SAMPLING_FREQUENCY_DEFAULT;
+	options->duration = BENCH_DURATION_DEFAULT;
+	options->number_of_segments = BENCH_SEGMENTS_DEFAULT;
+	options->number_of_discontinuities = BENCH_DISCONTINUITIES_DEFAULT;
+	options->gap_duration = BENCH_GAP_DEFAULT;
+	options->records_per_hour = BENCH_RECORDS_PER_HOUR_DEFAULT;
+	options->repeats = BENCH_REPEATS_DEFAULT;
+	options->window_samples = BENCH_WINDOW_SAMPLES_DEFAULT;
+	options->cipher_bytes = BENCH_CIPHER_BYTES_DEFAULT;
+
+	for (i = 1; i < argc; ++i) {
+		name = argv[i];
+		if (!strcmp(name, "-h") || !strcmp(name, "--help")) {
+			BENCH_usage(argv[0], usage_notes);
+			return(1);
+		}
+		if (!strcmp(name, "--encrypt")) {
+			options->encrypt = 1;
+			continue;
+		}
+		if (!strcmp(name, "--reuse")) {
+			options->reuse = 1;
+			continue;
+		}
+		if (i + 1 >= argc) {
+			fprintf(stderr, "%s: %s needs a value\n\n", argv[0], name);
+			BENCH_usage(argv[0], usage_notes);
+			return(-1);
+		}
+		value = argv[++i];
+		if (!strcmp(name, "--path"))
+			strncpy(options->path, value, BENCH_PATH_BYTES - 1);
+		else if (!strcmp(name, "--channels"))
+			options->number_of_channels = atoi(value);
+		else if (!strcmp(name, "--rate"))
+			options->sampling_frequency = atof(value);
+		else if (!strcmp(name, "--duration"))
+			options->duration = atof(value);
+		else if (!strcmp(name, "--segments"))
+			options->number_of_segments = atoi(value);
+		else if (!strcmp(name, "--discontinuities"))
+			options->number_of_discontinuities = atoi(value);
+		else if (!strcmp(name, "--gap"))
+			options->gap_duration = atof(value);
+		else if (!strcmp(name, "--records"))
+			options->records_per_hour = atof(value);
+		else if (!strcmp(name, "--threads"))
+			options->number_of_threads = atoi(value);
+		else if (!strcmp(name, "--repeats"))
+			options->repeats = atoi(value);
+		else if (!strcmp(name, "--window"))
+			options->window_samples = atoll(value);
+		else if (!strcmp(name, "--cipher-bytes"))
+			options->cipher_bytes = atoll(value);
+		else {
+			fprintf(stderr, "%s: unknown option %s\n\n", argv[0], name);
+			BENCH_usage(argv[0], usage_notes);
+			return(-1);
+		}
+	}
+
+	if (options->number_of_channels < 1 || options->sampling_frequency <= 0.0 || options->duration * options->sampling_frequency < 1.0 || options->number_of_segments < 1 || options->number_of_discontinuities < 0 || options->gap_duration <= 0.0 || options->records_per_hour < 0.0 || options->number_of_threads < 0 || options->repeats < 1 || options->window_samples < 1 || options->cipher_bytes < 16) {
+		fprintf(stderr, "%s: invalid option value\n\n", argv[0]);
+		BENCH_usage(argv[0], usage_notes);
+		return(-1);
+	}
+	options->cipher_bytes -= options->cipher_bytes % 16;  // whole AES blocks
+
+	// relative paths are taken from the working directory, as the MEF 3.0 library does (without its warnings)
+	#ifndef _WIN32
+		if (options->path[0] != '/' && getenv("PWD") != NULL) {
+			snprintf(relative_path, BENCH_PATH_BYTES, "%s", options->path);
+			if (snprintf(options->path, BENCH_PATH_BYTES, "%s/%s", getenv("PWD"), relative_path) >= BENCH_PATH_BYTES) {
+				fprintf(stderr, "%s: path %s/%s is too long\n", argv[0], getenv("PWD"), relative_path);
+				return(-1);
+			}
+		}
+	#endif
+
+
+	return(0);
+}
+
+
+si8	BENCH_peak_rss_bytes(void)
+{
+	#ifdef _WIN32
+		PROCESS_MEMORY_COUNTERS	counters;
+
+		if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+			return((si8) counters.PeakWorkingSetSize);
+		return(-1);
+	#else
+		struct rusage	usage;
+
+		if (getrusage(RUSAGE_SELF, &usage))
+			return(-1);
+		#ifdef __APPLE__
+			return((si8) usage.ru_maxrss);  // bytes
+		#else
+			return((si8) usage.ru_maxrss * 1024);  // kilobytes
+		#endif
+	#endif
+}
+
+
+void	BENCH_signal(si4 *samples, si8 number_of_samples, si8 first_sample, si4 channel_number, sf8 sampling_frequency)
+{
+	si8	i;
+	ui8	z;
+	sf8	t, phase, noise;
+
+
+	// EEG-like test signal: alpha rhythm, slow drift & line noise plus white noise, in stored units
+	// a function of the (channel-relative) sample number only, so the signal does not depend on how it is written
+	phase = 0.7 * (sf8) channel_number;
+	for (i = 0; i < number_of_samples; ++i) {
+		t = (sf8) (first_sample + i) / sampling_frequency;
+		z = ((ui8) (first_sample + i) << 8) + (ui8) channel_number + 0x9E3779B97F4A7C15ULL;  // splitmix64
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		z ^= z >> 31;
+		noise = ((sf8) (z >> 11) / (sf8) (1ULL << 53)) - 0.5;
+		samples[i] = (si4) lround(BENCH_SIGNAL_AMPLITUDE * ((0.5 * sin(2.0 * M_PI * 10.0 * t + phase)) + (0.2 * sin(2.0 * M_PI * 0.5 * t)) + (0.1 * sin(2.0 * M_PI * 60.0 * t)) + (0.2 * noise)));
+	}
+
+
+	return;
+}
+
+
+sf8	BENCH_time(void)
+{
+	// seconds, monotonic
+	#ifdef _WIN32
+		LARGE_INTEGER	counter, frequency;
+
+		QueryPerformanceCounter(&counter);
+		QueryPerformanceFrequency(&frequency);
+		return((sf8) counter.QuadPart / (sf8) frequency.QuadPart);
+	#else
+		struct timespec	ts;
+
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return((sf8) ts.tv_sec + ((sf8) ts.tv_nsec * 1e-9));
+	#endif
+}
+
+
+void	BENCH_usage(const si1 *program, const si1 *usage_notes)
+{
+	fprintf(stderr, "usage: %s [options]\n\n", program);
+	fprintf(stderr, "  --path DIR               directory of the synthetic data (default \"%s\")\n", BENCH_PATH_DEFAULT);
+	fprintf(stderr, "  --channels N             number of channels (default %d)\n", BENCH_CHANNELS_DEFAULT);
+	fprintf(stderr, "  --rate HZ                sampling frequency (default %g)\n", BENCH_SAMPLING_FREQUENCY_DEFAULT);
+	fprintf(stderr, "  --duration S             seconds of data per channel (default %g)\n", BENCH_DURATION_DEFAULT);
+	fprintf(stderr, "  --segments N             segments per channel (default %d)\n", BENCH_SEGMENTS_DEFAULT);
+	fprintf(stderr, "  --discontinuities N      time gaps per channel (default %d)\n", BENCH_DISCONTINUITIES_DEFAULT);
+	fprintf(stderr, "  --gap S                  seconds per gap (default %g)\n", BENCH_GAP_DEFAULT);
+	fprintf(stderr, "  --encrypt                encrypt with the password \"%s\"\n", BENCH_PASSWORD);
+	fprintf(stderr, "  --records N              records per hour (default %g)\n", BENCH_RECORDS_PER_HOUR_DEFAULT);
+	fprintf(stderr, "  --threads N              threads of the parallel measurements (default 0: one per processor)\n");
+	fprintf(stderr, "  --repeats N              repetitions of the open measurement (default %d)\n", BENCH_REPEATS_DEFAULT);
+	fprintf(stderr, "  --window N               samples decoded per read (default %lld)\n", (long long) BENCH_WINDOW_SAMPLES_DEFAULT);
+	fprintf(stderr, "  --cipher-bytes N         bytes per CRC & AES measurement (default %lld)\n", (long long) BENCH_CIPHER_BYTES_DEFAULT);
+	fprintf(stderr, "  --reuse                  measure the data already in the path (no generation)\n");
+	if (usage_notes != NULL)
+		fprintf(stderr, "\n%s\n", usage_notes);
+	fprintf(stderr, "\nResults are written to stdout as one JSON object; progress goes to stderr.\n");
+
+
+	return;
+}
@@ -0,0 +1,100 @@
+
+#ifndef MEF_BENCH_IN
+#define MEF_BENCH_IN
+
+
+/************************************************************************************/
+/****************************  MEF Benchmark Common Header  *************************/
+/************************************************************************************/
+
+//  Copyright (c) Richard J. Cui Created: Sun 10/18/2026 10:12:37.415 AM
+//  $Revision: 0.1 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+//
+//  Rocky Creek Dr NE
+//  Rochester, MN 55906, USA
+//
+//  Email: richard.cui@utoronto.ca
+
+// Shared by the standalone benchmarks mef_bench_3p0.c and mef_bench_2p1.c: options, synthetic signal, timing,
+// peak RSS & JSON output. Include after the MEF library (meflib.c or mef_lib_2p1.c), which supplies the size types;
+// the two libraries define the same symbols, so each benchmark is built from one of them only.
+
+// written with tab width = indent width = 8 spaces and a monospaced font
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#ifdef _WIN32
+	#include <windows.h>
+	#include <psapi.h>
+#else
+	#include <time.h>
+	#include <sys/time.h>
+	#include <sys/resource.h>
+#endif
+
+
+// Constants
+#define BENCH_PATH_BYTES			1024
+#define BENCH_PATH_DEFAULT			"mef_bench_data"
+#define BENCH_CHANNELS_DEFAULT			8
+#define BENCH_SAMPLING_FREQUENCY_DEFAULT	1000.0		// Hz
+#define BENCH_DURATION_DEFAULT			600.0		// seconds
+#define BENCH_SEGMENTS_DEFAULT			1
+#define BENCH_DISCONTINUITIES_DEFAULT		0
+#define BENCH_GAP_DEFAULT			1.0		// seconds
+#define BENCH_RECORDS_PER_HOUR_DEFAULT		60.0
+#define BENCH_REPEATS_DEFAULT			3
+#define BENCH_WINDOW_SAMPLES_DEFAULT		((si8) 1 << 20)	// samples decoded per read
+#define BENCH_CIPHER_BYTES_DEFAULT		((si8) 1 << 26)	// bytes hashed / encrypted per CRC & AES measurement
+#define BENCH_START_TIME			((si8) 946684800000000)	// uUTC of the first sample (2000-01-01)
+#define BENCH_PASSWORD				"bench_pw"
+#define BENCH_SIGNAL_AMPLITUDE			2000.0		// stored units
+
+
+// Typedefs & Structures
+typedef struct {
+	si1	path[BENCH_PATH_BYTES];  // directory of the synthetic data (created if needed, kept afterwards)
+	si4	number_of_channels;
+	sf8	sampling_frequency;
+	sf8	duration;  // seconds of data per channel (gaps excluded)
+	si4	number_of_segments;  // MEF 3.0 only
+	si4	number_of_discontinuities;  // time gaps inserted at evenly spaced samples
+	sf8	gap_duration;  // seconds per gap
+	si4	encrypt;  // 1: encrypt the data (and metadata/header) with BENCH_PASSWORD
+	sf8	records_per_hour;  // MEF 3.0 only: Note & Seiz records in the session record files
+	si4	number_of_threads;  // parallel measurements (0: one per processor)
+	si4	repeats;  // repetitions of the open measurement (the fastest & median are reported)
+	si8	window_samples;
+	si8	cipher_bytes;
+	si4	reuse;  // 1: measure existing data in path (no generation)
+} BENCH_OPTIONS;
+
+typedef struct {
+	FILE	*fp;  // written to (a temporary file while the root object is open)
+	FILE	*out;  // receives the complete document
+	si4	depth;
+	si4	first[8];  // no member written yet, per depth
+} BENCH_JSON;
+
+
+// Function Prototypes
+void	BENCH_discontinuity_samples(BENCH_OPTIONS *options, si8 *discontinuity_samples);
+void	BENCH_json_begin(BENCH_JSON *json, const si1 *name);
+void	BENCH_json_end(BENCH_JSON *json);
+void	BENCH_json_integer(BENCH_JSON *json, const si1 *name, si8 value);
+void	BENCH_json_number(BENCH_JSON *json, const si1 *name, sf8 value);
+void	BENCH_json_rate(BENCH_JSON *json, const si1 *name, sf8 amount, sf8 seconds);
+void	BENCH_json_string(BENCH_JSON *json, const si1 *name, const si1 *value);
+void	BENCH_json_options(BENCH_JSON *json, BENCH_OPTIONS *options);
+sf8	BENCH_median(sf8 *values, si4 n);
+si4	BENCH_parse_options(BENCH_OPTIONS *options, si4 argc, si1 **argv, const si1 *usage_notes);
+si8	BENCH_peak_rss_bytes(void);
+void	BENCH_signal(si4 *samples, si8 number_of_samples, si8 first_sample, si4 channel_number, sf8 sampling_frequency);
+sf8	BENCH_time(void);
+void	BENCH_usage(const si1 *program, const si1 *usage_notes);
+
+
+#endif  // MEF_BENCH_IN
@@ -0,0 +1,342 @@
+
+/************************************************************************************/
+/*****************************  MEF 2.1 Library Benchmark  **************************/
+/************************************************************************************/
+
+//  Copyright (c) Richard J. Cui Created: Sun 10/18/2026 10:12:37.415 AM
+//  $Revision: 0.1 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+//
+//  Rocky Creek Dr NE
+//  Rochester, MN 55906, USA
+//
+//  Email: richard.cui@utoronto.ca
+
+// Standalone benchmark of the MEF 2.1 library (no Matlab): generates one synthetic .mef file per channel (sampling
+// rate, duration, discontinuities & session encryption) with write_mef_ind(), then measures the header & index open
+// time, decoding throughput, CRC & AES throughput and the peak resident memory. MEF 2.1 has no segments, records or
+// threaded reader, so those options are ignored. Results are written to stdout as one JSON object.
+//
+// build with the libmef CMake project (target mef_bench_2p1), or from this directory:
+//   cc -O2 -I../mef_2p1 -o mef_bench_2p1 mef_bench_2p1.c ../mef_2p1/mef_lib_2p1.c ../mef_2p1/mef_reader_2p1.c -lm
+
+// written with tab width = indent width = 8 spaces and a monospaced font
+
+
+#include <sys/stat.h>
+#ifdef _WIN32
+	#include <direct.h>
+	#define BENCH_mkdir(path)	_mkdir(path)
+#else
+	#define BENCH_mkdir(path)	mkdir((path), 0755)
+#endif
+#include "mef_reader_2p1.h"
+#include "mef_bench.c"
+
+
+#define BENCH_SESSION_NAME	"bench_2p1"
+#define BENCH_SESSION_PATH_BYTES	(BENCH_PATH_BYTES + 16)	// <path>/BENCH_SESSION_NAME
+#define BENCH_FILE_NAME_BYTES	(BENCH_SESSION_PATH_BYTES + 64)	// <session path>/<channel name>.mef
+#define BENCH_BLOCK_SECONDS	1.0		// block interval of the written files
+#define BENCH_USAGE_NOTES	"The channels are written to <path>/" BENCH_SESSION_NAME "/ch<n>.mef; the directory must not exist unless --reuse is given.\nWith --encrypt, the header & data are session encrypted. --segments, --records & --threads do not apply to MEF 2.1."
+
+
+// Prototypes
+si4	BENCH_2p1_generate_channel(BENCH_OPTIONS *options, si4 channel_number, si1 *session_path, si8 *discontinuity_samples);
+si8	BENCH_2p1_decode(MEF_READER_2P1 **readers, BENCH_OPTIONS *options, si8 *failed_blocks, si4 *verified);
+
+
+si4	BENCH_2p1_generate_channel(BENCH_OPTIONS *options, si4 channel_number, si1 *session_path, si8 *discontinuity_samples)
+{
+	MEF_HEADER_INFO	header;
+	INDEX_DATA	*index_block;
+	si1		file_name[BENCH_FILE_NAME_BYTES], password[SESSION_PASSWORD_LENGTH];
+	si4		*samples, number_of_blocks, next_discontinuity, ret_val;
+	si8		sample, number_of_samples, samples_per_block, maximum_blocks, run_end, gap_time;
+
+
+	// whole channel in memory (write_mef_ind() takes it at once); a gap always starts a new block, whose time
+	// stamp carries the jump, so the library flags the discontinuities itself
+	number_of_samples = (si8) (options->duration * options->sampling_frequency);
+	samples_per_block = (si8) ((BENCH_BLOCK_SECONDS * options->sampling_frequency) + 0.5);
+	if (samples_per_block > number_of_samples)
+		samples_per_block = number_of_samples;
+	if (samples_per_block < 2) {
+		fprintf(stderr, "%s(): fewer than 2 samples per block\n", __FUNCTION__);
+		return(-1);
+	}
+	maximum_blocks = (number_of_samples / samples_per_block) + options->number_of_discontinuities + 1;
+	samples = (si4 *) malloc((size_t) number_of_samples * sizeof(si4));
+	index_block = (INDEX_DATA *) calloc((size_t) maximum_blocks, sizeof(INDEX_DATA));
+	if (samples == NULL || index_block == NULL) {
+		fprintf(stderr, "%s(): not enough memory for %lld samples\n", __FUNCTION__, (long long) number_of_samples);
+		free(samples);
+		free(index_block);
+		return(-1);
+	}
+	BENCH_signal(samples, number_of_samples, 0, channel_number, options->sampling_frequency);
+
+	number_of_blocks = 0;
+	next_discontinuity = 0;
+	gap_time = 0;
+	for (sample = 0; sample < number_of_samples; sample = run_end) {
+		while (next_discontinuity < options->number_of_discontinuities && sample == discontinuity_samples[next_discontinuity]) {
+			gap_time += (si8) (options->gap_duration * 1e6);
+			++next_discontinuity;
+		}
+		run_end = (next_discontinuity < options->number_of_discontinuities) ? discontinuity_samples[next_discontinuity] : number_of_samples;
+		for (; sample < run_end; sample += samples_per_block) {
+			index_block[number_of_blocks].time = (ui8) (BENCH_START_TIME + gap_time + (si8) ((((sf8) sample * 1e6) / options->sampling_frequency) + 0.5));
+			index_block[number_of_blocks].sample_number = (ui8) sample;
+			++number_of_blocks;
+		}
+	}
+
+	init_hdr_struct(&header);
+	snprintf(header.institution, INSTITUTION_LENGTH, "MEF_import benchmark");
+	snprintf(header.channel_name, CHANNEL_NAME_LENGTH, "ch%03d", channel_number + 1);
+	header.sampling_frequency = options->sampling_frequency;
+	header.block_interval = (ui8) ceil(((sf8) samples_per_block * 1e6) / options->sampling_frequency);
+	header.number_of_samples = (ui8) number_of_samples;
+	header.recording_start_time = (ui8) BENCH_START_TIME;
+	header.recording_end_time = index_block[number_of_blocks - 1].time + (ui8) ((((sf8) (number_of_samples - (si8) index_block[number_of_blocks - 1].sample_number) * 1e6) / options->sampling_frequency) + 0.5);
+	header.voltage_conversion_factor = 1.0;
+	header.physical_channel_number = channel_number + 1;
+	memset((void *) password, 0, SESSION_PASSWORD_LENGTH);
+	if (options->encrypt) {
+		header.session_encryption_used = 1;
+		header.data_encryption_used = 1;
+		strncpy2(header.session_password, BENCH_PASSWORD, SESSION_PASSWORD_LENGTH);
+	}
+	snprintf(file_name, BENCH_FILE_NAME_BYTES, "%s/%s.mef", session_path, header.channel_name);
+	ret_val = write_mef_ind(samples, &header, (ui8) number_of_samples, file_name, password, index_block, number_of_blocks, NULL);
+	free(samples);
+	free(index_block);
+
+
+	return((ret_val) ? -1 : 0);
+}
+
+
+si8	BENCH_2p1_decode(MEF_READER_2P1 **readers, BENCH_OPTIONS *options, si8 *failed_blocks, si4 *verified)
+{
+	MEF_READER_2P1	*reader;
+	si4		*samples, *expected, i;
+	si8		decoded, n_failed, n_samples, start, end, j;
+
+
+	// decodes every sample of every channel through the reader API, a window at a time (blocks failing their CRC
+	// are counted); the first window of each channel is checked against the synthetic signal
+	samples = (si4 *) malloc((size_t) options->window_samples * sizeof(si4));
+	if (samples == NULL)
+		return(-1);
+	decoded = 0;
+	*failed_blocks = 0;
+	for (i = 0; i < options->number_of_channels; ++i) {
+		reader = readers[i];
+		n_samples = (si8) reader->header.number_of_samples;
+		for (start = 0; start < n_samples; start = end) {
+			end = start + options->window_samples;
+			if (end > n_samples)
+				end = n_samples;
+			n_failed = mef_reader_decode(reader, (ui8) start, (ui8) end, samples);
+			if (n_failed < 0) {
+				free(samples);
+				return(-1);
+			}
+			*failed_blocks += n_failed;
+			decoded += end - start;
+
+			// verify
+			if (start == 0 && verified != NULL) {
+				expected = (si4 *) malloc((size_t) end * sizeof(si4));
+				BENCH_signal(expected, end, 0, reader->header.physical_channel_number - 1, reader->header.sampling_frequency);
+				for (j = 0; j < end; ++j)
+					if (samples[j] != expected[j])
+						*verified = 0;
+				free(expected);
+			}
+		}
+	}
+	free(samples);
+
+
+	return(decoded);
+}
+
+
+int	main(int argc, char **argv)
+{
+	BENCH_OPTIONS		options;
+	BENCH_JSON		json = {0};
+	MEF_READER_2P1		**readers;
+	struct stat		sb;
+	si1			session_path[BENCH_SESSION_PATH_BYTES], file_name[BENCH_FILE_NAME_BYTES], password[SESSION_PASSWORD_LENGTH], key[SESSION_PASSWORD_LENGTH];
+	ui1			expanded_key[AES_ENCRYPTION_KEY_LENGTH], *buffer, *bp;
+	si4			i, ret_val, verified;
+	si8			*discontinuity_samples, n_samples, n_decoded, n_failed, compressed_bytes, j, k;
+	sf8			t0, t1, *open_times;
+	ui4			crc, check;
+
+
+	ret_val = BENCH_parse_options(&options, (si4) argc, (si1 **) argv, BENCH_USAGE_NOTES);
+	if (ret_val)
+		return((ret_val > 0) ? 0 : 1);
+	if (cpu_endianness() == 0) {
+		fprintf(stderr, "%s: the MEF 2.1 reader is only compatible with little-endian machines\n", argv[0]);
+		return(1);
+	}
+	snprintf(session_path, BENCH_SESSION_PATH_BYTES, "%s/%s", options.path, BENCH_SESSION_NAME);
+	memset((void *) password, 0, SESSION_PASSWORD_LENGTH);
+	if (options.encrypt)
+		strncpy2(password, BENCH_PASSWORD, SESSION_PASSWORD_LENGTH);
+
+	json.fp = stdout;
+	BENCH_json_begin(&json, NULL);
+	BENCH_json_string(&json, "benchmark", "mef_bench_2p1");
+	BENCH_json_string(&json, "mef_version", "2.1");
+	BENCH_json_options(&json, &options);
+
+	//
+	// generate
+	//
+	if (options.reuse == 0) {
+		if (stat(session_path, &sb) == 0) {
+			fprintf(stderr, "%s: %s exists; use --reuse to measure it, or another --path\n", argv[0], session_path);
+			return(1);
+		}
+		(void) BENCH_mkdir(options.path);
+		if (BENCH_mkdir(session_path)) {
+			fprintf(stderr, "%s: could not create %s\n", argv[0], session_path);
+			return(1);
+		}
+		fprintf(stderr, "generating %s\n", session_path);
+
+		discontinuity_samples = (si8 *) calloc((size_t) options.number_of_discontinuities + 1, sizeof(si8));
+		BENCH_discontinuity_samples(&options, discontinuity_samples);
+		n_samples = (si8) (options.duration * options.sampling_frequency);
+
+		t0 = BENCH_time();
+		for (i = 0; i < options.number_of_channels; ++i) {
+			if (BENCH_2p1_generate_channel(&options, i, session_path, discontinuity_samples) < 0) {
+				fprintf(stderr, "%s: failed to write channel %d\n", argv[0], i + 1);
+				return(1);
+			}
+		}
+		t1 = BENCH_time();
+
+		BENCH_json_begin(&json, "generate");
+		BENCH_json_integer(&json, "samples", n_samples * options.number_of_channels);
+		BENCH_json_number(&json, "seconds", t1 - t0);
+		BENCH_json_rate(&json, "samples_per_second", (sf8) (n_samples * options.number_of_channels), t1 - t0);
+		BENCH_json_end(&json);
+
+		free(discontinuity_samples);
+	}
+
+	//
+	// open (headers & block indices)
+	//
+	fprintf(stderr, "opening %s\n", session_path);
+	readers = (MEF_READER_2P1 **) calloc((size_t) options.number_of_channels, sizeof(MEF_READER_2P1 *));
+	open_times = (sf8 *) calloc((size_t) options.repeats, sizeof(sf8));
+	for (k = 0; k < options.repeats; ++k) {
+		for (i = 0; i < options.number_of_channels; ++i)
+			mef_reader_close(readers[i]);
+		t0 = BENCH_time();
+		for (i = 0; i < options.number_of_channels; ++i) {
+			snprintf(file_name, BENCH_FILE_NAME_BYTES, "%s/ch%03d.mef", session_path, i + 1);
+			readers[i] = mef_reader_open(file_name, password);
+			if (readers[i] == NULL) {
+				fprintf(stderr, "%s: could not read %s (use --channels to match the data, --encrypt if encrypted)\n", argv[0], file_name);
+				return(1);
+			}
+		}
+		open_times[k] = BENCH_time() - t0;
+	}
+	compressed_bytes = 0;
+	for (i = 0; i < options.number_of_channels; ++i)
+		compressed_bytes += (si8) (readers[i]->header.index_data_offset - readers[i]->index_data[1]);
+	BENCH_json_begin(&json, "open");
+	BENCH_json_integer(&json, "channels", options.number_of_channels);
+	t1 = BENCH_median(open_times, options.repeats);  // sorts
+	BENCH_json_number(&json, "seconds_min", open_times[0]);
+	BENCH_json_number(&json, "seconds_median", t1);
+	BENCH_json_end(&json);
+	free(open_times);
+
+	//
+	// decode
+	//
+	fprintf(stderr, "decoding (1 thread)\n");
+	verified = 1;
+	t0 = BENCH_time();
+	n_decoded = BENCH_2p1_decode(readers, &options, &n_failed, &verified);
+	t1 = BENCH_time();
+	if (n_decoded < 0) {
+		fprintf(stderr, "%s: could not decode %s\n", argv[0], session_path);
+		return(1);
+	}
+	BENCH_json_begin(&json, "decode");
+	BENCH_json_integer(&json, "threads", 1);
+	BENCH_json_integer(&json, "samples", n_decoded);
+	BENCH_json_integer(&json, "compressed_bytes", compressed_bytes);
+	BENCH_json_integer(&json, "failed_blocks", n_failed);
+	BENCH_json_integer(&json, "verified", verified);
+	BENCH_json_number(&json, "seconds", t1 - t0);
+	BENCH_json_rate(&json, "samples_per_second", (sf8) n_decoded, t1 - t0);
+	BENCH_json_rate(&json, "compressed_megabytes_per_second", (sf8) compressed_bytes / 1e6, t1 - t0);
+	BENCH_json_end(&json);
+	for (i = 0; i < options.number_of_channels; ++i)
+		mef_reader_close(readers[i]);
+	free(readers);
+
+	//
+	// CRC & AES
+	//
+	fprintf(stderr, "hashing & encrypting %lld bytes\n", (long long) options.cipher_bytes);
+	buffer = (ui1 *) malloc((size_t) options.cipher_bytes);
+	if (buffer == NULL) {
+		fprintf(stderr, "%s: not enough memory for %lld bytes\n", argv[0], (long long) options.cipher_bytes);
+		return(1);
+	}
+	BENCH_signal((si4 *) buffer, options.cipher_bytes / 4, 0, 0, options.sampling_frequency);
+
+	t0 = BENCH_time();
+	crc = 0xffffffff;
+	for (bp = buffer, j = options.cipher_bytes; j--;)
+		crc = update_crc_32(crc, (si1) *bp++);
+	t1 = BENCH_time();
+	BENCH_json_begin(&json, "crc");
+	BENCH_json_integer(&json, "bytes", options.cipher_bytes);
+	BENCH_json_number(&json, "seconds", t1 - t0);
+	BENCH_json_rate(&json, "megabytes_per_second", (sf8) options.cipher_bytes / 1e6, t1 - t0);
+	BENCH_json_end(&json);
+
+	memset((void *) key, 0, SESSION_PASSWORD_LENGTH);
+	strncpy2(key, BENCH_PASSWORD, SESSION_PASSWORD_LENGTH);
+	AES_KeyExpansion(4, 10, expanded_key, key);
+	t0 = BENCH_time();
+	for (bp = buffer, j = options.cipher_bytes / ENCRYPTION_BLOCK_BYTES; j--; bp += ENCRYPTION_BLOCK_BYTES)
+		AES_encryptWithKey(bp, bp, expanded_key);
+	t1 = BENCH_time();
+	BENCH_json_begin(&json, "aes");
+	BENCH_json_integer(&json, "bytes", options.cipher_bytes);
+	BENCH_json_rate(&json, "encrypt_megabytes_per_second", (sf8) options.cipher_bytes / 1e6, t1 - t0);
+	t0 = BENCH_time();
+	for (bp = buffer, j = options.cipher_bytes / ENCRYPTION_BLOCK_BYTES; j--; bp += ENCRYPTION_BLOCK_BYTES)
+		AES_decryptWithKey(bp, bp, expanded_key);
+	t1 = BENCH_time();
+	BENCH_json_rate(&json, "decrypt_megabytes_per_second", (sf8) options.cipher_bytes / 1e6, t1 - t0);
+	check = 0xffffffff;
+	for (bp = buffer, j = options.cipher_bytes; j--;)
+		check = update_crc_32(check, (si1) *bp++);
+	BENCH_json_integer(&json, "round_trip_matches", check == crc);
+	BENCH_json_end(&json);
+	free(buffer);
+
+	BENCH_json_integer(&json, "peak_rss_bytes", BENCH_peak_rss_bytes());
+	BENCH_json_end(&json);
+
+
+	return(0);
+}
@@ -0,0 +1,428 @@
+
+/************************************************************************************/
+/*****************************  MEF 3.0 Library Benchmark  **************************/
+/************************************************************************************/
+
+//  Copyright (c) Richard J. Cui Created: Sun 10/18/2026 10:12:37.415 AM
+//  $Revision: 0.1 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+//
+//  Rocky Creek Dr NE
+//  Rochester, MN 55906, USA
+//
+//  Email: richard.cui@utoronto.ca
+
+// Standalone benchmark of the MEF 3.0 library (no Matlab): generates a synthetic session (channels, sampling rate,
+// duration, segments, discontinuities, encryption & record density) with the stream writer, then measures the
+// session open time, decoding throughput (one thread & in parallel), CRC & AES throughput, the record query time
+// and the peak resident memory. Results are written to stdout as one JSON object.
+//
+// build with the libmef CMake project (target mef_bench_3p0), or from this directory:
+//   cc -O2 -I../mef_3p0 -o mef_bench_3p0 mef_bench_3p0.c ../mef_3p0/meflib.c ../mef_3p0/mefrec.c ../mef_3p0/mefreader.c -lm -lpthread
+
+// written with tab width = indent width = 8 spaces and a monospaced font
+
+
+#include "mefreader.h"
+#include "mef_bench.c"
+
+
+#define BENCH_SESSION_NAME	"bench"
+#define BENCH_USAGE_NOTES	"The session is written to <path>/" BENCH_SESSION_NAME ".mefd, which must not exist unless --reuse is given.\nWith --encrypt, the metadata section 2, data & records are level 1 encrypted (section 3 level 2)."
+
+
+// Prototypes
+si4	BENCH_3p0_generate_channel(BENCH_OPTIONS *options, FILE_PROCESSING_STRUCT *proto_fps, RED_PROCESSING_STRUCT *proto_rps, si4 channel_number, si1 *session_path, si8 *discontinuity_samples);
+si4	BENCH_3p0_generate_records(BENCH_OPTIONS *options, FILE_PROCESSING_STRUCT *proto_fps, si1 *session_path, si8 number_of_records);
+si8	BENCH_3p0_decode(MEF_READER *reader, BENCH_OPTIONS *options, si8 *failed_blocks, si4 *verified);
+
+
+si4	BENCH_3p0_generate_channel(BENCH_OPTIONS *options, FILE_PROCESSING_STRUCT *proto_fps, RED_PROCESSING_STRUCT *proto_rps, si4 channel_number, si1 *session_path, si8 *discontinuity_samples)
+{
+	TIME_SERIES_STREAM	*stream;
+	si1			channel_path[MEF_FULL_FILE_NAME_BYTES];
+	si4			*samples, next_segment, next_discontinuity;
+	si8			sample, number_of_samples, n, stop, segment_end, gap_time, start_time;
+
+
+	// one channel through the stream writer: segments roll at evenly spaced samples, gaps are time jumps
+	MEF_snprintf(proto_fps->universal_header->channel_name, MEF_BASE_FILE_NAME_BYTES, "ch%03d", channel_number + 1);
+	MEF_snprintf(channel_path, MEF_FULL_FILE_NAME_BYTES, "%s/%s.%s", session_path, proto_fps->universal_header->channel_name, TIME_SERIES_CHANNEL_DIRECTORY_TYPE_STRING);
+	stream = STREAM_open(channel_path, proto_fps, proto_rps, 0, 0, BENCH_START_TIME, STREAM_SYNC_NONE, 0);
+	if (stream == NULL)
+		return(-1);
+
+	number_of_samples = (si8) (options->duration * options->sampling_frequency);
+	samples = (si4 *) e_malloc((size_t) options->window_samples * sizeof(si4), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	next_segment = 1;
+	next_discontinuity = 0;
+	gap_time = 0;
+	for (sample = 0; sample < number_of_samples; sample += n) {
+		segment_end = (next_segment < options->number_of_segments) ? ((si8) next_segment * number_of_samples) / options->number_of_segments : number_of_samples;
+		if (sample == segment_end) {
+			if (STREAM_roll_segment(stream) < 0)
+				break;
+			++next_segment;
+			n = 0;
+			continue;
+		}
+		while (next_discontinuity < options->number_of_discontinuities && sample == discontinuity_samples[next_discontinuity]) {
+			gap_time += (si8) (options->gap_duration * 1e6);
+			++next_discontinuity;
+		}
+		stop = segment_end;
+		if (next_discontinuity < options->number_of_discontinuities && discontinuity_samples[next_discontinuity] < stop)
+			stop = discontinuity_samples[next_discontinuity];
+		n = stop - sample;
+		if (n > options->window_samples)
+			n = options->window_samples;
+		BENCH_signal(samples, n, sample, channel_number, options->sampling_frequency);
+		start_time = BENCH_START_TIME + gap_time + (si8) ((((sf8) sample * 1e6) / options->sampling_frequency) + 0.5);
+		if (STREAM_append(stream, samples, n, start_time) < 0)
+			break;
+	}
+	free(samples);
+
+
+	return((STREAM_close(stream) < 0 || sample < number_of_samples) ? -1 : 0);
+}
+
+
+si4	BENCH_3p0_generate_records(BENCH_OPTIONS *options, FILE_PROCESSING_STRUCT *proto_fps, si1 *session_path, si8 number_of_records)
+{
+	FILE_PROCESSING_STRUCT	*data_fps, *indices_fps;
+	RECORD_HEADER		*rh;
+	RECORD_INDEX		*ri;
+	MEFREC_Seiz_1_0		*seiz;
+	ui1			*rp;
+	si8			i, span, bytes, record_bytes, maximum_record_bytes;
+
+
+	// session level Note & Seiz records (alternating), evenly spaced over the recording (gaps included)
+	if (number_of_records <= 0)
+		return(0);
+	span = (si8) (((options->duration + (options->number_of_discontinuities * options->gap_duration)) * 1e6) + 0.5);
+	data_fps = allocate_file_processing_struct(UNIVERSAL_HEADER_BYTES + (number_of_records * (RECORD_HEADER_BYTES + MEFREC_Seiz_1_0_BYTES)), RECORD_DATA_FILE_TYPE_CODE, NULL, proto_fps, UNIVERSAL_HEADER_BYTES);
+	indices_fps = allocate_file_processing_struct(UNIVERSAL_HEADER_BYTES + (number_of_records * RECORD_INDEX_BYTES), RECORD_INDICES_FILE_TYPE_CODE, NULL, proto_fps, UNIVERSAL_HEADER_BYTES);
+	MEF_strncpy(data_fps->universal_header->file_type_string, RECORD_DATA_FILE_TYPE_STRING, TYPE_BYTES);
+	MEF_strncpy(indices_fps->universal_header->file_type_string, RECORD_INDICES_FILE_TYPE_STRING, TYPE_BYTES);
+	data_fps->universal_header->channel_name[0] = indices_fps->universal_header->channel_name[0] = 0;
+	data_fps->universal_header->segment_number = indices_fps->universal_header->segment_number = UNIVERSAL_HEADER_SESSION_LEVEL_CODE;
+	generate_UUID(data_fps->universal_header->file_UUID);
+	generate_UUID(indices_fps->universal_header->file_UUID);
+
+	rp = data_fps->records;
+	ri = indices_fps->record_indices;
+	bytes = 0;
+	maximum_record_bytes = 0;
+	for (i = 0; i < number_of_records; ++i, ++ri) {
+		rh = (RECORD_HEADER *) rp;
+		memset((void *) rh, 0, RECORD_HEADER_BYTES);
+		rh->version_major = 1;
+		rh->version_minor = 0;
+		rh->time = BENCH_START_TIME + ((i * span) / number_of_records);
+		rh->encryption = (options->encrypt) ? LEVEL_1_ENCRYPTION_DECRYPTED : NO_ENCRYPTION;  // write_MEF_file() encrypts
+		if (i % 2) {
+			MEF_strncpy(rh->type_string, MEFREC_Seiz_TYPE_STRING, TYPE_BYTES);
+			rh->bytes = MEFREC_Seiz_1_0_BYTES;
+			seiz = (MEFREC_Seiz_1_0 *) (rp + MEFREC_Seiz_1_0_OFFSET);
+			memset((void *) seiz, 0, MEFREC_Seiz_1_0_BYTES);
+			seiz->earliest_onset = rh->time;
+			seiz->latest_offset = rh->time + (si8) 30000000;
+			seiz->duration = (si8) 30000000;
+			MEF_snprintf(seiz->annotation, MEFREC_Seiz_1_0_ANNOTATION_BYTES, "synthetic seizure %ld", (long) i);
+		} else {
+			MEF_strncpy(rh->type_string, MEFREC_Note_TYPE_STRING, TYPE_BYTES);
+			rh->bytes = 32;  // padded to a multiple of 16
+			memset((void *) (rp + MEFREC_Note_1_0_TEXT_OFFSET), 0, (size_t) rh->bytes);
+			MEF_snprintf((si1 *) (rp + MEFREC_Note_1_0_TEXT_OFFSET), rh->bytes, "synthetic note %ld", (long) i);
+		}
+		record_bytes = RECORD_HEADER_BYTES + rh->bytes;
+		memset((void *) ri, 0, RECORD_INDEX_BYTES);
+		MEF_strncpy(ri->type_string, rh->type_string, TYPE_BYTES);
+		ri->version_major = rh->version_major;
+		ri->version_minor = rh->version_minor;
+		ri->encryption = (options->encrypt) ? LEVEL_1_ENCRYPTION : NO_ENCRYPTION;
+		ri->file_offset = UNIVERSAL_HEADER_BYTES + bytes;
+		ri->time = rh->time;
+		if (record_bytes > maximum_record_bytes)
+			maximum_record_bytes = record_bytes;
+		bytes += record_bytes;
+		rp += record_bytes;
+	}
+	data_fps->raw_data_bytes = UNIVERSAL_HEADER_BYTES + bytes;
+	data_fps->universal_header->number_of_entries = indices_fps->universal_header->number_of_entries = number_of_records;
+	data_fps->universal_header->maximum_entry_size = maximum_record_bytes;
+	indices_fps->universal_header->maximum_entry_size = RECORD_INDEX_BYTES;
+	data_fps->universal_header->start_time = indices_fps->universal_header->start_time = BENCH_START_TIME;
+	data_fps->universal_header->end_time = indices_fps->universal_header->end_time = BENCH_START_TIME + span;
+
+	MEF_snprintf(data_fps->full_file_name, MEF_FULL_FILE_NAME_BYTES, "%s/%s.%s", session_path, BENCH_SESSION_NAME, RECORD_DATA_FILE_TYPE_STRING);
+	MEF_snprintf(indices_fps->full_file_name, MEF_FULL_FILE_NAME_BYTES, "%s/%s.%s", session_path, BENCH_SESSION_NAME, RECORD_INDICES_FILE_TYPE_STRING);
+	(void) write_MEF_file(data_fps);
+	(void) write_MEF_file(indices_fps);
+
+	// password data belongs to the prototype
+	data_fps->directives.free_password_data = indices_fps->directives.free_password_data = MEF_FALSE;
+	free_file_processing_struct(data_fps);
+	free_file_processing_struct(indices_fps);
+
+
+	return(0);
+}
+
+
+si8	BENCH_3p0_decode(MEF_READER *reader, BENCH_OPTIONS *options, si8 *failed_blocks, si4 *verified)
+{
+	CHANNEL	*channel;
+	si4	*samples, *expected, i;
+	si8	start, end, n_samples, decoded, n_failed, j;
+
+
+	// decodes every sample of every channel through the reader API, a window at a time; the first window of each
+	// channel is checked against the synthetic signal afterwards (not timed here, the caller times the whole call)
+	samples = (si4 *) e_malloc((size_t) options->window_samples * sizeof(si4), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	expected = NULL;
+	decoded = 0;
+	*failed_blocks = 0;
+	for (i = 0; i < reader->number_of_channels; ++i) {
+		channel = reader->channels + i;
+		n_samples = channel->metadata.time_series_section_2->number_of_samples;
+		for (start = 0; start < n_samples; start = end) {
+			end = start + options->window_samples;
+			if (end > n_samples)
+				end = n_samples;
+			n_failed = MEF_READER_decode(reader, i, MEF_READER_RANGE_BY_SAMPLES, start, end, samples, options->window_samples);
+			if (n_failed < 0)
+				return(-1);
+			*failed_blocks += n_failed;
+			decoded += end - start;
+
+			// verify (channel numbers are in the channel names written by this benchmark)
+			if (start == 0 && verified != NULL) {
+				if (expected == NULL)
+					expected = (si4 *) e_malloc((size_t) options->window_samples * sizeof(si4), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+				BENCH_signal(expected, end, 0, atoi(channel->name + 2) - 1, channel->metadata.time_series_section_2->sampling_frequency);
+				for (j = 0; j < end; ++j)
+					if (samples[j] != expected[j])
+						*verified = 0;
+			}
+		}
+	}
+	free(samples);
+	if (expected != NULL)
+		free(expected);
+
+
+	return(decoded);
+}
+
+
+int	main(int argc, char **argv)
+{
+	BENCH_OPTIONS		options;
+	BENCH_JSON		json = {0};
+	FILE_PROCESSING_STRUCT	*proto_fps;
+	RED_PROCESSING_STRUCT	*proto_rps;
+	PASSWORD_DATA		*pwd;
+	MEF_READER		*reader;
+	RECORD_QUERY		query;
+	RECORD_QUERY_RESULT	*result;
+	struct stat		sb;
+	si1			session_path[MEF_FULL_FILE_NAME_BYTES], *password, key[ENCRYPTION_BLOCK_BYTES], expanded_key[ENCRYPTION_KEY_BYTES];
+	ui1			*buffer, *bp;
+	si4			i, ret_val, n_threads, verified;
+	si8			*discontinuity_samples, n_records, n_samples, n_decoded, n_failed, compressed_bytes, j, k;
+	sf8			t0, t1, *open_times;
+	ui4			crc;
+
+
+	ret_val = BENCH_parse_options(&options, (si4) argc, (si1 **) argv, BENCH_USAGE_NOTES);
+	if (ret_val)
+		return((ret_val > 0) ? 0 : 1);
+	(void) initialize_meflib();
+	MEF_context->behavior_on_fail = RETURN_ON_FAIL;
+	n_threads = THREAD_number_of_threads(options.number_of_threads, (si8) 1 << 20);
+	MEF_snprintf(session_path, MEF_FULL_FILE_NAME_BYTES, "%s/%s.%s", options.path, BENCH_SESSION_NAME, SESSION_DIRECTORY_TYPE_STRING);
+	password = (options.encrypt) ? BENCH_PASSWORD : NULL;
+
+	json.fp = stdout;
+	BENCH_json_begin(&json, NULL);
+	BENCH_json_string(&json, "benchmark", "mef_bench_3p0");
+	BENCH_json_string(&json, "mef_version", "3.0");
+	BENCH_json_options(&json, &options);
+	BENCH_json_integer(&json, "worker_threads", n_threads);
+
+	//
+	// generate
+	//
+	if (options.reuse == 0) {
+		if (stat(session_path, &sb) == 0) {
+			fprintf(stderr, "%s: %s exists; use --reuse to measure it, or another --path\n", argv[0], session_path);
+			return(1);
+		}
+		fprintf(stderr, "generating %s\n", session_path);
+
+		proto_fps = allocate_file_processing_struct(METADATA_FILE_BYTES, TIME_SERIES_METADATA_FILE_TYPE_CODE, NULL, NULL, 0);
+		MEF_strncpy(proto_fps->universal_header->session_name, BENCH_SESSION_NAME, MEF_BASE_FILE_NAME_BYTES);
+		proto_fps->metadata.time_series_section_2->sampling_frequency = options.sampling_frequency;
+		proto_fps->metadata.time_series_section_2->units_conversion_factor = 1.0;
+		proto_rps = RED_allocate_processing_struct(0, 0, 0, 0, 0, 0, NULL);
+		if (options.encrypt) {
+			pwd = process_password_data(NULL, BENCH_PASSWORD, BENCH_PASSWORD "_2", proto_fps->universal_header);
+			proto_fps->password_data = pwd;
+			proto_fps->metadata.section_1->section_2_encryption = LEVEL_1_ENCRYPTION_DECRYPTED;  // write_MEF_file() encrypts
+			proto_fps->metadata.section_1->section_3_encryption = LEVEL_2_ENCRYPTION_DECRYPTED;
+			proto_rps->password_data = pwd;
+			proto_rps->directives.encryption_level = LEVEL_1_ENCRYPTION;
+		}
+		discontinuity_samples = (si8 *) e_calloc((size_t) options.number_of_discontinuities + 1, sizeof(si8), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+		BENCH_discontinuity_samples(&options, discontinuity_samples);
+		n_samples = (si8) (options.duration * options.sampling_frequency);
+		n_records = (si8) ((options.records_per_hour * (options.duration / 3600.0)) + 0.5);
+
+		t0 = BENCH_time();
+		for (i = 0; i < options.number_of_channels; ++i) {
+			if (BENCH_3p0_generate_channel(&options, proto_fps, proto_rps, i, session_path, discontinuity_samples) < 0) {
+				fprintf(stderr, "%s: failed to write channel %d\n", argv[0], i + 1);
+				return(1);
+			}
+		}
+		t1 = BENCH_time();
+		if (BENCH_3p0_generate_records(&options, proto_fps, session_path, n_records) < 0) {
+			fprintf(stderr, "%s: failed to write the records\n", argv[0]);
+			return(1);
+		}
+
+		BENCH_json_begin(&json, "generate");
+		BENCH_json_integer(&json, "samples", n_samples * options.number_of_channels);
+		BENCH_json_integer(&json, "records", n_records);
+		BENCH_json_number(&json, "seconds", t1 - t0);
+		BENCH_json_rate(&json, "samples_per_second", (sf8) (n_samples * options.number_of_channels), t1 - t0);
+		BENCH_json_end(&json);
+
+		free(discontinuity_samples);
+		RED_free_processing_struct(proto_rps);
+		free_file_processing_struct(proto_fps);  // frees the password data
+	}
+
+	//
+	// open (metadata, time series & record indices)
+	//
+	fprintf(stderr, "opening %s\n", session_path);
+	open_times = (sf8 *) e_calloc((size_t) options.repeats, sizeof(sf8), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	reader = NULL;
+	for (i = 0; i < options.repeats; ++i) {
+		if (reader != NULL)
+			MEF_READER_close(reader);
+		t0 = BENCH_time();
+		reader = MEF_READER_open(session_path, password, 1);
+		open_times[i] = BENCH_time() - t0;
+		if (reader == NULL || reader->session == NULL) {
+			fprintf(stderr, "%s: could not read %s (encrypted sessions need --encrypt)\n", argv[0], session_path);
+			return(1);
+		}
+	}
+	compressed_bytes = 0;
+	for (i = 0; i < reader->number_of_channels; ++i)
+		for (k = 0; k < reader->channels[i].number_of_segments; ++k)
+			if (reader->channels[i].segments[k].time_series_indices_fps != NULL)
+				for (j = 0; j < reader->channels[i].segments[k].time_series_indices_fps->universal_header->number_of_entries; ++j)
+					compressed_bytes += reader->channels[i].segments[k].time_series_indices_fps->time_series_indices[j].block_bytes;
+	BENCH_json_begin(&json, "open");
+	BENCH_json_integer(&json, "channels", reader->number_of_channels);
+	BENCH_json_integer(&json, "segments", reader->channels[0].number_of_segments);
+	t1 = BENCH_median(open_times, options.repeats);  // sorts
+	BENCH_json_number(&json, "seconds_min", open_times[0]);
+	BENCH_json_number(&json, "seconds_median", t1);
+	BENCH_json_end(&json);
+	free(open_times);
+
+	//
+	// decode
+	//
+	for (k = 0; k < 2; ++k) {
+		fprintf(stderr, "decoding (%d thread%s)\n", (k) ? n_threads : 1, (k && n_threads > 1) ? "s" : "");
+		verified = 1;
+		t0 = BENCH_time();
+		reader->number_of_threads = (k) ? n_threads : 1;
+		n_decoded = BENCH_3p0_decode(reader, &options, &n_failed, (k) ? NULL : &verified);
+		t1 = BENCH_time();
+		if (n_decoded < 0) {
+			fprintf(stderr, "%s: could not decode %s\n", argv[0], session_path);
+			return(1);
+		}
+		BENCH_json_begin(&json, (k) ? "decode_parallel" : "decode");
+		BENCH_json_integer(&json, "threads", (k) ? n_threads : 1);
+		BENCH_json_integer(&json, "samples", n_decoded);
+		BENCH_json_integer(&json, "compressed_bytes", compressed_bytes);
+		BENCH_json_integer(&json, "failed_blocks", n_failed);
+		if (k == 0)
+			BENCH_json_integer(&json, "verified", verified);
+		BENCH_json_number(&json, "seconds", t1 - t0);
+		BENCH_json_rate(&json, "samples_per_second", (sf8) n_decoded, t1 - t0);
+		BENCH_json_rate(&json, "compressed_megabytes_per_second", (sf8) compressed_bytes / 1e6, t1 - t0);
+		BENCH_json_end(&json);
+	}
+
+	//
+	// records
+	//
+	fprintf(stderr, "querying records\n");
+	RECORD_initialize_query(&query, UUTC_NO_ENTRY, UUTC_NO_ENTRY);
+	t0 = BENCH_time();
+	result = RECORD_query_session(reader->session, &query, NULL);
+	t1 = BENCH_time();
+	BENCH_json_begin(&json, "records");
+	BENCH_json_integer(&json, "records", (result != NULL) ? result->number_of_records : 0);
+	BENCH_json_number(&json, "seconds", t1 - t0);
+	BENCH_json_end(&json);
+	if (result != NULL)
+		RECORD_free_query_result(result, MEF_TRUE);
+	MEF_READER_close(reader);
+
+	//
+	// CRC & AES
+	//
+	fprintf(stderr, "hashing & encrypting %lld bytes\n", (long long) options.cipher_bytes);
+	buffer = (ui1 *) e_malloc((size_t) options.cipher_bytes, __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	BENCH_signal((si4 *) buffer, options.cipher_bytes / 4, 0, 0, options.sampling_frequency);
+
+	t0 = BENCH_time();
+	crc = CRC_calculate(buffer, options.cipher_bytes);
+	t1 = BENCH_time();
+	BENCH_json_begin(&json, "crc");
+	BENCH_json_integer(&json, "bytes", options.cipher_bytes);
+	BENCH_json_number(&json, "seconds", t1 - t0);
+	BENCH_json_rate(&json, "megabytes_per_second", (sf8) options.cipher_bytes / 1e6, t1 - t0);
+	t0 = BENCH_time();
+	ret_val = (CRC_calculate_parallel(buffer, options.cipher_bytes, n_threads) == crc);
+	t1 = BENCH_time();
+	BENCH_json_integer(&json, "parallel_matches", ret_val);
+	BENCH_json_rate(&json, "parallel_megabytes_per_second", (sf8) options.cipher_bytes / 1e6, t1 - t0);
+	BENCH_json_end(&json);
+
+	memset((void *) key, 0, ENCRYPTION_BLOCK_BYTES);
+	strncpy(key, BENCH_PASSWORD, ENCRYPTION_BLOCK_BYTES - 1);
+	AES_key_expansion((ui1 *) expanded_key, key);
+	t0 = BENCH_time();
+	for (bp = buffer, j = options.cipher_bytes / ENCRYPTION_BLOCK_BYTES; j--; bp += ENCRYPTION_BLOCK_BYTES)
+		AES_encrypt(bp, bp, NULL, (ui1 *) expanded_key);
+	t1 = BENCH_time();
+	BENCH_json_begin(&json, "aes");
+	BENCH_json_integer(&json, "bytes", options.cipher_bytes);
+	BENCH_json_rate(&json, "encrypt_megabytes_per_second", (sf8) options.cipher_bytes / 1e6, t1 - t0);
+	t0 = BENCH_time();
+	for (bp = buffer, j = options.cipher_bytes / ENCRYPTION_BLOCK_BYTES; j--; bp += ENCRYPTION_BLOCK_BYTES)
+		AES_decrypt(bp, bp, NULL, (ui1 *) expanded_key);
+	t1 = BENCH_time();
+	BENCH_json_rate(&json, "decrypt_megabytes_per_second", (sf8) options.cipher_bytes / 1e6, t1 - t0);
+	BENCH_json_integer(&json, "round_trip_matches", CRC_calculate(buffer, options.cipher_bytes) == crc);
+	BENCH_json_end(&json);
+	free(buffer);
+
+	BENCH_json_integer(&json, "peak_rss_bytes", BENCH_peak_rss_bytes());
+	BENCH_json_end(&json);
+
+
+	return(0);
+}
@@ -58,7 +58,7 @@
 
 /*
 modified by Richard J. Cui.
-$Revision: 0.1 $  $Date: Wed 11/04/2020  3:44:48.644 PM $
+$Revision: 0.2 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
 
 Rocky Creek Dr NE
 Rochester, MN 55906, USA
@@ -372,6 +372,8 @@ si4		check_header_block_alignment(ui1 *, si4);
 void		strncpy2(si1 *, si1 *, si4);
 void		init_hdr_struct(MEF_HEADER_INFO *);
 si4		write_mef(si4 *, MEF_HEADER_INFO *, ui8, si1 *, si1 *);
+si4		write_mef_ind(si4 *, MEF_HEADER_INFO *, ui8, si1 *, si1 *, INDEX_DATA *, si4, ui1 *);
+si4		validate_mef(char *, char *, char *);
 si4		build_RED_block_header(ui1 *, RED_BLOCK_HDR_INFO *);
 si4		read_RED_block_header(ui1 *, RED_BLOCK_HDR_INFO *);
 ui4		calculate_compressed_block_CRC(ui1 *);
@@ -1548,7 +1548,7 @@ ui4 update_crc_32(ui4 crc, si1 c ) {
 }  /* update_crc_32 */
 
 
-inline void dec_normalize(ui4 *range, ui4 *low_bound, ui1 *in_byte, ui1 **ib_p)
+static inline void dec_normalize(ui4 *range, ui4 *low_bound, ui1 *in_byte, ui1 **ib_p)
 {
 	ui4 low, rng;
 	ui1 in, *ib;
@@ -1687,7 +1687,7 @@ ui8 RED_decompress_block(ui1 *in_buffer, si4 *out_buffer, si1 *diff_buffer, ui1
 
 
 
-inline void enc_normalize(RANGE_STATS *rstats)
+static inline void enc_normalize(RANGE_STATS *rstats)
 {
 	while (rstats->range <= BOTTOM_VALUE) {
 		if (rstats->low_bound < (ui4 ) CARRY_CHECK) {		// no carry possible => output
@@ -1710,7 +1710,7 @@ inline void enc_normalize(RANGE_STATS *rstats)
 }
 
 
-inline void encode_symbol(ui1 symbol, ui4 symbol_cnts, ui4 cnts_lt_symbol, ui4 tot_cnts, RANGE_STATS *rstats )
+static inline void encode_symbol(ui1 symbol, ui4 symbol_cnts, ui4 cnts_lt_symbol, ui4 tot_cnts, RANGE_STATS *rstats )
 {
 	ui4	r, tmp;
 	
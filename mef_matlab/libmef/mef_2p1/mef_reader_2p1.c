@@ -0,0 +1,226 @@
+/*
+mef_reader_2p1.c
+
+Reader API of libmef21 (see mef_reader_2p1.h)
+
+Copyright (c) Richard J. Cui Created: Sun 10/18/2026 10:12:37.415 AM
+$Revision: 0.1 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+
+Rocky Creek Dr NE
+Rochester, MN 55906, USA
+
+Email: richard.cui@utoronto.ca
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "mef_reader_2p1.h"
+
+
+si4	mef_reader_api_version(void)
+{
+	return(MEF_READER_API_VERSION);
+}
+
+
+void	mef_reader_close(MEF_READER_2P1 *reader)
+{
+	if (reader == NULL)
+		return;
+
+	if (reader->fp != NULL)
+		fclose(reader->fp);
+	free(reader->index_data);
+	free(reader->compressed_data);
+	free(reader->difference_buffer);
+	free(reader->block_samples);
+	free(reader);
+
+	return;
+}
+
+
+si8	mef_reader_decode(MEF_READER_2P1 *reader, ui8 start_sample, ui8 end_sample, si4 *samples)
+{
+	RED_BLOCK_HDR_INFO	block_hdr;
+	ui1			*cdp, *block_end;
+	si4			*dp, *block_out;
+	si8			first_block, n_blocks, block, n_failed;
+	ui8			start_offset, end_offset, n_bytes, block_start, block_samples, skip, keep, i;
+
+	// decodes samples [start_sample, end_sample) into samples[0 ... end_sample - start_sample - 1]; the blocks are read
+	// with one fread(), and decoded straight into the output unless only part of the block is requested
+	n_blocks = mef_reader_query_index(reader, start_sample, end_sample, &first_block);
+	if (n_blocks <= 0)
+		return(n_blocks);
+	if (samples == NULL)
+		return(-1);
+
+	start_offset = reader->index_data[3 * first_block + 1];
+	if (first_block + n_blocks < (si8) reader->header.number_of_index_entries)
+		end_offset = reader->index_data[3 * (first_block + n_blocks) + 1];
+	else
+		end_offset = reader->header.index_data_offset;
+	n_bytes = end_offset - start_offset;
+	if (n_bytes > reader->compressed_data_bytes) {
+		free(reader->compressed_data);
+		reader->compressed_data = (ui1 *) malloc((size_t) n_bytes);
+		reader->compressed_data_bytes = (reader->compressed_data == NULL) ? 0 : n_bytes;
+		if (reader->compressed_data == NULL)
+			return(-1);
+	}
+	if (fseek(reader->fp, (long) start_offset, SEEK_SET) || fread((void *) reader->compressed_data, sizeof(ui1), (size_t) n_bytes, reader->fp) != (size_t) n_bytes)
+		return(-1);
+
+	n_failed = 0;
+	dp = samples;
+	for (block = first_block; block < first_block + n_blocks; ++block) {
+		cdp = reader->compressed_data + (reader->index_data[3 * block + 1] - start_offset);  // from the index: a bad block cannot misplace the next
+		if (block + 1 < (si8) reader->header.number_of_index_entries) {
+			block_end = reader->compressed_data + (reader->index_data[3 * (block + 1) + 1] - start_offset);
+			block_samples = reader->index_data[3 * (block + 1) + 2] - reader->index_data[3 * block + 2];
+		} else {
+			block_end = reader->compressed_data + n_bytes;
+			block_samples = reader->header.number_of_samples - reader->index_data[3 * block + 2];
+		}
+		block_start = reader->index_data[3 * block + 2];
+		skip = (start_sample > block_start) ? start_sample - block_start : 0;
+		keep = ((end_sample < block_start + block_samples) ? end_sample - block_start : block_samples) - skip;
+
+		// check the block
+		if (cdp + BLOCK_HEADER_BYTES > block_end || read_RED_block_header(cdp, &block_hdr) ||
+		    cdp + BLOCK_HEADER_BYTES + block_hdr.compressed_bytes > block_end || (ui8) block_hdr.sample_count != block_samples ||
+		    block_samples > reader->header.maximum_block_length ||
+		    (reader->validate_CRC == MEF_TRUE && calculate_compressed_block_CRC(cdp) != block_hdr.CRC_32)) {
+			for (i = 0; i < keep; ++i)
+				*dp++ = MEF_READER_FAILED_SAMPLE;
+			++n_failed;
+			continue;
+		}
+
+		// decode
+		block_out = (skip == 0 && keep == block_samples) ? dp : reader->block_samples;
+		(void) RED_decompress_block(cdp, block_out, reader->difference_buffer, reader->encryption_key, 0, reader->header.data_encryption_used, &block_hdr);
+		if (block_out != dp)
+			memcpy((void *) dp, (void *) (block_out + skip), (size_t) keep * sizeof(si4));
+		dp += keep;
+	}
+
+	return(n_failed);
+}
+
+
+MEF_READER_2P1	*mef_reader_open(si1 *file_name, si1 *password)
+{
+	MEF_READER_2P1	*reader;
+	ui1		*header;
+	si1		password_copy[SESSION_PASSWORD_LENGTH];
+	ui8		n_fields;
+	si4		ok;
+
+	// header (decrypted with the password), block index & decoding buffers; the file stays open until closed
+	if (file_name == NULL || cpu_endianness() == 0)  // the reader only handles little-endian machines
+		return(NULL);
+	reader = (MEF_READER_2P1 *) calloc((size_t) 1, sizeof(MEF_READER_2P1));
+	header = (ui1 *) malloc(MEF_HEADER_LENGTH);  // malloc to ensure boundary alignment
+	if (reader == NULL || header == NULL) {
+		free(reader);
+		free(header);
+		return(NULL);
+	}
+	reader->validate_CRC = MEF_TRUE;
+	memset((void *) password_copy, 0, SESSION_PASSWORD_LENGTH);
+	if (password != NULL)
+		strncpy2(password_copy, password, SESSION_PASSWORD_LENGTH);
+
+	ok = 0;
+	reader->fp = fopen(file_name, "rb");
+	if (reader->fp != NULL && fread((void *) header, sizeof(ui1), (size_t) MEF_HEADER_LENGTH, reader->fp) == MEF_HEADER_LENGTH &&
+	    read_mef_header_block(header, &reader->header, password_copy) == 0 && reader->header.byte_order_code == 1 &&
+	    reader->header.number_of_index_entries > 0 && reader->header.maximum_block_length > 0) {
+		n_fields = reader->header.number_of_index_entries * 3;
+		reader->index_data = (ui8 *) malloc((size_t) n_fields * sizeof(ui8));
+		reader->difference_buffer = (si1 *) malloc((size_t) reader->header.maximum_block_length * 4);
+		reader->block_samples = (si4 *) malloc((size_t) reader->header.maximum_block_length * sizeof(si4));
+		ok = (reader->index_data != NULL && reader->difference_buffer != NULL && reader->block_samples != NULL &&
+		      fseek(reader->fp, (long) reader->header.index_data_offset, SEEK_SET) == 0 &&
+		      fread((void *) reader->index_data, sizeof(ui8), (size_t) n_fields, reader->fp) == (size_t) n_fields);
+	}
+	free(header);
+	if (!ok) {
+		mef_reader_close(reader);
+		return(NULL);
+	}
+	if (reader->header.data_encryption_used)
+		AES_KeyExpansion(4, 10, reader->encryption_key, reader->header.session_password);
+
+	return(reader);
+}
+
+
+si8	mef_reader_query_index(MEF_READER_2P1 *reader, ui8 start_sample, ui8 end_sample, si8 *first_block)
+{
+	si8	lo, hi, mid, n_entries, last_block;
+
+	// blocks holding samples [start_sample, end_sample), by binary search of the index sample numbers
+	if (reader == NULL || first_block == NULL)
+		return(-1);
+	if (end_sample > reader->header.number_of_samples)
+		end_sample = reader->header.number_of_samples;
+	if (start_sample >= end_sample)
+		return(0);
+	n_entries = (si8) reader->header.number_of_index_entries;
+
+	// last block starting at or before a sample
+	lo = 0; hi = n_entries - 1;
+	while (lo < hi) {
+		mid = (lo + hi + 1) / 2;
+		if (reader->index_data[3 * mid + 2] <= start_sample)
+			lo = mid;
+		else
+			hi = mid - 1;
+	}
+	*first_block = lo;
+	hi = n_entries - 1;
+	while (lo < hi) {
+		mid = (lo + hi + 1) / 2;
+		if (reader->index_data[3 * mid + 2] < end_sample)
+			lo = mid;
+		else
+			hi = mid - 1;
+	}
+	last_block = lo;
+
+	return(last_block - *first_block + 1);
+}
+
+
+si8	mef_reader_sample_for_time(MEF_READER_2P1 *reader, ui8 time)
+{
+	si8	lo, hi, mid, sample, block_samples;
+
+	// sample at a uUTC time: in the block starting last at or before it, at the sampling frequency; -1 if before
+	// the recording or in a gap after a block
+	if (reader == NULL || reader->header.number_of_index_entries == 0 || time < reader->index_data[0])
+		return(-1);
+	lo = 0; hi = (si8) reader->header.number_of_index_entries - 1;
+	while (lo < hi) {
+		mid = (lo + hi + 1) / 2;
+		if (reader->index_data[3 * mid] <= time)
+			lo = mid;
+		else
+			hi = mid - 1;
+	}
+	sample = (si8) (((sf8) (time - reader->index_data[3 * lo]) * reader->header.sampling_frequency) / 1e6);
+	if (lo + 1 < (si8) reader->header.number_of_index_entries)
+		block_samples = (si8) (reader->index_data[3 * (lo + 1) + 2] - reader->index_data[3 * lo + 2]);
+	else
+		block_samples = (si8) (reader->header.number_of_samples - reader->index_data[3 * lo + 2]);
+	if (sample >= block_samples)
+		return(-1);
+
+	return((si8) reader->index_data[3 * lo + 2] + sample);
+}
+
+// [EOF]
@@ -0,0 +1,48 @@
+/*
+mef_reader_2p1.h
+
+Entry points of libmef21 for native callers (Matlab gateways, benchmarks, tools & language bindings): open a .mef file,
+query its block index, and decode a sample range into a buffer owned by the caller. Functions return a negative value
+(or NULL) on failure; decoding returns the number of blocks that could not be decoded (their samples are
+MEF_READER_FAILED_SAMPLE). MEF_READER_API_VERSION changes only when these prototypes or structures change.
+
+Copyright (c) Richard J. Cui Created: Sun 10/18/2026 10:12:37.415 AM
+$Revision: 0.1 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+
+Rocky Creek Dr NE
+Rochester, MN 55906, USA
+
+Email: richard.cui@utoronto.ca
+*/
+
+#ifndef _MEF_READER_2P1_H
+#define _MEF_READER_2P1_H
+
+#include <stdio.h>
+#include "mef_2p1.h"
+
+#define MEF_READER_API_VERSION		1
+#define MEF_READER_FAILED_SAMPLE	((si4) 0x80000000)	// samples of blocks that could not be decoded
+
+typedef struct {
+	FILE		*fp;
+	MEF_HEADER_INFO	header;  // decrypted
+	ui8		*index_data;  // number_of_index_entries (time, file offset, sample number) triplets
+	ui1		encryption_key[AES_ENCRYPTION_KEY_LENGTH];
+	ui1		validate_CRC;  // MEF_TRUE (default): blocks failing their CRC are not decoded
+	ui1		*compressed_data;  // read buffer (grows)
+	ui8		compressed_data_bytes;
+	si1		*difference_buffer;
+	si4		*block_samples;  // first or last block of a range
+} MEF_READER_2P1;
+
+si4		mef_reader_api_version(void);
+void		mef_reader_close(MEF_READER_2P1 *reader);
+si8		mef_reader_decode(MEF_READER_2P1 *reader, ui8 start_sample, ui8 end_sample, si4 *samples);
+MEF_READER_2P1	*mef_reader_open(si1 *file_name, si1 *password);
+si8		mef_reader_query_index(MEF_READER_2P1 *reader, ui8 start_sample, ui8 end_sample, si8 *first_block);
+si8		mef_reader_sample_for_time(MEF_READER_2P1 *reader, ui8 time);
+
+#endif
+
+// [EOF]
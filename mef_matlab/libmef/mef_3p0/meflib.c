@@ -36,7 +36,7 @@
 // set editor preferences to these for intended alignment
 
 //  Modified by Richard J. Cui: Wed 11/04/2020  3:44:48.644 PM
-//  $Revision: 0.1 $  $Date: Wed 11/04/2020  3:44:48.644 PM $
+//  $Revision: 0.7 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
 //
 //  Rocky Creek Dr NE
 //  Rochester, MN 55906, USA
@@ -49,6 +49,15 @@
 // global
 MEF_GLOBALS	*MEF_globals = NULL;
 
+// context bound to the calling thread (NULL: the default context), & the profile timer running on it
+#ifdef _WIN32
+	static __declspec(thread) MEF_CONTEXT	*MEF_thread_context = NULL;
+	static __declspec(thread) PROFILE_TIMER	*PROFILE_thread_timer = NULL;
+#else
+	static __thread MEF_CONTEXT		*MEF_thread_context = NULL;
+	static __thread PROFILE_TIMER		*PROFILE_thread_timer = NULL;
+#endif
+
 #ifdef _WIN32
 	void bzero(void *dest, size_t num)
 	{
@@ -635,6 +644,133 @@ void	AES_sub_bytes(ui1 state[][4])
 /*************************************************************************/
 
 
+/*************************************************************************/
+/****************************  ARENA FUNCTIONS  **************************/
+/*************************************************************************/
+
+
+MEF_ARENA	*ARENA_allocate(si8 slab_bytes)
+{
+	MEF_ARENA	*arena;
+
+
+	// slabs are allocated as needed (slab_bytes <= 0: default size)
+	arena = (MEF_ARENA *) e_calloc((size_t) 1, sizeof(MEF_ARENA), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	if (arena == NULL)
+		return(NULL);
+	if (slab_bytes <= 0)
+		slab_bytes = ARENA_SLAB_BYTES_DEFAULT;
+	arena->slab_bytes = ARENA_ALIGN(slab_bytes);
+
+
+	return(arena);
+}
+
+
+void	*ARENA_calloc(MEF_ARENA *arena, size_t n_members, size_t size, const si1 *function, si4 line, ui4 behavior_on_fail)
+{
+	si8		bytes, slab_bytes;
+	ARENA_SLAB	*slab;
+	ui1		*ptr;
+
+
+	// zeroed & aligned memory from the arena (NULL arena: e_calloc())
+	if (arena == NULL)
+		return(e_calloc(n_members, size, function, line, behavior_on_fail));
+
+	bytes = ARENA_ALIGN((si8) n_members * (si8) size);
+	if (bytes == 0)
+		bytes = ARENA_ALIGNMENT_BYTES;
+
+	// room in the current slab
+	slab = arena->slabs;
+	if (slab != NULL && slab->used_bytes + bytes <= slab->bytes) {
+		ptr = slab->data + slab->used_bytes;
+		slab->used_bytes += bytes;
+		arena->used_bytes += bytes;
+		++arena->allocations;
+		return((void *) ptr);
+	}
+
+	// new slab: large requests get one of their own, behind the current slab (which keeps filling)
+	slab_bytes = (bytes > arena->slab_bytes / ARENA_DEDICATED_SLAB_DIVISOR) ? bytes : arena->slab_bytes;
+	slab = (ARENA_SLAB *) e_calloc((size_t) 1, (size_t) (ARENA_ALIGN(sizeof(ARENA_SLAB)) + slab_bytes), function, line, behavior_on_fail);
+	if (slab == NULL)
+		return(NULL);
+	slab->data = (ui1 *) slab + ARENA_ALIGN(sizeof(ARENA_SLAB));
+	slab->bytes = slab_bytes;
+	slab->used_bytes = bytes;
+	if (slab_bytes == bytes && arena->slabs != NULL) {
+		slab->next = arena->slabs->next;
+		arena->slabs->next = slab;
+	} else {
+		slab->next = arena->slabs;
+		arena->slabs = slab;
+	}
+	arena->allocated_bytes += slab_bytes;
+	arena->used_bytes += bytes;
+	++arena->allocations;
+
+
+	return((void *) slab->data);
+}
+
+
+si4	ARENA_contains(MEF_ARENA *arena, void *ptr)
+{
+	ARENA_SLAB	*slab;
+
+
+	if (arena == NULL || ptr == NULL)
+		return(MEF_FALSE);
+
+	for (slab = arena->slabs; slab != NULL; slab = slab->next)
+		if ((ui1 *) ptr >= slab->data && (ui1 *) ptr < slab->data + slab->bytes)
+			return(MEF_TRUE);
+
+
+	return(MEF_FALSE);
+}
+
+
+void	ARENA_free(MEF_ARENA *arena)
+{
+	ARENA_SLAB	*slab, *next_slab;
+
+
+	// releases every allocation from the arena, & the arena
+	if (arena == NULL)
+		return;
+
+	for (slab = arena->slabs; slab != NULL; slab = next_slab) {
+		next_slab = slab->next;
+		free((void *) slab);
+	}
+	free((void *) arena);
+
+
+	return;
+}
+
+
+void	ARENA_release(MEF_ARENA *arena, void *ptr)
+{
+	// frees heap memory; arena memory is left to ARENA_free()
+	if (ptr == NULL || ARENA_contains(arena, ptr) == MEF_TRUE)
+		return;
+
+	free(ptr);
+
+
+	return;
+}
+
+
+/*************************************************************************/
+/**************************  END ARENA FUNCTIONS  ************************/
+/*************************************************************************/
+
+
 si1	all_zeros(ui1 *bytes, si4 field_length)
 {
 	while (field_length--)
@@ -651,14 +787,15 @@ FILE_PROCESSING_STRUCT	*allocate_file_processing_struct(si8 raw_data_bytes, ui4
         FILE_PROCESSING_STRUCT	*fps;
         void			*data_ptr;
 	
-	// allocate
-        fps = (FILE_PROCESSING_STRUCT *) e_calloc((size_t) 1, sizeof(FILE_PROCESSING_STRUCT), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	// allocate (from the arena of a session or channel being read)
+        fps = (FILE_PROCESSING_STRUCT *) ARENA_calloc(MEF_context->arena, (size_t) 1, sizeof(FILE_PROCESSING_STRUCT), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	fps->arena = MEF_context->arena;
 	
 	// zero metadata structure because calloc() does not zero substructues and arrays
 	fps->metadata.section_1 = NULL; fps->metadata.time_series_section_2 = NULL; fps->metadata.video_section_2 = NULL; fps->metadata.section_3 = NULL;
 	
 	if (raw_data_bytes > 0) {
-        	fps->raw_data = (ui1 *) e_calloc((size_t) raw_data_bytes, sizeof(ui1), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+        	fps->raw_data = (ui1 *) ARENA_calloc(fps->arena, (size_t) raw_data_bytes, sizeof(ui1), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
 		if (raw_data_bytes >= UNIVERSAL_HEADER_BYTES)
 			fps->universal_header = (UNIVERSAL_HEADER *) fps->raw_data; // all files start with universal header
         }
@@ -673,7 +810,7 @@ FILE_PROCESSING_STRUCT	*allocate_file_processing_struct(si8 raw_data_bytes, ui4
                 fps->password_data = proto_fps->password_data;
                 if ((bytes_to_copy > proto_fps->raw_data_bytes) || (bytes_to_copy > fps->raw_data_bytes)) {
                         fprintf(stderr, "Error: copy request size exceeds avaiable data => no copying done [function \"%s\", line %d]\n", __FUNCTION__, __LINE__);
-                        if (MEF_globals->behavior_on_fail & EXIT_ON_FAIL) {
+                        if (MEF_context->behavior_on_fail & EXIT_ON_FAIL) {
                                 (void) fprintf(stderr, "\t=> exiting program\n\n");
         			exit(1);
                         }
@@ -732,12 +869,13 @@ FILE_PROCESSING_STRUCT	*allocate_file_processing_struct(si8 raw_data_bytes, ui4
                         break;
                 case RECORD_INDICES_FILE_TYPE_CODE:
                         fps->record_indices = (RECORD_INDEX *) data_ptr;
+                        fps->record_indices_order = RECORD_INDICES_ORDER_UNKNOWN;
                         break;
                 default:
-                        free(fps->raw_data);
-                        free(fps);
+                        ARENA_release(fps->arena, fps->raw_data);
+                        ARENA_release(fps->arena, fps);
                         fprintf(stderr, "Error: unrecognized type code \"0x%x\" [function \"%s\", line %d]\n", file_type_code, __FUNCTION__, __LINE__);
-                        if (MEF_globals->behavior_on_fail & EXIT_ON_FAIL) {
+                        if (MEF_context->behavior_on_fail & EXIT_ON_FAIL) {
                                 (void) fprintf(stderr, "\t=> exiting program\n\n");
         			exit(1);
                         }
@@ -749,6 +887,45 @@ FILE_PROCESSING_STRUCT	*allocate_file_processing_struct(si8 raw_data_bytes, ui4
 }
 
 
+RUNNING_PERCENTILE	*allocate_running_percentile(sf8 *x, si4 span, sf8 prop)
+{
+	RUNNING_PERCENTILE	*rp;
+	NODE			*nodes;
+	si4			i, low_count;
+	
+	
+	// span should be odd, as in proportion_filt(); x must contain the first span values of the window
+	rp = (RUNNING_PERCENTILE *) e_calloc((size_t) 1, sizeof(RUNNING_PERCENTILE), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	rp->vals = (sf8 *) e_calloc((size_t) span, sizeof(sf8), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	rp->heap = (si4 *) e_calloc((size_t) span, sizeof(si4), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	rp->heap_pos = (si4 *) e_calloc((size_t) span, sizeof(si4), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	nodes = (NODE *) e_calloc((size_t) span, sizeof(NODE), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	
+	low_count = (si4) (((sf8) (span - 1) * prop) + 0.5) + 1;
+	rp->span = span;
+	rp->low_count = low_count;
+	rp->oldest_slot = 0;
+	
+	// a sorted array satisfies both heap properties: low heap descending from its root, high heap ascending from its root
+	for (i = 0; i < span; ++i) {
+		rp->vals[i] = nodes[i].val = x[i];
+		nodes[i].idx = i;
+	}
+	qsort(nodes, span, sizeof(NODE), sort_by_val);
+	for (i = 0; i < low_count; ++i)
+		rp->heap[i] = nodes[low_count - 1 - i].idx;
+	for (; i < span; ++i)
+		rp->heap[i] = nodes[i].idx;
+	for (i = 0; i < span; ++i)
+		rp->heap_pos[rp->heap[i]] = i;
+	
+	free(nodes);
+	
+	
+	return(rp);
+}
+
+
 inline void	apply_recording_time_offset(si8 *time)
 {
         if (*time == UUTC_NO_ENTRY)
@@ -758,13 +935,283 @@ inline void	apply_recording_time_offset(si8 *time)
 		return;
 	
 	// apply recording time offset & make negative to indicate application
-	*time = -(*time - MEF_globals->recording_time_offset);
+	*time = -(*time - MEF_context->recording_time_offset);
 	
         
 	return;
 }
 
 
+/*************************************************************************/
+/*************************  BLOCK CACHE FUNCTIONS  ***********************/
+/*************************************************************************/
+
+
+void	BLOCK_CACHE_clear(BLOCK_CACHE *cache)
+{
+	si8	i;
+
+
+	// drops all the entries not in use by a read (counters are kept)
+	THREAD_mutex_lock(&cache->mutex);
+	for (i = 0; i < cache->used_entries; ++i)
+		if (cache->entries[i].in_use == MEF_TRUE && cache->entries[i].pinned == MEF_FALSE)
+			BLOCK_CACHE_remove(cache, i);
+	THREAD_mutex_unlock(&cache->mutex);
+
+
+	return;
+}
+
+
+si4	BLOCK_CACHE_copy(BLOCK_CACHE *cache, ui1 *segment_UUID, si8 block_number, si1 access_level, si4 *samples, si8 skip_samples, si8 number_of_samples)
+{
+	si4			found;
+	si8			i;
+	BLOCK_CACHE_ENTRY	*entry;
+
+
+	// copies number_of_samples samples of a cached block, from skip_samples on; returns MEF_FALSE if not cached
+	// (blocks of segments without a UUID are never cached)
+	if (all_zeros(segment_UUID, UUID_BYTES) == MEF_TRUE)
+		return(MEF_FALSE);
+
+	found = MEF_FALSE;
+	THREAD_mutex_lock(&cache->mutex);
+	for (i = cache->buckets[BLOCK_CACHE_hash(segment_UUID, block_number)]; i != BLOCK_CACHE_NO_ENTRY; i = entry->next) {
+		entry = cache->entries + i;
+		if (entry->block_number != block_number || memcmp(entry->segment_UUID, segment_UUID, UUID_BYTES))
+			continue;
+		if (entry->pinned == MEF_FALSE && entry->encryption_level <= access_level && skip_samples + number_of_samples <= entry->number_of_samples) {
+			memcpy((void *) samples, (void *) (entry->samples + skip_samples), (size_t) number_of_samples * sizeof(si4));
+			entry->referenced = MEF_TRUE;
+			found = MEF_TRUE;
+		}
+		break;
+	}
+	if (found == MEF_TRUE)
+		++cache->hits;
+	else
+		++cache->misses;
+	THREAD_mutex_unlock(&cache->mutex);
+
+
+	return(found);
+}
+
+
+si4	BLOCK_CACHE_evict(BLOCK_CACHE *cache, si8 bytes)
+{
+	si8			steps;
+	BLOCK_CACHE_ENTRY	*entry;
+
+
+	// CLOCK replacement: evicts unreferenced, unpinned entries (clearing reference bits on the way) until bytes more
+	// fit within the budget; returns MEF_FALSE if they cannot (called with the mutex locked)
+	for (steps = 2 * cache->used_entries; cache->bytes + bytes > cache->maximum_bytes && steps > 0; --steps) {
+		if (cache->clock_hand >= cache->used_entries)
+			cache->clock_hand = 0;
+		entry = cache->entries + cache->clock_hand;
+		if (entry->in_use == MEF_TRUE && entry->pinned == MEF_FALSE) {
+			if (entry->referenced == MEF_TRUE) {
+				entry->referenced = MEF_FALSE;
+			} else {
+				BLOCK_CACHE_remove(cache, cache->clock_hand);
+				++cache->evictions;
+			}
+		}
+		++cache->clock_hand;
+	}
+
+
+	return((cache->bytes + bytes <= cache->maximum_bytes) ? MEF_TRUE : MEF_FALSE);
+}
+
+
+void	BLOCK_CACHE_free(BLOCK_CACHE *cache)
+{
+	si8	i;
+
+
+	if (cache == NULL)
+		return;
+
+	for (i = 0; i < cache->used_entries; ++i)
+		if (cache->entries[i].in_use == MEF_TRUE)
+			free((void *) cache->entries[i].samples);
+	if (cache->entries != NULL)
+		free((void *) cache->entries);
+	THREAD_mutex_destroy(&cache->mutex);
+	if (MEF_globals->block_cache == cache)
+		MEF_globals->block_cache = NULL;
+	free((void *) cache);
+
+
+	return;
+}
+
+
+ui4	BLOCK_CACHE_hash(ui1 *segment_UUID, si8 block_number)
+{
+	ui4	hash;
+	si4	i;
+
+
+	// FNV-1a over the UUID & the block number
+	hash = 2166136261u;
+	for (i = 0; i < UUID_BYTES; ++i)
+		hash = (hash ^ (ui4) segment_UUID[i]) * 16777619u;
+	for (i = 0; i < 8; ++i, block_number >>= 8)
+		hash = (hash ^ (ui4) (block_number & 0xFF)) * 16777619u;
+
+
+	return(hash & (BLOCK_CACHE_NUMBER_OF_BUCKETS - 1));
+}
+
+
+BLOCK_CACHE	*BLOCK_CACHE_initialize(si8 maximum_bytes, si4 global_flag)
+{
+	BLOCK_CACHE	*cache;
+	si4		i;
+
+
+	if (global_flag == MEF_TRUE && MEF_globals->block_cache != NULL)
+		return(MEF_globals->block_cache);
+
+	cache = (BLOCK_CACHE *) e_calloc((size_t) 1, sizeof(BLOCK_CACHE), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	cache->maximum_bytes = maximum_bytes;
+	cache->free_entries = BLOCK_CACHE_NO_ENTRY;
+	for (i = 0; i < BLOCK_CACHE_NUMBER_OF_BUCKETS; ++i)
+		cache->buckets[i] = BLOCK_CACHE_NO_ENTRY;
+	THREAD_mutex_init(&cache->mutex);
+
+	if (global_flag == MEF_TRUE)
+		MEF_globals->block_cache = cache;
+
+
+	return(cache);
+}
+
+
+si8	BLOCK_CACHE_insert(BLOCK_CACHE *cache, ui1 *segment_UUID, si8 block_number, si8 number_of_samples, si1 encryption_level, si4 **samples)
+{
+	si8			i;
+	ui4			bucket;
+	BLOCK_CACHE_ENTRY	*entry;
+
+
+	// claims a pinned entry for a block about to be decoded, with room for its samples (returned in samples); returns
+	// BLOCK_CACHE_NO_ENTRY (& samples NULL) if the block cannot be cached; release the entry with BLOCK_CACHE_release()
+	*samples = NULL;
+	if (all_zeros(segment_UUID, UUID_BYTES) == MEF_TRUE)
+		return(BLOCK_CACHE_NO_ENTRY);
+
+	THREAD_mutex_lock(&cache->mutex);
+	bucket = BLOCK_CACHE_hash(segment_UUID, block_number);
+	for (i = cache->buckets[bucket]; i != BLOCK_CACHE_NO_ENTRY; i = cache->entries[i].next)  // stale (e.g. access) entry
+		if (cache->entries[i].block_number == block_number && memcmp(cache->entries[i].segment_UUID, segment_UUID, UUID_BYTES) == 0)
+			break;
+	if (i != BLOCK_CACHE_NO_ENTRY) {
+		if (cache->entries[i].pinned == MEF_TRUE) {
+			THREAD_mutex_unlock(&cache->mutex);
+			return(BLOCK_CACHE_NO_ENTRY);
+		}
+		BLOCK_CACHE_remove(cache, i);
+	}
+	if (BLOCK_CACHE_evict(cache, BLOCK_CACHE_ENTRY_BYTES(number_of_samples)) == MEF_FALSE) {
+		THREAD_mutex_unlock(&cache->mutex);
+		return(BLOCK_CACHE_NO_ENTRY);
+	}
+
+	// take a free entry, or grow the table
+	if (cache->free_entries != BLOCK_CACHE_NO_ENTRY) {
+		i = cache->free_entries;
+		cache->free_entries = cache->entries[i].next;
+	} else {
+		if (cache->used_entries == cache->allocated_entries) {
+			cache->allocated_entries = (cache->allocated_entries) ? cache->allocated_entries << 1 : 256;
+			cache->entries = (BLOCK_CACHE_ENTRY *) e_realloc((void *) cache->entries, (size_t) cache->allocated_entries * sizeof(BLOCK_CACHE_ENTRY), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+		}
+		i = cache->used_entries++;
+	}
+	entry = cache->entries + i;
+	memcpy(entry->segment_UUID, segment_UUID, UUID_BYTES);
+	entry->block_number = block_number;
+	entry->number_of_samples = number_of_samples;
+	entry->samples = (si4 *) e_malloc((size_t) number_of_samples * sizeof(si4), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	entry->encryption_level = encryption_level;
+	entry->referenced = MEF_FALSE;
+	entry->pinned = MEF_TRUE;
+	entry->in_use = MEF_TRUE;
+	entry->next = cache->buckets[bucket];
+	cache->buckets[bucket] = i;
+	cache->bytes += BLOCK_CACHE_ENTRY_BYTES(number_of_samples);
+	++cache->number_of_entries;
+	*samples = entry->samples;
+	THREAD_mutex_unlock(&cache->mutex);
+
+
+	return(i);
+}
+
+
+void	BLOCK_CACHE_release(BLOCK_CACHE *cache, si8 entry_number, si4 keep_entry)
+{
+	// unpins an entry claimed with BLOCK_CACHE_insert(); entries of blocks that were not decoded are dropped
+	THREAD_mutex_lock(&cache->mutex);
+	cache->entries[entry_number].pinned = MEF_FALSE;
+	if (keep_entry != MEF_TRUE)
+		BLOCK_CACHE_remove(cache, entry_number);
+	THREAD_mutex_unlock(&cache->mutex);
+
+
+	return;
+}
+
+
+void	BLOCK_CACHE_remove(BLOCK_CACHE *cache, si8 entry_number)
+{
+	si8			*link;
+	BLOCK_CACHE_ENTRY	*entry;
+
+
+	// unlinks an entry from its hash chain & puts it on the free list (called with the mutex locked)
+	entry = cache->entries + entry_number;
+	for (link = cache->buckets + BLOCK_CACHE_hash(entry->segment_UUID, entry->block_number); *link != entry_number; link = &cache->entries[*link].next);
+	*link = entry->next;
+
+	free((void *) entry->samples);
+	entry->samples = NULL;
+	cache->bytes -= BLOCK_CACHE_ENTRY_BYTES(entry->number_of_samples);
+	--cache->number_of_entries;
+	entry->in_use = MEF_FALSE;
+	entry->pinned = MEF_FALSE;
+	entry->next = cache->free_entries;
+	cache->free_entries = entry_number;
+
+
+	return;
+}
+
+
+void	BLOCK_CACHE_set_maximum_bytes(BLOCK_CACHE *cache, si8 maximum_bytes)
+{
+	// a smaller budget evicts entries (not in use) down to it; 0 disables caching
+	THREAD_mutex_lock(&cache->mutex);
+	cache->maximum_bytes = (maximum_bytes > 0) ? maximum_bytes : 0;
+	(void) BLOCK_CACHE_evict(cache, 0);
+	THREAD_mutex_unlock(&cache->mutex);
+
+
+	return;
+}
+
+
+/*************************************************************************/
+/***********************  END BLOCK CACHE FUNCTIONS  *********************/
+/*************************************************************************/
+
+
 si4	channel_type_from_path(si1 *path)
 {
 	si1	*c, temp_path[MEF_FULL_FILE_NAME_BYTES], name[MEF_SEGMENT_BASE_FILE_NAME_BYTES], extension[TYPE_BYTES];
@@ -858,20 +1305,20 @@ si4	check_all_alignments(const si1 *function, si4 line)
 	
 	if (return_value == MEF_TRUE) {
 		MEF_globals->all_structures_aligned = MEF_TRUE;
-		if (MEF_globals->verbose == MEF_TRUE)
+		if (MEF_context->verbose == MEF_TRUE)
 			(void) printf("%s(): All MEF Library structures are aligned\n", __FUNCTION__);
 	} else {
-		if (!(MEF_globals->behavior_on_fail & SUPPRESS_ERROR_OUTPUT)) {
+		if (!(MEF_context->behavior_on_fail & SUPPRESS_ERROR_OUTPUT)) {
 			(void) fprintf(stderr, "%c\n%s(): unaligned MEF structures (code update required)\n", 7, __FUNCTION__);
 			(void) fprintf(stderr, "\tcalled from function \"%s\", line %d\n", function, line);
-			if (MEF_globals->behavior_on_fail & RETURN_ON_FAIL)
+			if (MEF_context->behavior_on_fail & RETURN_ON_FAIL)
 				(void) fprintf(stderr, "\t=> returning MEF_FALSE\n\n");
-			else if (MEF_globals->behavior_on_fail & EXIT_ON_FAIL)
+			else if (MEF_context->behavior_on_fail & EXIT_ON_FAIL)
 				(void) fprintf(stderr, "\t=> exiting program\n\n");
 		}
-		if (MEF_globals->behavior_on_fail & RETURN_ON_FAIL)
+		if (MEF_context->behavior_on_fail & RETURN_ON_FAIL)
 			return(MEF_FALSE);
-		else if (MEF_globals->behavior_on_fail & EXIT_ON_FAIL)
+		else if (MEF_context->behavior_on_fail & EXIT_ON_FAIL)
 			exit(1);
 	}
 	
@@ -954,7 +1401,7 @@ si4	check_metadata_section_1_alignment(ui1 *bytes)
 	if (free_flag == MEF_TRUE)
 		free(bytes);
 	
-	if (MEF_globals->verbose == MEF_TRUE)
+	if (MEF_context->verbose == MEF_TRUE)
 		(void) printf("%s(): METADATA_SECTION_1 structure is aligned\n", __FUNCTION__);
 	
         return(MEF_TRUE);
@@ -965,7 +1412,7 @@ METADATA_SECTION_1_NOT_ALIGNED:
 	if (free_flag == MEF_TRUE)
 		free(bytes);
 	
-	if (MEF_globals->verbose == MEF_TRUE)
+	if (MEF_context->verbose == MEF_TRUE)
 		(void) fprintf(stderr, "%c%s(): METADATA_SECTION_1 structure is not aligned\n", 7, __FUNCTION__);
 	
         
@@ -1022,7 +1469,7 @@ si4	check_metadata_section_3_alignment(ui1 *bytes)
 	if (free_flag == MEF_TRUE)
 		free(bytes);
 	
-	if (MEF_globals->verbose == MEF_TRUE)
+	if (MEF_context->verbose == MEF_TRUE)
 		(void) printf("%s(): METADATA_SECTION_3 structure is aligned\n", __FUNCTION__);
 	
         return(MEF_TRUE);
@@ -1047,7 +1494,7 @@ si4	check_password(si1 *password, const si1 *function, si4 line)
         
         // check pointer
         if (password == NULL) {
-		if (MEF_globals->verbose == MEF_TRUE)
+		if (MEF_context->verbose == MEF_TRUE)
 			printf("%s(): password field points to NULL [called from function \"%s\", line %d]\n", __FUNCTION__, function, line);
                 return(1);
         }
@@ -1055,17 +1502,17 @@ si4	check_password(si1 *password, const si1 *function, si4 line)
         // check password length
         pw_len = UTF8_strlen(password);
         if (pw_len == 0) {
-		if (MEF_globals->verbose == MEF_TRUE)
+		if (MEF_context->verbose == MEF_TRUE)
 			fprintf(stderr, "%s(): password has no characters [called from function \"%s\", line %d]\n", __FUNCTION__, function, line);
                 return(1);
         }
         if (pw_len > MAX_PASSWORD_CHARACTERS) {
-		if (MEF_globals->verbose == MEF_TRUE)
+		if (MEF_context->verbose == MEF_TRUE)
 			fprintf(stderr, "%s() Error: password too long [called from function \"%s\", line %d]\n", __FUNCTION__, function, line);
                 return(1);
         }
         
-	if (MEF_globals->verbose == MEF_TRUE)
+	if (MEF_context->verbose == MEF_TRUE)
 		fprintf(stderr, "%s(): password is of valid length [called from function \"%s\", line %d]\n", __FUNCTION__, function, line);
 	
         
@@ -1116,7 +1563,7 @@ si4	check_record_header_alignment(ui1 *bytes)
 	if (free_flag == MEF_TRUE)
 		free(bytes);
 	
-	if (MEF_globals->verbose == MEF_TRUE)
+	if (MEF_context->verbose == MEF_TRUE)
 		(void) printf("%s(): RECORD_HEADER structure is aligned\n", __FUNCTION__);
 	
         return(MEF_TRUE);
@@ -1175,7 +1622,7 @@ si4	check_record_indices_alignment(ui1 *bytes)
 	if (free_flag == MEF_TRUE)
 		free(bytes);
 	
-	if (MEF_globals->verbose == MEF_TRUE)
+	if (MEF_context->verbose == MEF_TRUE)
 		(void) printf("%s(): RECORD_INDEX structure is aligned\n", __FUNCTION__);
         
         return(MEF_TRUE);
@@ -1246,7 +1693,7 @@ si4	check_RED_block_header_alignment(ui1 *bytes)
 	if (free_flag == MEF_TRUE)
 		free(bytes);
 	
-	if (MEF_globals->verbose == MEF_TRUE)
+	if (MEF_context->verbose == MEF_TRUE)
 		(void) printf("%s(): RED_BLOCK_HEADER structure is aligned\n", __FUNCTION__);
 	
         return(MEF_TRUE);
@@ -1315,7 +1762,7 @@ si4	check_time_series_indices_alignment(ui1 *bytes)
 	if (free_flag == MEF_TRUE)
 		free(bytes);
 	
-	if (MEF_globals->verbose == MEF_TRUE)
+	if (MEF_context->verbose == MEF_TRUE)
 		(void) printf("%s(): TIME_SERIES_INDEX structure is aligned\n", __FUNCTION__);
 	
 	return(MEF_TRUE);
@@ -1416,7 +1863,7 @@ si4	check_time_series_metadata_section_2_alignment(ui1 *bytes)
 	if (free_flag == MEF_TRUE)
 		free(bytes);
 	
-	if (MEF_globals->verbose == MEF_TRUE)
+	if (MEF_context->verbose == MEF_TRUE)
 		(void) printf("%s(): TIME_SERIES_METADATA_SECTION_2 structure is aligned\n", __FUNCTION__);
 	
 	return(MEF_TRUE);
@@ -1427,7 +1874,7 @@ TIME_SERIES_METADATA_SECTION_2_NOT_ALIGNED:
 	if (free_flag == MEF_TRUE)
 		free(bytes);
 	
-	if (MEF_globals->verbose == MEF_TRUE)
+	if (MEF_context->verbose == MEF_TRUE)
 		(void) fprintf(stderr, "%c%s(): TIME_SERIES_METADATA_SECTION_2 structure is not aligned\n", 7, __FUNCTION__);
 	
 	
@@ -1506,7 +1953,7 @@ si4	check_universal_header_alignment(ui1 *bytes)
 	if (free_flag == MEF_TRUE)
 		free(bytes);
 	
-	if (MEF_globals->verbose == MEF_TRUE)
+	if (MEF_context->verbose == MEF_TRUE)
 		(void) printf("%s(): UNIVERSAL_HEADER structure is aligned\n", __FUNCTION__);
 	
         return(MEF_TRUE);
@@ -1517,7 +1964,7 @@ UNIVERSAL_HEADER_NOT_ALIGNED:
 	if (free_flag == MEF_TRUE)
 		free(bytes);
 	
-	if (MEF_globals->verbose == MEF_TRUE)
+	if (MEF_context->verbose == MEF_TRUE)
 		(void) fprintf(stderr, "%c%s(): UNIVERSAL_HEADER structure is not aligned\n", 7, __FUNCTION__);
 	
         
@@ -1570,7 +2017,7 @@ si4	check_video_indices_alignment(ui1 *bytes)
 	if (free_flag == MEF_TRUE)
 		free(bytes);
 	
-	if (MEF_globals->verbose == MEF_TRUE)
+	if (MEF_context->verbose == MEF_TRUE)
 		(void) printf("%s(): VIDEO_INDEX structure is aligned\n", __FUNCTION__);
 	
 	return(MEF_TRUE);
@@ -1643,7 +2090,7 @@ si4	check_video_metadata_section_2_alignment(ui1 *bytes)
 	if (free_flag == MEF_TRUE)
 		free(bytes);
 	
-	if (MEF_globals->verbose == MEF_TRUE)
+	if (MEF_context->verbose == MEF_TRUE)
 		(void) printf("%s(): VIDEO_METADATA_SECTION_2 structure is aligned\n", __FUNCTION__);
 	
 	return(MEF_TRUE);
@@ -1654,7 +2101,7 @@ VIDEO_METADATA_SECTION_2_NOT_ALIGNED:
 	if (free_flag == MEF_TRUE)
 		free(bytes);
 	
-	if (MEF_globals->verbose == MEF_TRUE)
+	if (MEF_context->verbose == MEF_TRUE)
 		(void) fprintf(stderr, "%c%s(): VIDEO_METADATA_SECTION_2 structure is not aligned\n", 7, __FUNCTION__);
 	
 	
@@ -1677,61 +2124,441 @@ inline si4     compare_sf8(const void *a, const void * b)
 }
 
 
-ui1	cpu_endianness()
-{
-	ui2	x = 1;
-	
-        
-	return(*((ui1 *) &x));
-}
-
-
 /*************************************************************************/
-/*****************************  CRC FUNCTIONS  ***************************/
+/**************************  CONTINUITY FUNCTIONS  ***********************/
 /*************************************************************************/
 
 
-inline ui4	CRC_calculate(ui1 *block_ptr, si8 block_bytes)
+CONTINUITY_INDEX	*CONTINUITY_build_index(CHANNEL *channel, CONTINUITY_INDEX *continuity_index)
 {
-	ui4	crc;
-	
-	
-	crc = CRC_update(block_ptr, block_bytes, CRC_START_VALUE);
-	
-        
-	return(crc);
-}
+	si1			sorted;
+	si4			i;
+	si8			j, n_blocks, n_indices, segment_start_sample, start_time;
+	sf8			uutc_per_sample, previous_end_time;
+	TIME_SERIES_INDEX	*tsi;
+	CONTINUITY_ENTRY	*entry;
 
 
-ui4	*CRC_initialize_table(si4 global_flag)
-{
-	ui4	*crc_table;
-	
-	
-	crc_table = (ui4 *) e_calloc((size_t) CRC_TABLE_ENTRIES, sizeof(ui4), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
-	
-	{
-		ui4 temp[CRC_TABLE_ENTRIES] = CRC_KOOPMAN32_KEY;
-		memcpy(crc_table, temp, CRC_TABLE_ENTRIES * sizeof(ui4));
+	// times are in uUTC with the recording time offset removed (as used to read data by time)
+	if (continuity_index == NULL)
+		continuity_index = (CONTINUITY_INDEX *) e_calloc((size_t) 1, sizeof(CONTINUITY_INDEX), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	else
+		CONTINUITY_free_index(continuity_index, MEF_FALSE);
+	continuity_index->sampling_frequency = channel->metadata.time_series_section_2->sampling_frequency;
+
+	// each block can start an entry
+	n_blocks = 0;
+	for (i = 0; i < channel->number_of_segments; ++i)
+		if (channel->segments[i].time_series_indices_fps != NULL)
+			n_blocks += channel->segments[i].time_series_indices_fps->universal_header->number_of_entries;
+	if (n_blocks <= 0 || continuity_index->sampling_frequency <= 0.0)
+		return(continuity_index);
+	continuity_index->entries = (CONTINUITY_ENTRY *) e_calloc((size_t) n_blocks, sizeof(CONTINUITY_ENTRY), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+
+	uutc_per_sample = (sf8) 1000000.0 / continuity_index->sampling_frequency;
+	entry = NULL;
+	previous_end_time = 0.0;
+	for (i = 0; i < channel->number_of_segments; ++i) {
+		if (channel->segments[i].time_series_indices_fps == NULL)
+			continue;
+		segment_start_sample = channel->segments[i].metadata_fps->metadata.time_series_section_2->start_sample;
+		tsi = channel->segments[i].time_series_indices_fps->time_series_indices;
+		n_indices = channel->segments[i].time_series_indices_fps->universal_header->number_of_entries;
+		if (fps_read_index_entries(channel->segments[i].time_series_indices_fps, 0, n_indices - 1) < 0)  // on demand indices
+			continue;
+		for (j = 0; j < n_indices; ++j) {
+			start_time = tsi[j].start_time;
+			remove_recording_time_offset(&start_time);
+			if (entry == NULL || ABS((sf8) start_time - previous_end_time) > (sf8) CONTINUITY_MAXIMUM_TIME_GAP) {
+				entry = continuity_index->entries + continuity_index->number_of_entries++;
+				entry->start_segment = i;
+				entry->start_block = j;
+				entry->start_time = start_time;
+				entry->start_sample = segment_start_sample + tsi[j].start_sample;
+				entry->number_of_samples = 0;
+			}
+			entry->end_segment = i;
+			entry->end_block = j;
+			entry->number_of_samples += (si8) tsi[j].number_of_samples;
+			entry->end_sample = entry->start_sample + entry->number_of_samples - 1;
+			entry->end_time = previous_end_time = (sf8) start_time + ((sf8) tsi[j].number_of_samples * uutc_per_sample);
+		}
 	}
-	
-	if (global_flag == MEF_TRUE) {
-		MEF_globals->CRC_table = crc_table;
-		return(NULL);
+
+	// segments are normally in time order, but the conversions rely on it
+	sorted = MEF_TRUE;
+	for (j = 1; j < continuity_index->number_of_entries; ++j) {
+		if (continuity_index->entries[j].start_time < continuity_index->entries[j - 1].start_time) {
+			sorted = MEF_FALSE;
+			break;
+		}
 	}
-	
-        
-	return(crc_table);
+	if (sorted == MEF_FALSE)
+		qsort((void *) continuity_index->entries, (size_t) continuity_index->number_of_entries, sizeof(CONTINUITY_ENTRY), CONTINUITY_compare_entries);
+
+
+	return(continuity_index);
 }
 
 
-inline ui4	CRC_update(ui1 *block_ptr, si8 block_bytes, ui4 current_crc)
+si4	CONTINUITY_compare_entries(const void *a, const void *b)
 {
-	si8	i;
-	ui4	tmp;
-	
-	
-	if (MEF_globals->CRC_table == NULL)
+	if (((CONTINUITY_ENTRY *) a)->start_time > ((CONTINUITY_ENTRY *) b)->start_time)
+		return(1);
+	else if (((CONTINUITY_ENTRY *) a)->start_time < ((CONTINUITY_ENTRY *) b)->start_time)
+		return(-1);
+
+
+	return(0);
+}
+
+
+si8	CONTINUITY_find_entry(CONTINUITY_INDEX *continuity_index, sf8 value, si1 by_sample)
+{
+	si8			low, high, mid;
+	sf8			start;
+	CONTINUITY_ENTRY	*entries;
+
+
+	// returns the last entry starting at or before value (a time, or a sample if by_sample is MEF_TRUE), or -1 if none
+	entries = continuity_index->entries;
+	low = 0;
+	high = continuity_index->number_of_entries;
+	while (low < high) {
+		mid = low + ((high - low) >> 1);
+		start = (by_sample == MEF_TRUE) ? (sf8) entries[mid].start_sample : (sf8) entries[mid].start_time;
+		if (start <= value)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+
+	return(low - 1);
+}
+
+
+void	CONTINUITY_free_index(CONTINUITY_INDEX *continuity_index, si4 free_index_structure)
+{
+	if (continuity_index == NULL)
+		return;
+
+	if (continuity_index->entries != NULL)
+		free((void *) continuity_index->entries);
+
+	if (free_index_structure == MEF_TRUE)
+		free((void *) continuity_index);
+	else
+		bzero((void *) continuity_index, sizeof(CONTINUITY_INDEX));
+
+
+	return;
+}
+
+
+void	CONTINUITY_samples_to_times(CONTINUITY_INDEX *continuity_index, sf8 *samples, si8 number_of_values, sf8 *times, ui1 *sampled)
+{
+	si1			sorted;
+	si8			i, k, n_entries;
+	sf8			sample, slope, uutc_per_sample;
+	CONTINUITY_ENTRY	*entries, *entry;
+
+
+	// samples in a gap (or outside the recording) are extrapolated from the nearest preceding entry at the sampling
+	// frequency, and flagged as not sampled (sampled: 1 or 0, may be NULL); NaN samples give NaN times
+	entries = continuity_index->entries;
+	n_entries = continuity_index->number_of_entries;
+	uutc_per_sample = (sf8) 1000000.0 / continuity_index->sampling_frequency;
+
+	sorted = MEF_TRUE;
+	for (i = 0; i < number_of_values; ++i) {
+		if (isnan(samples[i]) || (i && samples[i] < samples[i - 1])) {
+			sorted = MEF_FALSE;
+			break;
+		}
+	}
+
+	k = -1;
+	for (i = 0; i < number_of_values; ++i) {
+		sample = samples[i];
+		if (sampled != NULL)
+			sampled[i] = 0;
+		if (isnan(sample) || n_entries == 0) {
+			times[i] = NAN;
+			continue;
+		}
+
+		// merge sorted samples with the index, otherwise search it
+		if (sorted == MEF_TRUE) {
+			while (k + 1 < n_entries && (sf8) entries[k + 1].start_sample <= sample)
+				++k;
+		} else {
+			k = CONTINUITY_find_entry(continuity_index, sample, MEF_TRUE);
+		}
+
+		if (k < 0) {  // before the first entry
+			entry = entries;
+			times[i] = round((sf8) entry->start_time + (((sample - (sf8) entry->start_sample) * 1000000.0) / continuity_index->sampling_frequency));
+			continue;
+		}
+		entry = entries + k;
+		if (sample <= (sf8) entry->end_sample) {
+			if (entry->end_sample == entry->start_sample) {
+				times[i] = (sf8) entry->start_time;
+			} else {
+				slope = (entry->end_time - (sf8) entry->start_time) / (sf8) (entry->end_sample - entry->start_sample);
+				times[i] = round((sf8) entry->start_time + (slope * (sample - (sf8) entry->start_sample)));
+			}
+			if (sampled != NULL)
+				sampled[i] = 1;
+		} else {  // after the entry's last sample
+			times[i] = round((entry->end_time + ((sample - (sf8) entry->end_sample - 1.0) * uutc_per_sample)) + 1.0);
+		}
+	}
+
+
+	return;
+}
+
+
+void	CONTINUITY_times_to_samples(CONTINUITY_INDEX *continuity_index, sf8 *times, si8 number_of_values, sf8 *samples, ui1 *sampled)
+{
+	si1			sorted;
+	si8			i, k, n_entries;
+	sf8			time, slope;
+	CONTINUITY_ENTRY	*entries, *entry;
+
+
+	// times in a gap (or outside the recording) give NaN samples, flagged as not sampled (sampled: 1 or 0, may be NULL)
+	entries = continuity_index->entries;
+	n_entries = continuity_index->number_of_entries;
+
+	sorted = MEF_TRUE;
+	for (i = 0; i < number_of_values; ++i) {
+		if (isnan(times[i]) || (i && times[i] < times[i - 1])) {
+			sorted = MEF_FALSE;
+			break;
+		}
+	}
+
+	k = -1;
+	for (i = 0; i < number_of_values; ++i) {
+		time = times[i];
+		samples[i] = NAN;
+		if (sampled != NULL)
+			sampled[i] = 0;
+		if (isnan(time))
+			continue;
+
+		// merge sorted times with the index, otherwise search it
+		if (sorted == MEF_TRUE) {
+			while (k + 1 < n_entries && (sf8) entries[k + 1].start_time <= time)
+				++k;
+		} else {
+			k = CONTINUITY_find_entry(continuity_index, time, MEF_FALSE);
+		}
+		if (k < 0)
+			continue;
+
+		entry = entries + k;
+		if (time <= entry->end_time) {
+			slope = (sf8) (entry->end_sample - entry->start_sample) / (entry->end_time - (sf8) entry->start_time);
+			samples[i] = round((sf8) entry->start_sample + (slope * (time - (sf8) entry->start_time)));
+			if (sampled != NULL)
+				sampled[i] = 1;
+		}
+	}
+
+
+	return;
+}
+
+
+/*************************************************************************/
+/************************  END CONTINUITY FUNCTIONS  *********************/
+/*************************************************************************/
+
+
+ui1	cpu_endianness()
+{
+	ui2	x = 1;
+	
+        
+	return(*((ui1 *) &x));
+}
+
+
+/*************************************************************************/
+/*****************************  CRC FUNCTIONS  ***************************/
+/*************************************************************************/
+
+
+inline ui4	CRC_calculate(ui1 *block_ptr, si8 block_bytes)
+{
+	ui4	crc;
+	
+	
+	crc = CRC_update(block_ptr, block_bytes, CRC_START_VALUE);
+	
+        
+	return(crc);
+}
+
+
+void	CRC_calculate_chunk_task(void *task_args, si8 task_number, si4 thread_number)
+{
+	CRC_CHUNK_TASK_ARGS	*args;
+	si8			offset, bytes;
+	
+	
+	args = (CRC_CHUNK_TASK_ARGS *) task_args;
+	offset = task_number * args->chunk_bytes;
+	bytes = args->block_bytes - offset;
+	if (bytes > args->chunk_bytes)
+		bytes = args->chunk_bytes;
+	
+	args->chunk_CRCs[task_number] = CRC_update(args->block_ptr + offset, bytes, CRC_START_VALUE);
+	
+	
+	return;
+}
+
+
+ui4	CRC_calculate_parallel(ui1 *block_ptr, si8 block_bytes, si4 number_of_threads)
+{
+	CRC_CHUNK_TASK_ARGS	args;
+	si8			i, n_chunks;
+	si4			n_threads;
+	ui4			crc;
+	
+	
+	// same result as CRC_calculate(): chunk CRCs are calculated on worker threads & combined in order
+	n_threads = THREAD_number_of_threads(number_of_threads, block_bytes / CRC_PARALLEL_CHUNK_BYTES);
+	if (block_bytes < CRC_PARALLEL_MINIMUM_BYTES || n_threads < 2)
+		return(CRC_calculate(block_ptr, block_bytes));
+	
+	if (MEF_globals->CRC_table == NULL)  // initialize before the workers use it
+		(void) CRC_initialize_table(MEF_TRUE);
+	
+	n_chunks = (si8) n_threads;
+	args.block_ptr = block_ptr;
+	args.block_bytes = block_bytes;
+	args.chunk_bytes = (block_bytes + n_chunks - 1) / n_chunks;
+	args.chunk_CRCs = (ui4 *) e_calloc((size_t) n_chunks, sizeof(ui4), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	(void) THREAD_run_tasks(CRC_calculate_chunk_task, (void *) &args, n_chunks, n_threads);
+	
+	crc = args.chunk_CRCs[0];
+	for (i = 1; i < n_chunks; ++i)
+		crc = CRC_combine(crc, args.chunk_CRCs[i], (i == n_chunks - 1) ? block_bytes - (i * args.chunk_bytes) : args.chunk_bytes);
+	free(args.chunk_CRCs);
+	
+	
+	return(crc);
+}
+
+
+ui4	CRC_combine(ui4 crc_1, ui4 crc_2, si8 bytes_2)
+{
+	si4	i;
+	ui4	row, odd[CRC_GF2_DIMENSION], even[CRC_GF2_DIMENSION];
+	
+	
+	// returns the CRC of the concatenation of two byte runs, given the CRC of each (both calculated from CRC_START_VALUE) and the length of the second
+	// CRC_update() is linear in the register, so crc_12 = crc_2 ^ (crc_1 ^ CRC_START_VALUE) shifted through bytes_2 zero bytes;
+	// the shift is applied with GF(2) operator matrices squared from one zero bit up to the bits of bytes_2 (as in zlib's crc32_combine())
+	if (bytes_2 <= 0)
+		return(crc_1);
+	
+	// one zero bit operator
+	odd[0] = KOOPMAN32;
+	row = 1;
+	for (i = 1; i < CRC_GF2_DIMENSION; ++i) {
+		odd[i] = row;
+		row <<= 1;
+	}
+	CRC_gf2_matrix_square(even, odd);  // two zero bits
+	CRC_gf2_matrix_square(odd, even);  // four zero bits
+	
+	// apply bytes_2 zero bytes (the first squaring yields the one zero byte operator)
+	crc_1 ^= CRC_START_VALUE;
+	do {
+		CRC_gf2_matrix_square(even, odd);
+		if (bytes_2 & 1)
+			crc_1 = CRC_gf2_matrix_times(even, crc_1);
+		bytes_2 >>= 1;
+		if (bytes_2 == 0)
+			break;
+		CRC_gf2_matrix_square(odd, even);
+		if (bytes_2 & 1)
+			crc_1 = CRC_gf2_matrix_times(odd, crc_1);
+		bytes_2 >>= 1;
+	} while (bytes_2);
+	
+	
+	return(crc_1 ^ crc_2);
+}
+
+
+void	CRC_gf2_matrix_square(ui4 *square, ui4 *matrix)
+{
+	si4	i;
+	
+	
+	for (i = 0; i < CRC_GF2_DIMENSION; ++i)
+		square[i] = CRC_gf2_matrix_times(matrix, matrix[i]);
+	
+	
+	return;
+}
+
+
+ui4	CRC_gf2_matrix_times(ui4 *matrix, ui4 vector)
+{
+	ui4	sum;
+	
+	
+	sum = 0;
+	while (vector) {
+		if (vector & 1)
+			sum ^= *matrix;
+		vector >>= 1;
+		++matrix;
+	}
+	
+	
+	return(sum);
+}
+
+
+ui4	*CRC_initialize_table(si4 global_flag)
+{
+	ui4	*crc_table;
+	
+	
+	crc_table = (ui4 *) e_calloc((size_t) CRC_TABLE_ENTRIES, sizeof(ui4), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	
+	{
+		ui4 temp[CRC_TABLE_ENTRIES] = CRC_KOOPMAN32_KEY;
+		memcpy(crc_table, temp, CRC_TABLE_ENTRIES * sizeof(ui4));
+	}
+	
+	if (global_flag == MEF_TRUE) {
+		MEF_globals->CRC_table = crc_table;
+		return(NULL);
+	}
+	
+        
+	return(crc_table);
+}
+
+
+inline ui4	CRC_update(ui1 *block_ptr, si8 block_bytes, ui4 current_crc)
+{
+	si8	i;
+	ui4	tmp;
+	
+	
+	if (MEF_globals->CRC_table == NULL)
 		(void) CRC_initialize_table(MEF_TRUE);
 	
 	for (i = block_bytes; i--;) {
@@ -1746,10 +2573,17 @@ inline ui4	CRC_update(ui1 *block_ptr, si8 block_bytes, ui4 current_crc)
 
 inline si4	CRC_validate(ui1 *block_ptr, si8 block_bytes, ui4 crc_to_validate)
 {
-	ui4	crc;
+	ui4		crc;
+	PROFILE_TIMER	timer;
 	
 	
+	PROFILE_START(timer);
 	crc = CRC_calculate(block_ptr, block_bytes);
+	if (timer.profile != NULL) {
+		PROFILE_STOP(timer, PROFILE_PHASE_CRC);
+		if (crc != crc_to_validate)
+			PROFILE_COUNT(CRC_failures, 1);
+	}
 	
 	if (crc == crc_to_validate)
 		return(MEF_TRUE);
@@ -1759,6 +2593,28 @@ inline si4	CRC_validate(ui1 *block_ptr, si8 block_bytes, ui4 crc_to_validate)
 }
 
 
+si4	CRC_validate_parallel(ui1 *block_ptr, si8 block_bytes, ui4 crc_to_validate, si4 number_of_threads)
+{
+	ui4		crc;
+	PROFILE_TIMER	timer;
+	
+	
+	PROFILE_START(timer);
+	crc = CRC_calculate_parallel(block_ptr, block_bytes, number_of_threads);
+	if (timer.profile != NULL) {
+		PROFILE_STOP(timer, PROFILE_PHASE_CRC);
+		if (crc != crc_to_validate)
+			PROFILE_COUNT(CRC_failures, 1);
+	}
+	
+	if (crc == crc_to_validate)
+		return(MEF_TRUE);
+	
+	
+	return(MEF_FALSE);
+}
+
+
 /*************************************************************************/
 /***************************  END CRC FUNCTIONS  *************************/
 /*************************************************************************/
@@ -1769,9 +2625,11 @@ si4	decrypt_metadata(FILE_PROCESSING_STRUCT *fps)
 	ui1		*ui1_p, *decryption_key;
 	si4		i, decryption_blocks;
         PASSWORD_DATA	*pwd;
+	PROFILE_TIMER	timer;
 	
 	
         pwd = fps->password_data;
+	PROFILE_START(timer);
         
         // section 2 decryption
         if (fps->metadata.section_1->section_2_encryption > NO_ENCRYPTION) {  // natively encrypted and currently encrypted
@@ -1806,13 +2664,14 @@ si4	decrypt_metadata(FILE_PROCESSING_STRUCT *fps)
                         fps->metadata.section_1->section_3_encryption = -fps->metadata.section_1->section_3_encryption;  // mark as currently decrypted
 		}
         }
+	PROFILE_STOP(timer, PROFILE_PHASE_AES);
 	
 	// set global RTOs
         if (fps->metadata.section_1->section_3_encryption <= NO_ENCRYPTION) {
-		MEF_globals->recording_time_offset = fps->metadata.section_3->recording_time_offset;
-		MEF_globals->DST_start_time = fps->metadata.section_3->DST_start_time;
-		MEF_globals->DST_end_time = fps->metadata.section_3->DST_end_time;
-		MEF_globals->GMT_offset = fps->metadata.section_3->GMT_offset;
+		MEF_context->recording_time_offset = fps->metadata.section_3->recording_time_offset;
+		MEF_context->DST_start_time = fps->metadata.section_3->DST_start_time;
+		MEF_context->DST_end_time = fps->metadata.section_3->DST_end_time;
+		MEF_context->GMT_offset = fps->metadata.section_3->GMT_offset;
 	}
 	
 	
@@ -1820,98 +2679,117 @@ si4	decrypt_metadata(FILE_PROCESSING_STRUCT *fps)
 }
 
 
-si4	decrypt_records(FILE_PROCESSING_STRUCT *fps)
+si4	decrypt_record(RECORD_HEADER *record_header, PASSWORD_DATA *pwd, si8 record_number)
 {
-        si1		CRC_validity;
-        ui4		i, j, decryption_blocks, r_cnt;
-        ui1		*ui1_p, *end_p, *decryption_key;
-	si8		number_of_records;
-        RECORD_HEADER	*record_header;
-        PASSWORD_DATA	*pwd;
-        
-        
-        ui1_p = fps->records;
-        pwd = fps->password_data;
-	number_of_records = fps->universal_header->number_of_entries;
+	si1		CRC_validity;
+	ui4		i, decryption_blocks;
+	ui1		*ui1_p, *decryption_key;
+	PROFILE_TIMER	timer;
 	
-	if (number_of_records == UNKNOWN_NUMBER_OF_ENTRIES) {  // can still process if not passed, but will fail on incomplete final record
-		end_p = fps->raw_data + fps->raw_data_bytes;
-                r_cnt = 0;
-		while (ui1_p < end_p) {
-			record_header = (RECORD_HEADER *) ui1_p;
-			// Validate record CRC
-                        if (MEF_globals->CRC_mode & (CRC_VALIDATE | CRC_VALIDATE_ON_INPUT)) {
-                                if (record_header->encryption >= NO_ENCRYPTION) { // CRCs calculated on encrypted records if encryption is specified
-                                	CRC_validity = CRC_validate(ui1_p + CRC_BYTES, RECORD_HEADER_BYTES + record_header->bytes - CRC_BYTES, record_header->record_CRC);
-                                        if (CRC_validity == MEF_FALSE)
-                                                fprintf(stderr, "Invalid record CRC detected in record %d\n", r_cnt);
-                                } else
-                                        fprintf(stderr, "Can't validate CRC on decrypted record %d\n", r_cnt);
-                        }
-			// apply or remove recording time offset if requested
-                        if (MEF_globals->recording_time_offset_mode & (RTO_APPLY | RTO_APPLY_ON_INPUT))
-                                apply_recording_time_offset(&record_header->time);
-                        else if (MEF_globals->recording_time_offset_mode & (RTO_REMOVE | RTO_REMOVE_ON_INPUT))
-                                remove_recording_time_offset(&record_header->time);
-			// decrypt
-			if ((record_header->encryption > NO_ENCRYPTION) && (pwd->access_level >= record_header->encryption)) {
-				if (record_header->encryption == LEVEL_1_ENCRYPTION)
-					decryption_key = pwd->level_1_encryption_key;
-				else
-					decryption_key = pwd->level_2_encryption_key;
-				decryption_blocks = record_header->bytes / ENCRYPTION_BLOCK_BYTES;
-				ui1_p += RECORD_HEADER_BYTES;
-				for (i = 0; i < decryption_blocks; ++i) {
-					AES_decrypt(ui1_p, ui1_p, NULL, decryption_key);
-					ui1_p += ENCRYPTION_BLOCK_BYTES;
-				}
-				record_header->encryption = -record_header->encryption;  // mark as currently decrypted
-			} else {
-				ui1_p += (RECORD_HEADER_BYTES + record_header->bytes);
-			}
-                        ++r_cnt;
-		}
-	} else {   // use number_of_records if known
-                for (i = 0; i < number_of_records; ++i) {
-			record_header = (RECORD_HEADER *) ui1_p;
-                        if (MEF_globals->CRC_mode & (CRC_VALIDATE | CRC_VALIDATE_ON_INPUT)) {
-                                if (record_header->encryption >= NO_ENCRYPTION) { // CRCs calculated on encrypted records if encryption is specified
-                                	CRC_validity = CRC_validate(ui1_p + CRC_BYTES, RECORD_HEADER_BYTES + record_header->bytes - CRC_BYTES, record_header->record_CRC);
-                                        if (CRC_validity == MEF_FALSE)
-                                                fprintf(stderr, "Invalid record CRC detected in record %d\n", i);
-                                } else
-                                        fprintf(stderr, "Can't validate CRC on decrypted record %d\n", i);
-                        }
-			// apply or remove recording time offset if requested
-                        if (MEF_globals->recording_time_offset_mode & (RTO_APPLY | RTO_APPLY_ON_INPUT))
-                                apply_recording_time_offset(&record_header->time);
-                        else if (MEF_globals->recording_time_offset_mode & (RTO_REMOVE | RTO_REMOVE_ON_INPUT))
-                                remove_recording_time_offset(&record_header->time);
-			// decrypt
-			if ((record_header->encryption > NO_ENCRYPTION) && (pwd->access_level >= record_header->encryption)) {
-				if (record_header->encryption == LEVEL_1_ENCRYPTION)
-					decryption_key = pwd->level_1_encryption_key;
-				else
-					decryption_key = pwd->level_2_encryption_key;
-				decryption_blocks = record_header->bytes / ENCRYPTION_BLOCK_BYTES;
-				ui1_p += RECORD_HEADER_BYTES;
-				for (j = 0; j < decryption_blocks; ++j) {
-					AES_decrypt(ui1_p, ui1_p, NULL, decryption_key);
-					ui1_p += ENCRYPTION_BLOCK_BYTES;
-				}
-				record_header->encryption = -record_header->encryption;  // mark as currently decrypted
-			} else {
-				ui1_p += (RECORD_HEADER_BYTES + record_header->bytes);
-			}
+	
+	// validate record CRC
+	if (MEF_context->CRC_mode & (CRC_VALIDATE | CRC_VALIDATE_ON_INPUT)) {
+		if (record_header->encryption >= NO_ENCRYPTION) { // CRCs calculated on encrypted records if encryption is specified
+			CRC_validity = CRC_validate((ui1 *) record_header + CRC_BYTES, RECORD_HEADER_BYTES + record_header->bytes - CRC_BYTES, record_header->record_CRC);
+			if (CRC_validity == MEF_FALSE)
+				fprintf(stderr, "Invalid record CRC detected in record %ld\n", (long) record_number);
+		} else
+			fprintf(stderr, "Can't validate CRC on decrypted record %ld\n", (long) record_number);
+	}
+	
+	// apply or remove recording time offset if requested
+	if (MEF_context->recording_time_offset_mode & (RTO_APPLY | RTO_APPLY_ON_INPUT))
+		apply_recording_time_offset(&record_header->time);
+	else if (MEF_context->recording_time_offset_mode & (RTO_REMOVE | RTO_REMOVE_ON_INPUT))
+		remove_recording_time_offset(&record_header->time);
+	
+	// decrypt
+	if ((record_header->encryption > NO_ENCRYPTION) && (pwd->access_level >= record_header->encryption)) {
+		if (record_header->encryption == LEVEL_1_ENCRYPTION)
+			decryption_key = pwd->level_1_encryption_key;
+		else
+			decryption_key = pwd->level_2_encryption_key;
+		decryption_blocks = record_header->bytes / ENCRYPTION_BLOCK_BYTES;
+		ui1_p = (ui1 *) record_header + RECORD_HEADER_BYTES;
+		PROFILE_START(timer);
+		for (i = 0; i < decryption_blocks; ++i) {
+			AES_decrypt(ui1_p, ui1_p, NULL, decryption_key);
+			ui1_p += ENCRYPTION_BLOCK_BYTES;
 		}
+		PROFILE_STOP(timer, PROFILE_PHASE_AES);
+		record_header->encryption = -record_header->encryption;  // mark as currently decrypted
 	}
 	
-        
-        return(0);
+	
+	return(0);
 }
 
 
-/*************************************************************************/
+void	decrypt_record_task(void *task_args, si8 task_number, si4 thread_number)
+{
+	RECORD_DECRYPTION_TASK_ARGS	*args;
+	si8				i, first, last;
+	
+	
+	args = (RECORD_DECRYPTION_TASK_ARGS *) task_args;
+	first = task_number * RECORD_DECRYPTION_RECORDS_PER_TASK;
+	last = first + RECORD_DECRYPTION_RECORDS_PER_TASK;
+	if (last > args->number_of_records)
+		last = args->number_of_records;
+	
+	for (i = first; i < last; ++i)
+		decrypt_record((RECORD_HEADER *) (args->records + args->record_offsets[i]), args->password_data, i);
+	
+	
+	return;
+}
+
+
+si4	decrypt_records(FILE_PROCESSING_STRUCT *fps)
+{
+        ui1				*ui1_p, *end_p;
+	si8				i, number_of_records, n_tasks;
+        RECORD_HEADER			*record_header;
+	RECORD_DECRYPTION_TASK_ARGS	args;
+        
+        
+	// phase 1: walk the record headers to find each record (records are variable length)
+        ui1_p = fps->records;
+	end_p = fps->raw_data + fps->raw_data_bytes;
+	number_of_records = fps->universal_header->number_of_entries;
+	if (number_of_records == UNKNOWN_NUMBER_OF_ENTRIES)  // can still process if not passed, but will fail on incomplete final record
+		number_of_records = (fps->raw_data_bytes - UNIVERSAL_HEADER_BYTES) / RECORD_HEADER_BYTES;
+	if (number_of_records <= 0)
+		return(0);
+	args.record_offsets = (si8 *) e_calloc((size_t) number_of_records, sizeof(si8), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	for (i = 0; i < number_of_records && ui1_p + RECORD_HEADER_BYTES <= end_p; ++i) {
+		record_header = (RECORD_HEADER *) ui1_p;
+		if ((si8) record_header->bytes > (si8) (end_p - ui1_p) - RECORD_HEADER_BYTES)  // truncated record => stop
+			break;
+		args.record_offsets[i] = (si8) (ui1_p - fps->records);
+		ui1_p += (RECORD_HEADER_BYTES + record_header->bytes);
+	}
+	args.number_of_records = i;
+	args.records = fps->records;
+	args.password_data = fps->password_data;
+	
+	// phase 2: CRC check, time offset & decrypt the records (independent of each other) on worker threads
+	n_tasks = (args.number_of_records + RECORD_DECRYPTION_RECORDS_PER_TASK - 1) / RECORD_DECRYPTION_RECORDS_PER_TASK;
+	if (n_tasks > 1) {
+		if (MEF_globals->CRC_table == NULL)  // initialize shared tables before the workers use them
+			(void) CRC_initialize_table(MEF_TRUE);
+		if (MEF_globals->AES_rsbox_table == NULL)
+			(void) AES_initialize_rsbox_table(MEF_TRUE);
+	}
+	(void) THREAD_run_tasks(decrypt_record_task, (void *) &args, n_tasks, THREAD_number_of_threads(THREAD_NUMBER_OF_THREADS_DEFAULT, n_tasks));
+	free((void *) args.record_offsets);
+	
+        
+        return(0);
+}
+
+
+/*************************************************************************/
 /******************  ERROR CHECKING STANDARD FUNCTIONS  ******************/
 /*************************************************************************/
 
@@ -1920,7 +2798,7 @@ si4 	e_system(const char *command, const si1 *function, si4 line, ui4 behavior_o
 	si4 sys_res;
 
 	if (behavior_on_fail == USE_GLOBAL_BEHAVIOR)
-		behavior_on_fail = MEF_globals->behavior_on_fail;
+		behavior_on_fail = MEF_context->behavior_on_fail;
 
 	if ((sys_res = system(command)) != 0) {
 		if (!(behavior_on_fail & SUPPRESS_ERROR_OUTPUT)) {
@@ -1947,7 +2825,7 @@ void	*e_calloc(size_t n_members, size_t size, const si1 *function, si4 line, ui4
 	
 	
 	if (behavior_on_fail == USE_GLOBAL_BEHAVIOR)
-		behavior_on_fail = MEF_globals->behavior_on_fail;
+		behavior_on_fail = MEF_context->behavior_on_fail;
 	
 	if ((ptr = calloc(n_members, size)) == NULL) {
 		if (!(behavior_on_fail & SUPPRESS_ERROR_OUTPUT)) {
@@ -1970,6 +2848,12 @@ void	*e_calloc(size_t n_members, size_t size, const si1 *function, si4 line, ui4
 			exit(1);
 	}
 	
+	// profiled allocations
+	if (MEF_globals != NULL && MEF_context->profile != NULL) {
+		PROFILE_add(&MEF_context->profile->allocations, 1);
+		PROFILE_add(&MEF_context->profile->allocated_bytes, (si8) (n_members * size));
+	}
+	
         
 	return(ptr);
 }
@@ -1981,7 +2865,7 @@ FILE	*e_fopen(si1 *path, si1 *mode, const si1 *function, si4 line, ui4 behavior_
 	
 	
 	if (behavior_on_fail == USE_GLOBAL_BEHAVIOR)
-		behavior_on_fail = MEF_globals->behavior_on_fail;
+		behavior_on_fail = MEF_context->behavior_on_fail;
 	
 	if ((fp = fopen(path, mode)) == NULL) {
 		if (!(behavior_on_fail & SUPPRESS_ERROR_OUTPUT)) {
@@ -2007,13 +2891,20 @@ FILE	*e_fopen(si1 *path, si1 *mode, const si1 *function, si4 line, ui4 behavior_
 
 size_t	e_fread(void *ptr, size_t size, size_t n_members, FILE *stream, si1 *path, const si1 *function, si4 line, ui4 behavior_on_fail)
 {
-	size_t	nr;
+	size_t		nr;
+	PROFILE_TIMER	timer;
 	
 	
 	if (behavior_on_fail == USE_GLOBAL_BEHAVIOR)
-		behavior_on_fail = MEF_globals->behavior_on_fail;
+		behavior_on_fail = MEF_context->behavior_on_fail;
 	
-	if ((nr = fread(ptr, size, n_members, stream)) != n_members) {
+	PROFILE_START(timer);
+	nr = fread(ptr, size, n_members, stream);
+	if (timer.profile != NULL) {
+		PROFILE_STOP(timer, PROFILE_PHASE_READ);
+		PROFILE_COUNT(bytes_read, nr * size);
+	}
+	if (nr != n_members) {
 		if (!(behavior_on_fail & SUPPRESS_ERROR_OUTPUT)) {
 			(void) UTF8_fprintf(stderr, "%c\n\t%s() failed to read file \"%s\"\n", 7, __FUNCTION__, path);
 			(void) fprintf(stderr, "\tsystem error number %d (%s)\n", errno, strerror(errno));
@@ -2035,10 +2926,86 @@ size_t	e_fread(void *ptr, size_t size, size_t n_members, FILE *stream, si1 *path
 }
 
 
+#ifndef _WIN32
+	si8	e_pread(si4 fd, void *ptr, si8 n_bytes, si8 offset, si1 *path, const si1 *function, si4 line, ui4 behavior_on_fail)
+	{
+		struct iovec	iov;
+		
+		
+		iov.iov_base = ptr;
+		iov.iov_len = (size_t) n_bytes;
+		
+		
+		return(e_preadv(fd, &iov, 1, offset, path, function, line, behavior_on_fail));
+	}
+	
+	
+	si8	e_preadv(si4 fd, struct iovec *iov, si4 n_iov, si8 offset, si1 *path, const si1 *function, si4 line, ui4 behavior_on_fail)
+	{
+		si8		n_bytes, nr, total;
+		ssize_t		r;
+		PROFILE_TIMER	timer;
+		
+		
+		// reads at offset into the vectors (the file position is not used or moved); short reads are continued
+		// (iov is advanced); returns the bytes read
+		if (behavior_on_fail == USE_GLOBAL_BEHAVIOR)
+			behavior_on_fail = MEF_context->behavior_on_fail;
+		
+		for (n_bytes = 0, r = 0; r < n_iov; ++r)
+			n_bytes += (si8) iov[r].iov_len;
+		
+		PROFILE_START(timer);
+		for (total = 0; total < n_bytes && n_iov > 0; total += nr) {
+			r = (n_iov == 1) ? pread(fd, iov->iov_base, iov->iov_len, (off_t) (offset + total)) : preadv(fd, iov, n_iov, (off_t) (offset + total));
+			if (r == -1 && errno == EINTR) {
+				nr = 0;
+				continue;
+			}
+			if (r <= 0)
+				break;
+			nr = (si8) r;
+			while (n_iov > 0 && (size_t) r >= iov->iov_len) {
+				r -= (ssize_t) iov->iov_len;
+				++iov;
+				--n_iov;
+			}
+			if (n_iov > 0) {
+				iov->iov_base = (void *) ((ui1 *) iov->iov_base + r);
+				iov->iov_len -= (size_t) r;
+			}
+		}
+		if (timer.profile != NULL) {
+			PROFILE_STOP(timer, PROFILE_PHASE_READ);
+			PROFILE_COUNT(bytes_read, total);
+		}
+		if (total != n_bytes) {
+			if (!(behavior_on_fail & SUPPRESS_ERROR_OUTPUT)) {
+				(void) UTF8_fprintf(stderr, "%c\n\t%s() failed to read file \"%s\"\n", 7, __FUNCTION__, path);
+				(void) fprintf(stderr, "\tsystem error number %d (%s)\n", errno, strerror(errno));
+				if (function != NULL)
+					(void) fprintf(stderr, "\tcalled from function \"%s\", line %d\n", function, line);
+				if (behavior_on_fail & RETURN_ON_FAIL)
+					(void) fprintf(stderr, "\t=> returning number of bytes read\n\n");
+				else if (behavior_on_fail & EXIT_ON_FAIL)
+					(void) fprintf(stderr, "\t=> exiting program\n\n");
+			}
+			if (behavior_on_fail & RETURN_ON_FAIL)
+				return(total);
+			else if (behavior_on_fail & EXIT_ON_FAIL)
+				exit(1);
+		}
+		
+		
+		return(total);
+	}
+#endif
+
+
 si4	e_fseek(FILE *stream, size_t offset, si4 whence, si1 *path, const si1 *function, si4 line, ui4 behavior_on_fail)
 {
 	if (behavior_on_fail == USE_GLOBAL_BEHAVIOR)
-		behavior_on_fail = MEF_globals->behavior_on_fail;
+		behavior_on_fail = MEF_context->behavior_on_fail;
 	
 	if ((fseek(stream, offset, whence)) == -1) {
 		if (!(behavior_on_fail & SUPPRESS_ERROR_OUTPUT)) {
@@ -2073,7 +3040,7 @@ long	e_ftell(FILE *stream, const si1 *function, si4 line, ui4 behavior_on_fail)
 	
 	
 	if (behavior_on_fail == USE_GLOBAL_BEHAVIOR)
-		behavior_on_fail = MEF_globals->behavior_on_fail;
+		behavior_on_fail = MEF_context->behavior_on_fail;
 	
 	if ((pos = ftell(stream)) == -1) {
 		if (!(behavior_on_fail & SUPPRESS_ERROR_OUTPUT)) {
@@ -2103,7 +3070,7 @@ size_t	e_fwrite(void *ptr, size_t size, size_t n_members, FILE *stream, si1 *pat
 	
 	
 	if (behavior_on_fail == USE_GLOBAL_BEHAVIOR)
-		behavior_on_fail = MEF_globals->behavior_on_fail;
+		behavior_on_fail = MEF_context->behavior_on_fail;
 	
 	if ((nw = fwrite(ptr, size, n_members, stream)) != n_members) {
 		if (!(behavior_on_fail & SUPPRESS_ERROR_OUTPUT)) {
@@ -2133,7 +3100,7 @@ void	*e_malloc(size_t n_bytes, const si1 *function, si4 line, ui4 behavior_on_fa
 	
 	
 	if (behavior_on_fail == USE_GLOBAL_BEHAVIOR)
-		behavior_on_fail = MEF_globals->behavior_on_fail;
+		behavior_on_fail = MEF_context->behavior_on_fail;
 	
 	if ((ptr = malloc(n_bytes)) == NULL) {
 		if (!(behavior_on_fail & SUPPRESS_ERROR_OUTPUT)) {
@@ -2156,6 +3123,12 @@ void	*e_malloc(size_t n_bytes, const si1 *function, si4 line, ui4 behavior_on_fa
 			exit(1);
 	}
 	
+	// profiled allocations
+	if (MEF_globals != NULL && MEF_context->profile != NULL) {
+		PROFILE_add(&MEF_context->profile->allocations, 1);
+		PROFILE_add(&MEF_context->profile->allocated_bytes, (si8) (n_bytes));
+	}
+	
 	
 	return(ptr);
 }
@@ -2164,7 +3137,7 @@ void	*e_malloc(size_t n_bytes, const si1 *function, si4 line, ui4 behavior_on_fa
 void	*e_realloc(void *ptr, size_t n_bytes, const si1 *function, si4 line, ui4 behavior_on_fail)
 {
 	if (behavior_on_fail == USE_GLOBAL_BEHAVIOR)
-		behavior_on_fail = MEF_globals->behavior_on_fail;
+		behavior_on_fail = MEF_context->behavior_on_fail;
 	
 	if ((ptr = realloc(ptr, n_bytes)) == NULL) {
 		if (!(behavior_on_fail & SUPPRESS_ERROR_OUTPUT)) {
@@ -2187,6 +3160,12 @@ void	*e_realloc(void *ptr, size_t n_bytes, const si1 *function, si4 line, ui4 be
 			exit(1);
 	}
 	
+	// profiled allocations
+	if (MEF_globals != NULL && MEF_context->profile != NULL) {
+		PROFILE_add(&MEF_context->profile->allocations, 1);
+		PROFILE_add(&MEF_context->profile->allocated_bytes, (si8) (n_bytes));
+	}
+	
 	
 	return(ptr);
 }
@@ -2279,13 +3258,13 @@ si4	encrypt_records(FILE_PROCESSING_STRUCT *fps)
 			}
 			// apply or remove recording time offset if requested
                         if (record_header->time != UUTC_NO_ENTRY) {
-                        	if (MEF_globals->recording_time_offset_mode & (RTO_APPLY | RTO_APPLY_ON_OUTPUT))
+                        	if (MEF_context->recording_time_offset_mode & (RTO_APPLY | RTO_APPLY_ON_OUTPUT))
 					apply_recording_time_offset(&record_header->time);
-				else if (MEF_globals->recording_time_offset_mode & (RTO_REMOVE | RTO_REMOVE_ON_OUTPUT))
+				else if (MEF_context->recording_time_offset_mode & (RTO_REMOVE | RTO_REMOVE_ON_OUTPUT))
 					remove_recording_time_offset(&record_header->time);
                         }
 			// Calculate record CRC
-                        if (MEF_globals->CRC_mode & (CRC_CALCULATE | CRC_CALCULATE_ON_OUTPUT))
+                        if (MEF_context->CRC_mode & (CRC_CALCULATE | CRC_CALCULATE_ON_OUTPUT))
                         	record_header->record_CRC = CRC_calculate((ui1 *) record_header + CRC_BYTES, RECORD_HEADER_BYTES + record_header->bytes - CRC_BYTES);
 		}
 	} else {   // use number_of_records if known
@@ -2308,13 +3287,13 @@ si4	encrypt_records(FILE_PROCESSING_STRUCT *fps)
 			}
 			// apply or remove recording time offset if requested
                         if (record_header->time != UUTC_NO_ENTRY) {
-                        	if (MEF_globals->recording_time_offset_mode & (RTO_APPLY | RTO_APPLY_ON_OUTPUT))
+                        	if (MEF_context->recording_time_offset_mode & (RTO_APPLY | RTO_APPLY_ON_OUTPUT))
 					apply_recording_time_offset(&record_header->time);
-				else if (MEF_globals->recording_time_offset_mode & (RTO_REMOVE | RTO_REMOVE_ON_OUTPUT))
+				else if (MEF_context->recording_time_offset_mode & (RTO_REMOVE | RTO_REMOVE_ON_OUTPUT))
 					remove_recording_time_offset(&record_header->time);
                         }
 			// Calculate record CRC
-                        if (MEF_globals->CRC_mode & (CRC_CALCULATE | CRC_CALCULATE_ON_OUTPUT))
+                        if (MEF_context->CRC_mode & (CRC_CALCULATE | CRC_CALCULATE_ON_OUTPUT))
                         	record_header->record_CRC = CRC_calculate((ui1 *) record_header + CRC_BYTES, RECORD_HEADER_BYTES + record_header->bytes - CRC_BYTES);
 		}
         }
@@ -2323,6 +3302,501 @@ si4	encrypt_records(FILE_PROCESSING_STRUCT *fps)
         return(0);
 }
 
+/*************************************************************************/
+/***************************  ENVELOPE FUNCTIONS  ************************/
+/*************************************************************************/
+
+
+void	ENVELOPE_add(ENVELOPE *envelope, sf8 start_time, sf8 duration, sf8 minimum, sf8 maximum, sf8 sum_of_squares, si8 rms_samples)
+{
+	si8	i, first_bin, last_bin;
+
+
+	// adds the extrema (& squares) of the samples from start_time for duration (uUTC) to the envelope bins they overlap
+	first_bin = (si8) floor((start_time - (sf8) envelope->start_time) / envelope->bin_duration);
+	last_bin = (si8) ceil((start_time + duration - (sf8) envelope->start_time) / envelope->bin_duration) - 1;
+	if (last_bin < first_bin)
+		last_bin = first_bin;
+	if (first_bin < 0)
+		first_bin = 0;
+	if (last_bin >= envelope->number_of_bins)
+		last_bin = envelope->number_of_bins - 1;
+
+	for (i = first_bin; i <= last_bin; ++i) {
+		if (isnan(envelope->minimum[i]) || minimum < envelope->minimum[i])
+			envelope->minimum[i] = minimum;
+		if (isnan(envelope->maximum[i]) || maximum > envelope->maximum[i])
+			envelope->maximum[i] = maximum;
+		if (rms_samples > 0) {
+			envelope->sum_of_squares[i] += sum_of_squares;
+			envelope->rms_samples[i] += (sf8) rms_samples;
+		}
+	}
+
+
+	return;
+}
+
+
+ENVELOPE_PYRAMID	*ENVELOPE_build_pyramid(CHANNEL *channel, si4 segment_number, si4 number_of_threads, si8 *failed_blocks)
+{
+	SEGMENT			*segment;
+	TIME_SERIES_INDEX	*tsi;
+	ENVELOPE_PYRAMID	*pyramid;
+	ENVELOPE_LEVEL		*level;
+	ENVELOPE_TASK_ARGS	args;
+	READ_PLAN		plan = {0};
+	si4			i, *samples;
+	si8			j, first_block, end_block, first_sample, end_sample, segment_start_sample, max_block_samples, bin_samples, allocated_samples, n_failed;
+
+
+	// decodes the segment's blocks in batches (in parallel) & bins each block at every level of the pyramid
+	// (none for encrypted data: a pyramid would hold it in the clear); failed_blocks (if not NULL) is set to the number
+	// of blocks that could not be decoded (their bins are empty: save the pyramid only if there are none)
+	if (failed_blocks != NULL)
+		*failed_blocks = 0;
+	segment = channel->segments + segment_number;
+	if (segment->time_series_indices_fps == NULL || segment->time_series_data_fps == NULL)
+		return(NULL);
+	if (ENVELOPE_segment_encrypted(segment) != MEF_FALSE)
+		return(NULL);
+	tsi = segment->time_series_indices_fps->time_series_indices;
+
+	pyramid = (ENVELOPE_PYRAMID *) e_calloc((size_t) 1, sizeof(ENVELOPE_PYRAMID), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	memcpy(pyramid->segment_UUID, segment->time_series_data_fps->universal_header->file_UUID, UUID_BYTES);
+	pyramid->number_of_blocks = segment->time_series_indices_fps->universal_header->number_of_entries;
+	max_block_samples = 1;
+	for (j = 0; j < pyramid->number_of_blocks; ++j)
+		if ((si8) tsi[j].number_of_samples > max_block_samples)
+			max_block_samples = (si8) tsi[j].number_of_samples;
+
+	// levels of ENVELOPE_LEVEL_FACTOR times larger bins, then one bin per block
+	bin_samples = ENVELOPE_FINEST_BIN_SAMPLES;
+	while (pyramid->number_of_levels < ENVELOPE_MAXIMUM_LEVELS - 1 && bin_samples < max_block_samples) {
+		pyramid->levels[pyramid->number_of_levels++].bin_samples = bin_samples;
+		bin_samples *= ENVELOPE_LEVEL_FACTOR;
+	}
+	pyramid->levels[pyramid->number_of_levels++].bin_samples = max_block_samples;
+	for (i = 0; i < pyramid->number_of_levels; ++i) {
+		level = pyramid->levels + i;
+		level->block_bins = (si8 *) e_calloc((size_t) (pyramid->number_of_blocks + 1), sizeof(si8), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+		for (j = 0; j < pyramid->number_of_blocks; ++j)
+			level->block_bins[j + 1] = level->block_bins[j] + (((si8) tsi[j].number_of_samples + level->bin_samples - 1) / level->bin_samples);
+		level->number_of_bins = level->block_bins[pyramid->number_of_blocks];
+		level->bins = (ENVELOPE_BIN *) e_calloc((size_t) level->number_of_bins + 1, sizeof(ENVELOPE_BIN), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	}
+
+	segment_start_sample = segment->metadata_fps->metadata.time_series_section_2->start_sample;
+	samples = NULL;
+	allocated_samples = 0;
+	args.pyramid = pyramid;
+	args.tsi = tsi;
+	for (first_block = 0; first_block < pyramid->number_of_blocks; first_block = end_block) {
+		end_block = first_block + ENVELOPE_BUILD_BATCH_BLOCKS;
+		if (end_block > pyramid->number_of_blocks)
+			end_block = pyramid->number_of_blocks;
+		first_sample = tsi[first_block].start_sample;
+		end_sample = tsi[end_block - 1].start_sample + (si8) tsi[end_block - 1].number_of_samples;
+		if (end_sample - first_sample > allocated_samples) {
+			allocated_samples = end_sample - first_sample;
+			samples = (si4 *) e_realloc((void *) samples, (size_t) allocated_samples * sizeof(si4), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+		}
+
+		// blocks that cannot be decoded are left empty
+		(void) READ_PLAN_build_for_samples(channel, segment_start_sample + first_sample, segment_start_sample + end_sample, &plan);
+		n_failed = READ_PLAN_execute(channel, &plan, samples, number_of_threads);
+		if (n_failed < 0) {
+			for (j = 0; j < end_sample - first_sample; ++j)
+				samples[j] = RED_NAN;
+			n_failed = end_block - first_block;
+		}
+		if (failed_blocks != NULL)
+			*failed_blocks += n_failed;
+
+		args.samples = samples;
+		args.first_block = first_block;
+		args.first_sample = first_sample;
+		(void) THREAD_run_tasks(ENVELOPE_build_task, (void *) &args, end_block - first_block, number_of_threads);
+	}
+	READ_PLAN_free(&plan, MEF_FALSE);
+	free((void *) samples);
+
+
+	return(pyramid);
+}
+
+
+void	ENVELOPE_build_task(void *task_args, si8 task_number, si4 thread_number)
+{
+	ENVELOPE_TASK_ARGS	*args;
+	ENVELOPE_LEVEL		*level, *finer_level;
+	ENVELOPE_BIN		*bin, *finer_bin;
+	si4			i, *x, minimum, maximum;
+	si8			j, k, n, block_samples, bin_start, bin_end, finer_bins, rms_samples;
+	sf8			sum_of_squares;
+
+
+	// bins one block: the finest level from its samples, each other level from the level below
+	args = (ENVELOPE_TASK_ARGS *) task_args;
+	j = args->first_block + task_number;
+	block_samples = (si8) args->tsi[j].number_of_samples;
+	x = args->samples + (args->tsi[j].start_sample - args->first_sample);
+
+	level = args->pyramid->levels;
+	for (k = level->block_bins[j]; k < level->block_bins[j + 1]; ++k) {
+		bin_start = (k - level->block_bins[j]) * level->bin_samples;
+		bin_end = bin_start + level->bin_samples;
+		if (bin_end > block_samples)
+			bin_end = block_samples;
+		minimum = maximum = RED_NAN;
+		sum_of_squares = 0.0;
+		rms_samples = 0;
+		for (n = bin_start; n < bin_end; ++n) {
+			if (x[n] == RED_NAN)
+				continue;
+			if (rms_samples++ == 0) {
+				minimum = maximum = x[n];
+			} else if (x[n] < minimum) {
+				minimum = x[n];
+			} else if (x[n] > maximum) {
+				maximum = x[n];
+			}
+			sum_of_squares += (sf8) x[n] * (sf8) x[n];
+		}
+		bin = level->bins + k;
+		bin->minimum = minimum;
+		bin->maximum = maximum;
+		bin->number_of_samples = (ui4) rms_samples;
+		bin->rms = (rms_samples > 0) ? (sf4) sqrt(sum_of_squares / (sf8) rms_samples) : (sf4) 0.0;
+	}
+
+	for (i = 1; i < args->pyramid->number_of_levels; ++i) {
+		finer_level = level;
+		level = args->pyramid->levels + i;
+		finer_bins = (level->bin_samples + finer_level->bin_samples - 1) / finer_level->bin_samples;
+		for (k = level->block_bins[j]; k < level->block_bins[j + 1]; ++k) {
+			bin_start = finer_level->block_bins[j] + (k - level->block_bins[j]) * finer_bins;
+			bin_end = bin_start + finer_bins;
+			if (bin_end > finer_level->block_bins[j + 1])
+				bin_end = finer_level->block_bins[j + 1];
+			minimum = maximum = RED_NAN;
+			sum_of_squares = 0.0;
+			rms_samples = 0;
+			for (n = bin_start; n < bin_end; ++n) {
+				finer_bin = finer_level->bins + n;
+				if (finer_bin->number_of_samples == 0)
+					continue;
+				if (rms_samples == 0 || finer_bin->minimum < minimum)
+					minimum = finer_bin->minimum;
+				if (rms_samples == 0 || finer_bin->maximum > maximum)
+					maximum = finer_bin->maximum;
+				sum_of_squares += (sf8) finer_bin->rms * (sf8) finer_bin->rms * (sf8) finer_bin->number_of_samples;
+				rms_samples += (si8) finer_bin->number_of_samples;
+			}
+			bin = level->bins + k;
+			bin->minimum = minimum;
+			bin->maximum = maximum;
+			bin->number_of_samples = (ui4) rms_samples;
+			bin->rms = (rms_samples > 0) ? (sf4) sqrt(sum_of_squares / (sf8) rms_samples) : (sf4) 0.0;
+		}
+	}
+
+
+	return;
+}
+
+
+void	ENVELOPE_free(ENVELOPE *envelope, si4 free_envelope_structure)
+{
+	if (envelope == NULL)
+		return;
+
+	free((void *) envelope->minimum);
+	free((void *) envelope->maximum);
+	free((void *) envelope->rms);
+	free((void *) envelope->sum_of_squares);
+	free((void *) envelope->rms_samples);
+	if (free_envelope_structure == MEF_TRUE)
+		free((void *) envelope);
+	else
+		memset((void *) envelope, 0, sizeof(ENVELOPE));
+
+
+	return;
+}
+
+
+void	ENVELOPE_free_pyramid(ENVELOPE_PYRAMID *pyramid)
+{
+	si4	i;
+
+
+	if (pyramid == NULL)
+		return;
+
+	for (i = 0; i < pyramid->number_of_levels; ++i) {
+		free((void *) pyramid->levels[i].block_bins);
+		free((void *) pyramid->levels[i].bins);
+	}
+	free((void *) pyramid);
+
+
+	return;
+}
+
+
+void	ENVELOPE_pyramid_file_name(SEGMENT *segment, si1 *file_name)
+{
+	si1	*c;
+
+
+	// the segment's time series data file name, with the envelope extension
+	MEF_strncpy(file_name, segment->time_series_data_fps->full_file_name, MEF_FULL_FILE_NAME_BYTES);
+	c = strrchr(file_name, '.');
+	if (c == NULL || (size_t) (c - file_name) + TYPE_BYTES >= MEF_FULL_FILE_NAME_BYTES)
+		c = file_name + strlen(file_name);
+	sprintf(c, ".%s", ENVELOPE_FILE_TYPE_STRING);
+
+
+	return;
+}
+
+
+ENVELOPE	*ENVELOPE_query(CHANNEL *channel, ENVELOPE_PYRAMID **pyramids, si8 start_time, si8 end_time, si8 number_of_bins, si4 number_of_threads, ENVELOPE *envelope)
+{
+	TIME_SERIES_INDEX	*tsi;
+	ENVELOPE_PYRAMID	*pyramid;
+	ENVELOPE_LEVEL		*level;
+	ENVELOPE_BIN		*bin;
+	READ_PLAN		plan = {0};
+	si1			decode;
+	si4			i, *samples;
+	si8			j, k, n_blocks, block_start_time, bin_offset;
+	sf8			uutc_per_sample, block_duration;
+
+
+	// envelope of [start_time, end_time) (uUTC, recording time offset removed) in number_of_bins; pyramids has one
+	// entry per segment (NULL where there is none), or is NULL
+	if (envelope == NULL)
+		envelope = (ENVELOPE *) e_calloc((size_t) 1, sizeof(ENVELOPE), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	else
+		ENVELOPE_free(envelope, MEF_FALSE);
+	envelope->start_time = start_time;
+	envelope->end_time = end_time;
+	envelope->source = ENVELOPE_SOURCE_NONE;
+	if (number_of_bins <= 0 || end_time <= start_time || channel->metadata.time_series_section_2->sampling_frequency <= 0.0)
+		return(envelope);
+	envelope->number_of_bins = number_of_bins;
+	envelope->bin_duration = (sf8) (end_time - start_time) / (sf8) number_of_bins;
+	envelope->minimum = (sf8 *) e_malloc((size_t) number_of_bins * sizeof(sf8), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	envelope->maximum = (sf8 *) e_malloc((size_t) number_of_bins * sizeof(sf8), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	envelope->rms = (sf8 *) e_malloc((size_t) number_of_bins * sizeof(sf8), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	envelope->sum_of_squares = (sf8 *) e_calloc((size_t) number_of_bins, sizeof(sf8), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	envelope->rms_samples = (sf8 *) e_calloc((size_t) number_of_bins, sizeof(sf8), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	for (j = 0; j < number_of_bins; ++j)
+		envelope->minimum[j] = envelope->maximum[j] = NAN;
+	uutc_per_sample = (sf8) 1000000.0 / channel->metadata.time_series_section_2->sampling_frequency;
+
+	// each block from the coarsest pyramid level with bins no wider than the envelope's, or from its index extrema if
+	// it is no wider; any other block means decoding the range
+	decode = MEF_FALSE;
+	for (i = 0; i < channel->number_of_segments && decode == MEF_FALSE; ++i) {
+		if (channel->segments[i].time_series_indices_fps == NULL)
+			continue;
+		tsi = channel->segments[i].time_series_indices_fps->time_series_indices;
+		n_blocks = channel->segments[i].time_series_indices_fps->universal_header->number_of_entries;
+		if (fps_read_index_entries(channel->segments[i].time_series_indices_fps, 0, n_blocks - 1) < 0)  // on demand indices
+			continue;
+		pyramid = (pyramids == NULL) ? NULL : pyramids[i];
+		level = NULL;
+		if (pyramid != NULL && pyramid->number_of_blocks == n_blocks)
+			for (k = pyramid->number_of_levels - 1; k >= 0 && level == NULL; --k)
+				if ((sf8) pyramid->levels[k].bin_samples * uutc_per_sample <= envelope->bin_duration)
+					level = pyramid->levels + k;
+
+		for (j = 0; j < n_blocks; ++j) {
+			block_start_time = tsi[j].start_time;
+			remove_recording_time_offset(&block_start_time);
+			block_duration = (sf8) tsi[j].number_of_samples * uutc_per_sample;
+			if (block_start_time >= end_time || (sf8) block_start_time + block_duration <= (sf8) start_time)
+				continue;
+			if (level != NULL) {
+				for (k = level->block_bins[j]; k < level->block_bins[j + 1]; ++k) {
+					bin = level->bins + k;
+					if (bin->number_of_samples == 0)
+						continue;
+					bin_offset = (k - level->block_bins[j]) * level->bin_samples;
+					ENVELOPE_add(envelope, (sf8) block_start_time + ((sf8) bin_offset * uutc_per_sample), (sf8) bin->number_of_samples * uutc_per_sample, (sf8) bin->minimum, (sf8) bin->maximum, (sf8) bin->rms * (sf8) bin->rms * (sf8) bin->number_of_samples, (si8) bin->number_of_samples);
+				}
+				if (envelope->source < ENVELOPE_SOURCE_PYRAMID)
+					envelope->source = ENVELOPE_SOURCE_PYRAMID;
+			} else if (block_duration <= envelope->bin_duration && tsi[j].minimum_sample_value != TIME_SERIES_INDEX_MINIMUM_SAMPLE_VALUE_NO_ENTRY && tsi[j].maximum_sample_value != TIME_SERIES_INDEX_MAXIMUM_SAMPLE_VALUE_NO_ENTRY) {
+				ENVELOPE_add(envelope, (sf8) block_start_time, block_duration, (sf8) tsi[j].minimum_sample_value, (sf8) tsi[j].maximum_sample_value, 0.0, 0);
+				if (envelope->source < ENVELOPE_SOURCE_INDICES)
+					envelope->source = ENVELOPE_SOURCE_INDICES;
+			} else {
+				decode = MEF_TRUE;
+				break;
+			}
+		}
+	}
+
+	// decode the range, each sample to the bin of its output slot
+	if (decode == MEF_TRUE) {
+		for (j = 0; j < number_of_bins; ++j) {
+			envelope->minimum[j] = envelope->maximum[j] = NAN;
+			envelope->sum_of_squares[j] = envelope->rms_samples[j] = 0.0;
+		}
+		(void) READ_PLAN_build(channel, NULL, start_time, end_time, &plan);
+		samples = (si4 *) e_malloc((size_t) (plan.number_of_samples + 1) * sizeof(si4), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+		if (READ_PLAN_execute(channel, &plan, samples, number_of_threads) >= 0) {
+			for (j = 0; j < plan.number_of_samples; ++j) {
+				if (samples[j] == RED_NAN)
+					continue;
+				k = (j * number_of_bins) / plan.number_of_samples;
+				if (isnan(envelope->minimum[k]) || (sf8) samples[j] < envelope->minimum[k])
+					envelope->minimum[k] = (sf8) samples[j];
+				if (isnan(envelope->maximum[k]) || (sf8) samples[j] > envelope->maximum[k])
+					envelope->maximum[k] = (sf8) samples[j];
+				envelope->sum_of_squares[k] += (sf8) samples[j] * (sf8) samples[j];
+				envelope->rms_samples[k] += 1.0;
+			}
+		}
+		free((void *) samples);
+		READ_PLAN_free(&plan, MEF_FALSE);
+		envelope->source = ENVELOPE_SOURCE_SAMPLES;
+	}
+
+	for (j = 0; j < number_of_bins; ++j)
+		envelope->rms[j] = (envelope->rms_samples[j] > 0.0) ? sqrt(envelope->sum_of_squares[j] / envelope->rms_samples[j]) : NAN;
+
+
+	return(envelope);
+}
+
+
+ENVELOPE_PYRAMID	*ENVELOPE_read_pyramid(SEGMENT *segment)
+{
+	FILE			*fp;
+	ENVELOPE_PYRAMID	*pyramid;
+	ENVELOPE_LEVEL		*level;
+	si1			file_name[MEF_FULL_FILE_NAME_BYTES], magic[ENVELOPE_FILE_MAGIC_BYTES];
+	si4			i, reserved, valid;
+	si8			n_blocks;
+
+
+	// returns NULL if the segment has no envelope pyramid file, or if it does not match the segment's data (a file
+	// next to encrypted data is never used: it would bypass the access check)
+	if (segment->time_series_data_fps == NULL || segment->time_series_indices_fps == NULL)
+		return(NULL);
+	if (ENVELOPE_segment_encrypted(segment) != MEF_FALSE)
+		return(NULL);
+	ENVELOPE_pyramid_file_name(segment, file_name);
+	fp = e_fopen(file_name, "rb", __FUNCTION__, __LINE__, RETURN_ON_FAIL | SUPPRESS_ERROR_OUTPUT);
+	if (fp == NULL)
+		return(NULL);
+
+	pyramid = (ENVELOPE_PYRAMID *) e_calloc((size_t) 1, sizeof(ENVELOPE_PYRAMID), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	n_blocks = segment->time_series_indices_fps->universal_header->number_of_entries;
+	valid = fread((void *) magic, sizeof(si1), ENVELOPE_FILE_MAGIC_BYTES, fp) == ENVELOPE_FILE_MAGIC_BYTES &&
+		memcmp(magic, ENVELOPE_FILE_MAGIC, ENVELOPE_FILE_MAGIC_BYTES) == 0 &&
+		fread((void *) pyramid->segment_UUID, sizeof(ui1), UUID_BYTES, fp) == UUID_BYTES &&
+		memcmp(pyramid->segment_UUID, segment->time_series_data_fps->universal_header->file_UUID, UUID_BYTES) == 0 &&
+		fread((void *) &pyramid->number_of_blocks, sizeof(si8), 1, fp) == 1 && pyramid->number_of_blocks == n_blocks &&
+		fread((void *) &pyramid->number_of_levels, sizeof(si4), 1, fp) == 1 && fread((void *) &reserved, sizeof(si4), 1, fp) == 1 &&
+		pyramid->number_of_levels > 0 && pyramid->number_of_levels <= ENVELOPE_MAXIMUM_LEVELS;
+	for (i = 0; i < pyramid->number_of_levels && valid; ++i) {
+		level = pyramid->levels + i;
+		valid = fread((void *) &level->bin_samples, sizeof(si8), 1, fp) == 1 && fread((void *) &level->number_of_bins, sizeof(si8), 1, fp) == 1 &&
+			level->bin_samples > 0 && level->number_of_bins >= 0;
+	}
+	for (i = 0; i < pyramid->number_of_levels && valid; ++i) {
+		level = pyramid->levels + i;
+		level->block_bins = (si8 *) e_calloc((size_t) (n_blocks + 1), sizeof(si8), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+		level->bins = (ENVELOPE_BIN *) e_calloc((size_t) level->number_of_bins + 1, sizeof(ENVELOPE_BIN), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+		valid = fread((void *) level->block_bins, sizeof(si8), (size_t) (n_blocks + 1), fp) == (size_t) (n_blocks + 1) &&
+			fread((void *) level->bins, sizeof(ENVELOPE_BIN), (size_t) level->number_of_bins, fp) == (size_t) level->number_of_bins &&
+			level->block_bins[0] == 0 && level->block_bins[n_blocks] == level->number_of_bins;
+	}
+	fclose(fp);
+	if (!valid) {
+		ENVELOPE_free_pyramid(pyramid);
+		return(NULL);
+	}
+
+
+	return(pyramid);
+}
+
+
+si4	ENVELOPE_segment_encrypted(SEGMENT *segment)
+{
+	TIME_SERIES_INDEX	*tsi;
+	si8			i, n_blocks;
+
+
+	// returns MEF_TRUE if any block of the segment is encrypted (level 1 or 2), MEF_UNKNOWN if its indices cannot be read
+	n_blocks = segment->time_series_indices_fps->universal_header->number_of_entries;
+	if (fps_read_index_entries(segment->time_series_indices_fps, 0, n_blocks - 1) < 0)  // on demand indices
+		return(MEF_UNKNOWN);
+	tsi = segment->time_series_indices_fps->time_series_indices;
+	for (i = 0; i < n_blocks; ++i)
+		if (tsi[i].RED_block_flags & (RED_LEVEL_1_ENCRYPTION_MASK | RED_LEVEL_2_ENCRYPTION_MASK))
+			return(MEF_TRUE);
+
+
+	return(MEF_FALSE);
+}
+
+
+si4	ENVELOPE_write_pyramid(SEGMENT *segment, ENVELOPE_PYRAMID *pyramid)
+{
+	FILE		*fp;
+	ENVELOPE_LEVEL	*level;
+	si1		file_name[MEF_FULL_FILE_NAME_BYTES];
+	si4		i, reserved, written;
+
+
+	// returns -1 if the file could not be written (e.g. a read-only session), or if the segment's data is encrypted;
+	// a partial file is removed
+	if (ENVELOPE_segment_encrypted(segment) != MEF_FALSE)
+		return(-1);
+	ENVELOPE_pyramid_file_name(segment, file_name);
+	fp = e_fopen(file_name, "wb", __FUNCTION__, __LINE__, RETURN_ON_FAIL | SUPPRESS_ERROR_OUTPUT);
+	if (fp == NULL)
+		return(-1);
+
+	reserved = 0;
+	written = fwrite((void *) ENVELOPE_FILE_MAGIC, sizeof(si1), ENVELOPE_FILE_MAGIC_BYTES, fp) == ENVELOPE_FILE_MAGIC_BYTES &&
+		fwrite((void *) pyramid->segment_UUID, sizeof(ui1), UUID_BYTES, fp) == UUID_BYTES &&
+		fwrite((void *) &pyramid->number_of_blocks, sizeof(si8), 1, fp) == 1 &&
+		fwrite((void *) &pyramid->number_of_levels, sizeof(si4), 1, fp) == 1 && fwrite((void *) &reserved, sizeof(si4), 1, fp) == 1;
+	for (i = 0; i < pyramid->number_of_levels && written; ++i) {
+		level = pyramid->levels + i;
+		written = fwrite((void *) &level->bin_samples, sizeof(si8), 1, fp) == 1 && fwrite((void *) &level->number_of_bins, sizeof(si8), 1, fp) == 1;
+	}
+	for (i = 0; i < pyramid->number_of_levels && written; ++i) {
+		level = pyramid->levels + i;
+		written = fwrite((void *) level->block_bins, sizeof(si8), (size_t) (pyramid->number_of_blocks + 1), fp) == (size_t) (pyramid->number_of_blocks + 1) &&
+			fwrite((void *) level->bins, sizeof(ENVELOPE_BIN), (size_t) level->number_of_bins, fp) == (size_t) level->number_of_bins;
+	}
+	if (fclose(fp) != 0)
+		written = 0;
+	if (!written) {
+		remove(file_name);
+		return(-1);
+	}
+
+
+	return(0);
+}
+
+
+/*************************************************************************/
+/*************************  END ENVELOPE FUNCTIONS  **********************/
+/*************************************************************************/
+
+
 #ifdef _WIN32
 	si4	extract_path_parts(si1 *full_file_name, si1 *path, si1 *name, si1 *extension)
 	{
@@ -2380,7 +3854,7 @@ si4	encrypt_records(FILE_PROCESSING_STRUCT *fps)
 	    if (*full_file_name == '/') {
 			MEF_strncpy(temp_full_file_name, full_file_name, MEF_FULL_FILE_NAME_BYTES);  // do non-destructively
 		} else {
-			if (!(MEF_globals->behavior_on_fail & SUPPRESS_ERROR_OUTPUT))
+			if (!(MEF_context->behavior_on_fail & SUPPRESS_ERROR_OUTPUT))
 				(void) fprintf(stderr, "%s() Warning: path \"%s\" does not start from root => prepending current working directory\n", __FUNCTION__, full_file_name);
 			cwd = getenv("PWD");
 			c = full_file_name;
@@ -2568,16 +4042,16 @@ si4	FILT_butter(FILT_PROCESSING_STRUCT *filtps)
         	case FILT_BANDSTOP_TYPE:
                         break;
                 default:
-                        if (!(MEF_globals->behavior_on_fail & SUPPRESS_ERROR_OUTPUT)) {
+                        if (!(MEF_context->behavior_on_fail & SUPPRESS_ERROR_OUTPUT)) {
                                 fprintf(stderr, "Unrecognized filter type: %d [function %s, line %d]\n", filtps->type, __FUNCTION__, __LINE__);
-                                if (MEF_globals->behavior_on_fail & RETURN_ON_FAIL)
+                                if (MEF_context->behavior_on_fail & RETURN_ON_FAIL)
                                         (void) fprintf(stderr, "\t=> returning NULL\n\n");
-                                else if (MEF_globals->behavior_on_fail & EXIT_ON_FAIL)
+                                else if (MEF_context->behavior_on_fail & EXIT_ON_FAIL)
                                         (void) fprintf(stderr, "\t=> exiting program\n\n");
                         }
-                        if (MEF_globals->behavior_on_fail & RETURN_ON_FAIL)
+                        if (MEF_context->behavior_on_fail & RETURN_ON_FAIL)
                                 return(-1);
-                        else if (MEF_globals->behavior_on_fail & EXIT_ON_FAIL)
+                        else if (MEF_context->behavior_on_fail & EXIT_ON_FAIL)
                                 exit(1);
 	}
 	samp_freq = (sf16) filtps->sampling_frequency;
@@ -2731,9 +4205,13 @@ si4	FILT_butter(FILT_PROCESSING_STRUCT *filtps)
         
 	FILT_invert_matrix(ta2, inv_a, poles);
 	
-	FILT_mat_multl((void *) inv_a, (void *) ta1, (void *) a, poles, poles, poles);
+	// FILT_mat_multl() takes single row / column arguments as vectors, so single pole matrices are passed as their row
+	if (poles == 1)
+		FILT_mat_multl((void *) inv_a[0], (void *) ta1[0], (void *) a[0], poles, poles, poles);
+	else
+		FILT_mat_multl((void *) inv_a, (void *) ta1, (void *) a, poles, poles, poles);
         
-	FILT_mat_multl((void *) c, (void *) inv_a, (void *) bt, 1, poles, poles);
+	FILT_mat_multl((void *) c, (poles == 1) ? (void *) inv_a[0] : (void *) inv_a, (void *) bt, 1, poles, poles);
 	t = sqrtl((sf16) 0.5);
 	for (i = 0; i < poles; ++i)
 		c[i] = bt[i] * t;
@@ -2741,7 +4219,7 @@ si4	FILT_butter(FILT_PROCESSING_STRUCT *filtps)
 	FILT_mat_multl((void *) bt, (void *) b, (void *) &t, 1, poles, 1);
 	d += (t * (sf16) 0.25);
 	
-	FILT_mat_multl((void *) inv_a, (void *) b, (void *) bt, poles, poles, 1);
+	FILT_mat_multl((poles == 1) ? (void *) inv_a[0] : (void *) inv_a, (void *) b, (void *) bt, poles, poles, 1);
 	t = FILT_ONE / sqrtl((sf16) 2.0);
 	for (i = 0; i < poles; ++i)
 		b[i] = bt[i] * t;
@@ -2862,16 +4340,16 @@ si4	FILT_butter(FILT_PROCESSING_STRUCT *filtps)
 		d_den[i] = (sf8) den[i];
 		d_num[i] = (sf8) num[i];
 		if (isnan(d_num[i]) || isinf(d_num[i]) || isnan(d_den[i]) || isinf(d_den[i])) {
-                        if (!(MEF_globals->behavior_on_fail & SUPPRESS_ERROR_OUTPUT)) {
+                        if (!(MEF_context->behavior_on_fail & SUPPRESS_ERROR_OUTPUT)) {
                                 fprintf(stderr, "Bad filter: [function %s, line %d]\n", __FUNCTION__, __LINE__);
-                                if (MEF_globals->behavior_on_fail & RETURN_ON_FAIL)
+                                if (MEF_context->behavior_on_fail & RETURN_ON_FAIL)
                                         (void) fprintf(stderr, "\t=> returning FILT_BAD_FILTER\n\n");
-                                else if (MEF_globals->behavior_on_fail & EXIT_ON_FAIL)
+                                else if (MEF_context->behavior_on_fail & EXIT_ON_FAIL)
                                         (void) fprintf(stderr, "\t=> exiting program\n\n");
                         }
-                        if (MEF_globals->behavior_on_fail & RETURN_ON_FAIL)
+                        if (MEF_context->behavior_on_fail & RETURN_ON_FAIL)
                                 return(FILT_BAD_FILTER);
-                        else if (MEF_globals->behavior_on_fail & EXIT_ON_FAIL)
+                        else if (MEF_context->behavior_on_fail & EXIT_ON_FAIL)
                                 exit(FILT_BAD_FILTER);
 
 			exit(FILT_BAD_FILTER);
@@ -2909,44 +4387,300 @@ si4	FILT_butter(FILT_PROCESSING_STRUCT *filtps)
 }
 
 
-void	FILT_complex_divl(FILT_LONG_COMPLEX *a, FILT_LONG_COMPLEX *b, FILT_LONG_COMPLEX *quotient)  //  returns a / b
+si4	FILT_butter_sf8(FILT_PROCESSING_STRUCT *filtps)
 {
-        FILT_LONG_COMPLEX	ta, tb;
-	sf16			den;
-        
-        
-        ta = *a;  // copy in case in place
-        tb = *b;
-	den = (tb.real * tb.real) + (tb.imag * tb.imag);
-        quotient->real = ((ta.real * tb.real) + (ta.imag * tb.imag)) / den;
-        quotient->imag = ((ta.imag * tb.real) - (ta.real * tb.imag)) / den;
+	si4		i, j, n_fcs, order, poles, n_zeros;
+	sf8		samp_freq, u[2], pi, bw, wn, w, sum_num, sum_den, ratio;
+	sf8		num[(2 * FILT_MAX_ORDER) + 1], den[(2 * FILT_MAX_ORDER) + 1];
+	FILT_COMPLEX	proto[FILT_MAX_ORDER], p[2 * FILT_MAX_ORDER], z[2 * FILT_MAX_ORDER];
+	FILT_COMPLEX	cnum[(2 * FILT_MAX_ORDER) + 1], cden[(2 * FILT_MAX_ORDER) + 1];
+	FILT_COMPLEX	tc, tc2, csum_num, csum_den, cratio, ckern;
 	
-        
-        return;
-}
-
-
-void	FILT_complex_expl(FILT_LONG_COMPLEX *exponent, FILT_LONG_COMPLEX *ans)
-{
-        FILT_LONG_COMPLEX    t;
-        sf16            	c;
-        
-        
-        t = *exponent;  // copy in case in place
-        c = expl(t.real);
-        ans->real = c * cosl(t.imag);
-        ans->imag = c * sinl(t.imag);
-        
-        
-        return;
-}
-
-
-void	FILT_complex_multl(FILT_LONG_COMPLEX *a, FILT_LONG_COMPLEX *b, FILT_LONG_COMPLEX *product)
-{
-        FILT_LONG_COMPLEX    ta, tb;
-        
-        
+	
+	// Double precision Butterworth design from the zeros & poles; same transfer function as FILT_butter()
+	// (prototype => frequency transformation => bilinear transformation with the same prewarping), without the
+	// state-space eigenvalue problem that needs sf16. See FILT_design() for where it is used.
+	
+	// check input (no error output: FILT_design() falls back to FILT_butter(), which reports)
+	switch(filtps->type) {
+		case FILT_LOWPASS_TYPE:
+		case FILT_BANDPASS_TYPE:
+		case FILT_HIGHPASS_TYPE:
+		case FILT_BANDSTOP_TYPE:
+			break;
+		default:
+			return(FILT_BAD_FILTER);
+	}
+	samp_freq = filtps->sampling_frequency;
+	n_fcs = ((filtps->type == FILT_LOWPASS_TYPE) || (filtps->type == FILT_HIGHPASS_TYPE)) ? 1 : 2;
+	order = filtps->order;
+	filtps->poles = poles = n_fcs * order;
+	if (order < 1 || poles > (2 * FILT_MAX_ORDER))
+		return(FILT_BAD_FILTER);
+	
+	// step 1: get analog, pre-warped frequencies
+	pi = M_PI;
+	for (i = 0; i < n_fcs; ++i)
+		u[i] = 4.0 * tan((pi * filtps->cutoffs[i]) / samp_freq);
+	bw = wn = w = 0.0;
+	if (n_fcs == 1) {
+		wn = u[0];
+	} else {
+		bw = u[1] - u[0];
+		wn = sqrt(u[0] * u[1]);
+	}
+	
+	// step 2: N-th order Butterworth analog lowpass prototype poles (unit circle, left half plane)
+	for (i = 0; i < order; ++i) {
+		tc.real = 0.0;
+		tc.imag = (pi * (sf8) ((2 * i) + order + 1)) / (sf8) (2 * order);
+		FILT_complex_exp(&tc, proto + i);
+	}
+	
+	// step 3: transform to lowpass, bandpass, highpass, or bandstop of desired Wn
+	n_zeros = 0;
+	switch (filtps->type) {
+		case FILT_LOWPASS_TYPE:  // s => s / wn
+			for (i = 0; i < order; ++i) {
+				p[i].real = wn * proto[i].real;
+				p[i].imag = wn * proto[i].imag;
+			}
+			break;
+		case FILT_HIGHPASS_TYPE:  // s => wn / s
+			for (i = 0; i < order; ++i) {
+				tc.real = wn;
+				tc.imag = 0.0;
+				FILT_complex_div(&tc, proto + i, p + i);
+				z[n_zeros].real = z[n_zeros].imag = 0.0;
+				++n_zeros;
+			}
+			break;
+		case FILT_BANDPASS_TYPE:  // s => (s^2 + wn^2) / (s * bw)
+		case FILT_BANDSTOP_TYPE:  // s => (s * bw) / (s^2 + wn^2)
+			for (i = 0; i < order; ++i) {
+				if (filtps->type == FILT_BANDPASS_TYPE) {
+					tc.real = proto[i].real * (bw / 2.0);
+					tc.imag = proto[i].imag * (bw / 2.0);
+				} else {
+					tc2.real = bw / 2.0;
+					tc2.imag = 0.0;
+					FILT_complex_div(&tc2, proto + i, &tc);
+				}
+				FILT_complex_mult(&tc, &tc, &tc2);
+				tc2.real -= wn * wn;
+				FILT_complex_sqrt(&tc2, &tc2);
+				p[i].real = tc.real + tc2.real;
+				p[i].imag = tc.imag + tc2.imag;
+				p[i + order].real = tc.real - tc2.real;
+				p[i + order].imag = tc.imag - tc2.imag;
+				if (filtps->type == FILT_BANDPASS_TYPE) {
+					z[n_zeros].real = z[n_zeros].imag = 0.0;
+					++n_zeros;
+				} else {
+					z[n_zeros].real = 0.0;
+					z[n_zeros++].imag = wn;
+					z[n_zeros].real = 0.0;
+					z[n_zeros++].imag = -wn;
+				}
+			}
+			break;
+	}
+	
+	// step 4: bilinear transformation (sampling frequency 2 => s = 4 (z - 1) / (z + 1)); zeros at infinity map to -1
+	for (i = 0; i < poles; ++i) {
+		tc.real = 4.0 + p[i].real;
+		tc.imag = p[i].imag;
+		tc2.real = 4.0 - p[i].real;
+		tc2.imag = -p[i].imag;
+		FILT_complex_div(&tc, &tc2, p + i);
+	}
+	for (i = 0; i < n_zeros; ++i) {
+		tc.real = 4.0 + z[i].real;
+		tc.imag = z[i].imag;
+		tc2.real = 4.0 - z[i].real;
+		tc2.imag = -z[i].imag;
+		FILT_complex_div(&tc, &tc2, z + i);
+	}
+	for (; i < poles; ++i) {
+		z[i].real = -1.0;
+		z[i].imag = 0.0;
+	}
+	
+	// expand to polynomials
+	for (i = 0; i <= poles; ++i)
+		cnum[i].real = cnum[i].imag = cden[i].real = cden[i].imag = 0.0;
+	cnum[0].real = cden[0].real = 1.0;
+	for (i = 0; i < poles; ++i) {
+		for (j = i + 1; j--;) {
+			FILT_complex_mult(p + i, cden + j, &tc);
+			cden[j + 1].real -= tc.real;
+			cden[j + 1].imag -= tc.imag;
+			FILT_complex_mult(z + i, cnum + j, &tc);
+			cnum[j + 1].real -= tc.real;
+			cnum[j + 1].imag -= tc.imag;
+		}
+	}
+	for (i = 0; i <= poles; ++i) {
+		num[i] = cnum[i].real;
+		den[i] = cden[i].real;
+	}
+	
+	// normalize (as in FILT_butter(): unit gain at DC, or at the center frequency / Nyquist)
+	if ((filtps->type == FILT_LOWPASS_TYPE) || (filtps->type == FILT_BANDSTOP_TYPE)) {
+		sum_num = sum_den = 0.0;
+		for (i = 0; i <= poles; ++i) {
+			sum_num += num[i];
+			sum_den += den[i];
+		}
+		ratio = sum_den / sum_num;
+		for (i = 0; i <= poles; ++i)
+			num[i] *= ratio;
+	} else {
+		w = (filtps->type == FILT_BANDPASS_TYPE) ? -2.0 * atan2(wn, 4.0) : -pi;
+		csum_num.real = csum_den.real = csum_num.imag = csum_den.imag = 0.0;
+		for (i = 0; i <= poles; ++i) {
+			tc.real = 0.0;
+			tc.imag = w * (sf8) i;
+			FILT_complex_exp(&tc, &ckern);
+			csum_num.real += ckern.real * num[i];
+			csum_num.imag += ckern.imag * num[i];
+			csum_den.real += ckern.real * den[i];
+			csum_den.imag += ckern.imag * den[i];
+		}
+		FILT_complex_div(&csum_den, &csum_num, &cratio);
+		for (i = 0; i <= poles; ++i)
+			num[i] *= cratio.real;
+	}
+	
+	// check & set output
+	for (i = 0; i <= poles; ++i)
+		if (isnan(num[i]) || isinf(num[i]) || isnan(den[i]) || isinf(den[i]))
+			return(FILT_BAD_FILTER);
+	filtps->numerators = (sf8 *) e_calloc((size_t) (poles + 1), sizeof(sf8), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	filtps->denominators = (sf8 *) e_calloc((size_t) (poles + 1), sizeof(sf8), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	for (i = 0; i <= poles; ++i) {
+		filtps->numerators[i] = num[i];
+		filtps->denominators[i] = den[i];
+	}
+	
+	
+	return(0);
+}
+
+
+si4	FILT_check_cutoff_gain(FILT_PROCESSING_STRUCT *filtps, sf8 tolerance)
+{
+	si4		i, j, n_fcs;
+	sf8		w, num_real, num_imag, den_real, den_imag, gain;
+	
+	
+	// a Butterworth filter has a gain of 1/sqrt(2) at each cutoff: returns MEF_TRUE if the coefficients satisfy this within tolerance
+	n_fcs = ((filtps->type == FILT_LOWPASS_TYPE) || (filtps->type == FILT_HIGHPASS_TYPE)) ? 1 : 2;
+	for (i = 0; i < n_fcs; ++i) {
+		w = (-2.0 * M_PI * filtps->cutoffs[i]) / filtps->sampling_frequency;
+		num_real = num_imag = den_real = den_imag = 0.0;
+		for (j = 0; j <= filtps->poles; ++j) {
+			num_real += filtps->numerators[j] * cos(w * (sf8) j);
+			num_imag += filtps->numerators[j] * sin(w * (sf8) j);
+			den_real += filtps->denominators[j] * cos(w * (sf8) j);
+			den_imag += filtps->denominators[j] * sin(w * (sf8) j);
+		}
+		gain = sqrt(((num_real * num_real) + (num_imag * num_imag)) / ((den_real * den_real) + (den_imag * den_imag)));
+		if (isnan(gain) || fabs(gain - sqrt(0.5)) > tolerance)
+			return(MEF_FALSE);
+	}
+	
+	
+	return(MEF_TRUE);
+}
+
+
+void	FILT_complex_div(FILT_COMPLEX *a, FILT_COMPLEX *b, FILT_COMPLEX *quotient)  //  returns a / b
+{
+	FILT_COMPLEX	ta, tb;
+	sf8		den;
+	
+	
+	ta = *a;  // copy in case in place
+	tb = *b;
+	den = (tb.real * tb.real) + (tb.imag * tb.imag);
+	quotient->real = ((ta.real * tb.real) + (ta.imag * tb.imag)) / den;
+	quotient->imag = ((ta.imag * tb.real) - (ta.real * tb.imag)) / den;
+	
+	
+	return;
+}
+
+
+void	FILT_complex_divl(FILT_LONG_COMPLEX *a, FILT_LONG_COMPLEX *b, FILT_LONG_COMPLEX *quotient)  //  returns a / b
+{
+        FILT_LONG_COMPLEX	ta, tb;
+	sf16			den;
+        
+        
+        ta = *a;  // copy in case in place
+        tb = *b;
+	den = (tb.real * tb.real) + (tb.imag * tb.imag);
+        quotient->real = ((ta.real * tb.real) + (ta.imag * tb.imag)) / den;
+        quotient->imag = ((ta.imag * tb.real) - (ta.real * tb.imag)) / den;
+	
+        
+        return;
+}
+
+
+void	FILT_complex_exp(FILT_COMPLEX *exponent, FILT_COMPLEX *ans)
+{
+	FILT_COMPLEX	t;
+	sf8		c;
+	
+	
+	t = *exponent;  // copy in case in place
+	c = exp(t.real);
+	ans->real = c * cos(t.imag);
+	ans->imag = c * sin(t.imag);
+	
+	
+	return;
+}
+
+
+void	FILT_complex_expl(FILT_LONG_COMPLEX *exponent, FILT_LONG_COMPLEX *ans)
+{
+        FILT_LONG_COMPLEX    t;
+        sf16            	c;
+        
+        
+        t = *exponent;  // copy in case in place
+        c = expl(t.real);
+        ans->real = c * cosl(t.imag);
+        ans->imag = c * sinl(t.imag);
+        
+        
+        return;
+}
+
+
+void	FILT_complex_mult(FILT_COMPLEX *a, FILT_COMPLEX *b, FILT_COMPLEX *product)
+{
+	FILT_COMPLEX	ta, tb;
+	
+	
+	ta = *a;  // copy in case in place
+	tb = *b;
+	product->real = (ta.real * tb.real) - (ta.imag * tb.imag);
+	product->imag = (ta.real * tb.imag) + (ta.imag * tb.real);
+	
+	
+	return;
+}
+
+
+void	FILT_complex_multl(FILT_LONG_COMPLEX *a, FILT_LONG_COMPLEX *b, FILT_LONG_COMPLEX *product)
+{
+        FILT_LONG_COMPLEX    ta, tb;
+        
+        
         ta = *a;  // copy in case in place
         tb = *b;
         product->real = (ta.real * tb.real) - (ta.imag * tb.imag);
@@ -2957,6 +4691,43 @@ void	FILT_complex_multl(FILT_LONG_COMPLEX *a, FILT_LONG_COMPLEX *b, FILT_LONG_CO
 }
 
 
+void	FILT_complex_sqrt(FILT_COMPLEX *a, FILT_COMPLEX *root)  // principal square root
+{
+	FILT_COMPLEX	t;
+	sf8		mag;
+	
+	
+	t = *a;  // copy in case in place
+	mag = sqrt((t.real * t.real) + (t.imag * t.imag));
+	root->real = sqrt((mag + t.real) / 2.0);
+	root->imag = sqrt((mag - t.real) / 2.0);
+	if (t.imag < 0.0)
+		root->imag = -root->imag;
+	
+	
+	return;
+}
+
+
+si4	FILT_design(FILT_PROCESSING_STRUCT *filtps)
+{
+	// numerators & denominators: double precision design where it is numerically safe, sf16 reference otherwise
+	if (FILT_butter_sf8(filtps) == 0) {
+		if ((filtps->type == FILT_LOWPASS_TYPE) || (filtps->type == FILT_HIGHPASS_TYPE))
+			return(0);
+		if (FILT_check_cutoff_gain(filtps, FILT_SF8_CUTOFF_GAIN_TOLERANCE) == MEF_TRUE)
+			return(0);
+	}
+	if (filtps->numerators != NULL) {
+		free(filtps->numerators);
+		free(filtps->denominators);
+		filtps->numerators = filtps->denominators = NULL;
+	}
+	
+	return(FILT_butter(filtps));
+}
+
+
 void	FILT_elmhes(sf16 **a, si4 poles)
 {
         si4     i, j, m;
@@ -3018,14 +4789,14 @@ si4	FILT_filtfilt(FILT_PROCESSING_STRUCT *filtps)
         pad_lenx2 = pad_len * 2;
 	data_len = filtps->data_length;
 	if (data_len < pad_lenx2) {
-		if (!(MEF_globals->behavior_on_fail & SUPPRESS_ERROR_OUTPUT)) {
+		if (!(MEF_context->behavior_on_fail & SUPPRESS_ERROR_OUTPUT)) {
 			fprintf(stderr, "At least %d data points for a filter of order %d: [function %s, line %d]\n", pad_lenx2, poles, __FUNCTION__, __LINE__);
-			if (MEF_globals->behavior_on_fail & RETURN_ON_FAIL)
+			if (MEF_context->behavior_on_fail & RETURN_ON_FAIL)
 				(void) fprintf(stderr, "\t=> returning without filtering\n\n");
-			else if (MEF_globals->behavior_on_fail & EXIT_ON_FAIL)
+			else if (MEF_context->behavior_on_fail & EXIT_ON_FAIL)
 				(void) fprintf(stderr, "\t=> exiting program\n\n");
 		}
-		if (MEF_globals->behavior_on_fail & EXIT_ON_FAIL)
+		if (MEF_context->behavior_on_fail & EXIT_ON_FAIL)
 			exit(FILT_BAD_DATA);
 		return(FILT_BAD_DATA);
 	}
@@ -3161,7 +4932,7 @@ void	FILT_generate_initial_conditions(FILT_PROCESSING_STRUCT *filtps)
                 rhs[i] = (sf16) num[j] - ((sf16) num[0] * (sf16) den[j]);
         
         FILT_invert_matrix(q, q, poles);
-        FILT_mat_multl(q, rhs, z, poles, poles, 1);
+        FILT_mat_multl((poles == 1) ? (void *) q[0] : (void *) q, rhs, z, poles, poles, 1);  // a single pole matrix as a vector
         
         for (i = 0; i < poles; ++i)
                 filtps->initial_conditions[i] = (sf8) z[i];
@@ -3348,6 +5119,66 @@ void	FILT_hqr(sf16 **a, si4 poles, FILT_LONG_COMPLEX *eigs)
 }
 
 
+si4	FILT_get_cached_coefficients(FILT_PROCESSING_STRUCT *filtps)
+{
+	FILT_COEFFICIENT_CACHE	*cache;
+	FILT_COEFFICIENTS	*entry;
+	si4			i, poles, found;
+	
+	
+	// copies the cached design for (order, type, sampling frequency, cutoffs) into filtps; returns MEF_FALSE if not cached
+	cache = MEF_globals->FILT_coefficient_cache;
+	if (cache == NULL)
+		return(MEF_FALSE);
+	
+	found = MEF_FALSE;
+	THREAD_mutex_lock(&cache->mutex);
+	for (i = 0; i < cache->number_of_entries; ++i) {
+		entry = cache->entries + i;
+		if (entry->order != filtps->order || entry->type != filtps->type || entry->sampling_frequency != filtps->sampling_frequency)
+			continue;
+		if (entry->cutoffs[0] != filtps->cutoffs[0] || entry->cutoffs[1] != filtps->cutoffs[1])
+			continue;
+		filtps->poles = poles = entry->poles;
+		filtps->numerators = (sf8 *) e_calloc((size_t) (poles + 1), sizeof(sf8), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+		filtps->denominators = (sf8 *) e_calloc((size_t) (poles + 1), sizeof(sf8), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+		filtps->initial_conditions = (sf8 *) e_calloc((size_t) poles, sizeof(sf8), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+		memcpy(filtps->numerators, entry->numerators, (size_t) (poles + 1) * sizeof(sf8));
+		memcpy(filtps->denominators, entry->denominators, (size_t) (poles + 1) * sizeof(sf8));
+		memcpy(filtps->initial_conditions, entry->initial_conditions, (size_t) poles * sizeof(sf8));
+		found = MEF_TRUE;
+		break;
+	}
+	if (found == MEF_TRUE)
+		++cache->hits;
+	else
+		++cache->misses;
+	THREAD_mutex_unlock(&cache->mutex);
+	
+	
+	return(found);
+}
+
+
+FILT_COEFFICIENT_CACHE	*FILT_initialize_coefficient_cache(si4 global_flag)
+{
+	FILT_COEFFICIENT_CACHE	*cache;
+	
+	
+	if (global_flag == MEF_TRUE && MEF_globals->FILT_coefficient_cache != NULL)
+		return(MEF_globals->FILT_coefficient_cache);
+	
+	cache = (FILT_COEFFICIENT_CACHE *) e_calloc((size_t) 1, sizeof(FILT_COEFFICIENT_CACHE), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	THREAD_mutex_init(&cache->mutex);
+	
+	if (global_flag == MEF_TRUE)
+		MEF_globals->FILT_coefficient_cache = cache;
+	
+	
+	return(cache);
+}
+
+
 FILT_PROCESSING_STRUCT	*FILT_initialize_processing_struct(si4 order, si4 type, sf8 samp_freq, si8 data_len, si1 alloc_orig_data, si1 alloc_filt_data, sf8 cutoff_1, ...)
 {
 	si8			buff_len;
@@ -3372,9 +5203,12 @@ FILT_PROCESSING_STRUCT	*FILT_initialize_processing_struct(si4 order, si4 type, s
 		va_end(argp);
 	}
 	
-	// geneerate coefficients
-	FILT_butter(filtps);
-	FILT_generate_initial_conditions(filtps);
+	// geneerate coefficients (designed once per configuration)
+	if (FILT_get_cached_coefficients(filtps) == MEF_FALSE) {
+		FILT_design(filtps);
+		FILT_generate_initial_conditions(filtps);
+		FILT_put_cached_coefficients(filtps);
+	}
 	
 	// allocate
 	if (alloc_orig_data == MEF_TRUE)
@@ -3527,6 +5361,42 @@ void	FILT_mat_multl(void *a, void *b, void *product, si4 outer_dim1, si4 inner_d
 }
 
 
+void	FILT_put_cached_coefficients(FILT_PROCESSING_STRUCT *filtps)
+{
+	FILT_COEFFICIENT_CACHE	*cache;
+	FILT_COEFFICIENTS	*entry;
+	si4			poles;
+	
+	
+	cache = MEF_globals->FILT_coefficient_cache;
+	poles = filtps->poles;
+	if (cache == NULL || poles < 1 || poles > (2 * FILT_MAX_ORDER))
+		return;
+	if (filtps->numerators == NULL || filtps->denominators == NULL || filtps->initial_conditions == NULL)
+		return;
+	
+	THREAD_mutex_lock(&cache->mutex);
+	entry = cache->entries + cache->next_entry;
+	entry->order = filtps->order;
+	entry->type = filtps->type;
+	entry->poles = poles;
+	entry->sampling_frequency = filtps->sampling_frequency;
+	entry->cutoffs[0] = filtps->cutoffs[0];
+	entry->cutoffs[1] = filtps->cutoffs[1];
+	memcpy(entry->numerators, filtps->numerators, (size_t) (poles + 1) * sizeof(sf8));
+	memcpy(entry->denominators, filtps->denominators, (size_t) (poles + 1) * sizeof(sf8));
+	memcpy(entry->initial_conditions, filtps->initial_conditions, (size_t) poles * sizeof(sf8));
+	if (cache->number_of_entries < FILT_COEFFICIENT_CACHE_ENTRIES)
+		++cache->number_of_entries;
+	if (++cache->next_entry == FILT_COEFFICIENT_CACHE_ENTRIES)
+		cache->next_entry = 0;
+	THREAD_mutex_unlock(&cache->mutex);
+	
+	
+	return;
+}
+
+
 void	FILT_unsymmeig(sf16 **a, si4 poles, FILT_LONG_COMPLEX *eigs)
 {
         FILT_balance(a, poles);
@@ -3538,6 +5408,57 @@ void	FILT_unsymmeig(sf16 **a, si4 poles, FILT_LONG_COMPLEX *eigs)
 }
 
 
+si4	FILT_validate_sf8_design(si4 order, si4 type, sf8 samp_freq, sf8 cutoff_1, sf8 cutoff_2, sf8 *max_relative_difference)
+{
+	FILT_PROCESSING_STRUCT	ref, dbl;
+	si4			i, ret_val;
+	sf8			max_coeff, max_diff, diff;
+	
+	
+	// compares the double precision design against the sf16 reference; returns MEF_TRUE if within FILT_SF8_DESIGN_TOLERANCE
+	memset((void *) &ref, 0, sizeof(FILT_PROCESSING_STRUCT));
+	ref.order = order;
+	ref.type = type;
+	ref.sampling_frequency = samp_freq;
+	ref.cutoffs[0] = cutoff_1;
+	ref.cutoffs[1] = cutoff_2;
+	dbl = ref;
+	if (FILT_butter(&ref) != 0 || FILT_butter_sf8(&dbl) != 0 || ref.poles != dbl.poles) {
+		ret_val = MEF_FALSE;
+		max_diff = -1.0;
+	} else {
+		max_coeff = max_diff = 0.0;
+		for (i = 0; i <= ref.poles; ++i) {
+			if (fabs(ref.numerators[i]) > max_coeff)
+				max_coeff = fabs(ref.numerators[i]);
+			if (fabs(ref.denominators[i]) > max_coeff)
+				max_coeff = fabs(ref.denominators[i]);
+		}
+		for (i = 0; i <= ref.poles; ++i) {
+			if ((diff = fabs(ref.numerators[i] - dbl.numerators[i]) / max_coeff) > max_diff)
+				max_diff = diff;
+			if ((diff = fabs(ref.denominators[i] - dbl.denominators[i]) / max_coeff) > max_diff)
+				max_diff = diff;
+		}
+		ret_val = (max_diff <= FILT_SF8_DESIGN_TOLERANCE) ? MEF_TRUE : MEF_FALSE;
+	}
+	if (max_relative_difference != NULL)
+		*max_relative_difference = max_diff;
+	
+	if (ref.numerators != NULL) {
+		free(ref.numerators);
+		free(ref.denominators);
+	}
+	if (dbl.numerators != NULL) {
+		free(dbl.numerators);
+		free(dbl.denominators);
+	}
+	
+	
+	return(ret_val);
+}
+
+
 /*************************************************************************/
 /**************************  END FILTER FUNCTIONS  ***********************/
 /*************************************************************************/
@@ -3593,12 +5514,12 @@ void	force_behavior(ui4 behavior)
 	
 	
 	if (behavior == RESTORE_BEHAVIOR) {
-		MEF_globals->behavior_on_fail = saved_behavior;
+		MEF_context->behavior_on_fail = saved_behavior;
 		return;
 	}
 	
-	saved_behavior = MEF_globals->behavior_on_fail;
-	MEF_globals->behavior_on_fail = behavior;
+	saved_behavior = MEF_context->behavior_on_fail;
+	MEF_context->behavior_on_fail = behavior;
 	
 	
 	return;
@@ -3619,6 +5540,70 @@ void	fps_close(FILE_PROCESSING_STRUCT *fps) {
 	return;
 }
 
+si4	fps_find_index_entry(FILE_PROCESSING_STRUCT *fps, si4 key_type, si8 key, si8 *entry)
+{
+	si1	opened_file;
+	si4	ret_val;
+	si8	low, high, mid, entry_key;
+	
+	
+	// finds the last entry of a time series or record indices file with a key <= key (*entry = -1 if none) by binary
+	// search; on demand indices are searched in the file, a page read per step (the file kept open during the search);
+	// times compare with the recording time offset removed, as in record queries; returns 0, or -1 if the entries could
+	// not be read
+	*entry = -1;
+	if (fps == NULL || fps->universal_header == NULL)
+		return(-1);
+	if (fps->file_type_code == TIME_SERIES_INDICES_FILE_TYPE_CODE) {
+		if (fps->time_series_indices == NULL)
+			return(-1);
+	} else if (fps->file_type_code != RECORD_INDICES_FILE_TYPE_CODE || fps->record_indices == NULL || key_type != FPS_INDEX_KEY_TIME) {
+		return(-1);
+	}
+	if (key_type == FPS_INDEX_KEY_TIME)
+		remove_recording_time_offset(&key);
+	
+	opened_file = MEF_FALSE;
+	if (fps->index_pages_read != NULL && fps->fp == NULL) {
+		fps->directives.open_mode = FPS_R_OPEN_MODE;
+		if (fps_open(fps, __FUNCTION__, __LINE__, RETURN_ON_FAIL | SUPPRESS_ERROR_OUTPUT) != 0 || fps->fp == NULL)
+			return(-1);
+		opened_file = MEF_TRUE;
+	}
+	
+	// first entry with a key > key
+	ret_val = 0;
+	low = 0;
+	high = fps->universal_header->number_of_entries;
+	while (low < high) {
+		mid = low + ((high - low) >> 1);
+		if (fps_read_index_entries(fps, mid, mid) < 0) {
+			ret_val = -1;
+			break;
+		}
+		if (fps->file_type_code == RECORD_INDICES_FILE_TYPE_CODE)
+			entry_key = fps->record_indices[mid].time;
+		else if (key_type == FPS_INDEX_KEY_SAMPLE)
+			entry_key = fps->time_series_indices[mid].start_sample;
+		else
+			entry_key = fps->time_series_indices[mid].start_time;
+		if (key_type == FPS_INDEX_KEY_TIME)
+			remove_recording_time_offset(&entry_key);
+		if (entry_key <= key)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	if (ret_val == 0)
+		*entry = low - 1;
+	
+	if (opened_file == MEF_TRUE)
+		fps_close(fps);
+	
+	
+	return(ret_val);
+}
+
 #ifndef _WIN32
 	si4	fps_lock(FILE_PROCESSING_STRUCT *fps, si4 lock_type, const si1 *function, si4 line, ui4 behavior_on_fail)
 	{
@@ -3626,7 +5611,7 @@ void	fps_close(FILE_PROCESSING_STRUCT *fps) {
 		
 		
 		if (behavior_on_fail == USE_GLOBAL_BEHAVIOR)
-			behavior_on_fail = MEF_globals->behavior_on_fail;
+			behavior_on_fail = MEF_context->behavior_on_fail;
 		
 		fl.l_type = lock_type;
 		fl.l_whence = SEEK_SET;
@@ -3641,7 +5626,7 @@ void	fps_close(FILE_PROCESSING_STRUCT *fps) {
 					(void) fprintf(stderr, "\tcalled from function \"%s\", line %d\n", function, line);
 				if (behavior_on_fail & RETURN_ON_FAIL)
 					(void) fprintf(stderr, "\t=> returning -1\n\n");
-				else if (MEF_globals->behavior_on_fail & EXIT_ON_FAIL)
+				else if (MEF_context->behavior_on_fail & EXIT_ON_FAIL)
 					(void) fprintf(stderr, "\t=> exiting program\n\n");
 			}
 			if (behavior_on_fail & RETURN_ON_FAIL)
@@ -3666,7 +5651,7 @@ si4	fps_open(FILE_PROCESSING_STRUCT *fps, const si1 *function, si4 line, ui4 beh
 	
 	
 	if (behavior_on_fail == USE_GLOBAL_BEHAVIOR)
-		behavior_on_fail = MEF_globals->behavior_on_fail;
+		behavior_on_fail = MEF_context->behavior_on_fail;
 	
 	// open
 	mode = NULL;
@@ -3739,8 +5724,8 @@ si4	fps_open(FILE_PROCESSING_STRUCT *fps, const si1 *function, si4 line, ui4 beh
 	fps->fd = fileno(fps->fp);
 	
 	#ifndef _WIN32
-		// lock
-		if (fps->directives.lock_mode != FPS_NO_LOCK_MODE) {
+		// lock (positional I/O takes no locks on read only opens)
+		if (fps->directives.lock_mode != FPS_NO_LOCK_MODE && !(FPS_POSITIONAL_IO && fps->directives.open_mode == FPS_R_OPEN_MODE)) {
 			lock_type = FPS_NO_LOCK_TYPE;
 			if (fps->directives.open_mode == FPS_R_OPEN_MODE) {
 				if (fps->directives.lock_mode & FPS_READ_LOCK_ON_READ_OPEN)
@@ -3750,7 +5735,7 @@ si4	fps_open(FILE_PROCESSING_STRUCT *fps, const si1 *function, si4 line, ui4 beh
 			} else if (fps->directives.lock_mode & (FPS_WRITE_LOCK_ON_WRITE_OPEN | FPS_WRITE_LOCK_ON_READ_WRITE_OPEN)) {
 				lock_type = F_WRLCK;
 			} else {
-				if (!(MEF_globals->behavior_on_fail & SUPPRESS_ERROR_OUTPUT)) {
+				if (!(MEF_context->behavior_on_fail & SUPPRESS_ERROR_OUTPUT)) {
 					(void) fprintf(stderr, "%c\n\t%s(): incompatible lock (%u) and open (%u) modes\n", 7, __FUNCTION__, fps->directives.lock_mode, fps->directives.open_mode);
 					if (function != NULL)
 						(void) fprintf(stderr, "\tcalled from function \"%s\", line %d\n", function, line);
@@ -3780,41 +5765,219 @@ si4	fps_open(FILE_PROCESSING_STRUCT *fps, const si1 *function, si4 line, ui4 beh
 si4	fps_read(FILE_PROCESSING_STRUCT *fps, const si1 *function, si4 line, ui4 behavior_on_fail)
 {
 	si8		i_bytes;
+	#ifndef _WIN32
+		si4	lock;
+	#endif
 	
 	
 	if (behavior_on_fail == USE_GLOBAL_BEHAVIOR)
-		behavior_on_fail = MEF_globals->behavior_on_fail;
+		behavior_on_fail = MEF_context->behavior_on_fail;
 	
 	#ifndef _WIN32
-		// lock
-		if (fps->directives.lock_mode & FPS_READ_LOCK_ON_READ)
+		// lock (positional I/O takes no locks on read only opens)
+		lock = (fps->directives.lock_mode & FPS_READ_LOCK_ON_READ) && !(FPS_POSITIONAL_IO && fps->directives.open_mode == FPS_R_OPEN_MODE);
+		if (lock)
 			fps_lock(fps, F_RDLCK, function, line, behavior_on_fail);
 	#endif
-	// read
+	// read (from the start of the file)
 	if (fps->directives.io_bytes == FPS_FULL_FILE)
 		i_bytes = fps->file_length;
 	else
 		i_bytes = fps->directives.io_bytes;
+	#ifndef _WIN32
+		if (FPS_POSITIONAL_IO)
+			(void) e_pread(fps->fd, fps->raw_data, i_bytes, 0, fps->full_file_name, __FUNCTION__, __LINE__, behavior_on_fail);
+		else
+	#endif
 	(void) e_fread(fps->raw_data, sizeof(ui1), (size_t) i_bytes, fps->fp, fps->full_file_name, __FUNCTION__, __LINE__, behavior_on_fail);
 	
 	#ifndef _WIN32
 		// unlock
-		if (fps->directives.lock_mode & FPS_READ_LOCK_ON_READ)
+		if (lock)
 			fps_unlock(fps, function, line, behavior_on_fail);
 	#endif
 	
 	return(0);
 }
 
-#ifndef _WIN32
-	si4	fps_unlock(FILE_PROCESSING_STRUCT *fps, const si1 *function, si4 line, ui4 behavior_on_fail)
-	{
-		struct flock	fl;
-		
-		
-		if (behavior_on_fail == USE_GLOBAL_BEHAVIOR)
-			behavior_on_fail = MEF_globals->behavior_on_fail;
-		
+
+si4	fps_read_index_entries(FILE_PROCESSING_STRUCT *fps, si8 first_entry, si8 last_entry)
+{
+	si1		opened_file, apply, remove;
+	ui4		mode;
+	si8		i, j, k, page, first_page, last_page, entry_bytes, page_bytes, offset, bytes, range_bytes, n_ranges;
+	si8		*time;
+	FPS_RANGE	*ranges;
+	
+	
+	// reads entries [first_entry, last_entry] of on demand indices (see read_MEF_indices()) that are not in memory yet,
+	// in whole pages (each run of pages with one read), & offsets their times as read_MEF_file() does for whole files;
+	// returns 0, or -1 if they could not be read (indices read whole are always in memory)
+	if (fps == NULL || fps->index_pages_read == NULL)
+		return(0);
+	if (first_entry < 0)
+		first_entry = 0;
+	if (last_entry >= fps->universal_header->number_of_entries)
+		last_entry = fps->universal_header->number_of_entries - 1;
+	if (first_entry > last_entry)
+		return(0);
+	entry_bytes = (fps->file_type_code == TIME_SERIES_INDICES_FILE_TYPE_CODE) ? TIME_SERIES_INDEX_BYTES : RECORD_INDEX_BYTES;
+	page_bytes = FPS_INDEX_PAGE_ENTRIES * entry_bytes;
+	first_page = first_entry / FPS_INDEX_PAGE_ENTRIES;
+	last_page = last_entry / FPS_INDEX_PAGE_ENTRIES;
+	
+	// a range per run of pages not read
+	ranges = (FPS_RANGE *) e_malloc((size_t) (((last_page - first_page) >> 1) + 1) * sizeof(FPS_RANGE), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	n_ranges = range_bytes = 0;
+	for (page = first_page; page <= last_page; ++page) {
+		if (fps->index_pages_read[page] == MEF_TRUE)
+			continue;
+		offset = UNIVERSAL_HEADER_BYTES + (page * page_bytes);
+		bytes = (offset + page_bytes > fps->raw_data_bytes) ? fps->raw_data_bytes - offset : page_bytes;
+		if (page > first_page && fps->index_pages_read[page - 1] != MEF_TRUE) {  // continues the last range
+			ranges[n_ranges - 1].bytes += bytes;
+		} else {
+			ranges[n_ranges].file_offset = offset;
+			ranges[n_ranges].bytes = bytes;
+			ranges[n_ranges++].data = (void *) (fps->raw_data + offset);
+		}
+		range_bytes += bytes;
+	}
+	if (n_ranges == 0) {
+		free((void *) ranges);
+		return(0);
+	}
+	
+	// read
+	opened_file = MEF_FALSE;
+	if (fps->fp == NULL) {
+		fps->directives.open_mode = FPS_R_OPEN_MODE;
+		if (fps_open(fps, __FUNCTION__, __LINE__, RETURN_ON_FAIL | SUPPRESS_ERROR_OUTPUT) != 0 || fps->fp == NULL) {
+			free((void *) ranges);
+			return(-1);
+		}
+		opened_file = MEF_TRUE;
+	}
+	bytes = fps_read_ranges(fps, ranges, n_ranges, __FUNCTION__, __LINE__, RETURN_ON_FAIL | SUPPRESS_ERROR_OUTPUT);
+	if (opened_file == MEF_TRUE)
+		fps_close(fps);
+	if (bytes != range_bytes) {
+		free((void *) ranges);
+		return(-1);
+	}
+	
+	// offset the times read (neither if both apply & remove are set, as offset_time_series_index_times() reports)
+	mode = MEF_context->recording_time_offset_mode;
+	apply = (mode & (RTO_APPLY | RTO_APPLY_ON_INPUT)) ? MEF_TRUE : MEF_FALSE;
+	remove = (mode & (RTO_REMOVE | RTO_REMOVE_ON_INPUT)) ? MEF_TRUE : MEF_FALSE;
+	if (mode != RTO_IGNORE && apply != remove) {
+		for (i = 0; i < n_ranges; ++i) {
+			for (j = (ranges[i].file_offset - UNIVERSAL_HEADER_BYTES) / entry_bytes, k = j + (ranges[i].bytes / entry_bytes); j < k; ++j) {
+				if (fps->file_type_code == TIME_SERIES_INDICES_FILE_TYPE_CODE)
+					time = &fps->time_series_indices[j].start_time;
+				else
+					time = &fps->record_indices[j].time;
+				if (apply == MEF_TRUE)
+					apply_recording_time_offset(time);
+				else
+					remove_recording_time_offset(time);
+			}
+		}
+	}
+	for (page = first_page; page <= last_page; ++page)
+		fps->index_pages_read[page] = MEF_TRUE;
+	free((void *) ranges);
+	
+	
+	return(0);
+}
+
+
+si8	fps_read_ranges(FILE_PROCESSING_STRUCT *fps, FPS_RANGE *ranges, si8 number_of_ranges, const si1 *function, si4 line, ui4 behavior_on_fail)
+{
+	si8	i, j, run_start, run_end, run_bytes, gap, max_gap, total;
+	ui1	*gap_data;
+	#ifndef _WIN32
+		struct iovec	iov[FPS_MAXIMUM_IO_VECTORS];
+		si4		n_iov;
+	#endif
+	
+	
+	// reads ranges of an open file into their destinations; ranges that follow each other in the file with gaps of
+	// up to FPS_MAXIMUM_COALESCED_GAP_BYTES are read with one call (one preadv() in positional I/O), the gaps into a
+	// scratch buffer; returns the bytes read into the ranges (less than their sum on failure)
+	if (behavior_on_fail == USE_GLOBAL_BEHAVIOR)
+		behavior_on_fail = MEF_context->behavior_on_fail;
+	
+	max_gap = 0;
+	for (i = 1; i < number_of_ranges; ++i) {
+		gap = ranges[i].file_offset - (ranges[i - 1].file_offset + ranges[i - 1].bytes);
+		if (gap > max_gap && gap <= FPS_MAXIMUM_COALESCED_GAP_BYTES)
+			max_gap = gap;
+	}
+	gap_data = (max_gap > 0) ? (ui1 *) e_malloc((size_t) max_gap, __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR) : NULL;
+	
+	total = 0;
+	for (i = 0; i < number_of_ranges; i = j) {
+		// extend the run over the ranges that follow closely
+		run_start = ranges[i].file_offset;
+		run_end = run_start + ranges[i].bytes;
+		run_bytes = ranges[i].bytes;
+		for (j = i + 1; j < number_of_ranges && (j - i) * 2 < FPS_MAXIMUM_IO_VECTORS; ++j) {
+			gap = ranges[j].file_offset - run_end;
+			if (gap < 0 || gap > FPS_MAXIMUM_COALESCED_GAP_BYTES)
+				break;
+			run_end = ranges[j].file_offset + ranges[j].bytes;
+			run_bytes += ranges[j].bytes;
+		}
+		
+		// read the run
+		#ifndef _WIN32
+			if (FPS_POSITIONAL_IO) {
+				for (n_iov = 0; i < j; ++i) {
+					if (n_iov && (gap = ranges[i].file_offset - (ranges[i - 1].file_offset + ranges[i - 1].bytes)) > 0) {
+						iov[n_iov].iov_base = (void *) gap_data;
+						iov[n_iov++].iov_len = (size_t) gap;
+					}
+					iov[n_iov].iov_base = ranges[i].data;
+					iov[n_iov++].iov_len = (size_t) ranges[i].bytes;
+				}
+				if (e_preadv(fps->fd, iov, n_iov, run_start, fps->full_file_name, function, line, behavior_on_fail) != run_end - run_start)
+					break;
+				total += run_bytes;
+				continue;
+			}
+		#endif
+		if (e_fseek(fps->fp, (size_t) run_start, SEEK_SET, fps->full_file_name, function, line, behavior_on_fail) != 0)
+			break;
+		for (; i < j; ++i) {
+			if (i > 0 && ranges[i].file_offset > run_start && (gap = ranges[i].file_offset - (ranges[i - 1].file_offset + ranges[i - 1].bytes)) > 0)
+				if (e_fread((void *) gap_data, sizeof(ui1), (size_t) gap, fps->fp, fps->full_file_name, function, line, behavior_on_fail) != (size_t) gap)
+					break;
+			if (e_fread(ranges[i].data, sizeof(ui1), (size_t) ranges[i].bytes, fps->fp, fps->full_file_name, function, line, behavior_on_fail) != (size_t) ranges[i].bytes)
+				break;
+			total += ranges[i].bytes;
+		}
+		if (i < j)
+			break;
+	}
+	
+	if (gap_data != NULL)
+		free((void *) gap_data);
+	
+	
+	return(total);
+}
+
+#ifndef _WIN32
+	si4	fps_unlock(FILE_PROCESSING_STRUCT *fps, const si1 *function, si4 line, ui4 behavior_on_fail)
+	{
+		struct flock	fl;
+		
+		
+		if (behavior_on_fail == USE_GLOBAL_BEHAVIOR)
+			behavior_on_fail = MEF_context->behavior_on_fail;
+		
 		fl.l_type = F_UNLCK;
 		fl.l_whence = SEEK_SET;
 		fl.l_start = 0;
@@ -3849,7 +6012,7 @@ si4	fps_write(FILE_PROCESSING_STRUCT *fps, const si1 *function, si4 line, ui4 be
 	
         
 	if (behavior_on_fail == USE_GLOBAL_BEHAVIOR)
-		behavior_on_fail = MEF_globals->behavior_on_fail;
+		behavior_on_fail = MEF_context->behavior_on_fail;
 	
 	#ifndef _WIN32
 		// lock
@@ -3887,26 +6050,33 @@ si4	fps_write(FILE_PROCESSING_STRUCT *fps, const si1 *function, si4 line, ui4 be
 
 void	free_channel(CHANNEL *channel, si4 free_channel_structure)
 {
-        si4	i;
+        si4		i;
+	MEF_ARENA	*arena;
         
         
+	// a channel read into an arena holds only arena memory: left to the arena's owner (this channel, if it was read
+	// on its own), only its files are closed
+	arena = channel->arena;
         for (i = 0; i < channel->number_of_segments; ++i)
                 free_segment(channel->segments + i, MEF_FALSE);
-        free(channel->segments);
+	if (channel->record_data_fps != NULL)
+		free_file_processing_struct(channel->record_data_fps);
+	if (channel->record_indices_fps != NULL)
+		free_file_processing_struct(channel->record_indices_fps);
+	if (arena != NULL) {
+		if (arena->owner == (void *) channel)
+			ARENA_free(arena);
+		return;
+	}
 	
+        free(channel->segments);
         free(channel->metadata.section_1);
 	if (channel->metadata.time_series_section_2 != NULL)
 		free(channel->metadata.time_series_section_2);
 	if (channel->metadata.video_section_2 != NULL)
 		free(channel->metadata.video_section_2);
 	free(channel->metadata.section_3);
-	
-	if (channel->record_data_fps != NULL)
-		free_file_processing_struct(channel->record_data_fps);
-	if (channel->record_indices_fps != NULL)
-		free_file_processing_struct(channel->record_indices_fps);
-	
-        if (free_channel_structure == MEF_TRUE)
+	if (free_channel_structure == MEF_TRUE)
 		free(channel);
         
         
@@ -3917,20 +6087,26 @@ void	free_channel(CHANNEL *channel, si4 free_channel_structure)
 void	free_file_processing_struct(FILE_PROCESSING_STRUCT *fps)
 {
         if (fps == NULL) {
-                if (!(MEF_globals->behavior_on_fail & SUPPRESS_ERROR_OUTPUT))
+                if (!(MEF_context->behavior_on_fail & SUPPRESS_ERROR_OUTPUT))
                 	fprintf(stderr, "Warning: trying to free a NULL FILE_PROCESSING_STRUCT => returning with no action\n");
                 return;
         }
         
+	// password data may be shared with structures outside the arena
 	if (fps->password_data != NULL && fps->directives.free_password_data == MEF_TRUE)
-                free(fps->password_data);
-	
-        if (fps->raw_data != NULL && fps->raw_data_bytes > 0)
-                free(fps->raw_data);
+                ARENA_release(fps->arena, fps->password_data);
         
 	if (fps->fp != NULL && fps->directives.close_file == MEF_TRUE)
 		(void) fclose(fps->fp);
-        
+	
+	// a structure in an arena holds only arena memory: left to the arena's owner
+	if (fps->arena != NULL)
+		return;
+	
+        if (fps->raw_data != NULL && fps->raw_data_bytes > 0)
+                free(fps->raw_data);
+	if (fps->index_pages_read != NULL)
+		free(fps->index_pages_read);
         free(fps);
         
         
@@ -3938,6 +6114,21 @@ void	free_file_processing_struct(FILE_PROCESSING_STRUCT *fps)
 }
 
 
+void	free_running_percentile(RUNNING_PERCENTILE *rp)
+{
+	if (rp == NULL)
+		return;
+	
+	free(rp->vals);
+	free(rp->heap);
+	free(rp->heap_pos);
+	free(rp);
+	
+	
+	return;
+}
+
+
 void	free_segment(SEGMENT *segment, si4 free_segment_structure)
 {
 	free_file_processing_struct(segment->metadata_fps);
@@ -3964,32 +6155,38 @@ void	free_segment(SEGMENT *segment, si4 free_segment_structure)
 
 void	free_session(SESSION *session, si4 free_session_structure)
 {
-        si4	i;
+        si4		i;
+	MEF_ARENA	*arena;
         
 
+	// a session read into an arena holds only arena memory: its files are closed, then the arena is freed at once
+	arena = session->arena;
+	for (i = 0; i < session->number_of_time_series_channels; ++i)
+		free_channel(session->time_series_channels + i, MEF_FALSE);
+	for (i = 0; i < session->number_of_video_channels; ++i)
+		free_channel(session->video_channels + i, MEF_FALSE);
+	if (session->record_data_fps != NULL)
+		free_file_processing_struct(session->record_data_fps);
+	if (session->record_indices_fps != NULL)
+		free_file_processing_struct(session->record_indices_fps);
+	if (arena != NULL) {
+		if (arena->owner == (void *) session)
+			ARENA_free(arena);
+		return;
+	}
+
 	if (session->number_of_time_series_channels > 0) {
 		free(session->time_series_metadata.section_1);
 		free(session->time_series_metadata.time_series_section_2);
 		free(session->time_series_metadata.section_3);
-		for (i = 0; i < session->number_of_time_series_channels; ++i)
-			free_channel(session->time_series_channels + i, MEF_FALSE);
 		free(session->time_series_channels);
 	}
-
 	if (session->number_of_video_channels > 0) {
 		free(session->video_metadata.section_1);
 		free(session->video_metadata.video_section_2);
 		free(session->video_metadata.section_3);
-		for (i = 0; i < session->number_of_video_channels; ++i)
-			free_channel(session->video_channels + i, MEF_FALSE);
 		free(session->video_channels);
 	}
-	
-	if (session->record_data_fps != NULL)
-		free_file_processing_struct(session->record_data_fps);
-	if (session->record_indices_fps != NULL)
-		free_file_processing_struct(session->record_indices_fps);
-	
         if (free_session_structure == MEF_TRUE)
 		free(session);
         
@@ -4281,10 +6478,10 @@ si8	generate_recording_time_offset(si8 recording_start_time_uutc, si4 GMT_offset
         
         recording_time_offset_uutc = recording_time_offset_utc * (si8) 1e6;
 	
-        MEF_globals->recording_time_offset = recording_time_offset_uutc;
-        MEF_globals->GMT_offset = GMT_offset;
+        MEF_context->recording_time_offset = recording_time_offset_uutc;
+        MEF_context->GMT_offset = GMT_offset;
         
-        if (MEF_globals->verbose == MEF_TRUE) {
+        if (MEF_context->verbose == MEF_TRUE) {
 		#ifdef _WIN32
 			printf("Recording Time Offset = %lld\n", recording_time_offset_uutc);
 		#else
@@ -4344,15 +6541,14 @@ ui1	*generate_UUID(ui1 *uuid)
 
 void	initialize_MEF_globals()
 {
-	if (MEF_globals == NULL)
-		MEF_globals = (MEF_GLOBALS *) e_calloc((size_t) 1, sizeof(MEF_GLOBALS), __FUNCTION__, __LINE__, EXIT_ON_FAIL);
+	// set up once: other threads may be reading in the default context, or checking the alignments, at any time
+	// after (threads that need their own settings bind a context with MEF_set_context())
+	if (MEF_globals != NULL)
+		return;
+	MEF_globals = (MEF_GLOBALS *) e_calloc((size_t) 1, sizeof(MEF_GLOBALS), __FUNCTION__, __LINE__, EXIT_ON_FAIL);
 	
-	// time constants
-	MEF_globals->recording_time_offset = MEF_GLOBALS_RECORDING_TIME_OFFSET_DEFAULT;
-	MEF_globals->recording_time_offset_mode = MEF_GLOBALS_RECORDING_TIME_OFFSET_MODE_DEFAULT;
-	MEF_globals->GMT_offset = MEF_GLOBALS_GMT_OFFSET_DEFAULT;
-        MEF_globals->DST_start_time = MEF_GLOBALS_DST_START_TIME_DEFAULT;
-        MEF_globals->DST_end_time = MEF_GLOBALS_DST_END_TIME_DEFAULT;
+	// default context
+	MEF_initialize_context(&MEF_globals->default_context, NULL);
 	// alignment fields
 	MEF_globals->universal_header_aligned = MEF_UNKNOWN;
 	MEF_globals->metadata_section_1_aligned = MEF_UNKNOWN;
@@ -4367,24 +6563,8 @@ void	initialize_MEF_globals()
 	MEF_globals->record_indices_aligned = MEF_UNKNOWN;
 	MEF_globals->all_record_structures_aligned = MEF_UNKNOWN;
 	MEF_globals->all_structures_aligned = MEF_UNKNOWN;
-	// RED
-	MEF_globals->RED_normal_CDF_table = NULL;
-	// CRC
-	MEF_globals->CRC_table = NULL;
-	MEF_globals->CRC_mode = MEF_GLOBALS_CRC_MODE_DEFAULT;
-	// AES
-	MEF_globals->AES_sbox_table = NULL;
-	MEF_globals->AES_rsbox_table = NULL;
-	MEF_globals->AES_rcon_table = NULL;
-	// SHA256
-	MEF_globals->SHA256_h0_table = NULL;
-	MEF_globals->SHA256_k_table = NULL;
-	 // UTF8
-	MEF_globals->UTF8_offsets_from_UTF8_table = NULL;
-	MEF_globals->UTF8_trailing_bytes_for_UTF8_table = NULL;
+	// RED, CRC, AES, SHA256 & UTF8 tables, FILT coefficient cache: built by initialize_meflib()
 	// miscellaneous
-	MEF_globals->verbose = MEF_GLOBALS_VERBOSE_DEFAULT;
-        MEF_globals->behavior_on_fail = MEF_GLOBALS_BEHAVIOR_ON_FAIL_DEFAULT;
         #ifndef _WIN32
 		MEF_globals->file_creation_umask = MEF_GLOBALS_FILE_CREATION_UMASK_DEFAULT;
 	#endif
@@ -4394,6 +6574,65 @@ void	initialize_MEF_globals()
 }
 
 
+MEF_CONTEXT	*MEF_get_context(void)
+{
+	if (MEF_thread_context != NULL)
+		return(MEF_thread_context);
+	
+	
+	return(&MEF_globals->default_context);
+}
+
+
+void	MEF_initialize_context(MEF_CONTEXT *context, MEF_CONTEXT *settings)
+{
+	// time constants always start at their defaults (set when metadata are read); the CRC, time offset & error
+	// settings, the profile, the allocation, I/O & index modes are copied from settings if passed (no read is in progress)
+	context->recording_time_offset = MEF_GLOBALS_RECORDING_TIME_OFFSET_DEFAULT;
+	context->GMT_offset = MEF_GLOBALS_GMT_OFFSET_DEFAULT;
+        context->DST_start_time = MEF_GLOBALS_DST_START_TIME_DEFAULT;
+        context->DST_end_time = MEF_GLOBALS_DST_END_TIME_DEFAULT;
+	if (settings == NULL) {
+		context->recording_time_offset_mode = MEF_GLOBALS_RECORDING_TIME_OFFSET_MODE_DEFAULT;
+		context->CRC_mode = MEF_GLOBALS_CRC_MODE_DEFAULT;
+		context->verbose = MEF_GLOBALS_VERBOSE_DEFAULT;
+		context->behavior_on_fail = MEF_GLOBALS_BEHAVIOR_ON_FAIL_DEFAULT;
+		context->profile = NULL;
+		context->allocation_mode = MEF_GLOBALS_ALLOCATION_MODE_DEFAULT;
+		context->IO_mode = MEF_GLOBALS_IO_MODE_DEFAULT;
+		context->index_mode = MEF_GLOBALS_INDEX_MODE_DEFAULT;
+	} else {
+		context->recording_time_offset_mode = settings->recording_time_offset_mode;
+		context->CRC_mode = settings->CRC_mode;
+		context->verbose = settings->verbose;
+		context->behavior_on_fail = settings->behavior_on_fail;
+		context->profile = settings->profile;
+		context->allocation_mode = settings->allocation_mode;
+		context->IO_mode = settings->IO_mode;
+		context->index_mode = settings->index_mode;
+	}
+	context->arena = NULL;
+	
+	
+	return;
+}
+
+
+MEF_CONTEXT	*MEF_set_context(MEF_CONTEXT *context)
+{
+	MEF_CONTEXT	*previous_context;
+	
+	
+	// binds context to the calling thread (NULL: back to the default context); returns the previous binding, to
+	// be restored with another call
+	previous_context = MEF_thread_context;
+	MEF_thread_context = context;
+	
+	
+	return(previous_context);
+}
+
+
 /*************************************************************************/
 /****************************  END MEF GLOBALS  **************************/
 /*************************************************************************/
@@ -4439,24 +6678,36 @@ si4	initialize_meflib()
 	// set file creation umask
 	umask(MEF_globals->file_creation_umask);
 	
-	// make RED table global
-	(void) RED_initialize_normal_CDF_table(MEF_TRUE);
+	// make RED table global (the tables are built on the first call only)
+	if (MEF_globals->RED_normal_CDF_table == NULL)
+		(void) RED_initialize_normal_CDF_table(MEF_TRUE);
 	
 	// make CRC table global
-	(void) CRC_initialize_table(MEF_TRUE);
+	if (MEF_globals->CRC_table == NULL)
+		(void) CRC_initialize_table(MEF_TRUE);
 	
 	// make UTF-8 tables global
-	(void) UTF8_initialize_offsets_from_UTF8_table(MEF_TRUE);
-	(void) UTF8_initialize_trailing_bytes_for_UTF8_table(MEF_TRUE);
+	if (MEF_globals->UTF8_offsets_from_UTF8_table == NULL)
+		(void) UTF8_initialize_offsets_from_UTF8_table(MEF_TRUE);
+	if (MEF_globals->UTF8_trailing_bytes_for_UTF8_table == NULL)
+		(void) UTF8_initialize_trailing_bytes_for_UTF8_table(MEF_TRUE);
 	
 	// make AES-128 tables global
-	(void) AES_initialize_sbox_table(MEF_TRUE);
-	(void) AES_initialize_rsbox_table(MEF_TRUE);
-	(void) AES_initialize_rcon_table(MEF_TRUE);
+	if (MEF_globals->AES_sbox_table == NULL)
+		(void) AES_initialize_sbox_table(MEF_TRUE);
+	if (MEF_globals->AES_rsbox_table == NULL)
+		(void) AES_initialize_rsbox_table(MEF_TRUE);
+	if (MEF_globals->AES_rcon_table == NULL)
+		(void) AES_initialize_rcon_table(MEF_TRUE);
 	
 	// make SHA-256 tables global
-	(void) SHA256_initialize_h0_table(MEF_TRUE);
-	(void) SHA256_initialize_k_table(MEF_TRUE);
+	if (MEF_globals->SHA256_h0_table == NULL)
+		(void) SHA256_initialize_h0_table(MEF_TRUE);
+	if (MEF_globals->SHA256_k_table == NULL)
+		(void) SHA256_initialize_k_table(MEF_TRUE);
+	
+	// make filter coefficient cache global
+	(void) FILT_initialize_coefficient_cache(MEF_TRUE);
 	
 	
 	return(return_value);
@@ -4507,24 +6758,24 @@ si4	initialize_metadata(FILE_PROCESSING_STRUCT *fps)
 			vmd2->video_file_CRC = VIDEO_METADATA_VIDEO_FILE_CRC_NO_ENTRY;
 			break;
 		default:
-			if (!(MEF_globals->behavior_on_fail & SUPPRESS_ERROR_OUTPUT)) {
+			if (!(MEF_context->behavior_on_fail & SUPPRESS_ERROR_OUTPUT)) {
 				fprintf(stderr, "Unrecognized METADATA SECTION 2 type \"%s\" [function \"%s\", line %d]\n", fps->full_file_name, __FUNCTION__, __LINE__);
-				if (MEF_globals->behavior_on_fail & RETURN_ON_FAIL)
+				if (MEF_context->behavior_on_fail & RETURN_ON_FAIL)
 					(void) fprintf(stderr, "\t=> returning without initializing section 2\n\n");
-				else if (MEF_globals->behavior_on_fail & EXIT_ON_FAIL)
+				else if (MEF_context->behavior_on_fail & EXIT_ON_FAIL)
 					(void) fprintf(stderr, "\t=> exiting program\n\n");
 			}
-			if (MEF_globals->behavior_on_fail & EXIT_ON_FAIL)
+			if (MEF_context->behavior_on_fail & EXIT_ON_FAIL)
 				exit(1);
 			break;
 	}
         
 	// section 3 fields
 	md3 = fps->metadata.section_3;
-	md3->recording_time_offset = MEF_globals->recording_time_offset;
-	md3->DST_start_time = MEF_globals->DST_start_time;
-	md3->DST_end_time = MEF_globals->DST_end_time;
-        md3->GMT_offset = MEF_globals->GMT_offset;
+	md3->recording_time_offset = MEF_context->recording_time_offset;
+	md3->DST_start_time = MEF_context->DST_start_time;
+	md3->DST_end_time = MEF_context->DST_end_time;
+        md3->GMT_offset = MEF_context->GMT_offset;
 	
         
 	return(0);
@@ -4574,7 +6825,7 @@ si1	*local_date_time_string(si8 uutc_time, si1 *time_str)  // time_str buffer so
 		time_str = (si1 *) e_calloc((size_t) 32, sizeof(si1), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
 	
 	remove_recording_time_offset(&uutc_time);
-        uutc_time += (si8) (MEF_globals->GMT_offset * 1e6);
+        uutc_time += (si8) (MEF_context->GMT_offset * 1e6);
         
         utc_time = (si8) uutc_time / 1000000;
         microseconds = (si4) (uutc_time % 1000000);
@@ -4765,7 +7016,7 @@ si4	offset_record_index_times(FILE_PROCESSING_STRUCT *fps, si4 action)
 	RECORD_INDEX		*ri;
 	
 	
-	mode = MEF_globals->recording_time_offset_mode;
+	mode = MEF_context->recording_time_offset_mode;
 	
 	if (mode == RTO_IGNORE)
 		return(0);
@@ -4819,7 +7070,7 @@ si4	offset_time_series_index_times(FILE_PROCESSING_STRUCT *fps, si4 action)
 	TIME_SERIES_INDEX	*ti;
 	
 	
-	mode = MEF_globals->recording_time_offset_mode;
+	mode = MEF_context->recording_time_offset_mode;
 	
 	if (mode == RTO_IGNORE)
 		return(0);
@@ -4872,7 +7123,7 @@ si4	offset_universal_header_times(FILE_PROCESSING_STRUCT *fps, si4 action)
 	UNIVERSAL_HEADER	*uh;
 	
 	
-	mode = MEF_globals->recording_time_offset_mode;
+	mode = MEF_context->recording_time_offset_mode;
 	
 	if (mode == RTO_IGNORE)
 		return(0);
@@ -4926,7 +7177,7 @@ si4	offset_video_index_times(FILE_PROCESSING_STRUCT *fps, si4 action)
 	VIDEO_INDEX	*vi;
 	
 	
-	mode = MEF_globals->recording_time_offset_mode;
+	mode = MEF_context->recording_time_offset_mode;
 	
 	if (mode == RTO_IGNORE)
 		return(0);
@@ -4985,8 +7236,8 @@ PASSWORD_DATA	*process_password_data(si1 *unspecified_password, si1 *level_1_pas
 	si4			i;
 	
         
-        // allocate
-        pwd = (PASSWORD_DATA *) e_calloc((size_t) 1, sizeof(PASSWORD_DATA), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+        // allocate (from the arena of a session or channel being read)
+        pwd = (PASSWORD_DATA *) ARENA_calloc(MEF_context->arena, (size_t) 1, sizeof(PASSWORD_DATA), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
         pwd->access_level = LEVEL_0_ACCESS; // default access level
         
         // user passed single password for reading: validate against validation fields and generate encryption keys
@@ -5002,10 +7253,10 @@ PASSWORD_DATA	*process_password_data(si1 *unspecified_password, si1 *level_1_pas
 			for (i = 0; i < PASSWORD_VALIDATION_FIELD_BYTES; ++i)  // compare with stored level 1 hash
 				if (sha[i] != universal_header->level_1_password_validation_field[i])
 					break;
-			if (i == PASSWORD_BYTES) {  // Level 1 password valid - cannot be level 2 password
+			if (i == PASSWORD_VALIDATION_FIELD_BYTES) {  // Level 1 password valid - cannot be level 2 password
 				pwd->access_level = LEVEL_1_ACCESS;
-				AES_key_expansion(pwd->level_2_encryption_key, password_bytes);  // generate key
-				if (MEF_globals->verbose == MEF_TRUE)
+				AES_key_expansion(pwd->level_1_encryption_key, password_bytes);  // generate key
+				if (MEF_context->verbose == MEF_TRUE)
 					printf("Unspecified password is valid for Level 1 access\n");
 				return(pwd);
 			}
@@ -5023,14 +7274,14 @@ PASSWORD_DATA	*process_password_data(si1 *unspecified_password, si1 *level_1_pas
 				pwd->access_level = LEVEL_2_ACCESS;
 				AES_key_expansion(pwd->level_1_encryption_key, putative_level_1_password_bytes);  // generate key
 				AES_key_expansion(pwd->level_2_encryption_key, password_bytes);  // generate key
-				if (MEF_globals->verbose == MEF_TRUE)
+				if (MEF_context->verbose == MEF_TRUE)
 					printf("Unspecified password is valid for Level 1 and Level 2 access\n");
 			} else {
 				fprintf(stderr, "%s(), line %d: unspecified password is not valid for Level 1 or Level 2 access\n", __FUNCTION__, __LINE__);
 			}
 		} else {
 			fprintf(stderr, "%s(), line %d: unspecified password is not of valid form\n", __FUNCTION__, __LINE__);
-			if (MEF_globals->behavior_on_fail & EXIT_ON_FAIL) {
+			if (MEF_context->behavior_on_fail & EXIT_ON_FAIL) {
 				(void) fprintf(stderr, "\t=> exiting program\n\n");
 				exit(1);
 			}
@@ -5051,12 +7302,12 @@ PASSWORD_DATA	*process_password_data(si1 *unspecified_password, si1 *level_1_pas
 	                // generate Level 1 password validation field
 	                sha256((ui1 *) password_bytes, PASSWORD_BYTES, sha);
 	                memcpy(universal_header->level_1_password_validation_field, sha, PASSWORD_VALIDATION_FIELD_BYTES);
-	                if (MEF_globals->verbose == MEF_TRUE)
+	                if (MEF_context->verbose == MEF_TRUE)
 	                        printf("Level 1 password validation field generated\n");
 	                
 	                // generate encryption key
 	                AES_key_expansion(pwd->level_1_encryption_key, password_bytes);
-			if (MEF_globals->verbose == MEF_TRUE)
+			if (MEF_context->verbose == MEF_TRUE)
                 printf("Level 1 encryption key generated\n");
                 
                 // user also passed level 2 password for writing: generate validation field and encryption key
@@ -5075,18 +7326,18 @@ PASSWORD_DATA	*process_password_data(si1 *unspecified_password, si1 *level_1_pas
 	                        memcpy(universal_header->level_2_password_validation_field, sha, PASSWORD_VALIDATION_FIELD_BYTES);
 	                        for (i = 0; i < PASSWORD_VALIDATION_FIELD_BYTES; ++i) // exclusive or with level 1 password bytes
 	                                universal_header->level_2_password_validation_field[i] ^= password_bytes[i];
-	                        if (MEF_globals->verbose == MEF_TRUE)
+	                        if (MEF_context->verbose == MEF_TRUE)
 	                                printf("Level 2 password validation field generated\n");
 	                        
 	                        // generate encryption key
 	                        AES_key_expansion(pwd->level_2_encryption_key, l2_password_bytes);
-	                        if (MEF_globals->verbose == MEF_TRUE)
+	                        if (MEF_context->verbose == MEF_TRUE)
 	                                printf("Level 2 encryption key generated\n");
 				
 	                        
 	                } else {
 						fprintf(stderr, "%s(), line %d: Level 2 password is not of valid form\n", __FUNCTION__, __LINE__);
-						if (MEF_globals->behavior_on_fail & EXIT_ON_FAIL) {
+						if (MEF_context->behavior_on_fail & EXIT_ON_FAIL) {
 							(void) fprintf(stderr, "\t=> exiting program\n\n");
 							exit(1);
 						}
@@ -5094,7 +7345,7 @@ PASSWORD_DATA	*process_password_data(si1 *unspecified_password, si1 *level_1_pas
 				}
 		} else {
 			fprintf(stderr, "%s(), line %d: Level 1 password is not of valid form\n", __FUNCTION__, __LINE__);
-			if (MEF_globals->behavior_on_fail & EXIT_ON_FAIL) {
+			if (MEF_context->behavior_on_fail & EXIT_ON_FAIL) {
 				(void) fprintf(stderr, "\t=> exiting program\n\n");
 				exit(1);
 			}
@@ -5107,153 +7358,49 @@ PASSWORD_DATA	*process_password_data(si1 *unspecified_password, si1 *level_1_pas
 
 void    proportion_filt(sf8 *x, sf8 *px, si8 len, sf8 prop, si4 span)
 {
-	NODE    *nodes, *prop_node, *first_node, *last_node, *empty_node;
-	NODE	*curr_node, *next_node, *prev_node, *head, *tail;
-	si4     first_idx, last_idx, empty_idx, half_span, prop_span, prop_idx, span_plus_one;
-	si8     i, j;
-	sf8     prop_val, new_val, first_val, prop_shift, temp_shift;
+	RUNNING_PERCENTILE	*rp;
+	si4			half_span;
+	si8			i, j;
+	sf8			prop_val, new_val;
 	
 	
 	/* setup */
+	if (len < 1)
+		return;
+	if (span > len)
+		span = (si4) len;
 	if ((span % 2) == 0) // require odd-numbered window
-		++span;
+		span += (span < len) ? 1 : -1;
 	if (px == NULL) // caller responsible for freeing px
 		px = (sf8 *) calloc((size_t) len, sizeof(sf8));
-	nodes = (NODE *) calloc((size_t) (span + 3), sizeof(NODE));
-	first_idx = 0;
-	first_node = nodes + first_idx;
-	last_idx = span - 1;
-	last_node = nodes + last_idx;
-	empty_idx = span;
-	empty_node = nodes + empty_idx;
-	head = nodes + (span + 1);
-	tail = nodes + (span + 2);
 	half_span = span / 2;
-	prop_span = (si4) (((sf8) (span - 1) * prop) + 0.5);
-	span_plus_one = span + 1;
 	
-	/* build linked list */
-	head->val = -DBL_MAX;
-	tail->val = DBL_MAX;
-	for (i = 0; i < span; ++i) {
-		nodes[i].val = x[i];
-		nodes[i].idx = i;
-	}
-	qsort(nodes, span, sizeof(NODE), sort_by_val);
-	for (i = 1; i < span; ++i)
-		nodes[i - 1].next = nodes + nodes[i].idx;
-	nodes[span - 1].next = tail;
-	head->next = nodes + nodes[0].idx;
-	for (i = 1; i < span; ++i)
-		nodes[i].prev = nodes + nodes[i - 1].idx;
-	nodes[0].prev = head;
-	tail->prev = nodes + nodes[span - 1].idx;
-	prop_idx = nodes[prop_span].idx;
-	qsort(nodes, span, sizeof(NODE), sort_by_idx);
-	prop_node = nodes + prop_idx;
+	/* order statistics of the first window: two heaps split at the proportion rank, O(log span) per update */
+	rp = allocate_running_percentile(x, span, prop);
 	
 	/* fill in initial segment */
-	prop_val = prop_node->val;
+	prop_val = rp->vals[rp->heap[0]];
 	for (i = 0; i <= half_span; ++i)
 		px[i] = prop_val;
 	
 	/* slide window */
 	for (i = span, j = half_span + 1; i < len; ++i, ++j) {
 		
-		/* insert new value into list using empty node: Note routine doesn't handle NaNs */
-		
-		if (isnan(empty_node->val = new_val = x[i])) {
-			if (!(MEF_globals->behavior_on_fail & SUPPRESS_ERROR_OUTPUT)) {
+		/* Note routine doesn't handle NaNs */
+		if (isnan(new_val = x[i])) {
+			if (!(MEF_context->behavior_on_fail & SUPPRESS_ERROR_OUTPUT)) {
 				fprintf(stderr, "Proportion_filt() does not currently handle NaN values [function \"%s\", line %d]\n", __FUNCTION__, __LINE__);
-				if (MEF_globals->behavior_on_fail & RETURN_ON_FAIL)
+				if (MEF_context->behavior_on_fail & RETURN_ON_FAIL)
 					(void) fprintf(stderr, "\t=> returning without filtering\n\n");
-				else if (MEF_globals->behavior_on_fail & EXIT_ON_FAIL)
+				else if (MEF_context->behavior_on_fail & EXIT_ON_FAIL)
 					(void) fprintf(stderr, "\t=> exiting program\n\n");
 			}
-			if (MEF_globals->behavior_on_fail & EXIT_ON_FAIL)
+			if (MEF_context->behavior_on_fail & EXIT_ON_FAIL)
 				exit(1);
+			free_running_percentile(rp);
 			return;
 		}
-		if (new_val > prop_val)
-			prop_shift = 0.5;
-		else if (new_val < prop_val)
-			prop_shift = -0.5;
-		else
-			prop_shift = 0.0;
-		curr_node = last_node;
-		if (new_val > last_node->val) {  // search forward
-			while (1) {
-				next_node = curr_node->next;
-				if (new_val <= next_node->val)
-					break;
-				curr_node = next_node;
-			}
-			if (prop_shift == 0.0) {
-				prop_shift = val_equals_prop(curr_node, prop_node);
-				if (prop_shift == 0.0)
-					prop_shift = 0.5;
-			}
-			// insert after curr_node
-			empty_node->prev = curr_node;
-			empty_node->next = next_node;
-			next_node->prev = curr_node->next = empty_node;
-		} else {  // search backward
-			while (1) {
-				prev_node = curr_node->prev;
-				if (new_val >= prev_node->val)
-					break;
-				curr_node = prev_node;
-			}
-			if (prop_shift == 0.0) {
-				prop_shift = val_equals_prop(curr_node, prop_node);
-				if (prop_shift == 0.0)
-					prop_shift = -0.5;
-			}
-			// insert before curr_node
-			empty_node->next = curr_node;
-			empty_node->prev = prev_node;
-			prev_node->next = curr_node->prev = empty_node;
-		}
-		
-		/* update proportion value */
-		first_val = first_node->val;
-		if (first_val > prop_val)
-			prop_shift -= 0.5;
-		else if (first_val < prop_val)
-			prop_shift += 0.5;
-		else {
-			temp_shift = val_equals_prop(first_node, prop_node);
-			if (temp_shift == 0.0) {
-				if (prop_shift > 0.0)
-					prop_shift = 1.0;
-				else
-					prop_shift = -1.0;
-			} else {
-				prop_shift -= temp_shift;
-			}
-		}
-		if (prop_shift == 1.0) {
-			prop_node = prop_node->next;
-			prop_val = prop_node->val;
-		} else if (prop_shift == -1.0) {
-			prop_node = prop_node->prev;
-			prop_val = prop_node->val;
-		}
-		px[j] = prop_val;
-		
-		/* excise first (oldest) node */
-		prev_node = first_node->prev;
-		next_node = first_node->next;
-		prev_node->next = next_node;
-		next_node->prev = prev_node;
-		
-		/* update window */
-		++first_idx; first_idx %= span_plus_one;
-		first_node = nodes + first_idx;
-		++last_idx; last_idx %= span_plus_one;
-		last_node = nodes + last_idx;
-		++empty_idx; empty_idx %= span_plus_one;
-		empty_node = nodes + empty_idx;
+		px[j] = prop_val = update_running_percentile(rp, new_val);
 	}
 	
 	/* fill in terminal segment */
@@ -5261,12 +7408,46 @@ void    proportion_filt(sf8 *x, sf8 *px, si8 len, sf8 prop, si4 span)
 		px[j] = prop_val;
 	
 	/* clean up */
-	free(nodes);
+	free_running_percentile(rp);
 	
 	return;
 }
 
 
+sf8	quickselect_sf8(sf8 *x, si8 len, si8 k)
+{
+	si8	i, j, left, right;
+	sf8	pivot, temp;
+	
+	
+	// returns the k-th smallest value (0-based) in expected O(len), partially reordering x in place (Wirth's selection)
+	left = 0;
+	right = len - 1;
+	while (left < right) {
+		pivot = x[k];
+		i = left;
+		j = right;
+		do {
+			while (x[i] < pivot)
+				++i;
+			while (pivot < x[j])
+				--j;
+			if (i <= j) {
+				temp = x[i]; x[i] = x[j]; x[j] = temp;
+				++i; --j;
+			}
+		} while (i <= j);
+		if (j < k)
+			left = i;
+		if (k < i)
+			right = j;
+	}
+	
+	
+	return(x[k]);
+}
+
+
 inline ui1	random_byte(ui4 *m_w, ui4 *m_z)
 {
 	ui1	rb;
@@ -5291,11 +7472,25 @@ CHANNEL	*read_MEF_channel(CHANNEL *channel, si1 *chan_path, si4 channel_type, si
 	METADATA_SECTION_3		*smd3, *cmd3;
         SEGMENT				*seg;
 	FILE_PROCESSING_STRUCT		*temp_fps;
+	PROFILE_TIMER			timer;
+	si4				created_arena;
 	
 	
+	PROFILE_START(timer);
+	
+	// read into an arena in arena mode (this channel's own, unless it is read as part of a session)
+	created_arena = MEF_FALSE;
+	if (MEF_context->allocation_mode == MEF_ALLOCATE_IN_ARENA && MEF_context->arena == NULL) {
+		MEF_context->arena = ARENA_allocate(ARENA_SLAB_BYTES_DEFAULT);
+		created_arena = MEF_TRUE;
+	}
+	
 	// allocate channel if not passed
 	if (channel == NULL)
-		channel = (CHANNEL *) e_calloc((size_t) 1, sizeof(CHANNEL), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+		channel = (CHANNEL *) ARENA_calloc(MEF_context->arena, (size_t) 1, sizeof(CHANNEL), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	channel->arena = MEF_context->arena;
+	if (created_arena == MEF_TRUE && channel->arena != NULL)
+		channel->arena->owner = (void *) channel;
         
 	// get channel path & name
 	extract_path_parts(chan_path, channel->path, channel->name, channel->extension);
@@ -5323,7 +7518,7 @@ CHANNEL	*read_MEF_channel(CHANNEL *channel, si1 *chan_path, si4 channel_type, si
 	
 	// loop over segments
 	segment_names = generate_file_list(NULL, &n_segments, chan_path, SEGMENT_DIRECTORY_TYPE_STRING);
-	channel->segments = (SEGMENT *) e_calloc((size_t) n_segments, sizeof(SEGMENT), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	channel->segments = (SEGMENT *) ARENA_calloc(channel->arena, (size_t) n_segments, sizeof(SEGMENT), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
         channel->number_of_segments = n_segments;
 	for (i = 0; i < n_segments; ++i) {
 		(void) read_MEF_segment(channel->segments + i, segment_names[i], channel_type, password, password_data, read_time_series_data, read_record_data);
@@ -5335,15 +7530,15 @@ CHANNEL	*read_MEF_channel(CHANNEL *channel, si1 *chan_path, si4 channel_type, si
         
         // fill in channel metadata
         if (channel->metadata.section_1 == NULL)
-                channel->metadata.section_1 = (METADATA_SECTION_1 *) e_calloc((size_t) 1, sizeof(METADATA_SECTION_1), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+                channel->metadata.section_1 = (METADATA_SECTION_1 *) ARENA_calloc(channel->arena, (size_t) 1, sizeof(METADATA_SECTION_1), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
         if (channel->metadata.section_3 == NULL)
-                channel->metadata.section_3 = (METADATA_SECTION_3 *) e_calloc((size_t) 1, sizeof(METADATA_SECTION_3), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+                channel->metadata.section_3 = (METADATA_SECTION_3 *) ARENA_calloc(channel->arena, (size_t) 1, sizeof(METADATA_SECTION_3), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
 	if (channel->channel_type == TIME_SERIES_CHANNEL_TYPE) {
 		if (channel->metadata.time_series_section_2 == NULL)
-			channel->metadata.time_series_section_2 = (TIME_SERIES_METADATA_SECTION_2 *) e_calloc((size_t) 1, sizeof(TIME_SERIES_METADATA_SECTION_2), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+			channel->metadata.time_series_section_2 = (TIME_SERIES_METADATA_SECTION_2 *) ARENA_calloc(channel->arena, (size_t) 1, sizeof(TIME_SERIES_METADATA_SECTION_2), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
 	} else if (channel->channel_type == VIDEO_CHANNEL_TYPE) {
 		if (channel->metadata.video_section_2 == NULL)
-			channel->metadata.video_section_2 = (VIDEO_METADATA_SECTION_2 *) e_calloc((size_t) 1, sizeof(VIDEO_METADATA_SECTION_2), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+			channel->metadata.video_section_2 = (VIDEO_METADATA_SECTION_2 *) ARENA_calloc(channel->arena, (size_t) 1, sizeof(VIDEO_METADATA_SECTION_2), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
 	}
 
         // times series channel
@@ -5586,7 +7781,7 @@ CHANNEL	*read_MEF_channel(CHANNEL *channel, si1 *chan_path, si4 channel_type, si
 	
         // read channel record indices if present
 		MEF_snprintf(full_file_name, MEF_FULL_FILE_NAME_BYTES, "%s/%s.%s/%s.%s", channel->path, channel->name, channel->extension, channel->name, RECORD_INDICES_FILE_TYPE_STRING);
-		channel->record_indices_fps = read_MEF_file(NULL, full_file_name, password, password_data, NULL, RETURN_ON_FAIL | SUPPRESS_ERROR_OUTPUT);
+		channel->record_indices_fps = read_MEF_indices(full_file_name, password, password_data, RETURN_ON_FAIL | SUPPRESS_ERROR_OUTPUT);
 	    if (channel->record_indices_fps != NULL) {
 			if (password_data == NULL)
 				password_data = channel->record_indices_fps->password_data;
@@ -5613,7 +7808,12 @@ CHANNEL	*read_MEF_channel(CHANNEL *channel, si1 *chan_path, si4 channel_type, si
 			MEF_strncpy(channel->anonymized_name, channel->record_data_fps->universal_header->anonymized_name, UNIVERSAL_HEADER_ANONYMIZED_NAME_BYTES);
 		}
 
-	if (MEF_globals->verbose == MEF_TRUE) {
+	// later allocations are from the heap
+	if (created_arena == MEF_TRUE)
+		MEF_context->arena = NULL;
+	PROFILE_STOP(timer, PROFILE_PHASE_OPEN);
+
+	if (MEF_context->verbose == MEF_TRUE) {
 		if (channel_type == TIME_SERIES_CHANNEL_TYPE) {
 			printf("------------ Time Series Channel Metadata --------------\n");
 			temp_fps = allocate_file_processing_struct(0, TIME_SERIES_METADATA_FILE_TYPE_CODE, NULL, NULL, 0);
@@ -5671,7 +7871,7 @@ FILE_PROCESSING_STRUCT	*read_MEF_file(FILE_PROCESSING_STRUCT *fps, si1 *file_nam
 	#endif
         
 	if (behavior_on_fail == USE_GLOBAL_BEHAVIOR)
-		behavior_on_fail = MEF_globals->behavior_on_fail;
+		behavior_on_fail = MEF_context->behavior_on_fail;
 	
 	// allocate FILE_PROCESSING_STRUCT if required
 	if (fps == NULL) {
@@ -5694,8 +7894,9 @@ FILE_PROCESSING_STRUCT	*read_MEF_file(FILE_PROCESSING_STRUCT *fps, si1 *file_nam
 				free_file_processing_struct(fps);
 			return(NULL);
 		}
-	} else
+	} else if (!FPS_POSITIONAL_IO) {  // positional reads do not use the file position
 		e_fseek(fps->fp, 0, SEEK_SET, fps->full_file_name, __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	}
 	
 	// check file not empty
 	if (fps->file_length == 0) {
@@ -5715,7 +7916,7 @@ FILE_PROCESSING_STRUCT	*read_MEF_file(FILE_PROCESSING_STRUCT *fps, si1 *file_nam
         
 	// allocate raw data
 	if (fps->raw_data == NULL) {
-		fps->raw_data = (ui1 *) e_calloc((size_t) i_bytes, sizeof(ui1), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+		fps->raw_data = (ui1 *) ARENA_calloc(fps->arena, (size_t) i_bytes, sizeof(ui1), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
 		fps->raw_data_bytes = i_bytes;
 	}
         
@@ -5758,12 +7959,12 @@ FILE_PROCESSING_STRUCT	*read_MEF_file(FILE_PROCESSING_STRUCT *fps, si1 *file_nam
 	}
         
     // CRCs
-    if (MEF_globals->CRC_mode & (CRC_VALIDATE | CRC_VALIDATE_ON_INPUT)) {
+    if (MEF_context->CRC_mode & (CRC_VALIDATE | CRC_VALIDATE_ON_INPUT)) {
         if (fps->directives.io_bytes == FPS_FULL_FILE) {
-            CRC_result = CRC_validate(fps->raw_data + UNIVERSAL_HEADER_BYTES, fps->raw_data_bytes - UNIVERSAL_HEADER_BYTES, fps->universal_header->body_CRC);
+            CRC_result = CRC_validate_parallel(fps->raw_data + UNIVERSAL_HEADER_BYTES, fps->raw_data_bytes - UNIVERSAL_HEADER_BYTES, fps->universal_header->body_CRC, THREAD_NUMBER_OF_THREADS_DEFAULT);
             if (CRC_result == MEF_TRUE)
             {
-                if (MEF_globals->verbose == MEF_TRUE)
+                if (MEF_context->verbose == MEF_TRUE)
                     UTF8_printf("Body CRC is valid in file \"%s\".\n", fps->full_file_name);
             }
             else
@@ -5771,7 +7972,7 @@ FILE_PROCESSING_STRUCT	*read_MEF_file(FILE_PROCESSING_STRUCT *fps, si1 *file_nam
             CRC_result = CRC_validate(fps->raw_data + CRC_BYTES, UNIVERSAL_HEADER_BYTES - CRC_BYTES, fps->universal_header->header_CRC);
             if (CRC_result == MEF_TRUE)
             {
-                if (MEF_globals->verbose == MEF_TRUE)
+                if (MEF_context->verbose == MEF_TRUE)
                     UTF8_printf("Header CRC is valid in file \"%s\".\n", fps->full_file_name);
             }
             else
@@ -5781,7 +7982,7 @@ FILE_PROCESSING_STRUCT	*read_MEF_file(FILE_PROCESSING_STRUCT *fps, si1 *file_nam
 	
 	// if just reading UNIVERSAL HEADER (e.g. large files like records or segment data files)
         if (fps->directives.io_bytes == UNIVERSAL_HEADER_BYTES) {
-        	if (MEF_globals->verbose == MEF_TRUE)
+        	if (MEF_context->verbose == MEF_TRUE)
 			show_file_processing_struct(fps);
 		offset_universal_header_times(fps, RTO_INPUT_ACTION);
 		return(fps);
@@ -5816,10 +8017,11 @@ FILE_PROCESSING_STRUCT	*read_MEF_file(FILE_PROCESSING_STRUCT *fps, si1 *file_nam
 			break;
 		case RECORD_INDICES_FILE_TYPE_CODE:
 			fps->record_indices = (RECORD_INDEX *) data_ptr;
+			fps->record_indices_order = RECORD_INDICES_ORDER_UNKNOWN;
 			break;
 		default:
 			UTF8_fprintf(stderr, "Error: unrecognized type code in file \"%s\" [function \"%s\", line %d]\n", fps->full_file_name, __FUNCTION__, __LINE__);
-                        if (MEF_globals->behavior_on_fail & EXIT_ON_FAIL) {
+                        if (MEF_context->behavior_on_fail & EXIT_ON_FAIL) {
                                 (void) fprintf(stderr, "\t=> exiting program\n\n");
                                 exit(1);
                         }
@@ -5858,7 +8060,7 @@ FILE_PROCESSING_STRUCT	*read_MEF_file(FILE_PROCESSING_STRUCT *fps, si1 *file_nam
 	}
 	
 	// show
-	if (MEF_globals->verbose == MEF_TRUE)
+	if (MEF_context->verbose == MEF_TRUE)
 		show_file_processing_struct(fps);
         
         
@@ -5866,10 +8068,70 @@ FILE_PROCESSING_STRUCT	*read_MEF_file(FILE_PROCESSING_STRUCT *fps, si1 *file_nam
 }
 
 
+FILE_PROCESSING_STRUCT	*read_MEF_indices(si1 *file_name, si1 *password, PASSWORD_DATA *password_data, ui4 behavior_on_fail)
+{
+	FILE_PROCESSING_STRUCT	*fps;
+	ui1			*raw_data;
+	si8			entry_bytes, number_of_entries, maximum_entries;
+	
+	
+	// reads a time series or record indices file whole, or in MEF_INDICES_ON_DEMAND mode its universal header, with room
+	// for the entries (zeroed), which fps_read_index_entries() & fps_find_index_entry() read when they are needed
+	if (MEF_context->index_mode != MEF_INDICES_ON_DEMAND)
+		return(read_MEF_file(NULL, file_name, password, password_data, NULL, behavior_on_fail));
+	
+	fps = allocate_file_processing_struct(0, NO_TYPE_CODE, NULL, NULL, 0);
+	fps->directives.io_bytes = UNIVERSAL_HEADER_BYTES;
+	if (read_MEF_file(fps, file_name, password, password_data, NULL, behavior_on_fail) == NULL) {
+		free_file_processing_struct(fps);
+		return(NULL);
+	}
+	if (fps->universal_header == NULL)  // too short (returned as by read_MEF_file())
+		return(fps);
+	switch (fps->file_type_code) {
+		case TIME_SERIES_INDICES_FILE_TYPE_CODE:
+			entry_bytes = TIME_SERIES_INDEX_BYTES;
+			break;
+		case RECORD_INDICES_FILE_TYPE_CODE:
+			entry_bytes = RECORD_INDEX_BYTES;
+			break;
+		default:  // not an indices file
+			free_file_processing_struct(fps);
+			return(read_MEF_file(NULL, file_name, password, password_data, NULL, behavior_on_fail));
+	}
+	
+	// the entries the file holds (the header count is limited to them, as the entries beyond are never read)
+	maximum_entries = (fps->file_length - UNIVERSAL_HEADER_BYTES) / entry_bytes;
+	number_of_entries = fps->universal_header->number_of_entries;
+	if (number_of_entries == UNKNOWN_NUMBER_OF_ENTRIES || number_of_entries < 0 || number_of_entries > maximum_entries)
+		number_of_entries = fps->universal_header->number_of_entries = maximum_entries;
+	
+	raw_data = (ui1 *) ARENA_calloc(fps->arena, (size_t) (UNIVERSAL_HEADER_BYTES + (number_of_entries * entry_bytes)), sizeof(ui1), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	memcpy((void *) raw_data, (void *) fps->raw_data, (size_t) UNIVERSAL_HEADER_BYTES);
+	ARENA_release(fps->arena, fps->raw_data);
+	fps->raw_data = raw_data;
+	fps->raw_data_bytes = UNIVERSAL_HEADER_BYTES + (number_of_entries * entry_bytes);
+	fps->universal_header = (UNIVERSAL_HEADER *) raw_data;
+	if (fps->file_type_code == TIME_SERIES_INDICES_FILE_TYPE_CODE) {
+		fps->time_series_indices = (TIME_SERIES_INDEX *) (raw_data + UNIVERSAL_HEADER_BYTES);
+	} else {
+		fps->record_indices = (RECORD_INDEX *) (raw_data + UNIVERSAL_HEADER_BYTES);
+		fps->record_indices_order = RECORD_INDICES_ORDER_UNKNOWN;
+	}
+	fps->index_pages_read = (ui1 *) ARENA_calloc(fps->arena, (size_t) ((number_of_entries + FPS_INDEX_PAGE_ENTRIES - 1) / FPS_INDEX_PAGE_ENTRIES) + 1, sizeof(ui1), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	
+	
+	return(fps);
+}
+
+
 SEGMENT	*read_MEF_segment(SEGMENT *segment, si1 *seg_path, si4 channel_type, si1 *password, PASSWORD_DATA *password_data, si1 read_time_series_data, si1 read_record_data)
 {
 	si1		full_file_name[MEF_FULL_FILE_NAME_BYTES];
+	PROFILE_TIMER	timer;
+	
 	
+	PROFILE_START(timer);
 	
 	// allocate segment if not passed
 	if (segment == NULL)
@@ -5893,7 +8155,7 @@ SEGMENT	*read_MEF_segment(SEGMENT *segment, si1 *seg_path, si4 channel_type, si1
 			break;
 		default:
 			UTF8_fprintf(stderr, "Error: unrecognized type code in file \"%s\" [function \"%s\", line %d]\n", full_file_name, __FUNCTION__, __LINE__);
-			if (MEF_globals->behavior_on_fail & EXIT_ON_FAIL) {
+			if (MEF_context->behavior_on_fail & EXIT_ON_FAIL) {
 				(void) fprintf(stderr, "\t=> exiting program\n\n");
 				exit(1);
 			}
@@ -5928,7 +8190,7 @@ SEGMENT	*read_MEF_segment(SEGMENT *segment, si1 *seg_path, si4 channel_type, si1
 			break;
 		default:
 			UTF8_fprintf(stderr, "Error: unrecognized type code in file \"%s\" [function \"%s\", line %d]\n", full_file_name, __FUNCTION__, __LINE__);
-			if (MEF_globals->behavior_on_fail & EXIT_ON_FAIL) {
+			if (MEF_context->behavior_on_fail & EXIT_ON_FAIL) {
 				(void) fprintf(stderr, "\t=> exiting program\n\n");
 				exit(1);
 			}
@@ -5939,7 +8201,7 @@ SEGMENT	*read_MEF_segment(SEGMENT *segment, si1 *seg_path, si4 channel_type, si1
 	switch (channel_type) {
 		case TIME_SERIES_CHANNEL_TYPE:
 			MEF_snprintf(full_file_name, MEF_FULL_FILE_NAME_BYTES, "%s/%s.%s/%s.%s", segment->path, segment->name, SEGMENT_DIRECTORY_TYPE_STRING, segment->name, TIME_SERIES_INDICES_FILE_TYPE_STRING);
-			segment->time_series_indices_fps = read_MEF_file(NULL, full_file_name, password, password_data, NULL, USE_GLOBAL_BEHAVIOR);
+			segment->time_series_indices_fps = read_MEF_indices(full_file_name, password, password_data, USE_GLOBAL_BEHAVIOR);
 			// update metadata if metadata conflicts with actual data
 			if (segment->metadata_fps->metadata.time_series_section_2->number_of_blocks > segment->time_series_indices_fps->universal_header->number_of_entries)
                                 segment->metadata_fps->metadata.time_series_section_2->number_of_blocks = segment->time_series_indices_fps->universal_header->number_of_entries;
@@ -5950,7 +8212,7 @@ SEGMENT	*read_MEF_segment(SEGMENT *segment, si1 *seg_path, si4 channel_type, si1
 			break;
 		default:
 			UTF8_fprintf(stderr, "Error: unrecognized type code in file \"%s\" [function \"%s\", line %d]\n", full_file_name, __FUNCTION__, __LINE__);
-			if (MEF_globals->behavior_on_fail & EXIT_ON_FAIL) {
+			if (MEF_context->behavior_on_fail & EXIT_ON_FAIL) {
 				(void) fprintf(stderr, "\t=> exiting program\n\n");
 				exit(1);
 			}
@@ -5959,7 +8221,7 @@ SEGMENT	*read_MEF_segment(SEGMENT *segment, si1 *seg_path, si4 channel_type, si1
 	
 	// read segment records
 	MEF_snprintf(full_file_name, MEF_FULL_FILE_NAME_BYTES, "%s/%s.%s/%s.%s", segment->path, segment->name, SEGMENT_DIRECTORY_TYPE_STRING, segment->name, RECORD_INDICES_FILE_TYPE_STRING);
-	segment->record_indices_fps = read_MEF_file(NULL, full_file_name, password, password_data, NULL, RETURN_ON_FAIL | SUPPRESS_ERROR_OUTPUT);
+	segment->record_indices_fps = read_MEF_indices(full_file_name, password, password_data, RETURN_ON_FAIL | SUPPRESS_ERROR_OUTPUT);
 	if (segment->record_indices_fps != NULL) {
 		// read segment record data
 		MEF_snprintf(full_file_name, MEF_FULL_FILE_NAME_BYTES, "%s/%s.%s/%s.%s", segment->path, segment->name, SEGMENT_DIRECTORY_TYPE_STRING, segment->name, RECORD_DATA_FILE_TYPE_STRING);
@@ -5971,6 +8233,7 @@ SEGMENT	*read_MEF_segment(SEGMENT *segment, si1 *seg_path, si4 channel_type, si1
 		if (segment->record_data_fps == NULL)
 			UTF8_fprintf(stderr, "%s() Warning: Segment record indices file, but no segment record data file (\"%s\") in segment directory\n\n", __FUNCTION__, full_file_name);
 	}
+	PROFILE_STOP(timer, PROFILE_PHASE_OPEN);
 	
 	
 	return(segment);
@@ -5987,11 +8250,25 @@ SESSION	*read_MEF_session(SESSION *session, si1 *sess_path, si1 *password, PASSW
 	VIDEO_METADATA_SECTION_2	*cvmd, *svmd;
 	METADATA_SECTION_3		*smd3, *cmd3;
 	FILE_PROCESSING_STRUCT		*temp_fps;
+	PROFILE_TIMER			timer;
+	si4				created_arena;
 	
 	
+	PROFILE_START(timer);
+	
+	// read into an arena in arena mode (the session's channels are read into it too)
+	created_arena = MEF_FALSE;
+	if (MEF_context->allocation_mode == MEF_ALLOCATE_IN_ARENA && MEF_context->arena == NULL) {
+		MEF_context->arena = ARENA_allocate(ARENA_SLAB_BYTES_DEFAULT);
+		created_arena = MEF_TRUE;
+	}
+	
 	// allocate session if not passed
 	if (session == NULL)
-		session = (SESSION *) e_calloc((size_t) 1, sizeof(SESSION), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+		session = (SESSION *) ARENA_calloc(MEF_context->arena, (size_t) 1, sizeof(SESSION), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	session->arena = MEF_context->arena;
+	if (created_arena == MEF_TRUE && session->arena != NULL)
+		session->arena->owner = (void *) session;
         
 	// get session path & name
 	extract_path_parts(sess_path, session->path, session->name, NULL);
@@ -6010,7 +8287,7 @@ SESSION	*read_MEF_session(SESSION *session, si1 *sess_path, si1 *password, PASSW
 	
 	// loop over time series channels
 	channel_names = generate_file_list(NULL, &n_channels, sess_path, TIME_SERIES_CHANNEL_DIRECTORY_TYPE_STRING);
-	session->time_series_channels = (CHANNEL *) e_calloc((size_t) n_channels, sizeof(CHANNEL), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	session->time_series_channels = (CHANNEL *) ARENA_calloc(session->arena, (size_t) n_channels, sizeof(CHANNEL), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
 	for (i = 0; i < n_channels; ++i) {
 		(void) read_MEF_channel(session->time_series_channels + i, channel_names[i], TIME_SERIES_CHANNEL_TYPE, password, password_data, read_time_series_data, read_record_data);
 		if ((password_data == NULL) && (session->time_series_channels[i].number_of_segments > 0))
@@ -6022,7 +8299,7 @@ SESSION	*read_MEF_session(SESSION *session, si1 *sess_path, si1 *password, PASSW
 
 	// loop over video channels
 	channel_names = generate_file_list(NULL, &n_channels, sess_path, VIDEO_CHANNEL_DIRECTORY_TYPE_STRING);
-	session->video_channels = (CHANNEL *) e_calloc((size_t) n_channels, sizeof(CHANNEL), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	session->video_channels = (CHANNEL *) ARENA_calloc(session->arena, (size_t) n_channels, sizeof(CHANNEL), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
 	for (i = 0; i < n_channels; ++i) {
 		(void) read_MEF_channel(session->video_channels + i, channel_names[i], VIDEO_CHANNEL_TYPE, password, password_data, read_time_series_data, read_record_data);
 		if (password_data == NULL)
@@ -6035,11 +8312,11 @@ SESSION	*read_MEF_session(SESSION *session, si1 *sess_path, si1 *password, PASSW
 	// fill in session metadata: times series channels
 	if (session->number_of_time_series_channels > 0) {
 		if (session->time_series_metadata.section_1 == NULL)
-			session->time_series_metadata.section_1 = (METADATA_SECTION_1 *) e_calloc((size_t) 1, sizeof(METADATA_SECTION_1), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+			session->time_series_metadata.section_1 = (METADATA_SECTION_1 *) ARENA_calloc(session->arena, (size_t) 1, sizeof(METADATA_SECTION_1), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
 		if (session->time_series_metadata.time_series_section_2 == NULL)
-			session->time_series_metadata.time_series_section_2 = (TIME_SERIES_METADATA_SECTION_2 *) e_calloc((size_t) 1, sizeof(TIME_SERIES_METADATA_SECTION_2), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+			session->time_series_metadata.time_series_section_2 = (TIME_SERIES_METADATA_SECTION_2 *) ARENA_calloc(session->arena, (size_t) 1, sizeof(TIME_SERIES_METADATA_SECTION_2), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
 		if (session->time_series_metadata.section_3 == NULL)
-			session->time_series_metadata.section_3 = (METADATA_SECTION_3 *) e_calloc((size_t) 1, sizeof(METADATA_SECTION_3), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+			session->time_series_metadata.section_3 = (METADATA_SECTION_3 *) ARENA_calloc(session->arena, (size_t) 1, sizeof(METADATA_SECTION_3), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
 	}
 
 	for (i = 0; i < session->number_of_time_series_channels; ++i) {
@@ -6174,11 +8451,11 @@ SESSION	*read_MEF_session(SESSION *session, si1 *sess_path, si1 *password, PASSW
 	// fill in session metadata: video channels
 	if (session->number_of_video_channels > 0) {
 		if (session->video_metadata.section_1 == NULL)
-			session->video_metadata.section_1 = (METADATA_SECTION_1 *) e_calloc((size_t) 1, sizeof(METADATA_SECTION_1), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+			session->video_metadata.section_1 = (METADATA_SECTION_1 *) ARENA_calloc(session->arena, (size_t) 1, sizeof(METADATA_SECTION_1), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
 		if (session->video_metadata.video_section_2 == NULL)
-			session->video_metadata.video_section_2 = (VIDEO_METADATA_SECTION_2 *) e_calloc((size_t) 1, sizeof(VIDEO_METADATA_SECTION_2), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+			session->video_metadata.video_section_2 = (VIDEO_METADATA_SECTION_2 *) ARENA_calloc(session->arena, (size_t) 1, sizeof(VIDEO_METADATA_SECTION_2), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
 		if (session->video_metadata.section_3 == NULL)
-			session->video_metadata.section_3 = (METADATA_SECTION_3 *) e_calloc((size_t) 1, sizeof(METADATA_SECTION_3), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+			session->video_metadata.section_3 = (METADATA_SECTION_3 *) ARENA_calloc(session->arena, (size_t) 1, sizeof(METADATA_SECTION_3), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
 	}
 	
 	for (i = 0; i < session->number_of_video_channels; ++i) {
@@ -6283,7 +8560,7 @@ SESSION	*read_MEF_session(SESSION *session, si1 *sess_path, si1 *password, PASSW
 
 	// read session record indices if present
 	MEF_snprintf(full_file_name, MEF_FULL_FILE_NAME_BYTES, "%s/%s.%s/%s.%s", session->path, session->name, SESSION_DIRECTORY_TYPE_STRING, session->name, RECORD_INDICES_FILE_TYPE_STRING);
-	session->record_indices_fps = read_MEF_file(NULL, full_file_name, password, password_data, NULL, RETURN_ON_FAIL | SUPPRESS_ERROR_OUTPUT);
+	session->record_indices_fps = read_MEF_indices(full_file_name, password, password_data, RETURN_ON_FAIL | SUPPRESS_ERROR_OUTPUT);
     if (session->record_indices_fps != NULL) {
 		if (password_data == NULL)
 			password_data = session->record_indices_fps->password_data;
@@ -6310,7 +8587,12 @@ SESSION	*read_MEF_session(SESSION *session, si1 *sess_path, si1 *password, PASSW
 		MEF_strncpy(session->anonymized_name, session->record_data_fps->universal_header->anonymized_name, UNIVERSAL_HEADER_ANONYMIZED_NAME_BYTES);
 	}
 	
-	if (MEF_globals->verbose == MEF_TRUE) {
+	// later allocations are from the heap
+	if (created_arena == MEF_TRUE)
+		MEF_context->arena = NULL;
+	PROFILE_STOP(timer, PROFILE_PHASE_OPEN);
+
+	if (MEF_context->verbose == MEF_TRUE) {
 		if (session->number_of_time_series_channels > 0) {
 			printf("------------ Session Time Series Metadata --------------\n");
 			temp_fps = allocate_file_processing_struct(0, TIME_SERIES_METADATA_FILE_TYPE_CODE, NULL, NULL, 0);
@@ -6329,1658 +8611,3200 @@ SESSION	*read_MEF_session(SESSION *session, si1 *sess_path, si1 *password, PASSW
 		}
 	}
 
-	
+
 	return(session);
 }
 
 
-si4	reallocate_file_processing_struct(FILE_PROCESSING_STRUCT *fps, si8 raw_data_bytes)
-{
-	void	*data_ptr;
-	
-	
-	// reallocate
-	fps->raw_data = (ui1 *) e_realloc((void *) fps->raw_data, (size_t) raw_data_bytes, __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
-	
-	// zero additional memory
-	if (raw_data_bytes > fps->raw_data_bytes)
-		bzero(fps->raw_data + fps->raw_data_bytes, raw_data_bytes - fps->raw_data_bytes);
-        fps->raw_data_bytes = raw_data_bytes;
-	
-	// reset universal header pointer
-	if (raw_data_bytes >= UNIVERSAL_HEADER_BYTES)
-		fps->universal_header = (UNIVERSAL_HEADER *) fps->raw_data; // all files start with universal header
-	else
-		return(0);
-        
-	// set appropriate pointers
-	data_ptr = NULL;
-	if (fps->raw_data != NULL)
-		data_ptr = (ui1 *)fps->raw_data + UNIVERSAL_HEADER_BYTES;
+/*************************************************************************/
+/*****************************  PROFILE FUNCTIONS  ***********************/
+/*************************************************************************/
 
-        switch (fps->file_type_code) {
-                case NO_TYPE_CODE:
-                        break;
-                case TIME_SERIES_INDICES_FILE_TYPE_CODE:
-                        fps->time_series_indices = (TIME_SERIES_INDEX *) data_ptr;
-                        break;
-		case TIME_SERIES_METADATA_FILE_TYPE_CODE:
-			fps->metadata.section_1 = (METADATA_SECTION_1 *) data_ptr;
-			fps->metadata.time_series_section_2 = (TIME_SERIES_METADATA_SECTION_2 *) (fps->raw_data + METADATA_SECTION_2_OFFSET);
-			fps->metadata.section_3 = (METADATA_SECTION_3 *) (fps->raw_data + METADATA_SECTION_3_OFFSET);
-			break;
-		case TIME_SERIES_DATA_FILE_TYPE_CODE:
-			fps->RED_blocks = (ui1 *) data_ptr;
-			break;
-                case VIDEO_METADATA_FILE_TYPE_CODE:
-                        fps->metadata.section_1 = (METADATA_SECTION_1 *) data_ptr;
-                        fps->metadata.video_section_2 = (VIDEO_METADATA_SECTION_2 *) (fps->raw_data + METADATA_SECTION_2_OFFSET);
-                        fps->metadata.section_3 = (METADATA_SECTION_3 *) (fps->raw_data + METADATA_SECTION_3_OFFSET);
-                        break;
-                case VIDEO_INDICES_FILE_TYPE_CODE:
-                        fps->video_indices = (VIDEO_INDEX *) data_ptr;
-                	break;
-                case RECORD_DATA_FILE_TYPE_CODE:
-                        fps->records = (ui1 *) data_ptr;
-                        break;
-                case RECORD_INDICES_FILE_TYPE_CODE:
-                        fps->record_indices = (RECORD_INDEX *) data_ptr;
-                        break;
-                default:
-                        fprintf(stderr, "Error: unrecognized type code \"0x%x\" [function \"%s\", line %d]\n", fps->file_type_code, __FUNCTION__, __LINE__);
-                        if (MEF_globals->behavior_on_fail & EXIT_ON_FAIL) {
-                                (void) fprintf(stderr, "\t=> exiting program\n\n");
-        			exit(1);
-                        }
-                        return(-1);
-        }
-	
-        
-	return(0);
+
+void	PROFILE_add(si8 *counter, si8 value)
+{
+	// counters are added to from the worker threads
+	#ifdef _WIN32
+		(void) InterlockedExchangeAdd64((volatile LONG64 *) counter, (LONG64) value);
+	#else
+		(void) __atomic_fetch_add(counter, value, __ATOMIC_RELAXED);
+	#endif
+
+
+	return;
 }
 
 
-/*************************************************************************/
-/******************************  RED FUNCTIONS  **************************/
-/*************************************************************************/
+void	PROFILE_begin(MEF_PROFILE *profile)
+{
+	// zeroes the profile & starts its wall & CPU clocks (set it as a context's profile to collect into it)
+	memset((void *) profile, 0, sizeof(MEF_PROFILE));
+	profile->wall_ns = PROFILE_wall_ns();
+	profile->CPU_ns = PROFILE_process_CPU_ns();
 
 
-RED_PROCESSING_STRUCT	*RED_allocate_processing_struct(si8 original_data_size, si8 compressed_data_size, si8 decompressed_data_size, si8 difference_buffer_size, si8 detrended_buffer_size, si8 scaled_buffer_size, PASSWORD_DATA *password_data)
+	return;
+}
+
+
+void	PROFILE_end(MEF_PROFILE *profile)
 {
-        RED_PROCESSING_STRUCT	*rps;
-        
-	
-	// allocate
-        rps = (RED_PROCESSING_STRUCT *) e_calloc((size_t) 1, sizeof(RED_PROCESSING_STRUCT), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
-        
-        if (original_data_size)
-		rps->original_ptr = rps->original_data = (si4 *) e_calloc((size_t) original_data_size, sizeof(si4), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
-	
-        if (compressed_data_size) {
-		rps->compressed_data = (ui1 *) e_calloc((size_t) compressed_data_size, sizeof(ui1), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
-        	rps->block_header = (RED_BLOCK_HEADER *) rps->compressed_data;
-	}
-		
-	if (decompressed_data_size)
-		rps->decompressed_ptr = rps->decompressed_data = (si4 *) e_calloc((size_t) decompressed_data_size, sizeof(si4), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
-	
-	if (difference_buffer_size)
-		rps->difference_buffer = (si1 *) e_calloc((size_t) difference_buffer_size, sizeof(ui1), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
-	
-	if (detrended_buffer_size)
-		rps->detrended_buffer = (si4 *) e_calloc((size_t) detrended_buffer_size, sizeof(si4), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
-	
-	if (scaled_buffer_size)
-		rps->scaled_buffer = (si4 *) e_calloc((size_t) scaled_buffer_size, sizeof(si4), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
-	
-	// assign password data
-	rps->password_data = password_data;
-        
-	// set directives defaults
-	rps->directives.return_lossy_data = RED_RETURN_LOSSY_DATA_DEFAULT;
-	rps->directives.encryption_level = RED_ENCRYPTION_LEVEL_DEFAULT;
-	rps->directives.detrend_data = RED_DETREND_DATA_DEFAULT;
-	rps->directives.discontinuity = RED_DISCONTINUITY_DEFAULT;
-	rps->directives.reset_discontinuity = RED_RESET_DISCONTINUITY_DEFAULT;
-        rps->directives.require_normality = RED_REQUIRE_NORMALITY_DEFAULT;
-        rps->directives.normal_correlation = RED_NORMAL_CORRELATION_DEFAULT;
-	
-	// set compression defaults
-	rps->compression.mode = RED_COMPRESSION_MODE_DEFAULT;
-	rps->compression.goal_compression_ratio = RED_GOAL_COMPRESSION_RATIO_DEFAULT;
-	rps->compression.goal_mean_residual_ratio = RED_GOAL_MEAN_RESIDUAL_RATIO_DEFAULT;
-	rps->compression.goal_tolerance = RED_GOAL_TOLERANCE_DEFAULT;
-	rps->compression.maximum_rounds_per_block = RED_MAXIMUM_ROUNDS_PER_BLOCK_DEFAULT;
-	
-        
-        return(rps);
+	profile->wall_ns = PROFILE_wall_ns() - profile->wall_ns;
+	profile->CPU_ns = PROFILE_process_CPU_ns() - profile->CPU_ns;
+
+
+	return;
 }
 
 
-inline sf8	RED_calculate_mean_residual_ratio(si4 *original_data, si4 *lossy_data, ui4 n_samps)
+const si1	*PROFILE_phase_name(si4 phase)
 {
-	sf8	sum, mrr, diff, r;
-	si8	i;
-	
-	
-	sum = (sf8) 0.0;
-	for (i = n_samps; i--;) {
-		if (*original_data) {
-			diff = (sf8) (*original_data - *lossy_data++);
-                        r = diff / (sf8) *original_data++;
-			sum += ABS(r);
-		} else {
-			--n_samps;
-			++original_data;
-			++lossy_data;
-		}
-	}
-	
-	if (sum == (sf8) 0.0)
-		mrr = (sf8) 0.0;
-	else
-		mrr = sum / (sf8) n_samps;
-	
-	
-	return(mrr);
+	static const si1	*phase_names[PROFILE_NUMBER_OF_PHASES] = {"open", "read", "crc", "aes", "decode", "convert"};
+
+
+	if (phase < 0 || phase >= PROFILE_NUMBER_OF_PHASES)
+		return(NULL);
+
+
+	return(phase_names[phase]);
 }
 
 
-si1	RED_check_RPS_allocation(RED_PROCESSING_STRUCT *rps)
+si8	PROFILE_process_CPU_ns(void)
 {
-        si1	error = MEF_FALSE;
-	si1	need_compressed_data = MEF_FALSE;
-	si1	need_decompressed_data = MEF_FALSE;
-        si1	need_original_data = MEF_FALSE;
-	si1	need_detrended_buffer = MEF_FALSE;
-	si1	need_scaled_buffer = MEF_FALSE;
-	si1	need_difference_buffer = MEF_FALSE;
-	
-        
-        // decompression
-        if (rps->compression.mode == RED_DECOMPRESSION) {
-                need_compressed_data = MEF_TRUE;
-                need_decompressed_data = MEF_TRUE;
-                need_difference_buffer = MEF_TRUE;
-        }
-        
-        // compression
-        else {
-                need_compressed_data = MEF_TRUE;
-                need_original_data = MEF_TRUE;
-                need_difference_buffer = MEF_TRUE;
-                
-                // lossy compression
-                if (rps->compression.mode > RED_LOSSLESS_COMPRESSION) {
-                        need_scaled_buffer = MEF_TRUE;
-                        if (rps->directives.detrend_data == MEF_TRUE)
-                                need_detrended_buffer = MEF_TRUE;
-                        if (rps->compression.mode == RED_MEAN_RESIDUAL_RATIO)
-                                need_decompressed_data = MEF_TRUE;
-                        if (rps->directives.return_lossy_data == MEF_TRUE)
-                                need_decompressed_data = MEF_TRUE;
-                }
-        }
-        
-        // check compressed_data
-        if (need_compressed_data == MEF_TRUE && rps->compressed_data == NULL) {
-                fprintf(stderr, "\"compressed_data\" is not allocated in the RED_PROCESSING_STRUCT [function %s, line %d]\n", __FUNCTION__, __LINE__);
-		error = MEF_TRUE;
-        }
-	
-        // check difference_buffer
-        if (need_difference_buffer == MEF_TRUE && rps->difference_buffer == NULL) {
-                fprintf(stderr, "\"difference_buffer\" is not allocated in the RED_PROCESSING_STRUCT [function %s, line %d]\n", __FUNCTION__, __LINE__);
-		error = MEF_TRUE;
-        }
-	
-        // check original_data
-        if (need_original_data == MEF_TRUE && rps->original_data == NULL) {
-                fprintf(stderr, "\"original_data\" is not allocated in the RED_PROCESSING_STRUCT [function %s, line %d]\n", __FUNCTION__, __LINE__);
-		error = MEF_TRUE;
-        }
-	if (need_original_data == MEF_FALSE && rps->original_data != NULL) {
-                fprintf(stderr, "\"original_data\" is needlessly allocated in the RED_PROCESSING_STRUCT => freeing [function %s, line %d]\n", __FUNCTION__, __LINE__);
-		free(rps->original_data);
-		rps->original_ptr = rps->original_data = NULL;
-	}
-        
-        // check decompressed_data
-        if (need_decompressed_data == MEF_TRUE && rps->decompressed_data == NULL) {
-                fprintf(stderr, "\"decompressed_data\" is not allocated in the RED_PROCESSING_STRUCT [function %s, line %d]\n", __FUNCTION__, __LINE__);
-		error = MEF_TRUE;
-        }
-	if (need_decompressed_data == MEF_FALSE && rps->decompressed_data != NULL) {
-		fprintf(stderr, "\"decompressed_data\" is needlessly allocated in the RED_PROCESSING_STRUCT => freeing [function %s, line %d]\n", __FUNCTION__, __LINE__);
-		free(rps->decompressed_data);
-		rps->decompressed_ptr = rps->decompressed_data = NULL;
-	}
+	#ifdef _WIN32
+		FILETIME	creation_time, exit_time, kernel_time, user_time;
+		ULARGE_INTEGER	kernel, user;
 
-        // check detrended_buffer
-        if (need_detrended_buffer == MEF_TRUE && rps->detrended_buffer == NULL) {
-                fprintf(stderr, "\"detrended_buffer\" is not allocated in the RED_PROCESSING_STRUCT [function %s, line %d]\n", __FUNCTION__, __LINE__);
-		error = MEF_TRUE;
-        }
-	if (need_detrended_buffer == MEF_FALSE && rps->detrended_buffer != NULL) {
-                fprintf(stderr, "\"detrended_buffer\" is needlessly allocated in the RED_PROCESSING_STRUCT => freeing [function %s, line %d]\n", __FUNCTION__, __LINE__);
-		free(rps->detrended_buffer);
-		rps->detrended_buffer = NULL;
-	}
-        
-        // check scaled_buffer
-        if (need_scaled_buffer == MEF_TRUE && rps->scaled_buffer == NULL) {
-                fprintf(stderr, "\"scaled_buffer\" is not allocated in the RED_PROCESSING_STRUCT [function %s, line %d]\n", __FUNCTION__, __LINE__);
-		error = MEF_TRUE;
-        }
-	if (need_scaled_buffer == MEF_FALSE && rps->scaled_buffer != NULL) {
-                fprintf(stderr, "\"scaled_buffer\" is needlessly allocated in the RED_PROCESSING_STRUCT => freeing [function %s, line %d]\n", __FUNCTION__, __LINE__);
-		free(rps->scaled_buffer);
-		rps->scaled_buffer = NULL;
-	}
-	
-	// error
-	if (error == MEF_TRUE) {
-		if (MEF_globals->behavior_on_fail & EXIT_ON_FAIL) {
-			(void) fprintf(stderr, "\t=> exiting program\n\n");
-			exit(1);
-		}
+
+		if (GetProcessTimes(GetCurrentProcess(), &creation_time, &exit_time, &kernel_time, &user_time) == 0)
+			return(0);
+		kernel.LowPart = kernel_time.dwLowDateTime;
+		kernel.HighPart = kernel_time.dwHighDateTime;
+		user.LowPart = user_time.dwLowDateTime;
+		user.HighPart = user_time.dwHighDateTime;
+
+		return((si8) (kernel.QuadPart + user.QuadPart) * 100);  // 100 ns units
+	#else
+		struct timespec	ts;
+
+
+		if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts))
+			return(0);
+
+		return(((si8) ts.tv_sec * (si8) 1000000000) + (si8) ts.tv_nsec);
+	#endif
+}
+
+
+void	PROFILE_start_timer(PROFILE_TIMER *timer)
+{
+	// timer->profile is set (PROFILE_START()); the timer becomes the thread's running timer
+	timer->nested_wall_ns = timer->nested_CPU_ns = 0;
+	timer->parent = PROFILE_thread_timer;
+	PROFILE_thread_timer = timer;
+	timer->start_CPU_ns = PROFILE_thread_CPU_ns();
+	timer->start_wall_ns = PROFILE_wall_ns();
+
+
+	return;
+}
+
+
+void	PROFILE_stop_timer(PROFILE_TIMER *timer, si4 phase)
+{
+	si8	wall_ns, CPU_ns;
+
+
+	// adds the time since the timer started, less that of the timers nested in it, to the phase
+	wall_ns = PROFILE_wall_ns() - timer->start_wall_ns;
+	CPU_ns = PROFILE_thread_CPU_ns() - timer->start_CPU_ns;
+	PROFILE_thread_timer = timer->parent;
+	if (timer->parent != NULL) {
+		timer->parent->nested_wall_ns += wall_ns;
+		timer->parent->nested_CPU_ns += CPU_ns;
 	}
-        
+	PROFILE_add(timer->profile->phase_wall_ns + phase, wall_ns - timer->nested_wall_ns);
+	PROFILE_add(timer->profile->phase_CPU_ns + phase, CPU_ns - timer->nested_CPU_ns);
+	PROFILE_add(timer->profile->phase_calls + phase, 1);
+	timer->profile = NULL;
 
-        return(error);
+
+	return;
 }
 
 
-void 	RED_decode(RED_PROCESSING_STRUCT *rps)
+si8	PROFILE_thread_CPU_ns(void)
 {
-        si1			*si1_p1, *si1_p2, *diff_buffer_p, CRC_valid;
-        ui1			*ui1_p, *ib_p, in_byte, *scaled_counts, *key;
-        si4			*si4_p, current_val;
-	si8			i;
-        ui4			cc, *cumulative_counts, low_bound, range, symbol;
-        ui4			scaled_total_counts, temp_ui4, range_per_count, *ui4_p1, *ui4_p2;
-        RED_BLOCK_HEADER	*block_header;
-        
-        
-        // RED decompress from compressed_ptr to decompressed_ptr
-	block_header = rps->block_header;
-	
-        // check CRC
-	if (MEF_globals->CRC_mode & (CRC_VALIDATE | CRC_VALIDATE_ON_INPUT)) {
-                CRC_valid = CRC_validate((ui1 *) block_header + CRC_BYTES, block_header->block_bytes - CRC_BYTES, block_header->block_CRC);
-                if (CRC_valid == MEF_FALSE) {
-                        (void) fprintf(stderr, "%c\n%s(): invalid RED block CRC => returning without decoding\n", 7, __FUNCTION__);
-                        return;
-                }
-        }
-        
-        // decrypt
-	if (block_header->flags & RED_LEVEL_1_ENCRYPTION_MASK) {
-		rps->directives.encryption_level = LEVEL_1_ENCRYPTION;
-		key = rps->password_data->level_1_encryption_key;
-	} else if (block_header->flags & RED_LEVEL_2_ENCRYPTION_MASK) {
-		rps->directives.encryption_level = LEVEL_2_ENCRYPTION;
-		key = rps->password_data->level_2_encryption_key;
-	} else
-		rps->directives.encryption_level = NO_ENCRYPTION;
-	if (rps->directives.encryption_level > NO_ENCRYPTION) {
-		if (rps->password_data->access_level >= rps->directives.encryption_level) {
-			AES_decrypt(block_header->statistics, block_header->statistics, NULL, key);
-			block_header->flags &= ~RED_LEVEL_1_ENCRYPTION_MASK;
-			block_header->flags &= ~RED_LEVEL_2_ENCRYPTION_MASK;
-			rps->directives.encryption_level = -rps->directives.encryption_level;   // mark as decrypted
-		} else {
-			(void) fprintf(stderr, "%c\n%s(): No access to encrypted data => returning without decoding\n", 7, __FUNCTION__);
-			return;
-		}
+	#ifdef _WIN32
+		FILETIME	creation_time, exit_time, kernel_time, user_time;
+		ULARGE_INTEGER	kernel, user;
+
+
+		if (GetThreadTimes(GetCurrentThread(), &creation_time, &exit_time, &kernel_time, &user_time) == 0)
+			return(0);
+		kernel.LowPart = kernel_time.dwLowDateTime;
+		kernel.HighPart = kernel_time.dwHighDateTime;
+		user.LowPart = user_time.dwLowDateTime;
+		user.HighPart = user_time.dwHighDateTime;
+
+		return((si8) (kernel.QuadPart + user.QuadPart) * 100);  // 100 ns units
+	#else
+		struct timespec	ts;
+
+
+		if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts))
+			return(0);
+
+		return(((si8) ts.tv_sec * (si8) 1000000000) + (si8) ts.tv_nsec);
+	#endif
+}
+
+
+si8	PROFILE_wall_ns(void)
+{
+	#ifdef _WIN32
+		static LARGE_INTEGER	frequency = {0};
+		LARGE_INTEGER		counter;
+
+
+		if (frequency.QuadPart == 0)
+			QueryPerformanceFrequency(&frequency);
+		QueryPerformanceCounter(&counter);
+
+		return((si8) ((counter.QuadPart / frequency.QuadPart) * 1000000000) + (si8) (((counter.QuadPart % frequency.QuadPart) * 1000000000) / frequency.QuadPart));
+	#else
+		struct timespec	ts;
+
+
+		// monotonic (not set back or forward with the system clock)
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+
+		return(((si8) ts.tv_sec * (si8) 1000000000) + (si8) ts.tv_nsec);
+	#endif
+}
+
+
+/*************************************************************************/
+/***************************  END PROFILE FUNCTIONS  *********************/
+/*************************************************************************/
+
+
+/*************************************************************************/
+/***************************  READ PLAN FUNCTIONS  ***********************/
+/*************************************************************************/
+
+
+void	READ_PLAN_add_gap(READ_PLAN *plan, si8 output_offset, si8 number_of_samples)
+{
+	if (plan->number_of_gaps == plan->allocated_gaps) {
+		plan->allocated_gaps = (plan->allocated_gaps) ? plan->allocated_gaps << 1 : 16;
+		plan->gaps = (READ_PLAN_GAP *) e_realloc((void *) plan->gaps, (size_t) plan->allocated_gaps * sizeof(READ_PLAN_GAP), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
 	}
-        
-        // offset recording time
-        if (MEF_globals->recording_time_offset_mode & (RTO_APPLY | RTO_APPLY_ON_INPUT))
-                apply_recording_time_offset(&block_header->start_time);
-        else if (MEF_globals->recording_time_offset_mode & (RTO_REMOVE | RTO_REMOVE_ON_INPUT))
-                remove_recording_time_offset(&block_header->start_time);
-	
-	// discontinuity
-	if (block_header->flags & RED_DISCONTINUITY_MASK)
-		rps->directives.discontinuity = MEF_TRUE;
+	plan->gaps[plan->number_of_gaps].output_offset = output_offset;
+	plan->gaps[plan->number_of_gaps++].number_of_samples = number_of_samples;
+
+
+	return;
+}
+
+
+READ_PLAN	*READ_PLAN_build(CHANNEL *channel, CONTINUITY_INDEX *continuity_index, si8 start_time, si8 end_time, READ_PLAN *plan)
+{
+	si1			local_index;
+	si4			seg;
+	si8			k, first_block, last_block, n_out, covered, run_slot;
+	sf8			sampling_frequency;
+	CONTINUITY_ENTRY	*entry;
+
+
+	// plans the output of samples [start_time, end_time) (uUTC, recording time offset removed); the continuity index
+	// is built if NULL, and the channel's time series indices must be in memory
+	if (plan == NULL)
+		plan = (READ_PLAN *) e_calloc((size_t) 1, sizeof(READ_PLAN), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
 	else
-		rps->directives.discontinuity = MEF_FALSE;
-        
-	// if no samples, just return
-	if (block_header->number_of_samples == 0)
-		return;
-	
-        // range decode difference data
-        ui1_p = scaled_counts = block_header->statistics;
-        *(ui4_p1 = cumulative_counts = rps->counts) = 0;
-        ui4_p2 = ui4_p1 + 1;
-	for (i = RED_BLOCK_STATISTICS_BYTES; i--;)
-		*ui4_p2++ = *ui4_p1++ + (ui4) *ui1_p++;
-	scaled_total_counts = *ui4_p1;
-	
-        diff_buffer_p = rps->difference_buffer;
-        *diff_buffer_p++ = -128; // initial keysample flag not coded in encode (should be a low frequency symbol)
-	
-	ib_p = (ui1 *) rps->block_header + RED_BLOCK_HEADER_BYTES;
-	in_byte = *ib_p++;
-	low_bound = in_byte >> (8 - EXTRA_BITS);
-	range = (ui4) 1 << EXTRA_BITS;
-	ui4_p2 = cumulative_counts + 256;
-	for (i = block_header->difference_bytes; i--;) {
-                while (range <= BOTTOM_VALUE) {
-			low_bound = (low_bound << 8) | ((in_byte << EXTRA_BITS) & 0xff);
-                        in_byte = *ib_p++;
-                        low_bound |= in_byte >> (8 - EXTRA_BITS);
-                        range <<= 8;
-                }
-		temp_ui4 = low_bound / (range_per_count = range / scaled_total_counts);
-		cc = (temp_ui4 >= scaled_total_counts ? (scaled_total_counts - 1) : temp_ui4);
-		if (cc > cumulative_counts[128]) {
-			for (ui4_p1 = ui4_p2; *--ui4_p1 > cc;);
-			symbol = ui4_p1 - cumulative_counts;
-		} else {
-			for (ui4_p1 = cumulative_counts; *++ui4_p1 <= cc;);
-			symbol = ui4_p1 - cumulative_counts - 1;
+		READ_PLAN_free(plan, MEF_FALSE);
+	plan->start_time = start_time;
+	plan->end_time = end_time;
+
+	local_index = MEF_FALSE;
+	if (continuity_index == NULL) {
+		continuity_index = CONTINUITY_build_index(channel, NULL);
+		local_index = MEF_TRUE;
+	}
+	sampling_frequency = continuity_index->sampling_frequency;
+	n_out = (sampling_frequency > 0.0) ? READ_PLAN_samples_in_time(end_time - start_time, sampling_frequency) : 0;
+	if (n_out <= 0) {
+		if (local_index == MEF_TRUE)
+			CONTINUITY_free_index(continuity_index, MEF_TRUE);
+		return(plan);
+	}
+	plan->number_of_samples = n_out;
+
+	covered = 0;  // output samples before this are placed (or are gaps)
+	k = CONTINUITY_find_entry(continuity_index, (sf8) start_time, MEF_FALSE);
+	if (k < 0)
+		k = 0;
+	for (; k < continuity_index->number_of_entries && covered < n_out; ++k) {
+		entry = continuity_index->entries + k;
+		if (entry->start_time >= end_time)
+			break;
+		if (entry->end_time <= (sf8) start_time)
+			continue;
+
+		// place the entry by its start time, & its blocks by their sample offsets within the entry
+		run_slot = READ_PLAN_samples_in_time(entry->start_time - start_time, sampling_frequency);
+		if (run_slot >= n_out)
+			break;
+		for (seg = entry->start_segment; seg <= entry->end_segment && covered < n_out; ++seg) {
+			first_block = (seg == entry->start_segment) ? entry->start_block : 0;
+			last_block = (seg == entry->end_segment) ? entry->end_block : channel->segments[seg].time_series_indices_fps->universal_header->number_of_entries - 1;
+			covered = READ_PLAN_place_blocks(plan, channel, seg, first_block, last_block, run_slot - entry->start_sample, covered);
 		}
-		low_bound -= (temp_ui4 = range_per_count * cumulative_counts[symbol]);
-		if (symbol < 255)
-			range = range_per_count * scaled_counts[symbol];
-		else
-			range -= temp_ui4;
-		*diff_buffer_p++ = symbol;
 	}
-	
-	// generate output from difference data
-	si1_p1 = (si1 *) rps->difference_buffer;
-	si4_p = rps->decompressed_ptr;
-	for (i = block_header->number_of_samples; i--;) {
-		if (*si1_p1 == -128) {
-			++si1_p1;
-			si1_p2 = (si1 *) &current_val;
-			*si1_p2++ = *si1_p1++; *si1_p2++ = *si1_p1++; *si1_p2++ = *si1_p1++; *si1_p2 = *si1_p1++;
-		} else
-			current_val += (si4) *si1_p1++;
-		*si4_p++ = current_val;
+	if (covered < n_out)
+		READ_PLAN_add_gap(plan, covered, n_out - covered);
+
+	if (local_index == MEF_TRUE)
+		CONTINUITY_free_index(continuity_index, MEF_TRUE);
+
+
+	return(plan);
+}
+
+
+READ_PLAN	*READ_PLAN_build_for_samples(CHANNEL *channel, si8 start_sample, si8 end_sample, READ_PLAN *plan)
+{
+	si4			seg;
+	si8			n_out, covered, segment_start_sample, segment_samples, first_block, last_block;
+	FILE_PROCESSING_STRUCT	*fps;
+
+
+	// plans the output of channel samples [start_sample, end_sample) (zero-based); samples outside the channel are gaps,
+	// as are those of segments whose indices cannot be read (on demand indices: only the entries of the range are read)
+	if (plan == NULL)
+		plan = (READ_PLAN *) e_calloc((size_t) 1, sizeof(READ_PLAN), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	else
+		READ_PLAN_free(plan, MEF_FALSE);
+	plan->start_time = plan->end_time = UUTC_NO_ENTRY;
+
+	n_out = end_sample - start_sample;
+	if (n_out <= 0)
+		return(plan);
+	plan->number_of_samples = n_out;
+
+	covered = 0;
+	for (seg = 0; seg < channel->number_of_segments && covered < n_out; ++seg) {
+		segment_start_sample = channel->segments[seg].metadata_fps->metadata.time_series_section_2->start_sample;
+		segment_samples = channel->segments[seg].metadata_fps->metadata.time_series_section_2->number_of_samples;
+		if (segment_start_sample + segment_samples <= start_sample + covered)
+			continue;
+		if (segment_start_sample >= end_sample)
+			break;
+		fps = channel->segments[seg].time_series_indices_fps;
+		if (fps_find_index_entry(fps, FPS_INDEX_KEY_SAMPLE, (start_sample + covered) - segment_start_sample, &first_block) < 0 || fps_find_index_entry(fps, FPS_INDEX_KEY_SAMPLE, (end_sample - 1) - segment_start_sample, &last_block) < 0)
+			continue;
+		if (first_block < 0)
+			first_block = 0;
+		if (fps_read_index_entries(fps, first_block, last_block) < 0)
+			continue;
+		covered = READ_PLAN_place_blocks(plan, channel, seg, first_block, last_block, -start_sample, covered);
 	}
-	
-        // unscale decompressed_data if scaled (in place)
-	if (block_header->scale_factor > (sf4) 1.0)
-                RED_unscale(rps, rps->decompressed_ptr, rps->decompressed_ptr);
-        
-        // add trend to decompressed_data if detrended (in place)
-	if ((block_header->detrend_slope != (sf4) 0.0) || (block_header->detrend_intercept != (sf4) 0.0))
-                RED_retrend(rps, rps->decompressed_ptr, rps->decompressed_ptr);
-	
-	
-        return;
+	if (covered < n_out)
+		READ_PLAN_add_gap(plan, covered, n_out - covered);
+
+
+	return(plan);
 }
 
 
-si4	*RED_detrend(RED_PROCESSING_STRUCT *rps, si4 *input_buffer, si4 *output_buffer)
+si4	READ_PLAN_compare_blocks(const void *a, const void *b)
 {
-        si4			*si4_p1, *si4_p2;
-        sf8			sx, sy, sxx, syy, sxy, n, mx, my, c, sf8_m, sf8_b, val;
-        sf4			m, b;
-        si8			i;
-        RED_BLOCK_HEADER	*block_header;
-	
-	
-        // detrend from input_buffer to output_buffer
-	// slope and intercept values entered into block_header
-	// if input_buffer == output_buffer detrending will be done in place
-        
-        block_header = rps->block_header;
-	
-        // calculate slope & intercept
-        n = block_header->number_of_samples;
-        sx = (n * (n + (sf8) 1.0)) / (sf8) 2.0;
-        sxx = (n * (n + (sf8) 1.0) * ((n * (sf8) 2.0) + (sf8) 1.0)) / (sf8) 6.0;
-        
-        sy = syy = sxy = 0.0;
-        c = (sf8) 1.0;
-        si4_p1 = input_buffer;
-        for (i = block_header->number_of_samples; i--;) {
-                val = (sf8) *si4_p1++;
-                sy += val;
-                syy += val * val;
-                sxy += val * c;
-                c += (sf8) 1.0;
-        }
-        
-        mx = sx / n;
-        my = sy / n;
-        sf8_m = (((sx * my) - sxy) / ((sx * mx) - sxx));
-        sf8_b = (my - (sf8_m * mx));
-        
-        m = block_header->detrend_slope = (sf4) sf8_m;
-        b = block_header->detrend_intercept = (sf4) sf8_b;
-        
-        // subtract trend from input_buffer to output_buffer
-        sf8_m = (sf8) m;
-        sf8_b = (sf8) b;
-        c = (sf8) 0.0;
-        si4_p1 = input_buffer;
-	si4_p2 = output_buffer;
-        for (i = block_header->number_of_samples; i--;) {
-                c += (sf8) 1.0;
-                *si4_p2++ = RED_round((sf8) *si4_p1++ - (sf8_m * c) - sf8_b);
-        }
-        
-        
-        return(output_buffer);
+	READ_PLAN_BLOCK	*block_a, *block_b;
+
+
+	block_a = (READ_PLAN_BLOCK *) a;
+	block_b = (READ_PLAN_BLOCK *) b;
+	if (block_a->segment_number != block_b->segment_number)
+		return((block_a->segment_number > block_b->segment_number) ? 1 : -1);
+	if (block_a->block_number != block_b->block_number)
+		return((block_a->block_number > block_b->block_number) ? 1 : -1);
+
+
+	return(0);
 }
 
 
-inline void	RED_encode(RED_PROCESSING_STRUCT *rps)
+void	READ_PLAN_decode_task(void *task_args, si8 task_number, si4 thread_number)
 {
-	// RED compress from original_ptr to block_header pointer (compressed data array)
-	
-	rps->block_header->detrend_slope = rps->block_header->detrend_intercept = (sf4) 0.0;
-	if (rps->compression.mode == RED_LOSSLESS_COMPRESSION) {
-		rps->block_header->scale_factor = (sf4) 1.0;
-		RED_encode_exec(rps, rps->original_ptr, MEF_FALSE);
-	} else if (rps->compression.mode > RED_LOSSLESS_COMPRESSION) {
-		RED_encode_lossy(rps);
-	} else {
-		(void) fprintf(stderr, "%c\n%s(): Invalid compression mode => returning without encoding\n", 7, __FUNCTION__);
+	READ_PLAN_TASK_ARGS	*args;
+	RED_PROCESSING_STRUCT	*rps;
+	RED_BLOCK_HEADER	*block_header;
+	READ_PLAN_BLOCK		*plan_block;
+	TIME_SERIES_INDEX	*tsi;
+	PASSWORD_DATA		*pwd;
+	si1			whole_block, encryption_level;
+	si4			*out, *block_samples;
+	si8			i, j, first, last;
+	ui4			max_block_samples;
+
+
+	// decodes READ_PLAN_BLOCKS_PER_TASK plan blocks with the calling thread's RED_PROCESSING_STRUCT; blocks that cannot
+	// be decoded (bad header, CRC or access) are left as RED_NAN
+	args = (READ_PLAN_TASK_ARGS *) task_args;
+	rps = args->rps[thread_number];
+	max_block_samples = args->channel->metadata.time_series_section_2->maximum_block_samples;
+	first = task_number * READ_PLAN_BLOCKS_PER_TASK;
+	last = first + READ_PLAN_BLOCKS_PER_TASK;
+	if (last > args->plan->number_of_blocks)
+		last = args->plan->number_of_blocks;
+
+	for (i = first; i < last; ++i) {
+		if (args->block_decoded[i] == MEF_TRUE)  // copied from the block cache
+			continue;
+		plan_block = args->plan->blocks + i;
+		out = args->samples + plan_block->output_offset;
+		tsi = args->channel->segments[plan_block->segment_number].time_series_indices_fps->time_series_indices + plan_block->block_number;
+		pwd = args->channel->segments[plan_block->segment_number].metadata_fps->password_data;
+		block_header = (RED_BLOCK_HEADER *) args->block_data[i];
+
+		args->block_decoded[i] = MEF_FALSE;
+		if (block_header != NULL && block_header->number_of_samples == tsi->number_of_samples && block_header->number_of_samples <= max_block_samples && block_header->block_bytes >= RED_BLOCK_HEADER_BYTES) {
+			encryption_level = NO_ENCRYPTION;
+			if (block_header->flags & RED_LEVEL_1_ENCRYPTION_MASK)
+				encryption_level = LEVEL_1_ENCRYPTION;
+			else if (block_header->flags & RED_LEVEL_2_ENCRYPTION_MASK)
+				encryption_level = LEVEL_2_ENCRYPTION;
+			if (encryption_level == NO_ENCRYPTION || (pwd != NULL && pwd->access_level >= encryption_level))
+				args->block_decoded[i] = MEF_TRUE;
+			// block CRCs are always validated here, independent of CRC_mode, as the decompress gateways always did
+			if (args->block_decoded[i] == MEF_TRUE)
+				if (CRC_validate((ui1 *) block_header + CRC_BYTES, block_header->block_bytes - CRC_BYTES, block_header->block_CRC) == MEF_FALSE)
+					args->block_decoded[i] = MEF_FALSE;
+		}
+		if (args->block_decoded[i] == MEF_FALSE) {
+			for (j = 0; j < plan_block->number_of_samples; ++j)
+				out[j] = RED_NAN;
+			continue;
+		}
+
+		// decode whole blocks in place, partial blocks via the thread's buffer, & blocks to be cached into their cache entries
+		block_samples = args->cache_samples[i];
+		whole_block = (plan_block->skip_samples == 0 && plan_block->number_of_samples == (si8) block_header->number_of_samples) ? MEF_TRUE : MEF_FALSE;
+		if (block_samples == NULL)
+			block_samples = (whole_block == MEF_TRUE) ? out : rps->decompressed_data;
+		rps->password_data = pwd;
+		rps->compressed_data = (ui1 *) block_header;
+		rps->block_header = block_header;
+		rps->decompressed_ptr = block_samples;
+		RED_decode(rps);
+		if (block_samples != out)
+			memcpy((void *) out, (void *) (block_samples + plan_block->skip_samples), (size_t) plan_block->number_of_samples * sizeof(si4));
 	}
-	
-	
+
+
 	return;
 }
-	       
-	       
-void	RED_encode_exec(RED_PROCESSING_STRUCT *rps, si4 *input_buffer, si1 input_is_detrended)
-{
-	ui4			max_count, extra_bytes, range, r, underflow_bytes, low_bound, temp_ui4;
-	ui4			*counts, *cumulative_counts, scaled_total_counts, *ui4_p1, *ui4_p2;
-        ui1			*compressed_buffer_p, *diff_buffer_p, out_byte, *key, last_byte_val, *last_byte_ptr;
-	sf8			stats_scale;
-	si4			*si4_p1, *si4_p2, diff;
-	si1			*si1_p1, *si1_p2;
-	ui1			*ui1_p, *scaled_counts;
-	si8			i;
-	RED_BLOCK_HEADER	*block_header;
-	
- 
-	// RED compress from input_buffer to to block_header pointer (compressed data array)
-	block_header = rps->block_header;
-	
-        // apply recording time offset time
-        if (MEF_globals->recording_time_offset_mode & (RTO_APPLY | RTO_APPLY_ON_OUTPUT))
-                apply_recording_time_offset(&block_header->start_time);
-        else if (MEF_globals->recording_time_offset_mode & (RTO_REMOVE | RTO_REMOVE_ON_OUTPUT))
-                remove_recording_time_offset(&block_header->start_time);
-	
-	// if no samples: fill in an empty block header & return;
-	if (block_header->number_of_samples <= 0) {
-		block_header->flags = 0;
-		block_header->detrend_slope = block_header->detrend_intercept = block_header->scale_factor = (sf4) 0.0;
-		block_header->difference_bytes = block_header->number_of_samples = (ui4) 0;
-		block_header->block_bytes = RED_BLOCK_HEADER_BYTES;
-		bzero(block_header + RED_BLOCK_STATISTICS_OFFSET, RED_BLOCK_STATISTICS_BYTES);
-		block_header->block_CRC = CRC_calculate((ui1 *) block_header + CRC_BYTES, block_header->block_bytes - CRC_BYTES);
-		(void) fprintf(stderr, "%s(): No samples in block => returning without encoding\n", __FUNCTION__);
-		return;
-	}
-        
-        // detrend from input_buffer to detrended_buffer (lossless)
-	if (rps->directives.detrend_data == MEF_TRUE && input_is_detrended == MEF_FALSE)
-		input_buffer = RED_detrend(rps, input_buffer, rps->detrended_buffer);
-	
-        // scale if scale factor > 1 in block_header (lossy)
-        if (block_header->scale_factor > (sf4) 1.0)
-                input_buffer = RED_scale(rps, input_buffer, rps->scaled_buffer);
-        
-	// generate differences
-        si4_p1 = input_buffer;
-	si4_p2 = si4_p1 + 1;
-	si1_p1 = rps->difference_buffer;  // first 4 bytes are keysample without keysample flag (-128)
-	si1_p2 = (si1 *) si4_p1;
-	*si1_p1++ = *si1_p2++; *si1_p1++ = *si1_p2++; *si1_p1++ = *si1_p2++; *si1_p1++ = *si1_p2;
-	for (i = block_header->number_of_samples; --i;) {
-		diff = *si4_p2++ - *si4_p1++;
-		if (diff > 127 || diff < -127) {
-			si1_p2 = (si1 *) si4_p1;
-			*si1_p1++ = -128;
-			*si1_p1++ = *si1_p2++; *si1_p1++ = *si1_p2++; *si1_p1++ = *si1_p2++; *si1_p1++ = *si1_p2;
-		} else
-			*si1_p1++ = (si1) diff;
-	}
-	block_header->difference_bytes = (ui4) (si1_p1 - rps->difference_buffer);
-        
-	// generate statistics
-	counts = rps->counts;
-	bzero(counts, RED_BLOCK_STATISTICS_BYTES * sizeof(ui4));
-	ui1_p = (ui1 *) rps->difference_buffer;
-	for (i = block_header->difference_bytes; i--;)
-		++counts[*ui1_p++];
-	ui4_p1 = counts;
-	max_count = *ui4_p1;
-	for (i = RED_BLOCK_STATISTICS_BYTES; --i;)
-		if (*++ui4_p1 > max_count)
-			max_count = *ui4_p1;
-	ui1_p = scaled_counts = block_header->statistics;
-	ui4_p1 = counts;
-	if (max_count > 255) {
-		stats_scale = (sf8) 254.999999999 / (sf8) max_count;
-		for (i = RED_BLOCK_STATISTICS_BYTES; i--; ++ui4_p1) {
-			if (*ui4_p1)
-				*ui1_p++ = (ui1) ceil((sf8) *ui4_p1 * stats_scale);
-			else
-				*ui1_p++ = 0;
+
+
+si8	READ_PLAN_execute(CHANNEL *channel, READ_PLAN *plan, si4 *samples, si4 number_of_threads)
+{
+	READ_PLAN_TASK_ARGS		args;
+	FILE_PROCESSING_STRUCT		*fps;
+	TIME_SERIES_INDEX		*tsi;
+	READ_PLAN_BLOCK			*plan_block;
+	BLOCK_CACHE			*cache;
+	RED_BLOCK_HEADER		*block_header;
+	PASSWORD_DATA			*pwd;
+	FILE_PROCESSING_STRUCT		*ranges_fps;
+	FPS_RANGE			*ranges;
+	si1				encryption_level, access_level;
+	si4				n_threads, seg;
+	si8				i, j, k, n_tasks, n_spans, n_ranges, n_to_decode, span_start, span_end, span_bytes, block_bytes, n_failed;
+	si8				*cache_entries;
+	ui1				**spans, *span_data, *segment_UUID;
+	ui4				max_block_samples;
+
+
+	// decodes the plan's blocks into samples (plan->number_of_samples) & fills its gaps with RED_NAN
+	// blocks in the global block cache (if any) are copied from it, & the blocks decoded are added to it
+	// returns the number of blocks that could not be decoded (also RED_NAN), or -1 if the data could not be read
+	for (i = 0; i < plan->number_of_gaps; ++i)
+		for (j = plan->gaps[i].output_offset, k = j + plan->gaps[i].number_of_samples; j < k; ++j)
+			samples[j] = RED_NAN;
+	if (plan->number_of_blocks == 0)
+		return(0);
+
+	args.block_data = (ui1 **) e_calloc((size_t) plan->number_of_blocks, sizeof(ui1 *), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	args.block_decoded = (si1 *) e_calloc((size_t) plan->number_of_blocks, sizeof(si1), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	args.cache_samples = (si4 **) e_calloc((size_t) plan->number_of_blocks, sizeof(si4 *), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	cache_entries = (si8 *) e_malloc((size_t) plan->number_of_blocks * sizeof(si8), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	for (i = 0; i < plan->number_of_blocks; ++i)
+		cache_entries[i] = BLOCK_CACHE_NO_ENTRY;
+
+	// copy the cached blocks
+	cache = MEF_globals->block_cache;
+	n_to_decode = plan->number_of_blocks;
+	if (cache != NULL && cache->maximum_bytes > 0) {
+		for (i = 0; i < plan->number_of_blocks; ++i) {
+			plan_block = plan->blocks + i;
+			segment_UUID = channel->segments[plan_block->segment_number].time_series_data_fps->universal_header->file_UUID;
+			pwd = channel->segments[plan_block->segment_number].metadata_fps->password_data;
+			access_level = (pwd == NULL) ? LEVEL_0_ACCESS : pwd->access_level;
+			if (BLOCK_CACHE_copy(cache, segment_UUID, plan_block->block_number, access_level, samples + plan_block->output_offset, plan_block->skip_samples, plan_block->number_of_samples) == MEF_TRUE) {
+				args.block_decoded[i] = MEF_TRUE;
+				--n_to_decode;
+			}
 		}
-	} else {
-		for (i = RED_BLOCK_STATISTICS_BYTES; i--;)
-			*ui1_p++ = (ui1) *ui4_p1++;
-	}
-	*(ui4_p1 = cumulative_counts = rps->counts) = 0;
-	ui4_p2 = ui4_p1 + 1;
-	ui1_p = scaled_counts;
-	for (i = RED_BLOCK_STATISTICS_BYTES; i--;)
-		*ui4_p2++ = (ui4) *ui1_p++ + *ui4_p1++;
-	scaled_total_counts = *ui4_p1;
-	
-	// range encode
-	low_bound = out_byte = underflow_bytes = 0;
-	range = TOP_VALUE;
-	last_byte_val = *(last_byte_ptr = compressed_buffer_p = ((ui1 *) rps->block_header + RED_BLOCK_HEADER_BYTES - 1)); // first byte is junk - save & overwrite last statistics byte
-	diff_buffer_p = (ui1 *) rps->difference_buffer;
-	for(i = block_header->difference_bytes; i--; ++diff_buffer_p) {
-                while (range <= BOTTOM_VALUE) {
-                        if (low_bound < CARRY_CHECK) {
-                                *compressed_buffer_p++ = out_byte;
-                                for (; underflow_bytes; --underflow_bytes)
-                                        *compressed_buffer_p++ = 0xff;
-                                out_byte = (ui1) (low_bound >> SHIFT_BITS);
-                        } else if (low_bound & TOP_VALUE) {
-                                *compressed_buffer_p++ = out_byte + 1;
-                                for (; underflow_bytes; --underflow_bytes)
-                                        *compressed_buffer_p++ = 0;
-                                out_byte = (ui1) (low_bound >> SHIFT_BITS);
-                        } else
-                                ++underflow_bytes;
-                        range <<= 8;
-                        low_bound = (low_bound << 8) & TOP_VALUE_MINUS_1;
-                }
-                low_bound += (temp_ui4 = (r = range / scaled_total_counts) * cumulative_counts[*diff_buffer_p]);
-                if (*diff_buffer_p < 0xff)
-                        range = r * (ui4) scaled_counts[*diff_buffer_p];
-                else
-                        range -= temp_ui4;
-        }
-	while (range <= BOTTOM_VALUE) {
-		if (low_bound < CARRY_CHECK) {
-			*compressed_buffer_p++ = out_byte;
-			for (; underflow_bytes; --underflow_bytes)
-				*compressed_buffer_p++ = 0xff;
-			out_byte = (ui1) (low_bound >> SHIFT_BITS);
-		} else if (low_bound & TOP_VALUE) {
-			*compressed_buffer_p++ = out_byte + 1;
-			for (; underflow_bytes; --underflow_bytes)
-				*compressed_buffer_p++ = 0;
-			out_byte = (ui1) (low_bound >> SHIFT_BITS);
-		} else
-			++underflow_bytes;
-		range <<= 8;
-		low_bound = (low_bound << 8) & TOP_VALUE_MINUS_1;
 	}
-	temp_ui4 = (low_bound >> SHIFT_BITS) + 1;
-	if (temp_ui4 > 0xff) {
-		*compressed_buffer_p++ = out_byte + 1;
-		for (; underflow_bytes; --underflow_bytes)
-			*compressed_buffer_p++ = 0;
-	} else {
-		*compressed_buffer_p++ = out_byte;
-		for (; underflow_bytes; --underflow_bytes)
-			*compressed_buffer_p++ = 0xff;
+
+	// read each span of consecutive (uncached) blocks of a segment at once (or point into the data if it is in memory);
+	// the spans of a segment are read together, those close in the file with one call
+	spans = (ui1 **) e_calloc((size_t) plan->number_of_blocks, sizeof(ui1 *), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	ranges = (FPS_RANGE *) e_calloc((size_t) plan->number_of_blocks, sizeof(FPS_RANGE), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	ranges_fps = NULL;
+	n_spans = n_ranges = 0;
+	n_failed = -1;
+	for (i = 0; i < plan->number_of_blocks; i = j) {
+		if (args.block_decoded[i] == MEF_TRUE) {
+			j = i + 1;
+			continue;
+		}
+		seg = plan->blocks[i].segment_number;
+		tsi = channel->segments[seg].time_series_indices_fps->time_series_indices;
+		fps = channel->segments[seg].time_series_data_fps;
+		for (j = i + 1; j < plan->number_of_blocks; ++j)
+			if (args.block_decoded[j] == MEF_TRUE || plan->blocks[j].segment_number != seg || plan->blocks[j].block_number != plan->blocks[j - 1].block_number + 1)
+				break;
+		span_start = tsi[plan->blocks[i].block_number].file_offset;
+		span_end = tsi[plan->blocks[j - 1].block_number].file_offset + (si8) tsi[plan->blocks[j - 1].block_number].block_bytes;
+		span_bytes = span_end - span_start;
+		if (span_start < UNIVERSAL_HEADER_BYTES || span_bytes <= 0 || (fps->file_length > 0 && span_end > fps->file_length))
+			goto READ_PLAN_EXECUTE_DONE;
+
+		// the range decoder reads ahead past the end of a block's data
+		if (fps->raw_data != NULL && span_end + READ_PLAN_BLOCK_PAD_BYTES <= fps->raw_data_bytes) {
+			span_data = fps->raw_data + span_start;
+		} else {
+			if (ranges_fps != fps) {
+				if (n_ranges > 0 && READ_PLAN_read_spans(ranges_fps, ranges, n_ranges) != 0)
+					goto READ_PLAN_EXECUTE_DONE;
+				ranges_fps = fps;
+				n_ranges = 0;
+			}
+			span_data = spans[n_spans++] = (ui1 *) e_calloc((size_t) (span_bytes + READ_PLAN_BLOCK_PAD_BYTES), sizeof(ui1), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+			ranges[n_ranges].file_offset = span_start;
+			ranges[n_ranges].bytes = span_bytes;
+			ranges[n_ranges++].data = (void *) span_data;
+		}
+		for (k = i; k < j; ++k)
+			args.block_data[k] = span_data + (tsi[plan->blocks[k].block_number].file_offset - span_start);
 	}
-	*compressed_buffer_p++ = temp_ui4 & 0xff;
-        *compressed_buffer_p++ = 0;
-	
-	// replace last statistics byte
-	*last_byte_ptr = last_byte_val;
-        
-        // add one for uncoded initial keysample flag - need that byte allocated in decode
-        ++block_header->difference_bytes;
-        
-        // align to 8-byte boundary
-	block_header->block_bytes = (ui4) (compressed_buffer_p - (ui1 *) block_header);
-	extra_bytes = block_header->block_bytes % 8;
-	if (extra_bytes) {
-		extra_bytes = 8 - extra_bytes;
-		for (i = extra_bytes; i--;)
-			*compressed_buffer_p++ = PAD_BYTE_VALUE;
-                block_header->block_bytes += extra_bytes;
+	if (n_ranges > 0 && READ_PLAN_read_spans(ranges_fps, ranges, n_ranges) != 0)
+		goto READ_PLAN_EXECUTE_DONE;
+
+	// check the blocks read
+	for (k = 0; k < plan->number_of_blocks; ++k) {
+		if (args.block_data[k] == NULL)
+			continue;
+		seg = plan->blocks[k].segment_number;
+		tsi = channel->segments[seg].time_series_indices_fps->time_series_indices + plan->blocks[k].block_number;
+		block_header = (RED_BLOCK_HEADER *) args.block_data[k];
+		block_bytes = (si8) tsi->block_bytes;
+		if (block_bytes < RED_BLOCK_HEADER_BYTES || block_header->block_bytes != block_bytes) {
+			args.block_data[k] = NULL;
+			continue;
+		}
+
+		// claim a cache entry to decode the whole block into
+		if (cache != NULL && cache->maximum_bytes > 0) {
+			encryption_level = NO_ENCRYPTION;
+			if (block_header->flags & RED_LEVEL_1_ENCRYPTION_MASK)
+				encryption_level = LEVEL_1_ENCRYPTION;
+			else if (block_header->flags & RED_LEVEL_2_ENCRYPTION_MASK)
+				encryption_level = LEVEL_2_ENCRYPTION;
+			segment_UUID = channel->segments[seg].time_series_data_fps->universal_header->file_UUID;
+			cache_entries[k] = BLOCK_CACHE_insert(cache, segment_UUID, plan->blocks[k].block_number, (si8) tsi->number_of_samples, encryption_level, &args.cache_samples[k]);
+		}
 	}
 
-        // flags
-        block_header->flags = 0;
-        
-        // encrypt
-        if (rps->directives.encryption_level > NO_ENCRYPTION) {
-                if (rps->password_data->access_level >= rps->directives.encryption_level) {
-                        if (rps->directives.encryption_level == LEVEL_1_ENCRYPTION) {
-                                key = rps->password_data->level_1_encryption_key;
-				block_header->flags |= RED_LEVEL_1_ENCRYPTION_MASK;
-				block_header->flags &= ~RED_LEVEL_2_ENCRYPTION_MASK;
-			} else {
-                                key = rps->password_data->level_2_encryption_key;
-				block_header->flags &= ~RED_LEVEL_1_ENCRYPTION_MASK;
-				block_header->flags |= RED_LEVEL_2_ENCRYPTION_MASK;
+	// decode
+	n_failed = 0;
+	if (n_to_decode > 0) {
+		n_tasks = (plan->number_of_blocks + READ_PLAN_BLOCKS_PER_TASK - 1) / READ_PLAN_BLOCKS_PER_TASK;
+		n_threads = THREAD_number_of_threads(number_of_threads, n_tasks);
+		if (n_threads > 1) {
+			if (MEF_globals->CRC_table == NULL)  // initialize shared tables before the workers use them
+				(void) CRC_initialize_table(MEF_TRUE);
+			if (MEF_globals->AES_rsbox_table == NULL)
+				(void) AES_initialize_rsbox_table(MEF_TRUE);
+		}
+		max_block_samples = channel->metadata.time_series_section_2->maximum_block_samples;
+		args.rps = (RED_PROCESSING_STRUCT **) e_calloc((size_t) n_threads, sizeof(RED_PROCESSING_STRUCT *), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+		for (i = 0; i < n_threads; ++i) {
+			args.rps[i] = RED_allocate_processing_struct(0, 0, max_block_samples, RED_MAX_DIFFERENCE_BYTES(max_block_samples), 0, 0, NULL);
+			args.rps[i]->compression.mode = RED_DECOMPRESSION;
+		}
+		args.channel = channel;
+		args.plan = plan;
+		args.samples = samples;
+		(void) THREAD_run_tasks(READ_PLAN_decode_task, (void *) &args, n_tasks, n_threads);
+
+		for (i = 0; i < plan->number_of_blocks; ++i)
+			if (args.block_decoded[i] != MEF_TRUE)
+				++n_failed;
+		for (i = 0; i < n_threads; ++i) {
+			args.rps[i]->compressed_data = NULL;  // points into the read spans
+			RED_free_processing_struct(args.rps[i]);
+		}
+		free((void *) args.rps);
+	}
+
+READ_PLAN_EXECUTE_DONE:
+	// release the claimed cache entries, dropping those of blocks not decoded
+	for (i = 0; i < plan->number_of_blocks; ++i)
+		if (cache_entries[i] != BLOCK_CACHE_NO_ENTRY)
+			BLOCK_CACHE_release(cache, cache_entries[i], (n_failed >= 0 && args.block_decoded[i] == MEF_TRUE) ? MEF_TRUE : MEF_FALSE);
+	for (i = 0; i < n_spans; ++i)
+		free((void *) spans[i]);
+	free((void *) spans);
+	free((void *) ranges);
+	free((void *) args.block_data);
+	free((void *) args.block_decoded);
+	free((void *) args.cache_samples);
+	free((void *) cache_entries);
+
+
+	return(n_failed);
+}
+
+
+si8	READ_PLAN_execute_batch(CHANNEL *channel, READ_PLAN *plans, si8 number_of_plans, si4 **samples, si4 number_of_threads)
+{
+	READ_PLAN		merged = {0};
+	READ_PLAN_BLOCK		*plan_block, *merged_block;
+	si4			*decoded;
+	si8			i, j, k, n_blocks, n_failed;
+
+
+	// executes several plans of a channel (e.g. epochs) decoding each block they need once: their blocks are merged
+	// into one plan of whole blocks, decoded into a shared buffer, & copied to each plan's samples (samples[i] for plans[i])
+	// returns the number of (merged) blocks that could not be decoded, or -1 if the data could not be read
+	for (n_blocks = i = 0; i < number_of_plans; ++i)
+		n_blocks += plans[i].number_of_blocks;
+	if (n_blocks) {
+		merged.blocks = (READ_PLAN_BLOCK *) e_calloc((size_t) n_blocks, sizeof(READ_PLAN_BLOCK), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+		merged.allocated_blocks = n_blocks;
+		for (k = i = 0; i < number_of_plans; ++i)
+			for (j = 0; j < plans[i].number_of_blocks; ++j)
+				merged.blocks[k++] = plans[i].blocks[j];
+		qsort((void *) merged.blocks, (size_t) n_blocks, sizeof(READ_PLAN_BLOCK), READ_PLAN_compare_blocks);
+		for (k = i = 0; i < n_blocks; ++i) {
+			if (k && READ_PLAN_compare_blocks((void *) (merged.blocks + k - 1), (void *) (merged.blocks + i)) == 0)
+				continue;
+			merged_block = merged.blocks + k++;
+			*merged_block = merged.blocks[i];
+			merged_block->skip_samples = 0;
+			merged_block->number_of_samples = (si8) channel->segments[merged_block->segment_number].time_series_indices_fps->time_series_indices[merged_block->block_number].number_of_samples;
+			merged_block->output_offset = merged.number_of_samples;
+			merged.number_of_samples += merged_block->number_of_samples;
+		}
+		merged.number_of_blocks = k;
+	}
+
+	decoded = NULL;
+	n_failed = 0;
+	if (merged.number_of_samples) {
+		decoded = (si4 *) e_malloc((size_t) merged.number_of_samples * sizeof(si4), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+		n_failed = READ_PLAN_execute(channel, &merged, decoded, number_of_threads);
+	}
+	if (n_failed >= 0) {
+		for (i = 0; i < number_of_plans; ++i) {
+			for (j = 0; j < plans[i].number_of_gaps; ++j)
+				for (k = 0; k < plans[i].gaps[j].number_of_samples; ++k)
+					samples[i][plans[i].gaps[j].output_offset + k] = RED_NAN;
+			for (j = 0; j < plans[i].number_of_blocks; ++j) {
+				plan_block = plans[i].blocks + j;
+				merged_block = (READ_PLAN_BLOCK *) bsearch((void *) plan_block, (void *) merged.blocks, (size_t) merged.number_of_blocks, sizeof(READ_PLAN_BLOCK), READ_PLAN_compare_blocks);
+				memcpy((void *) (samples[i] + plan_block->output_offset), (void *) (decoded + merged_block->output_offset + plan_block->skip_samples), (size_t) plan_block->number_of_samples * sizeof(si4));
 			}
-                        AES_encrypt(block_header->statistics, block_header->statistics, NULL, key);
-                } else {
-                        (void) fprintf(stderr, "%c\n%s(): Cannot encrypt data => returning without encrypting\n", 7, __FUNCTION__);
-                }
-	} else {
-		block_header->flags &= ~RED_LEVEL_1_ENCRYPTION_MASK;
-		block_header->flags &= ~RED_LEVEL_2_ENCRYPTION_MASK;
-		rps->directives.encryption_level = NO_ENCRYPTION;
-	}
-        
-        // discontinuity
-	if (rps->directives.discontinuity == MEF_TRUE) {
-                block_header->flags |= RED_DISCONTINUITY_MASK;
-		if (rps->directives.reset_discontinuity == MEF_TRUE)
-			rps->directives.discontinuity = MEF_FALSE;
+		}
 	}
-	
-        // calculate CRC
-        block_header->block_CRC = CRC_calculate((ui1 *) block_header + CRC_BYTES, block_header->block_bytes - CRC_BYTES);
-	
-	
+
+	if (decoded != NULL)
+		free((void *) decoded);
+	READ_PLAN_free(&merged, MEF_FALSE);
+
+
+	return(n_failed);
+}
+
+
+void	READ_PLAN_free(READ_PLAN *plan, si4 free_plan_structure)
+{
+	if (plan == NULL)
+		return;
+
+	if (plan->blocks != NULL)
+		free((void *) plan->blocks);
+	if (plan->gaps != NULL)
+		free((void *) plan->gaps);
+
+	if (free_plan_structure == MEF_TRUE)
+		free((void *) plan);
+	else
+		bzero((void *) plan, sizeof(READ_PLAN));
+
+
 	return;
 }
 
 
-void 	RED_encode_lossy(RED_PROCESSING_STRUCT *rps)
+si8	READ_PLAN_place_blocks(READ_PLAN *plan, CHANNEL *channel, si4 segment_number, si8 first_block, si8 last_block, si8 slot_offset, si8 covered)
 {
-	si1			input_is_detrended, compression_mode;
-	si8			i;
-        si4			*input_buffer;
-	sf8			original_size, goal_compression_ratio, r;
-	sf8			low_sf, high_sf, mrr, mrr2, mrr5, sf_per_mrr;
-	sf8			goal_low_bound, goal_high_bound, goal_mrr, goal_tol;
-	sf4			new_scale_factor;
-	RED_BLOCK_HEADER	*block_header;
-	
-	mrr = 0;
+	si8			b, low, high, mid, n, skip, block_slot, segment_start_sample;
+	TIME_SERIES_INDEX	*tsi;
+	READ_PLAN_BLOCK		*plan_block;
+
+
+	// places blocks [first_block, last_block] of a segment at output slot (slot_offset + channel start sample), after the
+	// output already covered; gaps before a block are added, & the new covered output is returned
+	tsi = channel->segments[segment_number].time_series_indices_fps->time_series_indices;
+	segment_start_sample = channel->segments[segment_number].metadata_fps->metadata.time_series_section_2->start_sample;
+	slot_offset += segment_start_sample;
+
+	// first block ending after the covered output
+	low = first_block;
+	high = last_block + 1;
+	while (low < high) {
+		mid = low + ((high - low) >> 1);
+		if (slot_offset + tsi[mid].start_sample + (si8) tsi[mid].number_of_samples <= covered)
+			low = mid + 1;
+		else
+			high = mid;
+	}
 
+	for (b = low; b <= last_block; ++b) {
+		block_slot = slot_offset + tsi[b].start_sample;
+		if (block_slot >= plan->number_of_samples)
+			break;
+		n = (si8) tsi[b].number_of_samples;
+		if (block_slot + n > plan->number_of_samples)
+			n = plan->number_of_samples - block_slot;
+		skip = (block_slot < covered) ? covered - block_slot : 0;  // overlaps the previous entry (timestamp jitter) or precedes the output
+		if (skip >= n)
+			continue;
 
-	// RED compress from original_ptr to block_header pointer (compressed data array)
-	input_buffer = rps->original_ptr;
-	block_header = rps->block_header;
-	
-	// detrend data from original_ptr to detrended_buffer
-	if (rps->directives.detrend_data == MEF_TRUE) {
-		input_buffer = RED_detrend(rps, input_buffer, rps->detrended_buffer);
-		input_is_detrended = MEF_TRUE;
-	} else {
-		input_is_detrended = MEF_FALSE;
+		if (block_slot + skip > covered)
+			READ_PLAN_add_gap(plan, covered, (block_slot + skip) - covered);
+		if (plan->number_of_blocks == plan->allocated_blocks) {
+			plan->allocated_blocks = (plan->allocated_blocks) ? plan->allocated_blocks << 1 : 64;
+			plan->blocks = (READ_PLAN_BLOCK *) e_realloc((void *) plan->blocks, (size_t) plan->allocated_blocks * sizeof(READ_PLAN_BLOCK), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+		}
+		plan_block = plan->blocks + plan->number_of_blocks++;
+		plan_block->segment_number = segment_number;
+		plan_block->block_number = b;
+		plan_block->skip_samples = skip;
+		plan_block->number_of_samples = n - skip;
+		plan_block->output_offset = block_slot + skip;
+		covered = block_slot + n;
 	}
-        
-        // check block normality
-        compression_mode = rps->compression.mode;
-        if (rps->directives.require_normality == MEF_TRUE) {
-                r = RED_test_normality(input_buffer, block_header->number_of_samples);
-		if (r < rps->directives.normal_correlation)
-                        compression_mode = RED_LOSSLESS_COMPRESSION;
-        }
-	
-	// RED encode
-	switch(compression_mode) {
-		case RED_LOSSLESS_COMPRESSION:
-			block_header->scale_factor = (sf4) 1.0; // fall through to RED_FIXED_SCALE_FACTOR
-		case RED_FIXED_SCALE_FACTOR:
-			RED_encode_exec(rps, input_buffer, input_is_detrended);
-			break;
-		case RED_FIXED_COMPRESSION_RATIO:
-			goal_compression_ratio = rps->compression.goal_compression_ratio;
-			goal_low_bound = goal_compression_ratio - rps->compression.goal_tolerance;
-			goal_high_bound = goal_compression_ratio + rps->compression.goal_tolerance;
-			block_header->scale_factor = (sf4) 1.0;
-			RED_encode_exec(rps, input_buffer, input_is_detrended);
-			original_size = (sf8) block_header->number_of_samples * (sf8) sizeof(si4);
-			rps->compression.actual_compression_ratio = (sf8) block_header->block_bytes / original_size;
-			if (rps->compression.actual_compression_ratio <= goal_high_bound)
-				break;
-			// loop until acceptable scale factor found
-			for (i = rps->compression.maximum_rounds_per_block; i--;) {
-				new_scale_factor = block_header->scale_factor * (sf4) (rps->compression.actual_compression_ratio / goal_compression_ratio);
-				if ((ABS(new_scale_factor - block_header->scale_factor) <= (sf4) 0.000001) || (new_scale_factor <= (sf4) 1.0))
-					break;
-				block_header->scale_factor = new_scale_factor;
-				RED_encode_exec(rps, input_buffer, input_is_detrended);
-				rps->compression.actual_compression_ratio = (sf8) block_header->block_bytes / original_size;
-				if ((rps->compression.actual_compression_ratio <= goal_high_bound) && (rps->compression.actual_compression_ratio >= goal_low_bound))
-					break;
-			}
-			break;
-		case RED_MEAN_RESIDUAL_RATIO:
-                        // get residual ratio at sf 2 & 5 (roughly linear relationship: reasonable sample points)
-                        block_header->scale_factor = (sf4) 2.0;
-                        RED_generate_lossy_data(rps, input_buffer, rps->decompressed_ptr, input_is_detrended);
-                        mrr2 = RED_calculate_mean_residual_ratio(rps->original_ptr, rps->decompressed_ptr, block_header->number_of_samples);
-                        if (mrr2 == (sf8) 0.0) {  // all zeros in block
-                                block_header->scale_factor = (sf4) 1.0;
-                                rps->compression.actual_mean_residual_ratio = (sf8) 0.0;
-                                RED_encode_exec(rps, input_buffer, input_is_detrended);
-                                break;
-                        }
-                        block_header->scale_factor = (sf4) 5.0;
-                        RED_generate_lossy_data(rps, input_buffer, rps->decompressed_ptr, input_is_detrended);
-                        mrr5 = RED_calculate_mean_residual_ratio(rps->original_ptr, rps->decompressed_ptr, block_header->number_of_samples);
-                        sf_per_mrr = (sf8) 3.0 / (mrr5 - mrr2);
-                        // estimate starting points
-                        goal_mrr = rps->compression.goal_mean_residual_ratio;
-                        goal_tol = rps->compression.goal_tolerance;
-                        goal_low_bound = goal_mrr - goal_tol;
-                        goal_high_bound = goal_mrr + goal_tol;
-                        block_header->scale_factor = (sf4) (((goal_mrr - mrr2) * sf_per_mrr) + (sf8) 2.0);
-                        high_sf = ((goal_high_bound - mrr2) * sf_per_mrr) + (sf8) 2.0;
-                        high_sf *= (sf8) 2.0;  // empirically reasonable
-                        low_sf = (sf8) 1.0;
-			for (i = rps->compression.maximum_rounds_per_block; i--;) {
-				RED_generate_lossy_data(rps, input_buffer, rps->decompressed_ptr, input_is_detrended);
-				mrr = RED_calculate_mean_residual_ratio(rps->original_ptr, rps->decompressed_ptr, block_header->number_of_samples);
-				if (mrr < goal_low_bound)
-					low_sf = (sf8) block_header->scale_factor;
-				else if (mrr > goal_high_bound)
-					high_sf = (sf8) block_header->scale_factor;
-                                else
-                                        break;
-                                new_scale_factor = (sf4) ((low_sf + high_sf) / (sf8) 2.0);
-                                if (new_scale_factor <= (sf4) 1.0)
-                                        break;
-                                if ((high_sf - low_sf) < (sf8) 0.005) {
-                                        block_header->scale_factor = new_scale_factor;
-                                        break;
-                                }
-                                block_header->scale_factor = new_scale_factor;
-			}
-			rps->compression.actual_mean_residual_ratio = mrr;
-			RED_encode_exec(rps, input_buffer, input_is_detrended);
-			break;
-		default:
-			(void) fprintf(stderr, "%c\n%s(): unrecognized compression mode (%d) => exiting\n", 7, __FUNCTION__, rps->compression.mode);
-			exit(1);
-			break;
-	}
-	
-	// generate lossy data from input_buffer to decompressed_ptr
-	if (rps->directives.return_lossy_data == MEF_TRUE)
-		RED_generate_lossy_data(rps, input_buffer, rps->decompressed_ptr, input_is_detrended);
-	
-	
-	return;
-}
 
 
-void	RED_filter(FILT_PROCESSING_STRUCT *filtps)
-{
-	si4	*si4_p;
-	si8	i;
-	sf8	*sf8_p;
-	
-	
-	// filter
-	FILT_filtfilt(filtps);
-	
-	// make si4 version of filtered data
-	si4_p = filtps->filt_data;
-	sf8_p = filtps->sf8_filt_data;
-	for (i = filtps->data_length; i--;)
-		*si4_p++ = RED_round(*sf8_p++);
-	
-	
-	return;
+	return(covered);
 }
 
 
-void	RED_find_extrema(si4 *buffer, si8 number_of_samples, TIME_SERIES_INDEX *tsi)
+si4	READ_PLAN_read_spans(FILE_PROCESSING_STRUCT *fps, FPS_RANGE *ranges, si8 number_of_ranges)
 {
-	si4	min, max;
-	si8	i;
-	
-	
-	min = max = *buffer;
-	for (i = number_of_samples - 1; i--;) {
-		if (*++buffer > max)
-			max = *buffer;
-		else if (*buffer < min)
-			min = *buffer;
+	si1	opened_file;
+	si8	i, bytes, range_bytes;
+
+
+	// reads spans of blocks from a segment's data file, opening it if it is closed; returns 0, or -1 on failure
+	opened_file = MEF_FALSE;
+	if (fps->fp == NULL) {
+		fps->directives.open_mode = FPS_R_OPEN_MODE;
+		if (fps_open(fps, __FUNCTION__, __LINE__, RETURN_ON_FAIL | SUPPRESS_ERROR_OUTPUT) != 0 || fps->fp == NULL)
+			return(-1);
+		opened_file = MEF_TRUE;
 	}
-	
-	tsi->maximum_sample_value = max;
-	tsi->minimum_sample_value = min;
+	bytes = fps_read_ranges(fps, ranges, number_of_ranges, __FUNCTION__, __LINE__, RETURN_ON_FAIL | SUPPRESS_ERROR_OUTPUT);
+	if (opened_file == MEF_TRUE)
+		fps_close(fps);
 
-	
-	return;
+	for (range_bytes = i = 0; i < number_of_ranges; ++i)
+		range_bytes += ranges[i].bytes;
+
+
+	return((bytes == range_bytes) ? 0 : -1);
 }
 
 
-void	RED_free_processing_struct(RED_PROCESSING_STRUCT *rps)
+si8	READ_PLAN_samples_in_time(si8 microseconds, sf8 sampling_frequency)
 {
-	if (rps->original_data != NULL)
-		free(rps->original_data);
-	
-	if (rps->decompressed_data != NULL)
-		free(rps->decompressed_data);
-	
-	if (rps->compressed_data != NULL)
-		free(rps->compressed_data);
-	
-	if (rps->difference_buffer != NULL)
-		free(rps->difference_buffer);
-	
-	if (rps->detrended_buffer != NULL)
-		free(rps->detrended_buffer);
-	
-	if (rps->scaled_buffer != NULL)
-		free(rps->scaled_buffer);
-	
-	free(rps);
-	
-        
-	return;
-}
+	si8	whole_frequency, scaled;
 
 
-void	RED_generate_lossy_data(RED_PROCESSING_STRUCT *rps, si4 *input_buffer, si4 *output_buffer, si1 input_is_detrended)
-{	
-	
-        // generates lossy data from input_buffer to output_buffer
-	// if input_buffer == output_buffer lossy data will be made in place
-        	
-	// detrend from input_buffer to output_buffer (lossless)
-	if (rps->directives.detrend_data == MEF_TRUE && input_is_detrended == MEF_FALSE) {
-		input_buffer = RED_detrend(rps, input_buffer, output_buffer);
-		input_is_detrended = MEF_TRUE;
+	// rounded to the nearest sample (halves up, as floor(x + 0.5)); exact integer arithmetic if the sampling frequency is whole
+	whole_frequency = (si8) sampling_frequency;
+	if ((sf8) whole_frequency == sampling_frequency && whole_frequency > 0 && ABS(microseconds) < ((si8) 0x7FFFFFFFFFFFFFFF - (si8) 500000) / whole_frequency) {
+		scaled = (microseconds * whole_frequency) + (si8) 500000;
+		if (scaled >= 0)
+			return(scaled / (si8) 1000000);
+		return(-((-scaled + (si8) 999999) / (si8) 1000000));
 	}
 
-        // scale from input_buffer to output_buffer (lossy)
-	input_buffer = RED_scale(rps, input_buffer, output_buffer);
-                
-	// unscale from input_buffer to output_buffer
-	input_buffer = RED_unscale(rps, input_buffer, output_buffer);
-	
-        // retrend from input_buffer to output_buffer
-	if (input_is_detrended == MEF_TRUE)
-		RED_retrend(rps, input_buffer, output_buffer);
 
-	
-        return;
+	return((si8) floor((((sf8) microseconds * sampling_frequency) / (sf8) 1000000.0) + 0.5));
 }
 
-	       
-sf8	*RED_initialize_normal_CDF_table(si4 global_flag)
+
+READ_PLAN	*READ_PLAN_slice(READ_PLAN *plan, si8 start_sample, si8 end_sample, READ_PLAN *slice)
 {
-	sf8	*cdf_table;
-	
-	
-	cdf_table = (sf8 *) e_calloc((size_t) RED_NORMAL_CDF_TABLE_ENTRIES, sizeof(sf8), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
-	
-	{
-		sf8 temp[RED_NORMAL_CDF_TABLE_ENTRIES] = RED_NORMAL_CDF_TABLE;
-		memcpy(cdf_table, temp, RED_NORMAL_CDF_TABLE_ENTRIES * sizeof(sf8));
-	}
-	
-	if (global_flag == MEF_TRUE) {
-		MEF_globals->RED_normal_CDF_table = cdf_table;
-		return(NULL);
-	}
-	
-	
-	return(cdf_table);
-}
+	READ_PLAN_BLOCK	*block, *slice_block;
+	READ_PLAN_GAP	*gap;
+	si8		i, low, high, mid, first_block, block_start, block_end;
 
 
-si4	*RED_retrend(RED_PROCESSING_STRUCT *rps, si4 *input_buffer, si4 *output_buffer)
-{
-	si4			*si4_p1, *si4_p2;
-	si8			i;
-	sf8			m, b, c;
-	RED_BLOCK_HEADER	*block_header;
-	
-	
-	// retrend data from input_buffer to output_buffer
-	// if input_buffer == output_buffer retrending data will be done in place
-	
-	block_header = rps->block_header;
+	// output samples [start_sample, end_sample) of a plan as a plan of their own, so a long read can be executed a
+	// window at a time with the same placement (the blocks at the window edges are trimmed)
+	if (slice == NULL)
+		slice = (READ_PLAN *) e_calloc((size_t) 1, sizeof(READ_PLAN), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	else
+		READ_PLAN_free(slice, MEF_FALSE);
+	slice->start_time = slice->end_time = UUTC_NO_ENTRY;
+	if (start_sample < 0)
+		start_sample = 0;
+	if (end_sample > plan->number_of_samples)
+		end_sample = plan->number_of_samples;
+	if (end_sample <= start_sample)
+		return(slice);
+	slice->number_of_samples = end_sample - start_sample;
+
+	// blocks (in output order, not overlapping): first one ending after start_sample
+	low = 0;
+	high = plan->number_of_blocks;
+	while (low < high) {
+		mid = (low + high) >> 1;
+		block = plan->blocks + mid;
+		if (block->output_offset + block->number_of_samples <= start_sample)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	first_block = low;
+	for (i = first_block; i < plan->number_of_blocks; ++i)
+		if (plan->blocks[i].output_offset >= end_sample)
+			break;
+	slice->number_of_blocks = slice->allocated_blocks = i - first_block;
+	if (slice->number_of_blocks > 0)
+		slice->blocks = (READ_PLAN_BLOCK *) e_calloc((size_t) slice->number_of_blocks, sizeof(READ_PLAN_BLOCK), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	for (i = 0; i < slice->number_of_blocks; ++i) {
+		block = plan->blocks + first_block + i;
+		slice_block = slice->blocks + i;
+		block_start = (block->output_offset > start_sample) ? block->output_offset : start_sample;
+		block_end = block->output_offset + block->number_of_samples;
+		if (block_end > end_sample)
+			block_end = end_sample;
+		*slice_block = *block;
+		slice_block->skip_samples = block->skip_samples + (block_start - block->output_offset);
+		slice_block->number_of_samples = block_end - block_start;
+		slice_block->output_offset = block_start - start_sample;
+	}
 
-	m = (sf8) block_header->detrend_slope;
-	b = (sf8) (sf8) block_header->detrend_intercept;
-	c = (sf8) 0.0;
-	si4_p1 = input_buffer;
-	si4_p2 = output_buffer;
-	for (i = block_header->number_of_samples; i--;) {
-                c += (sf8) 1.0;
-		*si4_p2++ = RED_round( (sf8) *si4_p1++ + (m * c) + b);
+	// gaps
+	for (i = 0; i < plan->number_of_gaps; ++i) {
+		gap = plan->gaps + i;
+		block_start = (gap->output_offset > start_sample) ? gap->output_offset : start_sample;
+		block_end = gap->output_offset + gap->number_of_samples;
+		if (block_end > end_sample)
+			block_end = end_sample;
+		if (block_end > block_start)
+			READ_PLAN_add_gap(slice, block_start - start_sample, block_end - block_start);
 	}
-	
 
-	return(output_buffer);
+
+	return(slice);
 }
 
 
-inline si4 RED_round(sf8 val)
-{
-	if (val >= 0.0) {
-		if ((val += 0.5) >= (sf8) RED_POSITIVE_INFINITY)
-			return(RED_POSITIVE_INFINITY);
-	} else {
-		if ((val -= 0.5) <= (sf8) RED_NEGATIVE_INFINITY)
-			return(RED_NEGATIVE_INFINITY);
-	}
-	
-	
-	return((si4) val);
-}
+/*************************************************************************/
+/*************************  END READ PLAN FUNCTIONS  *********************/
+/*************************************************************************/
 
 
-si4	*RED_scale(RED_PROCESSING_STRUCT *rps, si4 *input_buffer, si4 *output_buffer)
+si4	reallocate_file_processing_struct(FILE_PROCESSING_STRUCT *fps, si8 raw_data_bytes)
 {
-        si4	*si4_p1, *si4_p2;
-        si8	i;
-        sf8	sf;
+	void	*data_ptr;
+	ui1	*arena_data;
 	
 	
-	// scale from input_buffer to output_buffer
-	// if input_buffer == output_buffer scaling will be done in place
+	// reallocate (arena raw data is copied to new arena memory: zeroed, so only the copy is needed)
+	if (fps->arena != NULL) {
+		arena_data = (ui1 *) ARENA_calloc(fps->arena, (size_t) raw_data_bytes, sizeof(ui1), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+		memcpy((void *) arena_data, (void *) fps->raw_data, (size_t) ((raw_data_bytes < fps->raw_data_bytes) ? raw_data_bytes : fps->raw_data_bytes));
+		fps->raw_data = arena_data;
+	} else {
+		fps->raw_data = (ui1 *) e_realloc((void *) fps->raw_data, (size_t) raw_data_bytes, __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	}
 	
-        si4_p1 = input_buffer;
-        si4_p2 = output_buffer;
-        sf = (sf8) rps->block_header->scale_factor;
-        for (i = rps->block_header->number_of_samples; i--;)
-                *si4_p2++ = RED_round((sf8) *si4_p1++ / sf);
+	// zero additional memory
+	if (raw_data_bytes > fps->raw_data_bytes)
+		bzero(fps->raw_data + fps->raw_data_bytes, raw_data_bytes - fps->raw_data_bytes);
+        fps->raw_data_bytes = raw_data_bytes;
 	
+	// reset universal header pointer
+	if (raw_data_bytes >= UNIVERSAL_HEADER_BYTES)
+		fps->universal_header = (UNIVERSAL_HEADER *) fps->raw_data; // all files start with universal header
+	else
+		return(0);
         
-        return(output_buffer);
+	// set appropriate pointers
+	data_ptr = NULL;
+	if (fps->raw_data != NULL)
+		data_ptr = (ui1 *)fps->raw_data + UNIVERSAL_HEADER_BYTES;
+
+        switch (fps->file_type_code) {
+                case NO_TYPE_CODE:
+                        break;
+                case TIME_SERIES_INDICES_FILE_TYPE_CODE:
+                        fps->time_series_indices = (TIME_SERIES_INDEX *) data_ptr;
+                        break;
+		case TIME_SERIES_METADATA_FILE_TYPE_CODE:
+			fps->metadata.section_1 = (METADATA_SECTION_1 *) data_ptr;
+			fps->metadata.time_series_section_2 = (TIME_SERIES_METADATA_SECTION_2 *) (fps->raw_data + METADATA_SECTION_2_OFFSET);
+			fps->metadata.section_3 = (METADATA_SECTION_3 *) (fps->raw_data + METADATA_SECTION_3_OFFSET);
+			break;
+		case TIME_SERIES_DATA_FILE_TYPE_CODE:
+			fps->RED_blocks = (ui1 *) data_ptr;
+			break;
+                case VIDEO_METADATA_FILE_TYPE_CODE:
+                        fps->metadata.section_1 = (METADATA_SECTION_1 *) data_ptr;
+                        fps->metadata.video_section_2 = (VIDEO_METADATA_SECTION_2 *) (fps->raw_data + METADATA_SECTION_2_OFFSET);
+                        fps->metadata.section_3 = (METADATA_SECTION_3 *) (fps->raw_data + METADATA_SECTION_3_OFFSET);
+                        break;
+                case VIDEO_INDICES_FILE_TYPE_CODE:
+                        fps->video_indices = (VIDEO_INDEX *) data_ptr;
+                	break;
+                case RECORD_DATA_FILE_TYPE_CODE:
+                        fps->records = (ui1 *) data_ptr;
+                        break;
+                case RECORD_INDICES_FILE_TYPE_CODE:
+                        fps->record_indices = (RECORD_INDEX *) data_ptr;
+                        fps->record_indices_order = RECORD_INDICES_ORDER_UNKNOWN;
+                        break;
+                default:
+                        fprintf(stderr, "Error: unrecognized type code \"0x%x\" [function \"%s\", line %d]\n", fps->file_type_code, __FUNCTION__, __LINE__);
+                        if (MEF_context->behavior_on_fail & EXIT_ON_FAIL) {
+                                (void) fprintf(stderr, "\t=> exiting program\n\n");
+        			exit(1);
+                        }
+                        return(-1);
+        }
+	
+        
+	return(0);
 }
 
 
-void	RED_show_block_header(RED_BLOCK_HEADER *bh)
+/*************************************************************************/
+/**************************  RECORD QUERY FUNCTIONS  *********************/
+/*************************************************************************/
+
+
+si4	RECORD_add_query_type(RECORD_QUERY *query, si1 *type_string)
 {
-	si1			hex_str[HEX_STRING_BYTES(RED_BLOCK_STATISTICS_BYTES)], time_str[TIME_STRING_BYTES];
+	si4	i;
+	ui4	type_code;
 	
 	
-	printf("--------------- RED Block Header - START ---------------\n");
-	if (bh->block_CRC == CRC_NO_ENTRY)
-		printf("Block CRC: no entry\n");
-	else {
-		generate_hex_string((ui1 *) &bh->block_CRC, CRC_BYTES, hex_str);
-		printf("Block CRC: %s\n", hex_str);
-	}
-	generate_hex_string((ui1 *) &bh->flags, 1, hex_str);
-	printf("Flags: %s\n", hex_str);
-	printf("Detrend Slope: %f\n", bh->detrend_slope);
-	printf("Detrend Intercept: %f\n", bh->detrend_intercept);
-	printf("Scale Factor: %f\n", bh->scale_factor);
-	printf("Difference Bytes: %u\n", bh->difference_bytes);
-	printf("Number of Samples: %u\n", bh->number_of_samples);
-	printf("Block Bytes: %u\n", bh->block_bytes);
-	if (bh->start_time == UUTC_NO_ENTRY)
-		printf("Start Time: no entry\n");
-	else {
-		local_date_time_string(bh->start_time, time_str);
-		if (bh->start_time < 0)
-			printf("Offset ");
-		#ifdef _WIN32
-			printf("Start Time: %lld (uUTC), %s (ascii, local)\n", ABS(bh->start_time), time_str);
-		#else
-			printf("Start Time: %ld (uUTC), %s (ascii, local)\n", ABS(bh->start_time), time_str);
-		#endif
+	// type strings are 4 characters (no terminal zero needed); type codes are their bytes as a ui4
+	type_code = 0;
+	memcpy((void *) &type_code, (void *) type_string, (size_t) (TYPE_BYTES - 1));
+	for (i = 0; i < query->number_of_type_codes; ++i)
+		if (query->type_codes[i] == type_code)
+			return(0);
+	
+	if (query->number_of_type_codes >= RECORD_QUERY_MAXIMUM_TYPE_CODES) {
+		if (!(MEF_context->behavior_on_fail & SUPPRESS_ERROR_OUTPUT))
+			(void) fprintf(stderr, "%s(), line %d: more than %d record types in query\n", __FUNCTION__, __LINE__, RECORD_QUERY_MAXIMUM_TYPE_CODES);
+		return(-1);
 	}
-	generate_hex_string((ui1 *) &bh->statistics, RED_BLOCK_STATISTICS_BYTES, hex_str);
-	printf("Statistics: %s\n", hex_str);
-	printf("---------------- RED Block Header - END ----------------\n\n");
+	query->type_codes[query->number_of_type_codes++] = type_code;
+	
+	
+	return(0);
+}
 
+
+void	RECORD_free_query_result(RECORD_QUERY_RESULT *result, si4 free_result_structure)
+{
+	if (result == NULL)
+		return;
+	
+	if (result->records != NULL)
+		free((void *) result->records);
+	if (result->matches != NULL)
+		free((void *) result->matches);
+	
+	if (free_result_structure == MEF_TRUE)
+		free((void *) result);
+	else
+		bzero((void *) result, sizeof(RECORD_QUERY_RESULT));
+	
 	
 	return;
 }
 
 
-sf8	RED_test_normality(si4 *data, ui4 n_samps)
+RECORD_QUERY	*RECORD_initialize_query(RECORD_QUERY *query, si8 start_time, si8 end_time)
 {
-	sf8	sx, sx2, sy, sy2, sxy, mx, mx2, sd, val, z, r, n, *norm_cdf;
-	sf8	num, den1, den2, cdf[RED_NORMAL_CDF_TABLE_ENTRIES];
-	si8	i, counts[RED_NORMAL_CDF_TABLE_ENTRIES] = {0};
-        si4	*si4_p, bin;
-        
-        
-        // returns the correlation of the distribution in the data to that expected from a normal distribution
-        
-        // calculate mean & standard deviation
-	n = (sf8) n_samps;
-        si4_p = data;
-        sx = sx2 = (sf8) 0.0;
-        for (i = n_samps; i--;) {
-                val = (sf8) *si4_p++;
-                sx += val;
-                sx2 += val * val;
-        }
-        mx = sx / n;
-        mx2 = sx2 / n;
-        sd = sqrt(mx2 - (mx * mx));
+	if (query == NULL)
+		query = (RECORD_QUERY *) e_calloc((size_t) 1, sizeof(RECORD_QUERY), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	else
+		bzero((void *) query, sizeof(RECORD_QUERY));
 	
-	// bin the samples
-	si4_p = data;
-	for (i = n_samps; i--;) {
-		val = (sf8) *si4_p++;
-		z = (val - mx) / sd;
-		bin = (si4) ((z + (sf8) 3.1) * (sf8) 10.0);
-		if (bin < 0)
-			bin = 0;
-		if (bin >= RED_NORMAL_CDF_TABLE_ENTRIES)
-			continue;
-		++counts[bin];
-	}
+	query->start_time = start_time;
+	query->end_time = end_time;
+	query->number_of_type_codes = 0;  // add types with RECORD_add_query_type()
 	
-	// generate data CDF
-	cdf[0] = (sf8) counts[0] / (sf8) n_samps;
-	for (i = 1; i < RED_NORMAL_CDF_TABLE_ENTRIES; ++i)
-		cdf[i] = (sf8) (counts[i] + counts[i - 1]) / n;
+	
+	return(query);
+}
+
+
+RECORD_QUERY_RESULT	*RECORD_query_file(FILE_PROCESSING_STRUCT *ri_fps, FILE_PROCESSING_STRUCT *rd_fps, RECORD_QUERY *query, RECORD_QUERY_RESULT *result, si4 channel_number, si4 segment_number)
+{
+	si1			opened_file, in_memory, truncated;
+	ui4			*type_code;
+	si8			i, j, first_index, last_index, n_candidates, n_indices, run_start, run_end, run_bytes, time, start_time, end_time;
+	ui1			*run_ptr;
+	RECORD_INDEX		*ri;
+	RECORD_HEADER		*rh;
+	RECORD_QUERY_MATCH	*match;
+	FPS_RANGE		run_range;
+	
+	
+	// matching records are appended to result (allocated if NULL)
+	if (result == NULL)
+		result = (RECORD_QUERY_RESULT *) e_calloc((size_t) 1, sizeof(RECORD_QUERY_RESULT), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	if (ri_fps == NULL || rd_fps == NULL || ri_fps->universal_header == NULL || ri_fps->record_indices == NULL)
+		return(result);
+	
+	n_indices = ri_fps->universal_header->number_of_entries;
+	if (n_indices == UNKNOWN_NUMBER_OF_ENTRIES || n_indices > (ri_fps->raw_data_bytes - UNIVERSAL_HEADER_BYTES) / RECORD_INDEX_BYTES)
+		n_indices = (ri_fps->raw_data_bytes - UNIVERSAL_HEADER_BYTES) / RECORD_INDEX_BYTES;
+	ri = ri_fps->record_indices;
+	
+	// query & index times compare with the recording time offset removed (either may have it applied)
+	start_time = query->start_time;
+	end_time = query->end_time;
+	remove_recording_time_offset(&start_time);
+	remove_recording_time_offset(&end_time);
+	if (ri_fps->index_pages_read == NULL) {
+		n_candidates = RECORD_query_index_range(ri, n_indices, start_time, end_time, &first_index, &ri_fps->record_indices_order);
+	} else {
+		// on demand indices (in time order): search the file, & read the candidates & the index after them (ends a run)
+		first_index = 0;
+		last_index = n_indices - 1;
+		if (start_time != UUTC_NO_ENTRY) {
+			if (fps_find_index_entry(ri_fps, FPS_INDEX_KEY_TIME, start_time - 1, &first_index) < 0)
+				return(result);
+			++first_index;
+		}
+		if (end_time != UUTC_NO_ENTRY && fps_find_index_entry(ri_fps, FPS_INDEX_KEY_TIME, end_time, &last_index) < 0)
+			return(result);
+		n_candidates = (last_index >= first_index) ? last_index - first_index + 1 : 0;
+		if (n_candidates > 0 && fps_read_index_entries(ri_fps, first_index, last_index + 1) < 0)
+			return(result);
+	}
+	
+	opened_file = MEF_FALSE;
+	for (i = first_index; i < first_index + n_candidates; i = run_end + 1) {
+		// skip to the next match
+		run_end = i;
+		time = ri[i].time;
+		if (time != UUTC_NO_ENTRY) {
+			remove_recording_time_offset(&time);
+			if ((start_time != UUTC_NO_ENTRY && time < start_time) || (end_time != UUTC_NO_ENTRY && time > end_time))
+				continue;
+		} else if (start_time != UUTC_NO_ENTRY || end_time != UUTC_NO_ENTRY) {
+			continue;
+		}
+		type_code = (ui4 *) ri[i].type_string;
+		if (RECORD_query_type_matches(query, *type_code) == MEF_FALSE)
+			continue;
 		
-        // calculate correlation between data CDF and normal CDF
-	sx = sx2 = sxy = (sf8) 0.0;
-	sy = (sf8) RED_SUM_NORMAL_CDF;
-	sy2 = (sf8) RED_SUM_SQ_NORMAL_CDF;
-	norm_cdf = MEF_globals->RED_normal_CDF_table;
-	for (i = 0; i < RED_NORMAL_CDF_TABLE_ENTRIES; ++i) {
-		sx += cdf[i];
-		sx2 += cdf[i] * cdf[i];
-		sxy += cdf[i] * norm_cdf[i];
+		// extend the run over following matches that are contiguous in the file (one read per run)
+		run_start = i;
+		while (run_end + 1 < first_index + n_candidates && ri[run_end + 1].file_offset > ri[run_end].file_offset) {
+			time = ri[run_end + 1].time;
+			type_code = (ui4 *) ri[run_end + 1].type_string;
+			remove_recording_time_offset(&time);
+			if (time == UUTC_NO_ENTRY || (start_time != UUTC_NO_ENTRY && time < start_time) || (end_time != UUTC_NO_ENTRY && time > end_time))
+				break;
+			if (RECORD_query_type_matches(query, *type_code) == MEF_FALSE)
+				break;
+			++run_end;
+		}
+		if (run_end + 1 < n_indices && ri[run_end + 1].file_offset > ri[run_end].file_offset)
+			run_bytes = ri[run_end + 1].file_offset - ri[run_start].file_offset;
+		else
+			run_bytes = rd_fps->file_length - ri[run_start].file_offset;
+		if (ri[run_start].file_offset < UNIVERSAL_HEADER_BYTES || run_bytes < RECORD_HEADER_BYTES) {
+			if (!(MEF_context->behavior_on_fail & SUPPRESS_ERROR_OUTPUT))
+				UTF8_fprintf(stderr, "%s(), line %d: invalid record index %ld for file \"%s\"\n", __FUNCTION__, __LINE__, (long) run_start, rd_fps->full_file_name);
+			break;
+		}
+		
+		// make room
+		if (result->records_bytes + run_bytes > result->allocated_records_bytes) {
+			result->allocated_records_bytes = (result->records_bytes + run_bytes) * 2;
+			result->records = (ui1 *) e_realloc((void *) result->records, (size_t) result->allocated_records_bytes, __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+		}
+		if (result->number_of_records + (run_end - run_start + 1) > result->allocated_matches) {
+			result->allocated_matches = (result->number_of_records + (run_end - run_start + 1)) * 2;
+			result->matches = (RECORD_QUERY_MATCH *) e_realloc((void *) result->matches, (size_t) result->allocated_matches * sizeof(RECORD_QUERY_MATCH), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+		}
+		run_ptr = result->records + result->records_bytes;
+		
+		// copy from memory if the record data was read (already decrypted), otherwise read the run
+		in_memory = (rd_fps->records != NULL && ri[run_start].file_offset + run_bytes <= rd_fps->raw_data_bytes) ? MEF_TRUE : MEF_FALSE;
+		if (in_memory == MEF_TRUE) {
+			memcpy((void *) run_ptr, (void *) (rd_fps->raw_data + ri[run_start].file_offset), (size_t) run_bytes);
+		} else {
+			if (rd_fps->fp == NULL) {
+				rd_fps->directives.open_mode = FPS_R_OPEN_MODE;
+				if (fps_open(rd_fps, __FUNCTION__, __LINE__, RETURN_ON_FAIL | SUPPRESS_ERROR_OUTPUT) != 0 || rd_fps->fp == NULL)
+					break;
+				opened_file = MEF_TRUE;
+			}
+			run_range.file_offset = ri[run_start].file_offset;
+			run_range.bytes = run_bytes;
+			run_range.data = (void *) run_ptr;
+			if (fps_read_ranges(rd_fps, &run_range, 1, __FUNCTION__, __LINE__, RETURN_ON_FAIL | SUPPRESS_ERROR_OUTPUT) != run_bytes)
+				break;
+		}
+		
+		// check extents of the whole run (a truncated record ends the query of this file), then CRC check, time offset
+		// & decrypt only the records read
+		truncated = MEF_FALSE;
+		for (j = run_start; j <= run_end; ++j) {
+			rh = (RECORD_HEADER *) (run_ptr + (ri[j].file_offset - ri[run_start].file_offset));
+			if ((ri[j].file_offset - ri[run_start].file_offset) + RECORD_HEADER_BYTES + (si8) rh->bytes > run_bytes) {
+				if (!(MEF_context->behavior_on_fail & SUPPRESS_ERROR_OUTPUT))
+					UTF8_fprintf(stderr, "%s(), line %d: truncated record %ld in file \"%s\"\n", __FUNCTION__, __LINE__, (long) j, rd_fps->full_file_name);
+				truncated = MEF_TRUE;
+				break;
+			}
+		}
+		if (truncated == MEF_TRUE)
+			break;
+		for (j = run_start; j <= run_end; ++j) {
+			rh = (RECORD_HEADER *) (run_ptr + (ri[j].file_offset - ri[run_start].file_offset));
+			if (in_memory == MEF_FALSE)
+				decrypt_record(rh, rd_fps->password_data, j);
+			match = result->matches + result->number_of_records++;
+			match->record_offset = (si8) ((ui1 *) rh - result->records);
+			match->channel_number = channel_number;
+			match->segment_number = segment_number;
+		}
+		result->records_bytes += run_bytes;
 	}
 	
-	num = (n * sxy) - (sx * sy);
-	den1 = (n * sx2) - (sx * sx);
-	den2 = (n * sy2) - (sy * sy);
+	if (opened_file == MEF_TRUE)
+		fps_close(rd_fps);
 	
-	if (den1 <= (sf8) 0.0)
-		r = (sf8) 0.0;
-	else
-		r = num / (sqrt(den1) * sqrt(den2));
 	
-        return(r);
+	return(result);
 }
 
 
-si4	*RED_unscale(RED_PROCESSING_STRUCT *rps, si4 *input_buffer, si4 *output_buffer)
+si8	RECORD_query_index_range(RECORD_INDEX *record_indices, si8 number_of_indices, si8 start_time, si8 end_time, si8 *first_index, si1 *indices_order)
 {
-	si4			*si4_p1, *si4_p2;
-	si8			i;
-	sf8			sf;
-	
+	si1	order;
+	si8	i, lo, hi, mid, last_index, time, previous_time;
 	
-	// unscale from input_buffer to output_buffer
-	// if input_buffer == output_buffer unscaling will be done in place
 	
-	si4_p1 = input_buffer;
-	si4_p2 = output_buffer;
-	sf = (sf8) rps->block_header->scale_factor;
-	for (i = rps->block_header->number_of_samples; i--;)
-		*si4_p2++ = RED_round((sf8) *si4_p1++ * sf);
+	// returns the number of indices in [*first_index, *first_index + returned) that may fall in the time range
+	// (the full range if the indices are not in time order, or contain UUTC_NO_ENTRY times)
+	// times compare with the recording time offset removed, from the index & range times alike
+	// indices_order (may be NULL) caches the order check across queries of the same indices
+	*first_index = 0;
+	if (number_of_indices <= 0)
+		return(0);
+	remove_recording_time_offset(&start_time);
+	remove_recording_time_offset(&end_time);
+	order = (indices_order == NULL) ? RECORD_INDICES_ORDER_UNKNOWN : *indices_order;
+	if (order == RECORD_INDICES_ORDER_UNKNOWN) {
+		order = RECORD_INDICES_TIME_ORDERED;
+		previous_time = UUTC_NO_ENTRY;
+		for (i = 0; i < number_of_indices; ++i) {
+			time = record_indices[i].time;
+			remove_recording_time_offset(&time);
+			if (time == UUTC_NO_ENTRY || (i && time < previous_time)) {
+				order = RECORD_INDICES_UNORDERED;
+				break;
+			}
+			previous_time = time;
+		}
+		if (indices_order != NULL)
+			*indices_order = order;
+	}
+	if (order == RECORD_INDICES_UNORDERED)
+		return(number_of_indices);
+	
+	// first index with time >= start_time
+	if (start_time != UUTC_NO_ENTRY) {
+		lo = 0;
+		hi = number_of_indices;
+		while (lo < hi) {
+			mid = lo + ((hi - lo) >> 1);
+			time = record_indices[mid].time;
+			remove_recording_time_offset(&time);
+			if (time < start_time)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		*first_index = lo;
+	}
+	
+	// first index with time > end_time
+	last_index = number_of_indices;
+	if (end_time != UUTC_NO_ENTRY) {
+		lo = *first_index;
+		hi = number_of_indices;
+		while (lo < hi) {
+			mid = lo + ((hi - lo) >> 1);
+			time = record_indices[mid].time;
+			remove_recording_time_offset(&time);
+			if (time <= end_time)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		last_index = lo;
+	}
 	
 	
-	return(output_buffer);
+	return(last_index - *first_index);
 }
 
 
-inline RED_BLOCK_HEADER	*RED_update_RPS_pointers(RED_PROCESSING_STRUCT *rps, ui1 flags)
+RECORD_QUERY_RESULT	*RECORD_query_session(SESSION *session, RECORD_QUERY *query, RECORD_QUERY_RESULT *result)
 {
-        RED_BLOCK_HEADER	*block_header;
+	si4		i, j;
+	CHANNEL		*chan;
+	SEGMENT		*seg;
+	
+	
+	// session, then each time series channel followed by its segments
+	if (result == NULL)
+		result = (RECORD_QUERY_RESULT *) e_calloc((size_t) 1, sizeof(RECORD_QUERY_RESULT), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	
+	(void) RECORD_query_file(session->record_indices_fps, session->record_data_fps, query, result, RECORD_QUERY_NO_LEVEL, RECORD_QUERY_NO_LEVEL);
+	for (i = 0; i < session->number_of_time_series_channels; ++i) {
+		chan = session->time_series_channels + i;
+		(void) RECORD_query_file(chan->record_indices_fps, chan->record_data_fps, query, result, i, RECORD_QUERY_NO_LEVEL);
+		for (j = 0; j < chan->number_of_segments; ++j) {
+			seg = chan->segments + j;
+			(void) RECORD_query_file(seg->record_indices_fps, seg->record_data_fps, query, result, i, j);
+		}
+	}
+	
+	
+	return(result);
+}
 
-        
-        block_header = rps->block_header;
-	if (flags & RED_UPDATE_ORIGINAL_PTR)
-                rps->original_ptr += block_header->number_of_samples;
-	if (flags & RED_UPDATE_BLOCK_HEADER_PTR)
-                rps->block_header = (RED_BLOCK_HEADER *) ((ui1 *) rps->block_header + block_header->block_bytes);
-        if (flags & RED_UPDATE_DECOMPRESSED_PTR)
-        	rps->decompressed_ptr += block_header->number_of_samples;
-        
-        
-        return(rps->block_header);
+
+si4	RECORD_query_type_matches(RECORD_QUERY *query, ui4 type_code)
+{
+	si4	i;
+	
+	
+	if (query->number_of_type_codes == 0)
+		return(MEF_TRUE);
+	
+	for (i = 0; i < query->number_of_type_codes; ++i)
+		if (query->type_codes[i] == type_code)
+			return(MEF_TRUE);
+	
+	
+	return(MEF_FALSE);
 }
 
 
 /*************************************************************************/
-/****************************  END RED FUNCTIONS  ************************/
+/************************  END RECORD QUERY FUNCTIONS  *******************/
 /*************************************************************************/
 
 
-si4	remove_line_noise(si4 *data, si8 n_samps, sf8 sampling_frequency, sf8 line_frequency, sf8 *template)
+/*************************************************************************/
+/******************************  RED FUNCTIONS  **************************/
+/*************************************************************************/
+
+
+RED_PROCESSING_STRUCT	*RED_allocate_processing_struct(si8 original_data_size, si8 compressed_data_size, si8 decompressed_data_size, si8 difference_buffer_size, si8 detrended_buffer_size, si8 scaled_buffer_size, PASSWORD_DATA *password_data)
 {
-        FILT_PROCESSING_STRUCT	*filtps;
-        si8			i, j, si8_curr_samp, leftovers, median_pt;
-        sf8			*filt_data, sf8_curr_samp, *point_arrays, *pa, sf8_template_len;
-        si4			template_len, n_waveforms;
-        si1			free_template;
-        
+        RED_PROCESSING_STRUCT	*rps;
         
-        // filter
-	filtps = FILT_initialize_processing_struct(5, FILT_BANDPASS_TYPE, sampling_frequency, n_samps, MEF_FALSE, MEF_FALSE, line_frequency - 10.0, (line_frequency * 5.0) + 10.0);
-        filtps->orig_data = data;
-        filtps->data_length = n_samps;
-        FILT_filtfilt(filtps);
+	
+	// allocate
+        rps = (RED_PROCESSING_STRUCT *) e_calloc((size_t) 1, sizeof(RED_PROCESSING_STRUCT), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
         
-        // allocate
-        filt_data = filtps->sf8_filt_data;
-        sf8_template_len = sampling_frequency / line_frequency;
-        template_len = (si4) (sf8_template_len + 0.5);
-        n_waveforms = (si4) ((sf8) n_samps / sf8_template_len);
-        point_arrays = (sf8 *) e_calloc((size_t) template_len * n_waveforms, sizeof(sf8), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
-	if (template == NULL) {
-                template = (sf8 *) e_calloc((size_t) template_len, sizeof(sf8), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
-		free_template = MEF_TRUE;
-	} else {
-		free_template = MEF_FALSE;
+        if (original_data_size)
+		rps->original_ptr = rps->original_data = (si4 *) e_calloc((size_t) original_data_size, sizeof(si4), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	
+        if (compressed_data_size) {
+		rps->compressed_data = (ui1 *) e_calloc((size_t) compressed_data_size, sizeof(ui1), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+        	rps->block_header = (RED_BLOCK_HEADER *) rps->compressed_data;
 	}
+		
+	if (decompressed_data_size)
+		rps->decompressed_ptr = rps->decompressed_data = (si4 *) e_calloc((size_t) decompressed_data_size, sizeof(si4), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
 	
-        // reorder points
-        sf8_curr_samp = 0.0;
-        for  (i = 0; i < n_waveforms; ++i) {
-                si8_curr_samp = (si8) (sf8_curr_samp + 0.5);
-                pa = point_arrays + i;
-                for (j = 0; j < template_len; ++j) {
-                        *pa = filt_data[si8_curr_samp++];
-                        pa += n_waveforms;
-                }
-                sf8_curr_samp += sf8_template_len;
-        }
-        
-        // sort
-        pa = point_arrays;
-        for (i = 0; i < template_len; ++i) {
-                qsort(pa, n_waveforms, sizeof(sf8), compare_sf8);
-                pa += n_waveforms;
-        }
-        
-        // build template from medians
-        median_pt = n_waveforms / 2;
-        pa = point_arrays + median_pt;
-        for (i = 0; i < template_len; ++i) {
-                template[i] = *pa;
-                pa += n_waveforms;
-        }
+	if (difference_buffer_size)
+		rps->difference_buffer = (si1 *) e_calloc((size_t) difference_buffer_size, sizeof(ui1), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
 	
-        // subtract template
-        sf8_curr_samp = 0.0;
-	si8_curr_samp = 0;
-        for  (i = 0; i < n_waveforms; ++i) {
-                for (j = 0; j < template_len; ++j, ++si8_curr_samp)
-                        data[si8_curr_samp] = RED_round((sf8) data[si8_curr_samp] - template[j]);
-                sf8_curr_samp += sf8_template_len;
-		if (si8_curr_samp < (si8) (sf8_curr_samp + 0.5)) {
-                        data[si8_curr_samp] -= template[0];
-			++si8_curr_samp;
-		}
-        }
-        leftovers = n_samps - ++si8_curr_samp;
-        for (i = 0; i < leftovers; ++i, si8_curr_samp++)
-                data[si8_curr_samp] = RED_round((sf8) data[si8_curr_samp] - template[i]);
+	if (detrended_buffer_size)
+		rps->detrended_buffer = (si4 *) e_calloc((size_t) detrended_buffer_size, sizeof(si4), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
 	
-        // clean up
-        free(point_arrays);
-        FILT_free_processing_struct(filtps, MEF_FALSE, MEF_FALSE);
-        if (free_template == MEF_TRUE)
-                free(template);
+	if (scaled_buffer_size)
+		rps->scaled_buffer = (si4 *) e_calloc((size_t) scaled_buffer_size, sizeof(si4), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	
+	// assign password data
+	rps->password_data = password_data;
         
+	// set directives defaults
+	rps->directives.return_lossy_data = RED_RETURN_LOSSY_DATA_DEFAULT;
+	rps->directives.encryption_level = RED_ENCRYPTION_LEVEL_DEFAULT;
+	rps->directives.detrend_data = RED_DETREND_DATA_DEFAULT;
+	rps->directives.discontinuity = RED_DISCONTINUITY_DEFAULT;
+	rps->directives.reset_discontinuity = RED_RESET_DISCONTINUITY_DEFAULT;
+        rps->directives.require_normality = RED_REQUIRE_NORMALITY_DEFAULT;
+        rps->directives.normal_correlation = RED_NORMAL_CORRELATION_DEFAULT;
+	
+	// set compression defaults
+	rps->compression.mode = RED_COMPRESSION_MODE_DEFAULT;
+	rps->compression.goal_compression_ratio = RED_GOAL_COMPRESSION_RATIO_DEFAULT;
+	rps->compression.goal_mean_residual_ratio = RED_GOAL_MEAN_RESIDUAL_RATIO_DEFAULT;
+	rps->compression.goal_tolerance = RED_GOAL_TOLERANCE_DEFAULT;
+	rps->compression.maximum_rounds_per_block = RED_MAXIMUM_ROUNDS_PER_BLOCK_DEFAULT;
+	
         
-        return(template_len);
+        return(rps);
 }
 
 
-void	remove_line_noise_adaptive(si4 *data, si8 n_samps, sf8 sampling_frequency, sf8 line_frequency, si4 n_cycles)
+inline sf8	RED_calculate_mean_residual_ratio(si4 *original_data, si4 *lossy_data, ui4 n_samps)
 {
-	FILT_PROCESSING_STRUCT	*filtps;
-	si8			i, j, si8_curr_samp, leftovers;
-	sf8			*filt_data, sf8_curr_samp, *point_arrays, *pa, *ma, *tma, sf8_template_len;
-	si4			template_len, n_waveforms;
-	
-	
-	// filter
-	filtps = FILT_initialize_processing_struct(5, FILT_BANDPASS_TYPE, sampling_frequency, n_samps, MEF_FALSE, MEF_FALSE, line_frequency - 10.0, (line_frequency * 5.0) + 10.0);
-	filtps->orig_data = data;
-	filtps->data_length = n_samps;
-	FILT_filtfilt(filtps);
-	
-	// allocate
-	filt_data = filtps->sf8_filt_data;
-	sf8_template_len = sampling_frequency / line_frequency;
-	template_len = (si4) (sf8_template_len + 0.5);
-	n_waveforms = (si4) ((sf8) n_samps / sf8_template_len);
-	point_arrays = (sf8 *) e_calloc((size_t) template_len * n_waveforms, sizeof(sf8), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
-	
-	// reorder points
-	sf8_curr_samp = 0.0;
-	for  (i = 0; i < n_waveforms; ++i) {
-		si8_curr_samp = (si8) (sf8_curr_samp + 0.5);
-		pa = point_arrays + i;
-		for (j = 0; j < template_len; ++j) {
-			*pa = filt_data[si8_curr_samp++];
-			pa += n_waveforms;
-		}
-		sf8_curr_samp += sf8_template_len;
-	}
+	sf8	sum, mrr, diff, r;
+	si8	i;
 	
-	// sort
-	pa = point_arrays;
-	ma = filt_data;
-	for (i = 0; i < template_len; ++i) {
-		proportion_filt(pa, ma, n_waveforms, 0.5, n_cycles);
-		pa += n_waveforms;
-		ma += n_waveforms;
-	}
 	
-	// subtract template
-	sf8_curr_samp = 0.0;
-	si8_curr_samp = 0;
-	ma = filt_data - 1;
-	for  (i = 0; i < n_waveforms; ++i, ++ma) {
-		tma = ma - n_waveforms;
-		for (j = 0; j < template_len; ++j, ++si8_curr_samp)
-			data[si8_curr_samp] = RED_round((sf8) data[si8_curr_samp] - *(tma += n_waveforms));
-		sf8_curr_samp += sf8_template_len;
-		if (si8_curr_samp < (si8) (sf8_curr_samp + 0.5)) {
-			data[si8_curr_samp] -= *ma;
-			++si8_curr_samp;
+	sum = (sf8) 0.0;
+	for (i = n_samps; i--;) {
+		if (*original_data) {
+			diff = (sf8) (*original_data - *lossy_data++);
+                        r = diff / (sf8) *original_data++;
+			sum += ABS(r);
+		} else {
+			--n_samps;
+			++original_data;
+			++lossy_data;
 		}
 	}
-	leftovers = n_samps - ++si8_curr_samp;
-	tma = ma - n_waveforms;
-	for (i = 0; i < leftovers; ++i, si8_curr_samp++)
-		data[si8_curr_samp] = RED_round((sf8) data[si8_curr_samp] - *(tma += n_waveforms));
 	
-	// clean up
-	free(point_arrays);
-	FILT_free_processing_struct(filtps, MEF_FALSE, MEF_FALSE);
+	if (sum == (sf8) 0.0)
+		mrr = (sf8) 0.0;
+	else
+		mrr = sum / (sf8) n_samps;
 	
 	
-	return;
+	return(mrr);
 }
 
 
-inline void	remove_recording_time_offset(si8 *time)
+si1	RED_check_RPS_allocation(RED_PROCESSING_STRUCT *rps)
 {
-        if (*time == UUTC_NO_ENTRY)
-                return;
+        si1	error = MEF_FALSE;
+	si1	need_compressed_data = MEF_FALSE;
+	si1	need_decompressed_data = MEF_FALSE;
+        si1	need_original_data = MEF_FALSE;
+	si1	need_detrended_buffer = MEF_FALSE;
+	si1	need_scaled_buffer = MEF_FALSE;
+	si1	need_difference_buffer = MEF_FALSE;
 	
-	if (*time > 0)  // positive times indicate recording time offset not applied, 0 - unlikely any records started at 1970.
-		return;
+        
+        // decompression
+        if (rps->compression.mode == RED_DECOMPRESSION) {
+                need_compressed_data = MEF_TRUE;
+                need_decompressed_data = MEF_TRUE;
+                need_difference_buffer = MEF_TRUE;
+        }
+        
+        // compression
+        else {
+                need_compressed_data = MEF_TRUE;
+                need_original_data = MEF_TRUE;
+                need_difference_buffer = MEF_TRUE;
+                
+                // lossy compression
+                if (rps->compression.mode > RED_LOSSLESS_COMPRESSION) {
+                        need_scaled_buffer = MEF_TRUE;
+                        if (rps->directives.detrend_data == MEF_TRUE)
+                                need_detrended_buffer = MEF_TRUE;
+                        if (rps->compression.mode == RED_MEAN_RESIDUAL_RATIO)
+                                need_decompressed_data = MEF_TRUE;
+                        if (rps->directives.return_lossy_data == MEF_TRUE)
+                                need_decompressed_data = MEF_TRUE;
+                }
+        }
+        
+        // check compressed_data
+        if (need_compressed_data == MEF_TRUE && rps->compressed_data == NULL) {
+                fprintf(stderr, "\"compressed_data\" is not allocated in the RED_PROCESSING_STRUCT [function %s, line %d]\n", __FUNCTION__, __LINE__);
+		error = MEF_TRUE;
+        }
 	
-	// remove recording time offset & make positive to indicate removal
-	*time = (-*time) + MEF_globals->recording_time_offset;
+        // check difference_buffer
+        if (need_difference_buffer == MEF_TRUE && rps->difference_buffer == NULL) {
+                fprintf(stderr, "\"difference_buffer\" is not allocated in the RED_PROCESSING_STRUCT [function %s, line %d]\n", __FUNCTION__, __LINE__);
+		error = MEF_TRUE;
+        }
 	
+        // check original_data
+        if (need_original_data == MEF_TRUE && rps->original_data == NULL) {
+                fprintf(stderr, "\"original_data\" is not allocated in the RED_PROCESSING_STRUCT [function %s, line %d]\n", __FUNCTION__, __LINE__);
+		error = MEF_TRUE;
+        }
+	if (need_original_data == MEF_FALSE && rps->original_data != NULL) {
+                fprintf(stderr, "\"original_data\" is needlessly allocated in the RED_PROCESSING_STRUCT => freeing [function %s, line %d]\n", __FUNCTION__, __LINE__);
+		free(rps->original_data);
+		rps->original_ptr = rps->original_data = NULL;
+	}
+        
+        // check decompressed_data
+        if (need_decompressed_data == MEF_TRUE && rps->decompressed_data == NULL) {
+                fprintf(stderr, "\"decompressed_data\" is not allocated in the RED_PROCESSING_STRUCT [function %s, line %d]\n", __FUNCTION__, __LINE__);
+		error = MEF_TRUE;
+        }
+	if (need_decompressed_data == MEF_FALSE && rps->decompressed_data != NULL) {
+		fprintf(stderr, "\"decompressed_data\" is needlessly allocated in the RED_PROCESSING_STRUCT => freeing [function %s, line %d]\n", __FUNCTION__, __LINE__);
+		free(rps->decompressed_data);
+		rps->decompressed_ptr = rps->decompressed_data = NULL;
+	}
+
+        // check detrended_buffer
+        if (need_detrended_buffer == MEF_TRUE && rps->detrended_buffer == NULL) {
+                fprintf(stderr, "\"detrended_buffer\" is not allocated in the RED_PROCESSING_STRUCT [function %s, line %d]\n", __FUNCTION__, __LINE__);
+		error = MEF_TRUE;
+        }
+	if (need_detrended_buffer == MEF_FALSE && rps->detrended_buffer != NULL) {
+                fprintf(stderr, "\"detrended_buffer\" is needlessly allocated in the RED_PROCESSING_STRUCT => freeing [function %s, line %d]\n", __FUNCTION__, __LINE__);
+		free(rps->detrended_buffer);
+		rps->detrended_buffer = NULL;
+	}
+        
+        // check scaled_buffer
+        if (need_scaled_buffer == MEF_TRUE && rps->scaled_buffer == NULL) {
+                fprintf(stderr, "\"scaled_buffer\" is not allocated in the RED_PROCESSING_STRUCT [function %s, line %d]\n", __FUNCTION__, __LINE__);
+		error = MEF_TRUE;
+        }
+	if (need_scaled_buffer == MEF_FALSE && rps->scaled_buffer != NULL) {
+                fprintf(stderr, "\"scaled_buffer\" is needlessly allocated in the RED_PROCESSING_STRUCT => freeing [function %s, line %d]\n", __FUNCTION__, __LINE__);
+		free(rps->scaled_buffer);
+		rps->scaled_buffer = NULL;
+	}
 	
-	return;
-}
+	// error
+	if (error == MEF_TRUE) {
+		if (MEF_context->behavior_on_fail & EXIT_ON_FAIL) {
+			(void) fprintf(stderr, "\t=> exiting program\n\n");
+			exit(1);
+		}
+	}
+        
 
+        return(error);
+}
 
-/*************************************************************************/
-/****************************  SHA-256 FUNCTIONS  ************************/
-/*************************************************************************/
 
-// ATTRIBUTION
-//
-// FIPS 180-2 SHA-224/256/384/512 implementation
-// Last update: 02/02/2007
-// Issue date:  04/30/2005
-//
-// Copyright (C) 2005, 2007 Olivier Gay <olivier.gay@a3.epfl.ch>
-// All rights reserved.
-//
-// "Redistribution and use in source and binary forms, with or without
-// modification, are permitted provided that the following conditions
-// are met:
-// 1. Redistributions of source code must retain the above copyright
-//    notice, this list of conditions and the following disclaimer.
-// 2. Redistributions in binary form must reproduce the above copyright
-//    notice, this list of conditions and the following disclaimer in the
-//    documentation and/or other materials provided with the distribution.
-// 3. Neither the name of the project nor the names of its contributors
-//    may be used to endorse or promote products derived from this software
-//    without specific prior written permission.
-//
-// THIS SOFTWARE IS PROVIDED BY THE PROJECT AND CONTRIBUTORS ``AS IS'' AND
-// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
-// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
-// ARE DISCLAIMED.  IN NO EVENT SHALL THE PROJECT OR CONTRIBUTORS BE LIABLE
-// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
-// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
-// OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
-// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
-// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
-// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
-// SUCH DAMAGE."
-//
-// ONLY SHA-256 FUNCTIONS ARE INCLUDED IN THE MEF 3.0 LIBRARY
-//
-// Minor modifications for compatibility with the MEF Library.
-
-
-void sha256(const ui1 *message, ui4 len, ui1 *digest)
+void 	RED_decode(RED_PROCESSING_STRUCT *rps)
 {
-	SHA256_ctx	ctx;
-	
-	SHA256_init(&ctx);
-	SHA256_update(&ctx, message, len);
-	SHA256_final(&ctx, digest);
+        si1			*si1_p1, *si1_p2, *diff_buffer_p, CRC_valid;
+        ui1			*ui1_p, *ib_p, in_byte, *scaled_counts, *key;
+        si4			*si4_p, current_val;
+	si8			i;
+        ui4			cc, *cumulative_counts, low_bound, range, symbol;
+        ui4			scaled_total_counts, temp_ui4, range_per_count, *ui4_p1, *ui4_p2;
+        RED_BLOCK_HEADER	*block_header;
+	PROFILE_TIMER		timer, AES_timer;
+        
+        
+        // RED decompress from compressed_ptr to decompressed_ptr
+	block_header = rps->block_header;
+	PROFILE_START(timer);
 	
+        // check CRC
+	if (MEF_context->CRC_mode & (CRC_VALIDATE | CRC_VALIDATE_ON_INPUT)) {
+                CRC_valid = CRC_validate((ui1 *) block_header + CRC_BYTES, block_header->block_bytes - CRC_BYTES, block_header->block_CRC);
+                if (CRC_valid == MEF_FALSE) {
+                        (void) fprintf(stderr, "%c\n%s(): invalid RED block CRC => returning without decoding\n", 7, __FUNCTION__);
+                        PROFILE_STOP(timer, PROFILE_PHASE_DECODE);
+                        return;
+                }
+        }
         
-	return;
-}
-
-
-void SHA256_final(SHA256_ctx *ctx, ui1 *digest)
-{
-	ui4	block_nb;
-	ui4	pm_len;
-	ui4	len_b;
+        // decrypt
+	if (block_header->flags & RED_LEVEL_1_ENCRYPTION_MASK) {
+		rps->directives.encryption_level = LEVEL_1_ENCRYPTION;
+		key = rps->password_data->level_1_encryption_key;
+	} else if (block_header->flags & RED_LEVEL_2_ENCRYPTION_MASK) {
+		rps->directives.encryption_level = LEVEL_2_ENCRYPTION;
+		key = rps->password_data->level_2_encryption_key;
+	} else
+		rps->directives.encryption_level = NO_ENCRYPTION;
+	if (rps->directives.encryption_level > NO_ENCRYPTION) {
+		if (rps->password_data->access_level >= rps->directives.encryption_level) {
+			PROFILE_START(AES_timer);
+			AES_decrypt(block_header->statistics, block_header->statistics, NULL, key);
+			PROFILE_STOP(AES_timer, PROFILE_PHASE_AES);
+			block_header->flags &= ~RED_LEVEL_1_ENCRYPTION_MASK;
+			block_header->flags &= ~RED_LEVEL_2_ENCRYPTION_MASK;
+			rps->directives.encryption_level = -rps->directives.encryption_level;   // mark as decrypted
+		} else {
+			(void) fprintf(stderr, "%c\n%s(): No access to encrypted data => returning without decoding\n", 7, __FUNCTION__);
+			PROFILE_STOP(timer, PROFILE_PHASE_DECODE);
+			return;
+		}
+	}
+        
+        // offset recording time
+        if (MEF_context->recording_time_offset_mode & (RTO_APPLY | RTO_APPLY_ON_INPUT))
+                apply_recording_time_offset(&block_header->start_time);
+        else if (MEF_context->recording_time_offset_mode & (RTO_REMOVE | RTO_REMOVE_ON_INPUT))
+                remove_recording_time_offset(&block_header->start_time);
 	
-	block_nb = (1 + ((SHA256_BLOCK_SIZE - 9) < (ctx->len % SHA256_BLOCK_SIZE)));
+	// discontinuity
+	if (block_header->flags & RED_DISCONTINUITY_MASK)
+		rps->directives.discontinuity = MEF_TRUE;
+	else
+		rps->directives.discontinuity = MEF_FALSE;
+        
+	// if no samples, just return
+	if (block_header->number_of_samples == 0) {
+		PROFILE_STOP(timer, PROFILE_PHASE_DECODE);
+		return;
+	}
 	
-	len_b = (ctx->tot_len + ctx->len) << 3;
-	pm_len = block_nb << 6;
+        // range decode difference data
+        ui1_p = scaled_counts = block_header->statistics;
+        *(ui4_p1 = cumulative_counts = rps->counts) = 0;
+        ui4_p2 = ui4_p1 + 1;
+	for (i = RED_BLOCK_STATISTICS_BYTES; i--;)
+		*ui4_p2++ = *ui4_p1++ + (ui4) *ui1_p++;
+	scaled_total_counts = *ui4_p1;
 	
-	memset(ctx->block + ctx->len, 0, pm_len - ctx->len);
-	ctx->block[ctx->len] = 0x80;
-	UNPACK32(len_b, ctx->block + pm_len - 4);
+        diff_buffer_p = rps->difference_buffer;
+        *diff_buffer_p++ = -128; // initial keysample flag not coded in encode (should be a low frequency symbol)
 	
-	SHA256_transf(ctx, ctx->block, block_nb);
+	ib_p = (ui1 *) rps->block_header + RED_BLOCK_HEADER_BYTES;
+	in_byte = *ib_p++;
+	low_bound = in_byte >> (8 - EXTRA_BITS);
+	range = (ui4) 1 << EXTRA_BITS;
+	ui4_p2 = cumulative_counts + 256;
+	for (i = block_header->difference_bytes; i--;) {
+                while (range <= BOTTOM_VALUE) {
+			low_bound = (low_bound << 8) | ((in_byte << EXTRA_BITS) & 0xff);
+                        in_byte = *ib_p++;
+                        low_bound |= in_byte >> (8 - EXTRA_BITS);
+                        range <<= 8;
+                }
+		temp_ui4 = low_bound / (range_per_count = range / scaled_total_counts);
+		cc = (temp_ui4 >= scaled_total_counts ? (scaled_total_counts - 1) : temp_ui4);
+		if (cc > cumulative_counts[128]) {
+			for (ui4_p1 = ui4_p2; *--ui4_p1 > cc;);
+			symbol = ui4_p1 - cumulative_counts;
+		} else {
+			for (ui4_p1 = cumulative_counts; *++ui4_p1 <= cc;);
+			symbol = ui4_p1 - cumulative_counts - 1;
+		}
+		low_bound -= (temp_ui4 = range_per_count * cumulative_counts[symbol]);
+		if (symbol < 255)
+			range = range_per_count * scaled_counts[symbol];
+		else
+			range -= temp_ui4;
+		*diff_buffer_p++ = symbol;
+	}
 	
-	UNPACK32(ctx->h[0], &digest[ 0]);
-	UNPACK32(ctx->h[1], &digest[ 4]);
-	UNPACK32(ctx->h[2], &digest[ 8]);
-	UNPACK32(ctx->h[3], &digest[12]);
-	UNPACK32(ctx->h[4], &digest[16]);
-	UNPACK32(ctx->h[5], &digest[20]);
-	UNPACK32(ctx->h[6], &digest[24]);
-	UNPACK32(ctx->h[7], &digest[28]);
+	// generate output from difference data
+	si1_p1 = (si1 *) rps->difference_buffer;
+	si4_p = rps->decompressed_ptr;
+	for (i = block_header->number_of_samples; i--;) {
+		if (*si1_p1 == -128) {
+			++si1_p1;
+			si1_p2 = (si1 *) &current_val;
+			*si1_p2++ = *si1_p1++; *si1_p2++ = *si1_p1++; *si1_p2++ = *si1_p1++; *si1_p2 = *si1_p1++;
+		} else
+			current_val += (si4) *si1_p1++;
+		*si4_p++ = current_val;
+	}
 	
+        // unscale decompressed_data if scaled (in place)
+	if (block_header->scale_factor > (sf4) 1.0)
+                RED_unscale(rps, rps->decompressed_ptr, rps->decompressed_ptr);
         
-	return;
-}
-
-
-void SHA256_init(SHA256_ctx *ctx)
-{
-	if (MEF_globals->SHA256_h0_table == NULL)
-		(void) SHA256_initialize_h0_table(MEF_TRUE);
+        // add trend to decompressed_data if detrended (in place)
+	if ((block_header->detrend_slope != (sf4) 0.0) || (block_header->detrend_intercept != (sf4) 0.0))
+                RED_retrend(rps, rps->decompressed_ptr, rps->decompressed_ptr);
 	
-	ctx->h[0] = MEF_globals->SHA256_h0_table[0]; ctx->h[1] = MEF_globals->SHA256_h0_table[1];
-	ctx->h[2] = MEF_globals->SHA256_h0_table[2]; ctx->h[3] = MEF_globals->SHA256_h0_table[3];
-	ctx->h[4] = MEF_globals->SHA256_h0_table[4]; ctx->h[5] = MEF_globals->SHA256_h0_table[5];
-	ctx->h[6] = MEF_globals->SHA256_h0_table[6]; ctx->h[7] = MEF_globals->SHA256_h0_table[7];
+	if (timer.profile != NULL) {
+		PROFILE_STOP(timer, PROFILE_PHASE_DECODE);
+		PROFILE_COUNT(blocks_decoded, 1);
+	}
 	
-	ctx->len = 0;
-	ctx->tot_len = 0;
 	
-        
-	return;
+        return;
 }
 
 
-ui4	*SHA256_initialize_h0_table(si4 global_flag)
+si4	*RED_detrend(RED_PROCESSING_STRUCT *rps, si4 *input_buffer, si4 *output_buffer)
 {
-	ui4	*SHA256_h0_table;
-	
-	
-	SHA256_h0_table = (ui4 *) e_calloc((size_t) SHA256_H0_ENTRIES, sizeof(ui4), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+        si4			*si4_p1, *si4_p2;
+        sf8			sx, sy, sxx, syy, sxy, n, mx, my, c, sf8_m, sf8_b, val;
+        sf4			m, b;
+        si8			i;
+        RED_BLOCK_HEADER	*block_header;
 	
-	{
-		ui4 temp[SHA256_H0_ENTRIES] = SHA256_H0;
-		memcpy(SHA256_h0_table, temp, SHA256_H0_ENTRIES * sizeof(ui4));
-	}
 	
-	if (global_flag == MEF_TRUE) {
-		MEF_globals->SHA256_h0_table = SHA256_h0_table;
-		return(NULL);
-	}
+        // detrend from input_buffer to output_buffer
+	// slope and intercept values entered into block_header
+	// if input_buffer == output_buffer detrending will be done in place
+        
+        block_header = rps->block_header;
 	
+        // calculate slope & intercept
+        n = block_header->number_of_samples;
+        sx = (n * (n + (sf8) 1.0)) / (sf8) 2.0;
+        sxx = (n * (n + (sf8) 1.0) * ((n * (sf8) 2.0) + (sf8) 1.0)) / (sf8) 6.0;
         
-	return(SHA256_h0_table);
+        sy = syy = sxy = 0.0;
+        c = (sf8) 1.0;
+        si4_p1 = input_buffer;
+        for (i = block_header->number_of_samples; i--;) {
+                val = (sf8) *si4_p1++;
+                sy += val;
+                syy += val * val;
+                sxy += val * c;
+                c += (sf8) 1.0;
+        }
+        
+        mx = sx / n;
+        my = sy / n;
+        sf8_m = (((sx * my) - sxy) / ((sx * mx) - sxx));
+        sf8_b = (my - (sf8_m * mx));
+        
+        m = block_header->detrend_slope = (sf4) sf8_m;
+        b = block_header->detrend_intercept = (sf4) sf8_b;
+        
+        // subtract trend from input_buffer to output_buffer
+        sf8_m = (sf8) m;
+        sf8_b = (sf8) b;
+        c = (sf8) 0.0;
+        si4_p1 = input_buffer;
+	si4_p2 = output_buffer;
+        for (i = block_header->number_of_samples; i--;) {
+                c += (sf8) 1.0;
+                *si4_p2++ = RED_round((sf8) *si4_p1++ - (sf8_m * c) - sf8_b);
+        }
+        
+        
+        return(output_buffer);
 }
 
 
-ui4	*SHA256_initialize_k_table(si4 global_flag)
+inline void	RED_encode(RED_PROCESSING_STRUCT *rps)
 {
-	ui4	*SHA256_k_table;
-	
+	// RED compress from original_ptr to block_header pointer (compressed data array)
 	
-	SHA256_k_table = (ui4 *) e_calloc((size_t) SHA256_K_ENTRIES, sizeof(ui4), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
-	
-	{
-		ui4 temp[SHA256_K_ENTRIES] = SHA256_K;
-		memcpy(SHA256_k_table, temp, SHA256_K_ENTRIES * sizeof(ui4));
-	}
-	
-	if (global_flag == MEF_TRUE) {
-		MEF_globals->SHA256_k_table = SHA256_k_table;
-		return(NULL);
+	rps->block_header->detrend_slope = rps->block_header->detrend_intercept = (sf4) 0.0;
+	if (rps->compression.mode == RED_LOSSLESS_COMPRESSION) {
+		rps->block_header->scale_factor = (sf4) 1.0;
+		RED_encode_exec(rps, rps->original_ptr, MEF_FALSE);
+	} else if (rps->compression.mode > RED_LOSSLESS_COMPRESSION) {
+		RED_encode_lossy(rps);
+	} else {
+		(void) fprintf(stderr, "%c\n%s(): Invalid compression mode => returning without encoding\n", 7, __FUNCTION__);
 	}
 	
-        
-	return(SHA256_k_table);
-}
-
-
-void SHA256_transf(SHA256_ctx *ctx, const ui1 *message, ui4 block_nb)
-{
-	ui4		w[64];
-	ui4		wv[8];
-	ui4		t1, t2;
-	const ui1	*sub_block;
-	si4		i;
-        
-	
-	if (MEF_globals->SHA256_k_table == NULL)
-		(void) SHA256_initialize_k_table(MEF_TRUE);
-	
-	for (i = 0; i < (si4) block_nb; i++) {
-		sub_block = message + (i << 6);
-		
-		PACK32(&sub_block[ 0], &w[ 0]); PACK32(&sub_block[ 4], &w[ 1]);
-		PACK32(&sub_block[ 8], &w[ 2]); PACK32(&sub_block[12], &w[ 3]);
-		PACK32(&sub_block[16], &w[ 4]); PACK32(&sub_block[20], &w[ 5]);
-		PACK32(&sub_block[24], &w[ 6]); PACK32(&sub_block[28], &w[ 7]);
-		PACK32(&sub_block[32], &w[ 8]); PACK32(&sub_block[36], &w[ 9]);
-		PACK32(&sub_block[40], &w[10]); PACK32(&sub_block[44], &w[11]);
-		PACK32(&sub_block[48], &w[12]); PACK32(&sub_block[52], &w[13]);
-		PACK32(&sub_block[56], &w[14]); PACK32(&sub_block[60], &w[15]);
-		
-		SHA256_SCR(16); SHA256_SCR(17); SHA256_SCR(18); SHA256_SCR(19);
-		SHA256_SCR(20); SHA256_SCR(21); SHA256_SCR(22); SHA256_SCR(23);
-		SHA256_SCR(24); SHA256_SCR(25); SHA256_SCR(26); SHA256_SCR(27);
-		SHA256_SCR(28); SHA256_SCR(29); SHA256_SCR(30); SHA256_SCR(31);
-		SHA256_SCR(32); SHA256_SCR(33); SHA256_SCR(34); SHA256_SCR(35);
-		SHA256_SCR(36); SHA256_SCR(37); SHA256_SCR(38); SHA256_SCR(39);
-		SHA256_SCR(40); SHA256_SCR(41); SHA256_SCR(42); SHA256_SCR(43);
-		SHA256_SCR(44); SHA256_SCR(45); SHA256_SCR(46); SHA256_SCR(47);
-		SHA256_SCR(48); SHA256_SCR(49); SHA256_SCR(50); SHA256_SCR(51);
-		SHA256_SCR(52); SHA256_SCR(53); SHA256_SCR(54); SHA256_SCR(55);
-		SHA256_SCR(56); SHA256_SCR(57); SHA256_SCR(58); SHA256_SCR(59);
-		SHA256_SCR(60); SHA256_SCR(61); SHA256_SCR(62); SHA256_SCR(63);
-		
-		wv[0] = ctx->h[0]; wv[1] = ctx->h[1];
-		wv[2] = ctx->h[2]; wv[3] = ctx->h[3];
-		wv[4] = ctx->h[4]; wv[5] = ctx->h[5];
-		wv[6] = ctx->h[6]; wv[7] = ctx->h[7];
-		
-		SHA256_EXP(0,1,2,3,4,5,6,7, 0); SHA256_EXP(7,0,1,2,3,4,5,6, 1);
-		SHA256_EXP(6,7,0,1,2,3,4,5, 2); SHA256_EXP(5,6,7,0,1,2,3,4, 3);
-		SHA256_EXP(4,5,6,7,0,1,2,3, 4); SHA256_EXP(3,4,5,6,7,0,1,2, 5);
-		SHA256_EXP(2,3,4,5,6,7,0,1, 6); SHA256_EXP(1,2,3,4,5,6,7,0, 7);
-		SHA256_EXP(0,1,2,3,4,5,6,7, 8); SHA256_EXP(7,0,1,2,3,4,5,6, 9);
-		SHA256_EXP(6,7,0,1,2,3,4,5,10); SHA256_EXP(5,6,7,0,1,2,3,4,11);
-		SHA256_EXP(4,5,6,7,0,1,2,3,12); SHA256_EXP(3,4,5,6,7,0,1,2,13);
-		SHA256_EXP(2,3,4,5,6,7,0,1,14); SHA256_EXP(1,2,3,4,5,6,7,0,15);
-		SHA256_EXP(0,1,2,3,4,5,6,7,16); SHA256_EXP(7,0,1,2,3,4,5,6,17);
-		SHA256_EXP(6,7,0,1,2,3,4,5,18); SHA256_EXP(5,6,7,0,1,2,3,4,19);
-		SHA256_EXP(4,5,6,7,0,1,2,3,20); SHA256_EXP(3,4,5,6,7,0,1,2,21);
-		SHA256_EXP(2,3,4,5,6,7,0,1,22); SHA256_EXP(1,2,3,4,5,6,7,0,23);
-		SHA256_EXP(0,1,2,3,4,5,6,7,24); SHA256_EXP(7,0,1,2,3,4,5,6,25);
-		SHA256_EXP(6,7,0,1,2,3,4,5,26); SHA256_EXP(5,6,7,0,1,2,3,4,27);
-		SHA256_EXP(4,5,6,7,0,1,2,3,28); SHA256_EXP(3,4,5,6,7,0,1,2,29);
-		SHA256_EXP(2,3,4,5,6,7,0,1,30); SHA256_EXP(1,2,3,4,5,6,7,0,31);
-		SHA256_EXP(0,1,2,3,4,5,6,7,32); SHA256_EXP(7,0,1,2,3,4,5,6,33);
-		SHA256_EXP(6,7,0,1,2,3,4,5,34); SHA256_EXP(5,6,7,0,1,2,3,4,35);
-		SHA256_EXP(4,5,6,7,0,1,2,3,36); SHA256_EXP(3,4,5,6,7,0,1,2,37);
-		SHA256_EXP(2,3,4,5,6,7,0,1,38); SHA256_EXP(1,2,3,4,5,6,7,0,39);
-		SHA256_EXP(0,1,2,3,4,5,6,7,40); SHA256_EXP(7,0,1,2,3,4,5,6,41);
-		SHA256_EXP(6,7,0,1,2,3,4,5,42); SHA256_EXP(5,6,7,0,1,2,3,4,43);
-		SHA256_EXP(4,5,6,7,0,1,2,3,44); SHA256_EXP(3,4,5,6,7,0,1,2,45);
-		SHA256_EXP(2,3,4,5,6,7,0,1,46); SHA256_EXP(1,2,3,4,5,6,7,0,47);
-		SHA256_EXP(0,1,2,3,4,5,6,7,48); SHA256_EXP(7,0,1,2,3,4,5,6,49);
-		SHA256_EXP(6,7,0,1,2,3,4,5,50); SHA256_EXP(5,6,7,0,1,2,3,4,51);
-		SHA256_EXP(4,5,6,7,0,1,2,3,52); SHA256_EXP(3,4,5,6,7,0,1,2,53);
-		SHA256_EXP(2,3,4,5,6,7,0,1,54); SHA256_EXP(1,2,3,4,5,6,7,0,55);
-		SHA256_EXP(0,1,2,3,4,5,6,7,56); SHA256_EXP(7,0,1,2,3,4,5,6,57);
-		SHA256_EXP(6,7,0,1,2,3,4,5,58); SHA256_EXP(5,6,7,0,1,2,3,4,59);
-		SHA256_EXP(4,5,6,7,0,1,2,3,60); SHA256_EXP(3,4,5,6,7,0,1,2,61);
-		SHA256_EXP(2,3,4,5,6,7,0,1,62); SHA256_EXP(1,2,3,4,5,6,7,0,63);
-		
-		ctx->h[0] += wv[0]; ctx->h[1] += wv[1];
-		ctx->h[2] += wv[2]; ctx->h[3] += wv[3];
-		ctx->h[4] += wv[4]; ctx->h[5] += wv[5];
-		ctx->h[6] += wv[6]; ctx->h[7] += wv[7];
-	}
 	
-        
 	return;
 }
-
-
-void SHA256_update(SHA256_ctx *ctx, const ui1 *message, unsigned int len)
+	       
+	       
+void	RED_encode_block_task(void *task_args, si8 task_number, si4 thread_number)
 {
-	ui4		block_nb;
-	ui4		new_len, rem_len, tmp_len;
-	const ui1	*shifted_message;
-	
-	tmp_len = SHA256_BLOCK_SIZE - ctx->len;
-	rem_len = len < tmp_len ? len : tmp_len;
-	
-	memcpy(&ctx->block[ctx->len], message, rem_len);
+	RED_ENCODE_TASK_ARGS	*args;
+	RED_PROCESSING_STRUCT	*rps;
+	RED_BLOCK_HEADER	*block_header;
+	TIME_SERIES_INDEX	*tsi;
+	si8			block_number, block_start;
+	ui4			block_samples;
 	
-	if (ctx->len + len < SHA256_BLOCK_SIZE) {
-		ctx->len += len;
-		return;
-	}
 	
-	new_len = len - rem_len;
-	block_nb = new_len / SHA256_BLOCK_SIZE;
+	// encodes one block into its own slot with the calling thread's RED_PROCESSING_STRUCT; blocks are serialized by RED_encode_blocks()
+	args = (RED_ENCODE_TASK_ARGS *) task_args;
+	rps = args->rps[thread_number];
+	block_number = args->first_block + task_number;
+	block_start = block_number * (si8) args->block_samples;
+	block_samples = args->block_samples;
+	if (block_number == args->number_of_blocks - 1)
+		block_samples = (ui4) (args->number_of_samples - block_start);
 	
-	shifted_message = message + rem_len;
+	block_header = (RED_BLOCK_HEADER *) (args->block_slots + (task_number * args->slot_bytes));
+	bzero((void *) block_header, (size_t) RED_BLOCK_HEADER_BYTES);
+	block_header->number_of_samples = block_samples;
+	block_header->start_time = args->start_time + (si8) ((((sf8) block_start * (sf8) 1e6) / args->sampling_frequency) + 0.5);
 	
-	SHA256_transf(ctx, ctx->block, 1);
-	SHA256_transf(ctx, shifted_message, block_nb);
+	rps->block_header = block_header;
+	rps->original_ptr = args->samples + block_start;
+	rps->directives.discontinuity = (block_number == 0) ? args->discontinuity : MEF_FALSE;
 	
-	rem_len = new_len % SHA256_BLOCK_SIZE;
+	tsi = args->tsi + task_number;
+	tsi->start_time = block_header->start_time;  // before the encoder applies any recording time offset
+	RED_encode(rps);
 	
-	memcpy(ctx->block, &shifted_message[block_nb << 6], rem_len);
+	// index entry (file offset filled in on serialization)
+	tsi->file_offset = TIME_SERIES_INDEX_FILE_OFFSET_NO_ENTRY;
+	tsi->start_sample = block_start;
+	tsi->number_of_samples = block_samples;
+	tsi->block_bytes = block_header->block_bytes;
+	RED_find_extrema(rps->original_ptr, (si8) block_samples, tsi);
+	tsi->RED_block_flags = block_header->flags;
 	
-	ctx->len = rem_len;
-	ctx->tot_len += (block_nb + 1) << 6;
 	
-        
 	return;
 }
 
 
-/*************************************************************************/
-/**************************  END SHA-256 FUNCTIONS  **********************/
-/*************************************************************************/
-
-
-void	show_file_processing_struct(FILE_PROCESSING_STRUCT *fps)
+si8	RED_encode_blocks(FILE_PROCESSING_STRUCT *data_fps, FILE_PROCESSING_STRUCT *indices_fps, si4 *samples, si8 number_of_samples, si8 start_sample, si8 start_time, sf8 sampling_frequency, ui4 block_samples, RED_PROCESSING_STRUCT *proto_rps, si4 number_of_threads)
 {
-        si1	hex_str[HEX_STRING_BYTES(4)], *s;
-	si4	i;
-        
-        
-	printf("----------- File Processing Structure - START ----------\n");
-	UTF8_printf("Full File Name: %s\n", fps->full_file_name);
-	if (fps->fd == -1)
-		printf("File Descriptor: %d (closed)\n", fps->fd);
-	else
-		printf("File Descriptor: %d (open)\n", fps->fd);
-	printf("File Length: ");
-	if (fps->file_length == FPS_FILE_LENGTH_UNKNOWN)
-		printf("unknown\n");
-	else
-		#ifdef _WIN32
-			printf("%lld\n", fps->file_length);
-		#else
-			printf("%ld\n", fps->file_length);
-		#endif
-	s = (si1 *) &fps->file_type_code;
-	generate_hex_string((ui1 *) s, 4, hex_str);
-        printf("File Type Code: %s    (", hex_str);
-	for (i = 0; i < 4; ++i)
-		printf(" %c ", *s++);
-	printf(")\n");
-	#ifdef _WIN32
-		printf("Raw Data Bytes: %lld\n", fps->raw_data_bytes);
-	#else
-		printf("Raw Data Bytes: %ld\n", fps->raw_data_bytes);
-	#endif
-	show_password_data(fps);
-	show_universal_header(fps);
-	if (fps->raw_data_bytes > UNIVERSAL_HEADER_BYTES) {
-		switch (fps->file_type_code) {
-			case TIME_SERIES_METADATA_FILE_TYPE_CODE:
-			case VIDEO_METADATA_FILE_TYPE_CODE:
-				show_metadata(fps);
-				break;
-			case RECORD_DATA_FILE_TYPE_CODE:
-				show_records(fps);
-				break;
-			default:
-				break;
+	RED_ENCODE_TASK_ARGS	args;
+	RED_BLOCK_HEADER	*block_header;
+	TIME_SERIES_INDEX	*tsi;
+	UNIVERSAL_HEADER	*uh;
+	si8			i, n_blocks, batch_blocks, n_tasks, existing_indices, data_bytes, batch_bytes;
+	si4			n_threads;
+	ui4			max_block_samples;
+	
+	
+	// RED encode samples in parallel & append the blocks to data_fps and their indices to indices_fps
+	// blocks are encoded in batches into fixed size slots (one per block), then copied in order, so the output is identical to serial encoding
+	// start_sample is relative to the segment start, start_time is the time of samples[0]
+	if (number_of_samples <= 0 || block_samples == 0)
+		return(0);
+	n_blocks = (number_of_samples + (si8) block_samples - 1) / (si8) block_samples;
+	
+	n_threads = THREAD_number_of_threads(number_of_threads, n_blocks);
+	batch_blocks = (si8) n_threads * RED_ENCODE_BATCH_BLOCKS_PER_THREAD;
+	if (batch_blocks > n_blocks)
+		batch_blocks = n_blocks;
+	
+	// per-thread processing structs (no compressed data array: the block header pointer is set to the task's slot)
+	args.rps = (RED_PROCESSING_STRUCT **) e_calloc((size_t) n_threads, sizeof(RED_PROCESSING_STRUCT *), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	for (i = 0; i < n_threads; ++i) {
+		args.rps[i] = RED_allocate_processing_struct(0, 0, block_samples, RED_MAX_DIFFERENCE_BYTES(block_samples), block_samples, block_samples, proto_rps->password_data);
+		args.rps[i]->compression = proto_rps->compression;
+		args.rps[i]->directives = proto_rps->directives;
+		args.rps[i]->directives.return_lossy_data = MEF_FALSE;
+		args.rps[i]->directives.reset_discontinuity = MEF_FALSE;
+	}
+	args.samples = samples;
+	args.number_of_samples = number_of_samples;
+	args.number_of_blocks = n_blocks;
+	args.block_samples = block_samples;
+	args.start_time = start_time;
+	args.sampling_frequency = sampling_frequency;
+	args.discontinuity = proto_rps->directives.discontinuity;
+	args.slot_bytes = RED_MAX_COMPRESSED_BYTES((si8) block_samples, 1);
+	args.block_slots = (ui1 *) e_calloc((size_t) (batch_blocks * args.slot_bytes), sizeof(ui1), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	args.tsi = (TIME_SERIES_INDEX *) e_calloc((size_t) batch_blocks, sizeof(TIME_SERIES_INDEX), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	
+	// make room for the new indices
+	existing_indices = (indices_fps->raw_data_bytes - UNIVERSAL_HEADER_BYTES) / TIME_SERIES_INDEX_BYTES;
+	reallocate_file_processing_struct(indices_fps, UNIVERSAL_HEADER_BYTES + ((existing_indices + n_blocks) * TIME_SERIES_INDEX_BYTES));
+	tsi = indices_fps->time_series_indices + existing_indices;
+	
+	max_block_samples = 0;
+	for (args.first_block = 0; args.first_block < n_blocks; args.first_block += n_tasks) {
+		n_tasks = n_blocks - args.first_block;
+		if (n_tasks > batch_blocks)
+			n_tasks = batch_blocks;
+		
+		// encode
+		(void) THREAD_run_tasks(RED_encode_block_task, (void *) &args, n_tasks, n_threads);
+		
+		// serialize
+		for (batch_bytes = i = 0; i < n_tasks; ++i)
+			batch_bytes += args.tsi[i].block_bytes;
+		data_bytes = data_fps->raw_data_bytes;
+		reallocate_file_processing_struct(data_fps, data_bytes + batch_bytes);
+		for (i = 0; i < n_tasks; ++i) {
+			block_header = (RED_BLOCK_HEADER *) (args.block_slots + (i * args.slot_bytes));
+			memcpy(data_fps->raw_data + data_bytes, (void *) block_header, (size_t) block_header->block_bytes);
+			*tsi = args.tsi[i];
+			tsi->file_offset = data_bytes;
+			tsi->start_sample += start_sample;
+			if (tsi->number_of_samples > max_block_samples)
+				max_block_samples = tsi->number_of_samples;
+			data_bytes += block_header->block_bytes;
+			++tsi;
 		}
 	}
-	printf("------------ File Processing Structure - END -----------\n\n");
-        
-        
-	return;
+	
+	// update universal headers
+	uh = data_fps->universal_header;
+	if (uh->number_of_entries < 0)
+		uh->number_of_entries = 0;
+	uh->number_of_entries += n_blocks;
+	if (uh->maximum_entry_size < (si8) max_block_samples)
+		uh->maximum_entry_size = (si8) max_block_samples;
+	if (uh->start_time == UUTC_NO_ENTRY)
+		uh->start_time = start_time;
+	uh->end_time = start_time + (si8) ((((sf8) number_of_samples * (sf8) 1e6) / sampling_frequency) + 0.5);
+	
+	uh = indices_fps->universal_header;
+	uh->number_of_entries = existing_indices + n_blocks;
+	uh->maximum_entry_size = TIME_SERIES_INDEX_BYTES;
+	uh->start_time = data_fps->universal_header->start_time;
+	uh->end_time = data_fps->universal_header->end_time;
+	
+	// clean up
+	for (i = 0; i < n_threads; ++i)
+		RED_free_processing_struct(args.rps[i]);
+	free(args.rps);
+	free(args.block_slots);
+	free(args.tsi);
+	
+	
+	return(n_blocks);
 }
 
 
-void	show_metadata(FILE_PROCESSING_STRUCT *fps)
+void	RED_encode_exec(RED_PROCESSING_STRUCT *rps, si4 *input_buffer, si1 input_is_detrended)
 {
-	METADATA_SECTION_1		*md1;
-	TIME_SERIES_METADATA_SECTION_2	*tmd2;
-	VIDEO_METADATA_SECTION_2	*vmd2;
-	METADATA_SECTION_3		*md3;
-	si1				hex_str[HEX_STRING_BYTES(CRC_BYTES)];
+	ui4			max_count, extra_bytes, range, r, underflow_bytes, low_bound, temp_ui4;
+	ui4			*counts, *cumulative_counts, scaled_total_counts, *ui4_p1, *ui4_p2;
+        ui1			*compressed_buffer_p, *diff_buffer_p, out_byte, *key, last_byte_val, *last_byte_ptr;
+	sf8			stats_scale;
+	si4			*si4_p1, *si4_p2, diff;
+	si1			*si1_p1, *si1_p2;
+	ui1			*ui1_p, *scaled_counts;
+	si8			i;
+	RED_BLOCK_HEADER	*block_header;
 	
+ 
+	// RED compress from input_buffer to to block_header pointer (compressed data array)
+	block_header = rps->block_header;
 	
-	// assign
-	md1 = fps->metadata.section_1;
-	tmd2 = fps->metadata.time_series_section_2;
-	vmd2 = fps->metadata.video_section_2;
-	md3 = fps->metadata.section_3;
+        // apply recording time offset time
+        if (MEF_context->recording_time_offset_mode & (RTO_APPLY | RTO_APPLY_ON_OUTPUT))
+                apply_recording_time_offset(&block_header->start_time);
+        else if (MEF_context->recording_time_offset_mode & (RTO_REMOVE | RTO_REMOVE_ON_OUTPUT))
+                remove_recording_time_offset(&block_header->start_time);
 	
-	// decrypt if needed
-	if (md1->section_2_encryption > NO_ENCRYPTION || md1->section_3_encryption > NO_ENCRYPTION)
-		decrypt_metadata(fps);
+	// if no samples: fill in an empty block header & return;
+	if (block_header->number_of_samples <= 0) {
+		block_header->flags = 0;
+		block_header->detrend_slope = block_header->detrend_intercept = block_header->scale_factor = (sf4) 0.0;
+		block_header->difference_bytes = block_header->number_of_samples = (ui4) 0;
+		block_header->block_bytes = RED_BLOCK_HEADER_BYTES;
+		bzero(block_header + RED_BLOCK_STATISTICS_OFFSET, RED_BLOCK_STATISTICS_BYTES);
+		block_header->block_CRC = CRC_calculate((ui1 *) block_header + CRC_BYTES, block_header->block_bytes - CRC_BYTES);
+		(void) fprintf(stderr, "%s(): No samples in block => returning without encoding\n", __FUNCTION__);
+		return;
+	}
         
-	// show
-	printf("------------------- Metadata - START -------------------\n");
-	printf("------------------ Section 1 - START -------------------\n");
-	printf("Section 2 Encryption: %d ", md1->section_2_encryption);
-	if (md1->section_2_encryption == NO_ENCRYPTION)
-		printf("(none)\n");
-	else if (md1->section_2_encryption == LEVEL_1_ENCRYPTION)
-		printf("(level 1, currently encrypted)\n");
-	else if (md1->section_2_encryption == LEVEL_2_ENCRYPTION)
-		printf("(level 2, currently encrypted)\n");
-	else if (md1->section_2_encryption == -LEVEL_1_ENCRYPTION)
-		printf("(level 1, currently decrypted)\n");
-	else if (md1->section_2_encryption == -LEVEL_2_ENCRYPTION)
-		printf("(level 2, currently decrypted)\n");
+        // detrend from input_buffer to detrended_buffer (lossless)
+	if (rps->directives.detrend_data == MEF_TRUE && input_is_detrended == MEF_FALSE)
+		input_buffer = RED_detrend(rps, input_buffer, rps->detrended_buffer);
+	
+        // scale if scale factor > 1 in block_header (lossy)
+        if (block_header->scale_factor > (sf4) 1.0)
+                input_buffer = RED_scale(rps, input_buffer, rps->scaled_buffer);
+        
+	// generate differences
+        si4_p1 = input_buffer;
+	si4_p2 = si4_p1 + 1;
+	si1_p1 = rps->difference_buffer;  // first 4 bytes are keysample without keysample flag (-128)
+	si1_p2 = (si1 *) si4_p1;
+	*si1_p1++ = *si1_p2++; *si1_p1++ = *si1_p2++; *si1_p1++ = *si1_p2++; *si1_p1++ = *si1_p2;
+	for (i = block_header->number_of_samples; --i;) {
+		diff = *si4_p2++ - *si4_p1++;
+		if (diff > 127 || diff < -127) {
+			si1_p2 = (si1 *) si4_p1;
+			*si1_p1++ = -128;
+			*si1_p1++ = *si1_p2++; *si1_p1++ = *si1_p2++; *si1_p1++ = *si1_p2++; *si1_p1++ = *si1_p2;
+		} else
+			*si1_p1++ = (si1) diff;
+	}
+	block_header->difference_bytes = (ui4) (si1_p1 - rps->difference_buffer);
+        
+	// generate statistics
+	counts = rps->counts;
+	bzero(counts, RED_BLOCK_STATISTICS_BYTES * sizeof(ui4));
+	ui1_p = (ui1 *) rps->difference_buffer;
+	for (i = block_header->difference_bytes; i--;)
+		++counts[*ui1_p++];
+	ui4_p1 = counts;
+	max_count = *ui4_p1;
+	for (i = RED_BLOCK_STATISTICS_BYTES; --i;)
+		if (*++ui4_p1 > max_count)
+			max_count = *ui4_p1;
+	ui1_p = scaled_counts = block_header->statistics;
+	ui4_p1 = counts;
+	if (max_count > 255) {
+		stats_scale = (sf8) 254.999999999 / (sf8) max_count;
+		for (i = RED_BLOCK_STATISTICS_BYTES; i--; ++ui4_p1) {
+			if (*ui4_p1)
+				*ui1_p++ = (ui1) ceil((sf8) *ui4_p1 * stats_scale);
+			else
+				*ui1_p++ = 0;
+		}
+	} else {
+		for (i = RED_BLOCK_STATISTICS_BYTES; i--;)
+			*ui1_p++ = (ui1) *ui4_p1++;
+	}
+	*(ui4_p1 = cumulative_counts = rps->counts) = 0;
+	ui4_p2 = ui4_p1 + 1;
+	ui1_p = scaled_counts;
+	for (i = RED_BLOCK_STATISTICS_BYTES; i--;)
+		*ui4_p2++ = (ui4) *ui1_p++ + *ui4_p1++;
+	scaled_total_counts = *ui4_p1;
+	
+	// range encode
+	low_bound = out_byte = underflow_bytes = 0;
+	range = TOP_VALUE;
+	last_byte_val = *(last_byte_ptr = compressed_buffer_p = ((ui1 *) rps->block_header + RED_BLOCK_HEADER_BYTES - 1)); // first byte is junk - save & overwrite last statistics byte
+	diff_buffer_p = (ui1 *) rps->difference_buffer;
+	for(i = block_header->difference_bytes; i--; ++diff_buffer_p) {
+                while (range <= BOTTOM_VALUE) {
+                        if (low_bound < CARRY_CHECK) {
+                                *compressed_buffer_p++ = out_byte;
+                                for (; underflow_bytes; --underflow_bytes)
+                                        *compressed_buffer_p++ = 0xff;
+                                out_byte = (ui1) (low_bound >> SHIFT_BITS);
+                        } else if (low_bound & TOP_VALUE) {
+                                *compressed_buffer_p++ = out_byte + 1;
+                                for (; underflow_bytes; --underflow_bytes)
+                                        *compressed_buffer_p++ = 0;
+                                out_byte = (ui1) (low_bound >> SHIFT_BITS);
+                        } else
+                                ++underflow_bytes;
+                        range <<= 8;
+                        low_bound = (low_bound << 8) & TOP_VALUE_MINUS_1;
+                }
+                low_bound += (temp_ui4 = (r = range / scaled_total_counts) * cumulative_counts[*diff_buffer_p]);
+                if (*diff_buffer_p < 0xff)
+                        range = r * (ui4) scaled_counts[*diff_buffer_p];
+                else
+                        range -= temp_ui4;
+        }
+	while (range <= BOTTOM_VALUE) {
+		if (low_bound < CARRY_CHECK) {
+			*compressed_buffer_p++ = out_byte;
+			for (; underflow_bytes; --underflow_bytes)
+				*compressed_buffer_p++ = 0xff;
+			out_byte = (ui1) (low_bound >> SHIFT_BITS);
+		} else if (low_bound & TOP_VALUE) {
+			*compressed_buffer_p++ = out_byte + 1;
+			for (; underflow_bytes; --underflow_bytes)
+				*compressed_buffer_p++ = 0;
+			out_byte = (ui1) (low_bound >> SHIFT_BITS);
+		} else
+			++underflow_bytes;
+		range <<= 8;
+		low_bound = (low_bound << 8) & TOP_VALUE_MINUS_1;
+	}
+	temp_ui4 = (low_bound >> SHIFT_BITS) + 1;
+	if (temp_ui4 > 0xff) {
+		*compressed_buffer_p++ = out_byte + 1;
+		for (; underflow_bytes; --underflow_bytes)
+			*compressed_buffer_p++ = 0;
+	} else {
+		*compressed_buffer_p++ = out_byte;
+		for (; underflow_bytes; --underflow_bytes)
+			*compressed_buffer_p++ = 0xff;
+	}
+	*compressed_buffer_p++ = temp_ui4 & 0xff;
+        *compressed_buffer_p++ = 0;
+	
+	// replace last statistics byte
+	*last_byte_ptr = last_byte_val;
+        
+        // add one for uncoded initial keysample flag - need that byte allocated in decode
+        ++block_header->difference_bytes;
+        
+        // align to 8-byte boundary
+	block_header->block_bytes = (ui4) (compressed_buffer_p - (ui1 *) block_header);
+	extra_bytes = block_header->block_bytes % 8;
+	if (extra_bytes) {
+		extra_bytes = 8 - extra_bytes;
+		for (i = extra_bytes; i--;)
+			*compressed_buffer_p++ = PAD_BYTE_VALUE;
+                block_header->block_bytes += extra_bytes;
+	}
+
+        // flags
+        block_header->flags = 0;
+        
+        // encrypt
+        if (rps->directives.encryption_level > NO_ENCRYPTION) {
+                if (rps->password_data->access_level >= rps->directives.encryption_level) {
+                        if (rps->directives.encryption_level == LEVEL_1_ENCRYPTION) {
+                                key = rps->password_data->level_1_encryption_key;
+				block_header->flags |= RED_LEVEL_1_ENCRYPTION_MASK;
+				block_header->flags &= ~RED_LEVEL_2_ENCRYPTION_MASK;
+			} else {
+                                key = rps->password_data->level_2_encryption_key;
+				block_header->flags &= ~RED_LEVEL_1_ENCRYPTION_MASK;
+				block_header->flags |= RED_LEVEL_2_ENCRYPTION_MASK;
+			}
+                        AES_encrypt(block_header->statistics, block_header->statistics, NULL, key);
+                } else {
+                        (void) fprintf(stderr, "%c\n%s(): Cannot encrypt data => returning without encrypting\n", 7, __FUNCTION__);
+                }
+	} else {
+		block_header->flags &= ~RED_LEVEL_1_ENCRYPTION_MASK;
+		block_header->flags &= ~RED_LEVEL_2_ENCRYPTION_MASK;
+		rps->directives.encryption_level = NO_ENCRYPTION;
+	}
+        
+        // discontinuity
+	if (rps->directives.discontinuity == MEF_TRUE) {
+                block_header->flags |= RED_DISCONTINUITY_MASK;
+		if (rps->directives.reset_discontinuity == MEF_TRUE)
+			rps->directives.discontinuity = MEF_FALSE;
+	}
+	
+        // calculate CRC
+        block_header->block_CRC = CRC_calculate((ui1 *) block_header + CRC_BYTES, block_header->block_bytes - CRC_BYTES);
+	
+	
+	return;
+}
+
+
+void 	RED_encode_lossy(RED_PROCESSING_STRUCT *rps)
+{
+	si1			input_is_detrended, compression_mode;
+	si8			i;
+        si4			*input_buffer;
+	sf8			original_size, goal_compression_ratio, r;
+	sf8			low_sf, high_sf, mrr, mrr2, mrr5, sf_per_mrr;
+	sf8			goal_low_bound, goal_high_bound, goal_mrr, goal_tol;
+	sf4			new_scale_factor;
+	RED_BLOCK_HEADER	*block_header;
+	
+	mrr = 0;
+
+
+	// RED compress from original_ptr to block_header pointer (compressed data array)
+	input_buffer = rps->original_ptr;
+	block_header = rps->block_header;
+	
+	// detrend data from original_ptr to detrended_buffer
+	if (rps->directives.detrend_data == MEF_TRUE) {
+		input_buffer = RED_detrend(rps, input_buffer, rps->detrended_buffer);
+		input_is_detrended = MEF_TRUE;
+	} else {
+		input_is_detrended = MEF_FALSE;
+	}
+        
+        // check block normality
+        compression_mode = rps->compression.mode;
+        if (rps->directives.require_normality == MEF_TRUE) {
+                r = RED_test_normality(input_buffer, block_header->number_of_samples);
+		if (r < rps->directives.normal_correlation)
+                        compression_mode = RED_LOSSLESS_COMPRESSION;
+        }
+	
+	// RED encode
+	switch(compression_mode) {
+		case RED_LOSSLESS_COMPRESSION:
+			block_header->scale_factor = (sf4) 1.0; // fall through to RED_FIXED_SCALE_FACTOR
+		case RED_FIXED_SCALE_FACTOR:
+			RED_encode_exec(rps, input_buffer, input_is_detrended);
+			break;
+		case RED_FIXED_COMPRESSION_RATIO:
+			goal_compression_ratio = rps->compression.goal_compression_ratio;
+			goal_low_bound = goal_compression_ratio - rps->compression.goal_tolerance;
+			goal_high_bound = goal_compression_ratio + rps->compression.goal_tolerance;
+			block_header->scale_factor = (sf4) 1.0;
+			RED_encode_exec(rps, input_buffer, input_is_detrended);
+			original_size = (sf8) block_header->number_of_samples * (sf8) sizeof(si4);
+			rps->compression.actual_compression_ratio = (sf8) block_header->block_bytes / original_size;
+			if (rps->compression.actual_compression_ratio <= goal_high_bound)
+				break;
+			// loop until acceptable scale factor found
+			for (i = rps->compression.maximum_rounds_per_block; i--;) {
+				new_scale_factor = block_header->scale_factor * (sf4) (rps->compression.actual_compression_ratio / goal_compression_ratio);
+				if ((ABS(new_scale_factor - block_header->scale_factor) <= (sf4) 0.000001) || (new_scale_factor <= (sf4) 1.0))
+					break;
+				block_header->scale_factor = new_scale_factor;
+				RED_encode_exec(rps, input_buffer, input_is_detrended);
+				rps->compression.actual_compression_ratio = (sf8) block_header->block_bytes / original_size;
+				if ((rps->compression.actual_compression_ratio <= goal_high_bound) && (rps->compression.actual_compression_ratio >= goal_low_bound))
+					break;
+			}
+			break;
+		case RED_MEAN_RESIDUAL_RATIO:
+                        // get residual ratio at sf 2 & 5 (roughly linear relationship: reasonable sample points)
+                        block_header->scale_factor = (sf4) 2.0;
+                        RED_generate_lossy_data(rps, input_buffer, rps->decompressed_ptr, input_is_detrended);
+                        mrr2 = RED_calculate_mean_residual_ratio(rps->original_ptr, rps->decompressed_ptr, block_header->number_of_samples);
+                        if (mrr2 == (sf8) 0.0) {  // all zeros in block
+                                block_header->scale_factor = (sf4) 1.0;
+                                rps->compression.actual_mean_residual_ratio = (sf8) 0.0;
+                                RED_encode_exec(rps, input_buffer, input_is_detrended);
+                                break;
+                        }
+                        block_header->scale_factor = (sf4) 5.0;
+                        RED_generate_lossy_data(rps, input_buffer, rps->decompressed_ptr, input_is_detrended);
+                        mrr5 = RED_calculate_mean_residual_ratio(rps->original_ptr, rps->decompressed_ptr, block_header->number_of_samples);
+                        sf_per_mrr = (sf8) 3.0 / (mrr5 - mrr2);
+                        // estimate starting points
+                        goal_mrr = rps->compression.goal_mean_residual_ratio;
+                        goal_tol = rps->compression.goal_tolerance;
+                        goal_low_bound = goal_mrr - goal_tol;
+                        goal_high_bound = goal_mrr + goal_tol;
+                        block_header->scale_factor = (sf4) (((goal_mrr - mrr2) * sf_per_mrr) + (sf8) 2.0);
+                        high_sf = ((goal_high_bound - mrr2) * sf_per_mrr) + (sf8) 2.0;
+                        high_sf *= (sf8) 2.0;  // empirically reasonable
+                        low_sf = (sf8) 1.0;
+			for (i = rps->compression.maximum_rounds_per_block; i--;) {
+				RED_generate_lossy_data(rps, input_buffer, rps->decompressed_ptr, input_is_detrended);
+				mrr = RED_calculate_mean_residual_ratio(rps->original_ptr, rps->decompressed_ptr, block_header->number_of_samples);
+				if (mrr < goal_low_bound)
+					low_sf = (sf8) block_header->scale_factor;
+				else if (mrr > goal_high_bound)
+					high_sf = (sf8) block_header->scale_factor;
+                                else
+                                        break;
+                                new_scale_factor = (sf4) ((low_sf + high_sf) / (sf8) 2.0);
+                                if (new_scale_factor <= (sf4) 1.0)
+                                        break;
+                                if ((high_sf - low_sf) < (sf8) 0.005) {
+                                        block_header->scale_factor = new_scale_factor;
+                                        break;
+                                }
+                                block_header->scale_factor = new_scale_factor;
+			}
+			rps->compression.actual_mean_residual_ratio = mrr;
+			RED_encode_exec(rps, input_buffer, input_is_detrended);
+			break;
+		default:
+			(void) fprintf(stderr, "%c\n%s(): unrecognized compression mode (%d) => exiting\n", 7, __FUNCTION__, rps->compression.mode);
+			exit(1);
+			break;
+	}
+	
+	// generate lossy data from input_buffer to decompressed_ptr
+	if (rps->directives.return_lossy_data == MEF_TRUE)
+		RED_generate_lossy_data(rps, input_buffer, rps->decompressed_ptr, input_is_detrended);
+	
+	
+	return;
+}
+
+
+void	RED_filter(FILT_PROCESSING_STRUCT *filtps)
+{
+	si4	*si4_p;
+	si8	i;
+	sf8	*sf8_p;
+	
+	
+	// filter
+	FILT_filtfilt(filtps);
+	
+	// make si4 version of filtered data
+	si4_p = filtps->filt_data;
+	sf8_p = filtps->sf8_filt_data;
+	for (i = filtps->data_length; i--;)
+		*si4_p++ = RED_round(*sf8_p++);
+	
+	
+	return;
+}
+
+
+void	RED_find_extrema(si4 *buffer, si8 number_of_samples, TIME_SERIES_INDEX *tsi)
+{
+	si4	min, max;
+	si8	i;
+	
+	
+	min = max = *buffer;
+	for (i = number_of_samples - 1; i--;) {
+		if (*++buffer > max)
+			max = *buffer;
+		else if (*buffer < min)
+			min = *buffer;
+	}
+	
+	tsi->maximum_sample_value = max;
+	tsi->minimum_sample_value = min;
+
+	
+	return;
+}
+
+
+void	RED_free_processing_struct(RED_PROCESSING_STRUCT *rps)
+{
+	if (rps->original_data != NULL)
+		free(rps->original_data);
+	
+	if (rps->decompressed_data != NULL)
+		free(rps->decompressed_data);
+	
+	if (rps->compressed_data != NULL)
+		free(rps->compressed_data);
+	
+	if (rps->difference_buffer != NULL)
+		free(rps->difference_buffer);
+	
+	if (rps->detrended_buffer != NULL)
+		free(rps->detrended_buffer);
+	
+	if (rps->scaled_buffer != NULL)
+		free(rps->scaled_buffer);
+	
+	free(rps);
+	
+        
+	return;
+}
+
+
+void	RED_generate_lossy_data(RED_PROCESSING_STRUCT *rps, si4 *input_buffer, si4 *output_buffer, si1 input_is_detrended)
+{	
+	
+        // generates lossy data from input_buffer to output_buffer
+	// if input_buffer == output_buffer lossy data will be made in place
+        	
+	// detrend from input_buffer to output_buffer (lossless)
+	if (rps->directives.detrend_data == MEF_TRUE && input_is_detrended == MEF_FALSE) {
+		input_buffer = RED_detrend(rps, input_buffer, output_buffer);
+		input_is_detrended = MEF_TRUE;
+	}
+
+        // scale from input_buffer to output_buffer (lossy)
+	input_buffer = RED_scale(rps, input_buffer, output_buffer);
+                
+	// unscale from input_buffer to output_buffer
+	input_buffer = RED_unscale(rps, input_buffer, output_buffer);
+	
+        // retrend from input_buffer to output_buffer
+	if (input_is_detrended == MEF_TRUE)
+		RED_retrend(rps, input_buffer, output_buffer);
+
+	
+        return;
+}
+
+	       
+sf8	*RED_initialize_normal_CDF_table(si4 global_flag)
+{
+	sf8	*cdf_table;
+	
+	
+	cdf_table = (sf8 *) e_calloc((size_t) RED_NORMAL_CDF_TABLE_ENTRIES, sizeof(sf8), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	
+	{
+		sf8 temp[RED_NORMAL_CDF_TABLE_ENTRIES] = RED_NORMAL_CDF_TABLE;
+		memcpy(cdf_table, temp, RED_NORMAL_CDF_TABLE_ENTRIES * sizeof(sf8));
+	}
+	
+	if (global_flag == MEF_TRUE) {
+		MEF_globals->RED_normal_CDF_table = cdf_table;
+		return(NULL);
+	}
+	
+	
+	return(cdf_table);
+}
+
+
+si4	*RED_retrend(RED_PROCESSING_STRUCT *rps, si4 *input_buffer, si4 *output_buffer)
+{
+	si4			*si4_p1, *si4_p2;
+	si8			i;
+	sf8			m, b, c;
+	RED_BLOCK_HEADER	*block_header;
+	
+	
+	// retrend data from input_buffer to output_buffer
+	// if input_buffer == output_buffer retrending data will be done in place
+	
+	block_header = rps->block_header;
+
+	m = (sf8) block_header->detrend_slope;
+	b = (sf8) (sf8) block_header->detrend_intercept;
+	c = (sf8) 0.0;
+	si4_p1 = input_buffer;
+	si4_p2 = output_buffer;
+	for (i = block_header->number_of_samples; i--;) {
+                c += (sf8) 1.0;
+		*si4_p2++ = RED_round( (sf8) *si4_p1++ + (m * c) + b);
+	}
+	
+
+	return(output_buffer);
+}
+
+
+inline si4 RED_round(sf8 val)
+{
+	if (val >= 0.0) {
+		if ((val += 0.5) >= (sf8) RED_POSITIVE_INFINITY)
+			return(RED_POSITIVE_INFINITY);
+	} else {
+		if ((val -= 0.5) <= (sf8) RED_NEGATIVE_INFINITY)
+			return(RED_NEGATIVE_INFINITY);
+	}
+	
+	
+	return((si4) val);
+}
+
+
+si4	*RED_scale(RED_PROCESSING_STRUCT *rps, si4 *input_buffer, si4 *output_buffer)
+{
+        si4	*si4_p1, *si4_p2;
+        si8	i;
+        sf8	sf;
+	
+	
+	// scale from input_buffer to output_buffer
+	// if input_buffer == output_buffer scaling will be done in place
+	
+        si4_p1 = input_buffer;
+        si4_p2 = output_buffer;
+        sf = (sf8) rps->block_header->scale_factor;
+        for (i = rps->block_header->number_of_samples; i--;)
+                *si4_p2++ = RED_round((sf8) *si4_p1++ / sf);
+	
+        
+        return(output_buffer);
+}
+
+
+void	RED_show_block_header(RED_BLOCK_HEADER *bh)
+{
+	si1			hex_str[HEX_STRING_BYTES(RED_BLOCK_STATISTICS_BYTES)], time_str[TIME_STRING_BYTES];
+	
+	
+	printf("--------------- RED Block Header - START ---------------\n");
+	if (bh->block_CRC == CRC_NO_ENTRY)
+		printf("Block CRC: no entry\n");
+	else {
+		generate_hex_string((ui1 *) &bh->block_CRC, CRC_BYTES, hex_str);
+		printf("Block CRC: %s\n", hex_str);
+	}
+	generate_hex_string((ui1 *) &bh->flags, 1, hex_str);
+	printf("Flags: %s\n", hex_str);
+	printf("Detrend Slope: %f\n", bh->detrend_slope);
+	printf("Detrend Intercept: %f\n", bh->detrend_intercept);
+	printf("Scale Factor: %f\n", bh->scale_factor);
+	printf("Difference Bytes: %u\n", bh->difference_bytes);
+	printf("Number of Samples: %u\n", bh->number_of_samples);
+	printf("Block Bytes: %u\n", bh->block_bytes);
+	if (bh->start_time == UUTC_NO_ENTRY)
+		printf("Start Time: no entry\n");
+	else {
+		local_date_time_string(bh->start_time, time_str);
+		if (bh->start_time < 0)
+			printf("Offset ");
+		#ifdef _WIN32
+			printf("Start Time: %lld (uUTC), %s (ascii, local)\n", ABS(bh->start_time), time_str);
+		#else
+			printf("Start Time: %ld (uUTC), %s (ascii, local)\n", ABS(bh->start_time), time_str);
+		#endif
+	}
+	generate_hex_string((ui1 *) &bh->statistics, RED_BLOCK_STATISTICS_BYTES, hex_str);
+	printf("Statistics: %s\n", hex_str);
+	printf("---------------- RED Block Header - END ----------------\n\n");
+
+	
+	return;
+}
+
+
+sf8	RED_test_normality(si4 *data, ui4 n_samps)
+{
+	sf8	sx, sx2, sy, sy2, sxy, mx, mx2, sd, val, z, r, n, *norm_cdf;
+	sf8	num, den1, den2, cdf[RED_NORMAL_CDF_TABLE_ENTRIES];
+	si8	i, counts[RED_NORMAL_CDF_TABLE_ENTRIES] = {0};
+        si4	*si4_p, bin;
+        
+        
+        // returns the correlation of the distribution in the data to that expected from a normal distribution
+        
+        // calculate mean & standard deviation
+	n = (sf8) n_samps;
+        si4_p = data;
+        sx = sx2 = (sf8) 0.0;
+        for (i = n_samps; i--;) {
+                val = (sf8) *si4_p++;
+                sx += val;
+                sx2 += val * val;
+        }
+        mx = sx / n;
+        mx2 = sx2 / n;
+        sd = sqrt(mx2 - (mx * mx));
+	
+	// bin the samples
+	si4_p = data;
+	for (i = n_samps; i--;) {
+		val = (sf8) *si4_p++;
+		z = (val - mx) / sd;
+		bin = (si4) ((z + (sf8) 3.1) * (sf8) 10.0);
+		if (bin < 0)
+			bin = 0;
+		if (bin >= RED_NORMAL_CDF_TABLE_ENTRIES)
+			continue;
+		++counts[bin];
+	}
+	
+	// generate data CDF
+	cdf[0] = (sf8) counts[0] / (sf8) n_samps;
+	for (i = 1; i < RED_NORMAL_CDF_TABLE_ENTRIES; ++i)
+		cdf[i] = (sf8) (counts[i] + counts[i - 1]) / n;
+		
+        // calculate correlation between data CDF and normal CDF
+	sx = sx2 = sxy = (sf8) 0.0;
+	sy = (sf8) RED_SUM_NORMAL_CDF;
+	sy2 = (sf8) RED_SUM_SQ_NORMAL_CDF;
+	norm_cdf = MEF_globals->RED_normal_CDF_table;
+	for (i = 0; i < RED_NORMAL_CDF_TABLE_ENTRIES; ++i) {
+		sx += cdf[i];
+		sx2 += cdf[i] * cdf[i];
+		sxy += cdf[i] * norm_cdf[i];
+	}
+	
+	num = (n * sxy) - (sx * sy);
+	den1 = (n * sx2) - (sx * sx);
+	den2 = (n * sy2) - (sy * sy);
+	
+	if (den1 <= (sf8) 0.0)
+		r = (sf8) 0.0;
+	else
+		r = num / (sqrt(den1) * sqrt(den2));
+	
+        return(r);
+}
+
+
+si4	*RED_unscale(RED_PROCESSING_STRUCT *rps, si4 *input_buffer, si4 *output_buffer)
+{
+	si4			*si4_p1, *si4_p2;
+	si8			i;
+	sf8			sf;
+	
+	
+	// unscale from input_buffer to output_buffer
+	// if input_buffer == output_buffer unscaling will be done in place
+	
+	si4_p1 = input_buffer;
+	si4_p2 = output_buffer;
+	sf = (sf8) rps->block_header->scale_factor;
+	for (i = rps->block_header->number_of_samples; i--;)
+		*si4_p2++ = RED_round((sf8) *si4_p1++ * sf);
+	
+	
+	return(output_buffer);
+}
+
+
+inline RED_BLOCK_HEADER	*RED_update_RPS_pointers(RED_PROCESSING_STRUCT *rps, ui1 flags)
+{
+        RED_BLOCK_HEADER	*block_header;
+
+        
+        block_header = rps->block_header;
+	if (flags & RED_UPDATE_ORIGINAL_PTR)
+                rps->original_ptr += block_header->number_of_samples;
+	if (flags & RED_UPDATE_BLOCK_HEADER_PTR)
+                rps->block_header = (RED_BLOCK_HEADER *) ((ui1 *) rps->block_header + block_header->block_bytes);
+        if (flags & RED_UPDATE_DECOMPRESSED_PTR)
+        	rps->decompressed_ptr += block_header->number_of_samples;
+        
+        
+        return(rps->block_header);
+}
+
+
+/*************************************************************************/
+/****************************  END RED FUNCTIONS  ************************/
+/*************************************************************************/
+
+
+si4	remove_line_noise(si4 *data, si8 n_samps, sf8 sampling_frequency, sf8 line_frequency, sf8 *template)
+{
+        FILT_PROCESSING_STRUCT	*filtps;
+        si8			i, j, k, si8_curr_samp, si8_next_samp, median_pt;
+        sf8			*filt_data, sf8_curr_samp, *point_arrays, *pa, sf8_template_len;
+        si4			template_len, n_waveforms;
+        si1			free_template;
+        
+        
+        // filter
+	filtps = FILT_initialize_processing_struct(5, FILT_BANDPASS_TYPE, sampling_frequency, n_samps, MEF_FALSE, MEF_FALSE, line_frequency - 10.0, (line_frequency * 5.0) + 10.0);
+        filtps->orig_data = data;
+        filtps->data_length = n_samps;
+        FILT_filtfilt(filtps);
+        
+        // allocate
+        filt_data = filtps->sf8_filt_data;
+        sf8_template_len = sampling_frequency / line_frequency;
+        template_len = (si4) (sf8_template_len + 0.5);
+        n_waveforms = (si4) ((sf8) n_samps / sf8_template_len);
+        point_arrays = (sf8 *) e_calloc((size_t) template_len * n_waveforms, sizeof(sf8), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	if (template == NULL) {
+                template = (sf8 *) e_calloc((size_t) template_len, sizeof(sf8), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+		free_template = MEF_TRUE;
+	} else {
+		free_template = MEF_FALSE;
+	}
+	
+        // reorder points (a waveform rounded up to template_len samples may end past the data: its last sample is repeated)
+        sf8_curr_samp = 0.0;
+        for  (i = 0; i < n_waveforms; ++i) {
+                si8_curr_samp = (si8) (sf8_curr_samp + 0.5);
+                pa = point_arrays + i;
+                for (j = 0; j < template_len; ++j) {
+                        *pa = filt_data[(si8_curr_samp < n_samps) ? si8_curr_samp++ : n_samps - 1];
+                        pa += n_waveforms;
+                }
+                sf8_curr_samp += sf8_template_len;
+        }
+        
+        // build template from medians (selection only, no full sort needed)
+        median_pt = n_waveforms / 2;
+        pa = point_arrays;
+        for (i = 0; i < template_len; ++i) {
+                template[i] = quickselect_sf8(pa, (si8) n_waveforms, median_pt);
+                pa += n_waveforms;
+        }
+	
+        // subtract template, from the (rounded) start of each waveform to the start of the next (the last to the end of
+        // the data), restarting the template if a waveform is longer than it
+        sf8_curr_samp = 0.0;
+        for  (i = 0; i < n_waveforms; ++i) {
+                si8_curr_samp = (si8) (sf8_curr_samp + 0.5);
+                sf8_curr_samp += sf8_template_len;
+                si8_next_samp = (i < (n_waveforms - 1)) ? (si8) (sf8_curr_samp + 0.5) : n_samps;
+                for (k = si8_curr_samp, j = 0; k < si8_next_samp; ++k, j = (j + 1 == template_len) ? 0 : j + 1)
+                        data[k] = RED_round((sf8) data[k] - template[j]);
+        }
+	
+        // clean up
+        free(point_arrays);
+        FILT_free_processing_struct(filtps, MEF_FALSE, MEF_FALSE);
+        if (free_template == MEF_TRUE)
+                free(template);
+        
+        
+        return(template_len);
+}
+
+
+void	remove_line_noise_adaptive(si4 *data, si8 n_samps, sf8 sampling_frequency, sf8 line_frequency, si4 n_cycles)
+{
+	FILT_PROCESSING_STRUCT	*filtps;
+	si8			i, j, k, si8_curr_samp, si8_next_samp;
+	sf8			*filt_data, sf8_curr_samp, *point_arrays, *templates, *pa, *ma, sf8_template_len;
+	si4			template_len, n_waveforms;
+	
+	
+	// filter
+	filtps = FILT_initialize_processing_struct(5, FILT_BANDPASS_TYPE, sampling_frequency, n_samps, MEF_FALSE, MEF_FALSE, line_frequency - 10.0, (line_frequency * 5.0) + 10.0);
+	filtps->orig_data = data;
+	filtps->data_length = n_samps;
+	FILT_filtfilt(filtps);
+	
+	// allocate
+	filt_data = filtps->sf8_filt_data;
+	sf8_template_len = sampling_frequency / line_frequency;
+	template_len = (si4) (sf8_template_len + 0.5);
+	n_waveforms = (si4) ((sf8) n_samps / sf8_template_len);
+	point_arrays = (sf8 *) e_calloc((size_t) template_len * n_waveforms, sizeof(sf8), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	templates = (sf8 *) e_calloc((size_t) template_len * n_waveforms, sizeof(sf8), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);  // can exceed n_samps
+	
+	// reorder points (a waveform rounded up to template_len samples may end past the data: its last sample is repeated)
+	sf8_curr_samp = 0.0;
+	for  (i = 0; i < n_waveforms; ++i) {
+		si8_curr_samp = (si8) (sf8_curr_samp + 0.5);
+		pa = point_arrays + i;
+		for (j = 0; j < template_len; ++j) {
+			*pa = filt_data[(si8_curr_samp < n_samps) ? si8_curr_samp++ : n_samps - 1];
+			pa += n_waveforms;
+		}
+		sf8_curr_samp += sf8_template_len;
+	}
+	
+	// sort
+	pa = point_arrays;
+	ma = templates;
+	for (i = 0; i < template_len; ++i) {
+		proportion_filt(pa, ma, n_waveforms, 0.5, n_cycles);
+		pa += n_waveforms;
+		ma += n_waveforms;
+	}
+	
+	// subtract the template of each waveform (column i of the running medians), from its (rounded) start to the start of
+	// the next (the last to the end of the data), restarting the template if a waveform is longer than it
+	sf8_curr_samp = 0.0;
+	for  (i = 0; i < n_waveforms; ++i) {
+		si8_curr_samp = (si8) (sf8_curr_samp + 0.5);
+		sf8_curr_samp += sf8_template_len;
+		si8_next_samp = (i < (n_waveforms - 1)) ? (si8) (sf8_curr_samp + 0.5) : n_samps;
+		for (k = si8_curr_samp, j = 0; k < si8_next_samp; ++k, j = (j + 1 == template_len) ? 0 : j + 1)
+			data[k] = RED_round((sf8) data[k] - templates[(j * n_waveforms) + i]);
+	}
+	
+	// clean up
+	free(point_arrays);
+	free(templates);
+	FILT_free_processing_struct(filtps, MEF_FALSE, MEF_FALSE);
+	
+	
+	return;
+}
+
+
+inline void	remove_recording_time_offset(si8 *time)
+{
+        if (*time == UUTC_NO_ENTRY)
+                return;
+	
+	if (*time > 0)  // positive times indicate recording time offset not applied, 0 - unlikely any records started at 1970.
+		return;
+	
+	// remove recording time offset & make positive to indicate removal
+	*time = (-*time) + MEF_context->recording_time_offset;
+	
+	
+	return;
+}
+
+
+/*************************************************************************/
+/*************************  SCAN READER FUNCTIONS  ***********************/
+/*************************************************************************/
+
+
+void	SCAN_READER_free(SCAN_READER *reader)
+{
+	si4	i;
+	
+	
+	if (reader == NULL)
+		return;
+	
+	SCAN_READER_stop(reader);
+	for (i = 0; i < reader->number_of_windows; ++i)
+		free((void *) reader->windows[i].samples);
+	free((void *) reader->windows);
+	THREAD_condition_destroy(&reader->window_ready);
+	THREAD_condition_destroy(&reader->window_free);
+	THREAD_mutex_destroy(&reader->mutex);
+	free((void *) reader);
+	
+	
+	return;
+}
+
+
+SCAN_READER	*SCAN_READER_initialize(CHANNEL *channel, si8 window_samples, si8 step_samples, si8 prefetch_blocks, si4 number_of_threads)
+{
+	SCAN_READER	*reader;
+	si8		n_windows, max_block_samples;
+	si4		i;
+	
+	
+	// windows are [start, start + window_samples) every step_samples from sample 0; the worker starts with the first read
+	if (channel == NULL || channel->channel_type != TIME_SERIES_CHANNEL_TYPE || window_samples <= 0 || step_samples <= 0)
+		return(NULL);
+	if (prefetch_blocks <= 0)
+		prefetch_blocks = SCAN_READER_PREFETCH_BLOCKS_DEFAULT;
+	
+	// enough windows to cover the prefetched blocks (beyond the one being handed out)
+	max_block_samples = (si8) channel->metadata.time_series_section_2->maximum_block_samples;
+	if (max_block_samples <= 0)
+		max_block_samples = window_samples;
+	n_windows = ((prefetch_blocks * max_block_samples) + step_samples - 1) / step_samples + 1;
+	if (n_windows < SCAN_READER_MINIMUM_WINDOWS)
+		n_windows = SCAN_READER_MINIMUM_WINDOWS;
+	else if (n_windows > SCAN_READER_MAXIMUM_WINDOWS)
+		n_windows = SCAN_READER_MAXIMUM_WINDOWS;
+	
+	reader = (SCAN_READER *) e_calloc((size_t) 1, sizeof(SCAN_READER), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	reader->channel = channel;
+	reader->number_of_samples = channel->metadata.time_series_section_2->number_of_samples;
+	reader->window_samples = window_samples;
+	reader->step_samples = step_samples;
+	reader->number_of_threads = number_of_threads;
+	reader->stop = MEF_FALSE;
+	reader->worker_running = MEF_FALSE;
+	reader->number_of_windows = (si4) n_windows;
+	reader->windows = (SCAN_READER_WINDOW *) e_calloc((size_t) n_windows, sizeof(SCAN_READER_WINDOW), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	for (i = 0; i < reader->number_of_windows; ++i)
+		reader->windows[i].samples = (si4 *) e_malloc((size_t) window_samples * sizeof(si4), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	THREAD_mutex_init(&reader->mutex);
+	THREAD_condition_init(&reader->window_ready);
+	THREAD_condition_init(&reader->window_free);
+	
+	// the worker reads in the reader's context: the settings & time constants of the context the channel was read in
+	MEF_initialize_context(&reader->context, MEF_context);
+	reader->context.recording_time_offset = MEF_context->recording_time_offset;
+	reader->context.GMT_offset = MEF_context->GMT_offset;
+	reader->context.DST_start_time = MEF_context->DST_start_time;
+	reader->context.DST_end_time = MEF_context->DST_end_time;
+	
+	// initialize shared tables before the worker uses them
+	if (MEF_globals->CRC_table == NULL)
+		(void) CRC_initialize_table(MEF_TRUE);
+	if (MEF_globals->AES_rsbox_table == NULL)
+		(void) AES_initialize_rsbox_table(MEF_TRUE);
+	
+	
+	return(reader);
+}
+
+
+si8	SCAN_READER_read(SCAN_READER *reader, si8 start_sample, si4 *samples, si8 *failed_blocks)
+{
+	SCAN_READER_WINDOW	*window;
+	si8			n_samples;
+	
+	
+	// copies the window_samples of the window at start_sample (zero-based) into samples, & sets failed_blocks (if not NULL)
+	// returns the number of those samples within the channel (0 past its end), or -1 if the worker could not be started
+	if (failed_blocks != NULL)
+		*failed_blocks = 0;
+	if (start_sample < 0 || start_sample >= reader->number_of_samples)
+		return(0);
+	
+	// forward access continues the prefetch, any other restarts it there
+	if (start_sample != reader->next_sample || reader->worker_running == MEF_FALSE) {
+		if (start_sample != reader->next_sample)
+			++reader->restarts;
+		if (SCAN_READER_seek(reader, start_sample) < 0)
+			return(-1);
+	}
+	
+	THREAD_mutex_lock(&reader->mutex);
+	window = reader->windows + reader->head;
+	if (window->state == SCAN_READER_WINDOW_READY) {
+		++reader->prefetch_hits;
+	} else {
+		++reader->prefetch_misses;
+		while (window->state != SCAN_READER_WINDOW_READY)
+			THREAD_condition_wait(&reader->window_ready, &reader->mutex);
+	}
+	THREAD_mutex_unlock(&reader->mutex);
+	
+	// the worker does not touch ready windows
+	memcpy((void *) samples, (void *) window->samples, (size_t) reader->window_samples * sizeof(si4));
+	n_samples = window->number_of_samples;
+	if (failed_blocks != NULL)
+		*failed_blocks = window->failed_blocks;
+	
+	THREAD_mutex_lock(&reader->mutex);
+	window->state = SCAN_READER_WINDOW_EMPTY;
+	reader->head = (reader->head + 1) % reader->number_of_windows;
+	--reader->filled_windows;
+	reader->next_sample += reader->step_samples;
+	THREAD_condition_broadcast(&reader->window_free);
+	THREAD_mutex_unlock(&reader->mutex);
+	
+	
+	return(n_samples);
+}
+
+
+si4	SCAN_READER_seek(SCAN_READER *reader, si8 start_sample)
+{
+	si4	i;
+	
+	
+	// discards the prefetched windows & restarts the worker at start_sample
+	SCAN_READER_stop(reader);
+	for (i = 0; i < reader->number_of_windows; ++i)
+		reader->windows[i].state = SCAN_READER_WINDOW_EMPTY;
+	reader->filled_windows = reader->head = reader->tail = 0;
+	reader->next_sample = reader->prefetch_sample = start_sample;
+	
+	
+	return(SCAN_READER_start(reader));
+}
+
+
+si4	SCAN_READER_start(SCAN_READER *reader)
+{
+	if (reader->worker_running == MEF_TRUE)
+		return(0);
+	
+	reader->stop = MEF_FALSE;
+	if (THREAD_create(&reader->worker, (THREAD_FUNCTION) SCAN_READER_worker, (void *) reader) != 0)
+		return(-1);
+	reader->worker_running = MEF_TRUE;
+	
+	
+	return(0);
+}
+
+
+void	SCAN_READER_stop(SCAN_READER *reader)
+{
+	if (reader->worker_running == MEF_FALSE)
+		return;
+	
+	// the worker finishes the window it is filling
+	THREAD_mutex_lock(&reader->mutex);
+	reader->stop = MEF_TRUE;
+	THREAD_condition_broadcast(&reader->window_free);
+	THREAD_mutex_unlock(&reader->mutex);
+	THREAD_join(reader->worker);
+	reader->worker_running = MEF_FALSE;
+	
+	
+	return;
+}
+
+
+THREAD_RETURN_TYPE	SCAN_READER_worker(void *reader_args)
+{
+	SCAN_READER		*reader;
+	SCAN_READER_WINDOW	*window;
+	READ_PLAN		plan = {0};
+	si8			n_failed;
+	
+	
+	// fills the ring windows in sequence until stopped, waiting while the ring is full or the channel has been read
+	reader = (SCAN_READER *) reader_args;
+	(void) MEF_set_context(&reader->context);
+	THREAD_mutex_lock(&reader->mutex);
+	while (reader->stop == MEF_FALSE) {
+		if (reader->filled_windows == reader->number_of_windows || reader->prefetch_sample >= reader->number_of_samples) {
+			THREAD_condition_wait(&reader->window_free, &reader->mutex);
+			continue;
+		}
+		window = reader->windows + reader->tail;
+		window->state = SCAN_READER_WINDOW_FILLING;
+		window->start_sample = reader->prefetch_sample;
+		reader->prefetch_sample += reader->step_samples;
+		reader->tail = (reader->tail + 1) % reader->number_of_windows;
+		++reader->filled_windows;
+		THREAD_mutex_unlock(&reader->mutex);
+		
+		(void) READ_PLAN_build_for_samples(reader->channel, window->start_sample, window->start_sample + reader->window_samples, &plan);
+		n_failed = READ_PLAN_execute(reader->channel, &plan, window->samples, reader->number_of_threads);
+		if (n_failed < 0) {  // data could not be read
+			for (n_failed = 0; n_failed < reader->window_samples; ++n_failed)
+				window->samples[n_failed] = RED_NAN;
+			n_failed = plan.number_of_blocks;
+		}
+		window->failed_blocks = n_failed;
+		window->number_of_samples = reader->number_of_samples - window->start_sample;
+		if (window->number_of_samples > reader->window_samples)
+			window->number_of_samples = reader->window_samples;
+		
+		THREAD_mutex_lock(&reader->mutex);
+		window->state = SCAN_READER_WINDOW_READY;
+		THREAD_condition_broadcast(&reader->window_ready);
+	}
+	THREAD_mutex_unlock(&reader->mutex);
+	READ_PLAN_free(&plan, MEF_FALSE);
+	
+	
+	return(0);
+}
+
+
+/*************************************************************************/
+/***********************  END SCAN READER FUNCTIONS  *********************/
+/*************************************************************************/
+
+
+/*************************************************************************/
+/****************************  SHA-256 FUNCTIONS  ************************/
+/*************************************************************************/
+
+// ATTRIBUTION
+//
+// FIPS 180-2 SHA-224/256/384/512 implementation
+// Last update: 02/02/2007
+// Issue date:  04/30/2005
+//
+// Copyright (C) 2005, 2007 Olivier Gay <olivier.gay@a3.epfl.ch>
+// All rights reserved.
+//
+// "Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+// 3. Neither the name of the project nor the names of its contributors
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE PROJECT AND CONTRIBUTORS ``AS IS'' AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED.  IN NO EVENT SHALL THE PROJECT OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+// OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE."
+//
+// ONLY SHA-256 FUNCTIONS ARE INCLUDED IN THE MEF 3.0 LIBRARY
+//
+// Minor modifications for compatibility with the MEF Library.
+
+
+void sha256(const ui1 *message, ui4 len, ui1 *digest)
+{
+	SHA256_ctx	ctx;
+	
+	SHA256_init(&ctx);
+	SHA256_update(&ctx, message, len);
+	SHA256_final(&ctx, digest);
+	
+        
+	return;
+}
+
+
+void SHA256_final(SHA256_ctx *ctx, ui1 *digest)
+{
+	ui4	block_nb;
+	ui4	pm_len;
+	ui4	len_b;
+	
+	block_nb = (1 + ((SHA256_BLOCK_SIZE - 9) < (ctx->len % SHA256_BLOCK_SIZE)));
+	
+	len_b = (ctx->tot_len + ctx->len) << 3;
+	pm_len = block_nb << 6;
+	
+	memset(ctx->block + ctx->len, 0, pm_len - ctx->len);
+	ctx->block[ctx->len] = 0x80;
+	UNPACK32(len_b, ctx->block + pm_len - 4);
+	
+	SHA256_transf(ctx, ctx->block, block_nb);
+	
+	UNPACK32(ctx->h[0], &digest[ 0]);
+	UNPACK32(ctx->h[1], &digest[ 4]);
+	UNPACK32(ctx->h[2], &digest[ 8]);
+	UNPACK32(ctx->h[3], &digest[12]);
+	UNPACK32(ctx->h[4], &digest[16]);
+	UNPACK32(ctx->h[5], &digest[20]);
+	UNPACK32(ctx->h[6], &digest[24]);
+	UNPACK32(ctx->h[7], &digest[28]);
+	
+        
+	return;
+}
+
+
+void SHA256_init(SHA256_ctx *ctx)
+{
+	if (MEF_globals->SHA256_h0_table == NULL)
+		(void) SHA256_initialize_h0_table(MEF_TRUE);
+	
+	ctx->h[0] = MEF_globals->SHA256_h0_table[0]; ctx->h[1] = MEF_globals->SHA256_h0_table[1];
+	ctx->h[2] = MEF_globals->SHA256_h0_table[2]; ctx->h[3] = MEF_globals->SHA256_h0_table[3];
+	ctx->h[4] = MEF_globals->SHA256_h0_table[4]; ctx->h[5] = MEF_globals->SHA256_h0_table[5];
+	ctx->h[6] = MEF_globals->SHA256_h0_table[6]; ctx->h[7] = MEF_globals->SHA256_h0_table[7];
+	
+	ctx->len = 0;
+	ctx->tot_len = 0;
+	
+        
+	return;
+}
+
+
+ui4	*SHA256_initialize_h0_table(si4 global_flag)
+{
+	ui4	*SHA256_h0_table;
+	
+	
+	SHA256_h0_table = (ui4 *) e_calloc((size_t) SHA256_H0_ENTRIES, sizeof(ui4), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	
+	{
+		ui4 temp[SHA256_H0_ENTRIES] = SHA256_H0;
+		memcpy(SHA256_h0_table, temp, SHA256_H0_ENTRIES * sizeof(ui4));
+	}
+	
+	if (global_flag == MEF_TRUE) {
+		MEF_globals->SHA256_h0_table = SHA256_h0_table;
+		return(NULL);
+	}
+	
+        
+	return(SHA256_h0_table);
+}
+
+
+ui4	*SHA256_initialize_k_table(si4 global_flag)
+{
+	ui4	*SHA256_k_table;
+	
+	
+	SHA256_k_table = (ui4 *) e_calloc((size_t) SHA256_K_ENTRIES, sizeof(ui4), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	
+	{
+		ui4 temp[SHA256_K_ENTRIES] = SHA256_K;
+		memcpy(SHA256_k_table, temp, SHA256_K_ENTRIES * sizeof(ui4));
+	}
+	
+	if (global_flag == MEF_TRUE) {
+		MEF_globals->SHA256_k_table = SHA256_k_table;
+		return(NULL);
+	}
+	
+        
+	return(SHA256_k_table);
+}
+
+
+void SHA256_transf(SHA256_ctx *ctx, const ui1 *message, ui4 block_nb)
+{
+	ui4		w[64];
+	ui4		wv[8];
+	ui4		t1, t2;
+	const ui1	*sub_block;
+	si4		i;
+        
+	
+	if (MEF_globals->SHA256_k_table == NULL)
+		(void) SHA256_initialize_k_table(MEF_TRUE);
+	
+	for (i = 0; i < (si4) block_nb; i++) {
+		sub_block = message + (i << 6);
+		
+		PACK32(&sub_block[ 0], &w[ 0]); PACK32(&sub_block[ 4], &w[ 1]);
+		PACK32(&sub_block[ 8], &w[ 2]); PACK32(&sub_block[12], &w[ 3]);
+		PACK32(&sub_block[16], &w[ 4]); PACK32(&sub_block[20], &w[ 5]);
+		PACK32(&sub_block[24], &w[ 6]); PACK32(&sub_block[28], &w[ 7]);
+		PACK32(&sub_block[32], &w[ 8]); PACK32(&sub_block[36], &w[ 9]);
+		PACK32(&sub_block[40], &w[10]); PACK32(&sub_block[44], &w[11]);
+		PACK32(&sub_block[48], &w[12]); PACK32(&sub_block[52], &w[13]);
+		PACK32(&sub_block[56], &w[14]); PACK32(&sub_block[60], &w[15]);
+		
+		SHA256_SCR(16); SHA256_SCR(17); SHA256_SCR(18); SHA256_SCR(19);
+		SHA256_SCR(20); SHA256_SCR(21); SHA256_SCR(22); SHA256_SCR(23);
+		SHA256_SCR(24); SHA256_SCR(25); SHA256_SCR(26); SHA256_SCR(27);
+		SHA256_SCR(28); SHA256_SCR(29); SHA256_SCR(30); SHA256_SCR(31);
+		SHA256_SCR(32); SHA256_SCR(33); SHA256_SCR(34); SHA256_SCR(35);
+		SHA256_SCR(36); SHA256_SCR(37); SHA256_SCR(38); SHA256_SCR(39);
+		SHA256_SCR(40); SHA256_SCR(41); SHA256_SCR(42); SHA256_SCR(43);
+		SHA256_SCR(44); SHA256_SCR(45); SHA256_SCR(46); SHA256_SCR(47);
+		SHA256_SCR(48); SHA256_SCR(49); SHA256_SCR(50); SHA256_SCR(51);
+		SHA256_SCR(52); SHA256_SCR(53); SHA256_SCR(54); SHA256_SCR(55);
+		SHA256_SCR(56); SHA256_SCR(57); SHA256_SCR(58); SHA256_SCR(59);
+		SHA256_SCR(60); SHA256_SCR(61); SHA256_SCR(62); SHA256_SCR(63);
+		
+		wv[0] = ctx->h[0]; wv[1] = ctx->h[1];
+		wv[2] = ctx->h[2]; wv[3] = ctx->h[3];
+		wv[4] = ctx->h[4]; wv[5] = ctx->h[5];
+		wv[6] = ctx->h[6]; wv[7] = ctx->h[7];
+		
+		SHA256_EXP(0,1,2,3,4,5,6,7, 0); SHA256_EXP(7,0,1,2,3,4,5,6, 1);
+		SHA256_EXP(6,7,0,1,2,3,4,5, 2); SHA256_EXP(5,6,7,0,1,2,3,4, 3);
+		SHA256_EXP(4,5,6,7,0,1,2,3, 4); SHA256_EXP(3,4,5,6,7,0,1,2, 5);
+		SHA256_EXP(2,3,4,5,6,7,0,1, 6); SHA256_EXP(1,2,3,4,5,6,7,0, 7);
+		SHA256_EXP(0,1,2,3,4,5,6,7, 8); SHA256_EXP(7,0,1,2,3,4,5,6, 9);
+		SHA256_EXP(6,7,0,1,2,3,4,5,10); SHA256_EXP(5,6,7,0,1,2,3,4,11);
+		SHA256_EXP(4,5,6,7,0,1,2,3,12); SHA256_EXP(3,4,5,6,7,0,1,2,13);
+		SHA256_EXP(2,3,4,5,6,7,0,1,14); SHA256_EXP(1,2,3,4,5,6,7,0,15);
+		SHA256_EXP(0,1,2,3,4,5,6,7,16); SHA256_EXP(7,0,1,2,3,4,5,6,17);
+		SHA256_EXP(6,7,0,1,2,3,4,5,18); SHA256_EXP(5,6,7,0,1,2,3,4,19);
+		SHA256_EXP(4,5,6,7,0,1,2,3,20); SHA256_EXP(3,4,5,6,7,0,1,2,21);
+		SHA256_EXP(2,3,4,5,6,7,0,1,22); SHA256_EXP(1,2,3,4,5,6,7,0,23);
+		SHA256_EXP(0,1,2,3,4,5,6,7,24); SHA256_EXP(7,0,1,2,3,4,5,6,25);
+		SHA256_EXP(6,7,0,1,2,3,4,5,26); SHA256_EXP(5,6,7,0,1,2,3,4,27);
+		SHA256_EXP(4,5,6,7,0,1,2,3,28); SHA256_EXP(3,4,5,6,7,0,1,2,29);
+		SHA256_EXP(2,3,4,5,6,7,0,1,30); SHA256_EXP(1,2,3,4,5,6,7,0,31);
+		SHA256_EXP(0,1,2,3,4,5,6,7,32); SHA256_EXP(7,0,1,2,3,4,5,6,33);
+		SHA256_EXP(6,7,0,1,2,3,4,5,34); SHA256_EXP(5,6,7,0,1,2,3,4,35);
+		SHA256_EXP(4,5,6,7,0,1,2,3,36); SHA256_EXP(3,4,5,6,7,0,1,2,37);
+		SHA256_EXP(2,3,4,5,6,7,0,1,38); SHA256_EXP(1,2,3,4,5,6,7,0,39);
+		SHA256_EXP(0,1,2,3,4,5,6,7,40); SHA256_EXP(7,0,1,2,3,4,5,6,41);
+		SHA256_EXP(6,7,0,1,2,3,4,5,42); SHA256_EXP(5,6,7,0,1,2,3,4,43);
+		SHA256_EXP(4,5,6,7,0,1,2,3,44); SHA256_EXP(3,4,5,6,7,0,1,2,45);
+		SHA256_EXP(2,3,4,5,6,7,0,1,46); SHA256_EXP(1,2,3,4,5,6,7,0,47);
+		SHA256_EXP(0,1,2,3,4,5,6,7,48); SHA256_EXP(7,0,1,2,3,4,5,6,49);
+		SHA256_EXP(6,7,0,1,2,3,4,5,50); SHA256_EXP(5,6,7,0,1,2,3,4,51);
+		SHA256_EXP(4,5,6,7,0,1,2,3,52); SHA256_EXP(3,4,5,6,7,0,1,2,53);
+		SHA256_EXP(2,3,4,5,6,7,0,1,54); SHA256_EXP(1,2,3,4,5,6,7,0,55);
+		SHA256_EXP(0,1,2,3,4,5,6,7,56); SHA256_EXP(7,0,1,2,3,4,5,6,57);
+		SHA256_EXP(6,7,0,1,2,3,4,5,58); SHA256_EXP(5,6,7,0,1,2,3,4,59);
+		SHA256_EXP(4,5,6,7,0,1,2,3,60); SHA256_EXP(3,4,5,6,7,0,1,2,61);
+		SHA256_EXP(2,3,4,5,6,7,0,1,62); SHA256_EXP(1,2,3,4,5,6,7,0,63);
+		
+		ctx->h[0] += wv[0]; ctx->h[1] += wv[1];
+		ctx->h[2] += wv[2]; ctx->h[3] += wv[3];
+		ctx->h[4] += wv[4]; ctx->h[5] += wv[5];
+		ctx->h[6] += wv[6]; ctx->h[7] += wv[7];
+	}
+	
+        
+	return;
+}
+
+
+void SHA256_update(SHA256_ctx *ctx, const ui1 *message, unsigned int len)
+{
+	ui4		block_nb;
+	ui4		new_len, rem_len, tmp_len;
+	const ui1	*shifted_message;
+	
+	tmp_len = SHA256_BLOCK_SIZE - ctx->len;
+	rem_len = len < tmp_len ? len : tmp_len;
+	
+	memcpy(&ctx->block[ctx->len], message, rem_len);
+	
+	if (ctx->len + len < SHA256_BLOCK_SIZE) {
+		ctx->len += len;
+		return;
+	}
+	
+	new_len = len - rem_len;
+	block_nb = new_len / SHA256_BLOCK_SIZE;
+	
+	shifted_message = message + rem_len;
+	
+	SHA256_transf(ctx, ctx->block, 1);
+	SHA256_transf(ctx, shifted_message, block_nb);
+	
+	rem_len = new_len % SHA256_BLOCK_SIZE;
+	
+	memcpy(ctx->block, &shifted_message[block_nb << 6], rem_len);
+	
+	ctx->len = rem_len;
+	ctx->tot_len += (block_nb + 1) << 6;
+	
+        
+	return;
+}
+
+
+/*************************************************************************/
+/**************************  END SHA-256 FUNCTIONS  **********************/
+/*************************************************************************/
+
+
+void	show_file_processing_struct(FILE_PROCESSING_STRUCT *fps)
+{
+        si1	hex_str[HEX_STRING_BYTES(4)], *s;
+	si4	i;
+        
+        
+	printf("----------- File Processing Structure - START ----------\n");
+	UTF8_printf("Full File Name: %s\n", fps->full_file_name);
+	if (fps->fd == -1)
+		printf("File Descriptor: %d (closed)\n", fps->fd);
+	else
+		printf("File Descriptor: %d (open)\n", fps->fd);
+	printf("File Length: ");
+	if (fps->file_length == FPS_FILE_LENGTH_UNKNOWN)
+		printf("unknown\n");
+	else
+		#ifdef _WIN32
+			printf("%lld\n", fps->file_length);
+		#else
+			printf("%ld\n", fps->file_length);
+		#endif
+	s = (si1 *) &fps->file_type_code;
+	generate_hex_string((ui1 *) s, 4, hex_str);
+        printf("File Type Code: %s    (", hex_str);
+	for (i = 0; i < 4; ++i)
+		printf(" %c ", *s++);
+	printf(")\n");
+	#ifdef _WIN32
+		printf("Raw Data Bytes: %lld\n", fps->raw_data_bytes);
+	#else
+		printf("Raw Data Bytes: %ld\n", fps->raw_data_bytes);
+	#endif
+	show_password_data(fps);
+	show_universal_header(fps);
+	if (fps->raw_data_bytes > UNIVERSAL_HEADER_BYTES) {
+		switch (fps->file_type_code) {
+			case TIME_SERIES_METADATA_FILE_TYPE_CODE:
+			case VIDEO_METADATA_FILE_TYPE_CODE:
+				show_metadata(fps);
+				break;
+			case RECORD_DATA_FILE_TYPE_CODE:
+				show_records(fps);
+				break;
+			default:
+				break;
+		}
+	}
+	printf("------------ File Processing Structure - END -----------\n\n");
+        
+        
+	return;
+}
+
+
+void	show_metadata(FILE_PROCESSING_STRUCT *fps)
+{
+	METADATA_SECTION_1		*md1;
+	TIME_SERIES_METADATA_SECTION_2	*tmd2;
+	VIDEO_METADATA_SECTION_2	*vmd2;
+	METADATA_SECTION_3		*md3;
+	si1				hex_str[HEX_STRING_BYTES(CRC_BYTES)];
+	
+	
+	// assign
+	md1 = fps->metadata.section_1;
+	tmd2 = fps->metadata.time_series_section_2;
+	vmd2 = fps->metadata.video_section_2;
+	md3 = fps->metadata.section_3;
+	
+	// decrypt if needed
+	if (md1->section_2_encryption > NO_ENCRYPTION || md1->section_3_encryption > NO_ENCRYPTION)
+		decrypt_metadata(fps);
+        
+	// show
+	printf("------------------- Metadata - START -------------------\n");
+	printf("------------------ Section 1 - START -------------------\n");
+	printf("Section 2 Encryption: %d ", md1->section_2_encryption);
+	if (md1->section_2_encryption == NO_ENCRYPTION)
+		printf("(none)\n");
+	else if (md1->section_2_encryption == LEVEL_1_ENCRYPTION)
+		printf("(level 1, currently encrypted)\n");
+	else if (md1->section_2_encryption == LEVEL_2_ENCRYPTION)
+		printf("(level 2, currently encrypted)\n");
+	else if (md1->section_2_encryption == -LEVEL_1_ENCRYPTION)
+		printf("(level 1, currently decrypted)\n");
+	else if (md1->section_2_encryption == -LEVEL_2_ENCRYPTION)
+		printf("(level 2, currently decrypted)\n");
 	else
 	printf("(unrecognized code)\n");
 	printf("Section 3 Encryption: %d ", md1->section_3_encryption);
@@ -8213,359 +12037,1176 @@ void	show_metadata(FILE_PROCESSING_STRUCT *fps)
 				printf("Video File CRC: %s\n", hex_str);
 			}
 		}
-		else {
-			printf("(unrecognized metadata section 2 type)\n");
+		else {
+			printf("(unrecognized metadata section 2 type)\n");
+		}
+	} else {
+		printf("No access to section 2\n");
+	}
+	printf("------------------- Section 2 - END --------------------\n\n");
+	printf("------------------ Section 3 - START -------------------\n");
+	if (fps->password_data->access_level >= ABS(md1->section_3_encryption)) {
+		if (md3->recording_time_offset == UUTC_NO_ENTRY)
+			printf("Recording Time Offset: no entry\n");
+		else
+			#ifdef _WIN32
+				printf("Recording Time Offset: %lld\n", md3->recording_time_offset);
+			#else
+				printf("Recording Time Offset: %ld\n", md3->recording_time_offset);
+			#endif
+		if (md3->DST_start_time == UUTC_NO_ENTRY)
+			printf("DST Start Time: no entry\n");
+		else
+			#ifdef _WIN32
+				printf("DST Start Time: %lld\n", md3->DST_start_time);
+			#else
+				printf("DST Start Time: %ld\n", md3->DST_start_time);
+			#endif
+		if (md3->DST_end_time == UUTC_NO_ENTRY)
+			printf("DST End Time: no entry\n");
+		else
+			#ifdef _WIN32
+				printf("DST End Time: %lld\n", md3->DST_end_time);
+			#else
+				printf("DST End Time: %ld\n", md3->DST_end_time);
+			#endif
+		if (md3->GMT_offset == GMT_OFFSET_NO_ENTRY)
+			printf("GMT: no entry\n");
+		else
+			printf("GMT Offset: %d\n", md3->GMT_offset);
+		if (strlen(md3->subject_name_1))
+			UTF8_printf("Subject Name 1: %s\n", md3->subject_name_1);
+		else
+			printf("Subject Name 1: no entry\n");
+		if (strlen(md3->subject_name_2))
+			UTF8_printf("Subject Name 2: %s\n", md3->subject_name_2);
+		else
+			printf("Subject Name 2: no entry\n");
+		if (strlen(md3->subject_ID))
+			UTF8_printf("Subject ID: %s\n", md3->subject_ID);
+		else
+			printf("Subject ID: no entry\n");
+		if (strlen(md3->recording_location))
+			UTF8_printf("Recording Location: %s\n", md3->recording_location);
+		else
+			printf("Recording Location: no entry\n");
+	} else {
+		printf("No access to section 3\n");
+	}
+	printf("------------------- Section 3 - END --------------------\n\n");
+	printf("-------------------- Metadata - END --------------------\n\n");
+        
+	
+	return;
+}
+
+
+void	show_password_data(FILE_PROCESSING_STRUCT *fps)
+{
+	PASSWORD_DATA	*pwd;
+        si1		hex_str[HEX_STRING_BYTES(ENCRYPTION_KEY_BYTES)];
+	
+	
+	pwd = fps->password_data;
+	
+	printf("------------------ Password Data - START -----------------\n");
+	if (pwd->access_level >= LEVEL_1_ACCESS) {
+                generate_hex_string(pwd->level_1_encryption_key, ENCRYPTION_KEY_BYTES, hex_str);
+		printf("Level 1 Encryption Key: %s\n", hex_str);
+	}
+	if (pwd->access_level == LEVEL_2_ACCESS) {
+                generate_hex_string(pwd->level_2_encryption_key, ENCRYPTION_KEY_BYTES, hex_str);
+		printf("Level 2 Encryption Key: %s\n", hex_str);
+	}
+	printf("Access Level: %d\n", pwd->access_level);
+	printf("------------------- Password Data - END ------------------\n\n");
+	
+        
+	return;
+}
+
+
+void	show_records(FILE_PROCESSING_STRUCT *fps)
+{
+	si8		number_of_records;
+        ui4		i, r_cnt;
+        ui1		*ui1_p, *end_p;
+        RECORD_HEADER	*record_header;
+        PASSWORD_DATA	*pwd;
+        
+	
+	number_of_records = fps->universal_header->number_of_entries;
+        ui1_p = fps->raw_data + UNIVERSAL_HEADER_BYTES;
+        pwd = fps->password_data;
+	
+	// number_of_records obtained from session metadata - use if passed
+	if (number_of_records == UNKNOWN_NUMBER_OF_ENTRIES) {   // can still process if not passed, but will fail on incomplete final record
+		end_p = fps->raw_data + fps->file_length;
+		r_cnt = 0;
+		while (ui1_p < end_p) {
+			record_header = (RECORD_HEADER *) ui1_p;
+			show_record(record_header, r_cnt, pwd);
+			ui1_p += (RECORD_HEADER_BYTES + record_header->bytes);
+			++r_cnt;
+		}
+		fps->universal_header->number_of_entries = r_cnt;
+	} else {
+                for (i = 0; i < number_of_records; ++i) {
+			record_header = (RECORD_HEADER *) ui1_p;
+			show_record(record_header, i, pwd);
+			ui1_p += (RECORD_HEADER_BYTES + record_header->bytes);
+		}
+	}
+        
+        
+        return;
+}
+
+
+void	show_universal_header(FILE_PROCESSING_STRUCT *fps)
+{
+	UNIVERSAL_HEADER	*uh;
+        si1			hex_str[HEX_STRING_BYTES(PASSWORD_VALIDATION_FIELD_BYTES)], time_str[TIME_STRING_BYTES];
+	ui4			type_code, *file_type_string_int;
+	
+	
+	uh = fps->universal_header;
+	file_type_string_int = (ui4 *) uh->file_type_string;
+	type_code = *file_type_string_int;
+	
+	printf("---------------- Universal Header - START ----------------\n");
+	if (uh->header_CRC == CRC_NO_ENTRY)
+		printf("Header CRC: no entry\n");
+	else {
+                generate_hex_string((ui1 *) &uh->header_CRC, CRC_BYTES, hex_str);
+                printf("Header CRC: %s\n", hex_str);
+        }
+	if (uh->body_CRC == CRC_NO_ENTRY)
+		printf("Body CRC: no entry\n");
+	else {
+		generate_hex_string((ui1 *) &uh->body_CRC, CRC_BYTES, hex_str);
+		printf("Body CRC: %s\n", hex_str);
+	}
+	if (strlen(uh->file_type_string))
+		printf("File Type String: %s\n", uh->file_type_string);
+	else
+		printf("File Type String: no entry\n");
+	if (uh->mef_version_major == UNIVERSAL_HEADER_MEF_VERSION_MAJOR_NO_ENTRY || uh->mef_version_minor == UNIVERSAL_HEADER_MEF_VERSION_MINOR_NO_ENTRY) {
+		if (uh->mef_version_major == UNIVERSAL_HEADER_MEF_VERSION_MAJOR_NO_ENTRY)
+			printf("MEF Version Major: no entry\n");
+		else
+			printf("MEF Version Major: %u\n", uh->mef_version_major);
+		if (uh->mef_version_minor == UNIVERSAL_HEADER_MEF_VERSION_MINOR_NO_ENTRY)
+			printf("MEF Version Minor: no entry\n");
+		else
+			printf("MEF Version Minor: %u\n", uh->mef_version_minor);
+	} else
+		printf("MEF Version: %u.%u\n", uh->mef_version_major, uh->mef_version_minor);
+	if (uh->byte_order_code == UNIVERSAL_HEADER_BYTE_ORDER_CODE_NO_ENTRY)
+		printf("Byte Order Code: no entry ");
+	else {
+		printf("Byte Order Code: %u ", uh->byte_order_code);
+		if (uh->byte_order_code == MEF_LITTLE_ENDIAN)
+			printf("(little endian)\n");
+		else if (uh->byte_order_code == MEF_BIG_ENDIAN)
+			printf("(big endian)\n");
+		else
+			printf("(unrecognized code)\n");
+	}
+	if (uh->start_time == UUTC_NO_ENTRY)
+		printf("Start Time: no entry\n");
+	else {
+		local_date_time_string(uh->start_time, time_str);
+		if (uh->start_time < 0)
+			printf("Offset ");
+		#ifdef _WIN32
+			printf("Start Time: %lld (uUTC), %s (ascii, local)\n", ABS(uh->start_time), time_str);
+		#else
+			printf("Start Time: %ld (uUTC), %s (ascii, local)\n", ABS(uh->start_time), time_str);
+		#endif
+	}
+	if (uh->end_time == UUTC_NO_ENTRY)
+		printf("End Time: no entry\n");
+	else {
+		local_date_time_string(uh->end_time, time_str);
+		if (uh->start_time < 0)
+			printf("Offset ");
+		#ifdef _WIN32
+			printf("End Time: %lld (uUTC), %s (ascii, local)\n", ABS(uh->end_time), time_str);
+		#else
+			printf("End Time: %ld (uUTC), %s (ascii, local)\n", ABS(uh->end_time), time_str);
+		#endif
+	}
+	if (uh->number_of_entries == UNIVERSAL_HEADER_NUMBER_OF_ENTRIES_NO_ENTRY)
+		printf("Number of Entries: no entry\n");
+	else {
+		#ifdef _WIN32
+			printf("Number of Entries: %lld  ", uh->number_of_entries);
+		#else
+			printf("Number of Entries: %ld  ", uh->number_of_entries);
+		#endif
+		switch (type_code) {
+			case RECORD_DATA_FILE_TYPE_CODE:
+				printf("(number of records in the file)\n");
+				break;
+			case RECORD_INDICES_FILE_TYPE_CODE:
+				printf("(number of records indices in the file)\n");
+				break;
+			case TIME_SERIES_METADATA_FILE_TYPE_CODE:
+			case VIDEO_METADATA_FILE_TYPE_CODE:
+				printf("(one metadata entry per metadata file)\n");
+				break;
+			case VIDEO_INDICES_FILE_TYPE_CODE:
+				printf("(number of video indices in the file)\n");
+				break;
+			case TIME_SERIES_DATA_FILE_TYPE_CODE:
+				printf("(number of RED blocks in the file)\n");
+				break;
+			case TIME_SERIES_INDICES_FILE_TYPE_CODE:
+				printf("(number of time series indices in the file)\n");
+				break;
+			default:
+				printf("\n");
+				break;
+		}
+	}
+	if (uh->maximum_entry_size == UNIVERSAL_HEADER_MAXIMUM_ENTRY_SIZE_NO_ENTRY)
+		printf("Maximum Entry Size: no entry\n");
+	else {
+		#ifdef _WIN32
+			printf("Maximum Entry Size: %lld  ", uh->maximum_entry_size);
+		#else
+			printf("Maximum Entry Size: %ld  ", uh->maximum_entry_size);
+		#endif
+		switch (type_code) {
+			case RECORD_DATA_FILE_TYPE_CODE:
+				printf("(number of bytes in the largest record in the file)\n");
+				break;
+			case RECORD_INDICES_FILE_TYPE_CODE:
+				printf("(number of bytes in a record index)\n");
+				break;
+			case TIME_SERIES_METADATA_FILE_TYPE_CODE:
+			case VIDEO_METADATA_FILE_TYPE_CODE:
+				printf("(number of bytes in a metadata file)\n");
+				break;
+			case VIDEO_INDICES_FILE_TYPE_CODE:
+				printf("(number of bytes in the largest clip in the video data file)\n");
+				break;
+			case TIME_SERIES_DATA_FILE_TYPE_CODE:
+				printf("(number of samples in the largest RED block in the file)\n");
+				break;
+			case TIME_SERIES_INDICES_FILE_TYPE_CODE:
+				printf("(number of bytes in a time series index)\n");
+				break;
+			default:
+				printf("\n");
+				break;
+				
 		}
+	}
+	if (uh->segment_number == UNIVERSAL_HEADER_SEGMENT_NUMBER_NO_ENTRY)
+		printf("Segment Number: no entry\n");
+        else if (uh->segment_number == UNIVERSAL_HEADER_CHANNEL_LEVEL_CODE)
+                printf("Segment Number: channel level\n");
+        else if (uh->segment_number == UNIVERSAL_HEADER_SESSION_LEVEL_CODE)
+                printf("Segment Number: session level\n");
+	else
+		printf("Segment Number: %d\n", uh->segment_number);
+	if (strlen(uh->channel_name))
+		UTF8_printf("Channel Name: %s\n", uh->channel_name);
+	else
+		printf("Channel Name: no entry\n");
+	if (strlen(uh->session_name))
+		UTF8_printf("Session Name: %s\n", uh->session_name);
+	else
+		printf("Session Name: no entry\n");
+	if (strlen(uh->anonymized_name))
+		UTF8_printf("Anonymized Name: %s\n", uh->anonymized_name);
+	else
+		printf("Anonymized Name: no entry\n");
+	if (all_zeros(uh->level_UUID, UUID_BYTES) == MEF_TRUE)
+		printf("Level UUID: no entry\n");
+	else {
+		generate_hex_string(uh->level_UUID, UUID_BYTES, hex_str);
+		printf("Level UUID: %s\n", hex_str);
+	}
+	if (all_zeros(uh->file_UUID, UUID_BYTES) == MEF_TRUE)
+		printf("File UUID: no entry\n");
+	else {
+		generate_hex_string(uh->file_UUID, UUID_BYTES, hex_str);
+		printf("File UUID: %s\n", hex_str);
+	}
+	if (all_zeros(uh->provenance_UUID, UUID_BYTES) == MEF_TRUE)
+		printf("Provenance UUID: no entry\n");
+	else {
+		generate_hex_string(uh->provenance_UUID, UUID_BYTES, hex_str);
+		printf("Provenance UUID: %s  ", hex_str);
+		if (memcmp(uh->provenance_UUID, uh->file_UUID, UUID_BYTES))
+			printf("(derived data\n)");
+		else
+			printf("(original data\n)");
+	}
+	if (all_zeros(uh->level_1_password_validation_field, PASSWORD_VALIDATION_FIELD_BYTES) == MEF_TRUE)
+		printf("Level 1 Password Validation_Field: no entry\n");
+	else {
+                generate_hex_string(uh->level_1_password_validation_field, PASSWORD_VALIDATION_FIELD_BYTES, hex_str);
+		printf("Level 1 Password Validation_Field: %s\n", hex_str);
+	}
+	if (all_zeros(uh->level_2_password_validation_field, PASSWORD_VALIDATION_FIELD_BYTES) == MEF_TRUE)
+		printf("Level 2 Password Validation_Field: no entry\n");
+	else {
+                generate_hex_string(uh->level_2_password_validation_field, PASSWORD_VALIDATION_FIELD_BYTES, hex_str);
+		printf("Level 2 Password Validation_Field: %s\n", hex_str);
+	}
+	printf("---------------- Universal Header - END ----------------\n\n");
+	
+        
+	return;
+}
+
+
+void	sift_running_percentile(RUNNING_PERCENTILE *rp, si4 pos)
+{
+	si4	*heap, *heap_pos, base, count, child, parent, slot, rel, sign;
+	sf8	*vals;
+	
+	
+	// restore the heap property around heap[pos] within its own heap (low: max-heap, high: min-heap)
+	vals = rp->vals;
+	heap = rp->heap;
+	heap_pos = rp->heap_pos;
+	if (pos < rp->low_count) {
+		base = 0;
+		count = rp->low_count;
+		sign = 1;
 	} else {
-		printf("No access to section 2\n");
+		base = rp->low_count;
+		count = rp->span - rp->low_count;
+		sign = -1;
+	}
+	slot = heap[pos];
+	rel = pos - base;
+	
+	// sift up
+	while (rel > 0) {
+		parent = (rel - 1) / 2;
+		if (sign * (vals[slot] - vals[heap[base + parent]]) <= 0.0)
+			break;
+		heap[base + rel] = heap[base + parent];
+		heap_pos[heap[base + rel]] = base + rel;
+		rel = parent;
+	}
+	
+	// sift down
+	while ((child = (2 * rel) + 1) < count) {
+		if (child + 1 < count && sign * (vals[heap[base + child + 1]] - vals[heap[base + child]]) > 0.0)
+			++child;
+		if (sign * (vals[heap[base + child]] - vals[slot]) <= 0.0)
+			break;
+		heap[base + rel] = heap[base + child];
+		heap_pos[heap[base + rel]] = base + rel;
+		rel = child;
+	}
+	heap[base + rel] = slot;
+	heap_pos[slot] = base + rel;
+	
+	
+	return;
+}
+
+
+si4     sort_by_idx(const void *n1, const void *n2)
+{
+	si4     i1, i2;
+	
+	
+	i1 = ((NODE *) n1)->idx;
+	i2 = ((NODE *) n2)->idx;
+	
+	return(i1 - i2);
+}
+
+
+si4     sort_by_val(const void *n1, const void *n2)
+{
+	sf8     v1, v2;
+	
+	
+	v1 = ((NODE *) n1)->val;
+	v2 = ((NODE *) n2)->val;
+	
+	if (v1 > v2)
+		return(1);
+	else if (v1 < v2)
+		return(-1);
+	return(0);
+}
+
+
+/*************************************************************************/
+/******************************  STREAM FUNCTIONS  ***********************/
+/*************************************************************************/
+
+
+si4	STREAM_append(TIME_SERIES_STREAM *stream, si4 *samples, si8 number_of_samples, si8 start_time)
+{
+	sf8	sampling_frequency;
+	si8	expected_time, n;
+	
+	
+	// start_time is the time of samples[0], or UUTC_NO_ENTRY if the samples continue the previous ones
+	if (stream->data_fps == NULL)  // segment closed, or the last one failed to open
+		return(-1);
+	
+	sampling_frequency = stream->metadata_fps->metadata.time_series_section_2->sampling_frequency;
+	if (start_time != UUTC_NO_ENTRY) {
+		expected_time = stream->run_start_time + (si8) ((((sf8) (stream->run_samples + stream->buffered_samples) * (sf8) 1e6) / sampling_frequency) + 0.5);
+		if (ABS(start_time - expected_time) > (si8) (((sf8) 5e5 / sampling_frequency) + 0.5)) {  // more than half a sample period off
+			if (STREAM_flush_block(stream) < 0)
+				return(-1);
+			stream->run_start_time = start_time;
+			stream->run_samples = 0;
+			stream->discontinuity = MEF_TRUE;
+		}
+	}
+	
+	// buffer & flush full blocks
+	while (number_of_samples > 0) {
+		n = (si8) (stream->block_samples - stream->buffered_samples);
+		if (n > number_of_samples)
+			n = number_of_samples;
+		memcpy(stream->rps->original_data + stream->buffered_samples, samples, (size_t) n * sizeof(si4));
+		stream->buffered_samples += (ui4) n;
+		samples += n;
+		number_of_samples -= n;
+		if (stream->buffered_samples == stream->block_samples)
+			if (STREAM_flush_block(stream) < 0)
+				return(-1);
+	}
+	
+	
+	return(0);
+}
+
+
+si4	STREAM_close(TIME_SERIES_STREAM *stream)
+{
+	si4	ret_val;
+	
+	
+	ret_val = STREAM_close_segment(stream);
+	
+	RED_free_processing_struct(stream->rps);
+	stream->metadata_fps->directives.free_password_data = MEF_FALSE;  // password data belongs to the prototype
+	free_file_processing_struct(stream->metadata_fps);
+	free(stream);
+	
+	
+	return(ret_val);
+}
+
+
+si4	STREAM_close_segment(TIME_SERIES_STREAM *stream)
+{
+	si4	ret_val;
+	
+	
+	// flush the partial block, make the files consistent, and close them
+	if (stream->data_fps == NULL)  // already closed, or failed to open
+		return(-1);
+	
+	ret_val = STREAM_flush_block(stream);
+	if (STREAM_update(stream) < 0)
+		ret_val = -1;
+	
+	fps_close(stream->data_fps);
+	fps_close(stream->indices_fps);
+	stream->data_fps->directives.free_password_data = stream->indices_fps->directives.free_password_data = MEF_FALSE;
+	free_file_processing_struct(stream->data_fps);
+	free_file_processing_struct(stream->indices_fps);
+	stream->data_fps = stream->indices_fps = NULL;
+	
+	
+	return(ret_val);
+}
+
+
+si4	STREAM_flush_block(TIME_SERIES_STREAM *stream)
+{
+	RED_PROCESSING_STRUCT		*rps;
+	RED_BLOCK_HEADER		*block_header;
+	TIME_SERIES_INDEX		tsi, out_tsi;
+	TIME_SERIES_METADATA_SECTION_2	*tmd2;
+	UNIVERSAL_HEADER		*uh;
+	sf8				sampling_frequency;
+	
+	
+	if (stream->data_fps == NULL)
+		return(-1);
+	if (stream->buffered_samples == 0)
+		return(0);
+	
+	rps = stream->rps;
+	tmd2 = stream->metadata_fps->metadata.time_series_section_2;
+	sampling_frequency = tmd2->sampling_frequency;
+	
+	// encode
+	block_header = rps->block_header = (RED_BLOCK_HEADER *) rps->compressed_data;
+	bzero((void *) block_header, (size_t) RED_BLOCK_HEADER_BYTES);
+	block_header->number_of_samples = stream->buffered_samples;
+	block_header->start_time = stream->run_start_time + (si8) ((((sf8) stream->run_samples * (sf8) 1e6) / sampling_frequency) + 0.5);
+	rps->original_ptr = rps->original_data;
+	rps->directives.discontinuity = stream->discontinuity;
+	bzero((void *) &tsi, sizeof(TIME_SERIES_INDEX));
+	tsi.start_time = block_header->start_time;  // before the encoder applies any recording time offset
+	RED_encode(rps);
+	
+	tsi.file_offset = stream->data_bytes;
+	tsi.start_sample = stream->segment_samples;
+	tsi.number_of_samples = block_header->number_of_samples;
+	tsi.block_bytes = block_header->block_bytes;
+	RED_find_extrema(rps->original_ptr, (si8) block_header->number_of_samples, &tsi);
+	tsi.RED_block_flags = block_header->flags;
+	
+	// append the block, then its index (an index entry never precedes its block on disk)
+	if (e_fwrite((void *) block_header, sizeof(ui1), (size_t) block_header->block_bytes, stream->data_fps->fp, stream->data_fps->full_file_name, __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR) != (size_t) block_header->block_bytes)
+		return(-1);
+	// the encoder's block CRC already covers all but the first CRC_BYTES of the block => combine rather than rescan
+	stream->data_body_CRC = CRC_update((ui1 *) block_header, (si8) CRC_BYTES, stream->data_body_CRC);
+	stream->data_body_CRC = CRC_combine(stream->data_body_CRC, block_header->block_CRC, (si8) block_header->block_bytes - CRC_BYTES);
+	out_tsi = tsi;
+	STREAM_output_time(&out_tsi.start_time);
+	if (e_fwrite((void *) &out_tsi, sizeof(TIME_SERIES_INDEX), (size_t) 1, stream->indices_fps->fp, stream->indices_fps->full_file_name, __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR) != 1)
+		return(-1);
+	stream->indices_body_CRC = CRC_update((ui1 *) &out_tsi, (si8) TIME_SERIES_INDEX_BYTES, stream->indices_body_CRC);
+	stream->data_bytes += block_header->block_bytes;
+	
+	// segment statistics
+	if (stream->discontinuity == MEF_TRUE) {
+		++tmd2->number_of_discontinuities;
+		stream->contiguous_blocks = stream->contiguous_block_bytes = stream->contiguous_samples = 0;
+	}
+	++tmd2->number_of_blocks;
+	tmd2->number_of_samples += tsi.number_of_samples;
+	if ((si8) tsi.block_bytes > tmd2->maximum_block_bytes)
+		tmd2->maximum_block_bytes = (si8) tsi.block_bytes;
+	if (block_header->difference_bytes > tmd2->maximum_difference_bytes)
+		tmd2->maximum_difference_bytes = block_header->difference_bytes;
+	if (tsi.maximum_sample_value > stream->maximum_sample_value)
+		stream->maximum_sample_value = tsi.maximum_sample_value;
+	if (tsi.minimum_sample_value < stream->minimum_sample_value)
+		stream->minimum_sample_value = tsi.minimum_sample_value;
+	++stream->contiguous_blocks;
+	stream->contiguous_block_bytes += tsi.block_bytes;
+	stream->contiguous_samples += tsi.number_of_samples;
+	if (stream->contiguous_blocks > tmd2->maximum_contiguous_blocks)
+		tmd2->maximum_contiguous_blocks = stream->contiguous_blocks;
+	if (stream->contiguous_block_bytes > tmd2->maximum_contiguous_block_bytes)
+		tmd2->maximum_contiguous_block_bytes = stream->contiguous_block_bytes;
+	if (stream->contiguous_samples > tmd2->maximum_contiguous_samples)
+		tmd2->maximum_contiguous_samples = stream->contiguous_samples;
+	
+	// universal headers (in memory; written by STREAM_update())
+	uh = stream->data_fps->universal_header;
+	++uh->number_of_entries;
+	if (uh->maximum_entry_size < (si8) tsi.number_of_samples)
+		uh->maximum_entry_size = (si8) tsi.number_of_samples;
+	if (uh->start_time == UUTC_NO_ENTRY)
+		uh->start_time = tsi.start_time;
+	uh->end_time = stream->run_start_time + (si8) ((((sf8) (stream->run_samples + tsi.number_of_samples) * (sf8) 1e6) / sampling_frequency) + 0.5);
+	stream->indices_fps->universal_header->number_of_entries = uh->number_of_entries;
+	stream->indices_fps->universal_header->start_time = uh->start_time;
+	stream->indices_fps->universal_header->end_time = uh->end_time;
+	
+	stream->segment_samples += tsi.number_of_samples;
+	stream->run_samples += tsi.number_of_samples;
+	stream->buffered_samples = 0;
+	stream->discontinuity = MEF_FALSE;
+	
+	// sync & periodic update
+	if (stream->sync_mode == STREAM_SYNC_ON_FLUSH) {
+		(void) STREAM_sync_file(stream->data_fps);
+		(void) STREAM_sync_file(stream->indices_fps);
+	}
+	if (stream->update_interval > 0 && ++stream->blocks_since_update >= stream->update_interval)
+		return(STREAM_update(stream));
+	
+	
+	return(0);
+}
+
+
+TIME_SERIES_STREAM	*STREAM_open(si1 *channel_path, FILE_PROCESSING_STRUCT *proto_metadata_fps, RED_PROCESSING_STRUCT *proto_rps, si4 segment_number, si8 start_sample, si8 start_time, si1 sync_mode, si8 update_interval)
+{
+	TIME_SERIES_STREAM		*stream;
+	TIME_SERIES_METADATA_SECTION_2	*tmd2;
+	ui4				block_samples;
+	
+	
+	// opens segment "segment_number" of the channel in "channel_path" for streaming
+	// proto_metadata_fps supplies the universal header names and the user settable metadata fields (as in write_MEF_time_series_segment())
+	// start_sample is the channel-relative sample number of the first sample, start_time its time
+	tmd2 = proto_metadata_fps->metadata.time_series_section_2;
+	if (tmd2->sampling_frequency <= 0.0) {
+		if (!(MEF_context->behavior_on_fail & SUPPRESS_ERROR_OUTPUT)) {
+			fprintf(stderr, "Error: no sampling frequency in the metadata prototype [function \"%s\", line %d]\n", __FUNCTION__, __LINE__);
+			if (MEF_context->behavior_on_fail & RETURN_ON_FAIL)
+				(void) fprintf(stderr, "\t=> returning NULL\n\n");
+			else if (MEF_context->behavior_on_fail & EXIT_ON_FAIL)
+				(void) fprintf(stderr, "\t=> exiting program\n\n");
+		}
+		if (MEF_context->behavior_on_fail & EXIT_ON_FAIL)
+			exit(1);
+		return(NULL);
 	}
-	printf("------------------- Section 2 - END --------------------\n\n");
-	printf("------------------ Section 3 - START -------------------\n");
-	if (fps->password_data->access_level >= ABS(md1->section_3_encryption)) {
-		if (md3->recording_time_offset == UUTC_NO_ENTRY)
-			printf("Recording Time Offset: no entry\n");
-		else
-			#ifdef _WIN32
-				printf("Recording Time Offset: %lld\n", md3->recording_time_offset);
-			#else
-				printf("Recording Time Offset: %ld\n", md3->recording_time_offset);
-			#endif
-		if (md3->DST_start_time == UUTC_NO_ENTRY)
-			printf("DST Start Time: no entry\n");
-		else
-			#ifdef _WIN32
-				printf("DST Start Time: %lld\n", md3->DST_start_time);
-			#else
-				printf("DST Start Time: %ld\n", md3->DST_start_time);
-			#endif
-		if (md3->DST_end_time == UUTC_NO_ENTRY)
-			printf("DST End Time: no entry\n");
-		else
-			#ifdef _WIN32
-				printf("DST End Time: %lld\n", md3->DST_end_time);
-			#else
-				printf("DST End Time: %ld\n", md3->DST_end_time);
-			#endif
-		if (md3->GMT_offset == GMT_OFFSET_NO_ENTRY)
-			printf("GMT: no entry\n");
-		else
-			printf("GMT Offset: %d\n", md3->GMT_offset);
-		if (strlen(md3->subject_name_1))
-			UTF8_printf("Subject Name 1: %s\n", md3->subject_name_1);
-		else
-			printf("Subject Name 1: no entry\n");
-		if (strlen(md3->subject_name_2))
-			UTF8_printf("Subject Name 2: %s\n", md3->subject_name_2);
-		else
-			printf("Subject Name 2: no entry\n");
-		if (strlen(md3->subject_ID))
-			UTF8_printf("Subject ID: %s\n", md3->subject_ID);
-		else
-			printf("Subject ID: no entry\n");
-		if (strlen(md3->recording_location))
-			UTF8_printf("Recording Location: %s\n", md3->recording_location);
-		else
-			printf("Recording Location: no entry\n");
-	} else {
-		printf("No access to section 3\n");
+	block_samples = tmd2->maximum_block_samples;
+	if (block_samples == TIME_SERIES_METADATA_MAXIMUM_BLOCK_SAMPLES_NO_ENTRY || block_samples == 0)
+		block_samples = (ui4) ceil(tmd2->sampling_frequency * RED_ENCODE_BLOCK_DURATION_DEFAULT);
+	
+	stream = (TIME_SERIES_STREAM *) e_calloc((size_t) 1, sizeof(TIME_SERIES_STREAM), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	MEF_strncpy(stream->channel_path, channel_path, MEF_FULL_FILE_NAME_BYTES);
+	stream->metadata_fps = allocate_file_processing_struct(METADATA_FILE_BYTES, TIME_SERIES_METADATA_FILE_TYPE_CODE, NULL, proto_metadata_fps, METADATA_FILE_BYTES);
+	stream->metadata_fps->metadata.time_series_section_2->maximum_block_samples = block_samples;
+	stream->rps = RED_allocate_processing_struct(block_samples, RED_MAX_COMPRESSED_BYTES((si8) block_samples, 1), block_samples, RED_MAX_DIFFERENCE_BYTES(block_samples), block_samples, block_samples, proto_rps->password_data);
+	stream->rps->compression = proto_rps->compression;
+	stream->rps->directives = proto_rps->directives;
+	stream->rps->directives.return_lossy_data = MEF_FALSE;
+	stream->rps->directives.reset_discontinuity = MEF_FALSE;
+	stream->block_samples = block_samples;
+	stream->sync_mode = sync_mode;
+	stream->update_interval = update_interval;
+	stream->run_start_time = start_time;
+	stream->segment_number = segment_number;
+	stream->segment_start_sample = start_sample;
+	
+	if (STREAM_open_segment(stream) < 0) {
+		RED_free_processing_struct(stream->rps);
+		stream->metadata_fps->directives.free_password_data = MEF_FALSE;
+		free_file_processing_struct(stream->metadata_fps);
+		free(stream);
+		return(NULL);
 	}
-	printf("------------------- Section 3 - END --------------------\n\n");
-	printf("-------------------- Metadata - END --------------------\n\n");
-        
+	
+	
+	return(stream);
+}
+
+
+si4	STREAM_open_segment(TIME_SERIES_STREAM *stream)
+{
+	FILE_PROCESSING_STRUCT		*metadata_fps, *fps;
+	TIME_SERIES_METADATA_SECTION_2	*tmd2;
+	METADATA_SECTION_1		*md1;
+	UNIVERSAL_HEADER		*uh;
+	si1				segment_name[MEF_SEGMENT_BASE_FILE_NAME_BYTES], segment_path[MEF_FULL_FILE_NAME_BYTES];
+	si4				i;
+	
+	
+	// metadata: new UUIDs & zeroed block derived fields
+	metadata_fps = stream->metadata_fps;
+	uh = metadata_fps->universal_header;
+	uh->segment_number = stream->segment_number;
+	generate_UUID(uh->level_UUID);
+	generate_UUID(uh->file_UUID);
+	memcpy(uh->provenance_UUID, uh->file_UUID, UUID_BYTES);
+	uh->number_of_entries = 1;
+	uh->maximum_entry_size = METADATA_FILE_BYTES;
+	uh->start_time = uh->end_time = UUTC_NO_ENTRY;
+	md1 = metadata_fps->metadata.section_1;
+	if (metadata_fps->password_data == NULL) {
+		md1->section_2_encryption = NO_ENCRYPTION;
+		md1->section_3_encryption = NO_ENCRYPTION;
+	} else {  // mark as currently decrypted, so write_MEF_file() encrypts
+		if (md1->section_2_encryption > NO_ENCRYPTION)
+			md1->section_2_encryption = -md1->section_2_encryption;
+		if (md1->section_3_encryption > NO_ENCRYPTION)
+			md1->section_3_encryption = -md1->section_3_encryption;
+	}
+	tmd2 = metadata_fps->metadata.time_series_section_2;
+	tmd2->start_sample = stream->segment_start_sample;
+	tmd2->number_of_samples = 0;
+	tmd2->number_of_blocks = 0;
+	tmd2->maximum_block_bytes = 0;
+	tmd2->maximum_difference_bytes = 0;
+	tmd2->block_interval = (si8) ((((sf8) stream->block_samples * (sf8) 1e6) / tmd2->sampling_frequency) + 0.5);
+	tmd2->recording_duration = 0;
+	tmd2->number_of_discontinuities = 0;
+	tmd2->maximum_contiguous_blocks = 0;
+	tmd2->maximum_contiguous_block_bytes = 0;
+	tmd2->maximum_contiguous_samples = 0;
+	tmd2->maximum_native_sample_value = TIME_SERIES_METADATA_MAXIMUM_NATIVE_SAMPLE_VALUE_NO_ENTRY;
+	tmd2->minimum_native_sample_value = TIME_SERIES_METADATA_MINIMUM_NATIVE_SAMPLE_VALUE_NO_ENTRY;
+	
+	generate_segment_name(metadata_fps, segment_name);
+	MEF_snprintf(segment_path, MEF_FULL_FILE_NAME_BYTES, "%s/%s.%s", stream->channel_path, segment_name, SEGMENT_DIRECTORY_TYPE_STRING);
+	MEF_snprintf(metadata_fps->full_file_name, MEF_FULL_FILE_NAME_BYTES, "%s/%s.%s", segment_path, segment_name, TIME_SERIES_METADATA_FILE_TYPE_STRING);
+	
+	// data & indices files: universal headers copied from the metadata, kept open for appending
+	stream->data_fps = allocate_file_processing_struct(UNIVERSAL_HEADER_BYTES, TIME_SERIES_DATA_FILE_TYPE_CODE, NULL, metadata_fps, UNIVERSAL_HEADER_BYTES);
+	stream->indices_fps = allocate_file_processing_struct(UNIVERSAL_HEADER_BYTES, TIME_SERIES_INDICES_FILE_TYPE_CODE, NULL, metadata_fps, UNIVERSAL_HEADER_BYTES);
+	MEF_snprintf(stream->data_fps->full_file_name, MEF_FULL_FILE_NAME_BYTES, "%s/%s.%s", segment_path, segment_name, TIME_SERIES_DATA_FILE_TYPE_STRING);
+	MEF_snprintf(stream->indices_fps->full_file_name, MEF_FULL_FILE_NAME_BYTES, "%s/%s.%s", segment_path, segment_name, TIME_SERIES_INDICES_FILE_TYPE_STRING);
+	for (i = 0; i < 2; ++i) {
+		fps = (i == 0) ? stream->data_fps : stream->indices_fps;
+		uh = fps->universal_header;
+		generate_UUID(uh->file_UUID);
+		memcpy(uh->provenance_UUID, uh->file_UUID, UUID_BYTES);
+		uh->number_of_entries = 0;
+		uh->maximum_entry_size = (i == 0) ? 0 : TIME_SERIES_INDEX_BYTES;
+		fps->directives.open_mode = FPS_W_PLUS_OPEN_MODE;
+		fps->directives.close_file = MEF_FALSE;
+		if (fps_open(fps, __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR) < 0 || fps->fp == NULL) {
+			if (stream->data_fps->fp != NULL)
+				fps_close(stream->data_fps);
+			free_file_processing_struct(stream->data_fps);
+			free_file_processing_struct(stream->indices_fps);
+			stream->data_fps = stream->indices_fps = NULL;
+			return(-1);
+		}
+	}
+	
+	// segment state
+	stream->segment_samples = 0;
+	stream->data_bytes = UNIVERSAL_HEADER_BYTES;
+	stream->data_body_CRC = stream->indices_body_CRC = CRC_START_VALUE;
+	stream->contiguous_blocks = stream->contiguous_block_bytes = stream->contiguous_samples = 0;
+	stream->maximum_sample_value = RED_MINIMUM_SAMPLE_VALUE;
+	stream->minimum_sample_value = RED_MAXIMUM_SAMPLE_VALUE;
+	stream->discontinuity = MEF_TRUE;  // the first block of a segment is always a discontinuity
+	
+	
+	return(STREAM_update(stream));  // write the (empty) segment
+}
+
+
+void	STREAM_output_time(si8 *time)
+{
+	// recording time offset applied to times written by the stream writer (as by write_MEF_file() & RED_encode_exec())
+	if (*time == UUTC_NO_ENTRY)
+		return;
+	if (MEF_context->recording_time_offset_mode & (RTO_APPLY | RTO_APPLY_ON_OUTPUT))
+		apply_recording_time_offset(time);
+	else if (MEF_context->recording_time_offset_mode & (RTO_REMOVE | RTO_REMOVE_ON_OUTPUT))
+		remove_recording_time_offset(time);
+	
 	
 	return;
 }
 
 
-void	show_password_data(FILE_PROCESSING_STRUCT *fps)
+si4	STREAM_roll_segment(TIME_SERIES_STREAM *stream)
 {
-	PASSWORD_DATA	*pwd;
-        si1		hex_str[HEX_STRING_BYTES(ENCRYPTION_KEY_BYTES)];
+	si4	ret_val;
 	
 	
-	pwd = fps->password_data;
+	// close the current segment & open the next one; sample numbering & timing continue
+	ret_val = STREAM_close_segment(stream);
+	stream->segment_start_sample += stream->segment_samples;
+	++stream->segment_number;
+	if (STREAM_open_segment(stream) < 0)
+		ret_val = -1;
 	
-	printf("------------------ Password Data - START -----------------\n");
-	if (pwd->access_level >= LEVEL_1_ACCESS) {
-                generate_hex_string(pwd->level_1_encryption_key, ENCRYPTION_KEY_BYTES, hex_str);
-		printf("Level 1 Encryption Key: %s\n", hex_str);
+	
+	return(ret_val);
+}
+
+
+si4	STREAM_sync_file(FILE_PROCESSING_STRUCT *fps)
+{
+	if (fps == NULL || fps->fp == NULL)
+		return(0);
+	
+	fflush(fps->fp);
+	#ifdef _WIN32
+		return(_commit(fps->fd));
+	#else
+		return(fsync(fps->fd));
+	#endif
+}
+
+
+si4	STREAM_update(TIME_SERIES_STREAM *stream)
+{
+	FILE_PROCESSING_STRUCT		*metadata_fps, *tmp_fps;
+	TIME_SERIES_METADATA_SECTION_2	*tmd2;
+	sf8				units_conversion_factor;
+	si4				ret_val;
+	
+	
+	// order: appended blocks & indices reach the disk, then the headers counting them, then the metadata (atomically replaced)
+	if (stream->data_fps == NULL || stream->indices_fps == NULL)
+		return(-1);
+	
+	ret_val = 0;
+	fflush(stream->data_fps->fp);
+	fflush(stream->indices_fps->fp);
+	if (stream->sync_mode != STREAM_SYNC_NONE) {
+		(void) STREAM_sync_file(stream->data_fps);
+		(void) STREAM_sync_file(stream->indices_fps);
+	}
+	if (STREAM_write_universal_header(stream->data_fps, stream->data_body_CRC) < 0)
+		ret_val = -1;
+	if (STREAM_write_universal_header(stream->indices_fps, stream->indices_body_CRC) < 0)
+		ret_val = -1;
+	if (stream->sync_mode != STREAM_SYNC_NONE) {
+		(void) STREAM_sync_file(stream->data_fps);
+		(void) STREAM_sync_file(stream->indices_fps);
+	}
+	
+	// metadata
+	metadata_fps = stream->metadata_fps;
+	tmd2 = metadata_fps->metadata.time_series_section_2;
+	metadata_fps->universal_header->start_time = stream->data_fps->universal_header->start_time;
+	metadata_fps->universal_header->end_time = stream->data_fps->universal_header->end_time;
+	if (tmd2->number_of_blocks > 0) {
+		tmd2->recording_duration = stream->data_fps->universal_header->end_time - stream->data_fps->universal_header->start_time;
+		units_conversion_factor = tmd2->units_conversion_factor;
+		if (units_conversion_factor == TIME_SERIES_METADATA_UNITS_CONVERSION_FACTOR_NO_ENTRY)
+			units_conversion_factor = 1.0;
+		tmd2->maximum_native_sample_value = (sf8) stream->maximum_sample_value * units_conversion_factor;
+		tmd2->minimum_native_sample_value = (sf8) stream->minimum_sample_value * units_conversion_factor;
+	}
+	tmp_fps = allocate_file_processing_struct(METADATA_FILE_BYTES, TIME_SERIES_METADATA_FILE_TYPE_CODE, NULL, metadata_fps, METADATA_FILE_BYTES);
+	MEF_snprintf(tmp_fps->full_file_name, MEF_FULL_FILE_NAME_BYTES, "%s.%s", metadata_fps->full_file_name, STREAM_TEMPORARY_FILE_EXTENSION);
+	tmp_fps->directives.open_mode = FPS_W_OPEN_MODE;
+	tmp_fps->directives.close_file = MEF_FALSE;
+	tmp_fps->directives.free_password_data = MEF_FALSE;
+	write_MEF_file(tmp_fps);
+	if (tmp_fps->fp != NULL) {
+		if (stream->sync_mode != STREAM_SYNC_NONE)
+			(void) STREAM_sync_file(tmp_fps);
+		fps_close(tmp_fps);
+		#ifdef _WIN32
+			(void) remove(metadata_fps->full_file_name);  // rename() does not replace existing files on Windows
+		#endif
+		if (rename(tmp_fps->full_file_name, metadata_fps->full_file_name) != 0)
+			ret_val = -1;
+	} else {
+		ret_val = -1;
 	}
-	if (pwd->access_level == LEVEL_2_ACCESS) {
-                generate_hex_string(pwd->level_2_encryption_key, ENCRYPTION_KEY_BYTES, hex_str);
-		printf("Level 2 Encryption Key: %s\n", hex_str);
+	free_file_processing_struct(tmp_fps);
+	
+	stream->blocks_since_update = 0;
+	
+	
+	return(ret_val);
+}
+
+
+si4	STREAM_write_universal_header(FILE_PROCESSING_STRUCT *fps, ui4 body_CRC)
+{
+	UNIVERSAL_HEADER	uh;
+	
+	
+	// rewrite the universal header of an open file (times offset & CRCs calculated on a copy), then return to the end of the file
+	uh = *fps->universal_header;
+	STREAM_output_time(&uh.start_time);
+	STREAM_output_time(&uh.end_time);
+	if (MEF_context->CRC_mode & (CRC_CALCULATE | CRC_CALCULATE_ON_OUTPUT)) {
+		uh.body_CRC = body_CRC;
+		uh.header_CRC = CRC_calculate((ui1 *) &uh + CRC_BYTES, UNIVERSAL_HEADER_BYTES - CRC_BYTES);
 	}
-	printf("Access Level: %d\n", pwd->access_level);
-	printf("------------------- Password Data - END ------------------\n\n");
 	
-        
+	if (e_fseek(fps->fp, (size_t) 0, SEEK_SET, fps->full_file_name, __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR) < 0)
+		return(-1);
+	if (e_fwrite((void *) &uh, sizeof(UNIVERSAL_HEADER), (size_t) 1, fps->fp, fps->full_file_name, __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR) != 1)
+		return(-1);
+	if (e_fseek(fps->fp, (size_t) 0, SEEK_END, fps->full_file_name, __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR) < 0)
+		return(-1);
+	
+	
+	return(0);
+}
+
+
+/*************************************************************************/
+/****************************  END STREAM FUNCTIONS  *********************/
+/*************************************************************************/
+
+
+/*************************************************************************/
+/******************************  THREAD FUNCTIONS  ***********************/
+/*************************************************************************/
+
+
+void	THREAD_condition_broadcast(THREAD_CONDITION *condition)
+{
+#ifdef _WIN32
+	WakeAllConditionVariable(condition);
+#else
+	pthread_cond_broadcast(condition);
+#endif
+	
 	return;
 }
 
 
-void	show_records(FILE_PROCESSING_STRUCT *fps)
+void	THREAD_condition_destroy(THREAD_CONDITION *condition)
 {
-	si8		number_of_records;
-        ui4		i, r_cnt;
-        ui1		*ui1_p, *end_p;
-        RECORD_HEADER	*record_header;
-        PASSWORD_DATA	*pwd;
-        
+#ifdef _WIN32
+	// Windows condition variables need no cleanup
+#else
+	pthread_cond_destroy(condition);
+#endif
 	
-	number_of_records = fps->universal_header->number_of_entries;
-        ui1_p = fps->raw_data + UNIVERSAL_HEADER_BYTES;
-        pwd = fps->password_data;
+	return;
+}
+
+
+void	THREAD_condition_init(THREAD_CONDITION *condition)
+{
+#ifdef _WIN32
+	InitializeConditionVariable(condition);
+#else
+	pthread_cond_init(condition, NULL);
+#endif
 	
-	// number_of_records obtained from session metadata - use if passed
-	if (number_of_records == UNKNOWN_NUMBER_OF_ENTRIES) {   // can still process if not passed, but will fail on incomplete final record
-		end_p = fps->raw_data + fps->file_length;
-		r_cnt = 0;
-		while (ui1_p < end_p) {
-			record_header = (RECORD_HEADER *) ui1_p;
-			show_record(record_header, r_cnt, pwd);
-			ui1_p += (RECORD_HEADER_BYTES + record_header->bytes);
-			++r_cnt;
-		}
-		fps->universal_header->number_of_entries = r_cnt;
-	} else {
-                for (i = 0; i < number_of_records; ++i) {
-			record_header = (RECORD_HEADER *) ui1_p;
-			show_record(record_header, i, pwd);
-			ui1_p += (RECORD_HEADER_BYTES + record_header->bytes);
-		}
-	}
-        
-        
-        return;
+	return;
+}
+
+
+void	THREAD_condition_wait(THREAD_CONDITION *condition, THREAD_MUTEX *mutex)
+{
+	// the mutex must be locked by the calling thread; it is released while waiting
+#ifdef _WIN32
+	SleepConditionVariableCS(condition, mutex, INFINITE);
+#else
+	pthread_cond_wait(condition, mutex);
+#endif
+	
+	return;
+}
+
+
+si4	THREAD_create(THREAD_ID *thread_id, THREAD_FUNCTION thread_function, void *thread_args)
+{
+#ifdef _WIN32
+	*thread_id = CreateThread(NULL, 0, thread_function, thread_args, 0, NULL);
+	if (*thread_id == NULL)
+		return(-1);
+#else
+	if (pthread_create(thread_id, NULL, thread_function, thread_args) != 0)
+		return(-1);
+#endif
+	
+	return(0);
+}
+
+
+si4	THREAD_join(THREAD_ID thread_id)
+{
+#ifdef _WIN32
+	if (WaitForSingleObject(thread_id, INFINITE) != WAIT_OBJECT_0)
+		return(-1);
+	CloseHandle(thread_id);
+#else
+	if (pthread_join(thread_id, NULL) != 0)
+		return(-1);
+#endif
+	
+	return(0);
+}
+
+
+void	THREAD_mutex_destroy(THREAD_MUTEX *mutex)
+{
+#ifdef _WIN32
+	DeleteCriticalSection(mutex);
+#else
+	pthread_mutex_destroy(mutex);
+#endif
+	
+	return;
+}
+
+
+void	THREAD_mutex_init(THREAD_MUTEX *mutex)
+{
+#ifdef _WIN32
+	InitializeCriticalSection(mutex);
+#else
+	pthread_mutex_init(mutex, NULL);
+#endif
+	
+	return;
+}
+
+
+void	THREAD_mutex_lock(THREAD_MUTEX *mutex)
+{
+#ifdef _WIN32
+	EnterCriticalSection(mutex);
+#else
+	pthread_mutex_lock(mutex);
+#endif
+	
+	return;
+}
+
+
+void	THREAD_mutex_unlock(THREAD_MUTEX *mutex)
+{
+#ifdef _WIN32
+	LeaveCriticalSection(mutex);
+#else
+	pthread_mutex_unlock(mutex);
+#endif
+	
+	return;
+}
+
+
+si4	THREAD_number_of_processors(void)
+{
+	si4	n_procs;
+#ifdef _WIN32
+	SYSTEM_INFO	sys_info;
+	
+	
+	GetSystemInfo(&sys_info);
+	n_procs = (si4) sys_info.dwNumberOfProcessors;
+#else
+	n_procs = (si4) sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	if (n_procs < 1)
+		n_procs = 1;
+	
+	return(n_procs);
 }
 
 
-void	show_universal_header(FILE_PROCESSING_STRUCT *fps)
+si4	THREAD_number_of_threads(si4 requested_threads, si8 number_of_tasks)
 {
-	UNIVERSAL_HEADER	*uh;
-        si1			hex_str[HEX_STRING_BYTES(PASSWORD_VALIDATION_FIELD_BYTES)], time_str[TIME_STRING_BYTES];
-	ui4			type_code, *file_type_string_int;
+	si4	n_threads;
 	
 	
-	uh = fps->universal_header;
-	file_type_string_int = (ui4 *) uh->file_type_string;
-	type_code = *file_type_string_int;
+	n_threads = requested_threads;
+	if (n_threads <= 0)
+		n_threads = THREAD_number_of_processors();
+	if (n_threads > THREAD_MAXIMUM_NUMBER_OF_THREADS)
+		n_threads = THREAD_MAXIMUM_NUMBER_OF_THREADS;
+	if ((si8) n_threads > number_of_tasks)
+		n_threads = (si4) number_of_tasks;
+	if (n_threads < 1)
+		n_threads = 1;
 	
-	printf("---------------- Universal Header - START ----------------\n");
-	if (uh->header_CRC == CRC_NO_ENTRY)
-		printf("Header CRC: no entry\n");
-	else {
-                generate_hex_string((ui1 *) &uh->header_CRC, CRC_BYTES, hex_str);
-                printf("Header CRC: %s\n", hex_str);
-        }
-	if (uh->body_CRC == CRC_NO_ENTRY)
-		printf("Body CRC: no entry\n");
-	else {
-		generate_hex_string((ui1 *) &uh->body_CRC, CRC_BYTES, hex_str);
-		printf("Body CRC: %s\n", hex_str);
-	}
-	if (strlen(uh->file_type_string))
-		printf("File Type String: %s\n", uh->file_type_string);
-	else
-		printf("File Type String: no entry\n");
-	if (uh->mef_version_major == UNIVERSAL_HEADER_MEF_VERSION_MAJOR_NO_ENTRY || uh->mef_version_minor == UNIVERSAL_HEADER_MEF_VERSION_MINOR_NO_ENTRY) {
-		if (uh->mef_version_major == UNIVERSAL_HEADER_MEF_VERSION_MAJOR_NO_ENTRY)
-			printf("MEF Version Major: no entry\n");
-		else
-			printf("MEF Version Major: %u\n", uh->mef_version_major);
-		if (uh->mef_version_minor == UNIVERSAL_HEADER_MEF_VERSION_MINOR_NO_ENTRY)
-			printf("MEF Version Minor: no entry\n");
-		else
-			printf("MEF Version Minor: %u\n", uh->mef_version_minor);
-	} else
-		printf("MEF Version: %u.%u\n", uh->mef_version_major, uh->mef_version_minor);
-	if (uh->byte_order_code == UNIVERSAL_HEADER_BYTE_ORDER_CODE_NO_ENTRY)
-		printf("Byte Order Code: no entry ");
-	else {
-		printf("Byte Order Code: %u ", uh->byte_order_code);
-		if (uh->byte_order_code == MEF_LITTLE_ENDIAN)
-			printf("(little endian)\n");
-		else if (uh->byte_order_code == MEF_BIG_ENDIAN)
-			printf("(big endian)\n");
-		else
-			printf("(unrecognized code)\n");
-	}
-	if (uh->start_time == UUTC_NO_ENTRY)
-		printf("Start Time: no entry\n");
-	else {
-		local_date_time_string(uh->start_time, time_str);
-		if (uh->start_time < 0)
-			printf("Offset ");
-		#ifdef _WIN32
-			printf("Start Time: %lld (uUTC), %s (ascii, local)\n", ABS(uh->start_time), time_str);
-		#else
-			printf("Start Time: %ld (uUTC), %s (ascii, local)\n", ABS(uh->start_time), time_str);
-		#endif
-	}
-	if (uh->end_time == UUTC_NO_ENTRY)
-		printf("End Time: no entry\n");
-	else {
-		local_date_time_string(uh->end_time, time_str);
-		if (uh->start_time < 0)
-			printf("Offset ");
-		#ifdef _WIN32
-			printf("End Time: %lld (uUTC), %s (ascii, local)\n", ABS(uh->end_time), time_str);
-		#else
-			printf("End Time: %ld (uUTC), %s (ascii, local)\n", ABS(uh->end_time), time_str);
-		#endif
-	}
-	if (uh->number_of_entries == UNIVERSAL_HEADER_NUMBER_OF_ENTRIES_NO_ENTRY)
-		printf("Number of Entries: no entry\n");
-	else {
-		#ifdef _WIN32
-			printf("Number of Entries: %lld  ", uh->number_of_entries);
-		#else
-			printf("Number of Entries: %ld  ", uh->number_of_entries);
-		#endif
-		switch (type_code) {
-			case RECORD_DATA_FILE_TYPE_CODE:
-				printf("(number of records in the file)\n");
-				break;
-			case RECORD_INDICES_FILE_TYPE_CODE:
-				printf("(number of records indices in the file)\n");
-				break;
-			case TIME_SERIES_METADATA_FILE_TYPE_CODE:
-			case VIDEO_METADATA_FILE_TYPE_CODE:
-				printf("(one metadata entry per metadata file)\n");
-				break;
-			case VIDEO_INDICES_FILE_TYPE_CODE:
-				printf("(number of video indices in the file)\n");
-				break;
-			case TIME_SERIES_DATA_FILE_TYPE_CODE:
-				printf("(number of RED blocks in the file)\n");
-				break;
-			case TIME_SERIES_INDICES_FILE_TYPE_CODE:
-				printf("(number of time series indices in the file)\n");
-				break;
-			default:
-				printf("\n");
-				break;
-		}
-	}
-	if (uh->maximum_entry_size == UNIVERSAL_HEADER_MAXIMUM_ENTRY_SIZE_NO_ENTRY)
-		printf("Maximum Entry Size: no entry\n");
-	else {
-		#ifdef _WIN32
-			printf("Maximum Entry Size: %lld  ", uh->maximum_entry_size);
-		#else
-			printf("Maximum Entry Size: %ld  ", uh->maximum_entry_size);
-		#endif
-		switch (type_code) {
-			case RECORD_DATA_FILE_TYPE_CODE:
-				printf("(number of bytes in the largest record in the file)\n");
-				break;
-			case RECORD_INDICES_FILE_TYPE_CODE:
-				printf("(number of bytes in a record index)\n");
-				break;
-			case TIME_SERIES_METADATA_FILE_TYPE_CODE:
-			case VIDEO_METADATA_FILE_TYPE_CODE:
-				printf("(number of bytes in a metadata file)\n");
-				break;
-			case VIDEO_INDICES_FILE_TYPE_CODE:
-				printf("(number of bytes in the largest clip in the video data file)\n");
-				break;
-			case TIME_SERIES_DATA_FILE_TYPE_CODE:
-				printf("(number of samples in the largest RED block in the file)\n");
-				break;
-			case TIME_SERIES_INDICES_FILE_TYPE_CODE:
-				printf("(number of bytes in a time series index)\n");
-				break;
-			default:
-				printf("\n");
-				break;
-				
-		}
-	}
-	if (uh->segment_number == UNIVERSAL_HEADER_SEGMENT_NUMBER_NO_ENTRY)
-		printf("Segment Number: no entry\n");
-        else if (uh->segment_number == UNIVERSAL_HEADER_CHANNEL_LEVEL_CODE)
-                printf("Segment Number: channel level\n");
-        else if (uh->segment_number == UNIVERSAL_HEADER_SESSION_LEVEL_CODE)
-                printf("Segment Number: session level\n");
-	else
-		printf("Segment Number: %d\n", uh->segment_number);
-	if (strlen(uh->channel_name))
-		UTF8_printf("Channel Name: %s\n", uh->channel_name);
-	else
-		printf("Channel Name: no entry\n");
-	if (strlen(uh->session_name))
-		UTF8_printf("Session Name: %s\n", uh->session_name);
-	else
-		printf("Session Name: no entry\n");
-	if (strlen(uh->anonymized_name))
-		UTF8_printf("Anonymized Name: %s\n", uh->anonymized_name);
-	else
-		printf("Anonymized Name: no entry\n");
-	if (all_zeros(uh->level_UUID, UUID_BYTES) == MEF_TRUE)
-		printf("Level UUID: no entry\n");
-	else {
-		generate_hex_string(uh->level_UUID, UUID_BYTES, hex_str);
-		printf("Level UUID: %s\n", hex_str);
-	}
-	if (all_zeros(uh->file_UUID, UUID_BYTES) == MEF_TRUE)
-		printf("File UUID: no entry\n");
-	else {
-		generate_hex_string(uh->file_UUID, UUID_BYTES, hex_str);
-		printf("File UUID: %s\n", hex_str);
-	}
-	if (all_zeros(uh->provenance_UUID, UUID_BYTES) == MEF_TRUE)
-		printf("Provenance UUID: no entry\n");
-	else {
-		generate_hex_string(uh->provenance_UUID, UUID_BYTES, hex_str);
-		printf("Provenance UUID: %s  ", hex_str);
-		if (memcmp(uh->provenance_UUID, uh->file_UUID, UUID_BYTES))
-			printf("(derived data\n)");
-		else
-			printf("(original data\n)");
-	}
-	if (all_zeros(uh->level_1_password_validation_field, PASSWORD_VALIDATION_FIELD_BYTES) == MEF_TRUE)
-		printf("Level 1 Password Validation_Field: no entry\n");
-	else {
-                generate_hex_string(uh->level_1_password_validation_field, PASSWORD_VALIDATION_FIELD_BYTES, hex_str);
-		printf("Level 1 Password Validation_Field: %s\n", hex_str);
+	return(n_threads);
+}
+
+
+si4	THREAD_run_tasks(THREAD_TASK_FUNCTION task_function, void *task_args, si8 number_of_tasks, si4 number_of_threads)
+{
+	THREAD_TASK_QUEUE	queue;
+	THREAD_WORKER		*workers;
+	THREAD_ID		*thread_ids;
+	si1			*thread_started;
+	si4			i, n_threads;
+	si8			task;
+	
+	
+	// returns the number of threads used (including the calling thread)
+	n_threads = THREAD_number_of_threads(number_of_threads, number_of_tasks);
+	if (n_threads == 1) {
+		for (task = 0; task < number_of_tasks; ++task)
+			(*task_function)(task_args, task, 0);
+		return(1);
 	}
-	if (all_zeros(uh->level_2_password_validation_field, PASSWORD_VALIDATION_FIELD_BYTES) == MEF_TRUE)
-		printf("Level 2 Password Validation_Field: no entry\n");
-	else {
-                generate_hex_string(uh->level_2_password_validation_field, PASSWORD_VALIDATION_FIELD_BYTES, hex_str);
-		printf("Level 2 Password Validation_Field: %s\n", hex_str);
+	
+	queue.task_function = task_function;
+	queue.task_args = task_args;
+	queue.number_of_tasks = number_of_tasks;
+	queue.next_task = 0;
+	queue.context = MEF_get_context();  // workers run in the calling thread's context
+	THREAD_mutex_init(&queue.mutex);
+	
+	workers = (THREAD_WORKER *) e_calloc((size_t) n_threads, sizeof(THREAD_WORKER), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	thread_ids = (THREAD_ID *) e_calloc((size_t) n_threads, sizeof(THREAD_ID), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	thread_started = (si1 *) e_calloc((size_t) n_threads, sizeof(si1), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	for (i = 0; i < n_threads; ++i) {
+		workers[i].queue = &queue;
+		workers[i].thread_number = i;
 	}
-	printf("---------------- Universal Header - END ----------------\n\n");
 	
-        
-	return;
+	// tasks are pulled from a shared queue, so a thread that fails to start just means fewer workers
+	for (i = 1; i < n_threads; ++i)
+		thread_started[i] = (THREAD_create(thread_ids + i, (THREAD_FUNCTION) THREAD_worker, (void *) (workers + i)) == 0) ? MEF_TRUE : MEF_FALSE;
+	THREAD_worker((void *) workers);
+	for (i = 1; i < n_threads; ++i)
+		if (thread_started[i] == MEF_TRUE)
+			THREAD_join(thread_ids[i]);
+	
+	THREAD_mutex_destroy(&queue.mutex);
+	free(workers);
+	free(thread_ids);
+	free(thread_started);
+	
+	
+	return(n_threads);
 }
 
 
-si4     sort_by_idx(const void *n1, const void *n2)
+THREAD_RETURN_TYPE	THREAD_worker(void *worker_args)
 {
-	si4     i1, i2;
+	THREAD_WORKER		*worker;
+	THREAD_TASK_QUEUE	*queue;
+	MEF_CONTEXT		*previous_context;
+	si8			task;
 	
 	
-	i1 = ((NODE *) n1)->idx;
-	i2 = ((NODE *) n2)->idx;
+	worker = (THREAD_WORKER *) worker_args;
+	queue = worker->queue;
+	previous_context = MEF_set_context(queue->context);
+	while (1) {
+		THREAD_mutex_lock(&queue->mutex);
+		task = queue->next_task++;
+		THREAD_mutex_unlock(&queue->mutex);
+		if (task >= queue->number_of_tasks)
+			break;
+		(*queue->task_function)(queue->task_args, task, worker->thread_number);
+	}
+	(void) MEF_set_context(previous_context);
 	
-	return(i1 - i2);
+	
+	return(0);
 }
 
 
-si4     sort_by_val(const void *n1, const void *n2)
+/*************************************************************************/
+/****************************  END THREAD FUNCTIONS  *********************/
+/*************************************************************************/
+
+
+sf8	update_running_percentile(RUNNING_PERCENTILE *rp, sf8 new_val)
 {
-	sf8     v1, v2;
+	si4	*heap, slot, low_top, high_top, low_count;
 	
 	
-	v1 = ((NODE *) n1)->val;
-	v2 = ((NODE *) n2)->val;
+	// replace the oldest value in the window with new_val, and return the updated percentile value
+	heap = rp->heap;
+	low_count = rp->low_count;
+	slot = rp->oldest_slot;
+	rp->vals[slot] = new_val;
+	sift_running_percentile(rp, rp->heap_pos[slot]);
 	
-	if (v1 > v2)
-		return(1);
-	else if (v1 < v2)
-		return(-1);
-	return(0);
+	// the new value may belong in the other heap: exchange the heap tops until ordered
+	if (low_count < rp->span) {
+		low_top = heap[0];
+		high_top = heap[low_count];
+		if (rp->vals[low_top] > rp->vals[high_top]) {
+			heap[0] = high_top;
+			rp->heap_pos[high_top] = 0;
+			heap[low_count] = low_top;
+			rp->heap_pos[low_top] = low_count;
+			sift_running_percentile(rp, 0);
+			sift_running_percentile(rp, low_count);
+		}
+	}
+	
+	if (++rp->oldest_slot == rp->span)
+		rp->oldest_slot = 0;
+	
+	
+	return(rp->vals[heap[0]]);
 }
 
 
@@ -9259,21 +13900,21 @@ si4	write_MEF_file(FILE_PROCESSING_STRUCT *fps)
 	}
 	
 	// CRCs
-	if (MEF_globals->CRC_mode & (CRC_CALCULATE | CRC_CALCULATE_ON_OUTPUT)) {
+	if (MEF_context->CRC_mode & (CRC_CALCULATE | CRC_CALCULATE_ON_OUTPUT)) {
 		if (fps->directives.io_bytes == FPS_FULL_FILE)  // if doing piecemeal writes, body CRC calculation should be done explicitly in the code
-			fps->universal_header->body_CRC = CRC_calculate(fps->raw_data + UNIVERSAL_HEADER_BYTES, fps->raw_data_bytes - UNIVERSAL_HEADER_BYTES);
+			fps->universal_header->body_CRC = CRC_calculate_parallel(fps->raw_data + UNIVERSAL_HEADER_BYTES, fps->raw_data_bytes - UNIVERSAL_HEADER_BYTES, THREAD_NUMBER_OF_THREADS_DEFAULT);
 		fps->universal_header->header_CRC = CRC_calculate(fps->raw_data + CRC_BYTES, UNIVERSAL_HEADER_BYTES - CRC_BYTES);
 
 	}
-	if (MEF_globals->CRC_mode & (CRC_VALIDATE | CRC_VALIDATE_ON_OUTPUT)) {
+	if (MEF_context->CRC_mode & (CRC_VALIDATE | CRC_VALIDATE_ON_OUTPUT)) {
 		if (fps->directives.io_bytes == FPS_FULL_FILE) {
-			CRC_result = CRC_validate(fps->raw_data + UNIVERSAL_HEADER_BYTES, fps->raw_data_bytes - UNIVERSAL_HEADER_BYTES, fps->universal_header->body_CRC);
-			if (CRC_result == MEF_TRUE && MEF_globals->verbose == MEF_TRUE)
+			CRC_result = CRC_validate_parallel(fps->raw_data + UNIVERSAL_HEADER_BYTES, fps->raw_data_bytes - UNIVERSAL_HEADER_BYTES, fps->universal_header->body_CRC, THREAD_NUMBER_OF_THREADS_DEFAULT);
+			if (CRC_result == MEF_TRUE && MEF_context->verbose == MEF_TRUE)
 				UTF8_printf("Body CRC is valid in file \"%s\".\n", fps->full_file_name);
 			else
 				UTF8_fprintf(stderr, "Warning: body CRC is invalid in file \"%s\".\n", fps->full_file_name);
 			CRC_result = CRC_validate(fps->raw_data + CRC_BYTES, UNIVERSAL_HEADER_BYTES - CRC_BYTES, fps->universal_header->header_CRC);
-			if (CRC_result == MEF_TRUE && MEF_globals->verbose == MEF_TRUE)
+			if (CRC_result == MEF_TRUE && MEF_context->verbose == MEF_TRUE)
 				UTF8_printf("Header CRC is valid in file \"%s\".\n", fps->full_file_name);
 			else
 				UTF8_fprintf(stderr, "Warning: header CRC is invalid in file \"%s\".\n", fps->full_file_name);
@@ -9293,7 +13934,7 @@ si4	write_MEF_file(FILE_PROCESSING_STRUCT *fps)
 	}
 	
 	// show
-	if (MEF_globals->verbose == MEF_TRUE)
+	if (MEF_context->verbose == MEF_TRUE)
 		show_file_processing_struct(fps);
 	
 	
@@ -9301,3 +13942,130 @@ si4	write_MEF_file(FILE_PROCESSING_STRUCT *fps)
 }
 
 
+si4	write_MEF_time_series_segment(si1 *channel_path, FILE_PROCESSING_STRUCT *proto_metadata_fps, si4 segment_number, si4 *samples, si8 number_of_samples, si8 start_sample, si8 start_time, RED_PROCESSING_STRUCT *proto_rps, si4 number_of_threads)
+{
+	FILE_PROCESSING_STRUCT		*metadata_fps, *data_fps, *indices_fps;
+	TIME_SERIES_METADATA_SECTION_2	*tmd2;
+	METADATA_SECTION_1		*md1;
+	TIME_SERIES_INDEX		*tsi;
+	RED_BLOCK_HEADER		*block_header;
+	si1				segment_name[MEF_SEGMENT_BASE_FILE_NAME_BYTES], segment_path[MEF_FULL_FILE_NAME_BYTES];
+	si4				max_sample_value, min_sample_value;
+	ui4				block_samples;
+	si8				i, n_blocks;
+	sf8				units_conversion_factor;
+	
+	
+	// writes one time series segment (metadata, data & indices files) in "channel_path" (the channel directory)
+	// proto_metadata_fps supplies the universal header names and the user settable metadata fields; the block derived fields are calculated here
+	// blocks are encoded in parallel (see RED_encode_blocks()), with compression parameters & directives from proto_rps
+	
+	// metadata
+	metadata_fps = allocate_file_processing_struct(METADATA_FILE_BYTES, TIME_SERIES_METADATA_FILE_TYPE_CODE, NULL, proto_metadata_fps, METADATA_FILE_BYTES);
+	metadata_fps->universal_header->segment_number = segment_number;
+	generate_UUID(metadata_fps->universal_header->level_UUID);
+	generate_UUID(metadata_fps->universal_header->file_UUID);
+	memcpy(metadata_fps->universal_header->provenance_UUID, metadata_fps->universal_header->file_UUID, UUID_BYTES);
+	metadata_fps->universal_header->number_of_entries = 1;
+	metadata_fps->universal_header->maximum_entry_size = METADATA_FILE_BYTES;
+	md1 = metadata_fps->metadata.section_1;
+	if (metadata_fps->password_data == NULL) {
+		md1->section_2_encryption = NO_ENCRYPTION;
+		md1->section_3_encryption = NO_ENCRYPTION;
+	} else {  // mark as currently decrypted, so write_MEF_file() encrypts
+		if (md1->section_2_encryption > NO_ENCRYPTION)
+			md1->section_2_encryption = -md1->section_2_encryption;
+		if (md1->section_3_encryption > NO_ENCRYPTION)
+			md1->section_3_encryption = -md1->section_3_encryption;
+	}
+	tmd2 = metadata_fps->metadata.time_series_section_2;
+	if (tmd2->sampling_frequency <= 0.0) {
+		if (!(MEF_context->behavior_on_fail & SUPPRESS_ERROR_OUTPUT)) {
+			fprintf(stderr, "Error: no sampling frequency in the metadata prototype [function \"%s\", line %d]\n", __FUNCTION__, __LINE__);
+			if (MEF_context->behavior_on_fail & RETURN_ON_FAIL)
+				(void) fprintf(stderr, "\t=> returning without writing\n\n");
+			else if (MEF_context->behavior_on_fail & EXIT_ON_FAIL)
+				(void) fprintf(stderr, "\t=> exiting program\n\n");
+		}
+		if (MEF_context->behavior_on_fail & EXIT_ON_FAIL)
+			exit(1);
+		free_file_processing_struct(metadata_fps);
+		return(-1);
+	}
+	block_samples = tmd2->maximum_block_samples;
+	if (block_samples == TIME_SERIES_METADATA_MAXIMUM_BLOCK_SAMPLES_NO_ENTRY || block_samples == 0)
+		block_samples = (ui4) ceil(tmd2->sampling_frequency * RED_ENCODE_BLOCK_DURATION_DEFAULT);
+	
+	// data & indices (universal headers copied from the metadata)
+	data_fps = allocate_file_processing_struct(UNIVERSAL_HEADER_BYTES, TIME_SERIES_DATA_FILE_TYPE_CODE, NULL, metadata_fps, UNIVERSAL_HEADER_BYTES);
+	indices_fps = allocate_file_processing_struct(UNIVERSAL_HEADER_BYTES, TIME_SERIES_INDICES_FILE_TYPE_CODE, NULL, metadata_fps, UNIVERSAL_HEADER_BYTES);
+	generate_UUID(data_fps->universal_header->file_UUID);
+	memcpy(data_fps->universal_header->provenance_UUID, data_fps->universal_header->file_UUID, UUID_BYTES);
+	generate_UUID(indices_fps->universal_header->file_UUID);
+	memcpy(indices_fps->universal_header->provenance_UUID, indices_fps->universal_header->file_UUID, UUID_BYTES);
+	data_fps->universal_header->number_of_entries = indices_fps->universal_header->number_of_entries = 0;
+	data_fps->universal_header->maximum_entry_size = indices_fps->universal_header->maximum_entry_size = 0;
+	data_fps->universal_header->start_time = indices_fps->universal_header->start_time = UUTC_NO_ENTRY;
+	data_fps->universal_header->end_time = indices_fps->universal_header->end_time = UUTC_NO_ENTRY;
+	
+	// encode
+	n_blocks = RED_encode_blocks(data_fps, indices_fps, samples, number_of_samples, 0, start_time, tmd2->sampling_frequency, block_samples, proto_rps, number_of_threads);
+	
+	// block derived metadata
+	tmd2->start_sample = start_sample;
+	tmd2->number_of_samples = number_of_samples;
+	tmd2->number_of_blocks = n_blocks;
+	tmd2->maximum_block_samples = block_samples;
+	tmd2->block_interval = (si8) ((((sf8) block_samples * (sf8) 1e6) / tmd2->sampling_frequency) + 0.5);
+	tmd2->recording_duration = data_fps->universal_header->end_time - data_fps->universal_header->start_time;
+	tmd2->number_of_discontinuities = (n_blocks > 0) ? 1 : 0;
+	tmd2->maximum_contiguous_blocks = n_blocks;
+	tmd2->maximum_contiguous_samples = number_of_samples;
+	tmd2->maximum_block_bytes = 0;
+	tmd2->maximum_difference_bytes = 0;
+	max_sample_value = RED_MINIMUM_SAMPLE_VALUE;
+	min_sample_value = RED_MAXIMUM_SAMPLE_VALUE;
+	tsi = indices_fps->time_series_indices;
+	for (i = 0; i < n_blocks; ++i, ++tsi) {
+		block_header = (RED_BLOCK_HEADER *) (data_fps->raw_data + tsi->file_offset);
+		if ((si8) tsi->block_bytes > tmd2->maximum_block_bytes)
+			tmd2->maximum_block_bytes = (si8) tsi->block_bytes;
+		if (block_header->difference_bytes > tmd2->maximum_difference_bytes)
+			tmd2->maximum_difference_bytes = block_header->difference_bytes;
+		if (tsi->maximum_sample_value > max_sample_value)
+			max_sample_value = tsi->maximum_sample_value;
+		if (tsi->minimum_sample_value < min_sample_value)
+			min_sample_value = tsi->minimum_sample_value;
+	}
+	tmd2->maximum_contiguous_block_bytes = data_fps->raw_data_bytes - UNIVERSAL_HEADER_BYTES;
+	units_conversion_factor = tmd2->units_conversion_factor;
+	if (units_conversion_factor == TIME_SERIES_METADATA_UNITS_CONVERSION_FACTOR_NO_ENTRY)
+		units_conversion_factor = 1.0;
+	if (n_blocks > 0) {
+		tmd2->maximum_native_sample_value = (sf8) max_sample_value * units_conversion_factor;
+		tmd2->minimum_native_sample_value = (sf8) min_sample_value * units_conversion_factor;
+	}
+	metadata_fps->universal_header->start_time = data_fps->universal_header->start_time;
+	metadata_fps->universal_header->end_time = data_fps->universal_header->end_time;
+	
+	// write
+	generate_segment_name(metadata_fps, segment_name);
+	MEF_snprintf(segment_path, MEF_FULL_FILE_NAME_BYTES, "%s/%s.%s", channel_path, segment_name, SEGMENT_DIRECTORY_TYPE_STRING);
+	MEF_snprintf(metadata_fps->full_file_name, MEF_FULL_FILE_NAME_BYTES, "%s/%s.%s", segment_path, segment_name, TIME_SERIES_METADATA_FILE_TYPE_STRING);
+	MEF_snprintf(data_fps->full_file_name, MEF_FULL_FILE_NAME_BYTES, "%s/%s.%s", segment_path, segment_name, TIME_SERIES_DATA_FILE_TYPE_STRING);
+	MEF_snprintf(indices_fps->full_file_name, MEF_FULL_FILE_NAME_BYTES, "%s/%s.%s", segment_path, segment_name, TIME_SERIES_INDICES_FILE_TYPE_STRING);
+	write_MEF_file(metadata_fps);
+	write_MEF_file(data_fps);
+	write_MEF_file(indices_fps);
+	
+	// clean up (password data belongs to the prototype)
+	metadata_fps->directives.free_password_data = data_fps->directives.free_password_data = indices_fps->directives.free_password_data = MEF_FALSE;
+	free_file_processing_struct(metadata_fps);
+	free_file_processing_struct(data_fps);
+	free_file_processing_struct(indices_fps);
+	
+	
+	return(0);
+}
+
+
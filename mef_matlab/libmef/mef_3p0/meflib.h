@@ -59,6 +59,7 @@
 	#include <fcntl.h>
 	#include <limits.h>
 	#include <malloc.h>  // for alloca()
+	#include <io.h>  // for _commit()
 	#include <stdint.h>
 	#include <windows.h>
 
@@ -76,7 +77,8 @@
 	#include <fcntl.h>
 	#include <limits.h>
 	#include <dirent.h>
-	//#include <pthread.h>
+	#include <pthread.h>
+	#include <sys/uio.h>  // for preadv()
 #endif
 
 
@@ -126,9 +128,15 @@
 
 
 /************************************************************************************/
-/************************************  MEF Globals  *********************************/
+/************************************  MEF Context  *********************************/
 /************************************************************************************/
 
+// Per session state: the time offsets read from (or written to) the metadata, and the CRC, time offset & error
+// settings. Each thread works in its current context (MEF_context), the default one in MEF_globals until
+// MEF_set_context() binds another; the worker threads of THREAD_run_tasks() & the scan reader take the context of
+// the thread that starts them. Sessions read in separate contexts (e.g. through separate MEF_READERs) can be read
+// concurrently.
+
 typedef struct {
         // time constants
 	si8	recording_time_offset;
@@ -136,6 +144,33 @@ typedef struct {
 	si4	GMT_offset;
         si8	DST_start_time;
         si8	DST_end_time;
+	// CRC
+        ui4	CRC_mode;
+        // miscellaneous
+        si4	verbose;
+        ui4	behavior_on_fail;
+	struct MEF_PROFILE_STRUCT	*profile;  // instrumentation (NULL: not profiled)
+	// allocation
+	ui4				allocation_mode;  // MEF_ALLOCATE_ON_HEAP or MEF_ALLOCATE_IN_ARENA
+	struct MEF_ARENA_STRUCT		*arena;  // the arena of the session or channel being read (NULL: the heap)
+	// file I/O
+	ui4				IO_mode;  // MEF_IO_STREAM or MEF_IO_POSITIONAL
+	ui4				index_mode;  // MEF_INDICES_WHOLE_FILE or MEF_INDICES_ON_DEMAND
+} MEF_CONTEXT;
+
+#define MEF_context	(MEF_get_context())
+
+
+
+/************************************************************************************/
+/************************************  MEF Globals  *********************************/
+/************************************************************************************/
+
+// Process wide, set up once by initialize_MEF_globals() (later calls leave them alone): the lookup tables (built once
+// by initialize_meflib(), read only afterwards), the alignment checks, the caches (which lock themselves) and the
+// default context. Callers that need fresh settings on every call bind a context of their own with MEF_set_context().
+
+typedef struct {
 	// alignment fields
 	si4	universal_header_aligned;
 	si4	metadata_section_1_aligned;
@@ -154,7 +189,6 @@ typedef struct {
 	sf8	*RED_normal_CDF_table;
 	// CRC
 	ui4	*CRC_table;
-        ui4	CRC_mode;
 	// AES tables
 	si4	*AES_sbox_table;
 	si4	*AES_rcon_table;
@@ -165,12 +199,18 @@ typedef struct {
 	// UTF8 tables
 	ui4	*UTF8_offsets_from_UTF8_table;
 	si1	*UTF8_trailing_bytes_for_UTF8_table;
+	// FILT coefficient cache
+	struct FILT_COEFFICIENT_CACHE_STRUCT	*FILT_coefficient_cache;
+	// decoded block cache
+	struct BLOCK_CACHE_STRUCT		*block_cache;
+	// default context (threads with no context of their own)
+	MEF_CONTEXT	default_context;
         // miscellaneous
-        si4	verbose;
-        ui4	behavior_on_fail;
         ui4	file_creation_umask;
 } MEF_GLOBALS;
 
+extern MEF_GLOBALS	*MEF_globals;  // defined in meflib.c
+
 
 
 /************************************************************************************/
@@ -189,6 +229,10 @@ si4 	e_system(const char *command, const si1 *function, si4 line, ui4 behavior_o
 void	*e_calloc(size_t n_members, size_t size, const si1 *function, si4 line, ui4 behavior_on_fail);
 FILE	*e_fopen(si1 *path, si1 *mode, const si1 *function, si4 line, ui4 behavior_on_fail);
 size_t	e_fread(void *ptr, size_t size, size_t n_members, FILE *stream, si1 *path, const si1 *function, si4 line, ui4 behavior_on_fail);
+#ifndef _WIN32
+	si8	e_pread(si4 fd, void *ptr, si8 n_bytes, si8 offset, si1 *path, const si1 *function, si4 line, ui4 behavior_on_fail);
+	si8	e_preadv(si4 fd, struct iovec *iov, si4 n_iov, si8 offset, si1 *path, const si1 *function, si4 line, ui4 behavior_on_fail);
+#endif
 si4	e_fseek(FILE *stream, size_t offset, si4 whence, si1 *path, const si1 *function, si4 line, ui4 behavior_on_fail);
 long	e_ftell(FILE *stream, const si1 *function, si4 line, ui4 behavior_on_fail);
 size_t	e_fwrite(void *ptr, size_t size, size_t n_members, FILE *stream, si1 *path, const si1 *function, si4 line, ui4 behavior_on_fail);
@@ -274,6 +318,21 @@ void	*e_realloc(void *ptr, size_t n_bytes, const si1 *function, si4 line, ui4 be
 #define MEF_GLOBALS_FILE_CREATION_UMASK_DEFAULT		S_IWOTH  // defined in <sys/stat.h>
 #define MEF_GLOBALS_BEHAVIOR_ON_FAIL_DEFAULT		EXIT_ON_FAIL
 #define MEF_GLOBALS_CRC_MODE_DEFAULT			(CRC_CALCULATE_ON_OUTPUT)
+#define MEF_GLOBALS_ALLOCATION_MODE_DEFAULT		MEF_ALLOCATE_ON_HEAP
+
+// Allocation Mode Constants
+#define MEF_ALLOCATE_ON_HEAP				0
+#define MEF_ALLOCATE_IN_ARENA				1
+#define MEF_GLOBALS_IO_MODE_DEFAULT			MEF_IO_STREAM
+
+// I/O Mode Constants
+#define MEF_IO_STREAM					0	// FILE streams (fseek() & fread()), locks as the lock mode directs
+#define MEF_IO_POSITIONAL				1	// pread() & preadv() at file offsets; read only opens take no locks
+#define MEF_GLOBALS_INDEX_MODE_DEFAULT			MEF_INDICES_WHOLE_FILE
+
+// Index Mode Constants
+#define MEF_INDICES_WHOLE_FILE				0	// time series & record indices files are read whole
+#define MEF_INDICES_ON_DEMAND				1	// only their headers; entries are read in pages when needed
 
 // File Type Constants
 #define NO_FILE_TYPE_STRING				""				// ascii[4]
@@ -337,6 +396,11 @@ void	*e_realloc(void *ptr, size_t n_bytes, const si1 *function, si4 line, ui4 be
 #define FPS_A_PLUS_OPEN_MODE					32
 #define FPS_GENERIC_READ_OPEN_MODE				(FPS_R_OPEN_MODE | FPS_R_PLUS_OPEN_MODE | FPS_W_PLUS_OPEN_MODE | FPS_A_PLUS_OPEN_MODE)
 #define FPS_GENERIC_WRITE_OPEN_MODE				(FPS_R_PLUS_OPEN_MODE | FPS_W_OPEN_MODE | FPS_W_PLUS_OPEN_MODE | FPS_A_OPEN_MODE | FPS_A_PLUS_OPEN_MODE)
+#define FPS_MAXIMUM_COALESCED_GAP_BYTES				((si8) 32 << 10)  // ranges closer than this are read with one call
+#define FPS_MAXIMUM_IO_VECTORS					256  // per preadv() call (<= IOV_MAX)
+#define FPS_INDEX_PAGE_ENTRIES					64  // on demand index entries are read in pages of this many
+#define FPS_INDEX_KEY_TIME					1  // fps_find_index_entry() keys: start_time (time series) or time (records)
+#define FPS_INDEX_KEY_SAMPLE					2  // start_sample (time series indices)
 
 // File Processing Directives defaults
 #define FPS_DIRECTIVE_CLOSE_FILE_DEFAULT			MEF_TRUE
@@ -535,6 +599,9 @@ void	*e_realloc(void *ptr, size_t n_bytes, const si1 *function, si4 line, ui4 be
 #define RECORD_INDEX_TIME_OFFSET			16	// si8
 #define RECORD_INDEX_TIME_NO_ENTRY			UUTC_NO_ENTRY
 
+// Record Decryption: records per worker task (decrypt_records() runs in the calling thread below this many records)
+#define RECORD_DECRYPTION_RECORDS_PER_TASK		256
+
 // Time Series Index: Format Constants
 #define TIME_SERIES_INDEX_BYTES					56
 #define TIME_SERIES_INDEX_FILE_OFFSET_OFFSET			0		// si8
@@ -588,6 +655,11 @@ void	*e_realloc(void *ptr, size_t n_bytes, const si1 *function, si4 line, ui4 be
 
 #define ABS(x)			( ((x) >= 0) ? (x) : -(x) )
 #define HEX_STRING_BYTES(x)	( ((x) + 1) * 3 )
+#ifdef _WIN32
+	#define FPS_POSITIONAL_IO	MEF_FALSE  // no pread() / preadv(): MEF_IO_POSITIONAL reads as MEF_IO_STREAM
+#else
+	#define FPS_POSITIONAL_IO	(MEF_context->IO_mode == MEF_IO_POSITIONAL)
+#endif
 
 
 
@@ -728,6 +800,13 @@ typedef struct {
         si8	time;
 } RECORD_INDEX;
 
+typedef struct {
+	ui1		*records;  // record data (FILE_PROCESSING_STRUCT records)
+	si8		*record_offsets;  // offset of each record header in records
+	si8		number_of_records;
+	PASSWORD_DATA	*password_data;
+} RECORD_DECRYPTION_TASK_ARGS;
+
 // Block Indices Structures
 typedef struct {
 	si8	file_offset;
@@ -764,6 +843,12 @@ typedef struct {
 	ui4				open_mode;
 } FILE_PROCESSING_DIRECTIVES;
 
+typedef struct {
+	si8				file_offset;
+	si8				bytes;
+	void				*data;  // destination
+} FPS_RANGE;
+
 typedef struct {
 	si1				full_file_name[MEF_FULL_FILE_NAME_BYTES];  // full path including extension
 	FILE				*fp;
@@ -778,9 +863,12 @@ typedef struct {
 	VIDEO_INDEX			*video_indices;
 	ui1				*records;
         RECORD_INDEX			*record_indices;
+	si1				record_indices_order;  // cached by record queries (RECORD_INDICES_ORDER_UNKNOWN when the indices are (re)read)
+	ui1				*index_pages_read;  // on demand indices: a flag per FPS_INDEX_PAGE_ENTRIES entries (NULL: all in memory)
         ui1				*RED_blocks;
 	si8				raw_data_bytes;
 	ui1				*raw_data;
+	struct MEF_ARENA_STRUCT		*arena;  // the structure & its raw data were allocated from (NULL: the heap)
 } FILE_PROCESSING_STRUCT;
 
 // Session, Channel, Segment Processing Structures
@@ -817,6 +905,7 @@ typedef struct {
 	si8			maximum_record_bytes;
 	si8			earliest_start_time;
 	si8			latest_end_time;
+	struct MEF_ARENA_STRUCT	*arena;  // the channel was read into (NULL: the heap)
 } CHANNEL;
 
 typedef struct {
@@ -837,6 +926,7 @@ typedef struct {
 	si8			maximum_record_bytes;
 	si8			earliest_start_time;
 	si8			latest_end_time;
+	struct MEF_ARENA_STRUCT	*arena;  // the session was read into (NULL: the heap)
 } SESSION;
 
 // Miscellaneous Structures
@@ -846,6 +936,15 @@ typedef struct NODE_STRUCT {
 	struct NODE_STRUCT     *prev, *next;
 } NODE;
 
+typedef struct {
+	sf8			*vals;  // window values, indexed by slot (slot = sample number % span)
+	si4			*heap;  // slots: [0, low_count) is a max-heap of the low values, [low_count, span) is a min-heap of the high values
+	si4			*heap_pos;  // position of each slot in heap[]
+	si4			span;
+	si4			low_count;  // (percentile rank + 1); the percentile value is always vals[heap[0]]
+	si4			oldest_slot;
+} RUNNING_PERCENTILE;
+
 #pragma pack()
 
 /************************************************************************************/
@@ -870,11 +969,14 @@ si4			check_video_metadata_section_2_alignment(ui1 *bytes);
 // MEF Function Prototypes
 si1			all_zeros(ui1 *bytes, si4 field_length);
 FILE_PROCESSING_STRUCT	*allocate_file_processing_struct(si8 raw_data_bytes, ui4 file_type_code, FILE_PROCESSING_DIRECTIVES *directives, FILE_PROCESSING_STRUCT *proto_fps, si8 bytes_to_copy);
+RUNNING_PERCENTILE	*allocate_running_percentile(sf8 *x, si4 span, sf8 prop);
 void			apply_recording_time_offset(si8 *time);
 si4			check_password(si1 *password, const si1 *function, si4 line);
 si4                     compare_sf8(const void *a, const void * b);
 ui1			cpu_endianness(void);
 si4			decrypt_metadata(FILE_PROCESSING_STRUCT *fps);
+si4			decrypt_record(RECORD_HEADER *record_header, PASSWORD_DATA *pwd, si8 record_number);
+void			decrypt_record_task(void *task_args, si8 task_number, si4 thread_number);
 si4			decrypt_records(FILE_PROCESSING_STRUCT *fps);
 si4			encrypt_metadata(FILE_PROCESSING_STRUCT *fps);
 si4			encrypt_records(FILE_PROCESSING_STRUCT *fps);
@@ -885,13 +987,17 @@ si8			*find_discontinuity_indices(TIME_SERIES_INDEX *tsi, si8 num_disconts, si8
 si8			*find_discontinuity_samples(TIME_SERIES_INDEX *tsi, si8 num_disconts, si8 number_of_blocks, si1 add_tail);
 void			force_behavior(ui4 behavior);
 void			fps_close(FILE_PROCESSING_STRUCT *fps);
+si4			fps_find_index_entry(FILE_PROCESSING_STRUCT *fps, si4 key_type, si8 key, si8 *entry);
 si4			fps_lock(FILE_PROCESSING_STRUCT *fps, si4 lock_type, const si1 *function, si4 line, ui4 behavior_on_fail);
 si4			fps_open(FILE_PROCESSING_STRUCT *fps, const si1 *function, si4 line, ui4 behavior_on_fail);
 si4			fps_read(FILE_PROCESSING_STRUCT *fps, const si1 *function, si4 line, ui4 behavior_on_fail);
+si4			fps_read_index_entries(FILE_PROCESSING_STRUCT *fps, si8 first_entry, si8 last_entry);
+si8			fps_read_ranges(FILE_PROCESSING_STRUCT *fps, FPS_RANGE *ranges, si8 number_of_ranges, const si1 *function, si4 line, ui4 behavior_on_fail);
 si4			fps_unlock(FILE_PROCESSING_STRUCT *fps, const si1 *function, si4 line, ui4 behavior_on_fail);
 si4			fps_write(FILE_PROCESSING_STRUCT *fps, const si1 *function, si4 line, ui4 behavior_on_fail);
 void			free_channel(CHANNEL *channel, si4 free_channel_structure);
 void			free_file_processing_struct(FILE_PROCESSING_STRUCT *fps);
+void			free_running_percentile(RUNNING_PERCENTILE *rp);
 void			free_segment(SEGMENT *segment, si4 free_segment_structure);
 void			free_session(SESSION *session, si4 free_session_structure);
 si1			**generate_file_list(si1 **file_list, si4 *num_files, si1 *enclosing_directory, si1 *extension);
@@ -905,7 +1011,10 @@ si4			initialize_meflib(void);
 si4			initialize_metadata(FILE_PROCESSING_STRUCT *fps);
 si4			initialize_universal_header(FILE_PROCESSING_STRUCT *fps, si1 generate_level_UUID, si1 generate_file_UUID, si1 originating_file);
 si1			*local_date_time_string(si8 uutc_time, si1 *time_str);
+MEF_CONTEXT		*MEF_get_context(void);
+void			MEF_initialize_context(MEF_CONTEXT *context, MEF_CONTEXT *settings);
 si8			MEF_pad(ui1 *buffer, si8 content_len, ui4 alignment);
+MEF_CONTEXT		*MEF_set_context(MEF_CONTEXT *context);
 si4			MEF_sprintf(si1 *target, si1 *format, ...);
 void			MEF_snprintf(si1 *target, si4 target_field_bytes, si1 *format, ...);
 si4			MEF_strcat(si1 *target_string, si1 *source_string);
@@ -919,9 +1028,11 @@ si4			offset_universal_header_times(FILE_PROCESSING_STRUCT *fps, si4 action);
 si4			offset_video_index_times(FILE_PROCESSING_STRUCT *fps, si4 action);
 PASSWORD_DATA		*process_password_data(si1 *unspecified_password, si1 *level_1_password, si1 *level_2_password, UNIVERSAL_HEADER *universal_header);
 void			proportion_filt(sf8 *x, sf8 *px, si8 len, sf8 prop, si4 span);
+sf8			quickselect_sf8(sf8 *x, si8 len, si8 k);
 ui1			random_byte(ui4 *m_w, ui4 *m_z);
 CHANNEL			*read_MEF_channel(CHANNEL *channel, si1 *chan_path, si4 channel_type, si1 *password, PASSWORD_DATA *password_data, si1 read_time_series_data, si1 read_record_data);
 FILE_PROCESSING_STRUCT	*read_MEF_file(FILE_PROCESSING_STRUCT *fps, si1 *file_name, si1 *password, PASSWORD_DATA *password_data, FILE_PROCESSING_DIRECTIVES *directives, ui4 behavior_on_fail);
+FILE_PROCESSING_STRUCT	*read_MEF_indices(si1 *file_name, si1 *password, PASSWORD_DATA *password_data, ui4 behavior_on_fail);
 SEGMENT			*read_MEF_segment(SEGMENT *segment, si1 *seg_path, si4 channel_type, si1 *password, PASSWORD_DATA *password_data, si1 read_time_series_data, si1 read_record_data);
 SESSION			*read_MEF_session(SESSION *session, si1 *sess_path, si1 *password, PASSWORD_DATA *password_data, si1 read_time_series_data, si1 read_record_data);
 si4			reallocate_file_processing_struct(FILE_PROCESSING_STRUCT *fps, si8 raw_data_bytes);
@@ -934,8 +1045,10 @@ void			show_password_data(FILE_PROCESSING_STRUCT *fps);
 void			show_record(RECORD_HEADER *record_header, ui4 record_number, PASSWORD_DATA *pwd);
 void			show_records(FILE_PROCESSING_STRUCT *fps);
 void			show_universal_header(FILE_PROCESSING_STRUCT *fps);
+void			sift_running_percentile(RUNNING_PERCENTILE *rp, si4 pos);
 si4			sort_by_idx(const void *n1, const void *n2);
 si4			sort_by_val(const void *n1, const void *n2);
+sf8			update_running_percentile(RUNNING_PERCENTILE *rp, sf8 new_val);
 sf8			val_equals_prop(NODE *curr_node, NODE *prop_node);
 si4			write_MEF_file(FILE_PROCESSING_STRUCT *fps);
 
@@ -943,6 +1056,69 @@ si4			write_MEF_file(FILE_PROCESSING_STRUCT *fps);
 	void 		slash_to_backslash(si1*);
 #endif
 
+/************************************************************************************/
+/*************************************  THREADS  ************************************/
+/************************************************************************************/
+
+// Portable worker threads (POSIX threads, or native threads on Windows).
+// THREAD_run_tasks() hands out task numbers [0, number_of_tasks) to a set of workers; the calling
+// thread is always worker 0, so per-thread scratch can be indexed by the thread number passed to the task.
+// Tasks must not call the MATLAB API and should treat MEF_globals as read-only.
+
+
+// Constants
+#define THREAD_MAXIMUM_NUMBER_OF_THREADS	256
+#define THREAD_NUMBER_OF_THREADS_DEFAULT	0	// zero or negative => one thread per online processor
+
+// Typedefs & Structures
+#ifdef _WIN32
+	#define THREAD_RETURN_TYPE	DWORD WINAPI
+	typedef HANDLE			THREAD_ID;
+	typedef CRITICAL_SECTION	THREAD_MUTEX;
+	typedef CONDITION_VARIABLE	THREAD_CONDITION;
+	typedef LPTHREAD_START_ROUTINE	THREAD_FUNCTION;
+#else
+	#define THREAD_RETURN_TYPE	void *
+	typedef pthread_t		THREAD_ID;
+	typedef pthread_mutex_t		THREAD_MUTEX;
+	typedef pthread_cond_t		THREAD_CONDITION;
+	typedef void			*(*THREAD_FUNCTION)(void *);
+#endif
+
+typedef void	(*THREAD_TASK_FUNCTION)(void *task_args, si8 task_number, si4 thread_number);
+
+typedef struct {
+	THREAD_TASK_FUNCTION	task_function;
+	void			*task_args;
+	si8			number_of_tasks;
+	si8			next_task;
+	MEF_CONTEXT		*context;  // of the thread running the tasks
+	THREAD_MUTEX		mutex;
+} THREAD_TASK_QUEUE;
+
+typedef struct {
+	THREAD_TASK_QUEUE	*queue;
+	si4			thread_number;
+} THREAD_WORKER;
+
+// Function Prototypes
+void			THREAD_condition_broadcast(THREAD_CONDITION *condition);
+void			THREAD_condition_destroy(THREAD_CONDITION *condition);
+void			THREAD_condition_init(THREAD_CONDITION *condition);
+void			THREAD_condition_wait(THREAD_CONDITION *condition, THREAD_MUTEX *mutex);
+si4			THREAD_create(THREAD_ID *thread_id, THREAD_FUNCTION thread_function, void *thread_args);
+si4			THREAD_join(THREAD_ID thread_id);
+void			THREAD_mutex_destroy(THREAD_MUTEX *mutex);
+void			THREAD_mutex_init(THREAD_MUTEX *mutex);
+void			THREAD_mutex_lock(THREAD_MUTEX *mutex);
+void			THREAD_mutex_unlock(THREAD_MUTEX *mutex);
+si4			THREAD_number_of_processors(void);
+si4			THREAD_number_of_threads(si4 requested_threads, si8 number_of_tasks);
+si4			THREAD_run_tasks(THREAD_TASK_FUNCTION task_function, void *task_args, si8 number_of_tasks, si4 number_of_threads);
+THREAD_RETURN_TYPE	THREAD_worker(void *worker_args);
+
+
+
 /************************************************************************************/
 /**************************************  FILTER  ************************************/
 /************************************************************************************/
@@ -957,6 +1133,12 @@ si4			write_MEF_file(FILE_PROCESSING_STRUCT *fps);
 // NOTE: This code requres long double (sf16) math.
 // It often requires an explicit compiler instruction to implement true long floating point math.
 // in icc: "-Qoption,cpp,--extended_float_type"
+//
+// Lowpass & highpass filters are designed in double precision from the zeros & poles (FILT_butter_sf8()), which matches
+// the sf16 state-space design (FILT_butter()) to within FILT_SF8_DESIGN_TOLERANCE (see FILT_validate_sf8_design()).
+// Bandpass & bandstop polynomials are much more sensitive to pole error, so the double precision design is only kept
+// if its gain at both cutoffs is within FILT_SF8_CUTOFF_GAIN_TOLERANCE of 1/sqrt(2); otherwise the sf16 design is used.
+// Designs are cached by (order, type, sampling frequency, cutoffs), so each configuration is only designed once per process.
 
 
 // Constants
@@ -974,6 +1156,9 @@ si4			write_MEF_file(FILE_PROCESSING_STRUCT *fps);
 #define FILT_RADIX           				2
 #define FILT_ZERO            				((sf16) 0.0)
 #define FILT_ONE					((sf16) 1.0)
+#define FILT_SF8_DESIGN_TOLERANCE			1.0e-9	// maximum coefficient difference, relative to the largest coefficient
+#define FILT_SF8_CUTOFF_GAIN_TOLERANCE			1.0e-10
+#define FILT_COEFFICIENT_CACHE_ENTRIES			32
 
 // Macros
 #define FILT_ABS(x)          				((x) >= FILT_ZERO ? (x) : (-x))
@@ -1001,21 +1186,57 @@ typedef struct {
 	sf16	imag;
 } FILT_LONG_COMPLEX;
 
+typedef struct {
+	sf8	real;
+	sf8	imag;
+} FILT_COMPLEX;
+
+typedef struct {
+	si4	order;
+	si4	type;
+	si4	poles;
+	sf8	sampling_frequency;
+	sf8	cutoffs[2];
+	sf8	numerators[(2 * FILT_MAX_ORDER) + 1];
+	sf8	denominators[(2 * FILT_MAX_ORDER) + 1];
+	sf8	initial_conditions[2 * FILT_MAX_ORDER];
+} FILT_COEFFICIENTS;
+
+typedef struct FILT_COEFFICIENT_CACHE_STRUCT {
+	FILT_COEFFICIENTS	entries[FILT_COEFFICIENT_CACHE_ENTRIES];
+	si4			number_of_entries;
+	si4			next_entry;  // replaced round-robin when full
+	ui8			hits;
+	ui8			misses;
+	THREAD_MUTEX		mutex;
+} FILT_COEFFICIENT_CACHE;
+
 // Prototypes
 void			FILT_balance(sf16 **a, si4 poles);
 si4			FILT_butter(FILT_PROCESSING_STRUCT *filtps);
+si4			FILT_butter_sf8(FILT_PROCESSING_STRUCT *filtps);
+si4			FILT_check_cutoff_gain(FILT_PROCESSING_STRUCT *filtps, sf8 tolerance);
+void			FILT_complex_div(FILT_COMPLEX *a, FILT_COMPLEX *b, FILT_COMPLEX *quotient);
 void			FILT_complex_divl(FILT_LONG_COMPLEX *a, FILT_LONG_COMPLEX *b, FILT_LONG_COMPLEX *quotient);
+void			FILT_complex_exp(FILT_COMPLEX *exponent, FILT_COMPLEX *ans);
 void			FILT_complex_expl(FILT_LONG_COMPLEX *exponent, FILT_LONG_COMPLEX *ans);
+void			FILT_complex_mult(FILT_COMPLEX *a, FILT_COMPLEX *b, FILT_COMPLEX *product);
 void			FILT_complex_multl(FILT_LONG_COMPLEX *a, FILT_LONG_COMPLEX *b, FILT_LONG_COMPLEX *product);
+void			FILT_complex_sqrt(FILT_COMPLEX *a, FILT_COMPLEX *root);
+si4			FILT_design(FILT_PROCESSING_STRUCT *filtps);
 void			FILT_elmhes(sf16 **a, si4 poles);
 si4			FILT_filtfilt(FILT_PROCESSING_STRUCT *filtps);
 void			FILT_free_processing_struct(FILT_PROCESSING_STRUCT *filtps, si1 free_orig_data, si1 free_filt_data);
+si4			FILT_get_cached_coefficients(FILT_PROCESSING_STRUCT *filtps);
+FILT_COEFFICIENT_CACHE	*FILT_initialize_coefficient_cache(si4 global_flag);
 FILT_PROCESSING_STRUCT	*FILT_initialize_processing_struct(si4 order, si4 type, sf8 samp_freq, si8 data_len, si1 alloc_orig_data, si1 alloc_filt_data, sf8 cutoff_1, ...);
 void			FILT_generate_initial_conditions(FILT_PROCESSING_STRUCT *filtps);
 void			FILT_hqr(sf16 **a, si4 poles, FILT_LONG_COMPLEX *eigs);
 void			FILT_invert_matrix(sf16 **a, sf16 **inv_a, si4 order);
 void			FILT_mat_multl(void *a, void *b, void *product, si4 outer_dim1, si4 inner_dim, si4 outer_dim2);
+void			FILT_put_cached_coefficients(FILT_PROCESSING_STRUCT *filtps);
 void			FILT_unsymmeig(sf16 **a, si4 poles, FILT_LONG_COMPLEX *eigs);
+si4			FILT_validate_sf8_design(si4 order, si4 type, sf8 samp_freq, sf8 cutoff_1, sf8 cutoff_2, sf8 *max_relative_difference);
 
 
 
@@ -1098,6 +1319,10 @@ void			FILT_unsymmeig(sf16 **a, si4 poles, FILT_LONG_COMPLEX *eigs);
 #define	RED_UPDATE_BLOCK_HEADER_PTR	2
 #define	RED_UPDATE_DECOMPRESSED_PTR	4
 
+// RED Parallel Encoding
+#define RED_ENCODE_BATCH_BLOCKS_PER_THREAD	32	// blocks encoded per thread between serializations (bounds the slot buffer)
+#define RED_ENCODE_BLOCK_DURATION_DEFAULT	1.0	// seconds; used by write_MEF_time_series_segment() when the metadata prototype has no maximum_block_samples
+
 // Normal cumulative distribution fucntion values from -3 to +3 standard deviations in 0.1 sigma steps
 #define RED_NORMAL_CDF_TABLE_ENTRIES	61
 #define RED_NORMAL_CDF_TABLE	      {	0.00134989803163010, 0.00186581330038404, 0.00255513033042794, 0.00346697380304067, \
@@ -1172,6 +1397,21 @@ typedef struct {
         si4				*scaled_buffer;  // used if needed in compression, size of decompressed block
 } RED_PROCESSING_STRUCT;
 
+typedef struct {
+	RED_PROCESSING_STRUCT		**rps;  // one per worker thread (indexed by thread number)
+	si4				*samples;  // all samples being encoded
+	si8				number_of_samples;
+	si8				number_of_blocks;
+	si8				first_block;  // block number of task 0 in the current batch
+	ui4				block_samples;
+	si8				start_time;  // time of samples[0]
+	sf8				sampling_frequency;
+	si1				discontinuity;  // discontinuity flag for block 0
+	ui1				*block_slots;  // one slot of RED_MAX_COMPRESSED_BYTES(block_samples, 1) bytes per block in the batch
+	si8				slot_bytes;
+	TIME_SERIES_INDEX		*tsi;  // one per block in the batch (file offsets are filled in on serialization)
+} RED_ENCODE_TASK_ARGS;
+
 // Function Prototypes
 RED_PROCESSING_STRUCT	*RED_allocate_processing_struct(si8 original_data_size, si8 compressed_data_size, si8 decompressed_data_size, si8 difference_buffer_size, si8 detrended_buffer_size, si8 scaled_buffer_size, PASSWORD_DATA *password_data);
 sf8			RED_calculate_mean_residual_ratio(si4 *original_data, si4 *lossy_data, ui4 n_samps);
@@ -1179,6 +1419,8 @@ si1			RED_check_RPS_allocation(RED_PROCESSING_STRUCT *rps);
 void			RED_decode(RED_PROCESSING_STRUCT *rps);
 si4			*RED_detrend(RED_PROCESSING_STRUCT *rps, si4 *input_buffer, si4 *output_buffer);
 void			RED_encode(RED_PROCESSING_STRUCT *rps);
+void			RED_encode_block_task(void *task_args, si8 task_number, si4 thread_number);
+si8			RED_encode_blocks(FILE_PROCESSING_STRUCT *data_fps, FILE_PROCESSING_STRUCT *indices_fps, si4 *samples, si8 number_of_samples, si8 start_sample, si8 start_time, sf8 sampling_frequency, ui4 block_samples, RED_PROCESSING_STRUCT *proto_rps, si4 number_of_threads);
 void			RED_encode_exec(RED_PROCESSING_STRUCT *rps, si4 *input_buffer, si1 input_is_detrended);
 void			RED_encode_lossy(RED_PROCESSING_STRUCT *rps);
 void			RED_filter(FILT_PROCESSING_STRUCT *filtps);
@@ -1194,6 +1436,540 @@ sf8			RED_test_normality(si4 *data, ui4 n_samps);
 si4			*RED_unscale(RED_PROCESSING_STRUCT *rps, si4 *input_buffer, si4 *output_buffer);
 RED_BLOCK_HEADER	*RED_update_RPS_pointers(RED_PROCESSING_STRUCT *rps, ui1 flags);
 
+// MEF writing function prototypes that depend on RED structures
+si4			write_MEF_time_series_segment(si1 *channel_path, FILE_PROCESSING_STRUCT *proto_metadata_fps, si4 segment_number, si4 *samples, si8 number_of_samples, si8 start_sample, si8 start_time, RED_PROCESSING_STRUCT *proto_rps, si4 number_of_threads);
+
+
+/************************************************************************************/
+/*************************************  STREAM  *************************************/
+/************************************************************************************/
+
+// Stream writer: appends RED blocks to open segment files with bounded memory; after each header/metadata update
+// the files on disk are consistent (the universal headers never count entries that have not been written)
+
+// Constants
+#define STREAM_SYNC_NONE			0	// leave flushing to the operating system
+#define STREAM_SYNC_ON_UPDATE			1	// fsync the segment files around each header & metadata update (and on close)
+#define STREAM_SYNC_ON_FLUSH			2	// also fsync the data & indices files after every block
+#define STREAM_SYNC_MODE_DEFAULT		STREAM_SYNC_ON_UPDATE
+#define STREAM_UPDATE_INTERVAL_DEFAULT		60	// blocks between header & metadata updates (one minute of one second blocks)
+#define STREAM_TEMPORARY_FILE_EXTENSION		"tmp"	// metadata is written to a temporary file & renamed
+
+// Typedefs & Structures
+typedef struct {
+	si1				channel_path[MEF_FULL_FILE_NAME_BYTES];  // channel directory
+	FILE_PROCESSING_STRUCT		*metadata_fps;  // current segment metadata (kept decrypted; written through a temporary file)
+	FILE_PROCESSING_STRUCT		*data_fps;  // open .tdat file (raw data is the universal header only); NULL when no segment is open
+	FILE_PROCESSING_STRUCT		*indices_fps;  // open .tidx file (raw data is the universal header only)
+	RED_PROCESSING_STRUCT		*rps;  // original_data is the sample buffer, compressed_data holds one block
+	ui4				block_samples;
+	ui4				buffered_samples;
+	si1				discontinuity;  // next block is the first after a discontinuity
+	si1				sync_mode;
+	si8				update_interval;  // blocks between header & metadata updates (<= 0: only on roll & close)
+	si8				blocks_since_update;
+	si8				run_start_time;  // time of the first sample since the last discontinuity
+	si8				run_samples;  // samples flushed since the last discontinuity
+	si4				segment_number;
+	si8				segment_start_sample;  // relative to the channel start
+	si8				segment_samples;
+	si8				data_bytes;  // current .tdat file length
+	ui4				data_body_CRC;
+	ui4				indices_body_CRC;
+	si8				contiguous_blocks;  // current contiguous run in this segment
+	si8				contiguous_block_bytes;
+	si8				contiguous_samples;
+	si4				maximum_sample_value;
+	si4				minimum_sample_value;
+} TIME_SERIES_STREAM;
+
+// Function Prototypes
+si4			STREAM_append(TIME_SERIES_STREAM *stream, si4 *samples, si8 number_of_samples, si8 start_time);
+si4			STREAM_close(TIME_SERIES_STREAM *stream);
+si4			STREAM_close_segment(TIME_SERIES_STREAM *stream);
+si4			STREAM_flush_block(TIME_SERIES_STREAM *stream);
+TIME_SERIES_STREAM	*STREAM_open(si1 *channel_path, FILE_PROCESSING_STRUCT *proto_metadata_fps, RED_PROCESSING_STRUCT *proto_rps, si4 segment_number, si8 start_sample, si8 start_time, si1 sync_mode, si8 update_interval);
+si4			STREAM_open_segment(TIME_SERIES_STREAM *stream);
+void			STREAM_output_time(si8 *time);
+si4			STREAM_roll_segment(TIME_SERIES_STREAM *stream);
+si4			STREAM_sync_file(FILE_PROCESSING_STRUCT *fps);
+si4			STREAM_update(TIME_SERIES_STREAM *stream);
+si4			STREAM_write_universal_header(FILE_PROCESSING_STRUCT *fps, ui4 body_CRC);
+
+
+
+/************************************************************************************/
+/*********************************  RECORD QUERY  ***********************************/
+/************************************************************************************/
+
+// Record queries select records by time & type from the record indices (binary search on RECORD_INDEX.time), then
+// read, CRC check, time offset & decrypt only the matching byte ranges of the record data files. Query & index times
+// may each have the recording time offset applied or not; they are compared with it removed.
+// The record indices must be in memory, or be read on demand (MEF_INDICES_ON_DEMAND: the matching range is found by a
+// binary search of the file, the indices assumed in time order, as MEF 3.0 writes them); the record data need not be
+// (pass read_record_data = MEF_FALSE), but if it is, the matching records are copied from memory.
+
+// Constants
+#define RECORD_QUERY_MAXIMUM_TYPE_CODES		16
+#define RECORD_QUERY_NO_LEVEL			-1	// channel & segment numbers of session level records (& segment numbers of channel level records)
+#define RECORD_INDICES_ORDER_UNKNOWN		0	// FILE_PROCESSING_STRUCT record_indices_order values
+#define RECORD_INDICES_TIME_ORDERED		1
+#define RECORD_INDICES_UNORDERED		2	// not in time order, or contains UUTC_NO_ENTRY times
+
+// Typedefs & Structures
+typedef struct {
+	si8	start_time;  // inclusive (UUTC_NO_ENTRY => from the first record)
+	si8	end_time;  // inclusive (UUTC_NO_ENTRY => to the last record)
+	si4	number_of_type_codes;  // zero => all record types
+	ui4	type_codes[RECORD_QUERY_MAXIMUM_TYPE_CODES];
+} RECORD_QUERY;
+
+typedef struct {
+	si8	record_offset;  // offset of the record header in RECORD_QUERY_RESULT records
+	si4	channel_number;  // index into the session's time series channels
+	si4	segment_number;  // index into the channel's segments
+} RECORD_QUERY_MATCH;
+
+typedef struct {
+	si8			number_of_records;
+	si8			records_bytes;
+	si8			allocated_records_bytes;
+	si8			allocated_matches;
+	ui1			*records;  // matching records, headers & bodies, in file order within each level
+	RECORD_QUERY_MATCH	*matches;
+} RECORD_QUERY_RESULT;
+
+// Function Prototypes
+si4			RECORD_add_query_type(RECORD_QUERY *query, si1 *type_string);
+void			RECORD_free_query_result(RECORD_QUERY_RESULT *result, si4 free_result_structure);
+RECORD_QUERY		*RECORD_initialize_query(RECORD_QUERY *query, si8 start_time, si8 end_time);
+RECORD_QUERY_RESULT	*RECORD_query_file(FILE_PROCESSING_STRUCT *ri_fps, FILE_PROCESSING_STRUCT *rd_fps, RECORD_QUERY *query, RECORD_QUERY_RESULT *result, si4 channel_number, si4 segment_number);
+si8			RECORD_query_index_range(RECORD_INDEX *record_indices, si8 number_of_indices, si8 start_time, si8 end_time, si8 *first_index, si1 *indices_order);
+RECORD_QUERY_RESULT	*RECORD_query_session(SESSION *session, RECORD_QUERY *query, RECORD_QUERY_RESULT *result);
+si4			RECORD_query_type_matches(RECORD_QUERY *query, ui4 type_code);
+
+
+
+/************************************************************************************/
+/**********************************  CONTINUITY  ************************************/
+/************************************************************************************/
+
+// A continuity index lists the runs of contiguously sampled blocks of a time series channel, built from its time
+// series indices. Blocks are contiguous when a block starts within CONTINUITY_MAXIMUM_TIME_GAP of the end of the
+// previous one, where a block ends at start_time + number_of_samples / sampling_frequency (the MATLAB BlockIndexData
+// convention, so the end time is fractional). Conversions between times & samples are linear within each entry
+// and rounded to the nearest integer; sorted inputs are merged with the index, unsorted ones binary searched.
+
+// Constants
+#define CONTINUITY_MAXIMUM_TIME_GAP		1	// microseconds
+
+// Typedefs & Structures
+typedef struct {
+	si4	start_segment;
+	si4	end_segment;
+	si8	start_block;  // index into the start segment's time series indices
+	si8	end_block;  // index into the end segment's time series indices
+	si8	start_time;  // uUTC of the first sample
+	sf8	end_time;  // upper bound of the last sample time (not rounded)
+	si8	start_sample;  // relative to the channel start
+	si8	end_sample;  // inclusive
+	si8	number_of_samples;
+} CONTINUITY_ENTRY;
+
+typedef struct {
+	sf8			sampling_frequency;
+	si8			number_of_entries;
+	CONTINUITY_ENTRY	*entries;  // sorted by start_time
+} CONTINUITY_INDEX;
+
+// Function Prototypes
+CONTINUITY_INDEX	*CONTINUITY_build_index(CHANNEL *channel, CONTINUITY_INDEX *continuity_index);
+si4			CONTINUITY_compare_entries(const void *a, const void *b);
+si8			CONTINUITY_find_entry(CONTINUITY_INDEX *continuity_index, sf8 value, si1 by_sample);
+void			CONTINUITY_free_index(CONTINUITY_INDEX *continuity_index, si4 free_index_structure);
+void			CONTINUITY_samples_to_times(CONTINUITY_INDEX *continuity_index, sf8 *samples, si8 number_of_values, sf8 *times, ui1 *sampled);
+void			CONTINUITY_times_to_samples(CONTINUITY_INDEX *continuity_index, sf8 *times, si8 number_of_values, sf8 *samples, ui1 *sampled);
+
+
+
+/************************************************************************************/
+/************************************  ARENA  ***************************************/
+/************************************************************************************/
+
+// Session lifetime allocation: while a context's allocation mode is MEF_ALLOCATE_IN_ARENA, read_MEF_session() &
+// read_MEF_channel() create an arena & allocate the structures, metadata & index buffers of what they read from it
+// (zeroed, 16 byte aligned, carved from large slabs), as is all they allocate later. The free_*() functions only close
+// the files of structures in an arena (& free their password data if flagged, as it may be shared), & the session or
+// channel that created the arena releases all of it with one free. Arena memory is never reused before then, so
+// structures read into an arena should not be reallocated repeatedly (reallocate_file_processing_struct() moves them
+// to new arena memory). An arena is filled from the thread reading into it.
+
+// Constants
+#define ARENA_SLAB_BYTES_DEFAULT	((si8) 256 << 10)
+#define ARENA_ALIGNMENT_BYTES		16
+#define ARENA_DEDICATED_SLAB_DIVISOR	4	// requests over (slab bytes / divisor) get a slab of their own
+
+// Macros
+#define ARENA_ALIGN(n)			((((si8) (n)) + (ARENA_ALIGNMENT_BYTES - 1)) & ~((si8) ARENA_ALIGNMENT_BYTES - 1))
+
+// Typedefs & Structures
+typedef struct ARENA_SLAB_STRUCT {
+	struct ARENA_SLAB_STRUCT	*next;
+	si8				bytes;  // of data
+	si8				used_bytes;
+	ui1				*data;  // follows the slab header
+} ARENA_SLAB;
+
+typedef struct MEF_ARENA_STRUCT {
+	ARENA_SLAB	*slabs;  // the slab being filled first
+	si8		slab_bytes;
+	si8		allocated_bytes;  // in slabs
+	si8		used_bytes;  // handed out (including alignment)
+	si8		allocations;
+	void		*owner;  // the session or channel whose free releases the arena
+} MEF_ARENA;
+
+// Function Prototypes
+MEF_ARENA	*ARENA_allocate(si8 slab_bytes);
+void		*ARENA_calloc(MEF_ARENA *arena, size_t n_members, size_t size, const si1 *function, si4 line, ui4 behavior_on_fail);
+si4		ARENA_contains(MEF_ARENA *arena, void *ptr);
+void		ARENA_free(MEF_ARENA *arena);
+void		ARENA_release(MEF_ARENA *arena, void *ptr);
+
+
+
+/************************************************************************************/
+/*********************************  BLOCK CACHE  ************************************/
+/************************************************************************************/
+
+// Decoded RED blocks, keyed by (time series data file UUID, block number), kept under a byte budget with CLOCK
+// (second chance) replacement. Reads copy cached blocks instead of reading & decoding them, & add the blocks they
+// decode. Entries record the block's encryption level, & are only served to readers with that access. Segments
+// without a file UUID are not cached.
+
+// Constants
+#define BLOCK_CACHE_NUMBER_OF_BUCKETS		4096  // power of 2
+#define BLOCK_CACHE_NO_ENTRY			-1
+#define BLOCK_CACHE_MAXIMUM_BYTES_DEFAULT	((si8) 256 << 20)
+
+// Macros
+#define BLOCK_CACHE_ENTRY_BYTES(n)		(((si8) (n) * (si8) sizeof(si4)) + (si8) sizeof(BLOCK_CACHE_ENTRY))
+
+// Typedefs & Structures
+typedef struct {
+	ui1	segment_UUID[UUID_BYTES];  // of the segment's time series data file
+	si8	block_number;
+	si8	number_of_samples;
+	si4	*samples;
+	si8	next;  // next entry of the hash chain (or of the free list)
+	si1	encryption_level;
+	si1	referenced;  // CLOCK reference bit
+	si1	pinned;  // being decoded into (not evicted)
+	si1	in_use;
+} BLOCK_CACHE_ENTRY;
+
+typedef struct BLOCK_CACHE_STRUCT {
+	si8			maximum_bytes;  // 0 disables caching
+	si8			bytes;
+	si8			number_of_entries;
+	si8			used_entries;  // entries of the table used so far (in use or free)
+	si8			allocated_entries;
+	si8			free_entries;  // free list
+	si8			clock_hand;
+	si8			buckets[BLOCK_CACHE_NUMBER_OF_BUCKETS];
+	BLOCK_CACHE_ENTRY	*entries;
+	ui8			hits;
+	ui8			misses;
+	ui8			evictions;
+	THREAD_MUTEX		mutex;
+} BLOCK_CACHE;
+
+// Function Prototypes
+void		BLOCK_CACHE_clear(BLOCK_CACHE *cache);
+si4		BLOCK_CACHE_copy(BLOCK_CACHE *cache, ui1 *segment_UUID, si8 block_number, si1 access_level, si4 *samples, si8 skip_samples, si8 number_of_samples);
+si4		BLOCK_CACHE_evict(BLOCK_CACHE *cache, si8 bytes);
+void		BLOCK_CACHE_free(BLOCK_CACHE *cache);
+ui4		BLOCK_CACHE_hash(ui1 *segment_UUID, si8 block_number);
+BLOCK_CACHE	*BLOCK_CACHE_initialize(si8 maximum_bytes, si4 global_flag);
+si8		BLOCK_CACHE_insert(BLOCK_CACHE *cache, ui1 *segment_UUID, si8 block_number, si8 number_of_samples, si1 encryption_level, si4 **samples);
+void		BLOCK_CACHE_release(BLOCK_CACHE *cache, si8 entry_number, si4 keep_entry);
+void		BLOCK_CACHE_remove(BLOCK_CACHE *cache, si8 entry_number);
+void		BLOCK_CACHE_set_maximum_bytes(BLOCK_CACHE *cache, si8 maximum_bytes);
+
+
+
+/************************************************************************************/
+/************************************  PROFILE  *************************************/
+/************************************************************************************/
+
+// Opt-in instrumentation of reads: while a context's profile is set, the library adds the wall & CPU time of each
+// phase (summed over threads), the bytes read, the blocks decoded, the CRC failures & the allocations to it. Timers
+// nest per thread, & a phase excludes the time of the phases nested in it (e.g. the reads & CRC checks of opening a
+// channel count as read & CRC, not open). Without a profile a timer costs a test of the context.
+
+// Constants
+#define PROFILE_PHASE_OPEN		0	// reading the metadata, indices & records of a session, channel or segment
+#define PROFILE_PHASE_READ		1	// reading from files
+#define PROFILE_PHASE_CRC		2	// CRC validation
+#define PROFILE_PHASE_AES		3	// decryption
+#define PROFILE_PHASE_DECODE		4	// RED decoding
+#define PROFILE_PHASE_CONVERT		5	// the caller's conversion of the results (e.g. to Matlab arrays)
+#define PROFILE_NUMBER_OF_PHASES	6
+
+// Macros
+#define PROFILE_START(timer)		(((timer).profile = MEF_context->profile) != NULL ? PROFILE_start_timer(&(timer)) : (void) 0)
+#define PROFILE_STOP(timer, phase)	(((timer).profile != NULL) ? PROFILE_stop_timer(&(timer), (phase)) : (void) 0)
+#define PROFILE_COUNT(field, n)		((MEF_context->profile != NULL) ? PROFILE_add(&MEF_context->profile->field, (si8) (n)) : (void) 0)
+
+// Typedefs & Structures
+typedef struct MEF_PROFILE_STRUCT {
+	si8	wall_ns;  // from PROFILE_begin() to PROFILE_end()
+	si8	CPU_ns;  // process CPU time (all threads)
+	si8	phase_wall_ns[PROFILE_NUMBER_OF_PHASES];  // summed over threads
+	si8	phase_CPU_ns[PROFILE_NUMBER_OF_PHASES];
+	si8	phase_calls[PROFILE_NUMBER_OF_PHASES];
+	si8	bytes_read;
+	si8	blocks_decoded;
+	si8	CRC_failures;
+	si8	allocations;
+	si8	allocated_bytes;
+} MEF_PROFILE;
+
+typedef struct PROFILE_TIMER_STRUCT {
+	MEF_PROFILE			*profile;  // NULL: not timing
+	si8				start_wall_ns;
+	si8				start_CPU_ns;  // thread CPU time
+	si8				nested_wall_ns;  // of the timers nested in this one
+	si8				nested_CPU_ns;
+	struct PROFILE_TIMER_STRUCT	*parent;  // timer running on this thread when this one started
+} PROFILE_TIMER;
+
+// Function Prototypes
+void	PROFILE_add(si8 *counter, si8 value);
+void	PROFILE_begin(MEF_PROFILE *profile);
+void	PROFILE_end(MEF_PROFILE *profile);
+si8	PROFILE_process_CPU_ns(void);
+const si1	*PROFILE_phase_name(si4 phase);
+void	PROFILE_start_timer(PROFILE_TIMER *timer);
+void	PROFILE_stop_timer(PROFILE_TIMER *timer, si4 phase);
+si8	PROFILE_thread_CPU_ns(void);
+si8	PROFILE_wall_ns(void);
+
+
+
+/************************************************************************************/
+/**********************************  READ PLAN  *************************************/
+/************************************************************************************/
+
+// A read plan places the blocks of a time series channel into the output of a time range read before any decoding.
+// Only the first block of each continuity index entry is placed by its time; the others follow at their sample
+// offsets within the entry, so placement does not drift. Output samples covered by no block are listed as gaps
+// (filled with RED_NAN). Block placement uses integer arithmetic when the sampling frequency is a whole number.
+// Sample range plans place blocks by their channel sample numbers. A batch of plans (e.g. epochs) decodes each block
+// the plans share once. A slice of a plan executes part of its output (a long read in bounded memory).
+
+// Constants
+#define READ_PLAN_BLOCKS_PER_TASK		16	// blocks decoded per thread task
+#define READ_PLAN_BLOCK_PAD_BYTES		8	// zeroed bytes after a span of blocks read
+
+// Typedefs & Structures
+typedef struct {
+	si4	segment_number;
+	si8	block_number;  // index into the segment's time series indices
+	si8	skip_samples;  // leading samples of the block that precede its output slot
+	si8	number_of_samples;  // samples of the block copied to the output
+	si8	output_offset;
+} READ_PLAN_BLOCK;
+
+typedef struct {
+	si8	output_offset;
+	si8	number_of_samples;
+} READ_PLAN_GAP;
+
+typedef struct {
+	si8		start_time;  // uUTC (recording time offset removed), inclusive
+	si8		end_time;  // uUTC, exclusive
+	si8		number_of_samples;  // output samples
+	si8		number_of_blocks;
+	si8		number_of_gaps;
+	READ_PLAN_BLOCK	*blocks;  // in output order
+	READ_PLAN_GAP	*gaps;  // in output order
+	si8		allocated_blocks;
+	si8		allocated_gaps;
+} READ_PLAN;
+
+typedef struct {
+	CHANNEL			*channel;
+	READ_PLAN		*plan;
+	si4			*samples;  // output
+	ui1			**block_data;  // compressed data of each plan block
+	RED_PROCESSING_STRUCT	**rps;  // one per worker thread (indexed by thread number); decompressed_data buffers partial blocks
+	si1			*block_decoded;  // one per plan block
+	si4			**cache_samples;  // one per plan block: its block cache entry's samples, or NULL
+} READ_PLAN_TASK_ARGS;
+
+// Function Prototypes
+void		READ_PLAN_add_gap(READ_PLAN *plan, si8 output_offset, si8 number_of_samples);
+READ_PLAN	*READ_PLAN_build(CHANNEL *channel, CONTINUITY_INDEX *continuity_index, si8 start_time, si8 end_time, READ_PLAN *plan);
+READ_PLAN	*READ_PLAN_build_for_samples(CHANNEL *channel, si8 start_sample, si8 end_sample, READ_PLAN *plan);
+si4		READ_PLAN_compare_blocks(const void *a, const void *b);
+void		READ_PLAN_decode_task(void *task_args, si8 task_number, si4 thread_number);
+si8		READ_PLAN_execute(CHANNEL *channel, READ_PLAN *plan, si4 *samples, si4 number_of_threads);
+si8		READ_PLAN_execute_batch(CHANNEL *channel, READ_PLAN *plans, si8 number_of_plans, si4 **samples, si4 number_of_threads);
+void		READ_PLAN_free(READ_PLAN *plan, si4 free_plan_structure);
+si8		READ_PLAN_place_blocks(READ_PLAN *plan, CHANNEL *channel, si4 segment_number, si8 first_block, si8 last_block, si8 slot_offset, si8 covered);
+si4		READ_PLAN_read_spans(FILE_PROCESSING_STRUCT *fps, FPS_RANGE *ranges, si8 number_of_ranges);
+si8		READ_PLAN_samples_in_time(si8 microseconds, sf8 sampling_frequency);
+READ_PLAN	*READ_PLAN_slice(READ_PLAN *plan, si8 start_sample, si8 end_sample, READ_PLAN *slice);
+
+
+
+/************************************************************************************/
+/*********************************  SCAN READER  ************************************/
+/************************************************************************************/
+
+// A scan reader hands out fixed windows of channel samples ([start, start + window) every step samples) while a
+// background thread reads & decodes the windows that follow into a ring, so the caller's processing of one window
+// overlaps the I/O & decoding of the next ones. The ring holds the windows covering the next prefetch blocks. Only the
+// worker reads the channel while it runs; a window requested out of sequence stops it, empties the ring, & restarts
+// it at that window. Windows are planned by sample number (samples past the end of the channel are RED_NAN). The
+// worker reads in the reader's own MEF_CONTEXT, so the caller's context can be used & changed while it runs.
+
+// Constants
+#define SCAN_READER_PREFETCH_BLOCKS_DEFAULT	8
+#define SCAN_READER_MINIMUM_WINDOWS		2
+#define SCAN_READER_MAXIMUM_WINDOWS		64
+#define SCAN_READER_WINDOW_EMPTY		0
+#define SCAN_READER_WINDOW_FILLING		1
+#define SCAN_READER_WINDOW_READY		2
+
+// Typedefs & Structures
+typedef struct {
+	si8	start_sample;
+	si8	number_of_samples;  // window samples within the channel
+	si8	failed_blocks;  // as returned by READ_PLAN_execute()
+	si4	*samples;  // window_samples
+	si1	state;
+} SCAN_READER_WINDOW;
+
+typedef struct {
+	CHANNEL			*channel;  // time series indices read (not freed with the reader)
+	si8			number_of_samples;  // in the channel
+	si8			window_samples;
+	si8			step_samples;
+	si8			next_sample;  // start of the window expected next
+	si8			prefetch_sample;  // start of the next window to fill
+	si4			number_of_windows;  // in the ring
+	si4			filled_windows;  // ring windows filling or ready
+	si4			head;  // ring window of next_sample
+	si4			tail;  // ring window filled next
+	si4			number_of_threads;  // decoding threads of the worker
+	si1			stop;
+	si1			worker_running;
+	ui8			prefetch_hits;  // windows ready when requested
+	ui8			prefetch_misses;  // windows waited for
+	ui8			restarts;  // windows requested out of sequence
+	SCAN_READER_WINDOW	*windows;
+	MEF_CONTEXT		context;  // the worker's (copied from the initializing thread's)
+	THREAD_ID		worker;
+	THREAD_MUTEX		mutex;
+	THREAD_CONDITION	window_ready;
+	THREAD_CONDITION	window_free;
+} SCAN_READER;
+
+// Function Prototypes
+void			SCAN_READER_free(SCAN_READER *reader);
+SCAN_READER		*SCAN_READER_initialize(CHANNEL *channel, si8 window_samples, si8 step_samples, si8 prefetch_blocks, si4 number_of_threads);
+si8			SCAN_READER_read(SCAN_READER *reader, si8 start_sample, si4 *samples, si8 *failed_blocks);
+si4			SCAN_READER_seek(SCAN_READER *reader, si8 start_sample);
+si4			SCAN_READER_start(SCAN_READER *reader);
+void			SCAN_READER_stop(SCAN_READER *reader);
+THREAD_RETURN_TYPE	SCAN_READER_worker(void *reader_args);
+
+
+
+/************************************************************************************/
+/**********************************  ENVELOPE  **************************************/
+/************************************************************************************/
+
+// Min/max (& RMS) envelope of a time series channel over a time range in a number of bins (e.g. pixels of a plot).
+// Bins at least as wide as the blocks are answered from the extrema in the time series indices, without decoding.
+// Finer bins use the envelope pyramids of the segments: levels of min/max/RMS over runs of samples within each block
+// (finest first, one bin per block last), built in one parallel decoding pass & kept in a sidecar file next to the
+// segment's data file. Ranges with blocks covered by neither are decoded. Pyramid bins never span two blocks, so they
+// never span a discontinuity. A sidecar file is only used if it matches the segment's data file UUID & block count.
+// Pyramids are not built, written or read for segments with encrypted blocks (their envelopes are decoded, which
+// checks the access level).
+
+// Constants
+#define ENVELOPE_FILE_TYPE_STRING		"tenv"	// ascii[4]
+#define ENVELOPE_FILE_MAGIC			"MEFENVL1"
+#define ENVELOPE_FILE_MAGIC_BYTES		8
+#define ENVELOPE_FINEST_BIN_SAMPLES		64
+#define ENVELOPE_LEVEL_FACTOR			8
+#define ENVELOPE_MAXIMUM_LEVELS			8
+#define ENVELOPE_BUILD_BATCH_BLOCKS		1024	// blocks decoded at once while building a pyramid
+#define ENVELOPE_SOURCE_NONE			-1
+#define ENVELOPE_SOURCE_INDICES			0
+#define ENVELOPE_SOURCE_PYRAMID			1
+#define ENVELOPE_SOURCE_SAMPLES			2
+
+// Typedefs & Structures
+typedef struct {
+	si4	minimum;
+	si4	maximum;
+	sf4	rms;
+	ui4	number_of_samples;  // 0 if the samples could not be decoded
+} ENVELOPE_BIN;
+
+typedef struct {
+	si8		bin_samples;
+	si8		number_of_bins;
+	si8		*block_bins;  // first bin of each block (number_of_blocks + 1 entries)
+	ENVELOPE_BIN	*bins;
+} ENVELOPE_LEVEL;
+
+typedef struct {
+	ui1		segment_UUID[UUID_BYTES];  // of the segment's time series data file
+	si8		number_of_blocks;
+	si4		number_of_levels;
+	ENVELOPE_LEVEL	levels[ENVELOPE_MAXIMUM_LEVELS];  // finest first
+} ENVELOPE_PYRAMID;
+
+typedef struct {
+	si8	start_time;  // uUTC (recording time offset removed), inclusive
+	si8	end_time;  // uUTC, exclusive
+	si8	number_of_bins;
+	sf8	bin_duration;  // uUTC
+	sf8	*minimum;  // NaN in bins without samples
+	sf8	*maximum;
+	sf8	*rms;  // NaN in bins without samples, or answered from the time series indices
+	sf8	*sum_of_squares;
+	sf8	*rms_samples;  // samples in sum_of_squares
+	si1	source;  // finest source used
+} ENVELOPE;
+
+typedef struct {
+	ENVELOPE_PYRAMID	*pyramid;
+	TIME_SERIES_INDEX	*tsi;
+	si4			*samples;  // of the batch, in sample order
+	si8			first_block;  // of the batch
+	si8			first_sample;  // segment sample of samples[0]
+} ENVELOPE_TASK_ARGS;
+
+// Function Prototypes
+void			ENVELOPE_add(ENVELOPE *envelope, sf8 start_time, sf8 duration, sf8 minimum, sf8 maximum, sf8 sum_of_squares, si8 rms_samples);
+ENVELOPE_PYRAMID	*ENVELOPE_build_pyramid(CHANNEL *channel, si4 segment_number, si4 number_of_threads, si8 *failed_blocks);
+void			ENVELOPE_build_task(void *task_args, si8 task_number, si4 thread_number);
+void			ENVELOPE_free(ENVELOPE *envelope, si4 free_envelope_structure);
+void			ENVELOPE_free_pyramid(ENVELOPE_PYRAMID *pyramid);
+void			ENVELOPE_pyramid_file_name(SEGMENT *segment, si1 *file_name);
+ENVELOPE		*ENVELOPE_query(CHANNEL *channel, ENVELOPE_PYRAMID **pyramids, si8 start_time, si8 end_time, si8 number_of_bins, si4 number_of_threads, ENVELOPE *envelope);
+ENVELOPE_PYRAMID	*ENVELOPE_read_pyramid(SEGMENT *segment);
+si4			ENVELOPE_segment_encrypted(SEGMENT *segment);
+si4			ENVELOPE_write_pyramid(SEGMENT *segment, ENVELOPE_PYRAMID *pyramid);
+
+
 
 /************************************************************************************/
 /****************************************  CRC  *************************************/
@@ -1204,6 +1980,9 @@ RED_BLOCK_HEADER	*RED_update_RPS_pointers(RED_PROCESSING_STRUCT *rps, ui1 flags)
 #define	KOOPMAN32				0xEB31D82E
 #define CRC_TABLE_ENTRIES			256
 #define CRC_START_VALUE				0xFFFFFFFF
+#define CRC_GF2_DIMENSION			32		// bits in the CRC (size of the GF(2) operator matrices used by CRC_combine())
+#define CRC_PARALLEL_MINIMUM_BYTES		((si8) 1 << 22)	// below this, CRC_calculate_parallel() runs in the calling thread
+#define CRC_PARALLEL_CHUNK_BYTES		((si8) 1 << 20)	// minimum bytes per parallel chunk
 
 
 #define CRC_KOOPMAN32_KEY     {	0x00000000, 0x9695C4CA, 0xFB4839C9, 0x6DDDFD03, \
@@ -1271,11 +2050,25 @@ RED_BLOCK_HEADER	*RED_update_RPS_pointers(RED_PROCESSING_STRUCT *rps, ui1 flags)
 				0x8D7C12BE, 0x1BE9D674, 0x76342B77, 0xE0A1EFBD, \
 				0xAD8FD171, 0x3B1A15BB, 0x56C7E8B8, 0xC0522C72 }
 
+// Typedefs & Structures
+typedef struct {
+	ui1	*block_ptr;
+	si8	block_bytes;
+	si8	chunk_bytes;
+	ui4	*chunk_CRCs;  // one per chunk, each started from CRC_START_VALUE
+} CRC_CHUNK_TASK_ARGS;
+
 // Function Prototypes
 ui4	CRC_calculate(ui1 *block_ptr, si8 block_bytes);
+void	CRC_calculate_chunk_task(void *task_args, si8 task_number, si4 thread_number);
+ui4	CRC_calculate_parallel(ui1 *block_ptr, si8 block_bytes, si4 number_of_threads);
+ui4	CRC_combine(ui4 crc_1, ui4 crc_2, si8 bytes_2);
+void	CRC_gf2_matrix_square(ui4 *square, ui4 *matrix);
+ui4	CRC_gf2_matrix_times(ui4 *matrix, ui4 vector);
 ui4	*CRC_initialize_table(si4 global_flag);
 ui4	CRC_update(ui1 *block_ptr, si8 block_bytes, ui4 current_crc);
 si4	CRC_validate(ui1 *block_ptr, si8 block_bytes, ui4 crc_to_validate);
+si4	CRC_validate_parallel(ui1 *block_ptr, si8 block_bytes, ui4 crc_to_validate, si4 number_of_threads);
 
 
 /************************************************************************************/
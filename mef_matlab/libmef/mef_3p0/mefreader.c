@@ -0,0 +1,323 @@
+
+/************************************************************************************/
+/******************************  MEF 3.0 Reader API  ********************************/
+/************************************************************************************/
+
+//  Copyright (c) Richard J. Cui Created: Sun 10/18/2026 10:12:37.415 AM
+//  $Revision: 0.2 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+//
+//  Rocky Creek Dr NE
+//  Rochester, MN 55906, USA
+//
+//  Email: richard.cui@utoronto.ca
+
+// written with tab width = indent width = 8 spaces and a monospaced font
+
+
+#include "mefreader.h"
+
+
+si4	MEF_READER_api_version(void)
+{
+	return(MEF_READER_API_VERSION);
+}
+
+
+si4	MEF_READER_channel_info(MEF_READER *reader, si4 channel_number, MEF_READER_CHANNEL_INFO *info)
+{
+	CHANNEL				*channel;
+	TIME_SERIES_METADATA_SECTION_2	*tmd2;
+	CONTINUITY_INDEX		*continuity_index;
+
+
+	if (reader == NULL || info == NULL || channel_number < 0 || channel_number >= reader->number_of_channels)
+		return(-1);
+	channel = reader->channels + channel_number;
+	tmd2 = channel->metadata.time_series_section_2;
+
+	memset((void *) info, 0, sizeof(MEF_READER_CHANNEL_INFO));
+	MEF_strncpy(info->name, channel->name, MEF_BASE_FILE_NAME_BYTES);
+	info->sampling_frequency = tmd2->sampling_frequency;
+	info->units_conversion_factor = tmd2->units_conversion_factor;
+	info->number_of_samples = tmd2->number_of_samples;
+	info->start_time = channel->earliest_start_time;
+	info->end_time = channel->latest_end_time;
+	info->number_of_segments = channel->number_of_segments;
+	info->number_of_blocks = tmd2->number_of_blocks;
+	continuity_index = MEF_READER_continuity_index(reader, channel_number);
+	info->number_of_runs = (continuity_index != NULL) ? continuity_index->number_of_entries : 0;
+
+
+	return(0);
+}
+
+
+void	MEF_READER_close(MEF_READER *reader)
+{
+	MEF_CONTEXT	*previous_context;
+	si4		i;
+
+
+	if (reader == NULL)
+		return;
+	previous_context = MEF_set_context(&reader->context);
+
+	// the password data is shared by all segments; the first metadata file frees it
+	if (reader->number_of_channels > 0 && reader->channels[0].number_of_segments > 0)
+		reader->channels[0].segments[0].metadata_fps->directives.free_password_data = MEF_TRUE;
+	if (reader->continuity_indices != NULL) {
+		for (i = 0; i < reader->number_of_channels; ++i)
+			CONTINUITY_free_index(reader->continuity_indices + i, MEF_FALSE);
+		free(reader->continuity_indices);
+	}
+	if (reader->session != NULL)
+		free_session(reader->session, MEF_TRUE);
+	else if (reader->channels != NULL)
+		free_channel(reader->channels, MEF_TRUE);
+	free(reader);
+	(void) MEF_set_context(previous_context);
+
+
+	return;
+}
+
+
+CONTINUITY_INDEX	*MEF_READER_continuity_index(MEF_READER *reader, si4 channel_number)
+{
+	MEF_CONTEXT		*previous_context;
+	CONTINUITY_INDEX	*continuity_index;
+
+
+	// built on first use, kept until the reader is closed
+	if (reader == NULL || channel_number < 0 || channel_number >= reader->number_of_channels)
+		return(NULL);
+	continuity_index = reader->continuity_indices + channel_number;
+	if (continuity_index->entries == NULL) {
+		previous_context = MEF_set_context(&reader->context);
+		(void) CONTINUITY_build_index(reader->channels + channel_number, continuity_index);
+		(void) MEF_set_context(previous_context);
+	}
+
+
+	return(continuity_index);
+}
+
+
+si8	MEF_READER_count_channel_samples(CHANNEL *channel, CONTINUITY_INDEX *continuity_index, si4 range_type, si8 range_start, si8 range_end)
+{
+	READ_PLAN	plan = {0};
+	si8		number_of_samples;
+
+
+	// output samples of a range (the buffer size MEF_READER_decode_channel() needs)
+	if (range_type == MEF_READER_RANGE_BY_SAMPLES)
+		return((range_end > range_start) ? range_end - range_start : 0);
+	if (READ_PLAN_build(channel, continuity_index, range_start, range_end, &plan) == NULL)
+		return(-1);
+	number_of_samples = plan.number_of_samples;
+	READ_PLAN_free(&plan, MEF_FALSE);
+
+
+	return(number_of_samples);
+}
+
+
+si8	MEF_READER_count_samples(MEF_READER *reader, si4 channel_number, si4 range_type, si8 range_start, si8 range_end)
+{
+	MEF_CONTEXT		*previous_context;
+	CONTINUITY_INDEX	*continuity_index;
+	si8			number_of_samples;
+
+
+	if (reader == NULL || channel_number < 0 || channel_number >= reader->number_of_channels)
+		return(-1);
+	continuity_index = MEF_READER_continuity_index(reader, channel_number);
+	previous_context = MEF_set_context(&reader->context);
+	number_of_samples = MEF_READER_count_channel_samples(reader->channels + channel_number, continuity_index, range_type, range_start, range_end);
+	(void) MEF_set_context(previous_context);
+
+
+	return(number_of_samples);
+}
+
+
+si8	MEF_READER_decode(MEF_READER *reader, si4 channel_number, si4 range_type, si8 range_start, si8 range_end, si4 *samples, si8 maximum_samples)
+{
+	MEF_CONTEXT		*previous_context;
+	CONTINUITY_INDEX	*continuity_index;
+	si8			n_failed;
+
+
+	// the decoding threads work in the reader's context too
+	if (reader == NULL || channel_number < 0 || channel_number >= reader->number_of_channels)
+		return(-1);
+	continuity_index = MEF_READER_continuity_index(reader, channel_number);
+	previous_context = MEF_set_context(&reader->context);
+	n_failed = MEF_READER_decode_channel(reader->channels + channel_number, continuity_index, range_type, range_start, range_end, samples, maximum_samples, reader->number_of_threads);
+	(void) MEF_set_context(previous_context);
+
+
+	return(n_failed);
+}
+
+
+si8	MEF_READER_decode_channel(CHANNEL *channel, CONTINUITY_INDEX *continuity_index, si4 range_type, si8 range_start, si8 range_end, si4 *samples, si8 maximum_samples, si4 number_of_threads)
+{
+	READ_PLAN	plan = {0};
+	si8		n_failed;
+
+
+	// decodes a range into samples[0 ... MEF_READER_count_channel_samples() - 1]; fails if maximum_samples is less
+	// (continuity_index may be NULL: built & freed per call)
+	if (channel == NULL || channel->channel_type != TIME_SERIES_CHANNEL_TYPE || channel->number_of_segments == 0)
+		return(-1);
+	if (range_type == MEF_READER_RANGE_BY_TIME)
+		(void) READ_PLAN_build(channel, continuity_index, range_start, range_end, &plan);
+	else
+		(void) READ_PLAN_build_for_samples(channel, range_start, range_end, &plan);
+	if (plan.number_of_samples > maximum_samples || (plan.number_of_samples > 0 && samples == NULL)) {
+		READ_PLAN_free(&plan, MEF_FALSE);
+		return(-1);
+	}
+	n_failed = (plan.number_of_samples > 0) ? READ_PLAN_execute(channel, &plan, samples, number_of_threads) : 0;
+	READ_PLAN_free(&plan, MEF_FALSE);
+
+
+	return(n_failed);
+}
+
+
+si4	MEF_READER_find_channel(MEF_READER *reader, si1 *channel_name)
+{
+	si4	i;
+
+
+	if (reader == NULL || channel_name == NULL)
+		return(-1);
+	for (i = 0; i < reader->number_of_channels; ++i)
+		if (strcmp(reader->channels[i].name, channel_name) == 0)
+			return(i);
+
+
+	return(-1);
+}
+
+
+MEF_READER	*MEF_READER_open(si1 *path, si1 *password, si4 number_of_threads)
+{
+	MEF_READER	*reader;
+	MEF_CONTEXT	*previous_context;
+	si1		full_path[MEF_FULL_FILE_NAME_BYTES];
+	si4		len, encrypted;
+
+
+	// a session directory (.mefd), or a single time series channel directory (.timd)
+	if (path == NULL || *path == 0)
+		return(NULL);
+	if (MEF_globals == NULL)
+		(void) initialize_meflib();
+	if (password != NULL && *password == 0)
+		password = NULL;
+	MEF_strncpy(full_path, path, MEF_FULL_FILE_NAME_BYTES);
+	len = (si4) strlen(full_path);
+	while (len > 1 && (full_path[len - 1] == '/' || full_path[len - 1] == '\\'))
+		full_path[--len] = 0;
+
+	reader = (MEF_READER *) e_calloc((size_t) 1, sizeof(MEF_READER), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	if (reader == NULL)
+		return(NULL);
+	reader->number_of_threads = number_of_threads;
+	MEF_initialize_context(&reader->context, MEF_context);  // settings of the calling thread
+	previous_context = MEF_set_context(&reader->context);
+	if (len > 5 && strcmp(full_path + len - 5, "." TIME_SERIES_CHANNEL_DIRECTORY_TYPE_STRING) == 0) {
+		reader->channels = read_MEF_channel(NULL, full_path, TIME_SERIES_CHANNEL_TYPE, password, NULL, MEF_FALSE, MEF_FALSE);
+		if (reader->channels != NULL && reader->channels->number_of_segments > 0)
+			reader->number_of_channels = 1;
+	} else {
+		reader->session = read_MEF_session(NULL, full_path, password, NULL, MEF_FALSE, MEF_FALSE);
+		if (reader->session != NULL) {
+			reader->channels = reader->session->time_series_channels;
+			reader->number_of_channels = reader->session->number_of_time_series_channels;
+		}
+	}
+
+	// unreadable, empty, or still encrypted (no or wrong password)
+	encrypted = (reader->number_of_channels > 0 && reader->channels[0].metadata.section_1->section_2_encryption > NO_ENCRYPTION);
+	if (reader->number_of_channels == 0 || encrypted) {
+		if (!(MEF_context->behavior_on_fail & SUPPRESS_ERROR_OUTPUT))
+			(void) fprintf(stderr, "%s(): %s \"%s\"\n", __FUNCTION__, (encrypted) ? "no valid password for" : "no time series data in", full_path);
+		(void) MEF_set_context(previous_context);
+		MEF_READER_close(reader);
+		return(NULL);
+	}
+	reader->continuity_indices = (CONTINUITY_INDEX *) e_calloc((size_t) reader->number_of_channels, sizeof(CONTINUITY_INDEX), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	(void) MEF_set_context(previous_context);
+
+
+	return(reader);
+}
+
+
+si8	MEF_READER_query_index(MEF_READER *reader, si4 channel_number, si8 start_time, si8 end_time, CONTINUITY_ENTRY **entries)
+{
+	CONTINUITY_INDEX	*continuity_index;
+	si8			first, last;
+
+
+	// runs of continuous sampling that overlap [start_time, end_time) (UUTC_NO_ENTRY: open ended); *entries points
+	// into the reader's index (valid until the reader is closed)
+	continuity_index = MEF_READER_continuity_index(reader, channel_number);
+	if (continuity_index == NULL || entries == NULL)
+		return(-1);
+	for (first = 0; first < continuity_index->number_of_entries; ++first)
+		if (start_time == UUTC_NO_ENTRY || continuity_index->entries[first].end_time > (sf8) start_time)
+			break;
+	for (last = first; last < continuity_index->number_of_entries; ++last)
+		if (end_time != UUTC_NO_ENTRY && continuity_index->entries[last].start_time >= end_time)
+			break;
+	*entries = continuity_index->entries + first;
+
+
+	return(last - first);
+}
+
+
+si8	MEF_READER_sample_for_time(MEF_READER *reader, si4 channel_number, si8 time)
+{
+	CONTINUITY_INDEX	*continuity_index;
+	sf8			uutc, sample;
+	ui1			sampled;
+
+
+	// zero-based sample at a uUTC time, or -1 if the time is in a gap or outside the recording
+	continuity_index = MEF_READER_continuity_index(reader, channel_number);
+	if (continuity_index == NULL)
+		return(-1);
+	uutc = (sf8) time;
+	CONTINUITY_times_to_samples(continuity_index, &uutc, 1, &sample, &sampled);
+	if (sampled == 0 || isnan(sample))
+		return(-1);
+
+
+	return((si8) sample);
+}
+
+
+si8	MEF_READER_time_for_sample(MEF_READER *reader, si4 channel_number, si8 sample)
+{
+	CONTINUITY_INDEX	*continuity_index;
+	sf8			sample_number, uutc;
+
+
+	// uUTC time of a zero-based sample (extrapolated at the sampling frequency outside the recording)
+	continuity_index = MEF_READER_continuity_index(reader, channel_number);
+	if (continuity_index == NULL)
+		return(UUTC_NO_ENTRY);
+	sample_number = (sf8) sample;
+	CONTINUITY_samples_to_times(continuity_index, &sample_number, 1, &uutc, NULL);
+	if (isnan(uutc))
+		return(UUTC_NO_ENTRY);
+
+
+	return((si8) (uutc + 0.5));
+}
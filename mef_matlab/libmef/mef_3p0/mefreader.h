@@ -0,0 +1,75 @@
+
+#ifndef MEFREADER_IN
+#define MEFREADER_IN
+
+
+/************************************************************************************/
+/*****************************  MEF 3.0 Reader API Header  **************************/
+/************************************************************************************/
+
+//  Copyright (c) Richard J. Cui Created: Sun 10/18/2026 10:12:37.415 AM
+//  $Revision: 0.4 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+//
+//  Rocky Creek Dr NE
+//  Rochester, MN 55906, USA
+//
+//  Email: richard.cui@utoronto.ca
+
+// Entry points of libmef3 for native callers (Matlab gateways, benchmarks, tools & language bindings): open a session
+// (or a single time series channel), query its continuity index, and decode a sample or time range into a buffer
+// owned by the caller, through the read plan & the decoded block cache. Functions return a negative value (or NULL)
+// on failure; decoding returns the number of blocks that could not be decoded (their samples are RED_NAN).
+// Each reader works in its own MEF_CONTEXT (time offsets, CRC, error, allocation & I/O settings, the latter copied
+// from the opening thread's context), so separate readers can be used from separate threads at the same time.
+// MEF_READER_API_VERSION changes only when these prototypes or structures change.
+
+// written with tab width = indent width = 8 spaces and a monospaced font
+
+
+#include "meflib.h"
+
+
+// Constants
+#define MEF_READER_API_VERSION		2
+#define MEF_READER_RANGE_BY_SAMPLES	0	// zero-based channel sample numbers, [start, end)
+#define MEF_READER_RANGE_BY_TIME	1	// uUTC, [start, end); samples not covered by data are RED_NAN
+
+// Typedefs & Structures
+typedef struct {
+	SESSION			*session;  // NULL when a single channel was opened
+	CHANNEL			*channels;  // time series channels
+	si4			number_of_channels;
+	si4			number_of_threads;  // decoding threads (THREAD_NUMBER_OF_THREADS_DEFAULT: one per processor)
+	CONTINUITY_INDEX	*continuity_indices;  // per channel, built on first use
+	MEF_CONTEXT		context;  // bound while the reader's functions run
+} MEF_READER;
+
+typedef struct {
+	si1	name[MEF_BASE_FILE_NAME_BYTES];
+	sf8	sampling_frequency;
+	sf8	units_conversion_factor;
+	si8	number_of_samples;
+	si8	start_time;  // uUTC
+	si8	end_time;  // uUTC
+	si8	number_of_segments;
+	si8	number_of_blocks;
+	si8	number_of_runs;  // continuity index entries (runs of continuous sampling)
+} MEF_READER_CHANNEL_INFO;
+
+// Function Prototypes
+si4			MEF_READER_api_version(void);
+si4			MEF_READER_channel_info(MEF_READER *reader, si4 channel_number, MEF_READER_CHANNEL_INFO *info);
+void			MEF_READER_close(MEF_READER *reader);
+CONTINUITY_INDEX	*MEF_READER_continuity_index(MEF_READER *reader, si4 channel_number);
+si8			MEF_READER_count_channel_samples(CHANNEL *channel, CONTINUITY_INDEX *continuity_index, si4 range_type, si8 range_start, si8 range_end);
+si8			MEF_READER_count_samples(MEF_READER *reader, si4 channel_number, si4 range_type, si8 range_start, si8 range_end);
+si8			MEF_READER_decode(MEF_READER *reader, si4 channel_number, si4 range_type, si8 range_start, si8 range_end, si4 *samples, si8 maximum_samples);
+si8			MEF_READER_decode_channel(CHANNEL *channel, CONTINUITY_INDEX *continuity_index, si4 range_type, si8 range_start, si8 range_end, si4 *samples, si8 maximum_samples, si4 number_of_threads);
+si4			MEF_READER_find_channel(MEF_READER *reader, si1 *channel_name);
+MEF_READER		*MEF_READER_open(si1 *path, si1 *password, si4 number_of_threads);
+si8			MEF_READER_query_index(MEF_READER *reader, si4 channel_number, si8 start_time, si8 end_time, CONTINUITY_ENTRY **entries);
+si8			MEF_READER_sample_for_time(MEF_READER *reader, si4 channel_number, si8 time);
+si8			MEF_READER_time_for_sample(MEF_READER *reader, si4 channel_number, si8 sample);
+
+
+#endif  // MEFREADER_IN
@@ -169,11 +169,11 @@ si1	check_record_structure_alignments(ui1 *bytes)
 	
 	if (return_value == MEF_TRUE) {
 		MEF_globals->all_record_structures_aligned = MEF_TRUE;
-		if (MEF_globals->verbose == MEF_TRUE)
+		if (MEF_context->verbose == MEF_TRUE)
 			(void) printf("%s(): All Record structures are aligned\n", __FUNCTION__);
 	} else {
 		MEF_globals->all_record_structures_aligned = MEF_FALSE;
-		if (MEF_globals->verbose == MEF_TRUE)
+		if (MEF_context->verbose == MEF_TRUE)
 			(void) printf("%s(): One or more Record structures are not aligned\n", __FUNCTION__);
 	}
 	
@@ -264,7 +264,7 @@ si4	check_mefrec_EDFA_type_alignment(ui1 *bytes)
 	if (free_flag == MEF_TRUE)
 		free(bytes);
 	
-	if (MEF_globals->verbose == MEF_TRUE)
+	if (MEF_context->verbose == MEF_TRUE)
 		(void) printf("%s(): MEFREC_EDFA_1_0 structure is aligned\n", __FUNCTION__);
 	
 	return(MEF_TRUE);
@@ -334,7 +334,7 @@ si4	check_mefrec_LNTP_type_alignment(ui1 *bytes)
 	if (free_flag == MEF_TRUE)
 		free(bytes);
 	
-	if (MEF_globals->verbose == MEF_TRUE)
+	if (MEF_context->verbose == MEF_TRUE)
 		(void) printf("%s(): MEFREC_LNTP_1_0 structure is aligned\n", __FUNCTION__);
 	
 	return(MEF_TRUE);
@@ -502,7 +502,7 @@ si4	check_mefrec_Seiz_type_alignment(ui1 *bytes)
 	if (free_flag == MEF_TRUE)
 		free(bytes);
 	
-	if (MEF_globals->verbose == MEF_TRUE)
+	if (MEF_context->verbose == MEF_TRUE)
 		(void) printf("%s(): MEFREC_Seiz_1_0 structure is aligned\n", __FUNCTION__);
 	
         return(MEF_TRUE);
@@ -621,7 +621,7 @@ si4	check_mefrec_CSti_type_alignment(ui1 *bytes)
 	if (free_flag == MEF_TRUE)
 		free(bytes);
 	
-	if (MEF_globals->verbose == MEF_TRUE)
+	if (MEF_context->verbose == MEF_TRUE)
 		(void) printf("%s(): MEFREC_CSti_1_0 structure is aligned\n", __FUNCTION__);
 	
         return(MEF_TRUE);
@@ -756,7 +756,7 @@ si4	check_mefrec_ESti_type_alignment(ui1 *bytes)
 	if (free_flag == MEF_TRUE)
 		free(bytes);
 	
-	if (MEF_globals->verbose == MEF_TRUE)
+	if (MEF_context->verbose == MEF_TRUE)
 		(void) printf("%s(): MEFREC_ESti_1_0 structure is aligned\n", __FUNCTION__);
 	
         return(MEF_TRUE);
@@ -0,0 +1,112 @@
+
+/************************************************************************************/
+/*********************  MEF 3.0 Library Test: sf8 Filter Designs  *******************/
+/************************************************************************************/
+
+//  Copyright (c) Richard J. Cui Created: Sun 10/18/2026 10:12:37.415 AM
+//  $Revision: 0.1 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+//
+//  Rocky Creek Dr NE
+//  Rochester, MN 55906, USA
+//
+//  Email: richard.cui@utoronto.ca
+
+// Sweeps the double precision Butterworth designs (FILT_butter_sf8()) against the sf16 reference (FILT_butter()) with
+// FILT_validate_sf8_design(), over every order, filter type, a range of sampling frequencies & cutoffs (as fractions of
+// the Nyquist frequency) & bandwidths. Every double precision design that FILT_design() keeps must be within
+// FILT_SF8_DESIGN_TOLERANCE: all lowpass & highpass designs, & the bandpass & bandstop designs that pass the cutoff
+// gain check (the others fall back to the sf16 design). Each failed configuration is reported; the exit status is the
+// number of failed configurations (0: all within tolerance).
+//
+// build & run with the libmef CMake project (target test_filt_sf8_design, run by ctest), or from this directory:
+//   cc -O2 -I../mef_3p0 -o test_filt_sf8_design test_filt_sf8_design.c ../mef_3p0/meflib.c ../mef_3p0/mefrec.c -lm -lpthread
+
+// written with tab width = indent width = 8 spaces and a monospaced font
+
+
+#include "meflib.h"
+
+
+#define TEST_SAMPLING_FREQUENCIES	{ 250.0, 1000.0, 5000.0, 32556.0 }
+#define TEST_CUTOFF_FRACTIONS		{ 0.001, 0.01, 0.05, 0.1, 0.25, 0.4, 0.45 }  // of the Nyquist frequency
+#define TEST_BANDWIDTH_RATIOS		{ 1.2, 2.0, 4.0 }  // upper / lower cutoff (bandpass & bandstop)
+#define TEST_MAXIMUM_CUTOFF_FRACTION	0.95  // of the Nyquist frequency
+
+
+// Prototypes
+si4	TEST_sf8_design_kept(si4 order, si4 type, sf8 samp_freq, sf8 cutoff_1, sf8 cutoff_2);
+
+
+si4	TEST_sf8_design_kept(si4 order, si4 type, sf8 samp_freq, sf8 cutoff_1, sf8 cutoff_2)
+{
+	FILT_PROCESSING_STRUCT	filtps;
+	si4			kept;
+
+
+	// returns MEF_TRUE if FILT_design() keeps the double precision design of this configuration
+	if ((type == FILT_LOWPASS_TYPE) || (type == FILT_HIGHPASS_TYPE))
+		return(MEF_TRUE);
+	memset((void *) &filtps, 0, sizeof(FILT_PROCESSING_STRUCT));
+	filtps.order = order;
+	filtps.type = type;
+	filtps.sampling_frequency = samp_freq;
+	filtps.cutoffs[0] = cutoff_1;
+	filtps.cutoffs[1] = cutoff_2;
+	kept = MEF_FALSE;
+	if (FILT_butter_sf8(&filtps) == 0)
+		kept = FILT_check_cutoff_gain(&filtps, FILT_SF8_CUTOFF_GAIN_TOLERANCE);
+	if (filtps.numerators != NULL) {
+		free(filtps.numerators);
+		free(filtps.denominators);
+	}
+
+
+	return(kept);
+}
+
+
+si4	main(si4 argc, si1 **argv)
+{
+	static const sf8	sampling_frequencies[] = TEST_SAMPLING_FREQUENCIES;
+	static const sf8	cutoff_fractions[] = TEST_CUTOFF_FRACTIONS;
+	static const sf8	bandwidth_ratios[] = TEST_BANDWIDTH_RATIOS;
+	static const si1	*type_names[] = { "", "lowpass", "bandpass", "highpass", "bandstop" };
+	si4			type, order, i, j, k, n_ratios, n_tested, n_kept, n_failed;
+	sf8			nyquist, cutoff_1, cutoff_2, difference, max_difference;
+
+
+	(void) initialize_meflib();
+
+	n_tested = n_kept = n_failed = 0;
+	max_difference = 0.0;
+	for (type = FILT_LOWPASS_TYPE; type <= FILT_BANDSTOP_TYPE; ++type) {
+		n_ratios = ((type == FILT_LOWPASS_TYPE) || (type == FILT_HIGHPASS_TYPE)) ? 1 : (si4) (sizeof(bandwidth_ratios) / sizeof(sf8));
+		for (order = 1; order <= FILT_MAX_ORDER; ++order) {
+			for (i = 0; i < (si4) (sizeof(sampling_frequencies) / sizeof(sf8)); ++i) {
+				nyquist = sampling_frequencies[i] / 2.0;
+				for (j = 0; j < (si4) (sizeof(cutoff_fractions) / sizeof(sf8)); ++j) {
+					for (k = 0; k < n_ratios; ++k) {
+						cutoff_1 = cutoff_fractions[j] * nyquist;
+						cutoff_2 = (n_ratios == 1) ? 0.0 : cutoff_1 * bandwidth_ratios[k];
+						if (cutoff_2 > TEST_MAXIMUM_CUTOFF_FRACTION * nyquist)
+							continue;
+						++n_tested;
+						if (TEST_sf8_design_kept(order, type, sampling_frequencies[i], cutoff_1, cutoff_2) != MEF_TRUE)
+							continue;
+						++n_kept;
+						if (FILT_validate_sf8_design(order, type, sampling_frequencies[i], cutoff_1, cutoff_2, &difference) != MEF_TRUE) {
+							fprintf(stderr, "FAILED: %s order %d, sampling frequency %0.1lf Hz, cutoffs %0.4lf & %0.4lf Hz: relative difference %0.3le (tolerance %0.1le)\n", type_names[type], order, sampling_frequencies[i], cutoff_1, cutoff_2, difference, FILT_SF8_DESIGN_TOLERANCE);
+							++n_failed;
+						}
+						if (difference > max_difference)
+							max_difference = difference;
+					}
+				}
+			}
+		}
+	}
+	printf("%d filter configurations tested, %d sf8 designs kept, %d outside tolerance (maximum relative difference %0.3le)\n", n_tested, n_kept, n_failed, max_difference);
+
+
+	return(n_failed);
+}
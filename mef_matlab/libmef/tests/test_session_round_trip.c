@@ -0,0 +1,251 @@
+
+/************************************************************************************/
+/*******************  MEF 3.0 Library Test: Session Write & Read  *******************/
+/************************************************************************************/
+
+//  Copyright (c) Richard J. Cui Created: Sun 10/18/2026 10:12:37.415 AM
+//  $Revision: 0.1 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+//
+//  Rocky Creek Dr NE
+//  Rochester, MN 55906, USA
+//
+//  Email: richard.cui@utoronto.ca
+
+// Writes a small session & reads it back with read_MEF_session(). The channel has two segments: the first written
+// by write_MEF_time_series_segment(), the second appended through a stream (STREAM_open(), STREAM_append() in
+// chunks that do not line up with the blocks, STREAM_close()) with a time gap in the middle, so the channel has two
+// contiguous runs. The segment metadata, the time series indices (start samples & times, block sizes, discontinuity
+// flags), the continuity index & the decoded samples are checked against what was written. Each mismatch is
+// reported; the exit status is the number of mismatches (0: the session reads back as written).
+//
+// build & run with the libmef CMake project (target test_session_round_trip, run by ctest), or from this directory:
+//   cc -O2 -I../mef_3p0 -o test_session_round_trip test_session_round_trip.c ../mef_3p0/meflib.c ../mef_3p0/mefrec.c -lm -lpthread
+//   ./test_session_round_trip [directory]  (the session is written in the directory, default: the current one)
+
+// written with tab width = indent width = 8 spaces and a monospaced font
+
+
+#include "meflib.h"
+
+
+#define TEST_SESSION_NAME		"round_trip"
+#define TEST_CHANNEL_NAME		"ch1"
+#define TEST_SAMPLING_FREQUENCY		1000.0
+#define TEST_BLOCK_SAMPLES		1000
+#define TEST_START_TIME			946684800000000  // uUTC (01/01/2000 00:00:00)
+#define TEST_SEGMENT_0_SAMPLES		2500  // write_MEF_time_series_segment()
+#define TEST_RUN_1_SAMPLES		1500  // streamed, contiguous with segment 0
+#define TEST_RUN_2_SAMPLES		1200  // streamed, after the gap
+#define TEST_GAP			5000000  // microseconds
+#define TEST_STREAM_CHUNK_SAMPLES	700
+#define TEST_NUMBER_OF_SAMPLES		(TEST_SEGMENT_0_SAMPLES + TEST_RUN_1_SAMPLES + TEST_RUN_2_SAMPLES)
+
+
+// Prototypes
+si4	TEST_check(si4 passed, si1 *description);
+void	TEST_signal(si4 *samples, si8 number_of_samples);
+si8	TEST_sample_time(si8 sample);
+si4	TEST_write_session(si1 *channel_path, si4 *samples);
+
+
+si4	TEST_check(si4 passed, si1 *description)
+{
+	// returns the number of mismatches (0 or 1)
+	if (passed)
+		return(0);
+	fprintf(stderr, "mismatch: %s\n", description);
+
+
+	return(1);
+}
+
+
+void	TEST_signal(si4 *samples, si8 number_of_samples)
+{
+	si8	i;
+
+
+	// a sinusoid with a small sawtooth, so that neighbouring blocks differ
+	for (i = 0; i < number_of_samples; ++i)
+		samples[i] = (si4) (1000.0 * sin((2.0 * M_PI * 7.0 * (sf8) i) / TEST_SAMPLING_FREQUENCY)) + (si4) (i % 13) - 6;
+
+
+	return;
+}
+
+
+si8	TEST_sample_time(si8 sample)
+{
+	si8	time;
+
+
+	// time of a channel sample as written: samples after the second run start are shifted by the gap
+	time = TEST_START_TIME;
+	if (sample >= TEST_SEGMENT_0_SAMPLES + TEST_RUN_1_SAMPLES)
+		time += TEST_GAP;
+
+
+	return(time + (si8) ((((sf8) sample * 1e6) / TEST_SAMPLING_FREQUENCY) + 0.5));
+}
+
+
+si4	TEST_write_session(si1 *channel_path, si4 *samples)
+{
+	FILE_PROCESSING_STRUCT	*proto_fps;
+	RED_PROCESSING_STRUCT	*proto_rps;
+	TIME_SERIES_STREAM	*stream;
+	si4			ret_val;
+	si8			sample, end, n;
+
+
+	proto_fps = allocate_file_processing_struct(METADATA_FILE_BYTES, TIME_SERIES_METADATA_FILE_TYPE_CODE, NULL, NULL, 0);
+	MEF_strncpy(proto_fps->universal_header->session_name, TEST_SESSION_NAME, MEF_BASE_FILE_NAME_BYTES);
+	MEF_strncpy(proto_fps->universal_header->channel_name, TEST_CHANNEL_NAME, MEF_BASE_FILE_NAME_BYTES);
+	proto_fps->metadata.time_series_section_2->sampling_frequency = TEST_SAMPLING_FREQUENCY;
+	proto_fps->metadata.time_series_section_2->units_conversion_factor = 1.0;
+	proto_fps->metadata.time_series_section_2->maximum_block_samples = TEST_BLOCK_SAMPLES;
+	proto_rps = RED_allocate_processing_struct(0, 0, 0, 0, 0, 0, NULL);
+
+	// segment 0: written whole
+	ret_val = write_MEF_time_series_segment(channel_path, proto_fps, 0, samples, TEST_SEGMENT_0_SAMPLES, 0, TEST_sample_time(0), proto_rps, 2);
+
+	// segment 1: streamed in chunks, the second run after a gap
+	if (ret_val == 0) {
+		sample = TEST_SEGMENT_0_SAMPLES;
+		stream = STREAM_open(channel_path, proto_fps, proto_rps, 1, sample, TEST_sample_time(sample), STREAM_SYNC_NONE, 0);
+		if (stream == NULL)
+			ret_val = -1;
+		for (; ret_val == 0 && sample < TEST_NUMBER_OF_SAMPLES; sample += n) {
+			end = (sample < TEST_SEGMENT_0_SAMPLES + TEST_RUN_1_SAMPLES) ? TEST_SEGMENT_0_SAMPLES + TEST_RUN_1_SAMPLES : TEST_NUMBER_OF_SAMPLES;
+			n = end - sample;
+			if (n > TEST_STREAM_CHUNK_SAMPLES)
+				n = TEST_STREAM_CHUNK_SAMPLES;
+			ret_val = STREAM_append(stream, samples + sample, n, TEST_sample_time(sample));
+		}
+		if (stream != NULL && STREAM_close(stream) < 0)
+			ret_val = -1;
+	}
+
+	RED_free_processing_struct(proto_rps);
+	free_file_processing_struct(proto_fps);
+
+
+	return(ret_val);
+}
+
+
+int	main(int argc, char **argv)
+{
+	SESSION				*session;
+	CHANNEL				*channel;
+	SEGMENT				*segment;
+	TIME_SERIES_METADATA_SECTION_2	*tmd2;
+	TIME_SERIES_INDEX		*tsi;
+	CONTINUITY_INDEX		*continuity_index;
+	READ_PLAN			*plan;
+	si1				session_path[MEF_FULL_FILE_NAME_BYTES], channel_path[MEF_FULL_FILE_NAME_BYTES], command[MEF_FULL_FILE_NAME_BYTES + 16];
+	si1				description[256];
+	si4				*samples, *decoded, n_mismatches, seg, flagged;
+	si8				segment_samples[2] = { TEST_SEGMENT_0_SAMPLES, TEST_RUN_1_SAMPLES + TEST_RUN_2_SAMPLES };
+	si8				segment_start_samples[2] = { 0, TEST_SEGMENT_0_SAMPLES };
+	si8				sample, channel_sample, run_end_sample, block_samples, i;
+
+
+	(void) initialize_meflib();
+	MEF_context->behavior_on_fail = RETURN_ON_FAIL;
+	MEF_snprintf(session_path, MEF_FULL_FILE_NAME_BYTES, "%s/%s.%s", (argc > 1) ? argv[1] : ".", TEST_SESSION_NAME, SESSION_DIRECTORY_TYPE_STRING);
+	MEF_snprintf(channel_path, MEF_FULL_FILE_NAME_BYTES, "%s/%s.%s", session_path, TEST_CHANNEL_NAME, TIME_SERIES_CHANNEL_DIRECTORY_TYPE_STRING);
+#if defined(_WIN32) || defined(_WIN64)
+	MEF_snprintf(command, MEF_FULL_FILE_NAME_BYTES + 16, "if exist \"%s\" rmdir /s /q \"%s\"", session_path, session_path);
+#else
+	MEF_snprintf(command, MEF_FULL_FILE_NAME_BYTES + 16, "rm -rf \"%s\"", session_path);
+#endif
+	(void) system(command);  // a session left by an earlier run
+
+	// write
+	samples = (si4 *) e_malloc((size_t) TEST_NUMBER_OF_SAMPLES * sizeof(si4), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	decoded = (si4 *) e_calloc((size_t) TEST_NUMBER_OF_SAMPLES, sizeof(si4), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+	TEST_signal(samples, TEST_NUMBER_OF_SAMPLES);
+	if (TEST_write_session(channel_path, samples) < 0) {
+		fprintf(stderr, "%s: failed to write %s\n", argv[0], session_path);
+		return(1);
+	}
+
+	// read
+	session = read_MEF_session(NULL, session_path, NULL, NULL, MEF_FALSE, MEF_FALSE);
+	if (session == NULL || session->number_of_time_series_channels != 1) {
+		fprintf(stderr, "%s: failed to read %s\n", argv[0], session_path);
+		return(1);
+	}
+	channel = session->time_series_channels;
+	n_mismatches = 0;
+
+	// metadata
+	tmd2 = channel->metadata.time_series_section_2;
+	n_mismatches += TEST_check(channel->number_of_segments == 2, "number of segments");
+	n_mismatches += TEST_check(strcmp(channel->name, TEST_CHANNEL_NAME) == 0, "channel name");
+	n_mismatches += TEST_check(tmd2->sampling_frequency == TEST_SAMPLING_FREQUENCY, "channel sampling frequency");
+	n_mismatches += TEST_check(tmd2->number_of_samples == TEST_NUMBER_OF_SAMPLES, "channel number of samples");
+	n_mismatches += TEST_check(channel->earliest_start_time == TEST_sample_time(0), "channel start time");
+	n_mismatches += TEST_check(channel->latest_end_time == TEST_sample_time(TEST_NUMBER_OF_SAMPLES), "channel end time");
+	for (seg = 0; seg < channel->number_of_segments && seg < 2; ++seg) {
+		segment = channel->segments + seg;
+		tmd2 = segment->metadata_fps->metadata.time_series_section_2;
+		MEF_snprintf(description, 256, "segment %d metadata", seg);
+		n_mismatches += TEST_check(tmd2->start_sample == segment_start_samples[seg] && tmd2->number_of_samples == segment_samples[seg], description);
+		n_mismatches += TEST_check(tmd2->number_of_blocks == segment->time_series_indices_fps->universal_header->number_of_entries, description);
+		n_mismatches += TEST_check(tmd2->number_of_discontinuities == seg + 1, description);  // the segment start (& the gap)
+		n_mismatches += TEST_check(segment->metadata_fps->universal_header->start_time == TEST_sample_time(segment_start_samples[seg]), description);
+		n_mismatches += TEST_check(segment->metadata_fps->universal_header->end_time == TEST_sample_time(segment_start_samples[seg] + segment_samples[seg]), description);
+
+		// indices: blocks of TEST_BLOCK_SAMPLES, cut short before the gap & at the segment end; flagged at the segment
+		// start & after the gap
+		MEF_snprintf(description, 256, "segment %d time series indices", seg);
+		tsi = segment->time_series_indices_fps->time_series_indices;
+		for (sample = 0, i = 0; i < tmd2->number_of_blocks; sample += tsi[i++].number_of_samples) {
+			channel_sample = segment_start_samples[seg] + sample;
+			run_end_sample = (channel_sample < TEST_SEGMENT_0_SAMPLES + TEST_RUN_1_SAMPLES && seg == 1) ? TEST_SEGMENT_0_SAMPLES + TEST_RUN_1_SAMPLES : segment_start_samples[seg] + segment_samples[seg];
+			n_mismatches += TEST_check(tsi[i].start_sample == sample, description);
+			n_mismatches += TEST_check(tsi[i].start_time == TEST_sample_time(channel_sample), description);
+			block_samples = run_end_sample - channel_sample;
+			if (block_samples > TEST_BLOCK_SAMPLES)
+				block_samples = TEST_BLOCK_SAMPLES;
+			n_mismatches += TEST_check((si8) tsi[i].number_of_samples == block_samples, description);
+			flagged = (tsi[i].RED_block_flags & RED_DISCONTINUITY_MASK) ? MEF_TRUE : MEF_FALSE;
+			n_mismatches += TEST_check(flagged == ((i == 0 || channel_sample == TEST_SEGMENT_0_SAMPLES + TEST_RUN_1_SAMPLES) ? MEF_TRUE : MEF_FALSE), description);
+		}
+		n_mismatches += TEST_check(sample == segment_samples[seg], description);
+	}
+
+	// continuity: one run across the segment boundary, one after the gap
+	continuity_index = CONTINUITY_build_index(channel, NULL);
+	if (continuity_index == NULL || continuity_index->number_of_entries != 2) {
+		n_mismatches += TEST_check(0, "number of continuity entries");
+	} else {
+		n_mismatches += TEST_check(continuity_index->entries[0].start_sample == 0 && continuity_index->entries[0].number_of_samples == TEST_SEGMENT_0_SAMPLES + TEST_RUN_1_SAMPLES, "continuity entry 0");
+		n_mismatches += TEST_check(continuity_index->entries[0].start_time == TEST_sample_time(0), "continuity entry 0");
+		n_mismatches += TEST_check(continuity_index->entries[1].start_sample == TEST_SEGMENT_0_SAMPLES + TEST_RUN_1_SAMPLES && continuity_index->entries[1].number_of_samples == TEST_RUN_2_SAMPLES, "continuity entry 1");
+		n_mismatches += TEST_check(continuity_index->entries[1].start_time == TEST_sample_time(TEST_SEGMENT_0_SAMPLES + TEST_RUN_1_SAMPLES), "continuity entry 1");
+	}
+	if (continuity_index != NULL)
+		CONTINUITY_free_index(continuity_index, MEF_TRUE);
+
+	// samples
+	plan = READ_PLAN_build_for_samples(channel, 0, TEST_NUMBER_OF_SAMPLES, NULL);
+	n_mismatches += TEST_check(plan->number_of_gaps == 0, "read plan gaps");
+	n_mismatches += TEST_check(READ_PLAN_execute(channel, plan, decoded, 2) == 0, "failed blocks");
+	for (i = 0; i < TEST_NUMBER_OF_SAMPLES; ++i)
+		if (decoded[i] != samples[i])
+			break;
+	MEF_snprintf(description, 256, "sample %ld", (long) i);
+	n_mismatches += TEST_check(i == TEST_NUMBER_OF_SAMPLES, description);
+	READ_PLAN_free(plan, MEF_TRUE);
+
+	free_session(session, MEF_TRUE);
+	free(samples);
+	free(decoded);
+	printf("%s: %d mismatches\n", session_path, n_mismatches);
+
+
+	return(n_mismatches);
+}
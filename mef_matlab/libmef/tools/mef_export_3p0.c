@@ -0,0 +1,712 @@
+
+/************************************************************************************/
+/*****************************  MEF 3.0 Session Export  *****************************/
+/************************************************************************************/
+
+//  Copyright (c) Richard J. Cui Created: Sun 10/18/2026 10:12:37.415 AM
+//  $Revision: 0.1 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+//
+//  Rocky Creek Dr NE
+//  Rochester, MN 55906, USA
+//
+//  Email: richard.cui@utoronto.ca
+
+// Standalone export of the time series channels of a MEF 3.0 session (or of one channel) to a single float32 array,
+// channels x samples (channel-major: all the samples of the first channel, then of the second...), for pipelines
+// that read flat binary: a raw file, an NPY file (data at a page aligned offset), or an HDF5 dataset chunked by row
+// (when built with HDF5). A JSON file next to it (<output>.json) describes the array, the channels & their gaps.
+//
+// The channels are decoded in parallel, each a chunk at a time (the chunks are aligned in the rows), so the memory
+// used depends on the chunk size & the number of threads, not on the length of the recording. Discontinuities are
+// NaN filled (--gaps nan: samples placed by time, as decompress_mef_3p0 reads time ranges) or removed (--gaps table:
+// the channel samples back to back, the JSON listing where each gap falls). Rows of channels with fewer samples are
+// NaN padded.
+//
+// build with the libmef CMake project (target mef_export_3p0), or from this directory:
+//   cc -O2 -I../mef_3p0 -o mef_export_3p0 mef_export_3p0.c ../mef_3p0/meflib.c ../mef_3p0/mefrec.c ../mef_3p0/mefreader.c -lm -lpthread
+// (add -DMEF_EXPORT_HDF5 & the HDF5 include & library flags for HDF5 output)
+
+// written with tab width = indent width = 8 spaces and a monospaced font
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "mefreader.h"
+#ifdef MEF_EXPORT_HDF5
+	#include "hdf5.h"
+#endif
+
+#ifdef _WIN32
+	#define EXPORT_fseek(fp, offset)	_fseeki64((fp), (__int64) (offset), SEEK_SET)
+#else
+	#define EXPORT_fseek(fp, offset)	fseeko((fp), (off_t) (offset), SEEK_SET)
+#endif
+
+
+// Constants
+#define EXPORT_FORMAT_RAW		0
+#define EXPORT_FORMAT_NPY		1
+#define EXPORT_FORMAT_HDF5		2
+#define EXPORT_GAPS_NAN			0	// discontinuities NaN filled (samples placed by time)
+#define EXPORT_GAPS_TABLE		1	// discontinuities removed & listed
+#define EXPORT_PATH_BYTES		1024
+#define EXPORT_CHUNK_SAMPLES_DEFAULT	((si8) 1 << 20)	// samples per channel decoded & written at a time
+#define EXPORT_NPY_DATA_OFFSET		4096	// bytes: the NPY header is padded to a page
+#define EXPORT_HDF5_DATASET		"data"
+
+
+// Typedefs & Structures
+typedef struct {
+	si1	input_path[EXPORT_PATH_BYTES];
+	si1	output_path[EXPORT_PATH_BYTES];
+	si1	*password;
+	si1	*channel_names;  // comma separated, NULL for all
+	si4	format;
+	si4	gaps_mode;
+	si4	scale;  // MEF_TRUE: values multiplied by the units conversion factor
+	si4	number_of_threads;
+	si8	chunk_samples;
+	si8	start_time;  // uUTC, UUTC_NO_ENTRY: start of the session
+	si8	end_time;  // uUTC (exclusive), UUTC_NO_ENTRY: end of the session
+} EXPORT_OPTIONS;
+
+typedef struct {
+	si8	output_sample;  // nan: first NaN sample; table: first sample after the gap
+	si8	number_of_samples;  // nan: NaN samples; table: 0
+	si8	start_time;  // uUTC
+	si8	end_time;  // uUTC
+} EXPORT_GAP;
+
+typedef struct {
+	si4		channel_number;  // in the reader
+	si8		first_sample;  // table: channel sample written first
+	si8		number_of_samples;  // written from the channel (the rest of the row is NaN)
+	si8		failed_blocks;  // could not be decoded (NaN)
+	si8		number_of_gaps;
+	EXPORT_GAP	*gaps;
+	si4		status;  // 0, or -1 if the channel could not be read or written
+} EXPORT_CHANNEL;
+
+typedef struct {
+	EXPORT_OPTIONS	*options;
+	MEF_READER	*reader;
+	EXPORT_CHANNEL	*channels;
+	si8		row_samples;  // output samples per channel
+	si8		data_offset;  // bytes (raw & NPY)
+	si4		decode_threads;  // per channel
+	si4		**samples;  // per thread, chunk_samples
+	sf4		**values;  // per thread, chunk_samples
+	THREAD_MUTEX	mutex;  // HDF5 calls
+	#ifdef MEF_EXPORT_HDF5
+		hid_t	dataset;
+	#endif
+} EXPORT_TASK_ARGS;
+
+
+// Prototypes
+void	EXPORT_channel_task(void *task_args, si8 task_number, si4 thread_number);
+void	EXPORT_gap_table(EXPORT_CHANNEL *export_channel, READ_PLAN *plan, CONTINUITY_INDEX *continuity_index, si8 start_time, si4 gaps_mode);
+void	EXPORT_json_string(FILE *fp, si1 *string);
+si4	EXPORT_parse_options(EXPORT_OPTIONS *options, si4 argc, si1 **argv);
+si8	EXPORT_sample_at_or_after(CONTINUITY_INDEX *continuity_index, si8 time);
+void	EXPORT_usage(si1 *program);
+si4	EXPORT_write_json(EXPORT_TASK_ARGS *args, si1 *json_path, si8 start_time, si8 end_time);
+si4	EXPORT_write_npy_header(FILE *fp, si8 number_of_channels, si8 row_samples);
+
+
+void	EXPORT_channel_task(void *task_args, si8 task_number, si4 thread_number)
+{
+	EXPORT_TASK_ARGS	*args;
+	EXPORT_OPTIONS		*options;
+	EXPORT_CHANNEL		*export_channel;
+	CHANNEL			*channel;
+	CONTINUITY_INDEX	*continuity_index;
+	READ_PLAN		plan = {0}, slice = {0};
+	FILE			*fp;
+	si4			*samples;
+	sf4			*values;
+	sf8			scale;
+	si8			start, n, n_decoded, n_failed, i;
+	#ifdef MEF_EXPORT_HDF5
+		hid_t		file_space, memory_space;
+		hsize_t		offset[2], count[2];
+		herr_t		status;
+	#endif
+
+
+	// one row: the whole channel is planned (blocks only), then decoded & written a chunk at a time
+	args = (EXPORT_TASK_ARGS *) task_args;
+	options = args->options;
+	export_channel = args->channels + task_number;
+	channel = args->reader->channels + export_channel->channel_number;
+	samples = args->samples[thread_number];
+	values = args->values[thread_number];
+	scale = (options->scale == MEF_TRUE) ? channel->metadata.time_series_section_2->units_conversion_factor : 1.0;
+	export_channel->status = -1;
+
+	continuity_index = MEF_READER_continuity_index(args->reader, export_channel->channel_number);
+	if (continuity_index == NULL)
+		return;
+	if (options->gaps_mode == EXPORT_GAPS_NAN)
+		(void) READ_PLAN_build(channel, continuity_index, options->start_time, options->end_time, &plan);
+	else
+		(void) READ_PLAN_build_for_samples(channel, export_channel->first_sample, export_channel->first_sample + export_channel->number_of_samples, &plan);
+	EXPORT_gap_table(export_channel, &plan, continuity_index, options->start_time, options->gaps_mode);
+
+	fp = NULL;
+	if (options->format != EXPORT_FORMAT_HDF5) {
+		fp = fopen(options->output_path, "r+b");
+		if (fp == NULL || EXPORT_fseek(fp, args->data_offset + (task_number * args->row_samples * (si8) sizeof(sf4)))) {
+			if (fp != NULL)
+				fclose(fp);
+			READ_PLAN_free(&plan, MEF_FALSE);
+			return;
+		}
+	}
+
+	for (start = 0; start < args->row_samples; start += n) {
+		n = args->row_samples - start;
+		if (n > options->chunk_samples)
+			n = options->chunk_samples;
+
+		// decode
+		n_decoded = plan.number_of_samples - start;
+		if (n_decoded > n)
+			n_decoded = n;
+		if (n_decoded > 0) {
+			(void) READ_PLAN_slice(&plan, start, start + n_decoded, &slice);
+			n_failed = READ_PLAN_execute(channel, &slice, samples, args->decode_threads);
+			if (n_failed < 0)
+				break;
+			export_channel->failed_blocks += n_failed;
+		} else {
+			n_decoded = 0;
+		}
+		for (i = 0; i < n_decoded; ++i)
+			values[i] = (samples[i] == RED_NAN) ? (sf4) NAN : (sf4) ((sf8) samples[i] * scale);
+		for (; i < n; ++i)
+			values[i] = (sf4) NAN;
+
+		// write
+		if (fp != NULL) {
+			if (fwrite((void *) values, sizeof(sf4), (size_t) n, fp) != (size_t) n)
+				break;
+		}
+		#ifdef MEF_EXPORT_HDF5
+		else {
+			THREAD_mutex_lock(&args->mutex);  // the HDF5 library is not thread safe
+			offset[0] = (hsize_t) task_number;
+			offset[1] = (hsize_t) start;
+			count[0] = 1;
+			count[1] = (hsize_t) n;
+			file_space = H5Dget_space(args->dataset);
+			memory_space = H5Screate_simple(1, count + 1, NULL);
+			status = H5Sselect_hyperslab(file_space, H5S_SELECT_SET, offset, NULL, count, NULL);
+			if (status >= 0)
+				status = H5Dwrite(args->dataset, H5T_NATIVE_FLOAT, memory_space, file_space, H5P_DEFAULT, (void *) values);
+			H5Sclose(memory_space);
+			H5Sclose(file_space);
+			THREAD_mutex_unlock(&args->mutex);
+			if (status < 0)
+				break;
+		}
+		#endif
+	}
+	if (start >= args->row_samples)
+		export_channel->status = 0;
+
+	if (fp != NULL && fclose(fp))
+		export_channel->status = -1;
+	READ_PLAN_free(&slice, MEF_FALSE);
+	READ_PLAN_free(&plan, MEF_FALSE);
+
+
+	return;
+}
+
+
+void	EXPORT_gap_table(EXPORT_CHANNEL *export_channel, READ_PLAN *plan, CONTINUITY_INDEX *continuity_index, si8 start_time, si4 gaps_mode)
+{
+	CONTINUITY_ENTRY	*entry;
+	EXPORT_GAP		*gap;
+	si8			i, last_sample;
+	sf8			sampling_frequency;
+
+
+	sampling_frequency = continuity_index->sampling_frequency;
+	if (gaps_mode == EXPORT_GAPS_NAN) {
+		// the NaN filled stretches of the row (before, between & after the runs of data)
+		export_channel->gaps = (EXPORT_GAP *) calloc((size_t) plan->number_of_gaps + 1, sizeof(EXPORT_GAP));
+		for (i = 0; i < plan->number_of_gaps; ++i) {
+			gap = export_channel->gaps + i;
+			gap->output_sample = plan->gaps[i].output_offset;
+			gap->number_of_samples = plan->gaps[i].number_of_samples;
+			gap->start_time = start_time + (si8) ((((sf8) gap->output_sample * 1e6) / sampling_frequency) + 0.5);
+			gap->end_time = start_time + (si8) ((((sf8) (gap->output_sample + gap->number_of_samples) * 1e6) / sampling_frequency) + 0.5);
+		}
+		export_channel->number_of_gaps = plan->number_of_gaps;
+		return;
+	}
+
+	// the discontinuities between the runs written (where the next run starts in the row)
+	export_channel->gaps = (EXPORT_GAP *) calloc((size_t) continuity_index->number_of_entries + 1, sizeof(EXPORT_GAP));
+	export_channel->number_of_gaps = 0;
+	last_sample = export_channel->first_sample + export_channel->number_of_samples;
+	for (i = 1; i < continuity_index->number_of_entries; ++i) {
+		entry = continuity_index->entries + i;
+		if (entry->start_sample <= export_channel->first_sample)
+			continue;
+		if (entry->start_sample >= last_sample)
+			break;
+		gap = export_channel->gaps + export_channel->number_of_gaps++;
+		gap->output_sample = entry->start_sample - export_channel->first_sample;
+		gap->number_of_samples = 0;
+		gap->start_time = (si8) ceil(entry[-1].end_time);
+		gap->end_time = entry->start_time;
+	}
+
+
+	return;
+}
+
+
+void	EXPORT_json_string(FILE *fp, si1 *string)
+{
+	ui1	c;
+
+
+	fputc('"', fp);
+	for (; *string; ++string) {
+		c = (ui1) *string;
+		if (c == '"' || c == '\\')
+			fprintf(fp, "\\%c", c);
+		else if (c < 0x20)
+			fprintf(fp, "\\u%04x", c);
+		else
+			fputc(c, fp);
+	}
+	fputc('"', fp);
+
+
+	return;
+}
+
+
+si4	EXPORT_parse_options(EXPORT_OPTIONS *options, si4 argc, si1 **argv)
+{
+	si4	i, n_paths, len;
+	si1	*name, *value;
+
+
+	// returns 0 to run, 1 if usage was asked for, -1 on error (usage printed to stderr)
+	memset((void *) options, 0, sizeof(EXPORT_OPTIONS));
+	options->format = -1;  // from the output file extension
+	options->gaps_mode = EXPORT_GAPS_NAN;
+	options->number_of_threads = THREAD_NUMBER_OF_THREADS_DEFAULT;
+	options->chunk_samples = EXPORT_CHUNK_SAMPLES_DEFAULT;
+	options->start_time = options->end_time = UUTC_NO_ENTRY;
+
+	n_paths = 0;
+	for (i = 1; i < argc; ++i) {
+		name = argv[i];
+		if (!strcmp(name, "-h") || !strcmp(name, "--help")) {
+			EXPORT_usage(argv[0]);
+			return(1);
+		}
+		if (!strcmp(name, "--scale")) {
+			options->scale = MEF_TRUE;
+			continue;
+		}
+		if (strncmp(name, "--", 2)) {
+			if (n_paths == 0)
+				strncpy(options->input_path, name, EXPORT_PATH_BYTES - 1);
+			else if (n_paths == 1)
+				strncpy(options->output_path, name, EXPORT_PATH_BYTES - 1);
+			if (++n_paths > 2)
+				break;
+			continue;
+		}
+		if (i + 1 >= argc) {
+			fprintf(stderr, "%s: %s needs a value\n\n", argv[0], name);
+			EXPORT_usage(argv[0]);
+			return(-1);
+		}
+		value = argv[++i];
+		if (!strcmp(name, "--format")) {
+			if (!strcmp(value, "raw"))
+				options->format = EXPORT_FORMAT_RAW;
+			else if (!strcmp(value, "npy"))
+				options->format = EXPORT_FORMAT_NPY;
+			else if (!strcmp(value, "hdf5"))
+				options->format = EXPORT_FORMAT_HDF5;
+			else
+				break;
+		} else if (!strcmp(name, "--gaps")) {
+			if (!strcmp(value, "nan"))
+				options->gaps_mode = EXPORT_GAPS_NAN;
+			else if (!strcmp(value, "table"))
+				options->gaps_mode = EXPORT_GAPS_TABLE;
+			else
+				break;
+		} else if (!strcmp(name, "--password")) {
+			options->password = value;
+		} else if (!strcmp(name, "--channels")) {
+			options->channel_names = value;
+		} else if (!strcmp(name, "--start")) {
+			options->start_time = (si8) strtoll(value, NULL, 10);
+		} else if (!strcmp(name, "--end")) {
+			options->end_time = (si8) strtoll(value, NULL, 10);
+		} else if (!strcmp(name, "--chunk")) {
+			options->chunk_samples = (si8) strtoll(value, NULL, 10);
+		} else if (!strcmp(name, "--threads")) {
+			options->number_of_threads = atoi(value);
+		} else {
+			break;
+		}
+	}
+	if (i < argc || n_paths != 2 || options->chunk_samples <= 0) {
+		fprintf(stderr, "%s: invalid arguments\n\n", argv[0]);
+		EXPORT_usage(argv[0]);
+		return(-1);
+	}
+
+	// format from the extension
+	if (options->format < 0) {
+		len = (si4) strlen(options->output_path);
+		if (len > 4 && !strcmp(options->output_path + len - 4, ".npy"))
+			options->format = EXPORT_FORMAT_NPY;
+		else if ((len > 3 && !strcmp(options->output_path + len - 3, ".h5")) || (len > 5 && !strcmp(options->output_path + len - 5, ".hdf5")))
+			options->format = EXPORT_FORMAT_HDF5;
+		else
+			options->format = EXPORT_FORMAT_RAW;
+	}
+	#ifndef MEF_EXPORT_HDF5
+		if (options->format == EXPORT_FORMAT_HDF5) {
+			fprintf(stderr, "%s: built without HDF5; use --format raw or npy\n", argv[0]);
+			return(-1);
+		}
+	#endif
+
+
+	return(0);
+}
+
+
+si8	EXPORT_sample_at_or_after(CONTINUITY_INDEX *continuity_index, si8 time)
+{
+	CONTINUITY_ENTRY	*entry;
+	si8			i, sample;
+
+
+	// first channel sample at or after a time (the number of samples if none)
+	for (i = 0; i < continuity_index->number_of_entries; ++i) {
+		entry = continuity_index->entries + i;
+		if (entry->end_time <= (sf8) time)
+			continue;
+		if (time <= entry->start_time)
+			return(entry->start_sample);
+		sample = entry->start_sample + READ_PLAN_samples_in_time(time - entry->start_time, continuity_index->sampling_frequency);
+		return((sample > entry->end_sample) ? entry->end_sample + 1 : sample);
+	}
+	if (continuity_index->number_of_entries == 0)
+		return(0);
+
+
+	return(continuity_index->entries[continuity_index->number_of_entries - 1].end_sample + 1);
+}
+
+
+void	EXPORT_usage(si1 *program)
+{
+	fprintf(stderr, "usage: %s [options] <session.mefd | channel.timd> <output>\n\n", program);
+	fprintf(stderr, "  --format raw|npy|hdf5   output format (default: from the extension, .npy, .h5 / .hdf5, else raw)\n");
+	fprintf(stderr, "  --gaps nan|table        NaN fill the discontinuities (default), or remove them & list them in the JSON\n");
+	fprintf(stderr, "  --password <pw>         password of the session\n");
+	fprintf(stderr, "  --channels <a,b,...>    channels to export, in this order (default: all)\n");
+	fprintf(stderr, "  --start <uUTC>          first time exported (default: start of the session)\n");
+	fprintf(stderr, "  --end <uUTC>            end time, exclusive (default: end of the session)\n");
+	fprintf(stderr, "  --scale                 multiply by the units conversion factor (default: stored values)\n");
+	fprintf(stderr, "  --chunk <samples>       samples per channel decoded & written at a time (default: %lld)\n", (long long) EXPORT_CHUNK_SAMPLES_DEFAULT);
+	fprintf(stderr, "  --threads <n>           decoding threads (default: one per processor)\n\n");
+	fprintf(stderr, "The array is float32, channels x samples (channel-major); <output>.json describes it.\n");
+
+
+	return;
+}
+
+
+si4	EXPORT_write_json(EXPORT_TASK_ARGS *args, si1 *json_path, si8 start_time, si8 end_time)
+{
+	static const si1	*format_names[] = {"raw", "npy", "hdf5"};
+	FILE			*fp;
+	EXPORT_CHANNEL		*export_channel;
+	CHANNEL			*channel;
+	TIME_SERIES_METADATA_SECTION_2	*tmd2;
+	EXPORT_GAP		*gap;
+	si8			i, j, n_channels;
+
+
+	fp = fopen(json_path, "w");
+	if (fp == NULL)
+		return(-1);
+	n_channels = 0;
+	while (args->channels[n_channels].channel_number >= 0)
+		++n_channels;
+
+	fprintf(fp, "{\n  \"format\": \"%s\",\n  \"file\": ", format_names[args->options->format]);
+	EXPORT_json_string(fp, args->options->output_path);
+	fprintf(fp, ",\n  \"source\": ");
+	EXPORT_json_string(fp, args->options->input_path);
+	fprintf(fp, ",\n  \"dtype\": \"float32\",\n  \"byte_order\": \"little\",\n  \"layout\": \"channel-major\",\n");
+	fprintf(fp, "  \"shape\": [%lld, %lld],\n", (long long) n_channels, (long long) args->row_samples);
+	if (args->options->format == EXPORT_FORMAT_HDF5)
+		fprintf(fp, "  \"dataset\": \"/%s\",\n", EXPORT_HDF5_DATASET);
+	else
+		fprintf(fp, "  \"data_offset\": %lld,\n", (long long) args->data_offset);
+	fprintf(fp, "  \"chunk_samples\": %lld,\n  \"gaps\": \"%s\",\n  \"scaled\": %s,\n", (long long) args->options->chunk_samples,
+		(args->options->gaps_mode == EXPORT_GAPS_NAN) ? "nan" : "table", (args->options->scale == MEF_TRUE) ? "true" : "false");
+	fprintf(fp, "  \"start_time\": %lld,\n  \"end_time\": %lld,\n  \"channels\": [", (long long) start_time, (long long) end_time);
+
+	for (i = 0; i < n_channels; ++i) {
+		export_channel = args->channels + i;
+		channel = args->reader->channels + export_channel->channel_number;
+		tmd2 = channel->metadata.time_series_section_2;
+		fprintf(fp, "%s\n    {\"name\": ", (i) ? "," : "");
+		EXPORT_json_string(fp, channel->name);
+		fprintf(fp, ", \"sampling_frequency\": %.17g, \"units_conversion_factor\": %.17g, \"units_description\": ", tmd2->sampling_frequency, tmd2->units_conversion_factor);
+		EXPORT_json_string(fp, tmd2->units_description);
+		fprintf(fp, ",\n     \"first_sample\": %lld, \"samples\": %lld, \"failed_blocks\": %lld, \"status\": \"%s\",\n     \"gaps\": [",
+			(long long) export_channel->first_sample, (long long) export_channel->number_of_samples, (long long) export_channel->failed_blocks, (export_channel->status) ? "failed" : "ok");
+		for (j = 0; j < export_channel->number_of_gaps; ++j) {
+			gap = export_channel->gaps + j;
+			fprintf(fp, "%s{\"output_sample\": %lld, \"samples\": %lld, \"start_time\": %lld, \"end_time\": %lld}", (j) ? ", " : "",
+				(long long) gap->output_sample, (long long) gap->number_of_samples, (long long) gap->start_time, (long long) gap->end_time);
+		}
+		fprintf(fp, "]}");
+	}
+	fprintf(fp, "\n  ]\n}\n");
+
+
+	return((fclose(fp)) ? -1 : 0);
+}
+
+
+si4	EXPORT_write_npy_header(FILE *fp, si8 number_of_channels, si8 row_samples)
+{
+	si1	header[EXPORT_NPY_DATA_OFFSET];
+	si4	len;
+
+
+	// NPY 1.0: magic, version, header length (little-endian ui2), then a dict padded with spaces to the data offset
+	memset((void *) header, ' ', EXPORT_NPY_DATA_OFFSET);
+	memcpy((void *) header, "\x93NUMPY\x01\x00", 8);
+	header[8] = (si1) ((EXPORT_NPY_DATA_OFFSET - 10) & 0xFF);
+	header[9] = (si1) ((EXPORT_NPY_DATA_OFFSET - 10) >> 8);
+	len = snprintf(header + 10, EXPORT_NPY_DATA_OFFSET - 10, "{'descr': '<f4', 'fortran_order': False, 'shape': (%lld, %lld), }", (long long) number_of_channels, (long long) row_samples);
+	header[10 + len] = ' ';
+	header[EXPORT_NPY_DATA_OFFSET - 1] = '\n';
+
+
+	return((fwrite((void *) header, sizeof(si1), EXPORT_NPY_DATA_OFFSET, fp) == EXPORT_NPY_DATA_OFFSET) ? 0 : -1);
+}
+
+
+int	main(int argc, char **argv)
+{
+	EXPORT_OPTIONS		options;
+	EXPORT_TASK_ARGS	args;
+	EXPORT_CHANNEL		*export_channel;
+	MEF_READER		*reader;
+	MEF_CONTEXT		*previous_context;
+	CHANNEL			*channel;
+	CONTINUITY_INDEX	*continuity_index;
+	FILE			*fp;
+	si1			json_path[EXPORT_PATH_BYTES + 8], *name, *next;
+	si4			i, n_channels, n_threads, ret_val, n_failed;
+	si8			n, earliest, latest;
+	#ifdef MEF_EXPORT_HDF5
+		hid_t		file, space, dcpl;
+		hsize_t		dims[2], chunk_dims[2];
+		sf4		fill_value;
+	#endif
+
+
+	ret_val = EXPORT_parse_options(&options, (si4) argc, (si1 **) argv);
+	if (ret_val)
+		return((ret_val > 0) ? 0 : 1);
+
+	(void) initialize_meflib();
+	MEF_context->behavior_on_fail = RETURN_ON_FAIL;
+	reader = MEF_READER_open(options.input_path, options.password, options.number_of_threads);
+	if (reader == NULL) {
+		fprintf(stderr, "%s: could not read %s\n", argv[0], options.input_path);
+		return(1);
+	}
+
+	// channels (terminated by channel_number -1)
+	memset((void *) &args, 0, sizeof(EXPORT_TASK_ARGS));
+	args.options = &options;
+	args.reader = reader;
+	args.channels = (EXPORT_CHANNEL *) calloc((size_t) reader->number_of_channels + 1, sizeof(EXPORT_CHANNEL));
+	n_channels = 0;
+	if (options.channel_names == NULL) {
+		for (i = 0; i < reader->number_of_channels; ++i)
+			args.channels[n_channels++].channel_number = i;
+	} else {
+		for (name = options.channel_names; name != NULL && *name; name = next) {
+			next = strchr(name, ',');
+			if (next != NULL)
+				*next++ = 0;
+			i = MEF_READER_find_channel(reader, name);
+			if (i < 0 || n_channels == reader->number_of_channels) {
+				fprintf(stderr, "%s: no channel \"%s\" in %s\n", argv[0], name, options.input_path);
+				return(1);
+			}
+			args.channels[n_channels++].channel_number = i;
+		}
+	}
+	args.channels[n_channels].channel_number = -1;
+	if (n_channels == 0) {
+		fprintf(stderr, "%s: no channels to export\n", argv[0]);
+		return(1);
+	}
+
+	// time range & samples per row
+	if (options.start_time == UUTC_NO_ENTRY || options.end_time == UUTC_NO_ENTRY) {
+		earliest = latest = UUTC_NO_ENTRY;
+		for (i = 0; i < n_channels; ++i) {
+			channel = reader->channels + args.channels[i].channel_number;
+			if (earliest == UUTC_NO_ENTRY || channel->earliest_start_time < earliest)
+				earliest = channel->earliest_start_time;
+			if (latest == UUTC_NO_ENTRY || channel->latest_end_time > latest)
+				latest = channel->latest_end_time;
+		}
+		if (options.start_time == UUTC_NO_ENTRY)
+			options.start_time = earliest;
+		if (options.end_time == UUTC_NO_ENTRY)
+			options.end_time = latest + 1;  // the end time is that of the last sample
+	}
+	args.row_samples = 0;
+	for (i = 0; i < n_channels; ++i) {
+		export_channel = args.channels + i;
+		continuity_index = MEF_READER_continuity_index(reader, export_channel->channel_number);
+		if (continuity_index == NULL) {
+			fprintf(stderr, "%s: could not index channel %s\n", argv[0], reader->channels[export_channel->channel_number].name);
+			return(1);
+		}
+		if (options.gaps_mode == EXPORT_GAPS_NAN) {
+			n = READ_PLAN_samples_in_time(options.end_time - options.start_time, continuity_index->sampling_frequency);
+		} else {
+			export_channel->first_sample = EXPORT_sample_at_or_after(continuity_index, options.start_time);
+			n = EXPORT_sample_at_or_after(continuity_index, options.end_time) - export_channel->first_sample;
+		}
+		export_channel->number_of_samples = (n > 0) ? n : 0;
+		if (export_channel->number_of_samples > args.row_samples)
+			args.row_samples = export_channel->number_of_samples;
+	}
+	if (args.row_samples == 0) {
+		fprintf(stderr, "%s: no samples between %lld and %lld\n", argv[0], (long long) options.start_time, (long long) options.end_time);
+		return(1);
+	}
+
+	// output file, full size (the rows are written in place, in parallel)
+	#ifdef MEF_EXPORT_HDF5
+		file = (hid_t) -1;  // only created for HDF5 output
+	#endif
+	if (options.format == EXPORT_FORMAT_HDF5) {
+		#ifdef MEF_EXPORT_HDF5
+			dims[0] = (hsize_t) n_channels;
+			dims[1] = (hsize_t) args.row_samples;
+			chunk_dims[0] = 1;
+			chunk_dims[1] = (hsize_t) ((options.chunk_samples < args.row_samples) ? options.chunk_samples : args.row_samples);
+			fill_value = (sf4) NAN;
+			file = H5Fcreate(options.output_path, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+			space = H5Screate_simple(2, dims, NULL);
+			dcpl = H5Pcreate(H5P_DATASET_CREATE);
+			(void) H5Pset_chunk(dcpl, 2, chunk_dims);
+			(void) H5Pset_fill_value(dcpl, H5T_NATIVE_FLOAT, &fill_value);
+			args.dataset = (file < 0) ? -1 : H5Dcreate2(file, EXPORT_HDF5_DATASET, H5T_IEEE_F32LE, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+			H5Pclose(dcpl);
+			H5Sclose(space);
+			if (args.dataset < 0) {
+				if (file >= 0)
+					H5Fclose(file);
+				fprintf(stderr, "%s: could not create %s\n", argv[0], options.output_path);
+				return(1);
+			}
+		#endif
+	} else {
+		args.data_offset = (options.format == EXPORT_FORMAT_NPY) ? EXPORT_NPY_DATA_OFFSET : 0;
+		fp = fopen(options.output_path, "wb");
+		ret_val = (fp == NULL) ? -1 : 0;
+		if (ret_val == 0 && options.format == EXPORT_FORMAT_NPY)
+			ret_val = EXPORT_write_npy_header(fp, (si8) n_channels, args.row_samples);
+		if (ret_val == 0)
+			ret_val = (EXPORT_fseek(fp, args.data_offset + ((si8) n_channels * args.row_samples * (si8) sizeof(sf4)) - 1) || fputc(0, fp) == EOF) ? -1 : 0;
+		if (fp != NULL && fclose(fp))
+			ret_val = -1;
+		if (ret_val) {
+			fprintf(stderr, "%s: could not create %s\n", argv[0], options.output_path);
+			return(1);
+		}
+	}
+
+	// decode & write the channels in parallel (in the reader's context)
+	n_threads = THREAD_number_of_threads(options.number_of_threads, (si8) n_channels);
+	args.decode_threads = THREAD_number_of_threads(options.number_of_threads, (si8) 1 << 30) / n_threads;
+	if (args.decode_threads < 1)
+		args.decode_threads = 1;
+	args.samples = (si4 **) calloc((size_t) n_threads, sizeof(si4 *));
+	args.values = (sf4 **) calloc((size_t) n_threads, sizeof(sf4 *));
+	for (i = 0; i < n_threads; ++i) {
+		n = (options.chunk_samples < args.row_samples) ? options.chunk_samples : args.row_samples;
+		args.samples[i] = (si4 *) malloc((size_t) n * sizeof(si4));
+		args.values[i] = (sf4 *) malloc((size_t) n * sizeof(sf4));
+		if (args.samples[i] == NULL || args.values[i] == NULL) {
+			fprintf(stderr, "%s: not enough memory for chunks of %lld samples\n", argv[0], (long long) n);
+			return(1);
+		}
+	}
+	THREAD_mutex_init(&args.mutex);
+	fprintf(stderr, "exporting %d channel%s x %lld samples to %s\n", n_channels, (n_channels > 1) ? "s" : "", (long long) args.row_samples, options.output_path);
+	previous_context = MEF_set_context(&reader->context);
+	(void) THREAD_run_tasks(EXPORT_channel_task, (void *) &args, (si8) n_channels, n_threads);
+	(void) MEF_set_context(previous_context);
+	THREAD_mutex_destroy(&args.mutex);
+	#ifdef MEF_EXPORT_HDF5
+		if (file >= 0) {
+			H5Dclose(args.dataset);
+			H5Fclose(file);
+		}
+	#endif
+
+	// metadata
+	snprintf(json_path, EXPORT_PATH_BYTES + 8, "%s.json", options.output_path);
+	if (EXPORT_write_json(&args, json_path, options.start_time, options.end_time)) {
+		fprintf(stderr, "%s: could not write %s\n", argv[0], json_path);
+		return(1);
+	}
+	n_failed = 0;
+	for (i = 0; i < n_channels; ++i) {
+		if (args.channels[i].status) {
+			fprintf(stderr, "%s: channel %s could not be exported\n", argv[0], reader->channels[args.channels[i].channel_number].name);
+			++n_failed;
+		} else if (args.channels[i].failed_blocks) {
+			fprintf(stderr, "%s: %lld block(s) of channel %s could not be decoded (NaN)\n", argv[0], (long long) args.channels[i].failed_blocks, reader->channels[args.channels[i].channel_number].name);
+		}
+		free(args.channels[i].gaps);
+	}
+	for (i = 0; i < n_threads; ++i) {
+		free(args.samples[i]);
+		free(args.values[i]);
+	}
+	free(args.samples);
+	free(args.values);
+	free(args.channels);
+	MEF_READER_close(reader);
+
+
+	return((n_failed) ? 1 : 0);
+}
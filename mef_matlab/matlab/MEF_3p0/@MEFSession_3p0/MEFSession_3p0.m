@@ -26,7 +26,7 @@ classdef MEFSession_3p0 < MEFSession & MultiscaleElectrophysiologyFile_3p0
     % See also get_sessinfo.
 
 	% Copyright 2020 Richard J. Cui. Created: Thu 02/06/2020 10:07:26.965 AM
-	% $Revision: 0.8 $  $Date: Fri 09/25/2020  9:41:56.944 AM $
+	% $Revision: 0.9 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
 	%
     % Rocky Creek Dr NE
     % Rochester, MN 55906, USA
@@ -115,6 +115,7 @@ classdef MEFSession_3p0 < MEFSession & MultiscaleElectrophysiologyFile_3p0
         metadata = read_mef_info(this, varargin) % get session metadata info of MEF 3.0
         valid_yn = checkSessValid(this, varargin) % check validity of session info
         [X, t] = import_sess(this, varargin) % import session of MEF 3.0 data
+        [pnts, failed_blocks, se_index] = export_sess(this, varargin) % export session of MEF 3.0 data to a float32 file
         metadata = setSessionInfo(this, varargin) % set session information
         ac_num = getAcqChanNumber(this) % get acquistion channel number
     end % methods
@@ -23,12 +23,17 @@ function valid_yn = checkSessValid(this, varargin)
 %   samples, Number of index entry, Number of discountinuity entry, Subject
 %   encryption, Session encryption, Data encryption, MEF fromat version.
 % 
+%   If sess_info is not given, the session in SessionPath is validated
+%   natively by validate_session_3p0, in one parallel pass over the
+%   metadata of its channels (no MATLAB objects or tables per channel).
+%   With sess_info, the checks are done on the table.
+% 
 % Example:
 % 
-% Sess also get_sessinfo, MEFSession_3p0.
+% Sess also get_sessinfo, MEFSession_3p0, validate_session_3p0.
 
 % Copyright 2020 Richard J. Cui. Created: Fri 01/03/2020  4:19:10.683 PM
-% $ Revision: 0.5 $  $ Date: Mon 11/02/2020 10:14:57.073 AM $
+% $ Revision: 0.6 $  $ Date: Sun 10/18/2026 10:12:37.415 AM $
 %
 % Rocky Creek Dr NE
 % Rochester, MN 55906, USA
@@ -44,13 +49,21 @@ q = parse_input(this, varargin{:});
 sess_info = q.sess_info;
 pw = q.password;
 
-if isempty(sess_info)
-    sess_info = this.SessionInformation;
-end % if
 if isempty(pw)
     pw = this.Password;
 end % if
 
+% validate the session natively
+% -----------------------------
+if isempty(sess_info) && ~isempty(this.SessionPath)
+    valid_yn = check_session(this, pw);
+    return
+end % if
+
+if isempty(sess_info)
+    sess_info = this.SessionInformation;
+end % if
+
 % validate the data
 % -----------------
 if isempty(sess_info)
@@ -96,6 +109,22 @@ end
 % =========================================================================
 % Subroutines
 % =========================================================================
+function valid_yn = check_session(this, pw)
+% check the session in SessionPath with validate_session_3p0
+
+pw_str = this.processPassword(pw); % password
+report = validate_session_3p0(this.SessionPath, pw_str); % mex
+
+warning('off','backtrace');
+for k = 1:numel(report.messages)
+    warning('MEFSession_3p0:checkSessValid', '%s', report.messages{k})
+end % for
+warning('on')
+
+valid_yn = report.valid;
+
+end % function
+
 function u_yn = checkUnique(x)
 % check uniqueness of an array
 
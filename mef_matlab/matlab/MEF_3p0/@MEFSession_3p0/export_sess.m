@@ -0,0 +1,130 @@
+function [pnts, failed_blocks, se_index] = export_sess(this, varargin)
+% MEFSESSION_3P0.EXPORT_SESS export session of MEF 3.0 data to a float32 file
+% 
+% Syntax:
+%   [pnts, failed_blocks, se_index] = export_sess(this, data_file, begin_stop, bs_unit, sel_chan)
+%   [pnts, failed_blocks, se_index] = export_sess(__, pw)
+% 
+% Input(s):
+%   this            - [obj] MEFSession_3p0 object
+%   data_file       - [str] path of the data file to write (overwritten)
+%   begin_stop      - [num] 1 x 2 array of begin and stop points of
+%                     exporting the session, absolute time points
+%   bs_unit         - [str] unit of begin_stop: 'uUTC','Index', 'Second', 
+%                     'Minute', 'Hour', and 'Day'.
+%   sel_chan        - [str array] the names of the selected channels
+%   pw              - [struct] (para) password structure
+%                     .Session      : session password
+%                     .Subject      : subject password
+%                     .Data         : data password
+% 
+% Output(s):
+%   pnts            - [num] number of samples written per channel
+%   failed_blocks   - [num] 1 x M number of blocks of each channel that
+%                     could not be read (written as NaN)
+%   se_index        - [num] 1 x 2 array of the first and last sample
+%                     indices exported
+% 
+% Note:
+%   Same range and channels as import_sess, but the data are written to
+%   data_file instead of being returned: single precision, M x N
+%   (channels x samples) column-major, i.e. the layout of an EEGLAB .fdt
+%   file. The channels are decoded in parallel, a chunk of samples at a
+%   time, so the memory used does not grow with the length of the range.
+% 
+% See also import_sess, export_data_3p0.
+
+% Copyright 2026 Richard J. Cui. Created: Sun 10/18/2026 10:12:37.415 AM
+% $Revision: 0.1 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+%
+% Rocky Creek Dr NE
+% Rochester, MN 55906, USA
+%
+% Email: richard.cui@utoronto.ca
+
+% =========================================================================
+% parse inputs
+% =========================================================================
+q = parseInputs(this, varargin{:});
+data_file = q.data_file;
+begin_stop = q.begin_stop;
+bs_unit = q.bs_unit;
+sel_chan = q.sel_chan;
+pw = q.pw;
+
+if isempty(pw)
+    pw = this.Password;
+end % if
+
+sess_path = this.SessionPath;
+
+% =========================================================================
+% main
+% =========================================================================
+ch_paths = cellstr(fullfile(sess_path, sel_chan + ".timd")); % channel paths
+pw_str = this.processPassword('Level1Password', pw.Level1Password,...
+    'Level2Password', pw.Level2Password,...
+    'AccessLevel', pw.AccessLevel);
+
+% sample indices of begin and stop points (of the first channel)
+% --------------------------------------------------------------
+[header, channel] = this.readHeader(ch_paths{1}, pw_str, pw.AccessLevel);
+this.Header = header;
+this.Channel = channel;
+switch lower(bs_unit)
+    case 'index'
+        se_index = begin_stop;
+    otherwise
+        se_index = this.SampleTime2Index(begin_stop, bs_unit);
+end % switch
+
+num_samples = max(this.Samples);
+if isempty(num_samples)
+    num_samples = channel.metadata.section_2.number_of_samples;
+end % if
+if se_index(1) < 1
+    se_index(1) = 1;
+    warning('MEFSession_3p0:export_sess:discardSample',...
+        'Reqested data samples before the recording are discarded')
+end % if
+if se_index(2) > num_samples
+    se_index(2) = num_samples;
+    warning('MEFSession_3p0:export_sess:discardSample',...
+        'Reqested data samples after the recording are discarded')
+end % if
+
+% export
+% ------
+[pnts, failed_blocks] = export_data_3p0(ch_paths, pw_str, se_index, data_file);
+if any(failed_blocks > 0)
+    warning('MEFSession_3p0:export_sess:failedBlocks',...
+        '%d data block(s) could not be read and were written as NaN',...
+        sum(failed_blocks))
+end % if
+
+end
+
+% =========================================================================
+% subroutines
+% =========================================================================
+function q = parseInputs(this, varargin)
+
+% defaults
+default_pw = struct([]); % password
+
+% parse rules
+p = inputParser;
+p.addRequired('this', @isobject);
+p.addRequired('data_file', @ischar);
+p.addRequired('begin_stop', @(x) isnumeric(x) & numel(x) == 2 & x(1) <= x(2));
+p.addRequired('bs_unit', @isstr);
+p.addRequired('sel_chan', @isstring) % must be string array
+p.addOptional('pw', default_pw, @isstruct);
+
+% parse and return the results
+p.parse(this, varargin{:});
+q = p.Results;
+
+end % function
+
+% [EOF]
\ No newline at end of file
@@ -30,7 +30,7 @@ function [sess_info, unit] = get_info_data(this)
 % See also MEFSession_3p0, get_sessinfo.
 
 % Copyright 2020 Richard J. Cui. Created: Fri 01/03/2020  4:19:10.683 PM
-% $ Revision: 0.5 $  $ Date: Mon 11/02/2020 10:24:12.139 AM $
+% $ Revision: 0.6 $  $ Date: Sun 10/18/2026 10:12:37.415 AM $
 %
 % Rocky Creek Dr NE
 % Rochester, MN 55906, USA
@@ -67,6 +67,11 @@ else % if
     pw = this.processPassword(this.Password); % password
     sess_info = table('size', sz, 'VariableTypes', var_types,...
         'VariableNames', var_names);
+    % analysis discountinuity of all channels in one pass
+    cont_var_names = {'SegmentStart', 'BlockStart', 'SegmentEnd', 'BlockEnd',...
+        'SampleTimeStart', 'SampleTimeEnd', 'SampleIndexStart',...
+        'SampleIndexEnd', 'SegmentLength'};
+    [sess_cont, cont_chan] = analyze_continuity_3p0(fp, pw); % mex
     for k = 1:num_chan
         tsc_k = ts_channel(k); % kth channel of time series
         fn_k = [tsc_k.name, '.', tsc_k.extension]; % channel name
@@ -74,12 +79,9 @@ else % if
         header_k = this.readHeader(fullfile(fp, fn_k), pw);
         mef_ver = sprintf('%d.%d', header_k.mef_version_major,...
             header_k.mef_version_minor);
-        % analysis discountinuity
-        ch3_k = MultiscaleElectrophysiologyFile_3p0(fp, fn_k,...
-            'Level1Password', this.Password.Level1Password,...
-            'Level2Password', this.Password.Level2Password,...
-            'AccessLevel', this.Password.AccessLevel);
-        seg_cont_k = ch3_k.analyzeContinuity;
+        % discountinuity of the channel
+        cont_k = sess_cont{strcmp(cont_chan, tsc_k.name)};
+        seg_cont_k = array2table(cont_k, 'VariableNames', cont_var_names);
         
         sess_info.ChannelName(k)  = tsc_k.name;
         sess_info.ChannelNumber(k)= tsc_k.metadata.section_2.acquisition_channel_number;
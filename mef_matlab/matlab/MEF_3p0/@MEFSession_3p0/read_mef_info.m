@@ -6,6 +6,7 @@ function metadata = read_mef_info(this, varargin)
 %   metadata = __(__, sess_path)
 %   metadata = __(__, sess_path, password)
 %   metadata = __(__, sess_path, password, map_indices)
+%   metadata = __(__, sess_path, password, map_indices, record_query)
 % 
 % Input(s):
 %   this            - [obj] MEFSession_3p0 object
@@ -15,6 +16,11 @@ function metadata = read_mef_info(this, varargin)
 %                     = password in this)
 %   map_indices     - [logical] flag whether indices should be mapped [true
 %                     or false] (default = true)
+%   record_query    - [struct] (opt) read only the records selected by
+%                     .start_time, .end_time (uUTC, inclusive) and .types
+%                     (cell of record types, e.g. {'Note', 'Seiz'}); any
+%                     field may be empty or missing (default = [], all
+%                     records)
 %
 % Output(s): 
 %   metadata    	- [struct] structure containing session metadata, 
@@ -25,7 +31,7 @@ function metadata = read_mef_info(this, varargin)
 % See also read_mef_info_3p0.
 
 % Copyright 2020 Richard J. Cui. Adapted: Sat 02/01/2020 10:30:50.708 PM
-% $Revision: 0.7 $  $Date: Fri 09/25/2020  9:41:56.944 AM $
+% $Revision: 0.8 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
 %
 % Rocky Creek Dr NE
 % Rochester, MN 55906, USA
@@ -39,6 +45,7 @@ q = parseInputs(this, varargin{:});
 sess_path = q.sess_path;
 password = q.password;
 map_indices = q.map_indices;
+record_query = q.record_query;
 
 if isempty(sess_path)
     sess_path = this.SessionPath;
@@ -52,7 +59,7 @@ end % if
 % main
 % =========================================================================
 pw = this.processPassword(password);
-metadata = read_mef_info_3p0(sess_path, pw, map_indices); % mex
+metadata = read_mef_info_3p0(sess_path, pw, map_indices, record_query); % mex
 
 end % function
 
@@ -65,6 +72,7 @@ function q = parseInputs(varargin)
 default_sp = ''; % sesseion path
 default_pw = struct([]);
 default_mi = true;
+default_rq = struct([]); % record query
 
 % parse rules
 p = inputParser;
@@ -72,6 +80,7 @@ p.addRequired('this', @isobject);
 p.addOptional('sess_path', default_sp, @isstr);
 p.addOptional('password', default_pw, @isstruct);
 p.addOptional('map_indices', default_mi, @islogical);
+p.addOptional('record_query', default_rq, @isstruct);
 
 % parse inputs and return results
 p.parse(varargin{:});
@@ -31,7 +31,7 @@ classdef MultiscaleElectrophysiologyFile_3p0 < MultiscaleElectrophysiologyFile
     % See also .
     
     % Copyright 2020 Richard J. Cui. Created: Tue 02/04/2020  2:21:31.965 PM
-    % $Revision: 0.6 $  $Date: Fri 09/25/2020  9:41:56.944 AM $
+    % $Revision: 0.10 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
     %
     % Rocky Creek Dr NE
     % Rochester, MN 55906, USA
@@ -151,7 +151,12 @@ classdef MultiscaleElectrophysiologyFile_3p0 < MultiscaleElectrophysiologyFile
         seg_cont = analyzeContinuity(this, varargin) % analyze continuity of data sampling
         [x, t] = importSignal(this, varargin) % input MEF 3.0 time series channel
         data = read_mef_data(this, channel_path, varargin) % read data of MEF 3.0
+        epochs = read_mef_epochs(this, ranges, varargin) % read many epochs of MEF 3.0 (mex)
+        id = open_mef_scan(this, window, varargin) % scan MEF 3.0 in windows with read-ahead (mex)
+        [env_min, env_max, env_rms, t] = read_mef_envelope(this, start_end, width, varargin) % min/max envelope of MEF 3.0 (mex)
         pw = processPassword(this, varargin) % process MEF 3.0 password
+        [sample_index, sample_yn] = SampleTime2Index(this, varargin) % time --> index (mex)
+        [sample_time, sample_yn] = SampleIndex2Time(this, varargin) % index --> time (mex)
     end % methods
 end
 
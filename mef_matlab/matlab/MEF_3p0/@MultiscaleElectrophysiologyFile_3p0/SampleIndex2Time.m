@@ -0,0 +1,99 @@
+function [sample_time, sample_yn] = SampleIndex2Time(this, varargin)
+% MULTISCALEELECTROPHYSIOLOGYFILE_3P0.SAMPLEINDEX2TIME Convert sample index to sample time of MEF 3.0 channel
+% 
+% Syntax
+%   [sample_time, sample_yn] = SampleIndex2Time(this, sample_index)
+%   [sample_time, sample_yn] = SampleIndex2Time(__, st_unit)
+% 
+% Input(s):
+%   this            - [obj] MultiscaleElectrophysiologyFile_3p0 object
+%   sample_index    - [num array] array of sample index (must be integers)
+%   st_unit         - [str] (optional) sample time unit: 'uUTC' (default)
+%                     or 'u', 'mSec', 'Second' or 's', 'Minute' or 'm', 'Hour' or
+%                     'h' and 'Day' or 'd'.
+% 
+% Output(s):
+%   sample_time     - [num array] sample time corresponding to sample
+%                     indices (default unit: uUTC)
+%   sample_yn       - [logical array] true: this sample time corresponding
+%                     to physically collected data
+% 
+% Note:
+%   An error less than one sample time may occure.
+%
+%   Overrides MultiscaleElectrophysiologyFile.SampleIndex2Time with the
+%   mex function convert_sample_time_3p0 (see SampleTime2Index), over the
+%   cached Continuity table of the channel. Indices
+%   outside the segments of continuity are extrapolated from the preceding
+%   segment at the sampling frequency.
+% 
+% See also SampleTime2Index, convert_sample_time_3p0.
+
+% Copyright 2026 Richard J. Cui. Created: Sun 10/18/2026 10:12:37.415 AM
+% $Revision: 0.2 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+%
+% Rocky Creek Dr NE
+% Rochester, MN 55906, USA
+%
+% Email: richard.cui@utoronto.ca
+
+% parse inputs
+% ------------
+q = parseInputs(this, varargin{:});
+sample_index = q.sample_index;
+st_unit = q.st_unit;
+
+% convert
+% -------
+if isempty(this.Continuity)
+    cont = this.analyzeContinuity;
+else
+    cont = this.Continuity;
+end % if
+ch_path = fullfile(this.FilePath, this.FileName);
+pw = this.processPassword;
+[sample_time, sample_yn] = convert_sample_time_3p0(ch_path, pw,...
+    double(sample_index), 'index2time', cont{:, :}, this.ChanSamplingFreq); % mex
+
+% output
+% ------
+switch lower(st_unit)
+    case 'msec'
+        sample_time = sample_time/1e3;
+    case 'second'
+        sample_time = sample_time/1e6;
+    case 'minute'
+        sample_time = sample_time/(60*1e6);
+    case 'hour'
+        sample_time = sample_time/(60*60*1e6);
+    case 'day'
+        sample_time = sample_time/(24*60*60*1e6);
+end % switch
+
+end
+
+% =========================================================================
+% subroutines
+% =========================================================================
+function q = parseInputs(varargin)
+
+% defaults
+defaultSTUnit = 'uutc';
+expectedSTUnit = {'uutc', 'msec', 'second', 'minute', 'hour', 'day'};
+
+% parse rules
+p = inputParser;
+p.addRequired('this', @isobject);
+p.addRequired('sample_index', @isnumeric);
+p.addOptional('st_unit', defaultSTUnit,...
+    @(x) any(validatestring(x, expectedSTUnit)));
+
+% parse and return the results
+p.parse(varargin{:});
+q.this = p.Results.this;
+q.sample_index = p.Results.sample_index;
+q.st_unit = p.Results.st_unit;
+
+end % function
+
+% [EOF]
\ No newline at end of file
@@ -0,0 +1,100 @@
+function [sample_index, sample_yn] = SampleTime2Index(this, varargin)
+% MULTISCALEELECTROPHYSIOLOGYFILE_3P0.SAMPLETIME2INDEX Convert sample time to sample index of MEF 3.0 channel
+% 
+% Syntax:
+%   [sample_index, sample_yn] = SampleTime2Index(this, sample_time)
+%   [sample_index, sample_yn] = SampleTime2Index(__, st_unit)
+% 
+% Input(s):
+%   this            - [obj] MultiscaleElectrophysiologyFile_3p0 object
+%   sample_time     - [num array] array of sample time (default unit uUTC)
+%   st_unit         - [str] (optional) sample time unit: 'uUTC' (default)
+%                     or 'u', 'mSec', 'Second' or 's', 'Minute' or 'm', 'Hour' or
+%                     'h' and 'Day' or 'd'.
+% 
+% Output(s):
+%   sample_index    - [num array] sample indices corresponding to sample
+%                     time; NaN if the time is not in any segment of
+%                     continuity, or 0 if the channel has only one segment
+%                     of continuity (as MultiscaleElectrophysiologyFile)
+%   sample_yn       - [logical array] true: this sample index corresponding
+%                     to physically collected data
+% 
+% Note:
+%   Overrides MultiscaleElectrophysiologyFile.SampleTime2Index with the
+%   mex function convert_sample_time_3p0, which searches the segments of
+%   continuity once per sample time, rather than masking all the times for
+%   each segment. The rounding is the same. The segments are the cached
+%   Continuity table of the channel (analyzed once if empty), so the
+%   channel is not read again.
+% 
+% See also SampleIndex2Time, convert_sample_time_3p0.
+
+% Copyright 2026 Richard J. Cui. Created: Sun 10/18/2026 10:12:37.415 AM
+% $Revision: 0.3 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+%
+% Rocky Creek Dr NE
+% Rochester, MN 55906, USA
+%
+% Email: richard.cui@utoronto.ca
+
+% parse inputs
+% ------------
+q = parseInputs(this, varargin{:});
+sample_time = q.sample_time;
+st_unit = q.st_unit;
+switch lower(st_unit) % convert to uUTC
+    case 'msec'
+        sample_time = round(sample_time*1e3);
+    case 'second'
+        sample_time = round(sample_time*1e6);
+    case 'minute'
+        sample_time = round(sample_time*60*1e6);
+    case 'hour'
+        sample_time = round(sample_time*60*60*1e6);
+    case 'day'
+        sample_time = round(sample_time*24*60*60*1e6);
+end % switch
+
+% convert
+% -------
+if isempty(this.Continuity)
+    cont = this.analyzeContinuity;
+else
+    cont = this.Continuity;
+end % if
+ch_path = fullfile(this.FilePath, this.FileName);
+pw = this.processPassword;
+[sample_index, sample_yn] = convert_sample_time_3p0(ch_path, pw,...
+    double(sample_time), 'time2index', cont{:, :}, this.ChanSamplingFreq); % mex
+if height(cont) <= 1 % no discontinuity: times outside the recording are 0
+    sample_index(~sample_yn) = 0;
+end % if
+
+end
+
+% =========================================================================
+% subroutines
+% =========================================================================
+function q = parseInputs(varargin)
+
+% defaults
+defaultSTUnit = 'uutc';
+expectedSTUnit = {'uutc', 'msec', 'second', 'minute', 'hour', 'day'};
+
+% parse rules
+p = inputParser;
+p.addRequired('this', @isobject);
+p.addRequired('sample_time', @isnumeric);
+p.addOptional('st_unit', defaultSTUnit,...
+    @(x) any(validatestring(x, expectedSTUnit)));
+
+% parse and return the results
+p.parse(varargin{:});
+q.this = p.Results.this;
+q.sample_time = p.Results.sample_time;
+q.st_unit = p.Results.st_unit;
+
+end % function
+
+% [EOF]
\ No newline at end of file
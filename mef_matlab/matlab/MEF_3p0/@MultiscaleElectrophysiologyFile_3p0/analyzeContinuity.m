@@ -8,7 +8,9 @@ function seg_cont = analyzeContinuity(this, varargin)
 % Imput(s):
 %   this            - [obj] MultiscaleElectrophysiologyFile object
 %   bid             - [table] (opt) block index data (see readBlockIndexData.m
-%                     for the detail) (default = this.BlockIndexData)
+%                     for the detail); if empty, the continuity is analyzed
+%                     from the time series indices of the channel by the
+%                     mex function analyze_continuity_3p0 (default = [])
 % 
 % Output(s):
 %   seg_cont        - [table] N x 9, information of segments of continuity
@@ -33,10 +35,10 @@ function seg_cont = analyzeContinuity(this, varargin)
 % Note:
 %   See the details of MEF 3.0 file at https://msel.mayo.edu/codes.html
 % 
-% See also readBlockIndexData.
+% See also readBlockIndexData, analyze_continuity_3p0.
 
 % Copyright 2020 Richard J. Cui. Created: Wed 02/05/2020 10:19:17.599 AM
-% $Revision: 0.4 $  $Date: Thu 04/09/2020 10:11:27.490 PM $
+% $Revision: 0.5 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
 %
 % Rocky Creek Dr NE
 % Rochester, MN 55906, USA
@@ -48,15 +50,22 @@ function seg_cont = analyzeContinuity(this, varargin)
 % =========================================================================
 q = parseInputs(this, varargin{:});
 bid = q.bid;
-if isempty(bid) && isempty(this.BlockIndexData)
-    bid = this.readBlockIndexData;
-elseif isempty(bid) && ~isempty(this.BlockIndexData)
-    bid = this.readBlockIndexData;
-end % if
 
 % =========================================================================
 % main
 % =========================================================================
+var_names = {'SegmentStart', 'BlockStart', 'SegmentEnd', 'BlockEnd', 'SampleTimeStart',...
+    'SampleTimeEnd', 'SampleIndexStart', 'SampleIndexEnd', 'SegmentLength'};
+
+% without block index data, analyze the time series indices natively
+% ------------------------------------------------------------------
+if isempty(bid)
+    ch_path = fullfile(this.FilePath, this.FileName);
+    chunk_cont = analyze_continuity_3p0(ch_path, this.processPassword); % mex
+    seg_cont = array2table(chunk_cont, 'VariableNames', var_names);
+    this.Continuity = seg_cont;
+    return
+end % if
 
 % find out index of continous chunks
 % -----------------------------------
@@ -93,13 +102,11 @@ end % if
 
 % get the continuity table
 % ------------------------
-var_names = {'SegmentStart', 'BlockStart', 'SegmentEnd', 'BlockEnd', 'SampleTimeStart',...
-    'SampleTimeEnd', 'SampleIndexStart', 'SampleIndexEnd', 'SegmentLength'};
 num_chunk_cont = size(chunk_index, 1); % number of continuity chunks
 chunk_cont = zeros(num_chunk_cont, numel(var_names));
 for k = 1:num_chunk_cont
-    bg_k = chunk_index(1);
-    ed_k = chunk_index(2);
+    bg_k = chunk_index(k, 1);
+    ed_k = chunk_index(k, 2);
     
     % SegmentStart
     chunk_cont(k, 1) = bid.Segment(bg_k);
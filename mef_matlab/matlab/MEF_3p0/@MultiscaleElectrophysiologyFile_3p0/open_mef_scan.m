@@ -0,0 +1,84 @@
+function id = open_mef_scan(this, window, varargin)
+% MULTISCALEELECTROPHYSIOLOGYFILE_3P0.OPEN_MEF_SCAN Open a windowed scan of the MEF 3.0 channel with read-ahead
+%	
+% Syntax:
+%   id = open_mef_scan(this, window)
+%   id = open_mef_scan(__, step)
+%   id = open_mef_scan(__, step, prefetch_blocks)
+% 
+% Input(s):
+%   this            - [obj] MultiscaleElectrophysiologyFile_3p0 object
+%   window          - [num] window length in samples
+%   step            - [num] (opt) samples between the starts of 
+%                     consecutive windows (default = window)
+%   prefetch_blocks - [num] (opt) number of blocks read and decoded ahead
+%                     of the window read last (default = 8)
+%
+% Output(s): 
+%   id              - [num] id of the scanner, for scan_signal_3p0
+%
+% Example:
+%   id = this.open_mef_scan(10000);
+%   [x, start_index] = scan_signal_3p0('read', id);
+%   while ~isempty(x)
+%       % ... process x ...
+%       [x, start_index] = scan_signal_3p0('read', id);
+%   end % while
+%   scan_signal_3p0('close', id);
+%
+% Note:
+%   Unlike calling importSignal once per window, the scanner keeps the
+%   channel open and reads and decodes the next windows on a background
+%   thread while the current one is processed. Samples are NaN where
+%   missing, as in read_mef_data.
+%
+% See also scan_signal_3p0, importSignal.
+
+% Copyright 2026 Richard J. Cui. Created: Sun 10/18/2026 10:12:37.415 AM
+% $Revision: 0.1 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+%
+% Rocky Creek Dr NE
+% Rochester, MN 55906, USA
+%
+% Email: richard.cui@utoronto.ca
+
+% =========================================================================
+% parse inputs
+% =========================================================================
+q = parseInputs(this, window, varargin{:});
+window = q.window;
+step = q.step;
+prefetch_blocks = q.prefetch_blocks;
+
+% =========================================================================
+% main
+% =========================================================================
+ch_path = fullfile(this.FilePath, this.FileName);
+pw = this.processPassword;
+id = scan_signal_3p0('open', ch_path, pw, window, step, prefetch_blocks); % mex
+
+end
+
+% =========================================================================
+% subroutines
+% =========================================================================
+function q = parseInputs(varargin)
+
+% defaults
+default_st = []; % step (= window)
+default_pb = []; % prefetch_blocks (mex default)
+
+% parse rules
+p = inputParser;
+p.addRequired('this', @isobject);
+p.addRequired('window', @(x) isnumeric(x) && isscalar(x) && x >= 1);
+p.addOptional('step', default_st, @(x) isempty(x) || (isnumeric(x) && isscalar(x) && x >= 1));
+p.addOptional('prefetch_blocks', default_pb, @(x) isempty(x) || (isnumeric(x) && isscalar(x) && x >= 1));
+
+% parse and return the results
+p.parse(varargin{:});
+q = p.Results;
+
+end % funciton
+
+% [EOF]
\ No newline at end of file
@@ -0,0 +1,86 @@
+function [env_min, env_max, env_rms, t] = read_mef_envelope(this, start_end, width, varargin)
+% MULTISCALEELECTROPHYSIOLOGYFILE_3P0.READ_MEF_ENVELOPE Read the min/max envelope of the MEF 3.0 channel for a plot
+%	
+% Syntax:
+%   [env_min, env_max, env_rms, t] = read_mef_envelope(this, start_end, width)
+%   [env_min, env_max, env_rms, t] = read_mef_envelope(__, build_pyramid)
+% 
+% Input(s):
+%   this            - [obj] MultiscaleElectrophysiologyFile_3p0 object
+%   start_end       - [num] [start, end] of the range in uUTC (start
+%                     inclusive, end exclusive); [] for the whole channel
+%   width           - [num] number of bins (e.g. the pixel width of the
+%                     plot)
+%   build_pyramid   - [logical] (opt) build and save the envelope pyramids
+%                     of the segments that have none (default = false)
+%
+% Output(s): 
+%   env_min         - [num] 1 x width minimum of each bin (NaN where there
+%                     are no samples)
+%   env_max         - [num] 1 x width maximum of each bin
+%   env_rms         - [num] 1 x width RMS of each bin (NaN if answered
+%                     from the block indices)
+%   t               - [num] 1 x width start time of each bin (uUTC), only
+%                     if start_end is given
+%
+% Note:
+%   Zoomed-out views are answered from the block extrema of the time
+%   series indices without decoding any data; see read_envelope_3p0.
+%   Values are in native units (as read_mef_data).
+%
+% See also read_envelope_3p0, importSignal.
+
+% Copyright 2026 Richard J. Cui. Created: Sun 10/18/2026 10:12:37.415 AM
+% $Revision: 0.1 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+%
+% Rocky Creek Dr NE
+% Rochester, MN 55906, USA
+%
+% Email: richard.cui@utoronto.ca
+
+% =========================================================================
+% parse inputs
+% =========================================================================
+q = parseInputs(this, start_end, width, varargin{:});
+start_end = q.start_end;
+width = q.width;
+build_pyramid = q.build_pyramid;
+
+% =========================================================================
+% main
+% =========================================================================
+ch_path = fullfile(this.FilePath, this.FileName);
+pw = this.processPassword;
+[env_min, env_max, env_rms] = read_envelope_3p0(ch_path, pw, double(start_end),...
+    width, logical(build_pyramid)); % mex
+
+if isempty(start_end)
+    t = [];
+else
+    t = start_end(1) + (0:width-1) * (start_end(2) - start_end(1)) / width;
+end % if
+
+end
+
+% =========================================================================
+% subroutines
+% =========================================================================
+function q = parseInputs(varargin)
+
+% defaults
+default_bp = false; % build_pyramid
+
+% parse rules
+p = inputParser;
+p.addRequired('this', @isobject);
+p.addRequired('start_end', @(x) isempty(x) || (isnumeric(x) && numel(x) == 2));
+p.addRequired('width', @(x) isnumeric(x) && isscalar(x) && x >= 1);
+p.addOptional('build_pyramid', default_bp, @(x) islogical(x) || isnumeric(x));
+
+% parse and return the results
+p.parse(varargin{:});
+q = p.Results;
+
+end % funciton
+
+% [EOF]
\ No newline at end of file
@@ -0,0 +1,75 @@
+function epochs = read_mef_epochs(this, ranges, varargin)
+% MULTISCALEELECTROPHYSIOLOGYFILE_3P0.READ_MEF_EPOCHS Read many epochs of the MEF 3.0 channel in one call
+%	
+% Syntax:
+%   epochs = read_mef_epochs(this, ranges)
+%   epochs = read_mef_epochs(__, range_type)
+% 
+% Input(s):
+%   this            - [obj] MultiscaleElectrophysiologyFile_3p0 object
+%   ranges          - [num] N x 2 matrix, one epoch per row: first and last
+%                     sample (samples, 1-based using Matlab convention), or
+%                     start (inclusive) and end (exclusive) time in uUTC
+%                     (time)
+%   range_type      - [char] (opt) modality that is used to define the 
+%                     ranges, either 'time' in uUTC or 'samples'
+%                     (default = samples)
+%
+% Output(s): 
+%   epochs          - [num] N x L matrix of the epochs, one per row; [cell]
+%                     N x 1 if the epochs are not all of the same length
+%
+% Note:
+%   Reads all the epochs with the mex function read_epochs_3p0, which
+%   opens the channel once and decodes each block needed once, even if
+%   the epochs overlap. As with read_mef_data, missing samples are NaN.
+%
+% See also read_mef_data, read_epochs_3p0.
+
+% Copyright 2026 Richard J. Cui. Created: Sun 10/18/2026 10:12:37.415 AM
+% $Revision: 0.1 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+%
+% Rocky Creek Dr NE
+% Rochester, MN 55906, USA
+%
+% Email: richard.cui@utoronto.ca
+
+% =========================================================================
+% parse inputs
+% =========================================================================
+q = parseInputs(this, ranges, varargin{:});
+ranges = q.ranges;
+rtype = q.range_type;
+
+% =========================================================================
+% main
+% =========================================================================
+ch_path = fullfile(this.FilePath, this.FileName);
+pw = this.processPassword;
+epochs = read_epochs_3p0(ch_path, pw, rtype, double(ranges)); % mex
+
+end
+
+% =========================================================================
+% subroutines
+% =========================================================================
+function q = parseInputs(varargin)
+
+% defaults
+default_rt = 'samples'; % range_type
+
+expected_type = {'samples', 'time'};
+
+% parse rules
+p = inputParser;
+p.addRequired('this', @isobject);
+p.addRequired('ranges', @(x) isnumeric(x) && size(x, 2) == 2);
+p.addOptional('range_type', default_rt, @(x) any(validatestring(x, expected_type)));
+
+% parse and return the results
+p.parse(varargin{:});
+q = p.Results;
+
+end % funciton
+
+% [EOF]
\ No newline at end of file
@@ -1,7 +1,7 @@
 % Compile mex files required to process MEF files
 
 % Copyright 2019-2020 Richard J. Cui. Created: Wed 05/29/2019  9:49:29.694 PM
-% $Revision: 1.2 $  $Date: Fri 09/25/2020  9:41:56.944 AM $
+% $Revision: 1.14 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
 %
 % Rocky Creek Dr NE
 % Rochester, MN 55906, USA
@@ -37,7 +37,8 @@ fprintf('\n')
 fprintf('Building decompress_mef_2p1.mex*\n')
 mex('-output','decompress_mef_2p1',['-I' libmef_2p1],...
     fullfile(mexmef_2p1,'decompress_mef_mex_2p1.c'),...
-    fullfile(libmef_2p1,'mef_lib_2p1.c'))
+    fullfile(libmef_2p1,'mef_lib_2p1.c'),...
+    fullfile(libmef_2p1,'mef_reader_2p1.c'))
 movefile('decompress_mef_2p1.mex*',mexmef_2p1)
 
 cd(cur_dir)
@@ -48,22 +49,118 @@ cd(cur_dir)
 % get the directories of mef_3p0
 libmef_3p0 = fullfile(fileparts(fileparts(mex_mef)),'libmef','mef_3p0'); % library
 mexmef_3p0 = fullfile(mex_mef,'mef_3p0'); % mex
+% worker threads of meflib (POSIX threads, native threads on Windows)
+if isunix
+    thread_lib = {'-lpthread'};
+else
+    thread_lib = {};
+end % if
+% the gateways link against libmef3 when it has been built with the CMake
+% project in libmef (cmake -S . -B build), otherwise they are compiled with
+% its sources
+libmef_build = fullfile(fileparts(libmef_3p0),'build');
+if isunix && (~isempty(dir(fullfile(libmef_build,'libmef3.so'))) ...
+        || ~isempty(dir(fullfile(libmef_build,'libmef3.dylib'))))
+    libmef3 = {['-L' libmef_build],'-lmef3',...
+        ['LDFLAGS=$LDFLAGS -Wl,-rpath,' libmef_build]};
+else
+    libmef3 = {fullfile(libmef_3p0,'meflib.c'),...
+        fullfile(libmef_3p0,'mefrec.c'),...
+        fullfile(libmef_3p0,'mefreader.c')};
+end % if
 
 fprintf('\n')
 me_cprintf('Keywords','===== Compiling c-mex for MEF 3.0 data =====\n')
 fprintf('Building read_mef_info_3p0.mex*\n')
 mex('-output','read_mef_info_3p0',...
     ['-I' libmef_3p0],['-I' mexmef_3p0],...
-    fullfile(mexmef_3p0,'read_mef_info_mex_3p0.c'))
+    fullfile(mexmef_3p0,'read_mef_info_mex_3p0.c'),libmef3{:},thread_lib{:})
 movefile('read_mef_info_3p0.mex*',mexmef_3p0)
 
 fprintf('\n')
 fprintf('Building decompress_mef_3p0.mex*\n')
 mex('-output','decompress_mef_3p0',...
     ['-I' libmef_3p0],['-I' mexmef_3p0],...
-    fullfile(mexmef_3p0,'decompress_mef_mex_3p0.c'))
+    fullfile(mexmef_3p0,'decompress_mef_mex_3p0.c'),libmef3{:},thread_lib{:})
 movefile('decompress_mef_3p0.mex*',mexmef_3p0)
 
+fprintf('\n')
+fprintf('Building remove_line_noise_3p0.mex*\n')
+mex('-output','remove_line_noise_3p0',...
+    ['-I' libmef_3p0],['-I' mexmef_3p0],...
+    fullfile(mexmef_3p0,'remove_line_noise_mex_3p0.c'),libmef3{:},thread_lib{:})
+movefile('remove_line_noise_3p0.mex*',mexmef_3p0)
+
+fprintf('\n')
+fprintf('Building write_mef_session_3p0.mex*\n')
+mex('-output','write_mef_session_3p0',...
+    ['-I' libmef_3p0],['-I' mexmef_3p0],...
+    fullfile(mexmef_3p0,'write_mef_session_mex_3p0.c'),libmef3{:},thread_lib{:})
+movefile('write_mef_session_3p0.mex*',mexmef_3p0)
+
+fprintf('\n')
+fprintf('Building read_mef_records_3p0.mex*\n')
+mex('-output','read_mef_records_3p0',...
+    ['-I' libmef_3p0],['-I' mexmef_3p0],...
+    fullfile(mexmef_3p0,'read_mef_records_mex_3p0.c'),libmef3{:},thread_lib{:})
+movefile('read_mef_records_3p0.mex*',mexmef_3p0)
+
+fprintf('\n')
+fprintf('Building convert_sample_time_3p0.mex*\n')
+mex('-output','convert_sample_time_3p0',...
+    ['-I' libmef_3p0],['-I' mexmef_3p0],...
+    fullfile(mexmef_3p0,'convert_sample_time_mex_3p0.c'),libmef3{:},thread_lib{:})
+movefile('convert_sample_time_3p0.mex*',mexmef_3p0)
+
+fprintf('\n')
+fprintf('Building analyze_continuity_3p0.mex*\n')
+mex('-output','analyze_continuity_3p0',...
+    ['-I' libmef_3p0],['-I' mexmef_3p0],...
+    fullfile(mexmef_3p0,'analyze_continuity_mex_3p0.c'),libmef3{:},thread_lib{:})
+movefile('analyze_continuity_3p0.mex*',mexmef_3p0)
+
+fprintf('\n')
+fprintf('Building read_epochs_3p0.mex*\n')
+mex('-output','read_epochs_3p0',...
+    ['-I' libmef_3p0],['-I' mexmef_3p0],...
+    fullfile(mexmef_3p0,'read_epochs_mex_3p0.c'),libmef3{:},thread_lib{:})
+movefile('read_epochs_3p0.mex*',mexmef_3p0)
+
+fprintf('\n')
+fprintf('Building scan_signal_3p0.mex*\n')
+mex('-output','scan_signal_3p0',...
+    ['-I' libmef_3p0],['-I' mexmef_3p0],...
+    fullfile(mexmef_3p0,'scan_signal_mex_3p0.c'),libmef3{:},thread_lib{:})
+movefile('scan_signal_3p0.mex*',mexmef_3p0)
+
+fprintf('\n')
+fprintf('Building read_envelope_3p0.mex*\n')
+mex('-output','read_envelope_3p0',...
+    ['-I' libmef_3p0],['-I' mexmef_3p0],...
+    fullfile(mexmef_3p0,'read_envelope_mex_3p0.c'),libmef3{:},thread_lib{:})
+movefile('read_envelope_3p0.mex*',mexmef_3p0)
+
+fprintf('\n')
+fprintf('Building export_data_3p0.mex*\n')
+mex('-output','export_data_3p0',...
+    ['-I' libmef_3p0],['-I' mexmef_3p0],...
+    fullfile(mexmef_3p0,'export_data_mex_3p0.c'),libmef3{:},thread_lib{:})
+movefile('export_data_3p0.mex*',mexmef_3p0)
+
+fprintf('\n')
+fprintf('Building validate_session_3p0.mex*\n')
+mex('-output','validate_session_3p0',...
+    ['-I' libmef_3p0],['-I' mexmef_3p0],...
+    fullfile(mexmef_3p0,'validate_session_mex_3p0.c'),libmef3{:},thread_lib{:})
+movefile('validate_session_3p0.mex*',mexmef_3p0)
+
+fprintf('\n')
+fprintf('Building find_events_3p0.mex*\n')
+mex('-output','find_events_3p0',...
+    ['-I' libmef_3p0],['-I' mexmef_3p0],...
+    fullfile(mexmef_3p0,'find_events_mex_3p0.c'),libmef3{:},thread_lib{:})
+movefile('find_events_3p0.mex*',mexmef_3p0)
+
 cd(cur_dir)
 
 % [EOF]
\ No newline at end of file
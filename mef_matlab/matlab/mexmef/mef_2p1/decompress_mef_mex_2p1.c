@@ -20,200 +20,76 @@
 
 /* 
  modified by Richard J. Cui.
- $Revision: 0.6 $  $Date: Thu 09/24/2020  9:21:34.089 PM $
+ $Revision: 0.7 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
 
  Rocky Creek Dr NE
  Rochester, MN 55906, USA
  
  Email: richard.cui@utoronto.ca
  */
-//mex decomp_mef_mex_2p1.c mef_lib_2p1.c -o decomp_mef_2p1
+//mex decompress_mef_mex_2p1.c mef_lib_2p1.c mef_reader_2p1.c -output decompress_mef_2p1
 
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
 #include "mex.h"
-#include "mef_2p1.h"
+#include "mef_reader_2p1.h"
 
 #define BIG_ENDIAN_CODE		0
 #define LITTLE_ENDIAN_CODE	1
 
 void decomp_mef(char *f_name, unsigned long long int start_idx, unsigned long long int end_idx, int *decomp_data, char *password)
 {
-	char			*c;
-	unsigned char	*header;
-	int			    *dcdp, *temp_data_buf;
-	unsigned int	cpu_endianness, n_read, comp_data_len, bytes_decoded, tot_samples;
-	unsigned int	i, n_index_entries, tot_index_fields, kept_samples, skipped_samples;
-	unsigned long long int	start_block_file_offset, end_block_file_offset, start_block_idx, end_block_idx;
-	unsigned long long int	*index_data, last_block_len;
-    ui1             encryptionKey[240], *cdp, *comp_data, *last_block_p;
-    si1             *diff_buffer;
+	MEF_READER_2P1	*reader;
 	FILE			*fp;
-	MEF_HEADER_INFO		hdr_info;
-	RED_BLOCK_HDR_INFO	block_hdr;
-    
-	/* get cpu endianness */
-	cpu_endianness = 0;
-	c = (char *) &cpu_endianness;
-	*c = 1;
-	if (cpu_endianness != LITTLE_ENDIAN_CODE) {
+	long long int	n_failed;
+	
+	if (cpu_endianness() != LITTLE_ENDIAN_CODE) {
 		mexErrMsgIdAndTxt("decompress_mef_mex:decomp_mef",
                 "currently only compatible with little-endian machines => exiting");
 		return;
 	}
 	
-	/* read header */
-	fp = fopen(f_name, "rb");
-	if (fp == NULL) { 
-		mexErrMsgIdAndTxt("decompress_mef_mex:decomp_mef",
-                "could not open the file \"%s\" => exiting\n",  f_name);
-		return;
-	}
-	header = (unsigned char *) malloc(MEF_HEADER_LENGTH);  // malloc to ensure boundary alignment
-	n_read = (unsigned int) fread((void *) header, sizeof(char), (size_t) MEF_HEADER_LENGTH, fp);
-	if (n_read != MEF_HEADER_LENGTH) {
-		mexErrMsgIdAndTxt("decompress_mef_mex:decomp_mef",
-                "error reading the file \"%s\" => exiting\n",  f_name);
-		return;
-	}	
-	if ((read_mef_header_block(header, &hdr_info, password))) {
+	/* read header & index (libmef21 reader) */
+	reader = mef_reader_open(f_name, password);
+	if (reader == NULL) {
+		fp = fopen(f_name, "rb");
+		if (fp == NULL)
+			mexErrMsgIdAndTxt("decompress_mef_mex:decomp_mef",
+                    "could not open the file \"%s\" => exiting\n",  f_name);
+		fclose(fp);
 		mexErrMsgIdAndTxt("decompress_mef_mex:decomp_mef",
                 "header read error for file \"%s\" => exiting\n", f_name);
-		return;		
-	}
-	free(header); header=NULL;
-	
-	// showHeader(&hdr_info);
-	
-	/* get file endianness */
-	if (hdr_info.byte_order_code != LITTLE_ENDIAN_CODE) {
-		mexErrMsgIdAndTxt("decompress_mef_mex:decomp_mef",
-                "currently only compatible with little-endian files (file \"%s\") => exiting");
-		return;
-	}
-
-	if (hdr_info.data_encryption_used)
-		AES_KeyExpansion(4, 10, encryptionKey, hdr_info.session_password); 
-	else
-		*encryptionKey = 0;
-	
-	/* read in index data */
-	n_index_entries = (unsigned int) hdr_info.number_of_index_entries;
-	fseek(fp, (long int) hdr_info.index_data_offset, SEEK_SET);
-	tot_index_fields = n_index_entries * 3;	// 3 fields per entry
-	index_data = (unsigned long long int *) malloc(tot_index_fields * sizeof(unsigned long long int));
-	if (index_data == NULL) {
-		mexErrMsgIdAndTxt("decompress_mef_mex:decomp_mef",
-                "could not allocate enough memory for file \"%s\" => exiting\n", f_name);
 		return;
 	}
+	reader->validate_CRC = MEF_FALSE;  // as before, blocks are decoded without checking their CRC
 	
-	n_read = (unsigned int) fread(index_data, sizeof(unsigned long long int), (size_t) tot_index_fields, fp);
-	if (n_read != tot_index_fields) {
-		mexErrMsgIdAndTxt("decompress_mef_mex:decomp_mef",
-                "error reading index data for file \"%s\" => exiting\n", f_name);
-		return;
-	}		
-
-    /* find block containing start of requested range */
-	if (start_idx >= hdr_info.number_of_samples) {
+	/* check the requested range */
+	if (start_idx >= reader->header.number_of_samples) {
+		mef_reader_close(reader);
 		mexErrMsgIdAndTxt("decompress_mef_mex:decomp_mef",
                 "start index for file \"%s\" exceeds the number of samples in the file => exiting\n", f_name);
 		return;
 	}
-	for (i = 2; i < tot_index_fields; i += 3)
-		if (index_data[i] > start_idx)
-			break;
-	i -= 3; // rewind one triplet
-	start_block_idx = index_data[i]; // sample index of start of block containing start index
-	start_block_file_offset = index_data[i - 1];  // file offset of block containing start index
-	
-	/* find block containing end of requested range */
-	if (end_idx >= hdr_info.number_of_samples) {
+	if (end_idx >= reader->header.number_of_samples) {
+		mef_reader_close(reader);
 		mexErrMsgIdAndTxt("decompress_mef_mex:decomp_mef",
                 "end index for file \"%s\" exceeds the number of samples in the file => tail values will be zeros\n", f_name);
-		end_idx = hdr_info.number_of_samples - 1;
-	}
-	for (; i < tot_index_fields; i += 3)
-		if (index_data[i] > end_idx)
-			break;
-	i -= 3; // rewind one triplet
-	end_block_idx = index_data[i]; // sample index of start of block containing end index
-	end_block_file_offset = index_data[i - 1];  // file offset of block containing end index
-
-	if (i == (tot_index_fields - 1))
-		last_block_len = hdr_info.index_data_offset - end_block_file_offset;  // file offset of index data
-	else
-		last_block_len = index_data[i + 2] - end_block_file_offset;  // file offset of next block
-	free(index_data); index_data=NULL;
-	
-	/* allocate input buffer */
-	comp_data_len = (unsigned int) (end_block_file_offset - start_block_file_offset + last_block_len);
-	comp_data = (ui1 *) malloc(comp_data_len); 
-	if (comp_data == NULL) {
-		mexErrMsgIdAndTxt("decompress_mef_mex:decomp_mef",
-                "could not allocate enough memory for file \"%s\" => exiting\n", f_name);
 		return;
 	}
-    
-	/* read in compressed data */
-	fseek(fp, (long int) start_block_file_offset, SEEK_SET);
-	n_read = (unsigned int) fread(comp_data, sizeof(char), (size_t) comp_data_len, fp);
-	if (n_read != comp_data_len) {
-		mexErrMsgIdAndTxt("decompress_mef_mex:decomp_mef",
-                "error reading data for file \"%s\" => exiting\n", f_name);
-		return;
-	}
-	fclose(fp);
-		
-	/* decompress data */
-	// decode first block to temp array
-	cdp = comp_data;  
-	diff_buffer = (si1 *) malloc(hdr_info.maximum_block_length * 4);
-	temp_data_buf = (int *) malloc(hdr_info.maximum_block_length * 4);
-	bytes_decoded = (unsigned int) RED_decompress_block(cdp, temp_data_buf, diff_buffer, encryptionKey, 0, hdr_info.data_encryption_used, &block_hdr);
-	cdp += bytes_decoded;
 	
-	// copy requested samples from first block to output buffer
-	skipped_samples = (unsigned int) (start_idx - start_block_idx);
-	if (skipped_samples > block_hdr.sample_count) {
-		//this is bad- likely means idx data is corrupt 
+	/* decompress data (one read of the blocks, decoded straight into the output) */
+	n_failed = (long long int) mef_reader_decode(reader, (ui8) start_idx, (ui8) end_idx + 1, (si4 *) decomp_data);
+	mef_reader_close(reader);
+	if (n_failed < 0) {
 		mexErrMsgIdAndTxt("decompress_mef_mex:decomp_mef",
-                "block indexing error: decoded %d samples, attempting to skip %lu samples\n", block_hdr.sample_count, skipped_samples);
-		return;
-	}
-	kept_samples = block_hdr.sample_count - skipped_samples;
-	tot_samples = (unsigned int) (end_idx - start_idx + 1);
-	if (kept_samples >= tot_samples) { // start and end indices in same block => already done
-		memcpy((void *) decomp_data, (void *) (temp_data_buf + skipped_samples), tot_samples * sizeof(int));
-		free(comp_data);
+                "error reading data for file \"%s\" => exiting\n", f_name);
 		return;
 	}
-	memcpy((void *) decomp_data, (void *) (temp_data_buf + skipped_samples), kept_samples * sizeof(int));
-	dcdp = decomp_data + kept_samples;
-	last_block_p = comp_data + (unsigned int) (end_block_file_offset - start_block_file_offset);
-  //  printf("end_block_file_offset = %lu, start_block_file_offset = %lu\n", end_block_file_offset, start_block_file_offset);
-    
-	while (cdp < last_block_p) {
-        read_RED_block_header(cdp, &block_hdr);
-		bytes_decoded = (unsigned int) RED_decompress_block(cdp, dcdp, diff_buffer, encryptionKey, 0, hdr_info.data_encryption_used, &block_hdr);
-        fflush(stdout);
-		cdp += bytes_decoded;
-		dcdp += block_hdr.sample_count; 
-	}
-	
-	// decode last block to temp array
-	(void) RED_decompress_block(cdp, temp_data_buf, diff_buffer, encryptionKey, 0, hdr_info.data_encryption_used, &block_hdr);
-
-	// copy requested samples from last block to output buffer
-	kept_samples = (unsigned int) (end_idx - end_block_idx + 1);
-	memcpy((void *) dcdp, (void *) temp_data_buf, kept_samples * sizeof(int));
-	    
-	free(comp_data); comp_data=NULL;
-	free(diff_buffer); diff_buffer=NULL;
-	free(temp_data_buf); temp_data_buf=NULL;
+	if (n_failed > 0)
+		mexWarnMsgIdAndTxt("decompress_mef_mex:decomp_mef",
+                "%lld block(s) of file \"%s\" could not be decoded", n_failed, f_name);
 
 	return;
 }
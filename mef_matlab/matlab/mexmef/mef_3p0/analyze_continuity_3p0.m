@@ -0,0 +1,57 @@
+function [cont, channel_names] = analyze_continuity_3p0(mef_path,password)
+% ANALYZE_CONTINUITY_3P0 Analyze continuity of sampling of MEF 3.0 channel(s)
+% 
+% Syntax:
+%   [cont, channel_names] = analyze_continuity_3p0(mef_path)
+%   [cont, channel_names] = analyze_continuity_3p0(__,password)
+% 
+% Imput(s):
+%   mef_path        - [char] path to a MEF 3.0 time series channel folder
+%                     (.timd), or to a session folder (.mefd) to analyze
+%                     all its time series channels in one pass
+%   password        - [char] (opt) password of the MEF 3.0 data; empty if
+%                     not encrypted (default = [])
+% 
+% Output(s):
+%   cont            - [num] N x 9 matrix of the segments of continuity of
+%                     the channel, columns as the variables of the table
+%                     of analyzeContinuity (SegmentStart, BlockStart,
+%                     SegmentEnd, BlockEnd, SampleTimeStart, SampleTimeEnd,
+%                     SampleIndexStart, SampleIndexEnd, SegmentLength);
+%                     for a session, [cell] 1 x C, one matrix per time
+%                     series channel
+%   channel_names   - [cell] 1 x C names of the channels
+% 
+% Note:
+%   This is a dummy function to check if the mex function has been
+%   compiled. If not, it will try to compile it.
+%
+%   The segments of continuity are computed from the time series indices
+%   directly (a gap of more than 1 uUTC between the end of a block and the
+%   start of the next one starts a new segment); no data are read.
+% 
+% See also analyzeContinuity, convert_sample_time_3p0.
+
+% Copyright 2026 Richard J. Cui. Created: Sun 10/18/2026 10:12:37.415 AM
+% $Revision: 0.1 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+%
+% Rocky Creek Dr NE
+% Rochester, MN 55906, USA
+%
+% Email: richard.cui@utoronto.ca
+
+% compile c-mex function
+% -----------------------
+% we are here, cuz we don't have the mex function compiled. So, do it now
+make_mex_mef
+
+% now analyze the continuity
+% --------------------------
+if nargin < 2
+    password = [];
+end % if
+[cont, channel_names] = analyze_continuity_3p0(mef_path,password);
+
+end % funciton
+
+% [EOF]
\ No newline at end of file
@@ -0,0 +1,189 @@
+/**
+*     @file
+*     MEF 3.0 Library Matlab Wrapper
+*     Analyze the continuity of sampling of a MEF 3.0 time series channel, or of all the channels of a session, from the
+*     time series indices
+*
+*  This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+*  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+*  This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*  You should have received a copy of the GNU General Public License along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//  Copyright (c) Richard J. Cui Created: Sun 10/18/2026 10:12:37.415 AM
+//  $Revision: 0.3 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+//
+//  Rocky Creek Dr NE
+//  Rochester, MN 55906, USA
+//
+//  Email: richard.cui@utoronto.ca
+
+#include "mex.h"
+#include "mef_mex_3p0.h"
+
+//  columns of the continuity table (as the VariableNames of analyzeContinuity.m)
+#define CONTINUITY_TABLE_NUMBER_OF_COLUMNS  9
+
+/**
+ *     Map the continuity index of a time series channel to a continuity table matrix
+ *
+ *  One row per segment of continuous sampling, with the columns SegmentStart, BlockStart, SegmentEnd, BlockEnd,
+ *  SampleTimeStart, SampleTimeEnd, SampleIndexStart, SampleIndexEnd and SegmentLength. Segment, block and sample
+ *  indices start at one (Matlab convention); sample times are in uUTC.
+ *
+ *     @param channel          Pointer to the MEF channel object (time series indices read)
+ *     @return                 N x 9 double matrix
+ */
+mxArray *map_mef3_continuity(CHANNEL *channel) {
+    CONTINUITY_INDEX    continuity_index = {0};
+    CONTINUITY_ENTRY    *entry;
+    si8                 i, n;
+
+    (void) CONTINUITY_build_index(channel, &continuity_index);
+    n = continuity_index.number_of_entries;
+
+    mxArray *mat_cont = mxCreateDoubleMatrix((mwSize) n, CONTINUITY_TABLE_NUMBER_OF_COLUMNS, mxREAL);
+    sf8 *col = mxGetPr(mat_cont);
+    for (i = 0; i < n; ++i) {
+        entry = continuity_index.entries + i;
+        col[i]         = (sf8) (entry->start_segment + 1);
+        col[i + n]     = (sf8) (entry->start_block + 1);
+        col[i + 2 * n] = (sf8) (entry->end_segment + 1);
+        col[i + 3 * n] = (sf8) (entry->end_block + 1);
+        col[i + 4 * n] = (sf8) entry->start_time;
+        col[i + 5 * n] = entry->end_time;
+        col[i + 6 * n] = (sf8) (entry->start_sample + 1);
+        col[i + 7 * n] = (sf8) (entry->end_sample + 1);
+        col[i + 8 * n] = (sf8) entry->number_of_samples;
+    }
+    CONTINUITY_free_index(&continuity_index, MEF_FALSE);
+
+    return mat_cont;
+}
+
+//  the gate function
+/**
+* Main entry point for 'analyze_continuity_3p0'
+*
+* @param path           Path (absolute or relative) to a MEF3 time series channel folder (.timd), or to a session
+*                       folder (.mefd) to analyze all its time series channels in one pass
+* @param password       (optional) Password to the MEF3 data; Pass empty string/variable if not encrypted
+* @return               [continuity, channelNames]: the N x 9 continuity table matrix of the channel, or for a session
+*                       a 1 x C cell array with one matrix per time series channel; and the channel names (cell array)
+*/
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
+
+    //
+    // path
+    //
+    if (nrhs < 1) {
+        mexErrMsgIdAndTxt( "MATLAB:analyze_continuity_mex_3p0:noPathArg", "path input argument not set");
+    }
+    if (!mxIsChar(prhs[0]) || mxIsEmpty(prhs[0])) {
+        mexErrMsgIdAndTxt( "MATLAB:analyze_continuity_mex_3p0:invalidPathArg", "path input argument invalid, should be a non-empty string (array of characters)");
+    }
+    si1 path[MEF_FULL_FILE_NAME_BYTES];
+    char *mat_path = mxArrayToString(prhs[0]);
+    MEF_strncpy(path, mat_path, MEF_FULL_FILE_NAME_BYTES);
+    mxFree(mat_path);
+
+    // strip trailing separators; a session path ends with the session extension
+    si4 len = (si4) strlen(path);
+    while (len > 1 && (path[len - 1] == '/' || path[len - 1] == '\\'))
+        path[--len] = 0;
+    si1 is_session = (len >= TYPE_BYTES && strcmp(path + len - TYPE_BYTES, "." SESSION_DIRECTORY_TYPE_STRING) == 0) ? MEF_TRUE : MEF_FALSE;
+
+    //
+    // password (optional)
+    //
+    si1 *password = NULL;
+    si1 password_arr[PASSWORD_BYTES] = {0};
+    if (nrhs > 1 && !mxIsEmpty(prhs[1])) {
+        if (!mxIsChar(prhs[1])) {
+            mexErrMsgIdAndTxt( "MATLAB:analyze_continuity_mex_3p0:invalidPasswordArg", "password input argument invalid, should string (array of characters)");
+        }
+        char *mat_password = mxArrayToString(prhs[1]);
+        MEF_strncpy(password_arr, mat_password, PASSWORD_BYTES);
+        mxFree(mat_password);
+        password = password_arr;
+    }
+
+    //
+    // read the metadata & time series indices (no data)
+    //
+
+    // initialize MEF library
+    (void) initialize_meflib();
+    static MEF_CONTEXT call_context;  // this call's context: the default context is shared by the gateways & threads
+    MEF_initialize_context(&call_context, NULL);
+    (void) MEF_set_context(&call_context);
+
+    MEF_context->behavior_on_fail = SUPPRESS_ERROR_OUTPUT;
+    if (is_session == MEF_TRUE) {
+        SESSION *session = read_MEF_session(NULL, path, password, NULL, MEF_FALSE, MEF_FALSE);
+        MEF_context->behavior_on_fail = EXIT_ON_FAIL;
+        if (session == NULL) {
+            mexErrMsgIdAndTxt( "MATLAB:analyze_continuity_mex_3p0:readFailed", "Error while reading session metadata");
+        }
+        if (session->time_series_metadata.section_1 != NULL && session->time_series_metadata.section_1->section_2_encryption > 0) {
+            free_session(session, MEF_TRUE);
+            if (password == NULL)
+                mexErrMsgIdAndTxt( "MATLAB:analyze_continuity_mex_3p0:encrypted", "Error: data is encrypted, but no password is given");
+            else
+                mexErrMsgIdAndTxt( "MATLAB:analyze_continuity_mex_3p0:wrongPassword", "Error: wrong password for encrypted data");
+        }
+
+        // one table per time series channel, in the order of read_mef_info_3p0
+        si4 n_chans = session->number_of_time_series_channels;
+        mxArray *mat_conts = mxCreateCellMatrix(1, (mwSize) n_chans);
+        mxArray *mat_names = mxCreateCellMatrix(1, (mwSize) n_chans);
+        for (si4 i = 0; i < n_chans; ++i) {
+            mxSetCell(mat_conts, (mwIndex) i, map_mef3_continuity(session->time_series_channels + i));
+            mxSetCell(mat_names, (mwIndex) i, mxCreateString(session->time_series_channels[i].name));
+        }
+        free_session(session, MEF_TRUE);
+
+        plhs[0] = mat_conts;
+        if (nlhs > 1)
+            plhs[1] = mat_names;
+        else
+            mxDestroyArray(mat_names);
+
+    } else {
+        CHANNEL *channel = read_MEF_channel(NULL, path, TIME_SERIES_CHANNEL_TYPE, password, NULL, MEF_FALSE, MEF_FALSE);
+        MEF_context->behavior_on_fail = EXIT_ON_FAIL;
+        if (channel == NULL || channel->number_of_segments == 0) {
+            if (channel != NULL)
+                free_channel(channel, MEF_TRUE);
+            mexErrMsgIdAndTxt( "MATLAB:analyze_continuity_mex_3p0:readFailed", "Error: no segments in channel, most likely due to an invalid channel folder");
+        }
+        if (channel->channel_type != TIME_SERIES_CHANNEL_TYPE) {
+            free_channel(channel, MEF_TRUE);
+            mexErrMsgIdAndTxt( "MATLAB:analyze_continuity_mex_3p0:invalidChannel", "Error: not a time series channel");
+        }
+        channel->segments[0].metadata_fps->directives.free_password_data = MEF_TRUE;
+        if (channel->metadata.section_1->section_2_encryption > 0) {
+            free_channel(channel, MEF_TRUE);
+            if (password == NULL)
+                mexErrMsgIdAndTxt( "MATLAB:analyze_continuity_mex_3p0:encrypted", "Error: data is encrypted, but no password is given");
+            else
+                mexErrMsgIdAndTxt( "MATLAB:analyze_continuity_mex_3p0:wrongPassword", "Error: wrong password for encrypted data");
+        }
+
+        plhs[0] = map_mef3_continuity(channel);
+        if (nlhs > 1) {
+            plhs[1] = mxCreateCellMatrix(1, 1);
+            mxSetCell(plhs[1], 0, mxCreateString(channel->name));
+        }
+        free_channel(channel, MEF_TRUE);
+    }
+
+    (void) MEF_set_context(NULL);
+
+    // succesfull return from call
+    return;
+
+}
+
+// [EOF]
@@ -0,0 +1,68 @@
+function [converted, sampled] = convert_sample_time_3p0(channel_path,password,values,direction,continuity,sampling_frequency)
+% CONVERT_SAMPLE_TIME_3P0 Convert sample times to indices (and back) of a MEF 3.0 channel
+% 
+% Syntax:
+%   [converted, sampled] = convert_sample_time_3p0(channel_path,password,values)
+%   [converted, sampled] = convert_sample_time_3p0(__,direction)
+%   [converted, sampled] = convert_sample_time_3p0(__,direction,continuity,sampling_frequency)
+% 
+% Imput(s):
+%   channel_path    - [char] path to the MEF 3.0 channel folder
+%   password        - [char] password of the MEF 3.0 data; empty if not
+%                     encrypted
+%   values          - [num array] sample times (uUTC) or sample indices
+%                     (start at 1, using Matlab convention)
+%   direction       - [char] (opt) 'time2index' (default) or 'index2time'
+%   continuity      - [num] (opt) N x 9 matrix of the segments of
+%                     continuity of the channel (as analyze_continuity_3p0,
+%                     or the Continuity table of the channel object); if
+%                     given, the channel is not read (default = [])
+%   sampling_frequency - [num] (opt) sampling frequency of the channel
+%                     (Hz); required with continuity
+% 
+% Output(s):
+%   converted       - [double array] sample indices or sample times (uUTC),
+%                     same size as values; NaN for times not in any segment
+%                     of continuity
+%   sampled         - [logical array] true: the value corresponds to
+%                     physically collected data
+% 
+% Note:
+%   This is a dummy function to check if the mex function has been
+%   compiled. If not, it will try to compile it.
+%
+%   The segments of continuity are built from the time series indices of
+%   the channel, unless given, and searched once per value (merged with
+%   the values if sorted), with the rounding of SampleTime2Index and
+%   SampleIndex2Time.
+% 
+% See also SampleTime2Index, SampleIndex2Time.
+
+% Copyright 2026 Richard J. Cui. Created: Sun 10/18/2026 10:12:37.415 AM
+% $Revision: 0.2 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+%
+% Rocky Creek Dr NE
+% Rochester, MN 55906, USA
+%
+% Email: richard.cui@utoronto.ca
+
+% compile c-mex function
+% -----------------------
+% we are here, cuz we don't have the mex function compiled. So, do it now
+make_mex_mef
+
+% now convert the values
+% ----------------------
+if nargin < 4
+    direction = 'time2index';
+end % if
+if nargin < 6
+    continuity = [];
+    sampling_frequency = [];
+end % if
+[converted, sampled] = convert_sample_time_3p0(channel_path,password,values,direction,...
+    continuity,sampling_frequency);
+
+end % funciton
+
+% [EOF]
\ No newline at end of file
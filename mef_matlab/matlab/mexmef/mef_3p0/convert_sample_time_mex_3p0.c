@@ -0,0 +1,236 @@
+/**
+*     @file
+*     MEF 3.0 Library Matlab Wrapper
+*     Convert sample times to sample indices (and back) over the continuity index of a MEF 3.0 time series channel
+*
+*  This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+*  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+*  This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*  You should have received a copy of the GNU General Public License along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//  Copyright (c) Richard J. Cui Created: Sun 10/18/2026 10:12:37.415 AM
+//  $Revision: 0.3 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+//
+//  Rocky Creek Dr NE
+//  Rochester, MN 55906, USA
+//
+//  Email: richard.cui@utoronto.ca
+
+#include "mex.h"
+#include "mef_mex_3p0.h"
+
+//  columns of the continuity table (as the VariableNames of analyzeContinuity.m)
+#define CONTINUITY_TABLE_NUMBER_OF_COLUMNS  9
+
+/**
+ *     Map a continuity table matrix back to a continuity index (the inverse of map_mef3_continuity)
+ *
+ *  The sample indices are kept 1-based (Matlab convention), as the conversion expects them.
+ *
+ *     @param mat_cont             N x 9 double matrix, as analyzeContinuity / analyze_continuity_3p0
+ *     @param sampling_frequency   Sampling frequency of the channel (Hz)
+ *     @param continuity_index     Pointer to the continuity index to fill (free with CONTINUITY_free_index)
+ *     @return                     The continuity index
+ */
+CONTINUITY_INDEX *map_continuity_table(const mxArray *mat_cont, sf8 sampling_frequency, CONTINUITY_INDEX *continuity_index) {
+    CONTINUITY_ENTRY    *entry;
+    si8                 i, n;
+
+    n = (si8) mxGetM(mat_cont);
+    sf8 *col = mxGetPr(mat_cont);
+    continuity_index->sampling_frequency = sampling_frequency;
+    continuity_index->number_of_entries = n;
+    continuity_index->entries = (CONTINUITY_ENTRY *) e_calloc((size_t) (n + 1), sizeof(CONTINUITY_ENTRY), __FUNCTION__, __LINE__, USE_GLOBAL_BEHAVIOR);
+    for (i = 0; i < n; ++i) {
+        entry = continuity_index->entries + i;
+        entry->start_segment     = (si4) col[i] - 1;
+        entry->start_block       = (si8) col[i + n] - 1;
+        entry->end_segment       = (si4) col[i + 2 * n] - 1;
+        entry->end_block         = (si8) col[i + 3 * n] - 1;
+        entry->start_time        = (si8) col[i + 4 * n];
+        entry->end_time          = col[i + 5 * n];
+        entry->start_sample      = (si8) col[i + 6 * n];
+        entry->end_sample        = (si8) col[i + 7 * n];
+        entry->number_of_samples = (si8) col[i + 8 * n];
+    }
+
+    return continuity_index;
+}
+
+/**
+ *     Build the continuity index of a time series channel from its time series indices
+ *
+ *  The sample indices are made 1-based (Matlab convention). Errors out (mexErrMsgIdAndTxt) if the channel cannot be read.
+ *
+ *     @param channel_path         Path to the MEF3 channel folder
+ *     @param password             Password to the MEF3 data (NULL if not encrypted)
+ *     @param continuity_index     Pointer to the continuity index to fill (free with CONTINUITY_free_index)
+ */
+void read_channel_continuity(si1 *channel_path, si1 *password, CONTINUITY_INDEX *continuity_index) {
+
+    MEF_context->behavior_on_fail = SUPPRESS_ERROR_OUTPUT;
+    CHANNEL *channel = read_MEF_channel(NULL, channel_path, TIME_SERIES_CHANNEL_TYPE, password, NULL, MEF_FALSE, MEF_FALSE);
+    MEF_context->behavior_on_fail = EXIT_ON_FAIL;
+    if (channel == NULL || channel->number_of_segments == 0) {
+        if (channel != NULL)
+            free_channel(channel, MEF_TRUE);
+        mexErrMsgIdAndTxt( "MATLAB:convert_sample_time_mex_3p0:readFailed", "Error: no segments in channel, most likely due to an invalid channel folder");
+    }
+    if (channel->channel_type != TIME_SERIES_CHANNEL_TYPE) {
+        free_channel(channel, MEF_TRUE);
+        mexErrMsgIdAndTxt( "MATLAB:convert_sample_time_mex_3p0:invalidChannel", "Error: not a time series channel");
+    }
+    if (channel->metadata.section_1->section_2_encryption > 0) {
+        channel->segments[0].metadata_fps->directives.free_password_data = MEF_TRUE;
+        free_channel(channel, MEF_TRUE);
+        if (password == NULL)
+            mexErrMsgIdAndTxt( "MATLAB:convert_sample_time_mex_3p0:encrypted", "Error: data is encrypted, but no password is given");
+        else
+            mexErrMsgIdAndTxt( "MATLAB:convert_sample_time_mex_3p0:wrongPassword", "Error: wrong password for encrypted data");
+    }
+
+    // the index is all that is needed from the channel
+    (void) CONTINUITY_build_index(channel, continuity_index);
+    channel->segments[0].metadata_fps->directives.free_password_data = MEF_TRUE;
+    free_channel(channel, MEF_TRUE);
+
+    // sample indices are 1-based in Matlab
+    for (si8 i = 0; i < continuity_index->number_of_entries; ++i) {
+        ++continuity_index->entries[i].start_sample;
+        ++continuity_index->entries[i].end_sample;
+    }
+
+
+    return;
+}
+
+//  the gate function
+/**
+* Main entry point for 'convert_sample_time_3p0'
+*
+* @param channelPath    Path (absolute or relative) to the MEF3 channel folder
+* @param password       Password to the MEF3 data; Pass empty string/variable if not encrypted
+* @param values         Array of sample times (uUTC) or sample indices (1-based, Matlab convention)
+* @param direction      (optional) 'time2index' (default) or 'index2time'
+* @param continuity     (optional) N x 9 continuity table matrix of the channel (as analyze_continuity_3p0, e.g. the
+*                       cached Continuity of the channel object); if given, the channel is not read
+* @param samplingFreq   (required with continuity) sampling frequency of the channel (Hz)
+* @return               [converted, sampled]: converted values (same size as values; NaN for times outside the sampled
+*                       data), and a logical array, true where the value corresponds to physically collected data
+*/
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
+
+    //
+    // channel path
+    //
+    if (nrhs < 3) {
+        mexErrMsgIdAndTxt( "MATLAB:convert_sample_time_mex_3p0:notEnoughArgs", "channelPath, password and values input arguments must be set");
+    }
+    if (!mxIsChar(prhs[0]) || mxIsEmpty(prhs[0])) {
+        mexErrMsgIdAndTxt( "MATLAB:convert_sample_time_mex_3p0:invalidChannelPathArg", "channelPath input argument invalid, should be a non-empty string (array of characters)");
+    }
+    si1 channel_path[MEF_FULL_FILE_NAME_BYTES];
+    char *mat_channel_path = mxArrayToString(prhs[0]);
+    MEF_strncpy(channel_path, mat_channel_path, MEF_FULL_FILE_NAME_BYTES);
+    mxFree(mat_channel_path);
+
+    //
+    // password
+    //
+    si1 *password = NULL;
+    si1 password_arr[PASSWORD_BYTES] = {0};
+    if (!mxIsEmpty(prhs[1])) {
+        if (!mxIsChar(prhs[1])) {
+            mexErrMsgIdAndTxt( "MATLAB:convert_sample_time_mex_3p0:invalidPasswordArg", "password input argument invalid, should string (array of characters)");
+        }
+        char *mat_password = mxArrayToString(prhs[1]);
+        MEF_strncpy(password_arr, mat_password, PASSWORD_BYTES);
+        mxFree(mat_password);
+        password = password_arr;
+    }
+
+    //
+    // values & direction
+    //
+    if (!mxIsNumeric(prhs[2]) || mxIsComplex(prhs[2])) {
+        mexErrMsgIdAndTxt( "MATLAB:convert_sample_time_mex_3p0:invalidValuesArg", "values input argument invalid; should be a real numeric array");
+    }
+    si1 to_index = MEF_TRUE;
+    if (nrhs > 3 && !mxIsEmpty(prhs[3])) {
+        char direction[16] = {0};
+        if (!mxIsChar(prhs[3]) || mxGetString(prhs[3], direction, sizeof(direction)) != 0) {
+            mexErrMsgIdAndTxt( "MATLAB:convert_sample_time_mex_3p0:invalidDirectionArg", "direction input argument invalid; should be 'time2index' or 'index2time'");
+        }
+        if (strcasecmp(direction, "index2time") == 0) {
+            to_index = MEF_FALSE;
+        } else if (strcasecmp(direction, "time2index") != 0) {
+            mexErrMsgIdAndTxt( "MATLAB:convert_sample_time_mex_3p0:invalidDirectionArg", "direction input argument invalid; should be 'time2index' or 'index2time'");
+        }
+    }
+
+    //
+    // continuity table (optional)
+    //
+    const mxArray *mat_cont = NULL;
+    sf8 sampling_frequency = 0.0;
+    if (nrhs > 4 && !mxIsEmpty(prhs[4])) {
+        if (!mxIsDouble(prhs[4]) || mxIsComplex(prhs[4]) || mxGetNumberOfDimensions(prhs[4]) != 2 || mxGetN(prhs[4]) != CONTINUITY_TABLE_NUMBER_OF_COLUMNS) {
+            mexErrMsgIdAndTxt( "MATLAB:convert_sample_time_mex_3p0:invalidContinuityArg", "continuity input argument invalid; should be an N x 9 double matrix (as analyze_continuity_3p0)");
+        }
+        if (nrhs < 6 || !mxIsNumeric(prhs[5]) || mxGetNumberOfElements(prhs[5]) != 1 || !(mxGetScalar(prhs[5]) > 0.0)) {
+            mexErrMsgIdAndTxt( "MATLAB:convert_sample_time_mex_3p0:invalidSamplingFreqArg", "samplingFreq input argument invalid; should be a positive number when continuity is given");
+        }
+        mat_cont = prhs[4];
+        sampling_frequency = mxGetScalar(prhs[5]);
+    }
+
+    // work in doubles (MEF times fit exactly up to 2^53 uUTC)
+    si8 n_values = (si8) mxGetNumberOfElements(prhs[2]);
+    mxArray *mat_values = mxIsDouble(prhs[2]) ? (mxArray *) prhs[2] : NULL;
+    if (mat_values == NULL) {
+        mxArray *mat_in = (mxArray *) prhs[2];
+        mexCallMATLAB(1, &mat_values, 1, &mat_in, "double");
+    }
+
+    // initialize MEF library
+    (void) initialize_meflib();
+    static MEF_CONTEXT call_context;  // this call's context: the default context is shared by the gateways & threads
+    MEF_initialize_context(&call_context, NULL);
+    (void) MEF_set_context(&call_context);
+
+    // the continuity index, from the table if given (sample indices already 1-based)
+    CONTINUITY_INDEX continuity_index = {0};
+    if (mat_cont != NULL)
+        (void) map_continuity_table(mat_cont, sampling_frequency, &continuity_index);
+    else
+        read_channel_continuity(channel_path, password, &continuity_index);
+
+    //
+    // convert
+    //
+    mxArray *mat_converted = mxCreateNumericArray(mxGetNumberOfDimensions(prhs[2]), mxGetDimensions(prhs[2]), mxDOUBLE_CLASS, mxREAL);
+    mxArray *mat_sampled = mxCreateLogicalArray(mxGetNumberOfDimensions(prhs[2]), mxGetDimensions(prhs[2]));
+    if (to_index == MEF_TRUE)
+        CONTINUITY_times_to_samples(&continuity_index, mxGetPr(mat_values), n_values, mxGetPr(mat_converted), (ui1 *) mxGetLogicals(mat_sampled));
+    else
+        CONTINUITY_samples_to_times(&continuity_index, mxGetPr(mat_values), n_values, mxGetPr(mat_converted), (ui1 *) mxGetLogicals(mat_sampled));
+    CONTINUITY_free_index(&continuity_index, MEF_FALSE);
+    if (mat_values != prhs[2])
+        mxDestroyArray(mat_values);
+
+    plhs[0] = mat_converted;
+    if (nlhs > 1)
+        plhs[1] = mat_sampled;
+    else
+        mxDestroyArray(mat_sampled);
+
+    (void) MEF_set_context(NULL);
+
+    // succesfull return from call
+    return;
+
+}
+
+// [EOF]
@@ -1,8 +1,12 @@
-function data = decompress_mef_3p0(ch_path,pw,rtype,begin,stop)
+function [data,profile] = decompress_mef_3p0(varargin)
 % decompress_mef_3p0 Read data for a single channle of MEF 3.0 session
 % 
 % Syntax:
 %   data = decompress_mef_3p0(ch_path,pw,rtype,begin,stop)
+%   [data,profile] = decompress_mef_3p0(ch_path,pw,rtype,begin,stop)
+%   cache = decompress_mef_3p0('-cache')
+%   cache = decompress_mef_3p0('-cache',max_bytes)
+%   cache = decompress_mef_3p0('-cache','clear')
 % 
 % Imput(s):
 %   ch_pass         - [str] channel path of a MEF 3.0 session
@@ -11,18 +15,35 @@ function data = decompress_mef_3p0(ch_path,pw,rtype,begin,stop)
 %                     to be read ('samples', 'time')
 %   begin           - [num] begin point
 %   stop            - [num] stop point
+%   max_bytes       - [num] budget of the decoded block cache in bytes (0
+%                     disables it)
 % 
 % Output(s):
 %   data            - [array] channel data
+%   profile         - [struct] (opt) where the time of the read went,
+%                     collected only if asked for:
+%                     .wall_time, .cpu_time : [num] whole read (sec)
+%                     .open, .read, .crc, .aes, .decode, .convert :
+%                       [struct] per phase wall_time and cpu_time (sec,
+%                       summed over threads) and calls
+%                     .bytes_read, .blocks_decoded, .crc_failures,
+%                     .allocations, .allocated_bytes : [num] counts
+%   cache           - [struct] state of the decoded block cache:
+%                     maximum_bytes, bytes, entries, hits, misses and
+%                     evictions
 % 
 % Note:
 %   This is a dummy function to check if the mex function has been
 %   compiled. If not, it will try to compile it.
+%
+%   The decoded blocks are kept in a cache (256 MB by default) until the
+%   mex function is cleared, so reads of overlapping ranges only decode
+%   the blocks not read before.
 % 
 % See also multiscaleelectrophysiologyfile_3p0.read_mef_data.
 
 % Copyright 2020 Richard J. Cui. Created: Mon 11/02/2020  3:44:14.289 PM
-% $Revision: 0.1 $  $Date: Mon 11/02/2020  3:44:14.289 PM $
+% $Revision: 0.3 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
 %
 % Rocky Creek Dr NE
 % Rochester, MN 55906, USA
@@ -36,7 +57,11 @@ make_mex_mef
 
 % now get the data
 % ----------------
-data = decompress_mef_3p0(ch_path,pw,rtype,begin,stop);
+if nargout > 1
+    [data,profile] = decompress_mef_3p0(varargin{:});
+else
+    data = decompress_mef_3p0(varargin{:});
+end % if
 
 end % funciton
 
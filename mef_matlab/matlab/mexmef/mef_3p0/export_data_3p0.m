@@ -0,0 +1,57 @@
+function [pnts, failed_blocks] = export_data_3p0(ch_paths,pw,range,file_path,chunk_samples)
+% EXPORT_DATA_3P0 Export MEF 3.0 channels to a float32 data file, chunk by chunk
+% 
+% Syntax:
+%   [pnts, failed_blocks] = export_data_3p0(ch_paths,pw,range,file_path)
+%   [pnts, failed_blocks] = export_data_3p0(__,chunk_samples)
+% 
+% Imput(s):
+%   ch_paths        - [str/cell] channel path(s) of a MEF 3.0 session
+%   pw              - [str] password for the desired level
+%   range           - [num] [first, last] sample to export (1-based,
+%                     inclusive)
+%   file_path       - [str] path of the data file to write (overwritten)
+%   chunk_samples   - [num] (opt) number of samples per channel decoded
+%                     and written at a time (default = 65536)
+% 
+% Output(s):
+%   pnts            - [num] number of samples written per channel
+%   failed_blocks   - [num] 1 x channels number of blocks that could not
+%                     be read (written as NaN)
+% 
+% Note:
+%   This is a dummy function to check if the mex function has been
+%   compiled. If not, it will try to compile it.
+%
+%   The file is written in the layout of an EEGLAB .fdt file: single
+%   precision, channels x samples, column-major (i.e. all channels of the
+%   first sample, then of the second...). Samples outside the channels
+%   (and unreadable blocks) are NaN. The channels of a chunk are decoded in
+%   parallel, so the memory used is bounded by the chunk size, not by the
+%   length of the range.
+% 
+% See also decompress_mef_3p0, export_sess.
+
+% Copyright 2026 Richard J. Cui. Created: Sun 10/18/2026 10:12:37.415 AM
+% $Revision: 0.1 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+%
+% Rocky Creek Dr NE
+% Rochester, MN 55906, USA
+%
+% Email: richard.cui@utoronto.ca
+
+% compile c-mex function
+% -----------------------
+% we are here, cuz we don't have the mex function compiled. So, do it now
+make_mex_mef
+
+% now export the data
+% -------------------
+if nargin < 5
+    chunk_samples = [];
+end % if
+[pnts, failed_blocks] = export_data_3p0(ch_paths,pw,range,file_path,chunk_samples);
+
+end % funciton
+
+% [EOF]
\ No newline at end of file
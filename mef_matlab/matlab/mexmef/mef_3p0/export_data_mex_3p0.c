@@ -0,0 +1,279 @@
+/**
+*     @file
+*     MEF 3.0 Library Matlab Wrapper
+*     Export a sample range of MEF 3.0 time series channels to a float32 data file (EEGLAB .fdt layout), chunk by chunk
+*
+*  This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+*  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+*  This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*  You should have received a copy of the GNU General Public License along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//  Copyright (c) Richard J. Cui Created: Sun 10/18/2026 10:12:37.415 AM
+//  $Revision: 0.3 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+//
+//  Rocky Creek Dr NE
+//  Rochester, MN 55906, USA
+//
+//  Email: richard.cui@utoronto.ca
+
+#include "mex.h"
+#include "mef_mex_3p0.h"
+
+//  default number of samples (per channel) decoded & written at a time
+#define EXPORT_DEFAULT_CHUNK_SAMPLES    65536
+
+/**
+ *  Arguments shared by all export tasks (one task per channel and chunk)
+ *
+ *  Note: the tasks run on worker threads, so they only use the C library; no MATLAB API calls
+ */
+typedef struct {
+    CHANNEL     **channels;
+    si8         number_of_channels;
+    si8         start_sample;           // first sample of the chunk (zero-based, in the channels)
+    si8         number_of_samples;      // samples in the chunk
+    si4         **thread_samples;       // decoding buffer of each worker (chunk samples each)
+    sf4         *data;                  // chunk output, number_of_channels x number_of_samples (column-major)
+    si8         *failed_blocks;         // blocks that could not be read, per channel
+} EXPORT_TASK_ARGS;
+
+/**
+ *     Decode a chunk of a single channel into the interleaved float output (thread task)
+ *
+ *  The samples are written with a stride of the number of channels, i.e. in the column-major
+ *  channels x samples layout of an EEGLAB .fdt file; gaps and unreadable blocks become NaN.
+ *
+ *     @param task_args        Pointer to the EXPORT_TASK_ARGS
+ *    @param task_number        Channel index (0-based)
+ *    @param thread_number    Worker index (selects the decoding buffer)
+ */
+void export_data_task(void *task_args, si8 task_number, si4 thread_number) {
+    EXPORT_TASK_ARGS    *args = (EXPORT_TASK_ARGS *) task_args;
+    si8     i, n_chans = args->number_of_channels, n_samps = args->number_of_samples, n_failed;
+    si4     *samples = args->thread_samples[thread_number];
+    sf4     *chan_data = args->data + task_number;
+    READ_PLAN   plan = {0};
+
+    (void) READ_PLAN_build_for_samples(args->channels[task_number], args->start_sample, args->start_sample + n_samps, &plan);
+    n_failed = READ_PLAN_execute(args->channels[task_number], &plan, samples, 1);
+    READ_PLAN_free(&plan, MEF_FALSE);
+    if (n_failed < 0) {
+        for (i = 0; i < n_samps; ++i)
+            samples[i] = RED_NAN;
+        n_failed = 1;
+    }
+    args->failed_blocks[task_number] += n_failed;
+
+    // scatter (strided by the number of channels)
+    for (i = 0; i < n_samps; ++i)
+        chan_data[i * n_chans] = (samples[i] == RED_NAN) ? NAN : (sf4) samples[i];
+
+    return;
+}
+
+/**
+ *     Free the channels opened for an export
+ *
+ *     @param channels         Channels (NULL entries are skipped)
+ *     @param n_channels       Number of channels
+ */
+void free_export_channels(CHANNEL **channels, si8 n_channels) {
+    for (si8 i = 0; i < n_channels; ++i)
+        if (channels[i] != NULL)
+            free_channel(channels[i], MEF_TRUE);
+    mxFree(channels);
+
+    return;
+}
+
+//  the gate function
+/**
+* Main entry point for 'export_data_3p0'
+*
+* @param channelPaths   Path (absolute or relative) to a MEF3 channel folder, or a cell array of them
+* @param password       Password to the MEF3 data; Pass empty string/variable if not encrypted
+* @param range          [first, last] sample to export (1-based, inclusive)
+* @param filePath       Path of the float32 data file to write (overwritten)
+* @param chunkSamples   (optional) Number of samples per channel decoded & written at a time (default: 65536)
+* @return               [pnts, failedBlocks]: number of samples written per channel, and 1 x channels number of
+*                       blocks that could not be read (written as NaN)
+*/
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
+
+    //
+    // channel paths
+    //
+    if (nrhs < 4) {
+        mexErrMsgIdAndTxt( "MATLAB:export_data_mex_3p0:notEnoughArgs", "channelPaths, password, range and filePath input arguments must be set");
+    }
+    si8 n_channels = 1;
+    if (mxIsCell(prhs[0])) {
+        n_channels = (si8) mxGetNumberOfElements(prhs[0]);
+        if (n_channels == 0) {
+            mexErrMsgIdAndTxt( "MATLAB:export_data_mex_3p0:invalidChannelPathsArg", "channelPaths input argument invalid, should be a non-empty cell array of strings");
+        }
+        for (si8 i = 0; i < n_channels; ++i) {
+            mxArray *cell = mxGetCell(prhs[0], (mwIndex) i);
+            if (cell == NULL || !mxIsChar(cell) || mxIsEmpty(cell)) {
+                mexErrMsgIdAndTxt( "MATLAB:export_data_mex_3p0:invalidChannelPathsArg", "channelPaths input argument invalid, should be a non-empty cell array of strings");
+            }
+        }
+    } else if (!mxIsChar(prhs[0]) || mxIsEmpty(prhs[0])) {
+        mexErrMsgIdAndTxt( "MATLAB:export_data_mex_3p0:invalidChannelPathsArg", "channelPaths input argument invalid, should be a non-empty string (array of characters) or a cell array of strings");
+    }
+
+    //
+    // password
+    //
+    si1 *password = NULL;
+    si1 password_arr[PASSWORD_BYTES] = {0};
+    if (!mxIsEmpty(prhs[1])) {
+        if (!mxIsChar(prhs[1])) {
+            mexErrMsgIdAndTxt( "MATLAB:export_data_mex_3p0:invalidPasswordArg", "password input argument invalid, should string (array of characters)");
+        }
+        char *mat_password = mxArrayToString(prhs[1]);
+        MEF_strncpy(password_arr, mat_password, PASSWORD_BYTES);
+        mxFree(mat_password);
+        password = password_arr;
+    }
+
+    //
+    // range, file path & chunk size
+    //
+    if (!mxIsNumeric(prhs[2]) || mxGetNumberOfElements(prhs[2]) != 2) {
+        mexErrMsgIdAndTxt( "MATLAB:export_data_mex_3p0:invalidRangeArg", "range input argument invalid; should be [first, last] sample (1-based)");
+    }
+    mxArray *mat_range = mxIsDouble(prhs[2]) ? (mxArray *) prhs[2] : NULL;
+    if (mat_range == NULL) {
+        mxArray *mat_in = (mxArray *) prhs[2];
+        mexCallMATLAB(1, &mat_range, 1, &mat_in, "double");
+    }
+    si8 first_sample = (si8) mxGetPr(mat_range)[0];
+    si8 last_sample = (si8) mxGetPr(mat_range)[1];
+    if (mat_range != prhs[2])
+        mxDestroyArray(mat_range);
+    if (first_sample < 1 || last_sample < first_sample) {
+        mexErrMsgIdAndTxt( "MATLAB:export_data_mex_3p0:invalidRangeArg", "range input argument invalid; should be [first, last] sample (1-based) with last >= first");
+    }
+    if (!mxIsChar(prhs[3]) || mxIsEmpty(prhs[3])) {
+        mexErrMsgIdAndTxt( "MATLAB:export_data_mex_3p0:invalidFilePathArg", "filePath input argument invalid, should be a non-empty string (array of characters)");
+    }
+    si8 chunk_samples = EXPORT_DEFAULT_CHUNK_SAMPLES;
+    if (nrhs > 4 && !mxIsEmpty(prhs[4])) {
+        if (!mxIsNumeric(prhs[4]) || mxGetNumberOfElements(prhs[4]) != 1 || mxGetScalar(prhs[4]) < 1) {
+            mexErrMsgIdAndTxt( "MATLAB:export_data_mex_3p0:invalidChunkSamplesArg", "chunkSamples input argument invalid; should be a positive number of samples");
+        }
+        chunk_samples = (si8) mxGetScalar(prhs[4]);
+    }
+
+    //
+    // read the channel metadata & time series indices
+    //
+
+    // initialize MEF library
+    (void) initialize_meflib();
+    static MEF_CONTEXT call_context;  // this call's context: the default context is shared by the gateways & threads
+    MEF_initialize_context(&call_context, NULL);
+    (void) MEF_set_context(&call_context);
+
+    CHANNEL **channels = (CHANNEL **) mxCalloc((size_t) n_channels, sizeof(CHANNEL *));
+    for (si8 i = 0; i < n_channels; ++i) {
+        si1 channel_path[MEF_FULL_FILE_NAME_BYTES];
+        char *mat_channel_path = mxArrayToString(mxIsCell(prhs[0]) ? mxGetCell(prhs[0], (mwIndex) i) : prhs[0]);
+        MEF_strncpy(channel_path, mat_channel_path, MEF_FULL_FILE_NAME_BYTES);
+        mxFree(mat_channel_path);
+
+        MEF_context->behavior_on_fail = SUPPRESS_ERROR_OUTPUT;
+        channels[i] = read_MEF_channel(NULL, channel_path, TIME_SERIES_CHANNEL_TYPE, password, NULL, MEF_FALSE, MEF_FALSE);
+        MEF_context->behavior_on_fail = EXIT_ON_FAIL;
+        if (channels[i] == NULL || channels[i]->number_of_segments == 0) {
+            free_export_channels(channels, n_channels);
+            mexErrMsgIdAndTxt( "MATLAB:export_data_mex_3p0:readFailed", "Error: no segments in channel %s, most likely due to an invalid channel folder", channel_path);
+        }
+        channels[i]->segments[0].metadata_fps->directives.free_password_data = MEF_TRUE;
+        if (channels[i]->channel_type != TIME_SERIES_CHANNEL_TYPE) {
+            free_export_channels(channels, n_channels);
+            mexErrMsgIdAndTxt( "MATLAB:export_data_mex_3p0:invalidChannel", "Error: %s is not a time series channel", channel_path);
+        }
+        if (channels[i]->metadata.section_1->section_2_encryption > 0) {
+            free_export_channels(channels, n_channels);
+            if (password == NULL)
+                mexErrMsgIdAndTxt( "MATLAB:export_data_mex_3p0:encrypted", "Error: data is encrypted, but no password is given");
+            else
+                mexErrMsgIdAndTxt( "MATLAB:export_data_mex_3p0:wrongPassword", "Error: wrong password for encrypted data");
+        }
+        if (channels[i]->metadata.time_series_section_2->sampling_frequency != channels[0]->metadata.time_series_section_2->sampling_frequency) {
+            free_export_channels(channels, n_channels);
+            mexErrMsgIdAndTxt( "MATLAB:export_data_mex_3p0:samplingFrequencyMismatch", "Error: the channels do not have the same sampling frequency");
+        }
+    }
+
+    //
+    // export
+    //
+    char *file_path = mxArrayToString(prhs[3]);
+    FILE *fp = fopen(file_path, "wb");
+    if (fp == NULL) {
+        free_export_channels(channels, n_channels);
+        mexErrMsgIdAndTxt( "MATLAB:export_data_mex_3p0:openFailed", "Error: cannot open %s for writing", file_path);
+    }
+    mxFree(file_path);
+
+    si8 n_samples = last_sample - first_sample + 1;
+    if (chunk_samples > n_samples)
+        chunk_samples = n_samples;
+
+    // peak memory is one float chunk of all channels, plus one decoding buffer per worker
+    EXPORT_TASK_ARGS args;
+    si4 n_threads = THREAD_number_of_threads(THREAD_NUMBER_OF_THREADS_DEFAULT, n_channels);
+    args.channels = channels;
+    args.number_of_channels = n_channels;
+    args.thread_samples = (si4 **) mxCalloc((size_t) n_threads, sizeof(si4 *));
+    for (si4 i = 0; i < n_threads; ++i)
+        args.thread_samples[i] = (si4 *) mxMalloc((size_t) chunk_samples * sizeof(si4));
+    args.data = (sf4 *) mxMalloc((size_t) (n_channels * chunk_samples) * sizeof(sf4));
+    args.failed_blocks = (si8 *) mxCalloc((size_t) n_channels, sizeof(si8));
+
+    si1 write_failed = MEF_FALSE;
+    MEF_context->behavior_on_fail = SUPPRESS_ERROR_OUTPUT;
+    for (si8 offset = 0; offset < n_samples; offset += chunk_samples) {
+        args.start_sample = first_sample - 1 + offset;
+        args.number_of_samples = (n_samples - offset < chunk_samples) ? n_samples - offset : chunk_samples;
+        (void) THREAD_run_tasks(export_data_task, (void *) &args, n_channels, n_threads);
+        if (fwrite(args.data, sizeof(sf4), (size_t) (n_channels * args.number_of_samples), fp) != (size_t) (n_channels * args.number_of_samples)) {
+            write_failed = MEF_TRUE;
+            break;
+        }
+    }
+    MEF_context->behavior_on_fail = EXIT_ON_FAIL;
+    if (fclose(fp) != 0)
+        write_failed = MEF_TRUE;
+
+    for (si4 i = 0; i < n_threads; ++i)
+        mxFree(args.thread_samples[i]);
+    mxFree(args.thread_samples);
+    mxFree(args.data);
+    free_export_channels(channels, n_channels);
+    if (write_failed == MEF_TRUE) {
+        mxFree(args.failed_blocks);
+        mexErrMsgIdAndTxt( "MATLAB:export_data_mex_3p0:writeFailed", "Error: writing the data file failed (disk full?)");
+    }
+
+    plhs[0] = mxCreateDoubleScalar((double) n_samples);
+    if (nlhs > 1) {
+        plhs[1] = mxCreateDoubleMatrix(1, (mwSize) n_channels, mxREAL);
+        for (si8 i = 0; i < n_channels; ++i)
+            mxGetPr(plhs[1])[i] = (double) args.failed_blocks[i];
+    }
+    mxFree(args.failed_blocks);
+
+    (void) MEF_set_context(NULL);
+
+    // succesfull return from call
+    return;
+
+}
+
+// [EOF]
@@ -0,0 +1,67 @@
+function events = find_events_3p0(sess_path,password,range,channel,types)
+% FIND_EVENTS_3P0 Find the discontinuity and record events of a MEF 3.0 session as EEGLAB events
+% 
+% Syntax:
+%   events = find_events_3p0(sess_path,password,range)
+%   events = find_events_3p0(__,channel)
+%   events = find_events_3p0(__,channel,types)
+% 
+% Imput(s):
+%   sess_path       - [char] path to a MEF 3.0 session folder (.mefd)
+%   password        - [char] password of the MEF 3.0 data; empty if not
+%                     encrypted
+%   range           - [num] 1 x 2 [first, last] sample indexes (1-based,
+%                     inclusive) of the reference channel; empty for the
+%                     whole channel
+%   channel         - [char] (opt) name of the reference channel (default
+%                     = the first time series channel)
+%   types           - [char|cell] (opt) event type(s): 'Discont', 'Seiz',
+%                     'Note', 'CSti' and/or 'ESti' (default = [], all)
+% 
+% Output(s):
+%   events          - [struct] 1 x N EEGLAB event structure
+%                     .type     : 'Discont', 'Seiz onset', 'Seiz offset',
+%                                 'Note', 'CSti' or 'ESti'
+%                     .latency  : sample index relative to the first
+%                                 sample of the range (1-based)
+%                     .urevent  : index of the event (1 to N)
+% 
+% Note:
+%   This is a dummy function to check if the mex function has been
+%   compiled. If not, it will try to compile it.
+%
+%   Only the metadata, time series indices and record indices are read.
+%   The discontinuities are the blocks flagged as such or starting a
+%   contiguous part of the reference channel; the records are those of
+%   all levels of the session. Events in a gap of the data are moved to
+%   the first sample after it. The events are sorted by latency, then
+%   type, without duplicates.
+% 
+% See also findDiscontEvent, findMEFEvent, read_mef_records_3p0.
+
+% Copyright 2026 Richard J. Cui. Created: Sun 10/18/2026 10:12:37.415 AM
+% $Revision: 0.1 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+%
+% Rocky Creek Dr NE
+% Rochester, MN 55906, USA
+%
+% Email: richard.cui@utoronto.ca
+
+% compile c-mex function
+% -----------------------
+% we are here, cuz we don't have the mex function compiled. So, do it now
+make_mex_mef
+
+% now find the events
+% -------------------
+if nargin < 4
+    channel = '';
+end % if
+if nargin < 5
+    types = [];
+end % if
+events = find_events_3p0(sess_path,password,range,channel,types);
+
+end % funciton
+
+% [EOF]
\ No newline at end of file
@@ -0,0 +1,420 @@
+/**
+*     @file
+*     MEF 3.0 Library Matlab Wrapper
+*     Find the discontinuities and record events of a MEF 3.0 session in a sample range, as EEGLAB events
+*
+*  This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+*  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+*  This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*  You should have received a copy of the GNU General Public License along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//  Copyright (c) Richard J. Cui Created: Sun 10/18/2026 10:12:37.415 AM
+//  $Revision: 0.4 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+//
+//  Rocky Creek Dr NE
+//  Rochester, MN 55906, USA
+//
+//  Email: richard.cui@utoronto.ca
+
+#include "mex.h"
+#include "mef_mex_3p0.h"
+
+//  event types (EEGLAB event.type), in the order events at the same latency are listed
+#define EVENT_DISCONT                   0
+#define EVENT_SEIZ_ONSET                1
+#define EVENT_SEIZ_OFFSET               2
+#define EVENT_NOTE                      3
+#define EVENT_CSTI                      4
+#define EVENT_ESTI                      5
+#define EVENT_NUMBER_OF_TYPES           6
+const char *event_type_strings[EVENT_NUMBER_OF_TYPES] = {
+    "Discont", "Seiz onset", "Seiz offset", "Note", "CSti", "ESti"
+};
+
+/**
+ *  An event, before it is mapped to the EEGLAB event structure
+ */
+typedef struct {
+    si8     sample;     // zero-based, in the reference channel
+    si4     type;       // EVENT_*
+} SESSION_EVENT;
+
+/**
+ *  Growable list of events
+ */
+typedef struct {
+    SESSION_EVENT   *events;
+    si8             number_of_events;
+    si8             allocated_events;
+} SESSION_EVENT_LIST;
+
+/**
+ *     Add an event to the list, if it is in the sample range
+ *
+ *     @param list             Event list
+ *     @param type             Event type (EVENT_*)
+ *     @param sample           Sample of the event (zero-based), negative if none
+ *     @param first_sample     First sample of the range (zero-based)
+ *     @param last_sample      Last sample of the range (zero-based, inclusive)
+ */
+void add_session_event(SESSION_EVENT_LIST *list, si4 type, si8 sample, si8 first_sample, si8 last_sample) {
+    if (sample < first_sample || sample > last_sample)
+        return;
+
+    if (list->number_of_events == list->allocated_events) {
+        list->allocated_events = (list->allocated_events == 0) ? 64 : 2 * list->allocated_events;
+        list->events = (SESSION_EVENT *) mxRealloc(list->events, (size_t) list->allocated_events * sizeof(SESSION_EVENT));
+    }
+    list->events[list->number_of_events].sample = sample;
+    list->events[list->number_of_events].type = type;
+    ++list->number_of_events;
+
+    return;
+}
+
+/**
+ *     Compare two events by sample, then type (for qsort)
+ */
+si4 compare_session_events(const void *a, const void *b) {
+    const SESSION_EVENT *event_a = (const SESSION_EVENT *) a, *event_b = (const SESSION_EVENT *) b;
+
+    if (event_a->sample != event_b->sample)
+        return (event_a->sample < event_b->sample) ? -1 : 1;
+    if (event_a->type != event_b->type)
+        return (event_a->type < event_b->type) ? -1 : 1;
+
+    return 0;
+}
+
+/**
+ *     Convert the time of an event to a sample of the reference channel
+ *
+ *  A time in a gap (or before the recording) is moved to the first sample after it, since an EEGLAB event needs a
+ *  latency in the data.
+ *
+ *     @param continuity_index     Continuity index of the reference channel
+ *     @param time                 Time of the event (uUTC, with or without the recording time offset)
+ *     @return                     Sample (zero-based), or -1 if the time is after the recording or has no entry
+ */
+si8 event_time_to_sample(CONTINUITY_INDEX *continuity_index, si8 time) {
+    CONTINUITY_ENTRY    *entry;
+    si8                 k;
+
+    if (time == UUTC_NO_ENTRY || continuity_index->number_of_entries == 0)
+        return -1;
+    remove_recording_time_offset(&time);
+
+    k = CONTINUITY_find_entry(continuity_index, (sf8) time, MEF_FALSE);
+    if (k >= 0) {
+        entry = continuity_index->entries + k;
+        if ((sf8) time < entry->end_time)
+            return entry->start_sample + (si8) (((sf8) (time - entry->start_time) * continuity_index->sampling_frequency) / 1000000.0);
+    }
+    if (k + 1 < continuity_index->number_of_entries)
+        return continuity_index->entries[k + 1].start_sample;
+
+    return -1;
+}
+
+/**
+ *     Add the discontinuities of the reference channel
+ *
+ *  A block starts a discontinuity if its discontinuity flag is set, or if it does not start where the previous block
+ *  ended (a new entry of the continuity index); both usually hold, so duplicates are removed later. The start of the
+ *  recording is not a discontinuity, so a channel sampled in a single run has none.
+ *
+ *     @param list                 Event list
+ *     @param channel              Reference channel (time series indices read)
+ *     @param continuity_index     Continuity index of the channel
+ *     @param first_sample         First sample of the range (zero-based)
+ *     @param last_sample          Last sample of the range (zero-based, inclusive)
+ */
+void add_discontinuity_events(SESSION_EVENT_LIST *list, CHANNEL *channel, CONTINUITY_INDEX *continuity_index, si8 first_sample, si8 last_sample) {
+    TIME_SERIES_INDEX   *tsi;
+    si8                 i, sample, segment_start_sample;
+    si4                 j;
+
+    if (continuity_index->number_of_entries <= 1)
+        return;
+    for (j = 0; j < channel->number_of_segments; ++j) {
+        if (channel->segments[j].time_series_indices_fps == NULL)
+            continue;
+        segment_start_sample = channel->segments[j].metadata_fps->metadata.time_series_section_2->start_sample;
+        tsi = channel->segments[j].time_series_indices_fps->time_series_indices;
+        for (i = 0; i < channel->segments[j].time_series_indices_fps->universal_header->number_of_entries; ++i) {
+            sample = segment_start_sample + tsi[i].start_sample;
+            if ((tsi[i].RED_block_flags & RED_DISCONTINUITY_MASK) && sample > continuity_index->entries[0].start_sample)
+                add_session_event(list, EVENT_DISCONT, sample, first_sample, last_sample);
+        }
+    }
+    for (i = 1; i < continuity_index->number_of_entries; ++i)
+        add_session_event(list, EVENT_DISCONT, continuity_index->entries[i].start_sample, first_sample, last_sample);
+
+    return;
+}
+
+/**
+ *     Add the events of the Seiz, Note, CSti & ESti records of the session (all levels)
+ *
+ *     @param list                 Event list
+ *     @param session              Session (record indices read)
+ *     @param continuity_index     Continuity index of the reference channel
+ *     @param types                Event types requested (MEF_TRUE / MEF_FALSE per EVENT_*)
+ *     @param first_sample         First sample of the range (zero-based)
+ *     @param last_sample          Last sample of the range (zero-based, inclusive)
+ */
+void add_record_events(SESSION_EVENT_LIST *list, SESSION *session, CONTINUITY_INDEX *continuity_index, si1 *types, si8 first_sample, si8 last_sample) {
+    RECORD_QUERY        query;
+    RECORD_QUERY_RESULT *result;
+    RECORD_HEADER       *rh;
+    si8                 m;
+
+    RECORD_initialize_query(&query, UUTC_NO_ENTRY, UUTC_NO_ENTRY);
+    if (types[EVENT_SEIZ_ONSET] == MEF_TRUE || types[EVENT_SEIZ_OFFSET] == MEF_TRUE)
+        (void) RECORD_add_query_type(&query, MEFREC_Seiz_TYPE_STRING);
+    if (types[EVENT_NOTE] == MEF_TRUE)
+        (void) RECORD_add_query_type(&query, MEFREC_Note_TYPE_STRING);
+    if (types[EVENT_CSTI] == MEF_TRUE)
+        (void) RECORD_add_query_type(&query, MEFREC_CSti_TYPE_STRING);
+    if (types[EVENT_ESTI] == MEF_TRUE)
+        (void) RECORD_add_query_type(&query, MEFREC_ESti_TYPE_STRING);
+    if (query.number_of_type_codes == 0)
+        return;
+
+    // only the records of these types are read
+    result = RECORD_query_session(session, &query, NULL);
+    for (m = 0; m < result->number_of_records; ++m) {
+        rh = (RECORD_HEADER *) (result->records + result->matches[m].record_offset);
+        if (rh->encryption > NO_ENCRYPTION)
+            continue;  // not decrypted (no password for its level)
+        switch (*((ui4 *) rh->type_string)) {
+            case MEFREC_Seiz_TYPE_CODE: {
+                MEFREC_Seiz_1_0 *seiz_p = (MEFREC_Seiz_1_0 *) ((ui1 *) rh + MEFREC_Seiz_1_0_OFFSET);
+                if (types[EVENT_SEIZ_ONSET] == MEF_TRUE)
+                    add_session_event(list, EVENT_SEIZ_ONSET, event_time_to_sample(continuity_index, (seiz_p->earliest_onset != UUTC_NO_ENTRY) ? seiz_p->earliest_onset : rh->time), first_sample, last_sample);
+                if (types[EVENT_SEIZ_OFFSET] == MEF_TRUE && seiz_p->latest_offset != UUTC_NO_ENTRY)
+                    add_session_event(list, EVENT_SEIZ_OFFSET, event_time_to_sample(continuity_index, seiz_p->latest_offset), first_sample, last_sample);
+                break;
+            }
+            case MEFREC_Note_TYPE_CODE:
+                add_session_event(list, EVENT_NOTE, event_time_to_sample(continuity_index, rh->time), first_sample, last_sample);
+                break;
+            case MEFREC_CSti_TYPE_CODE:
+                add_session_event(list, EVENT_CSTI, event_time_to_sample(continuity_index, rh->time), first_sample, last_sample);
+                break;
+            case MEFREC_ESti_TYPE_CODE:
+                add_session_event(list, EVENT_ESTI, event_time_to_sample(continuity_index, rh->time), first_sample, last_sample);
+                break;
+        }
+    }
+    RECORD_free_query_result(result, MEF_TRUE);
+
+    return;
+}
+
+/**
+ *     Sort the events, remove the duplicates and map them to an EEGLAB event structure
+ *
+ *     @param list             Event list
+ *     @param first_sample     First sample of the range (zero-based); latencies are relative to it (one-based)
+ *     @return                 1 x N structure with the fields type, latency & urevent
+ */
+mxArray *map_session_events(SESSION_EVENT_LIST *list, si8 first_sample) {
+    const char *fields[] = { "type", "latency", "urevent" };
+    si8     i, n = 0;
+
+    if (list->number_of_events > 1)
+        qsort((void *) list->events, (size_t) list->number_of_events, sizeof(SESSION_EVENT), compare_session_events);
+    for (i = 0; i < list->number_of_events; ++i)
+        if (n == 0 || compare_session_events(list->events + i, list->events + n - 1) != 0)
+            list->events[n++] = list->events[i];
+    list->number_of_events = n;
+
+    mxArray *mat_events = mxCreateStructMatrix(1, (mwSize) n, 3, fields);
+    for (i = 0; i < n; ++i) {
+        mxSetField(mat_events, (mwIndex) i, "type", mxCreateString(event_type_strings[list->events[i].type]));
+        mxSetField(mat_events, (mwIndex) i, "latency", mxCreateDoubleScalar((double) (list->events[i].sample - first_sample + 1)));
+        mxSetField(mat_events, (mwIndex) i, "urevent", mxCreateDoubleScalar((double) (i + 1)));
+    }
+
+    return mat_events;
+}
+
+//  the gate function
+/**
+* Main entry point for 'find_events_3p0'
+*
+* @param sessionPath    Path (absolute or relative) to the MEF3 session folder
+* @param password       Password to the MEF3 data; Pass empty string/variable if not encrypted
+* @param range          [first, last] sample of the range (1-based, inclusive) in the reference channel; empty for
+*                       the whole channel
+* @param channel        (optional) Name of the reference channel, whose samples the latencies count (default: the
+*                       first time series channel)
+* @param types          (optional) Event type(s): 'Discont', 'Seiz', 'Note', 'CSti' and/or 'ESti' (char array or cell
+*                       array; empty => all)
+* @return               1 x N EEGLAB event structure (type, latency, urevent), sorted by latency, without duplicates;
+*                       latencies are one-based, relative to the first sample of the range
+*/
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
+
+    //
+    // session path
+    //
+    if (nrhs < 3) {
+        mexErrMsgIdAndTxt( "MATLAB:find_events_mex_3p0:notEnoughArgs", "sessionPath, password and range input arguments must be set");
+    }
+    if (!mxIsChar(prhs[0]) || mxIsEmpty(prhs[0])) {
+        mexErrMsgIdAndTxt( "MATLAB:find_events_mex_3p0:invalidSessionPathArg", "sessionPath input argument invalid, should be a non-empty string (array of characters)");
+    }
+    si1 session_path[MEF_FULL_FILE_NAME_BYTES];
+    char *mat_session_path = mxArrayToString(prhs[0]);
+    MEF_strncpy(session_path, mat_session_path, MEF_FULL_FILE_NAME_BYTES);
+    mxFree(mat_session_path);
+
+    //
+    // password
+    //
+    si1 *password = NULL;
+    si1 password_arr[PASSWORD_BYTES] = {0};
+    if (!mxIsEmpty(prhs[1])) {
+        if (!mxIsChar(prhs[1])) {
+            mexErrMsgIdAndTxt( "MATLAB:find_events_mex_3p0:invalidPasswordArg", "password input argument invalid, should string (array of characters)");
+        }
+        char *mat_password = mxArrayToString(prhs[1]);
+        MEF_strncpy(password_arr, mat_password, PASSWORD_BYTES);
+        mxFree(mat_password);
+        password = password_arr;
+    }
+
+    //
+    // range, channel & types
+    //
+    si1 whole_channel = mxIsEmpty(prhs[2]) ? MEF_TRUE : MEF_FALSE;
+    si8 first_sample = 0, last_sample = 0;
+    if (whole_channel == MEF_FALSE) {
+        if (!mxIsNumeric(prhs[2]) || mxGetNumberOfElements(prhs[2]) != 2) {
+            mexErrMsgIdAndTxt( "MATLAB:find_events_mex_3p0:invalidRangeArg", "range input argument invalid; should be [first, last] sample (1-based), or empty for the whole channel");
+        }
+        mxArray *mat_range = mxIsDouble(prhs[2]) ? (mxArray *) prhs[2] : NULL;
+        if (mat_range == NULL) {
+            mxArray *mat_in = (mxArray *) prhs[2];
+            mexCallMATLAB(1, &mat_range, 1, &mat_in, "double");
+        }
+        first_sample = (si8) mxGetPr(mat_range)[0] - 1;
+        last_sample = (si8) mxGetPr(mat_range)[1] - 1;
+        if (mat_range != prhs[2])
+            mxDestroyArray(mat_range);
+        if (first_sample < 0 || last_sample < first_sample) {
+            mexErrMsgIdAndTxt( "MATLAB:find_events_mex_3p0:invalidRangeArg", "range input argument invalid; should be [first, last] sample (1-based) with last >= first");
+        }
+    }
+    si1 channel_name[MEF_BASE_FILE_NAME_BYTES] = {0};
+    if (nrhs > 3 && !mxIsEmpty(prhs[3])) {
+        if (!mxIsChar(prhs[3])) {
+            mexErrMsgIdAndTxt( "MATLAB:find_events_mex_3p0:invalidChannelArg", "channel input argument invalid, should be a string (array of characters)");
+        }
+        mxGetString(prhs[3], channel_name, MEF_BASE_FILE_NAME_BYTES);
+    }
+    si1 types[EVENT_NUMBER_OF_TYPES];
+    for (si4 t = 0; t < EVENT_NUMBER_OF_TYPES; ++t)
+        types[t] = (nrhs > 4 && !mxIsEmpty(prhs[4])) ? MEF_FALSE : MEF_TRUE;
+    if (nrhs > 4 && !mxIsEmpty(prhs[4])) {
+        si4 n_types = mxIsCell(prhs[4]) ? (si4) mxGetNumberOfElements(prhs[4]) : 1;
+        for (si4 i = 0; i < n_types; ++i) {
+            const mxArray *mat_type = mxIsCell(prhs[4]) ? mxGetCell(prhs[4], (mwIndex) i) : prhs[4];
+            si1 type_string[16] = {0};
+            if (mat_type == NULL || !mxIsChar(mat_type) || mxGetString(mat_type, type_string, sizeof(type_string)) != 0) {
+                mexErrMsgIdAndTxt( "MATLAB:find_events_mex_3p0:invalidTypesArg", "types input argument invalid; should be 'Discont', 'Seiz', 'Note', 'CSti' and/or 'ESti'");
+            }
+            if (strcmp(type_string, "Discont") == 0) {
+                types[EVENT_DISCONT] = MEF_TRUE;
+            } else if (strcmp(type_string, MEFREC_Seiz_TYPE_STRING) == 0) {
+                types[EVENT_SEIZ_ONSET] = types[EVENT_SEIZ_OFFSET] = MEF_TRUE;
+            } else if (strcmp(type_string, MEFREC_Note_TYPE_STRING) == 0) {
+                types[EVENT_NOTE] = MEF_TRUE;
+            } else if (strcmp(type_string, MEFREC_CSti_TYPE_STRING) == 0) {
+                types[EVENT_CSTI] = MEF_TRUE;
+            } else if (strcmp(type_string, MEFREC_ESti_TYPE_STRING) == 0) {
+                types[EVENT_ESTI] = MEF_TRUE;
+            } else {
+                mexErrMsgIdAndTxt( "MATLAB:find_events_mex_3p0:invalidTypesArg", "types input argument invalid; should be 'Discont', 'Seiz', 'Note', 'CSti' and/or 'ESti'");
+            }
+        }
+    }
+
+    //
+    // read the session metadata, time series & record indices (no data)
+    //
+
+    // initialize MEF library
+    (void) initialize_meflib();
+    static MEF_CONTEXT call_context;  // this call's context: the default context is shared by the gateways & threads
+    MEF_initialize_context(&call_context, NULL);
+    (void) MEF_set_context(&call_context);
+
+    MEF_context->behavior_on_fail = SUPPRESS_ERROR_OUTPUT;
+    SESSION *session = read_MEF_session(NULL, session_path, password, NULL, MEF_FALSE, MEF_FALSE);
+    MEF_context->behavior_on_fail = EXIT_ON_FAIL;
+    if (session == NULL) {
+        mexErrMsgIdAndTxt( "MATLAB:find_events_mex_3p0:readFailed", "Error while reading session metadata");
+    }
+    if (session->number_of_time_series_channels == 0) {
+        free_session(session, MEF_TRUE);
+        mexErrMsgIdAndTxt( "MATLAB:find_events_mex_3p0:noChannels", "Error: the session has no time series channels");
+    }
+    if (session->time_series_metadata.section_1 != NULL && session->time_series_metadata.section_1->section_2_encryption > 0) {
+        free_session(session, MEF_TRUE);
+        if (password == NULL)
+            mexErrMsgIdAndTxt( "MATLAB:find_events_mex_3p0:encrypted", "Error: data is encrypted, but no password is given");
+        else
+            mexErrMsgIdAndTxt( "MATLAB:find_events_mex_3p0:wrongPassword", "Error: wrong password for encrypted data");
+    }
+
+    // reference channel
+    CHANNEL *channel = session->time_series_channels;
+    if (channel_name[0]) {
+        channel = NULL;
+        for (si4 i = 0; i < session->number_of_time_series_channels; ++i) {
+            if (strcmp(session->time_series_channels[i].name, channel_name) == 0) {
+                channel = session->time_series_channels + i;
+                break;
+            }
+        }
+        if (channel == NULL) {
+            free_session(session, MEF_TRUE);
+            mexErrMsgIdAndTxt( "MATLAB:find_events_mex_3p0:invalidChannelArg", "Error: no time series channel %s in the session", channel_name);
+        }
+    }
+    if (whole_channel == MEF_TRUE)
+        last_sample = channel->metadata.time_series_section_2->number_of_samples - 1;
+
+    //
+    // events
+    //
+    CONTINUITY_INDEX continuity_index = {0};
+    (void) CONTINUITY_build_index(channel, &continuity_index);
+
+    SESSION_EVENT_LIST list = {0};
+    if (types[EVENT_DISCONT] == MEF_TRUE)
+        add_discontinuity_events(&list, channel, &continuity_index, first_sample, last_sample);
+    MEF_context->behavior_on_fail = SUPPRESS_ERROR_OUTPUT;
+    add_record_events(&list, session, &continuity_index, types, first_sample, last_sample);
+    MEF_context->behavior_on_fail = EXIT_ON_FAIL;
+
+    CONTINUITY_free_index(&continuity_index, MEF_FALSE);
+    free_session(session, MEF_TRUE);
+
+    plhs[0] = map_session_events(&list, first_sample);
+    if (list.events != NULL)
+        mxFree(list.events);
+
+    (void) MEF_set_context(NULL);
+
+    // succesfull return from call
+    return;
+
+}
+
+// [EOF]
@@ -3,7 +3,7 @@
 //  mef_3p0
 
 //  Copyright (c) Richard J. Cui Created: Wed 05/29/2019  9:49:29.694 PM
-//  $Revision: 0.2 $  $Date: Mon 11/02/2020  9:21:42.834 AM $
+//  $Revision: 0.4 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
 //
 //  Rocky Creek Dr NE
 //  Rochester, MN 55906, USA
@@ -366,10 +366,28 @@ const char *MEFREC_ESTI_1_0_FIELDNAMES []   = {
 //
 mxArray *read_channel_data_from_path(si1*, si1*, bool, si8, si8);
 mxArray *read_channel_data_from_object(CHANNEL*, bool, si8, si8);
-si8 sample_for_uutc_c(si8, CHANNEL*);
-si8 uutc_for_sample_c(si8, CHANNEL*);
-void memset_int(si4*, si4, size_t);
-si4 check_block_crc(ui1*, ui4, ui1*, ui8);
+mxArray *read_channel_range(CHANNEL*, bool, si8, si8);
+mxArray *read_channel_epochs(CHANNEL*, bool, sf8*, si8);
+void free_block_cache(void);
+BLOCK_CACHE *initialize_block_cache(void);
+mxArray *map_block_cache(BLOCK_CACHE*);
+mxArray *map_mef3_profile(MEF_PROFILE*);
+void close_scan_reader(si4);
+void close_scan_readers(void);
+si4 get_scan_reader_id(const mxArray*);
+mxArray *map_scan_reader(SCAN_READER*);
+si4 open_scan_reader(si1*, si1*, si8, si8, si8);
+mxArray *read_scan_window(SCAN_READER*, si8);
+ENVELOPE *read_channel_envelope(CHANNEL*, si8, si8, si8, si1);
+mxArray *map_envelope_values(sf8*, si8);
+void free_export_channels(CHANNEL**, si8);
+void add_validation_message(si1*, si4*, const char*, ...);
+si8 event_time_to_sample(CONTINUITY_INDEX*, si8);
+void read_channel_continuity(si1*, si1*, CONTINUITY_INDEX*);
+
+void remove_line_noise_task(void*, si8, si4);
+void export_data_task(void*, si8, si4);
+void validate_channel_task(void*, si8, si4);
 
 void map_mef3_segment_tostruct(SEGMENT*, si1, mxArray*, int);
 mxArray *map_mef3_segment(SEGMENT*, si1 );
@@ -383,9 +401,13 @@ mxArray *map_mef3_md3(METADATA_SECTION_3*);
 mxArray *map_mef3_ti(TIME_SERIES_INDEX*, si8);
 mxArray *map_mef3_vi(VIDEO_INDEX*, si8);
 mxArray *map_mef3_records(FILE_PROCESSING_STRUCT*, FILE_PROCESSING_STRUCT*);
+mxArray *map_mef3_record_columns(RECORD_QUERY_RESULT*, ui4, si8);
+mxArray *map_mef3_continuity(CHANNEL*);
+CONTINUITY_INDEX *map_continuity_table(const mxArray*, sf8, CONTINUITY_INDEX*);
 mxArray *map_mef3_csti(RECORD_HEADER*);
 mxArray *map_mef3_uh(UNIVERSAL_HEADER*);
 
+mxArray *mxCreateNumericColumn(si8, mxClassID);
 mxArray *mxUint8ArrayByValue(ui1*, int);
 mxArray *mxInt32ArrayByValue(si4*, int);
 mxArray *mxUint8ByValue(ui1);
@@ -0,0 +1,63 @@
+function [env_min, env_max, env_rms, source] = read_envelope_3p0(ch_path,pw,range,width,build_pyramid)
+% READ_ENVELOPE_3P0 Read the min/max envelope of a MEF 3.0 channel for a plot width
+% 
+% Syntax:
+%   [env_min, env_max, env_rms, source] = read_envelope_3p0(ch_path,pw,range,width)
+%   [env_min, env_max, env_rms, source] = read_envelope_3p0(__,build_pyramid)
+% 
+% Imput(s):
+%   ch_path         - [str] channel path of a MEF 3.0 session
+%   pw              - [str] password for the desired level
+%   range           - [num] [start, end] of the range in uUTC (start
+%                     inclusive, end exclusive); [] for the whole channel
+%   width           - [num] number of bins (e.g. the pixel width of the
+%                     plot)
+%   build_pyramid   - [logical] (opt) build the envelope pyramids of the
+%                     segments that have none (default = false)
+% 
+% Output(s):
+%   env_min         - [num] 1 x width minimum of each bin (NaN where there
+%                     are no samples)
+%   env_max         - [num] 1 x width maximum of each bin
+%   env_rms         - [num] 1 x width RMS of each bin (NaN if answered from
+%                     the block indices)
+%   source          - [char] finest source used: 'indices', 'pyramid',
+%                     'samples' or '' (no data)
+% 
+% Note:
+%   This is a dummy function to check if the mex function has been
+%   compiled. If not, it will try to compile it.
+%
+%   Bins at least as wide as the data blocks are answered from the block
+%   extrema in the time series indices, without decoding. Finer bins use
+%   the envelope pyramid of each segment (a .tenv file next to its .tdat
+%   file), whose levels are built in one parallel decoding pass with
+%   build_pyramid; without one, the range is decoded. Bins of the pyramid
+%   (and of the blocks) are added to all the output bins they overlap, so
+%   the envelope may be slightly wider than that of the samples.
+% 
+% See also decompress_mef_3p0, read_mef_envelope.
+
+% Copyright 2026 Richard J. Cui. Created: Sun 10/18/2026 10:12:37.415 AM
+% $Revision: 0.1 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+%
+% Rocky Creek Dr NE
+% Rochester, MN 55906, USA
+%
+% Email: richard.cui@utoronto.ca
+
+% compile c-mex function
+% -----------------------
+% we are here, cuz we don't have the mex function compiled. So, do it now
+make_mex_mef
+
+% now get the envelope
+% --------------------
+if nargin < 5
+    build_pyramid = false;
+end % if
+[env_min, env_max, env_rms, source] = read_envelope_3p0(ch_path,pw,range,width,build_pyramid);
+
+end % funciton
+
+% [EOF]
\ No newline at end of file
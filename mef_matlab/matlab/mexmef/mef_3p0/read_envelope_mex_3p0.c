@@ -0,0 +1,237 @@
+/**
+*     @file
+*     MEF 3.0 Library Matlab Wrapper
+*     Read the min/max (and RMS) envelope of a MEF 3.0 time series channel over a time range, for a number of bins
+*
+*  This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+*  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+*  This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*  You should have received a copy of the GNU General Public License along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//  Copyright (c) Richard J. Cui Created: Sun 10/18/2026 10:12:37.415 AM
+//  $Revision: 0.4 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+//
+//  Rocky Creek Dr NE
+//  Rochester, MN 55906, USA
+//
+//  Email: richard.cui@utoronto.ca
+
+#include "mex.h"
+#include "mef_mex_3p0.h"
+
+/**
+ *     Read the envelope of a channel
+ *
+ *  The envelope pyramids of the segments are read from their sidecar files; with build_pyramids, the missing (or out
+ *  of date) ones are built in one parallel decoding pass and written next to the segment data (kept in memory only
+ *  if that fails, e.g. for read-only data, or if some blocks could not be decoded, so their empty bins are not
+ *  reused by later calls).
+ *
+ *     @param channel          Pointer to the MEF channel object (time series indices read)
+ *     @param start_time       Start of the range (uUTC, inclusive)
+ *     @param end_time         End of the range (uUTC, exclusive)
+ *     @param n_bins           Number of bins (e.g. pixel width)
+ *     @param build_pyramids   Whether to build the missing envelope pyramids
+ *     @return                 Envelope (free with ENVELOPE_free)
+ */
+ENVELOPE *read_channel_envelope(CHANNEL *channel, si8 start_time, si8 end_time, si8 n_bins, si1 build_pyramids) {
+    si4 i, n_built = 0, n_incomplete = 0;
+    si8 n_failed;
+
+    ENVELOPE_PYRAMID **pyramids = (ENVELOPE_PYRAMID **) mxCalloc((size_t) channel->number_of_segments, sizeof(ENVELOPE_PYRAMID *));
+    for (i = 0; i < channel->number_of_segments; ++i) {
+        pyramids[i] = ENVELOPE_read_pyramid(channel->segments + i);
+        if (pyramids[i] == NULL && build_pyramids == MEF_TRUE) {
+            pyramids[i] = ENVELOPE_build_pyramid(channel, i, THREAD_NUMBER_OF_THREADS_DEFAULT, &n_failed);
+            if (pyramids[i] != NULL && n_failed > 0)
+                ++n_incomplete;
+            else if (pyramids[i] != NULL && ENVELOPE_write_pyramid(channel->segments + i, pyramids[i]) < 0)
+                ++n_built;
+        }
+    }
+    if (n_built > 0)
+        mexPrintf("Warning: the envelope pyramid of %d segment(s) of channel %s could not be saved\n", n_built, channel->name);
+    if (n_incomplete > 0)
+        mexPrintf("Warning: %d segment(s) of channel %s have blocks that could not be decoded (CRC or access); their envelope pyramids are not saved\n", n_incomplete, channel->name);
+
+    ENVELOPE *envelope = ENVELOPE_query(channel, pyramids, start_time, end_time, n_bins, THREAD_NUMBER_OF_THREADS_DEFAULT, NULL);
+
+    for (i = 0; i < channel->number_of_segments; ++i)
+        ENVELOPE_free_pyramid(pyramids[i]);
+    mxFree(pyramids);
+
+    return envelope;
+}
+
+/**
+ *     Copy an array of the envelope to a Matlab row vector
+ *
+ *     @param values           Values (NaN where there is no value)
+ *     @param n_bins           Number of bins
+ *     @return                 1 x n_bins double array
+ */
+mxArray *map_envelope_values(sf8 *values, si8 n_bins) {
+    mxArray *mat_values = mxCreateDoubleMatrix(1, (mwSize) n_bins, mxREAL);
+    if (n_bins > 0)
+        memcpy(mxGetPr(mat_values), values, (size_t) n_bins * sizeof(sf8));
+
+    return mat_values;
+}
+
+//  the gate function
+/**
+* Main entry point for 'read_envelope_3p0'
+*
+* @param channelPath    Path (absolute or relative) to the MEF3 channel folder
+* @param password       Password to the MEF3 data; Pass empty string/variable if not encrypted
+* @param range          [start, end] of the range in uUTC (start inclusive, end exclusive); empty for the whole channel
+* @param width          Number of bins (e.g. the pixel width of a plot)
+* @param buildPyramid   (optional) true to build (and save) the missing envelope pyramids (default: false)
+* @return               [minimum, maximum, rms, source]: 1 x width arrays (NaN in bins without samples; rms is NaN in
+*                       bins answered from the block indices), and the finest source used: 'indices', 'pyramid',
+*                       'samples' or '' (no data)
+*/
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
+
+    //
+    // channel path
+    //
+    if (nrhs < 4) {
+        mexErrMsgIdAndTxt( "MATLAB:read_envelope_mex_3p0:notEnoughArgs", "channelPath, password, range and width input arguments must be set");
+    }
+    if (!mxIsChar(prhs[0]) || mxIsEmpty(prhs[0])) {
+        mexErrMsgIdAndTxt( "MATLAB:read_envelope_mex_3p0:invalidChannelPathArg", "channelPath input argument invalid, should be a non-empty string (array of characters)");
+    }
+    si1 channel_path[MEF_FULL_FILE_NAME_BYTES];
+    char *mat_channel_path = mxArrayToString(prhs[0]);
+    MEF_strncpy(channel_path, mat_channel_path, MEF_FULL_FILE_NAME_BYTES);
+    mxFree(mat_channel_path);
+
+    //
+    // password
+    //
+    si1 *password = NULL;
+    si1 password_arr[PASSWORD_BYTES] = {0};
+    if (!mxIsEmpty(prhs[1])) {
+        if (!mxIsChar(prhs[1])) {
+            mexErrMsgIdAndTxt( "MATLAB:read_envelope_mex_3p0:invalidPasswordArg", "password input argument invalid, should string (array of characters)");
+        }
+        char *mat_password = mxArrayToString(prhs[1]);
+        MEF_strncpy(password_arr, mat_password, PASSWORD_BYTES);
+        mxFree(mat_password);
+        password = password_arr;
+    }
+
+    //
+    // range, width & build pyramid
+    //
+    si1 whole_channel = mxIsEmpty(prhs[2]) ? MEF_TRUE : MEF_FALSE;
+    if (whole_channel == MEF_FALSE && (!mxIsNumeric(prhs[2]) || mxGetNumberOfElements(prhs[2]) != 2)) {
+        mexErrMsgIdAndTxt( "MATLAB:read_envelope_mex_3p0:invalidRangeArg", "range input argument invalid; should be [start, end] in uUTC, or empty for the whole channel");
+    }
+    si8 start_time = 0, end_time = 0;
+    if (whole_channel == MEF_FALSE) {
+        mxArray *mat_range = mxIsDouble(prhs[2]) ? (mxArray *) prhs[2] : NULL;
+        if (mat_range == NULL) {
+            mxArray *mat_in = (mxArray *) prhs[2];
+            mexCallMATLAB(1, &mat_range, 1, &mat_in, "double");
+        }
+        start_time = (si8) mxGetPr(mat_range)[0];
+        end_time = (si8) mxGetPr(mat_range)[1];
+        if (mat_range != prhs[2])
+            mxDestroyArray(mat_range);
+        if (end_time <= start_time) {
+            mexErrMsgIdAndTxt( "MATLAB:read_envelope_mex_3p0:invalidRangeArg", "range input argument invalid; the end should be after the start");
+        }
+    }
+    if (!mxIsNumeric(prhs[3]) || mxGetNumberOfElements(prhs[3]) != 1 || mxGetScalar(prhs[3]) < 1) {
+        mexErrMsgIdAndTxt( "MATLAB:read_envelope_mex_3p0:invalidWidthArg", "width input argument invalid; should be a positive number of bins");
+    }
+    si8 n_bins = (si8) mxGetScalar(prhs[3]);
+    si1 build_pyramids = MEF_FALSE;
+    if (nrhs > 4 && !mxIsEmpty(prhs[4])) {
+        if (!(mxIsLogical(prhs[4]) || mxIsNumeric(prhs[4])) || mxGetNumberOfElements(prhs[4]) != 1) {
+            mexErrMsgIdAndTxt( "MATLAB:read_envelope_mex_3p0:invalidBuildPyramidArg", "buildPyramid input argument invalid; should be true or false");
+        }
+        build_pyramids = (mxGetScalar(prhs[4]) != 0) ? MEF_TRUE : MEF_FALSE;
+    }
+
+    //
+    // read the channel metadata & time series indices
+    //
+
+    // initialize MEF library
+    (void) initialize_meflib();
+    static MEF_CONTEXT call_context;  // this call's context: the default context is shared by the gateways & threads
+    MEF_initialize_context(&call_context, NULL);
+    (void) MEF_set_context(&call_context);
+
+    MEF_context->behavior_on_fail = SUPPRESS_ERROR_OUTPUT;
+    CHANNEL *channel = read_MEF_channel(NULL, channel_path, TIME_SERIES_CHANNEL_TYPE, password, NULL, MEF_FALSE, MEF_FALSE);
+    MEF_context->behavior_on_fail = EXIT_ON_FAIL;
+    if (channel == NULL || channel->number_of_segments == 0) {
+        if (channel != NULL)
+            free_channel(channel, MEF_TRUE);
+        mexErrMsgIdAndTxt( "MATLAB:read_envelope_mex_3p0:readFailed", "Error: no segments in channel, most likely due to an invalid channel folder");
+    }
+    channel->segments[0].metadata_fps->directives.free_password_data = MEF_TRUE;
+    if (channel->channel_type != TIME_SERIES_CHANNEL_TYPE) {
+        free_channel(channel, MEF_TRUE);
+        mexErrMsgIdAndTxt( "MATLAB:read_envelope_mex_3p0:invalidChannel", "Error: not a time series channel");
+    }
+    if (channel->metadata.section_1->section_2_encryption > 0) {
+        free_channel(channel, MEF_TRUE);
+        if (password == NULL)
+            mexErrMsgIdAndTxt( "MATLAB:read_envelope_mex_3p0:encrypted", "Error: data is encrypted, but no password is given");
+        else
+            mexErrMsgIdAndTxt( "MATLAB:read_envelope_mex_3p0:wrongPassword", "Error: wrong password for encrypted data");
+    }
+
+    // the whole channel is from the first sample to the end of the last
+    if (whole_channel == MEF_TRUE) {
+        CONTINUITY_INDEX continuity_index = {0};
+        (void) CONTINUITY_build_index(channel, &continuity_index);
+        if (continuity_index.number_of_entries > 0) {
+            start_time = continuity_index.entries[0].start_time;
+            end_time = (si8) ceil(continuity_index.entries[continuity_index.number_of_entries - 1].end_time);
+        }
+        CONTINUITY_free_index(&continuity_index, MEF_FALSE);
+    }
+
+    //
+    // envelope
+    //
+    ENVELOPE *envelope = read_channel_envelope(channel, start_time, end_time, n_bins, build_pyramids);
+    free_channel(channel, MEF_TRUE);
+
+    const char *source = "";
+    switch (envelope->source) {
+        case ENVELOPE_SOURCE_INDICES:
+            source = "indices";
+            break;
+        case ENVELOPE_SOURCE_PYRAMID:
+            source = "pyramid";
+            break;
+        case ENVELOPE_SOURCE_SAMPLES:
+            source = "samples";
+            break;
+    }
+    plhs[0] = map_envelope_values(envelope->minimum, envelope->number_of_bins);
+    if (nlhs > 1)
+        plhs[1] = map_envelope_values(envelope->maximum, envelope->number_of_bins);
+    if (nlhs > 2)
+        plhs[2] = map_envelope_values(envelope->rms, envelope->number_of_bins);
+    if (nlhs > 3)
+        plhs[3] = mxCreateString(source);
+    ENVELOPE_free(envelope, MEF_TRUE);
+
+    (void) MEF_set_context(NULL);
+
+    // succesfull return from call
+    return;
+
+}
+
+// [EOF]
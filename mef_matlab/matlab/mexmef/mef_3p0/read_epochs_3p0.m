@@ -0,0 +1,52 @@
+function [epochs, channel_names] = read_epochs_3p0(ch_path,pw,rtype,ranges)
+% READ_EPOCHS_3P0 Read many epochs of MEF 3.0 channel(s) in one call
+% 
+% Syntax:
+%   [epochs, channel_names] = read_epochs_3p0(ch_path,pw,rtype,ranges)
+% 
+% Imput(s):
+%   ch_path         - [char] channel path of a MEF 3.0 session, or [cell]
+%                     1 x C channel paths
+%   pw              - [str] password for the desired level
+%   rtype           - [str] range type: the unit of the ranges ('samples',
+%                     'time')
+%   ranges          - [num] N x 2 matrix, one epoch per row: first and
+%                     last sample (samples, 1-based), or start (inclusive)
+%                     and end (exclusive) time in uUTC (time)
+% 
+% Output(s):
+%   epochs          - [num] N x L matrix of epochs, one per row ([cell]
+%                     N x 1 if the epochs differ in length); NaN for the
+%                     missing samples. For a cell array of channels,
+%                     [cell] 1 x C, one per channel
+%   channel_names   - [cell] 1 x C names of the channels
+% 
+% Note:
+%   This is a dummy function to check if the mex function has been
+%   compiled. If not, it will try to compile it.
+%
+%   Each channel is opened once and every block needed by the epochs is
+%   decoded once, even if the epochs overlap.
+% 
+% See also decompress_mef_3p0, read_mef_epochs.
+
+% Copyright 2026 Richard J. Cui. Created: Sun 10/18/2026 10:12:37.415 AM
+% $Revision: 0.1 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+%
+% Rocky Creek Dr NE
+% Rochester, MN 55906, USA
+%
+% Email: richard.cui@utoronto.ca
+
+% compile c-mex function
+% -----------------------
+% we are here, cuz we don't have the mex function compiled. So, do it now
+make_mex_mef
+
+% now get the epochs
+% ------------------
+[epochs, channel_names] = read_epochs_3p0(ch_path,pw,rtype,ranges);
+
+end % funciton
+
+% [EOF]
\ No newline at end of file
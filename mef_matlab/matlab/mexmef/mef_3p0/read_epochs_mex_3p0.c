@@ -0,0 +1,239 @@
+/**
+*     @file
+*     MEF 3.0 Library Matlab Wrapper
+*     Read many epochs (ranges of samples or time) of one or more MEF 3.0 time series channels in one call
+*
+*  This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+*  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+*  This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*  You should have received a copy of the GNU General Public License along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//  Copyright (c) Richard J. Cui Created: Sun 10/18/2026 10:12:37.415 AM
+//  $Revision: 0.3 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+//
+//  Rocky Creek Dr NE
+//  Rochester, MN 55906, USA
+//
+//  Email: richard.cui@utoronto.ca
+
+#include <ctype.h>
+#include "mex.h"
+#include "mef_mex_3p0.h"
+
+/**
+ *     Read the epochs of a channel
+ *
+ *  Each epoch is planned on its own (gaps as NaN), and the blocks of all epochs are then decoded once each, so
+ *  overlapping epochs do not decode the same blocks again.
+ *
+ *     @param channel          Pointer to the MEF channel object (time series indices read)
+ *    @param range_type       RANGE_BY_SAMPLES (1-based, first & last sample) or RANGE_BY_TIME (uUTC, start & end)
+ *    @param ranges           N x 2 matrix of ranges (column-major)
+ *    @param n_ranges         Number of ranges (N)
+ *     @return                 N x L double matrix if all the epochs have L samples, otherwise an N x 1 cell array of
+ *                             row vectors; NULL on failure
+ */
+mxArray *read_channel_epochs(CHANNEL *channel, bool range_type, sf8 *ranges, si8 n_ranges) {
+    CONTINUITY_INDEX continuity_index = {0};
+    si8 i, j, n_failed;
+
+    READ_PLAN *plans = (READ_PLAN *) mxCalloc((size_t) n_ranges, sizeof(READ_PLAN));
+    si4 **samples = (si4 **) mxCalloc((size_t) n_ranges, sizeof(si4 *));
+
+    // plan each epoch
+    if (range_type == RANGE_BY_TIME)
+        (void) CONTINUITY_build_index(channel, &continuity_index);
+    si1 same_length = MEF_TRUE;
+    for (i = 0; i < n_ranges; ++i) {
+        if (range_type == RANGE_BY_TIME)
+            (void) READ_PLAN_build(channel, &continuity_index, (si8) ranges[i], (si8) ranges[i + n_ranges], plans + i);
+        else
+            (void) READ_PLAN_build_for_samples(channel, (si8) ranges[i] - 1, (si8) ranges[i + n_ranges], plans + i);  // to zero-based, end exclusive
+        samples[i] = (si4 *) mxMalloc((size_t) (plans[i].number_of_samples + 1) * sizeof(si4));
+        if (plans[i].number_of_samples != plans[0].number_of_samples)
+            same_length = MEF_FALSE;
+    }
+    if (range_type == RANGE_BY_TIME)
+        CONTINUITY_free_index(&continuity_index, MEF_FALSE);
+
+    // decode the blocks of all the epochs once
+    n_failed = READ_PLAN_execute_batch(channel, plans, n_ranges, samples, THREAD_NUMBER_OF_THREADS_DEFAULT);
+    if (n_failed > 0)
+        mexPrintf("Warning: %ld block(s) of channel %s could not be decoded (CRC or access), inserted NaNs\n", (long) n_failed, channel->name);
+
+    // copy/cast the data to the matlab array (RED_NAN as NaN)
+    mxArray *mat_epochs = NULL;
+    mxDouble mxNaN = mxGetNaN();
+    if (n_failed >= 0) {
+        if (same_length == MEF_TRUE) {
+            si8 n_samps = (n_ranges) ? plans[0].number_of_samples : 0;
+            mat_epochs = mxCreateDoubleMatrix((mwSize) n_ranges, (mwSize) n_samps, mxREAL);
+            mxDouble *ptr_epochs = mxGetPr(mat_epochs);
+            for (i = 0; i < n_ranges; ++i)
+                for (j = 0; j < n_samps; ++j)
+                    ptr_epochs[i + j * n_ranges] = (samples[i][j] == RED_NAN) ? mxNaN : (sf8) samples[i][j];
+        } else {
+            mat_epochs = mxCreateCellMatrix((mwSize) n_ranges, 1);
+            for (i = 0; i < n_ranges; ++i) {
+                mxArray *mat_epoch = mxCreateDoubleMatrix(1, (mwSize) plans[i].number_of_samples, mxREAL);
+                mxDouble *ptr_epoch = mxGetPr(mat_epoch);
+                for (j = 0; j < plans[i].number_of_samples; ++j)
+                    ptr_epoch[j] = (samples[i][j] == RED_NAN) ? mxNaN : (sf8) samples[i][j];
+                mxSetCell(mat_epochs, (mwIndex) i, mat_epoch);
+            }
+        }
+    }
+
+    for (i = 0; i < n_ranges; ++i) {
+        READ_PLAN_free(plans + i, MEF_FALSE);
+        mxFree(samples[i]);
+    }
+    mxFree(plans);
+    mxFree(samples);
+
+    return mat_epochs;
+}
+
+//  the gate function
+/**
+* Main entry point for 'read_epochs_3p0'
+*
+* @param channelPath    Path (absolute or relative) to a MEF3 channel folder, or a cell array of channel paths
+* @param password       Password to the MEF3 data; Pass empty string/variable if not encrypted
+* @param rangeType      Modality of the ranges, either 'samples' (1-based first & last sample) or 'time' (uUTC, start
+*                       inclusive & end exclusive)
+* @param ranges         N x 2 matrix with one range per row
+* @return               [epochs, channelNames]: N x L matrix of epochs (N x 1 cell array if their lengths differ), or a
+*                       1 x C cell array of those for a cell array of channels; and the channel names (cell array)
+*/
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
+
+    //
+    // channel path(s)
+    //
+    if (nrhs < 4) {
+        mexErrMsgIdAndTxt( "MATLAB:read_epochs_mex_3p0:notEnoughArgs", "channelPath, password, rangeType and ranges input arguments must be set");
+    }
+    si1 is_cell = mxIsCell(prhs[0]) ? MEF_TRUE : MEF_FALSE;
+    si4 n_chans = (is_cell == MEF_TRUE) ? (si4) mxGetNumberOfElements(prhs[0]) : 1;
+    if (is_cell == MEF_FALSE && (!mxIsChar(prhs[0]) || mxIsEmpty(prhs[0]))) {
+        mexErrMsgIdAndTxt( "MATLAB:read_epochs_mex_3p0:invalidChannelPathArg", "channelPath input argument invalid, should be a non-empty string (array of characters) or a cell array of strings");
+    }
+    for (si4 i = 0; i < n_chans && is_cell == MEF_TRUE; ++i) {
+        const mxArray *mat_path = mxGetCell(prhs[0], (mwIndex) i);
+        if (mat_path == NULL || !mxIsChar(mat_path) || mxIsEmpty(mat_path))
+            mexErrMsgIdAndTxt( "MATLAB:read_epochs_mex_3p0:invalidChannelPathArg", "channelPath input argument invalid, should be a non-empty string (array of characters) or a cell array of strings");
+    }
+
+    //
+    // password
+    //
+    si1 *password = NULL;
+    si1 password_arr[PASSWORD_BYTES] = {0};
+    if (!mxIsEmpty(prhs[1])) {
+        if (!mxIsChar(prhs[1])) {
+            mexErrMsgIdAndTxt( "MATLAB:read_epochs_mex_3p0:invalidPasswordArg", "password input argument invalid, should string (array of characters)");
+        }
+        char *mat_password = mxArrayToString(prhs[1]);
+        MEF_strncpy(password_arr, mat_password, PASSWORD_BYTES);
+        mxFree(mat_password);
+        password = password_arr;
+    }
+
+    //
+    // range type & ranges
+    //
+    char range_type_str[16] = {0};
+    if (!mxIsChar(prhs[2]) || mxGetString(prhs[2], range_type_str, sizeof(range_type_str)) != 0) {
+        mexErrMsgIdAndTxt( "MATLAB:read_epochs_mex_3p0:invalidRangeTypeArg", "rangeType input argument invalid; allowed values are 'time' or 'samples'");
+    }
+    for (int i = 0; range_type_str[i]; i++)
+        range_type_str[i] = tolower(range_type_str[i]);
+    if (strcmp(range_type_str, "time") != 0 && strcmp(range_type_str, "samples") != 0) {
+        mexErrMsgIdAndTxt( "MATLAB:read_epochs_mex_3p0:invalidRangeTypeArg", "rangeType input argument invalid; allowed values are 'time' or 'samples'");
+    }
+    bool range_type = (strcmp(range_type_str, "time") == 0) ? RANGE_BY_TIME : RANGE_BY_SAMPLES;
+
+    if (!mxIsNumeric(prhs[3]) || mxIsComplex(prhs[3]) || mxGetN(prhs[3]) != 2) {
+        mexErrMsgIdAndTxt( "MATLAB:read_epochs_mex_3p0:invalidRangesArg", "ranges input argument invalid; should be a real N x 2 numeric matrix");
+    }
+    si8 n_ranges = (si8) mxGetM(prhs[3]);
+    mxArray *mat_ranges = mxIsDouble(prhs[3]) ? (mxArray *) prhs[3] : NULL;
+    if (mat_ranges == NULL) {
+        mxArray *mat_in = (mxArray *) prhs[3];
+        mexCallMATLAB(1, &mat_ranges, 1, &mat_in, "double");
+    }
+    sf8 *ranges = mxGetPr(mat_ranges);
+
+    //
+    // read the epochs, channel by channel
+    //
+
+    // initialize MEF library
+    (void) initialize_meflib();
+    static MEF_CONTEXT call_context;  // this call's context: the default context is shared by the gateways & threads
+    MEF_initialize_context(&call_context, NULL);
+    (void) MEF_set_context(&call_context);
+
+    mxArray *mat_chans = mxCreateCellMatrix(1, (mwSize) n_chans);
+    mxArray *mat_names = mxCreateCellMatrix(1, (mwSize) n_chans);
+    for (si4 c = 0; c < n_chans; ++c) {
+        si1 channel_path[MEF_FULL_FILE_NAME_BYTES];
+        char *mat_channel_path = mxArrayToString((is_cell == MEF_TRUE) ? mxGetCell(prhs[0], (mwIndex) c) : prhs[0]);
+        MEF_strncpy(channel_path, mat_channel_path, MEF_FULL_FILE_NAME_BYTES);
+        mxFree(mat_channel_path);
+
+        // metadata & time series indices only; the blocks are read as planned
+        MEF_context->behavior_on_fail = SUPPRESS_ERROR_OUTPUT;
+        CHANNEL *channel = read_MEF_channel(NULL, channel_path, TIME_SERIES_CHANNEL_TYPE, password, NULL, MEF_FALSE, MEF_FALSE);
+        MEF_context->behavior_on_fail = EXIT_ON_FAIL;
+        if (channel == NULL || channel->number_of_segments == 0) {
+            if (channel != NULL)
+                free_channel(channel, MEF_TRUE);
+            mexErrMsgIdAndTxt( "MATLAB:read_epochs_mex_3p0:readFailed", "Error: no segments in channel %s, most likely due to an invalid channel folder", channel_path);
+        }
+        channel->segments[0].metadata_fps->directives.free_password_data = MEF_TRUE;
+        if (channel->channel_type != TIME_SERIES_CHANNEL_TYPE) {
+            free_channel(channel, MEF_TRUE);
+            mexErrMsgIdAndTxt( "MATLAB:read_epochs_mex_3p0:invalidChannel", "Error: %s is not a time series channel", channel_path);
+        }
+        if (channel->metadata.section_1->section_2_encryption > 0) {
+            free_channel(channel, MEF_TRUE);
+            if (password == NULL)
+                mexErrMsgIdAndTxt( "MATLAB:read_epochs_mex_3p0:encrypted", "Error: data is encrypted, but no password is given");
+            else
+                mexErrMsgIdAndTxt( "MATLAB:read_epochs_mex_3p0:wrongPassword", "Error: wrong password for encrypted data");
+        }
+
+        mxArray *mat_epochs = read_channel_epochs(channel, range_type, ranges, n_ranges);
+        mxSetCell(mat_names, (mwIndex) c, mxCreateString(channel->name));
+        free_channel(channel, MEF_TRUE);
+        if (mat_epochs == NULL) {
+            mexErrMsgIdAndTxt( "MATLAB:read_epochs_mex_3p0:readFailed", "Error while reading the data of channel %s", channel_path);
+        }
+        mxSetCell(mat_chans, (mwIndex) c, mat_epochs);
+    }
+    if (mat_ranges != prhs[3])
+        mxDestroyArray(mat_ranges);
+
+    if (is_cell == MEF_TRUE) {
+        plhs[0] = mat_chans;
+    } else {
+        plhs[0] = mxDuplicateArray(mxGetCell(mat_chans, 0));
+        mxDestroyArray(mat_chans);
+    }
+    if (nlhs > 1)
+        plhs[1] = mat_names;
+    else
+        mxDestroyArray(mat_names);
+
+    (void) MEF_set_context(NULL);
+
+    // succesfull return from call
+    return;
+
+}
+
+// [EOF]
@@ -1,8 +1,10 @@
-function metadata = read_mef_info_3p0(sess_path,password,map_indices)
+function [metadata,profile] = read_mef_info_3p0(sess_path,password,map_indices,record_query)
 % READ_MEF_INFO_3P0 Read metadata information from MEF 3.0 dataset
 % 
 % Syntax:
 %   metadata = read_mef_info_3p0(sess_path,password,map_indices)
+%   metadata = read_mef_info_3p0(sess_path,password,map_indices,record_query)
+%   [metadata,profile] = read_mef_info_3p0(___)
 % 
 % Imput(s):
 %   sess_path       - [str] session path
@@ -11,9 +13,19 @@ function metadata = read_mef_info_3p0(sess_path,password,map_indices)
 %                     .Level2Password
 %                     .AccessLevel
 %   map_indices     - [logical] 'ture' means to map indices
+%   record_query    - [struct] (opt) read only the records selected by
+%                     .start_time   : [num] uUTC, inclusive ([] = first)
+%                     .end_time     : [num] uUTC, inclusive ([] = last)
+%                     .types        : [cell] record types, e.g.
+%                                     {'Note','Seiz'} ([] = all types)
+%                     only the matching records are read (and decrypted)
+%                     from the record data files (default = [], read all
+%                     records)
 % 
 % Output(s):
 %   metadata        - [struct] MEF 3.0 metadata structure
+%   profile         - [struct] (opt) where the time of the read went,
+%                     collected only if asked for (see decompress_mef_3p0)
 % 
 % Note:
 %   This is a dummy function to check if the mex function has been
@@ -22,7 +34,7 @@ function metadata = read_mef_info_3p0(sess_path,password,map_indices)
 % See also mefsession_3p0.read_mef_info.
 
 % Copyright 2020 Richard J. Cui. Created: Mon 11/02/2020  3:44:14.289 PM
-% $Revision: 0.1 $  $Date: Mon 11/02/2020  3:44:14.289 PM $
+% $Revision: 0.3 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
 %
 % Rocky Creek Dr NE
 % Rochester, MN 55906, USA
@@ -36,7 +48,14 @@ make_mex_mef
 
 % now get the info
 % ----------------
-metadata = read_mef_info_3p0(sess_path,password,map_indices);
+if nargin < 4
+    record_query = [];
+end % if
+if nargout > 1
+    [metadata,profile] = read_mef_info_3p0(sess_path,password,map_indices,record_query);
+else
+    metadata = read_mef_info_3p0(sess_path,password,map_indices,record_query);
+end % if
 
 end % funciton
 
@@ -15,7 +15,7 @@
 */
 
 //  Modified by Richard J. Cui: Wed 05/29/2019  9:49:29.694 PM
-//  $Revision: 0.5 $  $Date: Mon 11/02/2020  9:21:42.834 AM $
+//  $Revision: 0.10 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
 //
 //  Rocky Creek Dr NE
 //  Rochester, MN 55906, USA
@@ -24,8 +24,9 @@
 
 #include "mex.h"
 #include "mef_mex_3p0.h"
-#include "meflib.c"
-#include "mefrec.c"
+
+//  record query of the current call (NULL => all records are read and mapped)
+RECORD_QUERY *record_query = NULL;
 
 ///
 // Functions for converting c-objects to matlab-structs
@@ -524,6 +525,8 @@ mxArray *map_mef3_vi(VIDEO_INDEX *vi, si8 number_of_entries) {
 /**
  *     Map the MEF records to a matlab-struct
  *
+ *  If a record query is set, only the matching records are read (and decrypted) from the record data file
+ *
  *     @param ri_fps
  *     @param rd_fps
  */
@@ -532,9 +535,14 @@ mxArray *map_mef3_records(FILE_PROCESSING_STRUCT *ri_fps, FILE_PROCESSING_STRUCT
     RECORD_HEADER *rh;
     ui4     *type_str_int;
     ui4     type_code;
+    RECORD_QUERY_RESULT *query_result = NULL;
     
     // retrieve the number of records
     si8 number_of_records = ri_fps->universal_header->number_of_entries;
+    if (record_query != NULL) {
+        query_result = RECORD_query_file(ri_fps, rd_fps, record_query, NULL, RECORD_QUERY_NO_LEVEL, RECORD_QUERY_NO_LEVEL);
+        number_of_records = query_result->number_of_records;
+    }
 
     // create custom record struct list
     const int RECORD_NUMFIELDS        = 5;
@@ -554,7 +562,10 @@ mxArray *map_mef3_records(FILE_PROCESSING_STRUCT *ri_fps, FILE_PROCESSING_STRUCT
     for (i = 0; i < number_of_records; ++i) {
         
         // cast the record header
-        rh = (RECORD_HEADER *) rd;
+        if (query_result != NULL)
+            rh = (RECORD_HEADER *) (query_result->records + query_result->matches[i].record_offset);
+        else
+            rh = (RECORD_HEADER *) rd;
 
 
         //
@@ -688,9 +699,11 @@ mxArray *map_mef3_records(FILE_PROCESSING_STRUCT *ri_fps, FILE_PROCESSING_STRUCT
                 break;
             case MEFREC_UnRc_TYPE_CODE:
                 mexPrintf("Error: \"%s\" (0x%x) is an unrecognized record type\n", rh->type_string, type_code);
+                RECORD_free_query_result(query_result, MEF_TRUE);
                 return NULL;
             default:
                 mexPrintf("Error: \"%s\" (0x%x) is an unrecognized record type\n", rh->type_string, type_code);
+                RECORD_free_query_result(query_result, MEF_TRUE);
                 return NULL;
         }
         
@@ -698,6 +711,7 @@ mxArray *map_mef3_records(FILE_PROCESSING_STRUCT *ri_fps, FILE_PROCESSING_STRUCT
         rd += (RECORD_HEADER_BYTES + rh->bytes);
         
     }
+    RECORD_free_query_result(query_result, MEF_TRUE);
     
     // return the struct
     return mat_records;
@@ -975,6 +989,35 @@ mxArray *mxStringByUTF8Value(char *str) {
     
 }
 
+/**
+ *     Map an instrumentation profile to a matlab struct (times in seconds)
+ *
+ *     @param profile            Pointer to the profile (ended)
+ *     @return                    Struct with the fields wall_time, cpu_time, one struct (wall_time, cpu_time, calls) per
+ *                              phase (open, read, crc, aes, decode, convert), bytes_read, blocks_decoded, crc_failures,
+ *                              allocations and allocated_bytes
+ */
+mxArray *map_mef3_profile(MEF_PROFILE *profile) {
+    const char *fieldnames[] = {"wall_time", "cpu_time", "open", "read", "crc", "aes", "decode", "convert", "bytes_read", "blocks_decoded", "crc_failures", "allocations", "allocated_bytes"};
+    const char *phase_fieldnames[] = {"wall_time", "cpu_time", "calls"};
+    mxArray *mat_profile = mxCreateStructMatrix(1, 1, 13, fieldnames);
+    mxSetField(mat_profile, 0, "wall_time", mxCreateDoubleScalar((sf8) profile->wall_ns / 1e9));
+    mxSetField(mat_profile, 0, "cpu_time", mxCreateDoubleScalar((sf8) profile->CPU_ns / 1e9));
+    for (si4 i = 0; i < PROFILE_NUMBER_OF_PHASES; ++i) {
+        mxArray *mat_phase = mxCreateStructMatrix(1, 1, 3, phase_fieldnames);
+        mxSetField(mat_phase, 0, "wall_time", mxCreateDoubleScalar((sf8) profile->phase_wall_ns[i] / 1e9));
+        mxSetField(mat_phase, 0, "cpu_time", mxCreateDoubleScalar((sf8) profile->phase_CPU_ns[i] / 1e9));
+        mxSetField(mat_phase, 0, "calls", mxCreateDoubleScalar((sf8) profile->phase_calls[i]));
+        mxSetField(mat_profile, 0, PROFILE_phase_name(i), mat_phase);
+    }
+    mxSetField(mat_profile, 0, "bytes_read", mxCreateDoubleScalar((sf8) profile->bytes_read));
+    mxSetField(mat_profile, 0, "blocks_decoded", mxCreateDoubleScalar((sf8) profile->blocks_decoded));
+    mxSetField(mat_profile, 0, "crc_failures", mxCreateDoubleScalar((sf8) profile->CRC_failures));
+    mxSetField(mat_profile, 0, "allocations", mxCreateDoubleScalar((sf8) profile->allocations));
+    mxSetField(mat_profile, 0, "allocated_bytes", mxCreateDoubleScalar((sf8) profile->allocated_bytes));
+    return mat_profile;
+}
+
 //  the gate funciton
 /**
  * Main entry point for 'read_mef_info_mex_3p9'
@@ -982,7 +1025,12 @@ mxArray *mxStringByUTF8Value(char *str) {
  * @param sessionPath    Path (absolute or relative) to the MEF3 session folder
  * @param password        Password to the MEF3 data; Pass empty string/variable if not encrypted
  * @param mapIndices    Flag whether indices should be mapped [0 or 1; default is 0]
+ * @param recordQuery   (optional) Struct selecting the records to read: 'start_time' & 'end_time' (uUTC, inclusive;
+ *                      empty or omitted => unbounded) and 'types' (char array or cell array of 4-character record
+ *                      types, e.g. {'Note', 'Seiz'}; empty or omitted => all types). Only the matching records are
+ *                      read from the record data files.
  * @return                Structure containing session metadata, channels metadata, segments metadata and records
+ * @return                (optional) The instrumentation profile of the read (collected only if asked for)
  */
 void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
     
@@ -1073,23 +1121,89 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
     }
     
     
+    //
+    // record query (optional)
+    //
+    
+    RECORD_QUERY query;
+    record_query = NULL;
+    
+    // check if a record query input argument is given
+    if (nrhs > 3 && !mxIsEmpty(prhs[3])) {
+        
+        if (!mxIsStruct(prhs[3]) || mxGetNumberOfElements(prhs[3]) != 1) {
+            mexErrMsgIdAndTxt( "MATLAB:read_mef_info_mex_3p0:invalidRecordQueryArg", "recordQuery input argument invalid, should be a single struct");
+        }
+        RECORD_initialize_query(&query, UUTC_NO_ENTRY, UUTC_NO_ENTRY);
+        
+        // time range
+        mxArray *mat_time = mxGetField(prhs[3], 0, "start_time");
+        if (mat_time != NULL && !mxIsEmpty(mat_time)) {
+            if (!mxIsNumeric(mat_time) || mxGetNumberOfElements(mat_time) > 1) {
+                mexErrMsgIdAndTxt( "MATLAB:read_mef_info_mex_3p0:invalidRecordQueryArg", "recordQuery.start_time invalid, should be a single value numeric (uUTC)");
+            }
+            query.start_time = (si8) mxGetScalar(mat_time);
+        }
+        mat_time = mxGetField(prhs[3], 0, "end_time");
+        if (mat_time != NULL && !mxIsEmpty(mat_time)) {
+            if (!mxIsNumeric(mat_time) || mxGetNumberOfElements(mat_time) > 1) {
+                mexErrMsgIdAndTxt( "MATLAB:read_mef_info_mex_3p0:invalidRecordQueryArg", "recordQuery.end_time invalid, should be a single value numeric (uUTC)");
+            }
+            query.end_time = (si8) mxGetScalar(mat_time);
+        }
+        
+        // record types
+        mxArray *mat_types = mxGetField(prhs[3], 0, "types");
+        if (mat_types != NULL && !mxIsEmpty(mat_types)) {
+            si4 n_types = mxIsCell(mat_types) ? (si4) mxGetNumberOfElements(mat_types) : 1;
+            for (si4 i = 0; i < n_types; ++i) {
+                const mxArray *mat_type = mxIsCell(mat_types) ? mxGetCell(mat_types, (mwIndex) i) : mat_types;
+                if (mat_type == NULL || !mxIsChar(mat_type) || mxGetNumberOfElements(mat_type) != TYPE_BYTES - 1) {
+                    mexErrMsgIdAndTxt( "MATLAB:read_mef_info_mex_3p0:invalidRecordQueryArg", "recordQuery.types invalid, should be 4-character record types (e.g. 'Note' or {'Note', 'Seiz'})");
+                }
+                si1 type_string[TYPE_BYTES];
+                mxGetString(mat_type, type_string, TYPE_BYTES);
+                if (RECORD_add_query_type(&query, type_string) != 0) {
+                    mexErrMsgIdAndTxt( "MATLAB:read_mef_info_mex_3p0:invalidRecordQueryArg", "recordQuery.types invalid, at most %d record types", RECORD_QUERY_MAXIMUM_TYPE_CODES);
+                }
+            }
+        }
+        
+        record_query = &query;
+        
+    }
+    
+    
     //
     // read session metadata
     //
     
     // initialize MEF library
     initialize_meflib();
+    static MEF_CONTEXT call_context;  // this call's context: the default context is shared by the gateways & threads
+    MEF_initialize_context(&call_context, NULL);
+    (void) MEF_set_context(&call_context);
+
+    // profile the read if a second output is expected
+    static MEF_PROFILE profile;
+    if (nlhs > 1)
+        PROFILE_begin(&profile);
+    MEF_context->profile = (nlhs > 1) ? &profile : NULL;
+
+    // read the session into an arena (released with one free once mapped), with positional reads & no file locks
+    MEF_context->allocation_mode = MEF_ALLOCATE_IN_ARENA;
+    MEF_context->IO_mode = MEF_IO_POSITIONAL;
 
     // read the session metadata
-    MEF_globals->behavior_on_fail = SUPPRESS_ERROR_OUTPUT;
+    MEF_context->behavior_on_fail = SUPPRESS_ERROR_OUTPUT;
     SESSION *session = read_MEF_session(    NULL,                     // allocate new session object
                                             session_path,             // session filepath
                                             password,                 // password
                                             NULL,                     // empty password
                                             MEF_FALSE,                 // do not read time series data
-                                            MEF_TRUE                // read record data
+                                            (record_query == NULL)  // read record data (with a record query, only the matching records are read when mapped)
                                         );
-    MEF_globals->behavior_on_fail = EXIT_ON_FAIL;
+    MEF_context->behavior_on_fail = EXIT_ON_FAIL;
     
     // check for error
     if (session == NULL)    mexErrMsgTxt("Error while reading session metadata");
@@ -1120,12 +1234,27 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
         
         // map session object to matlab output struct
         // and assign to the first return argument
+        PROFILE_TIMER timer;
+        PROFILE_START(timer);
         plhs[0] = map_mef3_session(session, map_indices_flag);
+        PROFILE_STOP(timer, PROFILE_PHASE_CONVERT);
         
     }
     
     // free the session memory
     free_session(session, MEF_TRUE);
+    record_query = NULL;
+    
+    // return the profile
+    MEF_context->profile = NULL;
+    MEF_context->allocation_mode = MEF_ALLOCATE_ON_HEAP;
+    MEF_context->IO_mode = MEF_IO_STREAM;
+    if (nlhs > 1) {
+        PROFILE_end(&profile);
+        plhs[1] = map_mef3_profile(&profile);
+    }
+    
+    (void) MEF_set_context(NULL);
     
     //
     return;
@@ -0,0 +1,80 @@
+function records = read_mef_records_3p0(sess_path,password,start_time,end_time,types)
+% READ_MEF_RECORDS_3P0 Read the records of a MEF 3.0 session into columns
+% 
+% Syntax:
+%   records = read_mef_records_3p0(sess_path)
+%   records = read_mef_records_3p0(__,password)
+%   records = read_mef_records_3p0(__,password,start_time,end_time)
+%   records = read_mef_records_3p0(__,password,start_time,end_time,types)
+% 
+% Imput(s):
+%   sess_path       - [char] session path
+%   password        - [char] (opt) password of the MEF 3.0 data; empty if
+%                     not encrypted (default = [])
+%   start_time      - [num] (opt) start of the time range (uUTC,
+%                     inclusive); empty = first record (default = [])
+%   end_time        - [num] (opt) end of the time range (uUTC, inclusive);
+%                     empty = last record (default = [])
+%   types           - [char/cell] (opt) record type(s), e.g. 'Note' or
+%                     {'Note','Seiz'}; empty = all types (default = [])
+% 
+% Output(s):
+%   records         - [struct] record columns
+%                     .channel_names : [cell] time series channel names
+%                     .<type>        : [struct] one per record type found
+%                                      (Note, Seiz, EDFA, CSti, ESti, LNTP,
+%                                      SyLg), each field a column with one
+%                                      row per record:
+%                       .time        : [int64] record time (uUTC)
+%                       .channel     : [int32] index into channel_names;
+%                                      0 = session level record
+%                       .segment     : [int32] segment number within the
+%                                      channel; 0 = session or channel
+%                                      level record
+%                       .<field>     : body fields of the type (e.g. text
+%                                      of Note, earliest_onset of Seiz);
+%                                      text in cell arrays
+% 
+% Note:
+%   This is a dummy function to check if the mex function has been
+%   compiled. If not, it will try to compile it.
+%
+%   Only the records in the time range and of the given types are read
+%   from the record data files, and each column is a single array, so a
+%   type converts directly to a table, e.g. struct2table(records.Note).
+%   Body columns of records that cannot be decrypted are left empty.
+% 
+% See also read_mef_info_3p0.
+
+% Copyright 2026 Richard J. Cui. Created: Sun 10/18/2026 10:12:37.415 AM
+% $Revision: 0.1 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+%
+% Rocky Creek Dr NE
+% Rochester, MN 55906, USA
+%
+% Email: richard.cui@utoronto.ca
+
+% compile c-mex function
+% -----------------------
+% we are here, cuz we don't have the mex function compiled. So, do it now
+make_mex_mef
+
+% now read the records
+% --------------------
+if nargin < 2
+    password = [];
+end % if
+if nargin < 3
+    start_time = [];
+end % if
+if nargin < 4
+    end_time = [];
+end % if
+if nargin < 5
+    types = [];
+end % if
+records = read_mef_records_3p0(sess_path,password,start_time,end_time,types);
+
+end % funciton
+
+% [EOF]
\ No newline at end of file
@@ -0,0 +1,373 @@
+/**
+*     @file
+*     MEF 3.0 Library Matlab Wrapper
+*     Read the records of a MEF 3.0 session into columns (one struct of column vectors per record type)
+*
+*  This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+*  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+*  This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*  You should have received a copy of the GNU General Public License along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//  Copyright (c) Richard J. Cui Created: Sun 10/18/2026 10:12:37.415 AM
+//  $Revision: 0.3 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+//
+//  Rocky Creek Dr NE
+//  Rochester, MN 55906, USA
+//
+//  Email: richard.cui@utoronto.ca
+
+#include "mex.h"
+#include "mef_mex_3p0.h"
+
+//  columns common to all record types
+const int RECORD_COLUMNS_NUMFIELDS          = 3;
+const char *RECORD_COLUMNS_FIELDNAMES[]     = {
+    "time",             // int64, uUTC
+    "channel",          // int32, index into channel_names (0 => session level record)
+    "segment"           // int32, segment number within the channel (0 => session or channel level record)
+};
+
+//  text records (Note, SyLg)
+const int MEFREC_TEXT_1_0_NUMFIELDS         = 1;
+const char *MEFREC_TEXT_1_0_FIELDNAMES[]    = {
+    "text"
+};
+
+//  record types exported (in output field order)
+#define RECORD_COLUMNS_NUMBER_OF_TYPES      7
+const char *RECORD_COLUMNS_TYPE_STRINGS[]   = {
+    MEFREC_Note_TYPE_STRING,
+    MEFREC_Seiz_TYPE_STRING,
+    MEFREC_EDFA_TYPE_STRING,
+    MEFREC_CSti_TYPE_STRING,
+    MEFREC_ESti_TYPE_STRING,
+    MEFREC_LNTP_TYPE_STRING,
+    MEFREC_SyLg_TYPE_STRING
+};
+
+/**
+ *     Create a column vector (n x 1) of the given numeric class
+ */
+mxArray *mxCreateNumericColumn(si8 number_of_rows, mxClassID class_id) {
+    return mxCreateNumericMatrix((mwSize) number_of_rows, 1, class_id, mxREAL);
+}
+
+/**
+ *     Map all query matches of one record type to a struct of columns
+ *
+ *  Each column is a single array (n x 1 numeric, or n x 1 cell for text), so the number of mxArrays does not grow with
+ *  the number of numeric fields. Records of other than version 1.0 keep their time, channel & segment, with empty text
+ *  and zero values in the body columns.
+ *
+ *     @param result           Query result with the records of all levels
+ *     @param type_code        Record type to map
+ *     @param number_of_rows   Number of matches of this type in result
+ *     @return                 Struct of columns (1 x 1)
+ */
+mxArray *map_mef3_record_columns(RECORD_QUERY_RESULT *result, ui4 type_code, si8 number_of_rows) {
+    const char  **body_fieldnames = NULL;
+    int         i, n_body_fields = 0;
+
+    switch (type_code) {
+        case MEFREC_Note_TYPE_CODE:
+        case MEFREC_SyLg_TYPE_CODE:
+            n_body_fields = MEFREC_TEXT_1_0_NUMFIELDS;
+            body_fieldnames = MEFREC_TEXT_1_0_FIELDNAMES;
+            break;
+        case MEFREC_Seiz_TYPE_CODE:
+            n_body_fields = MEFREC_SEIZ_1_0_NUMFIELDS;
+            body_fieldnames = MEFREC_SEIZ_1_0_FIELDNAMES;
+            break;
+        case MEFREC_EDFA_TYPE_CODE:
+            n_body_fields = MEFREC_EDFA_1_0_NUMFIELDS;
+            body_fieldnames = MEFREC_EDFA_1_0_FIELDNAMES;
+            break;
+        case MEFREC_CSti_TYPE_CODE:
+            n_body_fields = MEFREC_CSTI_1_0_NUMFIELDS;
+            body_fieldnames = MEFREC_CSTI_1_0_FIELDNAMES;
+            break;
+        case MEFREC_ESti_TYPE_CODE:
+            n_body_fields = MEFREC_ESTI_1_0_NUMFIELDS;
+            body_fieldnames = MEFREC_ESTI_1_0_FIELDNAMES;
+            break;
+        case MEFREC_LNTP_TYPE_CODE:
+            n_body_fields = MEFREC_LNTP_1_0_NUMFIELDS;
+            body_fieldnames = MEFREC_LNTP_1_0_FIELDNAMES;
+            break;
+    }
+
+    // common columns, then the body columns of this type
+    const char *fieldnames[RECORD_COLUMNS_NUMFIELDS + 8];
+    for (i = 0; i < RECORD_COLUMNS_NUMFIELDS; ++i)
+        fieldnames[i] = RECORD_COLUMNS_FIELDNAMES[i];
+    for (i = 0; i < n_body_fields; ++i)
+        fieldnames[RECORD_COLUMNS_NUMFIELDS + i] = body_fieldnames[i];
+    mxArray *mat_columns = mxCreateStructMatrix(1, 1, RECORD_COLUMNS_NUMFIELDS + n_body_fields, fieldnames);
+
+    // allocate the columns
+    mxArray *mat_col[RECORD_COLUMNS_NUMFIELDS + 8];
+    mat_col[0] = mxCreateNumericColumn(number_of_rows, mxINT64_CLASS);
+    mat_col[1] = mxCreateNumericColumn(number_of_rows, mxINT32_CLASS);
+    mat_col[2] = mxCreateNumericColumn(number_of_rows, mxINT32_CLASS);
+    si8 *time_col = (si8 *) mxGetData(mat_col[0]);
+    si4 *chan_col = (si4 *) mxGetData(mat_col[1]);
+    si4 *seg_col = (si4 *) mxGetData(mat_col[2]);
+    for (i = 0; i < n_body_fields; ++i) {
+        mxClassID class_id = mxCELL_CLASS;
+        switch (type_code) {
+            case MEFREC_Seiz_TYPE_CODE:  // earliest_onset, latest_offset, duration, number_of_channels, onset_code, then text
+                class_id = (i < 3) ? mxINT64_CLASS : (i < 5) ? mxINT32_CLASS : mxCELL_CLASS;
+                break;
+            case MEFREC_EDFA_TYPE_CODE:  // duration, annotation
+                class_id = (i == 0) ? mxINT64_CLASS : mxCELL_CLASS;
+                break;
+            case MEFREC_CSti_TYPE_CODE:  // task_type, stimulus_duration, stimulus_type, patient_response
+                class_id = (i == 1) ? mxINT64_CLASS : mxCELL_CLASS;
+                break;
+            case MEFREC_ESti_TYPE_CODE:  // amplitude, frequency, pulse_width, ampunit_code, mode_code, then text
+                class_id = (i < 2) ? mxDOUBLE_CLASS : (i == 2) ? mxINT64_CLASS : (i < 5) ? mxINT32_CLASS : mxCELL_CLASS;
+                break;
+            case MEFREC_LNTP_TYPE_CODE:  // length, template
+                class_id = (i == 0) ? mxINT64_CLASS : mxCELL_CLASS;
+                break;
+        }
+        if (class_id == mxCELL_CLASS)
+            mat_col[RECORD_COLUMNS_NUMFIELDS + i] = mxCreateCellMatrix((mwSize) number_of_rows, 1);
+        else
+            mat_col[RECORD_COLUMNS_NUMFIELDS + i] = mxCreateNumericColumn(number_of_rows, class_id);
+    }
+    mxArray **body_col = mat_col + RECORD_COLUMNS_NUMFIELDS;
+
+    // fill the rows (matches are in level & file order)
+    si8 row = 0;
+    for (si8 m = 0; m < result->number_of_records && row < number_of_rows; ++m) {
+        RECORD_HEADER *rh = (RECORD_HEADER *) (result->records + result->matches[m].record_offset);
+        if (*((ui4 *) rh->type_string) != type_code)
+            continue;
+
+        time_col[row] = rh->time;
+        chan_col[row] = result->matches[m].channel_number + 1;
+        seg_col[row] = result->matches[m].segment_number + 1;
+
+        if (rh->version_major == 1 && rh->version_minor == 0 && rh->encryption <= NO_ENCRYPTION) {
+            ui1 *body = (ui1 *) rh + RECORD_HEADER_BYTES;
+            switch (type_code) {
+                case MEFREC_Note_TYPE_CODE:
+                case MEFREC_SyLg_TYPE_CODE:
+                    mxSetCell(body_col[0], (mwIndex) row, mxCreateString((si1 *) body));
+                    break;
+                case MEFREC_Seiz_TYPE_CODE: {
+                    MEFREC_Seiz_1_0 *seiz_p = (MEFREC_Seiz_1_0 *) body;
+                    ((si8 *) mxGetData(body_col[0]))[row] = seiz_p->earliest_onset;
+                    ((si8 *) mxGetData(body_col[1]))[row] = seiz_p->latest_offset;
+                    ((si8 *) mxGetData(body_col[2]))[row] = seiz_p->duration;
+                    ((si4 *) mxGetData(body_col[3]))[row] = seiz_p->number_of_channels;
+                    ((si4 *) mxGetData(body_col[4]))[row] = seiz_p->onset_code;
+                    mxSetCell(body_col[5], (mwIndex) row, mxCreateString(seiz_p->marker_name_1));
+                    mxSetCell(body_col[6], (mwIndex) row, mxCreateString(seiz_p->marker_name_2));
+                    mxSetCell(body_col[7], (mwIndex) row, mxCreateString(seiz_p->annotation));
+                    break;
+                }
+                case MEFREC_EDFA_TYPE_CODE: {
+                    MEFREC_EDFA_1_0 *edfa_p = (MEFREC_EDFA_1_0 *) body;
+                    ((si8 *) mxGetData(body_col[0]))[row] = edfa_p->duration;
+                    mxSetCell(body_col[1], (mwIndex) row, mxCreateString((si1 *) rh + MEFREC_EDFA_1_0_ANNOTATION_OFFSET));
+                    break;
+                }
+                case MEFREC_CSti_TYPE_CODE: {
+                    MEFREC_CSti_1_0 *csti_p = (MEFREC_CSti_1_0 *) body;
+                    mxSetCell(body_col[0], (mwIndex) row, mxCreateString(csti_p->task_type));
+                    ((si8 *) mxGetData(body_col[1]))[row] = csti_p->stimulus_duration;
+                    mxSetCell(body_col[2], (mwIndex) row, mxCreateString(csti_p->stimulus_type));
+                    mxSetCell(body_col[3], (mwIndex) row, mxCreateString(csti_p->patient_response));
+                    break;
+                }
+                case MEFREC_ESti_TYPE_CODE: {
+                    MEFREC_ESti_1_0 *esti_p = (MEFREC_ESti_1_0 *) body;
+                    ((sf8 *) mxGetData(body_col[0]))[row] = esti_p->amplitude;
+                    ((sf8 *) mxGetData(body_col[1]))[row] = esti_p->frequency;
+                    ((si8 *) mxGetData(body_col[2]))[row] = esti_p->pulse_width;
+                    ((si4 *) mxGetData(body_col[3]))[row] = esti_p->ampunit_code;
+                    ((si4 *) mxGetData(body_col[4]))[row] = esti_p->mode_code;
+                    mxSetCell(body_col[5], (mwIndex) row, mxCreateString(esti_p->waveform));
+                    mxSetCell(body_col[6], (mwIndex) row, mxCreateString(esti_p->anode));
+                    mxSetCell(body_col[7], (mwIndex) row, mxCreateString(esti_p->catode));
+                    break;
+                }
+                case MEFREC_LNTP_TYPE_CODE: {
+                    MEFREC_LNTP_1_0 *lntp_p = (MEFREC_LNTP_1_0 *) body;
+                    si8 len = lntp_p->length;
+                    if (len < 0 || (si8) sizeof(MEFREC_LNTP_1_0) + len * (si8) sizeof(si4) > (si8) rh->bytes)
+                        len = 0;  // inconsistent length
+                    ((si8 *) mxGetData(body_col[0]))[row] = lntp_p->length;
+                    mxSetCell(body_col[1], (mwIndex) row, mxInt32ArrayByValue((si4 *) ((ui1 *) rh + MEFREC_LNTP_1_0_TEMPLATE_OFFSET), (int) len));
+                    break;
+                }
+            }
+        }
+        ++row;
+    }
+
+    for (i = 0; i < RECORD_COLUMNS_NUMFIELDS + n_body_fields; ++i)
+        mxSetFieldByNumber(mat_columns, 0, i, mat_col[i]);
+
+    return mat_columns;
+}
+
+/**
+ *     Create a int32 row-vector from a c-array
+ */
+mxArray *mxInt32ArrayByValue(si4 *array, int num_ints) {
+    mxArray *retArr = mxCreateNumericMatrix(1, num_ints, mxINT32_CLASS, mxREAL);
+    if (num_ints > 0)
+        memcpy(mxGetData(retArr), array, (size_t) num_ints * sizeof(si4));
+    return retArr;
+}
+
+//  the gate function
+/**
+* Main entry point for 'read_mef_records_3p0'
+*
+* @param sessionPath    Path (absolute or relative) to the MEF3 session folder
+* @param password       (optional) Password to the MEF3 data; empty if not encrypted
+* @param startTime      (optional) Start of the time range (uUTC, inclusive; empty => first record)
+* @param endTime        (optional) End of the time range (uUTC, inclusive; empty => last record)
+* @param types          (optional) Record type(s) to read, char array or cell array of 4-character types (empty => all types)
+* @return               Struct with 'channel_names' and one struct of column vectors per record type found
+*                       (Note, Seiz, EDFA, CSti, ESti, LNTP, SyLg)
+*/
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
+
+    //
+    // session path
+    //
+    if (nrhs < 1) {
+        mexErrMsgIdAndTxt( "MATLAB:read_mef_records_mex_3p0:noSessionPathArg", "sessionPath input argument not set");
+    }
+    if (!mxIsChar(prhs[0]) || mxIsEmpty(prhs[0])) {
+        mexErrMsgIdAndTxt( "MATLAB:read_mef_records_mex_3p0:invalidSessionPathArg", "sessionPath input argument invalid, should be a non-empty string (array of characters)");
+    }
+    si1 session_path[MEF_FULL_FILE_NAME_BYTES];
+    char *mat_session_path = mxArrayToString(prhs[0]);
+    MEF_strncpy(session_path, mat_session_path, MEF_FULL_FILE_NAME_BYTES);
+    mxFree(mat_session_path);
+
+    //
+    // password (optional)
+    //
+    si1 *password = NULL;
+    si1 password_arr[PASSWORD_BYTES] = {0};
+    if (nrhs > 1 && !mxIsEmpty(prhs[1])) {
+        if (!mxIsChar(prhs[1])) {
+            mexErrMsgIdAndTxt( "MATLAB:read_mef_records_mex_3p0:invalidPasswordArg", "password input argument invalid, should string (array of characters)");
+        }
+        char *mat_password = mxArrayToString(prhs[1]);
+        MEF_strncpy(password_arr, mat_password, PASSWORD_BYTES);
+        mxFree(mat_password);
+        password = password_arr;
+    }
+
+    //
+    // time range & types (optional)
+    //
+    RECORD_QUERY query;
+    RECORD_initialize_query(&query, UUTC_NO_ENTRY, UUTC_NO_ENTRY);
+    if (nrhs > 2 && !mxIsEmpty(prhs[2])) {
+        if (!mxIsNumeric(prhs[2]) || mxGetNumberOfElements(prhs[2]) > 1) {
+            mexErrMsgIdAndTxt( "MATLAB:read_mef_records_mex_3p0:invalidStartTimeArg", "startTime input argument invalid; should be a single value numeric (uUTC)");
+        }
+        query.start_time = (si8) mxGetScalar(prhs[2]);
+    }
+    if (nrhs > 3 && !mxIsEmpty(prhs[3])) {
+        if (!mxIsNumeric(prhs[3]) || mxGetNumberOfElements(prhs[3]) > 1) {
+            mexErrMsgIdAndTxt( "MATLAB:read_mef_records_mex_3p0:invalidEndTimeArg", "endTime input argument invalid; should be a single value numeric (uUTC)");
+        }
+        query.end_time = (si8) mxGetScalar(prhs[3]);
+    }
+    if (nrhs > 4 && !mxIsEmpty(prhs[4])) {
+        si4 n_types = mxIsCell(prhs[4]) ? (si4) mxGetNumberOfElements(prhs[4]) : 1;
+        for (si4 i = 0; i < n_types; ++i) {
+            const mxArray *mat_type = mxIsCell(prhs[4]) ? mxGetCell(prhs[4], (mwIndex) i) : prhs[4];
+            if (mat_type == NULL || !mxIsChar(mat_type) || mxGetNumberOfElements(mat_type) != TYPE_BYTES - 1) {
+                mexErrMsgIdAndTxt( "MATLAB:read_mef_records_mex_3p0:invalidTypesArg", "types input argument invalid; should be 4-character record types (e.g. 'Note' or {'Note', 'Seiz'})");
+            }
+            si1 type_string[TYPE_BYTES];
+            mxGetString(mat_type, type_string, TYPE_BYTES);
+            if (RECORD_add_query_type(&query, type_string) != 0) {
+                mexErrMsgIdAndTxt( "MATLAB:read_mef_records_mex_3p0:invalidTypesArg", "types input argument invalid; at most %d record types", RECORD_QUERY_MAXIMUM_TYPE_CODES);
+            }
+        }
+    }
+
+    //
+    // read
+    //
+
+    // initialize MEF library
+    (void) initialize_meflib();
+    static MEF_CONTEXT call_context;  // this call's context: the default context is shared by the gateways & threads
+    MEF_initialize_context(&call_context, NULL);
+    (void) MEF_set_context(&call_context);
+
+    // open the session without its record data, then read only the matching records
+    MEF_context->behavior_on_fail = SUPPRESS_ERROR_OUTPUT;
+    SESSION *session = read_MEF_session(NULL, session_path, password, NULL, MEF_FALSE, MEF_FALSE);
+    if (session == NULL) {
+        MEF_context->behavior_on_fail = EXIT_ON_FAIL;
+        mexErrMsgIdAndTxt( "MATLAB:read_mef_records_mex_3p0:readFailed", "Error while reading session metadata");
+    }
+    RECORD_QUERY_RESULT *result = RECORD_query_session(session, &query, NULL);
+    MEF_context->behavior_on_fail = EXIT_ON_FAIL;
+
+    //
+    // map
+    //
+    if (nlhs > 0) {
+
+        // count the matches of each type
+        si8 counts[RECORD_COLUMNS_NUMBER_OF_TYPES] = {0};
+        ui4 type_codes[RECORD_COLUMNS_NUMBER_OF_TYPES];
+        const char *fieldnames[RECORD_COLUMNS_NUMBER_OF_TYPES + 1];
+        for (si4 t = 0; t < RECORD_COLUMNS_NUMBER_OF_TYPES; ++t)
+            memcpy(type_codes + t, RECORD_COLUMNS_TYPE_STRINGS[t], sizeof(ui4));
+        for (si8 m = 0; m < result->number_of_records; ++m) {
+            ui4 type_code = *((ui4 *) ((RECORD_HEADER *) (result->records + result->matches[m].record_offset))->type_string);
+            for (si4 t = 0; t < RECORD_COLUMNS_NUMBER_OF_TYPES; ++t) {
+                if (type_codes[t] == type_code) {
+                    ++counts[t];
+                    break;
+                }
+            }
+        }
+
+        // one field per type found
+        si4 n_fields = 0;
+        fieldnames[n_fields++] = "channel_names";
+        for (si4 t = 0; t < RECORD_COLUMNS_NUMBER_OF_TYPES; ++t)
+            if (counts[t] > 0)
+                fieldnames[n_fields++] = RECORD_COLUMNS_TYPE_STRINGS[t];
+        plhs[0] = mxCreateStructMatrix(1, 1, n_fields, fieldnames);
+
+        mxArray *mat_names = mxCreateCellMatrix(1, (mwSize) session->number_of_time_series_channels);
+        for (si4 i = 0; i < session->number_of_time_series_channels; ++i)
+            mxSetCell(mat_names, (mwIndex) i, mxCreateString(session->time_series_channels[i].name));
+        mxSetField(plhs[0], 0, "channel_names", mat_names);
+
+        for (si4 t = 0; t < RECORD_COLUMNS_NUMBER_OF_TYPES; ++t)
+            if (counts[t] > 0)
+                mxSetField(plhs[0], 0, RECORD_COLUMNS_TYPE_STRINGS[t], map_mef3_record_columns(result, type_codes[t], counts[t]));
+    }
+
+    RECORD_free_query_result(result, MEF_TRUE);
+    free_session(session, MEF_TRUE);
+
+    (void) MEF_set_context(NULL);
+
+    // succesfull return from call
+    return;
+
+}
+
+// [EOF]
@@ -0,0 +1,60 @@
+function data = remove_line_noise_3p0(data,fs,line_freq,n_cycles,n_threads)
+% remove_line_noise_3p0 Remove line noise from multi-channel data in parallel
+% 
+% Syntax:
+%   data = remove_line_noise_3p0(data,fs,line_freq)
+%   data = remove_line_noise_3p0(data,fs,line_freq,n_cycles)
+%   data = remove_line_noise_3p0(data,fs,line_freq,n_cycles,n_threads)
+% 
+% Imput(s):
+%   data            - [num] channels x samples data (e.g. EEG.data)
+%   fs              - [num] sampling frequency (Hz)
+%   line_freq       - [num] line frequency (Hz; 50 or 60)
+%   n_cycles        - [num] (opt) number of cycles of the adaptive
+%                     (running-median) template; 0 = one median template
+%                     for the whole record (default = 0)
+%   n_threads       - [num] (opt) number of worker threads; 0 = one per
+%                     processor (default = 0)
+% 
+% Output(s):
+%   data            - [num] data with the line noise removed
+% 
+% Note:
+%   This is a dummy function to check if the mex function has been
+%   compiled. If not, it will try to compile it.
+%
+%   Each channel is processed by the MEF 3.0 library routines
+%   remove_line_noise (n_cycles = 0) or remove_line_noise_adaptive
+%   (n_cycles > 0) in their integer domain, into which the channel is
+%   scaled (its largest magnitude to 2^28) and back, so no precision is
+%   lost to rounding to units. NaN runs are bridged by linear
+%   interpolation while filtering, and kept in the output.
+% 
+% See also decompress_mef_3p0.
+
+% Copyright 2026 Richard J. Cui. Created: Sun 10/18/2026 10:12:37.415 AM
+% $Revision: 0.2 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+%
+% Rocky Creek Dr NE
+% Rochester, MN 55906, USA
+%
+% Email: richard.cui@utoronto.ca
+
+% compile c-mex function
+% -----------------------
+% we are here, cuz we don't have the mex function compiled. So, do it now
+make_mex_mef
+
+% now remove the line noise
+% -------------------------
+if nargin < 4
+    n_cycles = 0;
+end % if
+if nargin < 5
+    n_threads = 0;
+end % if
+data = remove_line_noise_3p0(data,fs,line_freq,n_cycles,n_threads);
+
+end % funciton
+
+% [EOF]
\ No newline at end of file
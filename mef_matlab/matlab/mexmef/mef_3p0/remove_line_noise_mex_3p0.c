@@ -0,0 +1,239 @@
+/**
+*     @file
+*     MEF 3.0 Library Matlab Wrapper
+*     Remove line noise (and its harmonics) from multi-channel data, one channel per worker thread
+*
+*  This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+*  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+*  This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*  You should have received a copy of the GNU General Public License along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//  Copyright (c) Richard J. Cui Created: Sun 10/18/2026 10:12:37.415 AM
+//  $Revision: 0.4 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+//
+//  Rocky Creek Dr NE
+//  Rochester, MN 55906, USA
+//
+//  Email: richard.cui@utoronto.ca
+
+#include "mex.h"
+#include "mef_mex_3p0.h"
+
+//  the filter used by remove_line_noise() is an order 5 bandpass (10 poles), and filtfilt pads 3 x poles on each side
+#define LINE_NOISE_MIN_SAMPLES      60
+
+//  each channel is scaled so its largest magnitude maps to this many sample units in the si4 domain of
+//  remove_line_noise(), leaving headroom (x 8) for the filter & template below the si4 limits
+#define LINE_NOISE_SCALED_MAXIMUM   ((sf8) (1 << 28))
+
+//  per-channel status
+#define LINE_NOISE_OK               0
+#define LINE_NOISE_TOO_SHORT        1
+#define LINE_NOISE_NO_MEMORY        2
+
+/**
+ *  Arguments shared by all line-noise tasks (one task per channel)
+ *
+ *  Note: the tasks run on worker threads, so they only use the C library; no MATLAB API calls
+ */
+typedef struct {
+    sf8     *data;                  // channels x samples, column-major (as in EEGLAB's EEG.data), processed in place
+    si8     number_of_channels;
+    si8     number_of_samples;
+    sf8     sampling_frequency;
+    sf8     line_frequency;
+    si4     n_cycles;               // <= 0 => fixed template (remove_line_noise), > 0 => adaptive template of n_cycles
+    si4     *status;                // one entry per channel
+} LINE_NOISE_TASK_ARGS;
+
+/**
+ *     Remove the line noise of a single channel (thread task)
+ *
+ *  The channel is scaled into a si4 buffer (the integer domain used by remove_line_noise; the largest magnitude maps
+ *  to LINE_NOISE_SCALED_MAXIMUM, so sub-unit detail is kept & no value overflows), the noise removed, and the result
+ *  scaled back. NaN runs are bridged by linear interpolation between their neighbouring samples while filtering (no
+ *  steps at the gaps), and restored afterwards.
+ *
+ *     @param task_args        Pointer to the LINE_NOISE_TASK_ARGS
+ *    @param task_number        Channel index (0-based)
+ *    @param thread_number    Worker index (unused)
+ */
+void remove_line_noise_task(void *task_args, si8 task_number, si4 thread_number) {
+    LINE_NOISE_TASK_ARGS    *args = (LINE_NOISE_TASK_ARGS *) task_args;
+    si8     i, j, last_valid, n_chans = args->number_of_channels, n_samps = args->number_of_samples;
+    sf8     *chan_data = args->data + task_number;
+    sf8     val, max_abs, scale, step;
+    si4     *buf;
+    si1     *nan_mask;
+
+    // check if enough data for the filter and at least a couple of cycles
+    if (n_samps < LINE_NOISE_MIN_SAMPLES || n_samps < (si8) (2.0 * args->sampling_frequency / args->line_frequency)) {
+        args->status[task_number] = LINE_NOISE_TOO_SHORT;
+        return;
+    }
+
+    // scale (nothing to remove from a channel of zeros or NaNs)
+    max_abs = 0.0;
+    for (i = 0; i < n_samps; ++i) {
+        val = chan_data[i * n_chans];
+        if (!isnan(val) && fabs(val) > max_abs)
+            max_abs = fabs(val);
+    }
+    if (max_abs == 0.0 || !isfinite(max_abs)) {
+        args->status[task_number] = LINE_NOISE_OK;
+        return;
+    }
+    scale = LINE_NOISE_SCALED_MAXIMUM / max_abs;
+
+    buf = (si4 *) calloc((size_t) n_samps, sizeof(si4));
+    nan_mask = (si1 *) calloc((size_t) n_samps, sizeof(si1));
+    if (buf == NULL || nan_mask == NULL) {
+        free(buf);
+        free(nan_mask);
+        args->status[task_number] = LINE_NOISE_NO_MEMORY;
+        return;
+    }
+
+    // gather (strided by the number of channels), bridging NaN runs: linear between their neighbours, held at the ends
+    last_valid = -1;
+    for (i = 0; i < n_samps; ++i) {
+        val = chan_data[i * n_chans];
+        if (isnan(val)) {
+            nan_mask[i] = 1;
+            continue;
+        }
+        buf[i] = RED_round(val * scale);
+        if (i > last_valid + 1) {
+            step = (last_valid < 0) ? 0.0 : ((sf8) buf[i] - (sf8) buf[last_valid]) / (sf8) (i - last_valid);
+            for (j = last_valid + 1; j < i; ++j)
+                buf[j] = (last_valid < 0) ? buf[i] : RED_round((sf8) buf[last_valid] + (step * (sf8) (j - last_valid)));
+        }
+        last_valid = i;
+    }
+    for (j = last_valid + 1; j < n_samps; ++j)
+        buf[j] = buf[last_valid];
+
+    // remove the line noise
+    if (args->n_cycles > 0)
+        remove_line_noise_adaptive(buf, n_samps, args->sampling_frequency, args->line_frequency, args->n_cycles);
+    else
+        (void) remove_line_noise(buf, n_samps, args->sampling_frequency, args->line_frequency, NULL);
+
+    // scatter
+    for (i = 0; i < n_samps; ++i)
+        chan_data[i * n_chans] = nan_mask[i] ? NAN : (sf8) buf[i] / scale;
+
+    free(buf);
+    free(nan_mask);
+    args->status[task_number] = LINE_NOISE_OK;
+
+}
+
+//  the gate function
+/**
+* Main entry point for 'remove_line_noise_3p0'
+*
+* @param data                Channels x samples matrix of doubles (e.g. EEG.data)
+* @param samplingFrequency    Sampling frequency (Hz)
+* @param lineFrequency        Line frequency (Hz; e.g. 50 or 60)
+* @param nCycles            Number of cycles of the adaptive template (0 or omitted => one template for the whole record)
+* @param nThreads            Number of worker threads (0 or omitted => one per processor)
+* @return                    The data with the line noise removed (same size as the input)
+*/
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
+
+    //
+    // data
+    //
+    if(nrhs < 3) {
+        mexErrMsgIdAndTxt( "MATLAB:remove_line_noise_mex_3p0:notEnoughArgs", "data, samplingFrequency and lineFrequency input arguments must be set");
+    }
+    if(!mxIsDouble(prhs[0]) || mxIsComplex(prhs[0]) || mxGetNumberOfDimensions(prhs[0]) > 2) {
+        mexErrMsgIdAndTxt( "MATLAB:remove_line_noise_mex_3p0:invalidDataArg", "data input argument invalid; should be a real 2-D double matrix (channels x samples)");
+    }
+
+    //
+    // frequencies
+    //
+    if (!mxIsNumeric(prhs[1]) || mxGetNumberOfElements(prhs[1]) != 1 || mxGetScalar(prhs[1]) <= 0) {
+        mexErrMsgIdAndTxt( "MATLAB:remove_line_noise_mex_3p0:invalidSamplingFrequencyArg", "samplingFrequency input argument invalid; should be a single positive value");
+    }
+    if (!mxIsNumeric(prhs[2]) || mxGetNumberOfElements(prhs[2]) != 1 || mxGetScalar(prhs[2]) <= 10) {
+        mexErrMsgIdAndTxt( "MATLAB:remove_line_noise_mex_3p0:invalidLineFrequencyArg", "lineFrequency input argument invalid; should be a single value > 10 Hz");
+    }
+    sf8 sampling_frequency = mxGetScalar(prhs[1]);
+    sf8 line_frequency = mxGetScalar(prhs[2]);
+
+    // the bandpass filter spans the line frequency up to its 5th harmonic (+ 10 Hz)
+    if ((line_frequency * 5.0) + 10.0 >= sampling_frequency / 2.0) {
+        mexErrMsgIdAndTxt( "MATLAB:remove_line_noise_mex_3p0:invalidLineFrequencyArg", "samplingFrequency too low; the Nyquist frequency must exceed 5 x lineFrequency + 10 Hz");
+    }
+
+    //
+    // number of cycles & threads (optional)
+    //
+    si4 n_cycles = 0;
+    si4 n_threads = THREAD_NUMBER_OF_THREADS_DEFAULT;
+    if (nrhs > 3 && !mxIsEmpty(prhs[3])) {
+        if (!mxIsNumeric(prhs[3]) || mxGetNumberOfElements(prhs[3]) > 1 || mxGetScalar(prhs[3]) < 0) {
+            mexErrMsgIdAndTxt( "MATLAB:remove_line_noise_mex_3p0:invalidNCyclesArg", "nCycles input argument invalid; should be a single value numeric (>= 0)");
+        }
+        n_cycles = (si4) mxGetScalar(prhs[3]);
+    }
+    if (nrhs > 4 && !mxIsEmpty(prhs[4])) {
+        if (!mxIsNumeric(prhs[4]) || mxGetNumberOfElements(prhs[4]) > 1 || mxGetScalar(prhs[4]) < 0) {
+            mexErrMsgIdAndTxt( "MATLAB:remove_line_noise_mex_3p0:invalidNThreadsArg", "nThreads input argument invalid; should be a single value numeric (>= 0)");
+        }
+        n_threads = (si4) mxGetScalar(prhs[4]);
+    }
+
+    //
+    // process
+    //
+    mxArray *data = mxDuplicateArray(prhs[0]);
+    LINE_NOISE_TASK_ARGS args;
+    args.data = mxGetPr(data);
+    args.number_of_channels = (si8) mxGetM(data);
+    args.number_of_samples = (si8) mxGetN(data);
+    args.sampling_frequency = sampling_frequency;
+    args.line_frequency = line_frequency;
+    args.n_cycles = n_cycles;
+    args.status = (si4 *) mxCalloc((size_t) (args.number_of_channels + 1), sizeof(si4));
+
+    // initialize MEF library
+    (void) initialize_meflib();
+    static MEF_CONTEXT call_context;  // this call's context: the default context is shared by the gateways & threads
+    MEF_initialize_context(&call_context, NULL);
+    (void) MEF_set_context(&call_context);
+    MEF_context->behavior_on_fail = SUPPRESS_ERROR_OUTPUT;
+
+    (void) THREAD_run_tasks(remove_line_noise_task, (void *) &args, args.number_of_channels, n_threads);
+
+    MEF_context->behavior_on_fail = EXIT_ON_FAIL;
+
+    // report channels that were left unchanged
+    for (si8 i = 0; i < args.number_of_channels; ++i) {
+        if (args.status[i] == LINE_NOISE_TOO_SHORT)
+            mexWarnMsgIdAndTxt("MATLAB:remove_line_noise_mex_3p0:tooShort", "channel %ld: too few samples to remove the line noise; left unchanged", (long) (i + 1));
+        else if (args.status[i] == LINE_NOISE_NO_MEMORY)
+            mexWarnMsgIdAndTxt("MATLAB:remove_line_noise_mex_3p0:noMemory", "channel %ld: not enough memory to remove the line noise; left unchanged", (long) (i + 1));
+    }
+    mxFree(args.status);
+
+    // check if output is expected
+    if (nlhs > 0) {
+        plhs[0] = data;
+    } else {
+        mxDestroyArray(data);
+    }
+
+    (void) MEF_set_context(NULL);
+
+    // succesfull return from call
+    return;
+
+}
+
+// [EOF]
@@ -0,0 +1,75 @@
+function [out, start_index] = scan_signal_3p0(varargin)
+% SCAN_SIGNAL_3P0 Scan a MEF 3.0 channel in fixed windows with read-ahead
+% 
+% Syntax:
+%   id = scan_signal_3p0('open',ch_path,pw,window)
+%   id = scan_signal_3p0('open',ch_path,pw,window,step)
+%   id = scan_signal_3p0('open',ch_path,pw,window,step,prefetch_blocks)
+%   [x, start_index] = scan_signal_3p0('read',id)
+%   [x, start_index] = scan_signal_3p0('read',id,start_index)
+%   scan = scan_signal_3p0('status',id)
+%   scan_signal_3p0('close',id)
+%   scan_signal_3p0('close')
+% 
+% Imput(s):
+%   ch_path         - [str] channel path of a MEF 3.0 session
+%   pw              - [str] password for the desired level
+%   window          - [num] window length in samples
+%   step            - [num] (opt) samples between the starts of consecutive
+%                     windows (default = window)
+%   prefetch_blocks - [num] (opt) number of blocks read and decoded ahead
+%                     (default = 8)
+%   id              - [num] scanner id returned by 'open'
+%   start_index     - [num] (opt) index of the first sample of the window
+%                     (1-based); default is the window after the last one
+%                     read
+% 
+% Output(s):
+%   id              - [num] scanner id
+%   x               - [num] 1 x L window of signal, NaN for the missing
+%                     samples and shorter at the end of the channel; empty
+%                     past the end of the channel
+%   start_index     - [num] index of the first sample of x (1-based)
+%   scan            - [struct] state of the scanner: window, step,
+%                     next_index, windows (prefetched), hits, misses and
+%                     restarts
+% 
+% Note:
+%   This is a dummy function to check if the mex function has been
+%   compiled. If not, it will try to compile it.
+%
+%   After a window is read, a background thread reads and decodes the
+%   windows that follow, so the processing of one window overlaps the
+%   reading of the next ones. Reading the windows in sequence uses the
+%   prefetched data; reading any other window restarts the read-ahead
+%   there. Close the scanners when done; clear('scan_signal_3p0') is only
+%   possible once they are closed.
+% 
+% See also decompress_mef_3p0, open_mef_scan.
+
+% Copyright 2026 Richard J. Cui. Created: Sun 10/18/2026 10:12:37.415 AM
+% $Revision: 0.1 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+%
+% Rocky Creek Dr NE
+% Rochester, MN 55906, USA
+%
+% Email: richard.cui@utoronto.ca
+
+% compile c-mex function
+% -----------------------
+% we are here, cuz we don't have the mex function compiled. So, do it now
+make_mex_mef
+
+% now run the command
+% -------------------
+if nargout > 1
+    [out, start_index] = scan_signal_3p0(varargin{:});
+elseif nargout > 0
+    out = scan_signal_3p0(varargin{:});
+else
+    scan_signal_3p0(varargin{:});
+end % if
+
+end % funciton
+
+% [EOF]
\ No newline at end of file
@@ -0,0 +1,319 @@
+/**
+*     @file
+*     MEF 3.0 Library Matlab Wrapper
+*     Scan a MEF 3.0 time series channel in fixed windows, reading and decoding the next windows in the background
+*
+*  This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+*  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+*  This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*  You should have received a copy of the GNU General Public License along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//  Copyright (c) Richard J. Cui Created: Sun 10/18/2026 10:12:37.415 AM
+//  $Revision: 0.4 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+//
+//  Rocky Creek Dr NE
+//  Rochester, MN 55906, USA
+//
+//  Email: richard.cui@utoronto.ca
+
+#include "mex.h"
+#include "mef_mex_3p0.h"
+
+//  open scanners (the ids handed to Matlab are their index + 1)
+#define SCAN_SIGNAL_MAXIMUM_SCANNERS    64
+
+SCAN_READER *scan_readers[SCAN_SIGNAL_MAXIMUM_SCANNERS] = {NULL};
+si4 scan_readers_open = 0;
+
+/**
+ *     Close a scanner: stop its worker thread and free it together with its channel
+ *
+ *     @param id               Scanner index (zero-based)
+ */
+void close_scan_reader(si4 id) {
+    SCAN_READER *reader = scan_readers[id];
+
+    if (reader == NULL)
+        return;
+    CHANNEL *channel = reader->channel;
+    SCAN_READER_free(reader);
+    free_channel(channel, MEF_TRUE);
+    scan_readers[id] = NULL;
+
+    // the mex function can be cleared again once no worker thread runs its code
+    if (--scan_readers_open == 0)
+        mexUnlock();
+
+    return;
+}
+
+/**
+ *     Close all the scanners when the mex function is cleared from memory (registered with mexAtExit)
+ */
+void close_scan_readers(void) {
+    for (si4 i = 0; i < SCAN_SIGNAL_MAXIMUM_SCANNERS; ++i)
+        close_scan_reader(i);
+
+    return;
+}
+
+/**
+ *     Get the scanner of an id argument
+ *
+ *     @param mat_id           Scanner id (as returned by 'open')
+ *     @return                 Scanner index (zero-based); raises an error if there is no such open scanner
+ */
+si4 get_scan_reader_id(const mxArray *mat_id) {
+    if (!mxIsNumeric(mat_id) || mxGetNumberOfElements(mat_id) != 1) {
+        mexErrMsgIdAndTxt( "MATLAB:scan_signal_mex_3p0:invalidIdArg", "id input argument invalid; should be the scalar returned by 'open'");
+    }
+    sf8 id = mxGetScalar(mat_id);
+    if (id < 1 || id > SCAN_SIGNAL_MAXIMUM_SCANNERS || id != floor(id) || scan_readers[(si4) id - 1] == NULL) {
+        mexErrMsgIdAndTxt( "MATLAB:scan_signal_mex_3p0:invalidIdArg", "id input argument invalid; no open scanner with that id");
+    }
+
+    return (si4) id - 1;
+}
+
+/**
+ *     Map the state of a scanner to a Matlab structure
+ *
+ *     @param reader           Pointer to the scanner
+ *     @return                 Struct with the fields window, step, next_index (1-based), windows, hits, misses and
+ *                             restarts
+ */
+mxArray *map_scan_reader(SCAN_READER *reader) {
+    const char *fieldnames[] = {"window", "step", "next_index", "windows", "hits", "misses", "restarts"};
+
+    mxArray *mat_scan = mxCreateStructMatrix(1, 1, 7, fieldnames);
+    mxSetField(mat_scan, 0, "window", mxCreateDoubleScalar((sf8) reader->window_samples));
+    mxSetField(mat_scan, 0, "step", mxCreateDoubleScalar((sf8) reader->step_samples));
+    mxSetField(mat_scan, 0, "next_index", mxCreateDoubleScalar((sf8) (reader->next_sample + 1)));
+    mxSetField(mat_scan, 0, "windows", mxCreateDoubleScalar((sf8) reader->number_of_windows));
+    mxSetField(mat_scan, 0, "hits", mxCreateDoubleScalar((sf8) reader->prefetch_hits));
+    mxSetField(mat_scan, 0, "misses", mxCreateDoubleScalar((sf8) reader->prefetch_misses));
+    mxSetField(mat_scan, 0, "restarts", mxCreateDoubleScalar((sf8) reader->restarts));
+
+    return mat_scan;
+}
+
+/**
+ *     Open a scanner on a channel
+ *
+ *     @param channel_path     Path to the MEF3 channel folder
+ *     @param password         Password to the MEF3 data, or NULL
+ *     @param window           Window length (samples)
+ *     @param step             Samples between the starts of consecutive windows
+ *     @param prefetch_blocks  Blocks to read ahead (<= 0 for the default)
+ *     @return                 Scanner id (one-based); raises an error on failure
+ */
+si4 open_scan_reader(si1 *channel_path, si1 *password, si8 window, si8 step, si8 prefetch_blocks) {
+    si4 id;
+
+    for (id = 0; id < SCAN_SIGNAL_MAXIMUM_SCANNERS; ++id)
+        if (scan_readers[id] == NULL)
+            break;
+    if (id == SCAN_SIGNAL_MAXIMUM_SCANNERS) {
+        mexErrMsgIdAndTxt( "MATLAB:scan_signal_mex_3p0:tooManyScanners", "Error: too many open scanners (%d); close some first", SCAN_SIGNAL_MAXIMUM_SCANNERS);
+    }
+
+    // metadata & time series indices only; the windows are read as planned
+    MEF_context->behavior_on_fail = SUPPRESS_ERROR_OUTPUT;
+    CHANNEL *channel = read_MEF_channel(NULL, channel_path, TIME_SERIES_CHANNEL_TYPE, password, NULL, MEF_FALSE, MEF_FALSE);
+    MEF_context->behavior_on_fail = EXIT_ON_FAIL;
+    if (channel == NULL || channel->number_of_segments == 0) {
+        if (channel != NULL)
+            free_channel(channel, MEF_TRUE);
+        mexErrMsgIdAndTxt( "MATLAB:scan_signal_mex_3p0:readFailed", "Error: no segments in channel, most likely due to an invalid channel folder");
+    }
+    channel->segments[0].metadata_fps->directives.free_password_data = MEF_TRUE;
+    if (channel->channel_type != TIME_SERIES_CHANNEL_TYPE) {
+        free_channel(channel, MEF_TRUE);
+        mexErrMsgIdAndTxt( "MATLAB:scan_signal_mex_3p0:invalidChannel", "Error: not a time series channel");
+    }
+    if (channel->metadata.section_1->section_2_encryption > 0) {
+        free_channel(channel, MEF_TRUE);
+        if (password == NULL)
+            mexErrMsgIdAndTxt( "MATLAB:scan_signal_mex_3p0:encrypted", "Error: data is encrypted, but no password is given");
+        else
+            mexErrMsgIdAndTxt( "MATLAB:scan_signal_mex_3p0:wrongPassword", "Error: wrong password for encrypted data");
+    }
+
+    SCAN_READER *reader = SCAN_READER_initialize(channel, window, step, prefetch_blocks, THREAD_NUMBER_OF_THREADS_DEFAULT);
+    if (reader == NULL) {
+        free_channel(channel, MEF_TRUE);
+        mexErrMsgIdAndTxt( "MATLAB:scan_signal_mex_3p0:openFailed", "Error: could not open a scanner on the channel");
+    }
+    // the worker reads in the scanner's own context (other mex functions reset & change the default context); failed
+    // blocks are counted there, never exit Matlab
+    reader->context.behavior_on_fail = RETURN_ON_FAIL | SUPPRESS_ERROR_OUTPUT;
+
+    // keep the mex function (run by the worker threads) in memory while scanners are open
+    scan_readers[id] = reader;
+    if (scan_readers_open++ == 0)
+        mexLock();
+
+    return id + 1;
+}
+
+/**
+ *     Read a window of a scanner
+ *
+ *     @param reader           Pointer to the scanner
+ *     @param start_sample     Start of the window (zero-based)
+ *     @return                 1 x L double array (NaN for missing samples, trimmed at the end of the channel), or an
+ *                             empty array past the end of the channel
+ */
+mxArray *read_scan_window(SCAN_READER *reader, si8 start_sample) {
+    si8 i, n_samps, n_failed;
+
+    si4 *samples = (si4 *) mxMalloc((size_t) reader->window_samples * sizeof(si4));
+    n_samps = SCAN_READER_read(reader, start_sample, samples, &n_failed);
+    if (n_samps < 0) {
+        mxFree(samples);
+        mexErrMsgIdAndTxt( "MATLAB:scan_signal_mex_3p0:workerFailed", "Error: could not start the prefetch thread");
+    }
+    if (n_failed > 0)
+        mexPrintf("Warning: %ld block(s) of channel %s could not be decoded (CRC or access), inserted NaNs\n", (long) n_failed, reader->channel->name);
+
+    // copy/cast the data to the matlab array (RED_NAN as NaN)
+    mxArray *mat_window = mxCreateDoubleMatrix((n_samps > 0) ? 1 : 0, (mwSize) n_samps, mxREAL);
+    mxDouble *ptr_window = mxGetPr(mat_window);
+    mxDouble mxNaN = mxGetNaN();
+    for (i = 0; i < n_samps; ++i)
+        ptr_window[i] = (samples[i] == RED_NAN) ? mxNaN : (sf8) samples[i];
+    mxFree(samples);
+
+    return mat_window;
+}
+
+//  the gate function
+/**
+* Main entry point for 'scan_signal_3p0'
+*
+* id = scan_signal_3p0('open', channelPath, password, window, step, prefetchBlocks)
+* [x, startIndex] = scan_signal_3p0('read', id)
+* [x, startIndex] = scan_signal_3p0('read', id, startIndex)
+* scan = scan_signal_3p0('status', id)
+* scan_signal_3p0('close', id)
+* scan_signal_3p0('close')
+*
+* @param command        'open', 'read', 'status' or 'close'
+* @param channelPath    Path (absolute or relative) to the MEF3 channel folder
+* @param password       Password to the MEF3 data; Pass empty string/variable if not encrypted
+* @param window         Window length in samples
+* @param step           (optional) Samples between the starts of consecutive windows (default: window)
+* @param prefetchBlocks (optional) Blocks to read and decode ahead (default: 8)
+* @param id             Scanner id returned by 'open'
+* @param startIndex     (optional) Index of the first sample of the window (1-based); default: the window after the last
+*                       one read (reading windows in sequence uses the prefetched data, other windows restart it)
+* @return               'open': the scanner id; 'read': the window (1 x L, NaN for missing samples, empty past the end
+*                       of the channel) and its start index; 'status': a struct with the state of the scanner
+*/
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
+
+    //
+    // command
+    //
+    char command[16] = {0};
+    if (nrhs < 1 || !mxIsChar(prhs[0]) || mxGetString(prhs[0], command, sizeof(command)) != 0) {
+        mexErrMsgIdAndTxt( "MATLAB:scan_signal_mex_3p0:invalidCommandArg", "command input argument invalid; allowed values are 'open', 'read', 'status' or 'close'");
+    }
+
+    // initialize MEF library (once: the worker threads use its tables); MEF_globals may have been set up by another
+    // mex function sharing the library, so the exit function is registered on every call
+    if (MEF_globals == NULL)
+        (void) initialize_meflib();
+    mexAtExit(close_scan_readers);
+    static MEF_CONTEXT call_context;  // this call's context: the default context is shared by the gateways & threads
+    MEF_initialize_context(&call_context, NULL);
+    (void) MEF_set_context(&call_context);
+
+    if (strcasecmp(command, "open") == 0) {
+        if (nrhs < 4) {
+            mexErrMsgIdAndTxt( "MATLAB:scan_signal_mex_3p0:notEnoughArgs", "channelPath, password and window input arguments must be set");
+        }
+        if (!mxIsChar(prhs[1]) || mxIsEmpty(prhs[1])) {
+            mexErrMsgIdAndTxt( "MATLAB:scan_signal_mex_3p0:invalidChannelPathArg", "channelPath input argument invalid, should be a non-empty string (array of characters)");
+        }
+        si1 channel_path[MEF_FULL_FILE_NAME_BYTES];
+        char *mat_channel_path = mxArrayToString(prhs[1]);
+        MEF_strncpy(channel_path, mat_channel_path, MEF_FULL_FILE_NAME_BYTES);
+        mxFree(mat_channel_path);
+
+        si1 *password = NULL;
+        si1 password_arr[PASSWORD_BYTES] = {0};
+        if (!mxIsEmpty(prhs[2])) {
+            if (!mxIsChar(prhs[2])) {
+                mexErrMsgIdAndTxt( "MATLAB:scan_signal_mex_3p0:invalidPasswordArg", "password input argument invalid, should string (array of characters)");
+            }
+            char *mat_password = mxArrayToString(prhs[2]);
+            MEF_strncpy(password_arr, mat_password, PASSWORD_BYTES);
+            mxFree(mat_password);
+            password = password_arr;
+        }
+
+        if (!mxIsNumeric(prhs[3]) || mxGetNumberOfElements(prhs[3]) != 1 || mxGetScalar(prhs[3]) < 1) {
+            mexErrMsgIdAndTxt( "MATLAB:scan_signal_mex_3p0:invalidWindowArg", "window input argument invalid; should be a positive number of samples");
+        }
+        si8 window = (si8) mxGetScalar(prhs[3]);
+        si8 step = window;
+        if (nrhs > 4 && !mxIsEmpty(prhs[4])) {
+            if (!mxIsNumeric(prhs[4]) || mxGetNumberOfElements(prhs[4]) != 1 || mxGetScalar(prhs[4]) < 1) {
+                mexErrMsgIdAndTxt( "MATLAB:scan_signal_mex_3p0:invalidStepArg", "step input argument invalid; should be a positive number of samples");
+            }
+            step = (si8) mxGetScalar(prhs[4]);
+        }
+        si8 prefetch_blocks = SCAN_READER_PREFETCH_BLOCKS_DEFAULT;
+        if (nrhs > 5 && !mxIsEmpty(prhs[5])) {
+            if (!mxIsNumeric(prhs[5]) || mxGetNumberOfElements(prhs[5]) != 1 || mxGetScalar(prhs[5]) < 1) {
+                mexErrMsgIdAndTxt( "MATLAB:scan_signal_mex_3p0:invalidPrefetchBlocksArg", "prefetchBlocks input argument invalid; should be a positive number of blocks");
+            }
+            prefetch_blocks = (si8) mxGetScalar(prhs[5]);
+        }
+
+        plhs[0] = mxCreateDoubleScalar((sf8) open_scan_reader(channel_path, password, window, step, prefetch_blocks));
+
+    } else if (strcasecmp(command, "read") == 0) {
+        if (nrhs < 2) {
+            mexErrMsgIdAndTxt( "MATLAB:scan_signal_mex_3p0:notEnoughArgs", "id input argument must be set");
+        }
+        SCAN_READER *reader = scan_readers[get_scan_reader_id(prhs[1])];
+        si8 start_sample = reader->next_sample;
+        if (nrhs > 2 && !mxIsEmpty(prhs[2])) {
+            if (!mxIsNumeric(prhs[2]) || mxGetNumberOfElements(prhs[2]) != 1 || mxGetScalar(prhs[2]) < 1) {
+                mexErrMsgIdAndTxt( "MATLAB:scan_signal_mex_3p0:invalidStartIndexArg", "startIndex input argument invalid; should be a positive sample index (1-based)");
+            }
+            start_sample = (si8) mxGetScalar(prhs[2]) - 1;
+        }
+
+        plhs[0] = read_scan_window(reader, start_sample);
+        if (nlhs > 1)
+            plhs[1] = mxCreateDoubleScalar((sf8) (start_sample + 1));
+
+    } else if (strcasecmp(command, "status") == 0) {
+        if (nrhs < 2) {
+            mexErrMsgIdAndTxt( "MATLAB:scan_signal_mex_3p0:notEnoughArgs", "id input argument must be set");
+        }
+        plhs[0] = map_scan_reader(scan_readers[get_scan_reader_id(prhs[1])]);
+
+    } else if (strcasecmp(command, "close") == 0) {
+        if (nrhs > 1)
+            close_scan_reader(get_scan_reader_id(prhs[1]));
+        else
+            close_scan_readers();
+
+    } else {
+        mexErrMsgIdAndTxt( "MATLAB:scan_signal_mex_3p0:invalidCommandArg", "command input argument invalid; allowed values are 'open', 'read', 'status' or 'close'");
+    }
+
+    (void) MEF_set_context(NULL);
+
+    // succesfull return from call
+    return;
+
+}
+
+// [EOF]
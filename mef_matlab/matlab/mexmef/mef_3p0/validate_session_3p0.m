@@ -0,0 +1,67 @@
+function report = validate_session_3p0(sess_path,password)
+% VALIDATE_SESSION_3P0 Validate the consistency of the channels of a MEF 3.0 session
+% 
+% Syntax:
+%   report = validate_session_3p0(sess_path)
+%   report = validate_session_3p0(__,password)
+% 
+% Imput(s):
+%   sess_path       - [char] path to a MEF 3.0 session folder (.mefd)
+%   password        - [char] (opt) password of the MEF 3.0 data; empty if
+%                     not encrypted (default = [])
+% 
+% Output(s):
+%   report          - [struct] validation report
+%                     .valid        : [logical] all checks passed
+%                     .checks       : [struct] one logical per check:
+%                                     Readable, SamplingFreq, Begin, Stop,
+%                                     Samples, IndexEntry,
+%                                     DiscountinuityEntry,
+%                                     Section2Encryption,
+%                                     Section3Encryption, Version,
+%                                     Institution, SubjectID,
+%                                     AcquisitionSystem,
+%                                     CompressionAlgorithm
+%                     .messages     : [cell] N x 1 problems found
+%                     .channel_name : [cell] 1 x C names of the time
+%                                     series channels
+%                     .readable, .sampling_frequency, .begin, .stop,
+%                     .samples, .index_entry, .discontinuity_entry,
+%                     .version      : 1 x C values of each channel (NaN
+%                                     or '' if it could not be read)
+% 
+% Note:
+%   This is a dummy function to check if the mex function has been
+%   compiled. If not, it will try to compile it.
+%
+%   The metadata and time series indices of the channels are read in
+%   parallel (one channel per worker), no data are read. The checks are
+%   those of checkSessValid; in addition, IndexEntry fails if the indices
+%   of a channel do not account for the blocks and samples of its
+%   metadata, in order.
+% 
+% See also checkSessValid, analyze_continuity_3p0.
+
+% Copyright 2026 Richard J. Cui. Created: Sun 10/18/2026 10:12:37.415 AM
+% $Revision: 0.2 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+%
+% Rocky Creek Dr NE
+% Rochester, MN 55906, USA
+%
+% Email: richard.cui@utoronto.ca
+
+% compile c-mex function
+% -----------------------
+% we are here, cuz we don't have the mex function compiled. So, do it now
+make_mex_mef
+
+% now validate the session
+% ------------------------
+if nargin < 2
+    password = [];
+end % if
+report = validate_session_3p0(sess_path,password);
+
+end % funciton
+
+% [EOF]
\ No newline at end of file
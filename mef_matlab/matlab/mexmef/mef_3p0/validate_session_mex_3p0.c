@@ -0,0 +1,498 @@
+/**
+*     @file
+*     MEF 3.0 Library Matlab Wrapper
+*     Validate the consistency of the time series channels of a MEF 3.0 session in one parallel pass over their metadata
+*
+*  This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+*  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+*  This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*  You should have received a copy of the GNU General Public License along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//  Copyright (c) Richard J. Cui Created: Sun 10/18/2026 10:12:37.415 AM
+//  $Revision: 0.4 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+//
+//  Rocky Creek Dr NE
+//  Rochester, MN 55906, USA
+//
+//  Email: richard.cui@utoronto.ca
+
+#include "mex.h"
+#include "mef_mex_3p0.h"
+
+//  per-channel status
+#define VALIDATION_OK                   0
+#define VALIDATION_READ_FAILED          1
+#define VALIDATION_ENCRYPTED            2
+
+//  session checks (in the order of checkSessValid.m)
+#define VALIDATION_NUMBER_OF_CHECKS     14
+const char *validation_check_names[VALIDATION_NUMBER_OF_CHECKS] = {
+    "Readable", "SamplingFreq", "Begin", "Stop", "Samples", "IndexEntry", "DiscountinuityEntry",
+    "Section2Encryption", "Section3Encryption", "Version", "Institution", "SubjectID", "AcquisitionSystem",
+    "CompressionAlgorithm"
+};
+
+//  not in the MEF 3.0 metadata (as get_info_data.m)
+#define VALIDATION_NOT_AVAILABLE        "not available"
+#define VALIDATION_DESCRIPTION_BYTES    32
+
+//  maximum number of messages reported
+#define VALIDATION_MAXIMUM_MESSAGES     64
+#define VALIDATION_MESSAGE_BYTES        512
+
+/**
+ *  Metadata summary of a time series channel, filled by a validation task
+ */
+typedef struct {
+    si1     path[MEF_FULL_FILE_NAME_BYTES];
+    si1     name[MEF_BASE_FILE_NAME_BYTES];
+    si4     status;
+    sf8     sampling_frequency;
+    si8     begin;                  // uUTC
+    si8     stop;                   // uUTC
+    si8     samples;
+    si8     index_entries;          // number of data blocks
+    si8     discontinuity_entries;  // number of segments of continuous sampling
+    si1     section_2_encryption;   // MEF_TRUE if level 1 or 2 encrypted
+    si1     section_3_encryption;
+    si1     section_3_readable;
+    si4     version_major;
+    si4     version_minor;
+    si1     institution[METADATA_RECORDING_LOCATION_BYTES];
+    si1     subject_ID[METADATA_SUBJECT_ID_BYTES];
+    si1     acquisition_system[VALIDATION_DESCRIPTION_BYTES];
+    si1     compression_algorithm[VALIDATION_DESCRIPTION_BYTES];
+    si1     indices_consistent;     // indices agree with the metadata (blocks, samples, order)
+} VALIDATION_CHANNEL;
+
+/**
+ *  Arguments shared by all validation tasks (one task per channel)
+ *
+ *  Note: the tasks run on worker threads, so they only use the C library; no MATLAB API calls
+ */
+typedef struct {
+    VALIDATION_CHANNEL  *channels;
+    si1                 *password;
+} VALIDATION_TASK_ARGS;
+
+/**
+ *     Read the metadata & time series indices of a channel and summarize them (thread task)
+ *
+ *  No data are read. Each task reads its channel in its own context (settings copied from the calling thread's), so
+ *  the recording time offset of one channel is never applied to another.
+ *
+ *     @param task_args        Pointer to the VALIDATION_TASK_ARGS
+ *    @param task_number        Channel index (0-based)
+ *    @param thread_number    Worker index (unused)
+ */
+void validate_channel_task(void *task_args, si8 task_number, si4 thread_number) {
+    VALIDATION_TASK_ARGS    *args = (VALIDATION_TASK_ARGS *) task_args;
+    VALIDATION_CHANNEL      *summary = args->channels + task_number;
+    CONTINUITY_INDEX        continuity_index = {0};
+    TIME_SERIES_INDEX       *tsi, *prev_tsi;
+    SEGMENT                 *seg;
+    si8                     i, n_entries, index_samples, segment_samples;
+    si4                     j;
+    MEF_CONTEXT             context, *previous_context;
+
+    MEF_initialize_context(&context, MEF_context);
+    previous_context = MEF_set_context(&context);
+
+    CHANNEL *channel = read_MEF_channel(NULL, summary->path, TIME_SERIES_CHANNEL_TYPE, args->password, NULL, MEF_FALSE, MEF_FALSE);
+    if (channel == NULL || channel->number_of_segments == 0) {
+        if (channel != NULL)
+            free_channel(channel, MEF_TRUE);
+        summary->status = VALIDATION_READ_FAILED;
+        (void) MEF_set_context(previous_context);
+        return;
+    }
+    channel->segments[0].metadata_fps->directives.free_password_data = MEF_TRUE;
+    if (channel->metadata.section_1->section_2_encryption > 0) {
+        free_channel(channel, MEF_TRUE);
+        summary->status = VALIDATION_ENCRYPTED;
+        (void) MEF_set_context(previous_context);
+        return;
+    }
+    summary->status = VALIDATION_OK;
+
+    // metadata
+    MEF_strncpy(summary->name, channel->name, MEF_BASE_FILE_NAME_BYTES);
+    summary->sampling_frequency = channel->metadata.time_series_section_2->sampling_frequency;
+    summary->begin = channel->earliest_start_time;
+    summary->stop = channel->latest_end_time;
+    summary->samples = channel->metadata.time_series_section_2->number_of_samples;
+    summary->index_entries = channel->metadata.time_series_section_2->number_of_blocks;
+    summary->section_2_encryption = (ABS(channel->metadata.section_1->section_2_encryption) == LEVEL_1_ENCRYPTION || ABS(channel->metadata.section_1->section_2_encryption) == LEVEL_2_ENCRYPTION) ? MEF_TRUE : MEF_FALSE;
+    summary->section_3_encryption = (ABS(channel->metadata.section_1->section_3_encryption) == LEVEL_1_ENCRYPTION || ABS(channel->metadata.section_1->section_3_encryption) == LEVEL_2_ENCRYPTION) ? MEF_TRUE : MEF_FALSE;
+    summary->section_3_readable = (channel->metadata.section_1->section_3_encryption <= NO_ENCRYPTION) ? MEF_TRUE : MEF_FALSE;
+    summary->version_major = (si4) channel->segments[0].metadata_fps->universal_header->mef_version_major;
+    summary->version_minor = (si4) channel->segments[0].metadata_fps->universal_header->mef_version_minor;
+    if (summary->section_3_readable == MEF_TRUE) {
+        MEF_strncpy(summary->institution, channel->metadata.section_3->recording_location, METADATA_RECORDING_LOCATION_BYTES);
+        MEF_strncpy(summary->subject_ID, channel->metadata.section_3->subject_ID, METADATA_SUBJECT_ID_BYTES);
+    }
+    MEF_strncpy(summary->acquisition_system, VALIDATION_NOT_AVAILABLE, VALIDATION_DESCRIPTION_BYTES);
+    MEF_strncpy(summary->compression_algorithm, VALIDATION_NOT_AVAILABLE, VALIDATION_DESCRIPTION_BYTES);
+
+    // the time series indices must account for every block & sample of the metadata, in order
+    summary->indices_consistent = MEF_TRUE;
+    n_entries = index_samples = 0;
+    prev_tsi = NULL;
+    for (j = 0; j < channel->number_of_segments; ++j) {
+        seg = channel->segments + j;
+        tsi = seg->time_series_indices_fps->time_series_indices;
+        segment_samples = 0;  // index start samples are relative to the segment
+        for (i = 0; i < seg->time_series_indices_fps->universal_header->number_of_entries; ++i, ++tsi) {
+            if (tsi->start_sample != segment_samples || (prev_tsi != NULL && tsi->start_time < prev_tsi->start_time))
+                summary->indices_consistent = MEF_FALSE;
+            segment_samples += (si8) tsi->number_of_samples;
+            prev_tsi = tsi;
+        }
+        n_entries += seg->time_series_indices_fps->universal_header->number_of_entries;
+        index_samples += segment_samples;
+    }
+    if (n_entries != summary->index_entries || index_samples != summary->samples)
+        summary->indices_consistent = MEF_FALSE;
+
+    // discontinuities
+    (void) CONTINUITY_build_index(channel, &continuity_index);
+    summary->discontinuity_entries = continuity_index.number_of_entries;
+    CONTINUITY_free_index(&continuity_index, MEF_FALSE);
+
+    free_channel(channel, MEF_TRUE);
+    (void) MEF_set_context(previous_context);
+
+    return;
+}
+
+/**
+ *     Add a message to the validation report
+ *
+ *     @param messages         Message buffer (VALIDATION_MAXIMUM_MESSAGES x VALIDATION_MESSAGE_BYTES)
+ *     @param n_messages       Number of messages so far (updated)
+ *     @param fmt              printf style format of the message
+ */
+void add_validation_message(si1 *messages, si4 *n_messages, const char *fmt, ...) {
+    va_list args;
+
+    if (*n_messages >= VALIDATION_MAXIMUM_MESSAGES)
+        return;
+    va_start(args, fmt);
+    (void) vsnprintf(messages + (*n_messages * VALIDATION_MESSAGE_BYTES), VALIDATION_MESSAGE_BYTES, fmt, args);
+    va_end(args);
+    ++(*n_messages);
+
+    return;
+}
+
+/**
+ *     Compare the summaries of the channels (as the checks of checkSessValid.m)
+ *
+ *  Only the readable channels are compared; they must agree with each other on every property, and be valid.
+ *
+ *     @param channels         Channel summaries
+ *     @param n_channels       Number of channels
+ *     @param checks           Result of each check (VALIDATION_NUMBER_OF_CHECKS; MEF_TRUE or MEF_FALSE)
+ *     @param messages         Message buffer (VALIDATION_MAXIMUM_MESSAGES x VALIDATION_MESSAGE_BYTES)
+ *     @param n_messages       Number of messages (updated)
+ */
+void compare_validation_channels(VALIDATION_CHANNEL *channels, si4 n_channels, si1 *checks, si1 *messages, si4 *n_messages) {
+    VALIDATION_CHANNEL  *ref = NULL, *ch;
+    si1     consistent[VALIDATION_NUMBER_OF_CHECKS], valid[VALIDATION_NUMBER_OF_CHECKS];
+    si4     i, k;
+
+    for (k = 0; k < VALIDATION_NUMBER_OF_CHECKS; ++k)
+        consistent[k] = valid[k] = MEF_TRUE;
+
+    for (i = 0; i < n_channels; ++i) {
+        ch = channels + i;
+        if (ch->status == VALIDATION_READ_FAILED) {
+            valid[0] = MEF_FALSE;
+            add_validation_message(messages, n_messages, "Channel %s could not be read", ch->path);
+            continue;
+        }
+        if (ch->status == VALIDATION_ENCRYPTED) {
+            valid[0] = MEF_FALSE;
+            add_validation_message(messages, n_messages, "Data password is required for channel %s, but may not be provided", ch->path);
+            continue;
+        }
+        if (ch->indices_consistent == MEF_FALSE) {
+            valid[5] = MEF_FALSE;
+            add_validation_message(messages, n_messages, "Time series indices of channel %s do not match its metadata", ch->name);
+        }
+
+        // validity
+        if (ch->sampling_frequency <= 0.0)
+            valid[1] = MEF_FALSE;
+        if (ch->begin < 0)
+            valid[2] = MEF_FALSE;
+        if (ch->stop <= 0)
+            valid[3] = MEF_FALSE;
+        if (ch->samples < 0)
+            valid[4] = MEF_FALSE;
+        if (ch->index_entries <= 0)
+            valid[5] = MEF_FALSE;
+        if (ch->discontinuity_entries <= 0)
+            valid[6] = MEF_FALSE;
+        if (ch->version_major != 3 || ch->version_minor != 0)
+            valid[9] = MEF_FALSE;
+
+        // consistency
+        if (ref == NULL) {
+            ref = ch;
+            continue;
+        }
+        if (ch->sampling_frequency != ref->sampling_frequency)
+            consistent[1] = MEF_FALSE;
+        if (ch->begin != ref->begin)
+            consistent[2] = MEF_FALSE;
+        if (ch->stop != ref->stop)
+            consistent[3] = MEF_FALSE;
+        if (ch->samples != ref->samples)
+            consistent[4] = MEF_FALSE;
+        if (ch->index_entries != ref->index_entries)
+            consistent[5] = MEF_FALSE;
+        if (ch->discontinuity_entries != ref->discontinuity_entries)
+            consistent[6] = MEF_FALSE;
+        if (ch->section_2_encryption != ref->section_2_encryption)
+            consistent[7] = MEF_FALSE;
+        if (ch->section_3_encryption != ref->section_3_encryption)
+            consistent[8] = MEF_FALSE;
+        if (ch->version_major != ref->version_major || ch->version_minor != ref->version_minor)
+            consistent[9] = MEF_FALSE;
+        if (ch->section_3_readable == MEF_TRUE && ref->section_3_readable == MEF_TRUE) {
+            if (strcmp(ch->institution, ref->institution))
+                consistent[10] = MEF_FALSE;
+            if (strcmp(ch->subject_ID, ref->subject_ID))
+                consistent[11] = MEF_FALSE;
+        }
+        if (strcmp(ch->acquisition_system, ref->acquisition_system))
+            consistent[12] = MEF_FALSE;
+        if (strcmp(ch->compression_algorithm, ref->compression_algorithm))
+            consistent[13] = MEF_FALSE;
+    }
+    if (ref == NULL)
+        add_validation_message(messages, n_messages, "No channel of the session could be read");
+
+    // messages (wording of checkSessValid.m)
+    if (consistent[1] == MEF_FALSE)
+        add_validation_message(messages, n_messages, "Sampling frequencies of different channels are not consistent");
+    if (valid[1] == MEF_FALSE)
+        add_validation_message(messages, n_messages, "Sampling frequencies in some channels may not be valid");
+    if (consistent[2] == MEF_FALSE)
+        add_validation_message(messages, n_messages, "Begin points of different channels are not consistent");
+    if (valid[2] == MEF_FALSE)
+        add_validation_message(messages, n_messages, "Begin points in some channels may not be valid");
+    if (consistent[3] == MEF_FALSE)
+        add_validation_message(messages, n_messages, "Stop points of different channels are not consistent");
+    if (valid[3] == MEF_FALSE)
+        add_validation_message(messages, n_messages, "Stop points in some channels may not be valid");
+    if (consistent[4] == MEF_FALSE)
+        add_validation_message(messages, n_messages, "Numbers of samples of different channels are not consistent");
+    if (valid[4] == MEF_FALSE)
+        add_validation_message(messages, n_messages, "Number of samples in some channels may not be valid");
+    if (consistent[5] == MEF_FALSE)
+        add_validation_message(messages, n_messages, "Numbers of index entry of different channels are not consistent");
+    if (valid[5] == MEF_FALSE)
+        add_validation_message(messages, n_messages, "Number of index entry in some channels may not be valid");
+    if (consistent[6] == MEF_FALSE)
+        add_validation_message(messages, n_messages, "Numbers of discountinuity entry of different channels are not consistent");
+    if (valid[6] == MEF_FALSE)
+        add_validation_message(messages, n_messages, "Numbers of discountinuity entry in some channels may not be valid");
+    if (consistent[7] == MEF_FALSE)
+        add_validation_message(messages, n_messages, "Requirements of section 2 encryption of different channels are not consistent");
+    if (consistent[8] == MEF_FALSE)
+        add_validation_message(messages, n_messages, "Requirements of section 3 encryption of different channels are not consistent");
+    if (consistent[9] == MEF_FALSE)
+        add_validation_message(messages, n_messages, "MEF data versions of different channels are not consistent");
+    else if (valid[9] == MEF_FALSE && ref != NULL)
+        add_validation_message(messages, n_messages, "The MEF channel is in format version %d.%d, rather than 3.0. The results may be unpredictable.", ref->version_major, ref->version_minor);
+    if (consistent[10] == MEF_FALSE)
+        add_validation_message(messages, n_messages, "Institution names of different channels are not consistent");
+    if (consistent[11] == MEF_FALSE)
+        add_validation_message(messages, n_messages, "Subject IDs of different channels are not consistent");
+    if (consistent[12] == MEF_FALSE)
+        add_validation_message(messages, n_messages, "Acquisition systems of different channels are not consistent");
+    if (consistent[13] == MEF_FALSE)
+        add_validation_message(messages, n_messages, "Compression algorithms of different channels are not consistent");
+
+    for (k = 0; k < VALIDATION_NUMBER_OF_CHECKS; ++k)
+        checks[k] = (consistent[k] == MEF_TRUE && valid[k] == MEF_TRUE && ref != NULL) ? MEF_TRUE : MEF_FALSE;
+
+    return;
+}
+
+/**
+ *     Map the validation of a session to a Matlab report structure
+ *
+ *     @param channels         Channel summaries
+ *     @param n_channels       Number of channels
+ *     @param checks           Result of each check
+ *     @param messages         Message buffer
+ *     @param n_messages       Number of messages
+ *     @return                 Report structure (see validate_session_3p0.m)
+ */
+mxArray *map_session_validation(VALIDATION_CHANNEL *channels, si4 n_channels, si1 *checks, si1 *messages, si4 n_messages) {
+    const char *fields[] = { "valid", "checks", "messages", "channel_name", "readable", "sampling_frequency", "begin",
+        "stop", "samples", "index_entry", "discontinuity_entry", "version" };
+    si1     valid = MEF_TRUE;
+    si4     i, k;
+
+    mxArray *report = mxCreateStructMatrix(1, 1, 12, fields);
+
+    mxArray *mat_checks = mxCreateStructMatrix(1, 1, VALIDATION_NUMBER_OF_CHECKS, validation_check_names);
+    for (k = 0; k < VALIDATION_NUMBER_OF_CHECKS; ++k) {
+        mxSetField(mat_checks, 0, validation_check_names[k], mxCreateLogicalScalar(checks[k] == MEF_TRUE));
+        if (checks[k] != MEF_TRUE)
+            valid = MEF_FALSE;
+    }
+    mxSetField(report, 0, "valid", mxCreateLogicalScalar(valid == MEF_TRUE));
+    mxSetField(report, 0, "checks", mat_checks);
+
+    mxArray *mat_messages = mxCreateCellMatrix((mwSize) n_messages, 1);
+    for (i = 0; i < n_messages; ++i)
+        mxSetCell(mat_messages, (mwIndex) i, mxCreateString(messages + (i * VALIDATION_MESSAGE_BYTES)));
+    mxSetField(report, 0, "messages", mat_messages);
+
+    // per channel (NaN for the channels that could not be read)
+    mxArray *mat_names = mxCreateCellMatrix(1, (mwSize) n_channels);
+    mxArray *mat_readable = mxCreateLogicalMatrix(1, (mwSize) n_channels);
+    mxArray *mat_cols[6];
+    for (k = 0; k < 6; ++k)
+        mat_cols[k] = mxCreateDoubleMatrix(1, (mwSize) n_channels, mxREAL);
+    mxArray *mat_versions = mxCreateCellMatrix(1, (mwSize) n_channels);
+    for (i = 0; i < n_channels; ++i) {
+        VALIDATION_CHANNEL *ch = channels + i;
+        si1 version[16] = "";
+        si1 name[MEF_BASE_FILE_NAME_BYTES];
+        si1 ok = (ch->status == VALIDATION_OK) ? MEF_TRUE : MEF_FALSE;
+
+        if (ok == MEF_TRUE) {
+            MEF_strncpy(name, ch->name, MEF_BASE_FILE_NAME_BYTES);
+            sprintf(version, "%d.%d", ch->version_major, ch->version_minor);
+        } else {
+            extract_path_parts(ch->path, NULL, name, NULL);
+        }
+        mxSetCell(mat_names, (mwIndex) i, mxCreateString(name));
+        mxSetCell(mat_versions, (mwIndex) i, mxCreateString(version));
+        mxGetLogicals(mat_readable)[i] = (ok == MEF_TRUE);
+        mxGetPr(mat_cols[0])[i] = (ok == MEF_TRUE) ? ch->sampling_frequency : mxGetNaN();
+        mxGetPr(mat_cols[1])[i] = (ok == MEF_TRUE) ? (sf8) ch->begin : mxGetNaN();
+        mxGetPr(mat_cols[2])[i] = (ok == MEF_TRUE) ? (sf8) ch->stop : mxGetNaN();
+        mxGetPr(mat_cols[3])[i] = (ok == MEF_TRUE) ? (sf8) ch->samples : mxGetNaN();
+        mxGetPr(mat_cols[4])[i] = (ok == MEF_TRUE) ? (sf8) ch->index_entries : mxGetNaN();
+        mxGetPr(mat_cols[5])[i] = (ok == MEF_TRUE) ? (sf8) ch->discontinuity_entries : mxGetNaN();
+    }
+    mxSetField(report, 0, "channel_name", mat_names);
+    mxSetField(report, 0, "readable", mat_readable);
+    mxSetField(report, 0, "sampling_frequency", mat_cols[0]);
+    mxSetField(report, 0, "begin", mat_cols[1]);
+    mxSetField(report, 0, "stop", mat_cols[2]);
+    mxSetField(report, 0, "samples", mat_cols[3]);
+    mxSetField(report, 0, "index_entry", mat_cols[4]);
+    mxSetField(report, 0, "discontinuity_entry", mat_cols[5]);
+    mxSetField(report, 0, "version", mat_versions);
+
+    return report;
+}
+
+//  the gate function
+/**
+* Main entry point for 'validate_session_3p0'
+*
+* @param sessionPath    Path (absolute or relative) to the MEF3 session folder (.mefd)
+* @param password       (optional) Password to the MEF3 data; Pass empty string/variable if not encrypted
+* @return               Report structure: valid (logical), checks (structure of logicals, one per check), messages
+*                       (cell array of the problems found), and per channel (1 x C): channel_name, readable,
+*                       sampling_frequency, begin, stop, samples, index_entry, discontinuity_entry and version
+*/
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
+
+    //
+    // session path
+    //
+    if (nrhs < 1) {
+        mexErrMsgIdAndTxt( "MATLAB:validate_session_mex_3p0:noSessionPathArg", "sessionPath input argument not set");
+    }
+    if (!mxIsChar(prhs[0]) || mxIsEmpty(prhs[0])) {
+        mexErrMsgIdAndTxt( "MATLAB:validate_session_mex_3p0:invalidSessionPathArg", "sessionPath input argument invalid, should be a non-empty string (array of characters)");
+    }
+    si1 session_path[MEF_FULL_FILE_NAME_BYTES];
+    char *mat_session_path = mxArrayToString(prhs[0]);
+    MEF_strncpy(session_path, mat_session_path, MEF_FULL_FILE_NAME_BYTES);
+    mxFree(mat_session_path);
+
+    // strip trailing separators
+    si4 len = (si4) strlen(session_path);
+    while (len > 1 && (session_path[len - 1] == '/' || session_path[len - 1] == '\\'))
+        session_path[--len] = 0;
+
+    //
+    // password (optional)
+    //
+    si1 *password = NULL;
+    si1 password_arr[PASSWORD_BYTES] = {0};
+    if (nrhs > 1 && !mxIsEmpty(prhs[1])) {
+        if (!mxIsChar(prhs[1])) {
+            mexErrMsgIdAndTxt( "MATLAB:validate_session_mex_3p0:invalidPasswordArg", "password input argument invalid, should string (array of characters)");
+        }
+        char *mat_password = mxArrayToString(prhs[1]);
+        MEF_strncpy(password_arr, mat_password, PASSWORD_BYTES);
+        mxFree(mat_password);
+        password = password_arr;
+    }
+
+    //
+    // summarize the time series channels in parallel (metadata & indices only)
+    //
+
+    // initialize MEF library
+    (void) initialize_meflib();
+    static MEF_CONTEXT call_context;  // this call's context: the default context is shared by the gateways & threads
+    MEF_initialize_context(&call_context, NULL);
+    (void) MEF_set_context(&call_context);
+
+    si4 n_channels = 0;
+    MEF_context->behavior_on_fail = SUPPRESS_ERROR_OUTPUT;
+    si1 **channel_paths = generate_file_list(NULL, &n_channels, session_path, TIME_SERIES_CHANNEL_DIRECTORY_TYPE_STRING);
+    MEF_context->behavior_on_fail = EXIT_ON_FAIL;
+    if (channel_paths == NULL || n_channels <= 0) {
+        free(channel_paths);
+        mexErrMsgIdAndTxt( "MATLAB:validate_session_mex_3p0:noChannels", "Error: no time series channels in %s, most likely due to an invalid session folder", session_path);
+    }
+
+    VALIDATION_TASK_ARGS args;
+    args.channels = (VALIDATION_CHANNEL *) mxCalloc((size_t) n_channels, sizeof(VALIDATION_CHANNEL));
+    args.password = password;
+    for (si4 i = 0; i < n_channels; ++i) {
+        MEF_strncpy(args.channels[i].path, channel_paths[i], MEF_FULL_FILE_NAME_BYTES);
+        free(channel_paths[i]);
+    }
+    free(channel_paths);
+
+    MEF_context->behavior_on_fail = SUPPRESS_ERROR_OUTPUT;
+    (void) THREAD_run_tasks(validate_channel_task, (void *) &args, n_channels, THREAD_NUMBER_OF_THREADS_DEFAULT);
+    MEF_context->behavior_on_fail = EXIT_ON_FAIL;
+
+    //
+    // compare & report
+    //
+    si1 checks[VALIDATION_NUMBER_OF_CHECKS];
+    si1 *messages = (si1 *) mxCalloc((size_t) VALIDATION_MAXIMUM_MESSAGES * VALIDATION_MESSAGE_BYTES, sizeof(si1));
+    si4 n_messages = 0;
+    compare_validation_channels(args.channels, n_channels, checks, messages, &n_messages);
+
+    plhs[0] = map_session_validation(args.channels, n_channels, checks, messages, n_messages);
+    mxFree(messages);
+    mxFree(args.channels);
+
+    (void) MEF_set_context(NULL);
+
+    // succesfull return from call
+    return;
+
+}
+
+// [EOF]
@@ -0,0 +1,71 @@
+function write_mef_session_3p0(sess_path,chan_names,data,fs,start_time,ucf,block_samples,mrr,n_threads)
+% write_mef_session_3p0 Write multi-channel data to a MEF 3.0 session
+% 
+% Syntax:
+%   write_mef_session_3p0(sess_path,chan_names,data,fs,start_time)
+%   write_mef_session_3p0(__,ucf)
+%   write_mef_session_3p0(__,ucf,block_samples)
+%   write_mef_session_3p0(__,ucf,block_samples,mrr)
+%   write_mef_session_3p0(__,ucf,block_samples,mrr,n_threads)
+% 
+% Imput(s):
+%   sess_path       - [char] path of the session directory; '.mefd' is
+%                     added if missing
+%   chan_names      - [cell] channel names, one per row of data
+%   data            - [num] channels x samples data in physical units
+%                     (e.g. EEG.data); NaNs are kept
+%   fs              - [num] sampling frequency (Hz)
+%   start_time      - [num] time of the first sample (uUTC)
+%   ucf             - [num] (opt) units conversion factor, i.e. physical
+%                     units per stored integer unit (default = 1)
+%   block_samples   - [num] (opt) samples per RED block; 0 = one second
+%                     of samples (default = 0)
+%   mrr             - [num] (opt) goal mean residual ratio of the lossy
+%                     compression; 0 = lossless (default = 0)
+%   n_threads       - [num] (opt) number of worker threads; 0 = one per
+%                     processor (default = 0)
+% 
+% Output(s):
+% 
+% Note:
+%   This is a dummy function to check if the mex function has been
+%   compiled. If not, it will try to compile it.
+%
+%   Each channel is written as one unencrypted segment; its RED blocks
+%   are encoded in parallel and serialized in order, so the files are
+%   the same whatever the number of threads.
+% 
+% See also decompress_mef_3p0, read_mef_info_3p0.
+
+% Copyright 2026 Richard J. Cui. Created: Sun 10/18/2026 10:12:37.415 AM
+% $Revision: 0.1 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+%
+% Rocky Creek Dr NE
+% Rochester, MN 55906, USA
+%
+% Email: richard.cui@utoronto.ca
+
+% compile c-mex function
+% -----------------------
+% we are here, cuz we don't have the mex function compiled. So, do it now
+make_mex_mef
+
+% now write the session
+% ---------------------
+if nargin < 6
+    ucf = 0;
+end % if
+if nargin < 7
+    block_samples = 0;
+end % if
+if nargin < 8
+    mrr = 0;
+end % if
+if nargin < 9
+    n_threads = 0;
+end % if
+write_mef_session_3p0(sess_path,chan_names,data,fs,start_time,ucf,block_samples,mrr,n_threads)
+
+end % funciton
+
+% [EOF]
\ No newline at end of file
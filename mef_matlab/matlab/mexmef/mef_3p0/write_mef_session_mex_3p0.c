@@ -0,0 +1,194 @@
+/**
+*     @file
+*     MEF 3.0 Library Matlab Wrapper
+*     Write multi-channel data to a MEF 3.0 session (one time series segment per channel), encoding the blocks in parallel
+*
+*  This program is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+*  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+*  This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*  You should have received a copy of the GNU General Public License along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//  Copyright (c) Richard J. Cui Created: Sun 10/18/2026 10:12:37.415 AM
+//  $Revision: 0.3 $  $Date: Sun 10/18/2026 10:12:37.415 AM $
+//
+//  Rocky Creek Dr NE
+//  Rochester, MN 55906, USA
+//
+//  Email: richard.cui@utoronto.ca
+
+#include "mex.h"
+#include "mef_mex_3p0.h"
+
+//  the gate function
+/**
+* Main entry point for 'write_mef_session_3p0'
+*
+* @param sessionPath            Path to the session directory to write (the '.mefd' extension is added if missing)
+* @param channelNames           Cell array with one channel name per row of data
+* @param data                   Channels x samples matrix of doubles in physical units (e.g. EEG.data); NaNs are stored as RED NaN
+* @param samplingFrequency      Sampling frequency (Hz)
+* @param startTime              Time of the first sample (uUTC)
+* @param unitsConversionFactor  (optional) Physical units per stored integer unit (0 or omitted => 1)
+* @param blockSamples           (optional) Samples per RED block (0 or omitted => one second of samples)
+* @param meanResidualRatio      (optional) Goal mean residual ratio of the lossy compression (0 or omitted => lossless)
+* @param nThreads               (optional) Number of worker threads (0 or omitted => one per processor)
+*/
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
+
+    //
+    // session path
+    //
+    if (nrhs < 5) {
+        mexErrMsgIdAndTxt( "MATLAB:write_mef_session_mex_3p0:notEnoughArgs", "sessionPath, channelNames, data, samplingFrequency and startTime input arguments must be set");
+    }
+    if (!mxIsChar(prhs[0]) || mxIsEmpty(prhs[0])) {
+        mexErrMsgIdAndTxt( "MATLAB:write_mef_session_mex_3p0:invalidSessionPathArg", "sessionPath input argument invalid, should be a non-empty string (array of characters)");
+    }
+    si1 session_path[MEF_FULL_FILE_NAME_BYTES];
+    si1 session_name[MEF_BASE_FILE_NAME_BYTES];
+    char *mat_session_path = mxArrayToString(prhs[0]);
+    MEF_strncpy(session_path, mat_session_path, MEF_FULL_FILE_NAME_BYTES - TYPE_BYTES - 1);
+    mxFree(mat_session_path);
+
+    // strip trailing separators, add the session extension if missing, and take the base name as the session name
+    si4 len = (si4) strlen(session_path);
+    while (len > 1 && (session_path[len - 1] == '/' || session_path[len - 1] == '\\'))
+        session_path[--len] = 0;
+    if (len < TYPE_BYTES || strcmp(session_path + len - TYPE_BYTES, "." SESSION_DIRECTORY_TYPE_STRING)) {
+        strcat(session_path, "." SESSION_DIRECTORY_TYPE_STRING);
+        len += TYPE_BYTES;
+    }
+    si1 *base = session_path + len;
+    while (base > session_path && base[-1] != '/' && base[-1] != '\\')
+        --base;
+    MEF_strncpy(session_name, base, MEF_BASE_FILE_NAME_BYTES);
+    session_name[strlen(session_name) - TYPE_BYTES] = 0;
+
+    //
+    // data & channel names
+    //
+    if (!mxIsDouble(prhs[2]) || mxIsComplex(prhs[2]) || mxGetNumberOfDimensions(prhs[2]) > 2 || mxIsEmpty(prhs[2])) {
+        mexErrMsgIdAndTxt( "MATLAB:write_mef_session_mex_3p0:invalidDataArg", "data input argument invalid; should be a non-empty real 2-D double matrix (channels x samples)");
+    }
+    si8 n_chans = (si8) mxGetM(prhs[2]);
+    si8 n_samps = (si8) mxGetN(prhs[2]);
+    if (!mxIsCell(prhs[1]) || (si8) mxGetNumberOfElements(prhs[1]) != n_chans) {
+        mexErrMsgIdAndTxt( "MATLAB:write_mef_session_mex_3p0:invalidChannelNamesArg", "channelNames input argument invalid; should be a cell array with one name per row of data");
+    }
+    for (si8 i = 0; i < n_chans; ++i) {
+        const mxArray *name = mxGetCell(prhs[1], (mwIndex) i);
+        if (name == NULL || !mxIsChar(name) || mxIsEmpty(name)) {
+            mexErrMsgIdAndTxt( "MATLAB:write_mef_session_mex_3p0:invalidChannelNamesArg", "channelNames input argument invalid; channel %ld has no name", (long) (i + 1));
+        }
+    }
+
+    //
+    // sampling frequency & start time
+    //
+    if (!mxIsNumeric(prhs[3]) || mxGetNumberOfElements(prhs[3]) != 1 || mxGetScalar(prhs[3]) <= 0) {
+        mexErrMsgIdAndTxt( "MATLAB:write_mef_session_mex_3p0:invalidSamplingFrequencyArg", "samplingFrequency input argument invalid; should be a single positive value");
+    }
+    if (!mxIsNumeric(prhs[4]) || mxGetNumberOfElements(prhs[4]) != 1) {
+        mexErrMsgIdAndTxt( "MATLAB:write_mef_session_mex_3p0:invalidStartTimeArg", "startTime input argument invalid; should be a single value (uUTC)");
+    }
+    sf8 sampling_frequency = mxGetScalar(prhs[3]);
+    si8 start_time = (si8) mxGetScalar(prhs[4]);
+
+    //
+    // units conversion factor, block samples, mean residual ratio & threads (optional)
+    //
+    sf8 units_conversion_factor = 1.0;
+    if (nrhs > 5 && !mxIsEmpty(prhs[5])) {
+        if (!mxIsNumeric(prhs[5]) || mxGetNumberOfElements(prhs[5]) > 1 || mxGetScalar(prhs[5]) < 0) {
+            mexErrMsgIdAndTxt( "MATLAB:write_mef_session_mex_3p0:invalidUnitsConversionFactorArg", "unitsConversionFactor input argument invalid; should be a single value numeric (>= 0)");
+        }
+        if (mxGetScalar(prhs[5]) > 0)
+            units_conversion_factor = mxGetScalar(prhs[5]);
+    }
+    ui4 block_samples = TIME_SERIES_METADATA_MAXIMUM_BLOCK_SAMPLES_NO_ENTRY;
+    if (nrhs > 6 && !mxIsEmpty(prhs[6])) {
+        if (!mxIsNumeric(prhs[6]) || mxGetNumberOfElements(prhs[6]) > 1 || mxGetScalar(prhs[6]) < 0 || mxGetScalar(prhs[6]) >= (sf8) 0x7FFFFFFF) {
+            mexErrMsgIdAndTxt( "MATLAB:write_mef_session_mex_3p0:invalidBlockSamplesArg", "blockSamples input argument invalid; should be a single value numeric (>= 0)");
+        }
+        if (mxGetScalar(prhs[6]) >= 1)
+            block_samples = (ui4) mxGetScalar(prhs[6]);
+    }
+    sf8 mean_residual_ratio = 0.0;
+    if (nrhs > 7 && !mxIsEmpty(prhs[7])) {
+        if (!mxIsNumeric(prhs[7]) || mxGetNumberOfElements(prhs[7]) > 1 || mxGetScalar(prhs[7]) < 0 || mxGetScalar(prhs[7]) >= 1) {
+            mexErrMsgIdAndTxt( "MATLAB:write_mef_session_mex_3p0:invalidMeanResidualRatioArg", "meanResidualRatio input argument invalid; should be a single value numeric in [0, 1)");
+        }
+        mean_residual_ratio = mxGetScalar(prhs[7]);
+    }
+    si4 n_threads = THREAD_NUMBER_OF_THREADS_DEFAULT;
+    if (nrhs > 8 && !mxIsEmpty(prhs[8])) {
+        if (!mxIsNumeric(prhs[8]) || mxGetNumberOfElements(prhs[8]) > 1 || mxGetScalar(prhs[8]) < 0) {
+            mexErrMsgIdAndTxt( "MATLAB:write_mef_session_mex_3p0:invalidNThreadsArg", "nThreads input argument invalid; should be a single value numeric (>= 0)");
+        }
+        n_threads = (si4) mxGetScalar(prhs[8]);
+    }
+
+    //
+    // write
+    //
+
+    // initialize MEF library
+    (void) initialize_meflib();
+    static MEF_CONTEXT call_context;  // this call's context: the default context is shared by the gateways & threads
+    MEF_initialize_context(&call_context, NULL);
+    (void) MEF_set_context(&call_context);
+    MEF_context->behavior_on_fail = SUPPRESS_ERROR_OUTPUT;
+
+    // metadata prototype (names are set per channel)
+    FILE_PROCESSING_STRUCT *proto_fps = allocate_file_processing_struct(METADATA_FILE_BYTES, TIME_SERIES_METADATA_FILE_TYPE_CODE, NULL, NULL, 0);
+    MEF_strncpy(proto_fps->universal_header->session_name, session_name, MEF_BASE_FILE_NAME_BYTES);
+    proto_fps->metadata.time_series_section_2->sampling_frequency = sampling_frequency;
+    proto_fps->metadata.time_series_section_2->units_conversion_factor = units_conversion_factor;
+    proto_fps->metadata.time_series_section_2->maximum_block_samples = block_samples;
+
+    // compression parameters
+    RED_PROCESSING_STRUCT *proto_rps = RED_allocate_processing_struct(0, 0, 0, 0, 0, 0, NULL);
+    if (mean_residual_ratio > 0.0) {
+        proto_rps->compression.mode = RED_MEAN_RESIDUAL_RATIO;
+        proto_rps->compression.goal_mean_residual_ratio = mean_residual_ratio;
+    }
+
+    const sf8 *data = mxGetPr(prhs[2]);
+    si4 *samples = (si4 *) mxMalloc((size_t) n_samps * sizeof(si4));
+    si1 channel_path[MEF_FULL_FILE_NAME_BYTES];
+    for (si8 i = 0; i < n_chans; ++i) {
+        char *mat_channel_name = mxArrayToString(mxGetCell(prhs[1], (mwIndex) i));
+        MEF_strncpy(proto_fps->universal_header->channel_name, mat_channel_name, MEF_BASE_FILE_NAME_BYTES);
+        mxFree(mat_channel_name);
+        MEF_snprintf(channel_path, MEF_FULL_FILE_NAME_BYTES, "%s/%s.%s", session_path, proto_fps->universal_header->channel_name, TIME_SERIES_CHANNEL_DIRECTORY_TYPE_STRING);
+
+        // gather the channel (strided by the number of channels) in stored units
+        for (si8 j = 0; j < n_samps; ++j) {
+            sf8 val = data[i + j * n_chans];
+            samples[j] = isnan(val) ? RED_NAN : RED_round(val / units_conversion_factor);
+        }
+
+        if (write_MEF_time_series_segment(channel_path, proto_fps, 0, samples, n_samps, 0, start_time, proto_rps, n_threads) != 0) {
+            mxFree(samples);
+            RED_free_processing_struct(proto_rps);
+            free_file_processing_struct(proto_fps);
+            MEF_context->behavior_on_fail = EXIT_ON_FAIL;
+            mexErrMsgIdAndTxt( "MATLAB:write_mef_session_mex_3p0:writeFailed", "failed to write channel %ld", (long) (i + 1));
+        }
+    }
+
+    mxFree(samples);
+    RED_free_processing_struct(proto_rps);
+    free_file_processing_struct(proto_fps);
+    MEF_context->behavior_on_fail = EXIT_ON_FAIL;
+
+    (void) MEF_set_context(NULL);
+
+    // succesfull return from call
+    return;
+
+}
+
+// [EOF]